@@ -141,6 +141,10 @@ function createAppArchive(rootPath, releasePath, tempPath, destPath) {
     path.join(releasePath, 'resources', 'ui'),
     path.join(tempPath, 'resources', 'ui')
   );
+  fs.copySync(
+    path.join(releasePath, 'resources', 'ui.pack'),
+    path.join(tempPath, 'resources', 'ui.pack')
+  );
 
   // Documentation.
   fs.copySync(
@@ -0,0 +1,101 @@
+#!/usr/bin/env node
+// UI resource packing script. Takes one argument, which is the path to the
+// repository's root. Packs each release's resources/ui directory into a
+// resources/ui.pack archive that LOOT can serve its UI from. See
+// src/gui/cef/resource_archive.h for a description of the archive format.
+
+const path = require('path');
+const fs = require('fs');
+const helpers = require('./helpers');
+
+const MAGIC = 'LOOTPACK';
+const VERSION = 1;
+const DATA_ALIGNMENT = 16;
+const HEADER_SIZE = 16;
+const INDEX_ENTRY_SIZE = 20;
+
+function listFiles(directoryPath, prefix) {
+  return fs
+    .readdirSync(directoryPath, { withFileTypes: true })
+    .map(dirent => {
+      const entryPath = path.join(directoryPath, dirent.name);
+      const archivePath = `${prefix}/${dirent.name}`;
+
+      if (dirent.isDirectory()) {
+        return listFiles(entryPath, archivePath);
+      }
+
+      return [{ filePath: entryPath, archivePath }];
+    })
+    .reduce((files, directoryFiles) => files.concat(directoryFiles), []);
+}
+
+function align(offset) {
+  return Math.ceil(offset / DATA_ALIGNMENT) * DATA_ALIGNMENT;
+}
+
+function writeUint64(buffer, value, offset) {
+  buffer.writeUInt32LE(value % 0x100000000, offset);
+  buffer.writeUInt32LE(Math.floor(value / 0x100000000), offset + 4);
+}
+
+function packDirectory(resourcesPath, archivePath) {
+  const files = listFiles(path.join(resourcesPath, 'ui'), 'ui')
+    .map(file => ({
+      pathBytes: Buffer.from(file.archivePath, 'utf8'),
+      data: fs.readFileSync(file.filePath)
+    }))
+    .sort((a, b) => Buffer.compare(a.pathBytes, b.pathBytes));
+
+  const indexSize = files.reduce(
+    (size, file) => size + INDEX_ENTRY_SIZE + file.pathBytes.length,
+    0
+  );
+
+  let dataOffset = align(HEADER_SIZE + indexSize);
+  files.forEach(file => {
+    file.offset = dataOffset;
+    dataOffset = align(dataOffset + file.data.length);
+  });
+
+  const archive = Buffer.alloc(dataOffset);
+  archive.write(MAGIC, 0, 'ascii');
+  archive.writeUInt32LE(VERSION, 8);
+  archive.writeUInt32LE(files.length, 12);
+
+  let indexOffset = HEADER_SIZE;
+  files.forEach(file => {
+    archive.writeUInt32LE(file.pathBytes.length, indexOffset);
+    writeUint64(archive, file.offset, indexOffset + 4);
+    writeUint64(archive, file.data.length, indexOffset + 12);
+    file.pathBytes.copy(archive, indexOffset + INDEX_ENTRY_SIZE);
+    indexOffset += INDEX_ENTRY_SIZE + file.pathBytes.length;
+
+    file.data.copy(archive, file.offset);
+  });
+
+  // Write to a temporary file first so that a running LOOT never maps a
+  // partially-written archive.
+  const tempPath = `${archivePath}.tmp`;
+  fs.writeFileSync(tempPath, archive);
+  fs.renameSync(tempPath, archivePath);
+
+  return files.length;
+}
+
+const [, , rootPath = '.'] = process.argv;
+
+helpers.getAppReleasePaths(rootPath).forEach(releasePath => {
+  const resourcesPath = path.join(releasePath.path, 'resources');
+  if (!fs.existsSync(path.join(resourcesPath, 'ui'))) {
+    return;
+  }
+
+  const count = packDirectory(
+    resourcesPath,
+    path.join(resourcesPath, 'ui.pack')
+  );
+
+  // eslint-disable-next-line no-console
+  console.log(`Packed ${count} files into ${resourcesPath}/ui.pack`);
+});
@@ -0,0 +1,82 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_BENCHMARKS_GUI_CEF_QUERY_TYPES_GET_GAME_DATA_QUERY_BENCHMARK
+#define LOOT_BENCHMARKS_GUI_CEF_QUERY_TYPES_GET_GAME_DATA_QUERY_BENCHMARK
+
+#include "gui/cef/query/types/get_game_data_query.h"
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks/gui/synthetic_game.h"
+
+namespace loot {
+namespace benchmarks {
+// Measures the first load of a game's data, which loads its plugins' headers
+// and metadata lists before deriving metadata for every plugin.
+void GetGameDataQueryFirstLoad(::benchmark::State& state) {
+  const auto& syntheticGame = SyntheticGame::Get(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto game = syntheticGame.CreateGame();
+    state.ResumeTiming();
+
+    GetGameDataQuery<> query(*game, "en", [](const ProgressUpdate&) {});
+    ::benchmark::DoNotOptimize(query.executeLogic());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Measures a reload of a game's data after the first load, which may reuse
+// previously evaluated metadata.
+void GetGameDataQueryReload(::benchmark::State& state) {
+  const auto& syntheticGame = SyntheticGame::Get(state.range(0));
+  auto game = syntheticGame.CreateGame();
+  GetGameDataQuery<>(*game, "en", [](const ProgressUpdate&) {}).executeLogic();
+
+  for (auto _ : state) {
+    GetGameDataQuery<> query(*game, "en", [](const ProgressUpdate&) {});
+    ::benchmark::DoNotOptimize(query.executeLogic());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(GetGameDataQueryFirstLoad)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Unit(::benchmark::kMillisecond);
+BENCHMARK(GetGameDataQueryReload)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Unit(::benchmark::kMillisecond);
+}
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_BENCHMARKS_GUI_CEF_QUERY_TYPES_SORT_PLUGINS_QUERY_BENCHMARK
+#define LOOT_BENCHMARKS_GUI_CEF_QUERY_TYPES_SORT_PLUGINS_QUERY_BENCHMARK
+
+#include "gui/cef/query/types/sort_plugins_query.h"
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks/gui/synthetic_game.h"
+
+namespace loot {
+namespace benchmarks {
+// Measures sorting and generating the response for the sorted load order.
+void SortPluginsQueryExecuteLogic(::benchmark::State& state) {
+  const auto& syntheticGame = SyntheticGame::Get(state.range(0));
+  auto game = syntheticGame.CreateGame();
+  game->LoadAllInstalledPluginsAndMetadata(true, false);
+  UnappliedChangeCounter counter;
+
+  for (auto _ : state) {
+    SortPluginsQuery<> query(
+        *game, counter, "en", [](const ProgressUpdate&) {});
+    ::benchmark::DoNotOptimize(query.executeLogic());
+
+    state.PauseTiming();
+    counter.DecrementUnappliedChangeCounter();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(SortPluginsQueryExecuteLogic)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Unit(::benchmark::kMillisecond);
+}
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_BENCHMARKS_GUI_HELPERS_BENCHMARK
+#define LOOT_BENCHMARKS_GUI_HELPERS_BENCHMARK
+
+#include "gui/helpers.h"
+
+#include <benchmark/benchmark.h>
+
+namespace loot {
+namespace benchmarks {
+// Plugin names of a typical length that differ only in case, so that the
+// whole of each name is compared.
+void CompareAsciiFilenames(::benchmark::State& state) {
+  const std::string lhs = "Unofficial Skyrim Special Edition Patch.esp";
+  const std::string rhs = "unofficial skyrim special edition patch.ESP";
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(CompareFilenames(lhs, rhs));
+  }
+}
+
+// As above, but the names can't be compared as ASCII.
+void CompareNonAsciiFilenames(::benchmark::State& state) {
+  const std::string lhs =
+      u8"Unofficial Skyrim Special Edition Patch \u00C1.esp";
+  const std::string rhs =
+      u8"unofficial skyrim special edition patch \u00E1.ESP";
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(CompareFilenames(lhs, rhs));
+  }
+}
+
+void NormalizeAsciiFilename(::benchmark::State& state) {
+  const std::string filename = "Unofficial Skyrim Special Edition Patch.esp";
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(NormalizeFilename(filename));
+  }
+}
+
+void NormalizeNonAsciiFilename(::benchmark::State& state) {
+  const std::string filename =
+      u8"Unofficial Skyrim Special Edition Patch \u00C1.esp";
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(NormalizeFilename(filename));
+  }
+}
+
+BENCHMARK(CompareAsciiFilenames);
+BENCHMARK(CompareNonAsciiFilenames);
+BENCHMARK(NormalizeAsciiFilename);
+BENCHMARK(NormalizeNonAsciiFilename);
+}
+}
+
+#endif
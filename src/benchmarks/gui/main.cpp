@@ -0,0 +1,53 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include <boost/locale.hpp>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include "benchmarks/gui/cef/query/types/get_conflicting_plugins_query_benchmark.h"
+#include "benchmarks/gui/cef/query/types/get_game_data_query_benchmark.h"
+#include "benchmarks/gui/cef/query/types/sort_plugins_query_benchmark.h"
+#include "benchmarks/gui/helpers_benchmark.h"
+#include "benchmarks/gui/state/game/helpers_benchmark.h"
+#include "benchmarks/gui/state/loot_settings_benchmark.h"
+
+// Run with --benchmark_out=<file> --benchmark_out_format=json to get results
+// that can be compared over time, e.g. using Google Benchmark's compare.py.
+int main(int argc, char **argv) {
+  // Set the locale to get encoding conversions working correctly.
+  std::locale::global(boost::locale::generator().generate(""));
+
+  // Set the logger to use a null sink so that logging doesn't affect timings.
+  spdlog::create<spdlog::sinks::null_sink_st>("loot_logger");
+
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
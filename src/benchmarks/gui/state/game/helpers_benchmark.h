@@ -0,0 +1,80 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_BENCHMARKS_GUI_STATE_GAME_HELPERS_BENCHMARK
+#define LOOT_BENCHMARKS_GUI_STATE_GAME_HELPERS_BENCHMARK
+
+#include "gui/state/game/helpers.h"
+
+#include <regex>
+
+#include <benchmark/benchmark.h>
+
+namespace loot {
+namespace benchmarks {
+// Get text that is the given number of bytes long, about a tenth of which
+// are Markdown special characters.
+std::string GetMarkdownEscapingText(size_t length) {
+  const std::string sample = "Requires SKSE v2.0.17+ (see *readme*). ";
+
+  std::string text;
+  while (text.size() < length) {
+    text += sample;
+  }
+  text.resize(length);
+
+  return text;
+}
+
+void EscapeMarkdownSpecialCharsLength(::benchmark::State& state) {
+  const auto text = GetMarkdownEscapingText(state.range(0));
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(EscapeMarkdownSpecialChars(text));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// The regex replacement that EscapeMarkdownSpecialChars() replaced, for
+// comparison.
+void RegexEscapeMarkdownSpecialCharsLength(::benchmark::State& state) {
+  const auto text = GetMarkdownEscapingText(state.range(0));
+  const std::regex specialCharsRegex("([\\\\`*_{}\\[\\]()#+.!-])");
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+        std::regex_replace(text, specialCharsRegex, "\\$1"));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(EscapeMarkdownSpecialCharsLength)->Range(16, 64 << 10);
+BENCHMARK(RegexEscapeMarkdownSpecialCharsLength)->Range(16, 64 << 10);
+}
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_BENCHMARKS_GUI_STATE_LOOT_SETTINGS_BENCHMARK
+#define LOOT_BENCHMARKS_GUI_STATE_LOOT_SETTINGS_BENCHMARK
+
+#include "gui/state/loot_settings.h"
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks/gui/synthetic_game.h"
+
+namespace loot {
+namespace benchmarks {
+// Add the given number of extra games to the default games, since games make
+// up most of a settings file.
+void AddGames(LootSettings& settings, size_t extraGameCount) {
+  auto gameSettings = settings.getGameSettings();
+  for (size_t i = 0; i < extraGameCount; ++i) {
+    auto folder = "Synthetic " + std::to_string(i);
+    gameSettings.push_back(GameSettings(GameType::tes5se, folder)
+                               .SetName(folder)
+                               .SetGamePath("C:/Games/" + folder));
+  }
+  settings.storeGameSettings(gameSettings);
+}
+
+void LootSettingsSave(::benchmark::State& state) {
+  const auto& syntheticGame = SyntheticGame::Get(0);
+  const auto settingsPath = syntheticGame.GetRootPath() / "settings.toml";
+  LootSettings settings;
+  AddGames(settings, state.range(0));
+
+  for (auto _ : state) {
+    settings.save(settingsPath);
+  }
+}
+
+void LootSettingsLoad(::benchmark::State& state) {
+  const auto& syntheticGame = SyntheticGame::Get(0);
+  const auto settingsPath = syntheticGame.GetRootPath() / "settings.toml";
+  LootSettings savedSettings;
+  AddGames(savedSettings, state.range(0));
+  savedSettings.save(settingsPath);
+
+  for (auto _ : state) {
+    LootSettings settings;
+    settings.load(settingsPath, syntheticGame.GetRootPath());
+    ::benchmark::DoNotOptimize(settings.getGameSettings().size());
+  }
+}
+
+BENCHMARK(LootSettingsSave)->Arg(0)->Arg(100)->Unit(::benchmark::kMicrosecond);
+BENCHMARK(LootSettingsLoad)->Arg(0)->Arg(100)->Unit(::benchmark::kMicrosecond);
+}
+}
+
+#endif
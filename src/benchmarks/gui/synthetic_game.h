@@ -0,0 +1,166 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_BENCHMARKS_GUI_SYNTHETIC_GAME
+#define LOOT_BENCHMARKS_GUI_SYNTHETIC_GAME
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "gui/state/game/game.h"
+#include "tests/synthetic_plugins.h"
+
+namespace loot {
+namespace benchmarks {
+/**
+ * @brief A Skyrim Special Edition install with a given number of synthetic
+ *        plugins and a masterlist and userlist with entries for each of them,
+ *        created in a temporary directory and deleted on destruction.
+ * @details The plugins and metadata lists are the ones that the tests use for
+ *          their scale tests, so every plugin overrides the same records and
+ *          overlaps with each other.
+ */
+class SyntheticGame {
+public:
+  // The masterlist has this many entries for each installed plugin, with the
+  // rest being for plugins that aren't installed.
+  static constexpr size_t MASTERLIST_ENTRIES_PER_PLUGIN = 4;
+
+  // The masterlist's plugins are spread across this many groups.
+  static constexpr size_t MASTERLIST_GROUP_COUNT = 10;
+
+  explicit SyntheticGame(size_t pluginCount) :
+      rootPath_(getRootPath()),
+      gamePath_(rootPath_ / "game"),
+      dataPath_(gamePath_ / "Data"),
+      localPath_(rootPath_ / "local" / "game"),
+      lootDataPath_(rootPath_ / "local" / "LOOT"),
+      settings_(GameSettings(GameType::tes5se, "Synthetic")
+                    .SetMinimumHeaderVersion(0.0f)
+                    .SetGamePath(gamePath_)
+                    .SetGameLocalPath(localPath_)) {
+    std::filesystem::create_directories(dataPath_);
+    std::filesystem::create_directories(localPath_);
+    std::filesystem::create_directories(lootDataPath_ /
+                                        settings_.FolderName());
+
+    std::filesystem::copy_file("./Skyrim/Data/Blank.esm",
+                               dataPath_ / settings_.Master());
+
+    // Activate as many plugins as the game can load.
+    test::SyntheticPluginOptions options;
+    options.pluginCount = pluginCount;
+    options.activeInterval = 1;
+
+    const auto loadOrder = test::createSyntheticPlugins(
+        settings_.Type(), dataPath_, settings_.Master(), options);
+    for (const auto& plugin : loadOrder) {
+      plugins_.push_back(plugin.first);
+    }
+
+    writePluginsTxt(loadOrder);
+
+    const auto folderPath = lootDataPath_ / settings_.FolderName();
+    test::writeSyntheticMetadataLists(folderPath / "masterlist.yaml",
+                                      folderPath / "userlist.yaml",
+                                      settings_.Master(),
+                                      plugins_,
+                                      MASTERLIST_GROUP_COUNT,
+                                      MASTERLIST_ENTRIES_PER_PLUGIN);
+  }
+
+  ~SyntheticGame() { std::filesystem::remove_all(rootPath_); }
+
+  SyntheticGame(const SyntheticGame&) = delete;
+  SyntheticGame& operator=(const SyntheticGame&) = delete;
+
+  // Get an initialised game object for the install that hasn't loaded any
+  // plugins or metadata.
+  std::unique_ptr<gui::Game> CreateGame() const {
+    auto game = std::make_unique<gui::Game>(settings_, lootDataPath_);
+    game->Init();
+    return game;
+  }
+
+  const std::vector<std::string>& GetPlugins() const { return plugins_; }
+
+  const std::filesystem::path& GetRootPath() const { return rootPath_; }
+
+  // Get an install for the given number of plugins, creating it the first
+  // time it's requested. Installs are kept until the program exits so that
+  // benchmarks that are run repeatedly don't spend their time creating them.
+  static const SyntheticGame& Get(size_t pluginCount) {
+    static std::map<size_t, std::unique_ptr<SyntheticGame>> games;
+
+    auto& game = games[pluginCount];
+    if (!game) {
+      game = std::make_unique<SyntheticGame>(pluginCount);
+    }
+
+    return *game;
+  }
+
+private:
+  static std::filesystem::path getRootPath() {
+    auto directoryName =
+        u8"LOOT-benchmark-" +
+        boost::lexical_cast<std::string>((boost::uuids::random_generator())());
+
+    return std::filesystem::absolute(std::filesystem::temp_directory_path() /
+                                     std::filesystem::u8path(directoryName));
+  }
+
+  void writePluginsTxt(
+      const std::vector<std::pair<std::string, bool>>& loadOrder) const {
+    std::ofstream out(localPath_ / "plugins.txt");
+    for (const auto& plugin : loadOrder) {
+      if (plugin.second) {
+        out << '*';
+      }
+      out << plugin.first << std::endl;
+    }
+  }
+
+  const std::filesystem::path rootPath_;
+  const std::filesystem::path gamePath_;
+  const std::filesystem::path dataPath_;
+  const std::filesystem::path localPath_;
+  const std::filesystem::path lootDataPath_;
+  const GameSettings settings_;
+  std::vector<std::string> plugins_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,214 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/batch_sort.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "gui/state/logging.h"
+
+namespace loot {
+namespace {
+std::string describeMessageType(MessageType type) {
+  switch (type) {
+    case MessageType::say:
+      return "say";
+    case MessageType::warn:
+      return "warn";
+    case MessageType::error:
+      return "error";
+    default:
+      return "say";
+  }
+}
+}
+
+std::vector<SortJob> ParseSortJobs(const nlohmann::json& json) {
+  std::vector<SortJob> jobs;
+  for (const auto& jobJson : json) {
+    SortJob job;
+    job.gameFolder = jobJson.at("game").get<std::string>();
+    job.gamePath =
+        std::filesystem::u8path(jobJson.value("gamePath", std::string()));
+    job.gameLocalPath =
+        std::filesystem::u8path(jobJson.value("gameLocalPath", std::string()));
+    jobs.push_back(job);
+  }
+
+  return jobs;
+}
+
+std::vector<SortJob> ReadSortJobs(const std::filesystem::path& file) {
+  std::ifstream in(file);
+  if (!in.is_open()) {
+    throw std::runtime_error("Could not open sort jobs file: " +
+                             file.u8string());
+  }
+
+  return ParseSortJobs(nlohmann::json::parse(in));
+}
+
+GameSettings ResolveSortJob(const SortJob& job,
+                            const std::vector<GameSettings>& gamesSettings) {
+  auto it = std::find_if(gamesSettings.cbegin(),
+                         gamesSettings.cend(),
+                         [&](const GameSettings& gameSettings) {
+                           return gameSettings.FolderName() == job.gameFolder;
+                         });
+  if (it == gamesSettings.cend()) {
+    throw std::invalid_argument("Unknown game: " + job.gameFolder);
+  }
+
+  auto gameSettings = *it;
+  if (!job.gamePath.empty()) {
+    gameSettings.SetGamePath(job.gamePath);
+  } else {
+    auto gamePath = gameSettings.FindGamePath();
+    if (!gamePath.has_value()) {
+      throw std::runtime_error("Could not find the install path of " +
+                               job.gameFolder);
+    }
+    gameSettings.SetGamePath(gamePath.value());
+  }
+
+  if (!job.gameLocalPath.empty()) {
+    gameSettings.SetGameLocalPath(job.gameLocalPath);
+  }
+
+  return gameSettings;
+}
+
+nlohmann::json DescribeMessages(const gui::Game& game,
+                                const std::string& language) {
+  nlohmann::json messages = nlohmann::json::array();
+  for (const auto& message : game.GetMessages()) {
+    messages.push_back({
+        {"type", describeMessageType(message.GetType())},
+        {"text", message.GetContent(language).GetText()},
+    });
+  }
+
+  return messages;
+}
+
+nlohmann::json SortGame(gui::Game& game,
+                        bool applyLoadOrder,
+                        bool updateMasterlist,
+                        const std::string& language) {
+  nlohmann::json result = {
+      {"game", game.FolderName()},
+      {"gamePath", game.GamePath().u8string()},
+      {"gameLocalPath", game.GameLocalPath().u8string()},
+  };
+
+  game.Init();
+  game.LoadAllInstalledPluginsAndMetadata(true, updateMasterlist);
+
+  const auto currentLoadOrder = game.GetLoadOrder();
+  const auto sortedLoadOrder = game.SortPlugins();
+
+  result["messages"] = DescribeMessages(game, language);
+
+  // An empty load order means that sorting failed, and the messages say why.
+  if (sortedLoadOrder.empty()) {
+    result["error"] = "Sorting failed";
+    return result;
+  }
+
+  const bool changed = sortedLoadOrder != currentLoadOrder;
+  if (applyLoadOrder && changed) {
+    game.SetLoadOrder(sortedLoadOrder);
+  }
+
+  result["loadOrder"] = sortedLoadOrder;
+  result["changed"] = changed;
+  result["applied"] = applyLoadOrder && changed;
+
+  return result;
+}
+
+int RunSortJobs(LootState& state,
+                const std::vector<SortJob>& jobs,
+                bool applyLoadOrders,
+                std::ostream& out) {
+  auto logger = getLogger();
+
+  bool allSucceeded = state.getInitErrors().empty();
+  nlohmann::json results = nlohmann::json::array();
+
+  // Profiles of the same game share its masterlist, so it only needs to be
+  // updated for the first of the game's jobs that succeeds.
+  std::unordered_set<std::string> updatedMasterlists;
+  for (const auto& job : jobs) {
+    if (logger) {
+      logger->info("Running sort job for game {} with local path \"{}\"",
+                   job.gameFolder,
+                   job.gameLocalPath.u8string());
+    }
+
+    nlohmann::json result;
+    try {
+      const bool updateMasterlist =
+          state.updateMasterlist() &&
+          updatedMasterlists.count(job.gameFolder) == 0;
+
+      gui::Game game(ResolveSortJob(job, state.getGameSettings()),
+                     state.getLootDataPath());
+      result = SortGame(
+          game, applyLoadOrders, updateMasterlist, state.getLanguage());
+
+      if (updateMasterlist) {
+        updatedMasterlists.insert(job.gameFolder);
+      }
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->error("Sort job for game {} failed: {}",
+                      job.gameFolder,
+                      e.what());
+      }
+      result = {
+          {"game", job.gameFolder},
+          {"gamePath", job.gamePath.u8string()},
+          {"gameLocalPath", job.gameLocalPath.u8string()},
+          {"error", e.what()},
+      };
+    }
+
+    allSucceeded = allSucceeded && result.count("error") == 0;
+    results.push_back(result);
+  }
+
+  nlohmann::json json = {
+      {"initErrors", state.getInitErrors()},
+      {"results", results},
+  };
+  out << json.dump(2) << std::endl;
+
+  return allSucceeded ? 0 : 1;
+}
+}
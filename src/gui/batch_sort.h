@@ -0,0 +1,83 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_BATCH_SORT
+#define LOOT_GUI_BATCH_SORT
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include "gui/state/game/game.h"
+#include "gui/state/loot_state.h"
+
+namespace loot {
+struct SortJob {
+  std::string gameFolder;
+  // If empty, the game's configured or detected path is used.
+  std::filesystem::path gamePath;
+  // If empty, the game's configured or default local path is used. Setting
+  // this allows the load orders of different mod manager profiles to be
+  // sorted.
+  std::filesystem::path gameLocalPath;
+};
+
+// Read sort jobs from a JSON array of objects with "game", and optionally
+// "gamePath" and "gameLocalPath", string values.
+std::vector<SortJob> ParseSortJobs(const nlohmann::json& json);
+
+std::vector<SortJob> ReadSortJobs(const std::filesystem::path& file);
+
+// Get the settings for the game that the job sorts, with the job's paths
+// applied. Throws if the game is unknown or its path can't be found.
+GameSettings ResolveSortJob(const SortJob& job,
+                            const std::vector<GameSettings>& gamesSettings);
+
+// Get the game's messages as a JSON array of objects with "type" and "text"
+// strings, using the text in the given language where possible.
+nlohmann::json DescribeMessages(const gui::Game& game,
+                                const std::string& language);
+
+// Load and sort the game's plugins, optionally applying the sorted load order
+// if it differs from the current load order, and return the result as JSON.
+nlohmann::json SortGame(gui::Game& game,
+                        bool applyLoadOrder,
+                        bool updateMasterlist,
+                        const std::string& language);
+
+// Run the given jobs one after another, writing their results to the given
+// stream as a JSON object. If masterlist updates are enabled, each game's
+// masterlist is updated at most once, however many of its profiles are
+// sorted. Returns 0 if all jobs succeeded, and 1 otherwise.
+int RunSortJobs(LootState& state,
+                const std::vector<SortJob>& jobs,
+                bool applyLoadOrders,
+                std::ostream& out);
+}
+
+#endif
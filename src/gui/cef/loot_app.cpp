@@ -29,19 +29,54 @@
 #include <include/views/cef_window.h>
 #include <boost/locale.hpp>
 
+#include "gui/cef/function_task.h"
 #include "gui/cef/loot_handler.h"
 #include "gui/cef/loot_scheme_handler_factory.h"
+#include "gui/cef/query/query_recording.h"
 #include "gui/cef/window_delegate.h"
 #include "gui/state/logging.h"
 #include "gui/state/loot_paths.h"
 
 namespace loot {
+namespace {
+// Limit the V8 heap of the UI's renderer process to 256 MiB. LOOT's UI holds
+// little more than the current game's plugin data, which is far smaller.
+constexpr const char* LOW_FOOTPRINT_V8_HEAP_LIMIT = "--max-old-space-size=256";
+
+// Sample the process' memory usage this often when memory accounting is
+// enabled, so that the history covers the last two hours.
+constexpr std::chrono::seconds MEMORY_SAMPLE_INTERVAL(30);
+
+// LOOT's UI is one local page, so it doesn't need GPU compositing, a
+// renderer process per site, or disk and media caches of any size. The
+// switches are added to the browser process' command line, and CEF passes
+// the relevant switches on to the processes that it starts.
+void appendLowFootprintSwitches(CefRefPtr<CefCommandLine> command_line) {
+  command_line->AppendSwitch("--disable-gpu");
+  command_line->AppendSwitch("--disable-gpu-compositing");
+  command_line->AppendSwitchWithValue("--renderer-process-limit", "1");
+  command_line->AppendSwitch("--process-per-site");
+  command_line->AppendSwitchWithValue("--disk-cache-size", "1048576");
+  command_line->AppendSwitchWithValue("--media-cache-size", "1048576");
+  command_line->AppendSwitch("--disable-pdf-extension");
+  command_line->AppendSwitch("--disable-print-preview");
+  command_line->AppendSwitch("--disable-component-update");
+  command_line->AppendSwitch("--disable-background-networking");
+  command_line->AppendSwitchWithValue("--js-flags",
+                                      LOW_FOOTPRINT_V8_HEAP_LIMIT);
+}
+}
+
 #ifdef _WIN32
 CommandLineOptions::CommandLineOptions() : CommandLineOptions(0, nullptr) {}
 #endif
 
 CommandLineOptions::CommandLineOptions(int argc, const char* const* argv) :
-    autoSort(false) {
+    autoSort(false),
+    lowFootprint(false),
+    headless(false),
+    applySortedLoadOrder(false),
+    memoryAccounting(false) {
   // Record command line arguments.
   CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
 
@@ -64,6 +99,36 @@ CommandLineOptions::CommandLineOptions(int argc, const char* const* argv) :
   }
 
   autoSort = command_line->HasSwitch("auto-sort");
+  lowFootprint = command_line->HasSwitch("low-footprint");
+
+  headless = command_line->HasSwitch("headless");
+  applySortedLoadOrder = command_line->HasSwitch("apply");
+
+  if (command_line->HasSwitch("sort-jobs")) {
+    sortJobsPath = command_line->GetSwitchValue("sort-jobs");
+  }
+
+  if (command_line->HasSwitch("game-path")) {
+    gamePath = command_line->GetSwitchValue("game-path");
+  }
+
+  if (command_line->HasSwitch("game-local-path")) {
+    gameLocalPath = command_line->GetSwitchValue("game-local-path");
+  }
+
+  if (command_line->HasSwitch("record-queries")) {
+    recordQueriesPath = command_line->GetSwitchValue("record-queries");
+  }
+
+  if (command_line->HasSwitch("replay-queries")) {
+    replayQueriesPath = command_line->GetSwitchValue("replay-queries");
+  }
+
+  if (command_line->HasSwitch("serve")) {
+    serveEndpoint = command_line->GetSwitchValue("serve");
+  }
+
+  memoryAccounting = command_line->HasSwitch("memory-accounting");
 }
 
 LootApp::LootApp(CommandLineOptions options) :
@@ -74,6 +139,37 @@ std::filesystem::path LootApp::getL10nPath() const {
   return lootState_.getL10nPath();
 }
 
+void LootApp::flushSettings() { lootState_.flushSave(); }
+
+void LootApp::joinBackgroundThreads() {
+  if (autoSortThread_.joinable()) {
+    autoSortThread_.join();
+  }
+
+  if (handler_) {
+    handler_->joinThreads();
+  }
+}
+
+bool LootApp::useLowFootprintMode() const {
+  if (commandLineOptions_.lowFootprint) {
+    return true;
+  }
+
+  if (!std::filesystem::exists(lootState_.getSettingsPath())) {
+    return false;
+  }
+
+  try {
+    LootSettings settings;
+    settings.load(lootState_.getSettingsPath(), lootState_.getLootDataPath());
+    return settings.isLowFootprintModeEnabled();
+  } catch (std::exception&) {
+    // LOOT's initialisation reports any error when it loads the settings.
+    return false;
+  }
+}
+
 void LootApp::OnBeforeCommandLineProcessing(
     const CefString& process_type,
     CefRefPtr<CefCommandLine> command_line) {
@@ -83,6 +179,10 @@ void LootApp::OnBeforeCommandLineProcessing(
     // Disable spell checking.
     command_line->AppendSwitch("--disable-spell-checking");
     command_line->AppendSwitch("--disable-extensions");
+
+    if (useLowFootprintMode()) {
+      appendLowFootprintSwitches(command_line);
+    }
   }
 }
 
@@ -98,17 +198,68 @@ void LootApp::OnContextInitialized() {
   // Make sure this is running in the UI thread.
   assert(CefCurrentlyOn(TID_UI));
 
+  if (commandLineOptions_.memoryAccounting) {
+    SetAllocationAccountingEnabled(true);
+    memorySampler_ =
+        std::make_unique<ProcessMemorySampler>(MEMORY_SAMPLE_INTERVAL);
+  }
+
   // Initialise LOOT's state.
   lootState_.init(commandLineOptions_.defaultGame, commandLineOptions_.autoSort);
 
+  if (!commandLineOptions_.recordQueriesPath.empty()) {
+    try {
+      GetQueryRecorder().Start(
+          std::filesystem::u8path(commandLineOptions_.recordQueriesPath));
+    } catch (std::exception& e) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->error("Failed to start recording queries: {}", e.what());
+      }
+    }
+  }
+
+  // Auto-sorting doesn't need the UI unless there are errors to show, so do
+  // it before the browser window is created. It can take a while, so it's run
+  // on its own thread to keep the UI thread responsive.
+  if (commandLineOptions_.autoSort) {
+    autoSortThread_ = std::thread([this]() {
+      const bool sorted = lootState_.runAutoSort();
+      CefPostTask(TID_UI, new FunctionTask([this, sorted]() {
+                    onAutoSortFinished(sorted);
+                  }));
+    });
+    return;
+  }
+
+  createBrowserWindow();
+}
+
+void LootApp::onAutoSortFinished(bool sorted) {
+  if (sorted) {
+    lootState_.save(lootState_.getSettingsPath());
+    CefQuitMessageLoop();
+    return;
+  }
+
+  // Auto-sort failed, so show the UI so that the errors can be seen. Game
+  // preloading was skipped in case the UI wasn't needed.
+  if (lootState_.shouldPreloadGames()) {
+    lootState_.PreloadGames();
+  }
+
+  createBrowserWindow();
+}
+
+void LootApp::createBrowserWindow() {
   // Set the handler for browser-level callbacks.
-  CefRefPtr<LootHandler> handler(new LootHandler(lootState_));
+  handler_ = new LootHandler(lootState_);
 
   // Register the custom "loot" domain handler.
   CefRegisterSchemeHandlerFactory(
       "http",
       "loot",
-      new LootSchemeHandlerFactory(lootState_.getResourcesPath()));
+      new LootSchemeHandlerFactory(lootState_.getResourcesPath(), true));
 
   CefRegisterSchemeHandlerFactory(
       "http",
@@ -119,7 +270,7 @@ void LootApp::OnContextInitialized() {
   CefBrowserSettings browser_settings;
 
   CefRefPtr<CefBrowserView> browser_view = CefBrowserView::CreateBrowserView(
-      handler, "http://loot/ui/index.html", browser_settings, NULL, NULL, NULL);
+      handler_, "http://loot/ui/index.html", browser_settings, NULL, NULL, NULL);
 
   CefWindow::CreateTopLevelWindow(
       new WindowDelegate(browser_view, lootState_.getWindowPosition()));
@@ -26,11 +26,15 @@
 #ifndef LOOT_GUI_LOOT_APP
 #define LOOT_GUI_LOOT_APP
 
+#include <thread>
+
 #include <include/base/cef_lock.h>
 #include <include/cef_app.h>
 #include <include/wrapper/cef_message_router.h>
 
+#include "gui/cef/loot_handler.h"
 #include "gui/state/loot_state.h"
+#include "gui/state/memory_accounting.h"
 
 namespace loot {
 struct CommandLineOptions {
@@ -40,8 +44,30 @@ struct CommandLineOptions {
   CommandLineOptions(int argc, const char *const *argv);
 
   bool autoSort;
+  bool lowFootprint;
   std::string defaultGame;
   std::string lootDataPath;
+
+  // Sort without starting the UI, writing results to stdout.
+  bool headless;
+  bool applySortedLoadOrder;
+  std::string sortJobsPath;
+  std::string gamePath;
+  std::string gameLocalPath;
+
+  // Write the queries that the UI sends to this file.
+  std::string recordQueriesPath;
+  // Replay the queries recorded in this file without starting the UI,
+  // writing their latencies to stdout.
+  std::string replayQueriesPath;
+
+  // Serve queries to other processes on this named pipe or Unix domain
+  // socket without starting the UI.
+  std::string serveEndpoint;
+
+  // Count the allocations made by each query and Game operation, and sample
+  // the process' memory usage periodically.
+  bool memoryAccounting;
 };
 
 class LootApp : public CefApp,
@@ -52,6 +78,19 @@ public:
 
   std::filesystem::path getL10nPath() const;
 
+  // Complete any pending save of LOOT's settings.
+  void flushSettings();
+
+  // Wait for the auto-sort thread and the background threads of the browser's
+  // handler to finish. This must be called after the message loop has quit.
+  void joinBackgroundThreads();
+
+  // Check if CEF should be started with settings that use less memory, which
+  // is the case if --low-footprint was passed or it's enabled in LOOT's
+  // settings. The settings haven't been loaded when CEF starts, so they're
+  // read from the settings file.
+  bool useLowFootprintMode() const;
+
   // Override CefApp methods.
   virtual void OnBeforeCommandLineProcessing(
       const CefString& process_type,
@@ -76,8 +115,16 @@ private:
                                 CefRefPtr<CefFrame> frame,
                                 CefRefPtr<CefV8Context> context) OVERRIDE;
 
+  // Called on the UI thread once auto-sort has finished. Quits if the load
+  // order was sorted, and otherwise shows the UI.
+  void onAutoSortFinished(bool sorted);
+  void createBrowserWindow();
+
   CommandLineOptions commandLineOptions_;
   LootState lootState_;
+  std::unique_ptr<ProcessMemorySampler> memorySampler_;
+  CefRefPtr<LootHandler> handler_;
+  std::thread autoSortThread_;
   CefRefPtr<CefMessageRouterRendererSide> message_router_;
 
   IMPLEMENT_REFCOUNTING(LootApp);
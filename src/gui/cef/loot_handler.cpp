@@ -37,9 +37,11 @@
 #include <boost/algorithm/string.hpp>
 
 #include "gui/cef/loot_scheme_handler_factory.h"
+#include "gui/cef/query/command_line_forwarding.h"
 #include "gui/cef/query/query_handler.h"
 #include "gui/helpers.h"
 #include "gui/state/loot_paths.h"
+#include "gui/state/startup_report.h"
 
 namespace loot {
 LootSettings::WindowPosition getWindowPosition(CefRefPtr<CefBrowser> browser) {
@@ -148,7 +150,16 @@ void LootHandler::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
   CefMessageRouterConfig config;
   browser_side_router_ = CefMessageRouterBrowserSide::Create(config);
 
-  browser_side_router_->AddHandler(new QueryHandler(lootState_), false);
+  auto queryHandler = new QueryHandler(lootState_);
+  browser_side_router_->AddHandler(queryHandler, false);
+
+#ifdef _WIN32
+  // Only LOOT on Windows stops later instances from starting, so only it
+  // listens for their command lines.
+  startInstanceServer(*queryHandler);
+#endif
+
+  RecordStartupMilestone("Browser creation");
 }
 
 bool LootHandler::DoClose(CefRefPtr<CefBrowser> browser) {
@@ -203,10 +214,53 @@ void LootHandler::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
 
   if (browser_list_.empty()) {
     // All browser windows have closed. Quit the application message loop.
+    stopInstanceServer();
     CefQuitMessageLoop();
   }
 }
 
+void LootHandler::startInstanceServer(QueryHandler& queryHandler) {
+  if (instanceServer_) {
+    return;
+  }
+
+  try {
+    instanceServer_ = std::make_unique<QueryServer>(
+        GetInstanceEndpointName(),
+        GetForwardedCommandLineRunner(
+            [&queryHandler](const std::string& gameFolder, bool autoSort) {
+              return queryHandler.handleForwardedCommandLine(gameFolder,
+                                                             autoSort);
+            }));
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error(
+          "Failed to listen for the command lines of other instances of "
+          "LOOT: {}",
+          e.what());
+    }
+    return;
+  }
+
+  instanceServerThread_ = std::thread([this]() { instanceServer_->Run(); });
+}
+
+void LootHandler::stopInstanceServer() {
+  if (!instanceServer_) {
+    return;
+  }
+
+  instanceServer_->Stop();
+}
+
+void LootHandler::joinThreads() {
+  if (instanceServerThread_.joinable()) {
+    instanceServerThread_.join();
+  }
+  instanceServer_.reset();
+}
+
 // CefLoadHandler methods
 //-----------------------
 
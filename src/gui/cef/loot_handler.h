@@ -27,13 +27,18 @@
 #define LOOT_GUI_LOOT_HANDLER
 
 #include <list>
+#include <memory>
+#include <thread>
 
 #include <include/cef_client.h>
 #include <include/wrapper/cef_message_router.h>
 
+#include "gui/cef/query/query_server.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
+class QueryHandler;
+
 class LootHandler : public CefClient,
                     public CefDisplayHandler,
                     public CefLifeSpanHandler,
@@ -104,15 +109,29 @@ public:
       CefRefPtr<CefRequest> request,
       CefRefPtr<CefRequestCallback> callback) OVERRIDE;
 
+  // Wait for the background threads that the handler started to finish.
+  // This must not be called on the CEF UI thread.
+  void joinThreads();
+
 private:
   typedef std::list<CefRefPtr<CefBrowser>> BrowserList;
 
+  // Handle the command lines that later instances of LOOT forward to this
+  // one on a background thread, using the given query handler.
+  void startInstanceServer(QueryHandler& queryHandler);
+  // Stop accepting command lines without waiting for the server's thread, as
+  // it may be waiting for the CEF UI thread.
+  void stopInstanceServer();
+
   // List of existing browser windows. Only accessed on the CEF UI thread.
   BrowserList browser_list_;
   CefRefPtr<CefMessageRouterBrowserSide> browser_side_router_;
 
   LootState& lootState_;
 
+  std::unique_ptr<QueryServer> instanceServer_;
+  std::thread instanceServerThread_;
+
   // Include the default reference counting implementation.
   IMPLEMENT_REFCOUNTING(LootHandler);
 };
@@ -31,19 +31,122 @@ along with LOOT.  If not, see
 #include <include/cef_parser.h>
 #include <include/wrapper/cef_stream_resource_handler.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include <string_view>
+
+#include <boost/algorithm/string.hpp>
 
 using namespace std;
 
 using std::filesystem::u8path;
 
 namespace loot {
+namespace {
+// Reads a cached resource without copying it, sharing ownership of the
+// resource so that it outlives the request.
+class ResourceReadHandler : public CefReadHandler {
+public:
+  explicit ResourceReadHandler(
+      std::shared_ptr<const LootSchemeHandlerFactory::Resource> resource) :
+      resource_(resource), offset_(0) {}
+
+  size_t Read(void* ptr, size_t size, size_t n) OVERRIDE {
+    if (size == 0) {
+      return 0;
+    }
+
+    auto itemsLeft = (resource_->data.size() - offset_) / size;
+    auto itemsToRead = std::min(n, itemsLeft);
+    std::memcpy(ptr, resource_->data.data() + offset_, itemsToRead * size);
+    offset_ += itemsToRead * size;
+
+    return itemsToRead;
+  }
+
+  int Seek(int64 offset, int whence) OVERRIDE {
+    int64 base = 0;
+    if (whence == SEEK_CUR) {
+      base = offset_;
+    } else if (whence == SEEK_END) {
+      base = resource_->data.size();
+    } else if (whence != SEEK_SET) {
+      return -1;
+    }
+
+    auto newOffset = base + offset;
+    if (newOffset < 0 ||
+        newOffset > static_cast<int64>(resource_->data.size())) {
+      return -1;
+    }
+
+    offset_ = static_cast<size_t>(newOffset);
+    return 0;
+  }
+
+  int64 Tell() OVERRIDE { return offset_; }
+
+  int Eof() OVERRIDE { return offset_ >= resource_->data.size() ? 1 : 0; }
+
+  bool MayBlock() OVERRIDE { return false; }
+
+private:
+  const std::shared_ptr<const LootSchemeHandlerFactory::Resource> resource_;
+  size_t offset_;
+
+  IMPLEMENT_REFCOUNTING(ResourceReadHandler);
+};
+
+std::string GetETag(std::string_view data) {
+  std::ostringstream etag;
+  etag << '"' << std::hex << std::hash<std::string_view>()(data) << '"';
+  return etag.str();
+}
+
+CefRefPtr<CefResourceHandler> CreateNotFoundHandler(
+    CefResponse::HeaderMap headers) {
+  const string error404 = "File not found.";
+  CefRefPtr<CefStreamReader> stream =
+      CefStreamReader::CreateForData((void*)error404.c_str(), error404.size());
+  return new CefStreamResourceHandler(
+      404, "Not Found", "text/plain", headers, stream);
+}
+}
+
 ///////////////////////////////
 // LootSchemeHandlerFactory
 ///////////////////////////////
 
 LootSchemeHandlerFactory::LootSchemeHandlerFactory(
-  std::filesystem::path resourcesPath) : resourcesPath_(resourcesPath) {}
+    std::filesystem::path resourcesPath,
+    bool cacheResources) :
+    resourcesPath_(resourcesPath), cacheResources_(cacheResources) {
+  auto archivePath = resourcesPath_ / "ui.pack";
+  if (!cacheResources_ || !std::filesystem::exists(archivePath)) {
+    return;
+  }
+
+  auto logger = getLogger();
+  try {
+    archive_ = std::make_shared<ResourceArchive>(archivePath);
+    if (logger) {
+      logger->info("Serving {} files from {}",
+                   archive_->Size(),
+                   archivePath.u8string());
+    }
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error(
+          "Failed to open {}, falling back to loose files. Details: {}",
+          archivePath.u8string(),
+          e.what());
+    }
+  }
+}
 
 CefRefPtr<CefResourceHandler> LootSchemeHandlerFactory::Create(
     CefRefPtr<CefBrowser> browser,
@@ -52,27 +155,56 @@ CefRefPtr<CefResourceHandler> LootSchemeHandlerFactory::Create(
     CefRefPtr<CefRequest> request) {
   auto logger = getLogger();
   if (logger) {
-    logger->info("Handling request to URL: {}", request->GetURL().ToString());
+    logger->debug("Handling request to URL: {}", request->GetURL().ToString());
   }
   auto filePath = GetPath(request->GetURL());
 
-  if (std::filesystem::exists(filePath)) {
-    return new CefStreamResourceHandler(
-        200,
-        "OK",
-        GetMimeType(filePath.u8string()),
-        GetHeaders(),
-        CefStreamReader::CreateForFile(filePath.u8string()));
+  if (!cacheResources_) {
+    if (std::filesystem::exists(filePath)) {
+      return new CefStreamResourceHandler(
+          200,
+          "OK",
+          GetMimeType(filePath),
+          GetHeaders(),
+          CefStreamReader::CreateForFile(filePath.u8string()));
+    }
+
+    if (logger) {
+      logger->trace("File {} not found, sending 404.", filePath.u8string());
+    }
+    return CreateNotFoundHandler(GetHeaders());
   }
 
-  if (logger) {
-    logger->trace("File {} not found, sending 404.", filePath.u8string());
+  auto resource = GetCachedResource(filePath);
+  if (!resource) {
+    if (logger) {
+      logger->trace("File {} not found, sending 404.", filePath.u8string());
+    }
+    return CreateNotFoundHandler(GetHeaders());
   }
-  const string error404 = "File not found.";
-  CefRefPtr<CefStreamReader> stream =
-      CefStreamReader::CreateForData((void*)error404.c_str(), error404.size());
+
+  auto headers = GetHeaders();
+  headers.emplace("ETag", resource->etag);
+  // The browser may keep a copy, but must check that it's still current.
+  headers.emplace("Cache-Control", "no-cache");
+
+  if (request->GetHeaderByName("If-None-Match").ToString() ==
+      resource->etag) {
+    static const string emptyBody;
+    return new CefStreamResourceHandler(
+        304,
+        "Not Modified",
+        resource->mimeType,
+        headers,
+        CefStreamReader::CreateForData((void*)emptyBody.c_str(), 0));
+  }
+
   return new CefStreamResourceHandler(
-      404, "Not Found", "text/plain", GetHeaders(), stream);
+      200,
+      "OK",
+      resource->mimeType,
+      headers,
+      CefStreamReader::CreateForHandler(new ResourceReadHandler(resource)));
 }
 
 std::filesystem::path LootSchemeHandlerFactory::GetPath(const CefString& url) const {
@@ -86,15 +218,26 @@ std::filesystem::path LootSchemeHandlerFactory::GetPath(const CefString& url) co
 }
 
 std::string LootSchemeHandlerFactory::GetMimeType(
-    const std::string& file) const {
-  if (file.substr(file.length() - 5) == ".html")
-    return "text/html";
-  else if (file.substr(file.length() - 3) == ".js")
-    return "application/javascript";
-  else if (file.substr(file.length() - 4) == ".css")
-    return "text/css";
-  else
-    return "application/octet-stream";
+    const std::filesystem::path& file) const {
+  static const std::unordered_map<std::string, std::string> MIME_TYPES = {
+      {".html", "text/html"},
+      {".js", "application/javascript"},
+      {".css", "text/css"},
+      {".json", "application/json"},
+      {".svg", "image/svg+xml"},
+      {".png", "image/png"},
+      {".woff", "font/woff"},
+      {".woff2", "font/woff2"},
+      {".ttf", "font/ttf"},
+  };
+
+  auto mimeType =
+      MIME_TYPES.find(boost::to_lower_copy(file.extension().u8string()));
+  if (mimeType != MIME_TYPES.end()) {
+    return mimeType->second;
+  }
+
+  return "application/octet-stream";
 }
 
 CefResponse::HeaderMap LootSchemeHandlerFactory::GetHeaders() const {
@@ -103,4 +246,76 @@ CefResponse::HeaderMap LootSchemeHandlerFactory::GetHeaders() const {
 
   return headers;
 }
+
+std::shared_ptr<const LootSchemeHandlerFactory::Resource>
+LootSchemeHandlerFactory::GetCachedResource(
+    const std::filesystem::path& filePath) {
+  auto key = filePath.lexically_normal().u8string();
+  {
+    lock_guard<mutex> guard(cacheMutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      return it->second;
+    }
+  }
+
+  // Read the file without holding the lock so that requests for other files
+  // aren't blocked. If two requests race to read the same file, the first
+  // result to be cached wins.
+  auto resource = ReadResource(filePath);
+
+  lock_guard<mutex> guard(cacheMutex_);
+  return cache_.emplace(key, resource).first->second;
+}
+
+std::shared_ptr<const LootSchemeHandlerFactory::Resource>
+LootSchemeHandlerFactory::ReadResource(
+    const std::filesystem::path& filePath) const {
+  // The archive only holds the UI's files, so other resources, like the
+  // l10n files, are read from the filesystem.
+  if (archive_) {
+    auto archivedPath =
+        filePath.lexically_relative(resourcesPath_).generic_u8string();
+    auto data = archive_->Find(archivedPath);
+    if (data.has_value()) {
+      auto resource = std::make_shared<Resource>();
+      resource->storage = archive_;
+      resource->data = data.value();
+      resource->mimeType = GetMimeType(filePath);
+      resource->etag = GetETag(resource->data);
+
+      return resource;
+    }
+  }
+
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(filePath, ec)) {
+    return nullptr;
+  }
+
+  std::ifstream in(filePath, std::ios::binary);
+  if (!in.is_open()) {
+    return nullptr;
+  }
+
+  auto resource = std::make_shared<Resource>();
+
+  std::ostringstream content;
+  content << in.rdbuf();
+  auto storage = std::make_shared<std::string>(content.str());
+
+  resource->storage = storage;
+  resource->data = *storage;
+  resource->mimeType = GetMimeType(filePath);
+  resource->etag = GetETag(resource->data);
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Cached {} bytes read from {}",
+                  resource->data.size(),
+                  filePath.u8string());
+  }
+
+  return resource;
+}
 }
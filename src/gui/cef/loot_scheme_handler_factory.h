@@ -27,14 +27,27 @@ along with LOOT.  If not, see
 #define LOOT_GUI_LOOT_SCHEME_HANDLER_FACTORY
 
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include <include/cef_base.h>
 #include <include/cef_scheme.h>
 
+#include "gui/cef/resource_archive.h"
+
 namespace loot {
 class LootSchemeHandlerFactory : public CefSchemeHandlerFactory {
 public:
-  LootSchemeHandlerFactory(std::filesystem::path resourcesPath);
+  // If cacheResources is true, each file is read once and then served from
+  // memory, so this should only be done for files that don't change while
+  // LOOT is running. Files are then read from a ui.pack archive in the
+  // resources directory if there is one, falling back to loose files if not,
+  // or if the archive doesn't hold the requested file.
+  LootSchemeHandlerFactory(std::filesystem::path resourcesPath,
+                           bool cacheResources = false);
 
   virtual CefRefPtr<CefResourceHandler> Create(
       CefRefPtr<CefBrowser> browser,
@@ -42,12 +55,31 @@ public:
       const CefString& scheme_name,
       CefRefPtr<CefRequest> request) OVERRIDE;
 
+  struct Resource {
+    // Owns the memory that data views.
+    std::shared_ptr<const void> storage;
+    std::string_view data;
+    std::string mimeType;
+    std::string etag;
+  };
+
 private:
   std::filesystem::path GetPath(const CefString& url) const;
-  std::string GetMimeType(const std::string& file) const;
+  std::string GetMimeType(const std::filesystem::path& file) const;
   CefResponse::HeaderMap GetHeaders() const;
 
+  std::shared_ptr<const Resource> GetCachedResource(
+      const std::filesystem::path& filePath);
+  std::shared_ptr<const Resource> ReadResource(
+      const std::filesystem::path& filePath) const;
+
   const std::filesystem::path resourcesPath_;
+  const bool cacheResources_;
+  std::shared_ptr<const ResourceArchive> archive_;
+
+  // Missing files are cached as null pointers.
+  std::mutex cacheMutex_;
+  std::unordered_map<std::string, std::shared_ptr<const Resource>> cache_;
 
   IMPLEMENT_REFCOUNTING(LootSchemeHandlerFactory);
 };
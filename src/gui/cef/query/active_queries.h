@@ -0,0 +1,118 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_ACTIVE_QUERIES
+#define LOOT_GUI_QUERY_ACTIVE_QUERIES
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "gui/cef/query/cancellation_token.h"
+
+namespace loot {
+// The cancellation tokens of the queries in progress. Each query is stored
+// under the ID that CEF's browser-side message router gave it, which is what
+// CEF passes when it cancels the query. The UI can't see those IDs, so a
+// query can also be stored under a cancellation ID that the UI sent with it.
+class ActiveQueries {
+public:
+  void add(int64_t queryId,
+           std::optional<int64_t> cancellationId,
+           std::shared_ptr<CancellationToken> token) {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    eraseLocked(queryId);
+    queries_.insert_or_assign(queryId, Entry{cancellationId, token});
+    if (cancellationId.has_value()) {
+      queryIds_.insert_or_assign(cancellationId.value(), queryId);
+    }
+  }
+
+  void remove(int64_t queryId) {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    eraseLocked(queryId);
+  }
+
+  // Returns false if there is no query with the given ID in progress.
+  bool cancel(int64_t queryId) {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    return cancelLocked(queryId);
+  }
+
+  // Returns false if there is no query with the given cancellation ID in
+  // progress.
+  bool cancelByCancellationId(int64_t cancellationId) {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto it = queryIds_.find(cancellationId);
+    if (it == queryIds_.end()) {
+      return false;
+    }
+
+    return cancelLocked(it->second);
+  }
+
+private:
+  struct Entry {
+    std::optional<int64_t> cancellationId;
+    std::shared_ptr<CancellationToken> token;
+  };
+
+  bool cancelLocked(int64_t queryId) {
+    auto it = queries_.find(queryId);
+    if (it == queries_.end()) {
+      return false;
+    }
+
+    it->second.token->cancel();
+    eraseLocked(queryId);
+
+    return true;
+  }
+
+  void eraseLocked(int64_t queryId) {
+    auto it = queries_.find(queryId);
+    if (it == queries_.end()) {
+      return;
+    }
+
+    if (it->second.cancellationId.has_value()) {
+      queryIds_.erase(it->second.cancellationId.value());
+    }
+    queries_.erase(it);
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<int64_t, Entry> queries_;
+  std::unordered_map<int64_t, int64_t> queryIds_;
+};
+}
+
+#endif
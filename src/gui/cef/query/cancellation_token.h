@@ -0,0 +1,60 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_CANCELLATION_TOKEN
+#define LOOT_GUI_QUERY_CANCELLATION_TOKEN
+
+#include <atomic>
+#include <stdexcept>
+
+namespace loot {
+class QueryCancelledError : public std::runtime_error {
+public:
+  QueryCancelledError() : std::runtime_error("The query was cancelled.") {}
+};
+
+// Shared between a query and whatever may want to cancel it. Cancellation is
+// cooperative: long-running work should poll the token and stop (by throwing
+// a QueryCancelledError) once it has been cancelled.
+class CancellationToken {
+public:
+  CancellationToken() : isCancelled_(false) {}
+
+  void cancel() { isCancelled_ = true; }
+
+  bool isCancelled() const { return isCancelled_; }
+
+  void throwIfCancelled() const {
+    if (isCancelled_) {
+      throw QueryCancelledError();
+    }
+  }
+
+private:
+  std::atomic<bool> isCancelled_;
+};
+}
+
+#endif
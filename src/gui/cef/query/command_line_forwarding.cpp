@@ -0,0 +1,99 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/command_line_forwarding.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+#include "gui/cef/query/local_socket.h"
+
+namespace loot {
+static constexpr const char* INSTANCE_ENDPOINT_NAME = "LOOT.Shell.Instance";
+static constexpr const char* FORWARD_COMMAND_LINE_QUERY = "forwardCommandLine";
+
+std::string GetInstanceEndpointName() {
+  std::string name = INSTANCE_ENDPOINT_NAME;
+
+#ifdef _WIN32
+  DWORD sessionId = 0;
+  if (ProcessIdToSessionId(GetCurrentProcessId(), &sessionId)) {
+    name += "." + std::to_string(sessionId);
+  }
+#endif
+
+  return name;
+}
+
+nlohmann::json ForwardCommandLine(const std::string& endpointName,
+                                  const std::string& gameFolder,
+                                  bool autoSort) {
+  LocalConnection connection(endpointName);
+
+  nlohmann::json request = {
+      {"name", FORWARD_COMMAND_LINE_QUERY},
+      {"game", gameFolder},
+      {"autoSort", autoSort},
+  };
+  connection.WriteMessage(request.dump());
+
+  const auto message = connection.ReadMessage();
+  if (!message.has_value()) {
+    throw std::runtime_error(
+        "The running instance of LOOT closed the connection without "
+        "replying");
+  }
+
+  const auto reply = nlohmann::json::parse(message.value());
+  if (reply.contains("error")) {
+    throw std::runtime_error(reply.at("error").get<std::string>());
+  }
+
+  return nlohmann::json::parse(reply.at("response").get<std::string>());
+}
+
+QueryRunner GetForwardedCommandLineRunner(CommandLineHandler handler) {
+  return [handler](nlohmann::json request) {
+    const std::string name = request.at("name");
+    if (name != FORWARD_COMMAND_LINE_QUERY) {
+      throw std::invalid_argument("Unknown query \"" + name + "\"");
+    }
+
+    return handler(request.at("game"), request.at("autoSort")).dump();
+  };
+}
+}
@@ -0,0 +1,64 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_COMMAND_LINE_FORWARDING
+#define LOOT_GUI_QUERY_COMMAND_LINE_FORWARDING
+
+#include <functional>
+#include <string>
+
+#include <json.hpp>
+
+#include "gui/cef/query/query_server.h"
+
+namespace loot {
+// Get the name of the pipe that the first instance of LOOT listens on for the
+// command lines of later instances. Pipe names are machine-wide, unlike the
+// mutex that tells later instances that LOOT is already running, so the name
+// includes the current session's ID to match the mutex's scope.
+std::string GetInstanceEndpointName();
+
+// Changes the current game to the given game, unless it's empty, then sorts
+// the game's load order if autoSort is true. Returns the result as JSON, or
+// throws if the command line can't be handled.
+typedef std::function<nlohmann::json(const std::string& gameFolder,
+                                     bool autoSort)>
+    CommandLineHandler;
+
+// Send the --game and --auto-sort options of this instance's command line to
+// the instance of LOOT listening on the given endpoint, and wait for it to
+// handle them. Returns the result that the other instance sent back. Throws
+// a std::system_error if no instance is listening, and a std::runtime_error
+// if the other instance fails to handle the command line.
+nlohmann::json ForwardCommandLine(const std::string& endpointName,
+                                  const std::string& gameFolder,
+                                  bool autoSort);
+
+// Get a QueryRunner that passes the command lines forwarded to a QueryServer
+// to the given handler, and rejects any other request.
+QueryRunner GetForwardedCommandLineRunner(CommandLineHandler handler);
+}
+
+#endif
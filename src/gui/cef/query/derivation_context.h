@@ -0,0 +1,134 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_DERIVATION_CONTEXT
+#define LOOT_GUI_QUERY_DERIVATION_CONTEXT
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <loot/api.h>
+
+#include "gui/helpers.h"
+#include "gui/state/game/bash_tag_set.h"
+#include "gui/state/game/string_pool.h"
+
+namespace loot {
+// Holds the state that is shared by the derivation of each plugin's metadata
+// for a response, so that it only needs to be looked up once per response
+// instead of once per plugin. A context can be used by multiple threads at
+// once, as it is not modified after it is created.
+class DerivationContext {
+public:
+  // Create a context for the given load order, which may differ from the
+  // game's current load order (e.g. if it is a sorted load order that has not
+  // yet been applied).
+  template<typename G>
+  DerivationContext(const G& game,
+                    const std::vector<std::string>& loadOrder,
+                    std::string language) :
+      language_(gui::GetStringPool().Intern(language)),
+      bashTagTable_(game.GetBashTagTable()) {
+    // Count the number of active plugins before each active plugin in the
+    // load order. Light masters are counted separately from other plugins,
+    // and active plugins that aren't loaded have no index.
+    short numberOfActiveLightMasters = 0;
+    short numberOfActiveNormalPlugins = 0;
+    for (const auto& pluginName : loadOrder) {
+      if (!game.IsPluginActive(pluginName)) {
+        continue;
+      }
+
+      auto plugin = game.GetPlugin(pluginName);
+      if (!plugin) {
+        activePlugins_.emplace(NormalizeFilename(pluginName), std::nullopt);
+        continue;
+      }
+
+      auto& counter = plugin->IsLightMaster() ? numberOfActiveLightMasters
+                                              : numberOfActiveNormalPlugins;
+      activePlugins_.emplace(NormalizeFilename(pluginName), counter);
+      ++counter;
+    }
+  }
+
+  // Create a context that only holds the given plugin's state in the game's
+  // current load order, for when only that plugin's metadata is derived.
+  template<typename G>
+  static DerivationContext forPlugin(
+      const G& game,
+      const std::shared_ptr<const PluginInterface>& plugin,
+      std::string language) {
+    DerivationContext context(language);
+    context.bashTagTable_ = game.GetBashTagTable();
+    if (game.IsPluginActive(plugin->GetName())) {
+      context.activePlugins_.emplace(NormalizeFilename(plugin->GetName()),
+                                     game.GetActiveLoadOrderIndex(plugin));
+    }
+
+    return context;
+  }
+
+  const std::string& getLanguage() const { return *language_; }
+
+  // The language is pooled so that each plugin's derived metadata can share
+  // it instead of holding a copy.
+  const gui::PooledString& getPooledLanguage() const { return language_; }
+
+  // Plugins' Bash Tags are encoded using the game's known tags. The table is
+  // shared by all contexts until the game's metadata lists change.
+  const std::shared_ptr<const gui::BashTagTable>& getBashTagTable() const {
+    return bashTagTable_;
+  }
+
+  bool isActive(const std::string& pluginName) const {
+    return activePlugins_.count(NormalizeFilename(pluginName)) != 0;
+  }
+
+  std::optional<short> getActiveLoadOrderIndex(
+      const std::string& pluginName) const {
+    auto it = activePlugins_.find(NormalizeFilename(pluginName));
+    if (it == activePlugins_.end()) {
+      return std::nullopt;
+    }
+
+    return it->second;
+  }
+
+private:
+  explicit DerivationContext(std::string language) :
+      language_(gui::GetStringPool().Intern(language)) {}
+
+  gui::PooledString language_;
+  std::shared_ptr<const gui::BashTagTable> bashTagTable_;
+  // Keyed by normalised filename, and only holds active plugins.
+  std::unordered_map<std::string, std::optional<short>> activePlugins_;
+};
+}
+
+#endif
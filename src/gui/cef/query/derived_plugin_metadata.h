@@ -31,36 +31,52 @@ along with LOOT.  If not, see
 #include <loot/api.h>
 #include <json.hpp>
 
+#include "gui/cef/query/derivation_context.h"
+#include "gui/state/game/bash_tag_set.h"
 #include "gui/state/game/game.h"
+#include "gui/state/game/string_pool.h"
 
 namespace loot {
+class JsonWriter;
+
 template<typename G>
 class DerivedPluginMetadata {
 public:
   DerivedPluginMetadata(const std::shared_ptr<const PluginInterface>& file,
-                        const G& game,
-                        std::string language) :
+                        const DerivationContext& context) :
       name(file->GetName()),
       version(file->GetVersion()),
-      isActive(game.IsPluginActive(file->GetName())),
+      isActive(context.isActive(file->GetName())),
       isDirty(false),
       isEmpty(file->IsEmpty()),
       isMaster(file->IsMaster()),
       isLightMaster(file->IsLightMaster()),
       loadsArchive(file->LoadsArchive()),
       crc(file->GetCRC()),
-      loadOrderIndex(game.GetActiveLoadOrderIndex(file, game.GetLoadOrder())),
-      currentTags(file->GetBashTags()),
-      language(language) {}
+      loadOrderIndex(context.getActiveLoadOrderIndex(file->GetName())),
+      currentTags(context.getBashTagTable(), file->GetBashTags()),
+      suggestedTags(context.getBashTagTable()),
+      language(context.getPooledLanguage()) {}
+
+  // Plugins that only have their headers loaded have no CRC, but their game
+  // may have cached it from when they were last fully loaded.
+  void setCRC(std::optional<uint32_t> pluginCrc) { crc = pluginCrc; }
 
+  // Group names and cleaning utility names are shared by many plugins, so
+  // are pooled.
   void setEvaluatedMetadata(PluginMetadata metadata) {
     isDirty = !metadata.GetDirtyInfo().empty();
-    group = metadata.GetGroup();
+    if (metadata.GetGroup().has_value()) {
+      group = gui::GetStringPool().Intern(metadata.GetGroup().value());
+    }
     if (!metadata.GetCleanInfo().empty()) {
-      cleanedWith = metadata.GetCleanInfo().begin()->GetCleaningUtility();
+      cleanedWith = gui::GetStringPool().Intern(
+          metadata.GetCleanInfo().begin()->GetCleaningUtility());
+    }
+    messages = metadata.GetSimpleMessages(*language);
+    for (const auto& tag : metadata.GetTags()) {
+      suggestedTags.Add(tag);
     }
-    messages = metadata.GetSimpleMessages(language);
-    suggestedTags = metadata.GetTags();
   }
 
   void setMasterlistMetadata(PluginMetadata masterlistEntry) {
@@ -71,10 +87,6 @@ public:
     this->userMetadata = userlistEntry;
   }
 
-  void setLoadOrderIndex(short loadOrderIndex) {
-    this->loadOrderIndex = loadOrderIndex;
-  }
-
 private:
   std::string name;
   std::optional<std::string> version;
@@ -88,20 +100,25 @@ private:
   std::optional<uint32_t> crc;
   std::optional<short> loadOrderIndex;
 
-  std::optional<std::string> group;
-  std::string cleanedWith;
+  // Null if the plugin has no group or no cleaning data.
+  gui::PooledString group;
+  gui::PooledString cleanedWith;
   std::vector<SimpleMessage> messages;
-  std::set<Tag> currentTags;
-  std::set<Tag> suggestedTags;
+  gui::BashTagSet currentTags;
+  gui::BashTagSet suggestedTags;
 
   std::optional<PluginMetadata> masterlistMetadata;
   std::optional<PluginMetadata> userMetadata;
 
-  std::string language;
+  gui::PooledString language;
 
   template<typename T>
   friend void to_json(nlohmann::json& json,
                       const DerivedPluginMetadata<T>& plugin);
+
+  template<typename T>
+  friend void write_json(JsonWriter& writer,
+                         const DerivedPluginMetadata<T>& plugin);
 };
 }
 
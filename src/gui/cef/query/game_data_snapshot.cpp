@@ -0,0 +1,192 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/game_data_snapshot.h"
+
+#include <fstream>
+
+#include "gui/state/binary_io.h"
+#include "gui/state/logging.h"
+
+namespace fs = std::filesystem;
+
+namespace loot {
+namespace {
+constexpr char MAGIC[] = {'L', 'O', 'O', 'T', 'G', 'D', 'S', '\0'};
+}
+
+GameDataSnapshot::GameDataSnapshot(
+    std::string metadataKey,
+    std::unordered_map<std::string, gui::PluginFingerprint> fingerprints,
+    std::string response) :
+    metadataKey_(std::move(metadataKey)),
+    fingerprints_(std::move(fingerprints)),
+    response_(std::move(response)) {}
+
+void GameDataSnapshot::Load(const fs::path& snapshotPath) {
+  *this = GameDataSnapshot();
+
+  if (!fs::exists(snapshotPath)) {
+    return;
+  }
+
+  auto logger = getLogger();
+  try {
+    std::ifstream in(snapshotPath, std::ios::binary);
+    in.exceptions(std::ios::badbit);
+
+    auto version = ReadBinaryHeader(in, MAGIC);
+    if (version != VERSION) {
+      if (logger) {
+        logger->info("Ignoring game data snapshot with unsupported version {}.",
+                     version);
+      }
+      return;
+    }
+
+    GameDataSnapshot snapshot;
+    snapshot.metadataKey_ = ReadBinaryString<uint32_t>(in);
+
+    auto fingerprintCount = ReadBinary<uint64_t>(in);
+    for (uint64_t i = 0; i < fingerprintCount; ++i) {
+      auto filename = ReadBinaryString<uint32_t>(in);
+
+      gui::PluginFingerprint fingerprint;
+      fingerprint.fileSize = ReadBinary<uint64_t>(in);
+      fingerprint.modificationTime = fs::file_time_type(
+          fs::file_time_type::duration(ReadBinary<int64_t>(in)));
+      if (ReadBinary<uint8_t>(in) != 0) {
+        fingerprint.crc = ReadBinary<uint32_t>(in);
+      }
+      fingerprint.isActive = ReadBinary<uint8_t>(in) != 0;
+
+      snapshot.fingerprints_.emplace(filename, fingerprint);
+    }
+
+    snapshot.response_ = ReadBinaryString<uint64_t>(in);
+
+    *this = std::move(snapshot);
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->warn("Failed to read game data snapshot at \"{}\": {}",
+                   snapshotPath.u8string(),
+                   e.what());
+    }
+  }
+}
+
+void GameDataSnapshot::Save(const fs::path& snapshotPath) const {
+  WriteBinaryFile(snapshotPath, [&](std::ostream& out) {
+    WriteBinaryHeader(out, MAGIC, VERSION);
+    WriteBinaryString<uint32_t>(out, metadataKey_);
+    WriteBinary<uint64_t>(out, fingerprints_.size());
+    for (const auto& entry : fingerprints_) {
+      WriteBinaryString<uint32_t>(out, entry.first);
+      WriteBinary<uint64_t>(out, entry.second.fileSize);
+      WriteBinary<int64_t>(
+          out, entry.second.modificationTime.time_since_epoch().count());
+      WriteBinary<uint8_t>(out, entry.second.crc.has_value() ? 1 : 0);
+      if (entry.second.crc.has_value()) {
+        WriteBinary<uint32_t>(out, entry.second.crc.value());
+      }
+      WriteBinary<uint8_t>(out, entry.second.isActive ? 1 : 0);
+    }
+    WriteBinaryString<uint64_t>(out, response_);
+  });
+}
+
+bool GameDataSnapshot::IsEmpty() const { return response_.empty(); }
+
+const std::string& GameDataSnapshot::GetMetadataKey() const {
+  return metadataKey_;
+}
+
+const std::unordered_map<std::string, gui::PluginFingerprint>&
+GameDataSnapshot::GetPluginFingerprints() const {
+  return fingerprints_;
+}
+
+const std::string& GameDataSnapshot::GetResponse() const { return response_; }
+
+std::string GameDataSnapshot::GetProvisionalResponse() const {
+  // Splice the field into the stored text rather than parsing the whole
+  // response just to add it.
+  static const std::string PROVISIONAL_FIELD = "\"provisional\":true";
+
+  auto bodyStart = response_.find_first_not_of(" \t\r\n", 1);
+  if (response_.empty() || response_.front() != '{' ||
+      bodyStart == std::string::npos) {
+    throw std::runtime_error("The game data snapshot is not a JSON object");
+  }
+
+  const bool isEmptyObject = response_[bodyStart] == '}';
+  return "{" + PROVISIONAL_FIELD + (isEmptyObject ? "" : ",") +
+         response_.substr(1);
+}
+
+void GameDataSnapshot::ApplyDelta(
+    const nlohmann::json& delta,
+    std::string metadataKey,
+    std::unordered_map<std::string, gui::PluginFingerprint> fingerprints) {
+  auto gameData = nlohmann::json::parse(response_);
+
+  std::unordered_map<std::string, nlohmann::json> plugins;
+  for (auto& plugin : gameData.at("plugins")) {
+    std::string name = plugin.at("name");
+    plugins.emplace(name, std::move(plugin));
+  }
+  for (const auto& plugin : delta.at("plugins")) {
+    plugins.insert_or_assign(plugin.at("name"), plugin);
+  }
+
+  auto loadOrderPlugins = nlohmann::json::array();
+  for (const auto& item : delta.at("loadOrder")) {
+    auto it = plugins.find(item.at("name"));
+    if (it == plugins.end()) {
+      continue;
+    }
+
+    auto plugin = std::move(it->second);
+    auto loadOrderIndex = item.find("loadOrderIndex");
+    if (loadOrderIndex != item.end()) {
+      plugin["loadOrderIndex"] = *loadOrderIndex;
+    } else {
+      plugin.erase("loadOrderIndex");
+    }
+    loadOrderPlugins.push_back(std::move(plugin));
+  }
+
+  for (const auto& field : delta.items()) {
+    if (field.key() != "loadOrder" && field.key() != "plugins") {
+      gameData[field.key()] = field.value();
+    }
+  }
+  gameData["plugins"] = std::move(loadOrderPlugins);
+
+  metadataKey_ = std::move(metadataKey);
+  fingerprints_ = std::move(fingerprints);
+  response_ = gameData.dump();
+}
+}
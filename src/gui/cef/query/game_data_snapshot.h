@@ -0,0 +1,107 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_GAME_DATA_SNAPSHOT
+#define LOOT_GUI_QUERY_GAME_DATA_SNAPSHOT
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include <json.hpp>
+
+#include "gui/state/game/plugin_fingerprint.h"
+
+namespace loot {
+/**
+ * @brief A persistent copy of the last full getGameData response for a game,
+ *        with the inputs that it was derived from.
+ * @details The snapshot is shown while LOOT loads the game's data on startup,
+ *          and the inputs are compared with the loaded data to find the
+ *          plugins whose derived metadata may have changed since.
+ */
+class GameDataSnapshot {
+public:
+  GameDataSnapshot() = default;
+
+  /**
+   * The metadata key identifies everything other than the plugins themselves
+   * that the response's derived metadata depends on, e.g. the language and
+   * the metadata lists, so that if it changes all plugins must be derived
+   * again. The fingerprints are keyed by normalised plugin filename.
+   */
+  GameDataSnapshot(
+      std::string metadataKey,
+      std::unordered_map<std::string, gui::PluginFingerprint> fingerprints,
+      std::string response);
+
+  /**
+   * Load the snapshot from the given file. If the file doesn't exist, was
+   * written by an incompatible version of LOOT or is corrupt, the snapshot is
+   * left empty.
+   */
+  void Load(const std::filesystem::path& snapshotPath);
+
+  /**
+   * Write the snapshot to the given file, replacing any existing file.
+   */
+  void Save(const std::filesystem::path& snapshotPath) const;
+
+  bool IsEmpty() const;
+
+  const std::string& GetMetadataKey() const;
+  const std::unordered_map<std::string, gui::PluginFingerprint>&
+  GetPluginFingerprints() const;
+  const std::string& GetResponse() const;
+
+  /**
+   * Get the response with a "provisional" field set to true, so that the UI
+   * can tell it apart from live data.
+   */
+  std::string GetProvisionalResponse() const;
+
+  /**
+   * Update the response with a delta response, which holds the game's
+   * current data, its load order and the plugins that have changed, and
+   * replace the snapshot's inputs with those that the delta was derived from.
+   * Plugins that aren't in the delta's load order are removed, and unchanged
+   * plugins get their load order index from it.
+   */
+  void ApplyDelta(
+      const nlohmann::json& delta,
+      std::string metadataKey,
+      std::unordered_map<std::string, gui::PluginFingerprint> fingerprints);
+
+private:
+  static constexpr uint32_t VERSION = 1;
+
+  std::string metadataKey_;
+  std::unordered_map<std::string, gui::PluginFingerprint> fingerprints_;
+  std::string response_;
+};
+}
+
+#endif
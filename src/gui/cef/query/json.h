@@ -33,6 +33,8 @@ along with LOOT.  If not, see
 #include <loot/api.h>
 
 #include "gui/cef/query/derived_plugin_metadata.h"
+#include "gui/cef/query/json_writer.h"
+#include "gui/state/game/sort_profile.h"
 #include "gui/state/loot_settings.h"
 
 namespace loot {
@@ -272,6 +274,26 @@ void to_json(nlohmann::json& json, const MasterlistInfo& info) {
   };
 }
 
+namespace gui {
+void to_json(nlohmann::json& json, const SortProfile::Stage& stage) {
+  json = {
+    { "name", stage.name },
+    { "microseconds", stage.microseconds },
+  };
+}
+
+void to_json(nlohmann::json& json, const SortProfile& profile) {
+  json = {
+    { "stages", profile.stages },
+    { "pluginCount", profile.pluginCount },
+    { "movedPluginCount", profile.movedPluginCount },
+    { "reusedLastResult", profile.reusedLastResult },
+    { "edgeCounts", profile.edgeCounts },
+    { "overlapCandidatePairs", profile.overlapCandidatePairs },
+  };
+}
+}
+
 void to_json(nlohmann::json& json, const GameSettings& game) {
   json = {
     { "type", GameSettings(game.Type()).FolderName() },
@@ -391,8 +413,8 @@ void to_json(nlohmann::json& json, const DerivedPluginMetadata<G>& plugin) {
     { "isLightMaster", plugin.isLightMaster },
     { "loadsArchive", plugin.loadsArchive },
     { "messages", plugin.messages },
-    { "suggestedTags", plugin.suggestedTags },
-    { "currentTags", plugin.currentTags },
+    { "suggestedTags", plugin.suggestedTags.ToTags() },
+    { "currentTags", plugin.currentTags.ToTags() },
   };
 
   if (plugin.version.has_value()) {
@@ -403,26 +425,226 @@ void to_json(nlohmann::json& json, const DerivedPluginMetadata<G>& plugin) {
     json["crc"] = plugin.crc.value();
   }
 
-  if (plugin.group.has_value()) {
-    json["group"] = plugin.group.value();
+  if (plugin.group) {
+    json["group"] = *plugin.group;
   }
 
   if (plugin.loadOrderIndex.has_value()) {
     json["loadOrderIndex"] = plugin.loadOrderIndex.value();
   }
 
-  if (!plugin.cleanedWith.empty()) {
-    json["cleanedWith"] = plugin.cleanedWith;
+  if (plugin.cleanedWith && !plugin.cleanedWith->empty()) {
+    json["cleanedWith"] = *plugin.cleanedWith;
   }
 
   if (plugin.masterlistMetadata.has_value()) {
-    json["masterlist"] = to_json_with_language(plugin.masterlistMetadata.value(), plugin.language);
+    json["masterlist"] = to_json_with_language(plugin.masterlistMetadata.value(), *plugin.language);
   }
 
   if (plugin.userMetadata.has_value()) {
-    json["userlist"] = to_json_with_language(plugin.userMetadata.value(), plugin.language);
+    json["userlist"] = to_json_with_language(plugin.userMetadata.value(), *plugin.language);
   }
 }
+
+// The write_json() overloads produce the same output as serialising the
+// result of the equivalent to_json() overload, but without building a JSON
+// tree first. Object keys must be written in lexicographical order to match
+// nlohmann::json's ordering.
+template<typename Container>
+void write_json_array(JsonWriter& writer, const Container& container) {
+  writer.startArray();
+  for (const auto& element : container) {
+    write_json(writer, element);
+  }
+  writer.endArray();
+}
+
+void write_json(JsonWriter& writer, const MessageType& type) {
+  if (type == MessageType::say) {
+    writer.value("say");
+  } else if (type == MessageType::warn) {
+    writer.value("warn");
+  } else {
+    writer.value("error");
+  }
+}
+
+void write_json(JsonWriter& writer, const SimpleMessage& message) {
+  writer.startObject();
+  writer.key("condition");
+  writer.value(message.condition);
+  writer.key("language");
+  writer.value(message.language);
+  writer.key("text");
+  writer.value(message.text);
+  writer.key("type");
+  write_json(writer, message.type);
+  writer.endObject();
+}
+
+void write_json(JsonWriter& writer, const Tag& tag) {
+  writer.startObject();
+  writer.key("condition");
+  writer.value(tag.GetCondition());
+  writer.key("isAddition");
+  writer.value(tag.IsAddition());
+  writer.key("name");
+  writer.value(tag.GetName());
+  writer.endObject();
+}
+
+void write_json(JsonWriter& writer, const gui::BashTagSet& tags) {
+  writer.startArray();
+  tags.ForEach([&](const Tag& tag) { write_json(writer, tag); });
+  writer.endArray();
+}
+
+void write_json(JsonWriter& writer, const MessageContent& content) {
+  writer.startObject();
+  writer.key("language");
+  writer.value(content.GetLanguage());
+  writer.key("text");
+  writer.value(content.GetText());
+  writer.endObject();
+}
+
+void write_json(JsonWriter& writer, const PluginCleaningData& data) {
+  writer.startObject();
+  writer.key("crc");
+  writer.value(data.GetCRC());
+  writer.key("info");
+  write_json_array(writer, data.GetInfo());
+  writer.key("itm");
+  writer.value(data.GetITMCount());
+  writer.key("nav");
+  writer.value(data.GetDeletedNavmeshCount());
+  writer.key("udr");
+  writer.value(data.GetDeletedReferenceCount());
+  writer.key("util");
+  writer.value(data.GetCleaningUtility());
+  writer.endObject();
+}
+
+void write_json(JsonWriter& writer, const File& file) {
+  writer.startObject();
+  writer.key("condition");
+  writer.value(file.GetCondition());
+  writer.key("display");
+  writer.value(file.GetDisplayName());
+  writer.key("name");
+  writer.value(file.GetName());
+  writer.endObject();
+}
+
+void write_json(JsonWriter& writer, const Location& location) {
+  writer.startObject();
+  writer.key("link");
+  writer.value(location.GetURL());
+  writer.key("name");
+  writer.value(location.GetName());
+  writer.endObject();
+}
+
+void write_json_with_language(JsonWriter& writer,
+                              const PluginMetadata& metadata,
+                              const std::string& language) {
+  writer.startObject();
+  writer.key("after");
+  write_json_array(writer, metadata.GetLoadAfterFiles());
+  writer.key("clean");
+  write_json_array(writer, metadata.GetCleanInfo());
+  writer.key("dirty");
+  write_json_array(writer, metadata.GetDirtyInfo());
+  writer.key("enabled");
+  writer.value(metadata.IsEnabled());
+
+  if (metadata.GetGroup().has_value()) {
+    writer.key("group");
+    writer.value(metadata.GetGroup().value());
+  }
+
+  writer.key("inc");
+  write_json_array(writer, metadata.GetIncompatibilities());
+  writer.key("msg");
+  write_json_array(writer, metadata.GetSimpleMessages(language));
+  writer.key("name");
+  writer.value(metadata.GetName());
+  writer.key("req");
+  write_json_array(writer, metadata.GetRequirements());
+  writer.key("tag");
+  write_json_array(writer, metadata.GetTags());
+  writer.key("url");
+  write_json_array(writer, metadata.GetLocations());
+  writer.endObject();
+}
+
+template<typename G>
+void write_json(JsonWriter& writer, const DerivedPluginMetadata<G>& plugin) {
+  writer.startObject();
+
+  if (plugin.cleanedWith && !plugin.cleanedWith->empty()) {
+    writer.key("cleanedWith");
+    writer.value(*plugin.cleanedWith);
+  }
+
+  if (plugin.crc.has_value()) {
+    writer.key("crc");
+    writer.value(plugin.crc.value());
+  }
+
+  writer.key("currentTags");
+  write_json(writer, plugin.currentTags);
+
+  if (plugin.group) {
+    writer.key("group");
+    writer.value(*plugin.group);
+  }
+
+  writer.key("isActive");
+  writer.value(plugin.isActive);
+  writer.key("isDirty");
+  writer.value(plugin.isDirty);
+  writer.key("isEmpty");
+  writer.value(plugin.isEmpty);
+  writer.key("isLightMaster");
+  writer.value(plugin.isLightMaster);
+  writer.key("isMaster");
+  writer.value(plugin.isMaster);
+
+  if (plugin.loadOrderIndex.has_value()) {
+    writer.key("loadOrderIndex");
+    writer.value(plugin.loadOrderIndex.value());
+  }
+
+  writer.key("loadsArchive");
+  writer.value(plugin.loadsArchive);
+
+  if (plugin.masterlistMetadata.has_value()) {
+    writer.key("masterlist");
+    write_json_with_language(
+        writer, plugin.masterlistMetadata.value(), *plugin.language);
+  }
+
+  writer.key("messages");
+  write_json_array(writer, plugin.messages);
+  writer.key("name");
+  writer.value(plugin.name);
+  writer.key("suggestedTags");
+  write_json(writer, plugin.suggestedTags);
+
+  if (plugin.userMetadata.has_value()) {
+    writer.key("userlist");
+    write_json_with_language(
+        writer, plugin.userMetadata.value(), *plugin.language);
+  }
+
+  if (plugin.version.has_value()) {
+    writer.key("version");
+    writer.value(plugin.version.value());
+  }
+
+  writer.endObject();
+}
 }
 
 #endif
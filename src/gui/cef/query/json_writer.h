@@ -0,0 +1,252 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_JSON_WRITER
+#define LOOT_GUI_QUERY_JSON_WRITER
+
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <json.hpp>
+
+namespace loot {
+// Serialises JSON directly into a string buffer, without building an
+// intermediate nlohmann::json tree. The output is formatted the same way as
+// nlohmann::json::dump() with its default arguments, but it's up to the caller
+// to write object keys in the same (lexicographical) order as nlohmann::json
+// would store them. Keys and values are written straight from the given
+// views, so writing them doesn't allocate any temporary strings.
+class JsonWriter {
+public:
+  JsonWriter() : expectingValue_(false) {}
+
+  void reserve(size_t size) { buffer_.reserve(size); }
+
+  size_t size() const { return buffer_.size(); }
+
+  void startObject() {
+    beforeValue();
+    buffer_ += '{';
+    hasElements_.push_back(false);
+  }
+
+  void endObject() {
+    buffer_ += '}';
+    hasElements_.pop_back();
+  }
+
+  void startArray() {
+    beforeValue();
+    buffer_ += '[';
+    hasElements_.push_back(false);
+  }
+
+  void endArray() {
+    buffer_ += ']';
+    hasElements_.pop_back();
+  }
+
+  void key(std::string_view key) {
+    beforeValue();
+    writeString(key);
+    buffer_ += ':';
+    expectingValue_ = true;
+  }
+
+  void value(std::string_view value) {
+    beforeValue();
+    writeString(value);
+  }
+
+  // These overloads stop strings from being converted to bool or to
+  // nlohmann::json trees instead.
+  void value(const std::string& value) { this->value(std::string_view(value)); }
+
+  void value(const char* value) { this->value(std::string_view(value)); }
+
+  void value(bool value) {
+    beforeValue();
+    buffer_ += value ? "true" : "false";
+  }
+
+  template<typename T>
+  std::enable_if_t<std::is_integral_v<T>> value(T value) {
+    beforeValue();
+
+    // Enough for any 64-bit integer, including its sign.
+    char digits[20];
+    const auto result =
+        std::to_chars(std::begin(digits), std::end(digits), value);
+    buffer_.append(digits, result.ptr);
+  }
+
+  // Small or irregular values that already exist as nlohmann::json trees can
+  // be written as they are.
+  void value(const nlohmann::json& value) {
+    beforeValue();
+    buffer_ += value.dump();
+  }
+
+  // Write a value that has already been serialised, e.g. by another writer.
+  void serialisedValue(const std::string& json) {
+    beforeValue();
+    buffer_ += json;
+  }
+
+  // Write a comma-separated sequence of array elements that have already been
+  // serialised, e.g. by another thread. Does nothing if the sequence is empty.
+  void serialisedElements(const std::string& json) {
+    if (json.empty()) {
+      return;
+    }
+
+    beforeValue();
+    buffer_ += json;
+  }
+
+  std::string release() {
+    hasElements_.clear();
+    expectingValue_ = false;
+    return std::move(buffer_);
+  }
+
+private:
+  void beforeValue() {
+    if (expectingValue_) {
+      expectingValue_ = false;
+    } else if (!hasElements_.empty()) {
+      if (hasElements_.back()) {
+        buffer_ += ',';
+      } else {
+        hasElements_.back() = true;
+      }
+    }
+  }
+
+  // Escapes strings the same way as nlohmann::json, which only escapes quotes,
+  // backslashes and control characters, and passes through valid UTF-8 as-is.
+  void writeString(std::string_view value) {
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    buffer_ += '"';
+
+    for (size_t i = 0; i < value.size(); ++i) {
+      const auto byte = static_cast<unsigned char>(value[i]);
+      switch (byte) {
+        case '"':
+          buffer_ += "\\\"";
+          break;
+        case '\\':
+          buffer_ += "\\\\";
+          break;
+        case '\b':
+          buffer_ += "\\b";
+          break;
+        case '\f':
+          buffer_ += "\\f";
+          break;
+        case '\n':
+          buffer_ += "\\n";
+          break;
+        case '\r':
+          buffer_ += "\\r";
+          break;
+        case '\t':
+          buffer_ += "\\t";
+          break;
+        default:
+          if (byte <= 0x1F) {
+            buffer_ += "\\u00";
+            buffer_ += HEX_DIGITS[byte >> 4];
+            buffer_ += HEX_DIGITS[byte & 0xF];
+          } else if (byte < 0x80) {
+            buffer_ += static_cast<char>(byte);
+          } else {
+            const size_t length = getUtf8SequenceLength(value, i);
+            buffer_.append(value.substr(i, length));
+            i += length - 1;
+          }
+      }
+    }
+
+    buffer_ += '"';
+  }
+
+  // Get the length of the multi-byte UTF-8 sequence that starts at the given
+  // index, throwing if it is not valid UTF-8.
+  static size_t getUtf8SequenceLength(std::string_view value, size_t index) {
+    const auto byte = static_cast<unsigned char>(value[index]);
+
+    size_t length = 0;
+    unsigned char minSecondByte = 0x80;
+    unsigned char maxSecondByte = 0xBF;
+    if (byte >= 0xC2 && byte <= 0xDF) {
+      length = 2;
+    } else if (byte >= 0xE0 && byte <= 0xEF) {
+      length = 3;
+      if (byte == 0xE0) {
+        minSecondByte = 0xA0;  // Overlong encoding.
+      } else if (byte == 0xED) {
+        maxSecondByte = 0x9F;  // UTF-16 surrogate.
+      }
+    } else if (byte >= 0xF0 && byte <= 0xF4) {
+      length = 4;
+      if (byte == 0xF0) {
+        minSecondByte = 0x90;  // Overlong encoding.
+      } else if (byte == 0xF4) {
+        maxSecondByte = 0x8F;  // Above U+10FFFF.
+      }
+    }
+
+    if (length == 0 || index + length > value.size()) {
+      throw std::runtime_error("The string \"" + std::string(value) +
+                               "\" is not valid UTF-8");
+    }
+
+    for (size_t i = 1; i < length; ++i) {
+      const auto nextByte = static_cast<unsigned char>(value[index + i]);
+      const auto min = i == 1 ? minSecondByte : 0x80;
+      const auto max = i == 1 ? maxSecondByte : 0xBF;
+      if (nextByte < min || nextByte > max) {
+        throw std::runtime_error("The string \"" + std::string(value) +
+                                 "\" is not valid UTF-8");
+      }
+    }
+
+    return length;
+  }
+
+  std::string buffer_;
+  std::vector<bool> hasElements_;
+  bool expectingValue_;
+};
+}
+
+#endif
@@ -0,0 +1,206 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_LOAD_ORDER_FORMATTER
+#define LOOT_GUI_QUERY_LOAD_ORDER_FORMATTER
+
+#include <stdexcept>
+#include <string>
+
+namespace loot {
+enum struct LoadOrderFormat {
+  // Each plugin's active load order index in decimal and hexadecimal,
+  // followed by its name. This is the format used for support requests.
+  table,
+  // Each plugin's name.
+  names,
+  // Each plugin's name, prefixed by an asterisk if it is active.
+  pluginsTxt,
+  // A CSV file with a header row, giving each plugin's position, active load
+  // order index in decimal and hexadecimal, and name.
+  csv,
+};
+
+inline LoadOrderFormat mapLoadOrderFormat(const std::string& format) {
+  if (format == "table") {
+    return LoadOrderFormat::table;
+  } else if (format == "names") {
+    return LoadOrderFormat::names;
+  } else if (format == "pluginsTxt") {
+    return LoadOrderFormat::pluginsTxt;
+  } else if (format == "csv") {
+    return LoadOrderFormat::csv;
+  } else {
+    throw std::runtime_error("Invalid load order format value: " + format);
+  }
+}
+
+// Writes a load order in one of the export formats. Output is written into a
+// single buffer that is sized up front, and numbers are formatted directly
+// into it instead of through a stream. Lines end in CRLF, as the output is
+// usually pasted into Windows applications.
+class LoadOrderFormatter {
+public:
+  // The name length is the total length of the names of the plugins that will
+  // be written, and is used to size the output buffer.
+  LoadOrderFormatter(LoadOrderFormat format,
+                     size_t pluginCount,
+                     size_t nameLength) :
+      format_(format),
+      position_(0),
+      activeNormalCount_(0),
+      activeLightMasterCount_(0) {
+    // Leave enough room for the longest prefix each format writes, so that
+    // the buffer is only resized if CSV names need quoting.
+    output_.reserve(nameLength + pluginCount * MAX_LINE_OVERHEAD +
+                    sizeof(CSV_HEADER));
+
+    if (format_ == LoadOrderFormat::csv) {
+      output_.append(CSV_HEADER);
+    }
+  }
+
+  void writePlugin(const std::string& name, bool isActive, bool isLightMaster) {
+    switch (format_) {
+      case LoadOrderFormat::table:
+        writeTableLine(name, isActive, isLightMaster);
+        break;
+      case LoadOrderFormat::names:
+        output_.append(name);
+        break;
+      case LoadOrderFormat::pluginsTxt:
+        if (isActive) {
+          output_.push_back('*');
+        }
+        output_.append(name);
+        break;
+      case LoadOrderFormat::csv:
+        writeCsvLine(name, isActive, isLightMaster);
+        break;
+    }
+
+    output_.append("\r\n");
+
+    ++position_;
+    if (isActive && isLightMaster) {
+      ++activeLightMasterCount_;
+    } else if (isActive) {
+      ++activeNormalCount_;
+    }
+  }
+
+  const std::string& getOutput() const { return output_; }
+
+private:
+  static constexpr size_t MAX_LINE_OVERHEAD = 32;
+  static constexpr const char CSV_HEADER[] =
+      "Position,Active Index,Hex Index,Name\r\n";
+
+  void writeTableLine(const std::string& name,
+                      bool isActive,
+                      bool isLightMaster) {
+    if (isActive && isLightMaster) {
+      output_.append("254 FE ");
+      appendNumber(activeLightMasterCount_, 16, 3, ' ');
+      output_.append(" ");
+    } else if (isActive) {
+      appendNumber(activeNormalCount_, 10, 3, ' ');
+      output_.push_back(' ');
+      appendNumber(activeNormalCount_, 16, 2, ' ');
+      output_.append("     ");
+    } else {
+      output_.append("           ");
+    }
+
+    output_.append(name);
+  }
+
+  void writeCsvLine(const std::string& name,
+                    bool isActive,
+                    bool isLightMaster) {
+    appendNumber(position_, 10, 0, ' ');
+    output_.push_back(',');
+
+    if (isActive && isLightMaster) {
+      appendNumber(activeLightMasterCount_, 10, 0, ' ');
+      output_.append(",FE ");
+      appendNumber(activeLightMasterCount_, 16, 3, '0');
+    } else if (isActive) {
+      appendNumber(activeNormalCount_, 10, 0, ' ');
+      output_.push_back(',');
+      appendNumber(activeNormalCount_, 16, 2, '0');
+    } else {
+      output_.push_back(',');
+    }
+    output_.push_back(',');
+
+    // Plugin names may contain commas, so quote them when necessary.
+    if (name.find_first_of(",\"") == std::string::npos) {
+      output_.append(name);
+      return;
+    }
+
+    output_.push_back('"');
+    for (const auto character : name) {
+      if (character == '"') {
+        output_.push_back('"');
+      }
+      output_.push_back(character);
+    }
+    output_.push_back('"');
+  }
+
+  // Append the value in the given base, padded to the given width.
+  void appendNumber(size_t value, size_t base, size_t width, char padding) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+
+    // Enough for any size_t value in base 10 or higher.
+    char digits[3 * sizeof(size_t)];
+    size_t digitCount = 0;
+    do {
+      digits[digitCount] = DIGITS[value % base];
+      ++digitCount;
+      value /= base;
+    } while (value > 0);
+
+    if (digitCount < width) {
+      output_.append(width - digitCount, padding);
+    }
+
+    while (digitCount > 0) {
+      --digitCount;
+      output_.push_back(digits[digitCount]);
+    }
+  }
+
+  const LoadOrderFormat format_;
+  std::string output_;
+  size_t position_;
+  size_t activeNormalCount_;
+  size_t activeLightMasterCount_;
+};
+}
+
+#endif
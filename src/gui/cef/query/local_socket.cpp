@@ -0,0 +1,429 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/local_socket.h"
+
+#include <cerrno>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace loot {
+namespace {
+constexpr size_t READ_BUFFER_SIZE = 4096;
+
+#ifdef _WIN32
+// How long a client waits for the server to be ready to accept another
+// connection.
+constexpr DWORD PIPE_BUSY_TIMEOUT_MILLISECONDS = 5000;
+
+std::wstring getPipePath(const std::string& endpointName) {
+  return std::filesystem::u8path("\\\\.\\pipe\\" + endpointName).wstring();
+}
+
+HANDLE createPipeInstance(const std::string& endpointName, bool isFirst) {
+  DWORD openMode = PIPE_ACCESS_DUPLEX;
+  if (isFirst) {
+    openMode |= FILE_FLAG_FIRST_PIPE_INSTANCE;
+  }
+
+  HANDLE pipe = CreateNamedPipe(
+      getPipePath(endpointName).c_str(),
+      openMode,
+      PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT |
+          PIPE_REJECT_REMOTE_CLIENTS,
+      PIPE_UNLIMITED_INSTANCES,
+      READ_BUFFER_SIZE,
+      READ_BUFFER_SIZE,
+      0,
+      NULL);
+  if (pipe == INVALID_HANDLE_VALUE) {
+    throw std::system_error(GetLastError(),
+                            std::system_category(),
+                            "Failed to create the pipe \"" + endpointName +
+                                "\"");
+  }
+
+  return pipe;
+}
+#else
+sockaddr_un getSocketAddress(const std::string& endpointName) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+
+  // The path must fit with its null terminator.
+  if (endpointName.empty() || endpointName.size() >= sizeof(address.sun_path)) {
+    throw std::system_error(ENAMETOOLONG,
+                            std::generic_category(),
+                            "Invalid socket path \"" + endpointName + "\"");
+  }
+  endpointName.copy(address.sun_path, endpointName.size());
+
+  return address;
+}
+
+int createSocket(const std::string& endpointName) {
+  int socketFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socketFd == -1) {
+    throw std::system_error(errno,
+                            std::generic_category(),
+                            "Failed to create a socket for \"" + endpointName +
+                                "\"");
+  }
+
+  return socketFd;
+}
+
+// Returns errno if the connection fails.
+int connectSocket(int socketFd, const sockaddr_un& address) {
+  int result = 0;
+  do {
+    result = connect(socketFd,
+                     reinterpret_cast<const sockaddr*>(&address),
+                     sizeof(address));
+  } while (result == -1 && errno == EINTR);
+
+  return result == 0 ? 0 : errno;
+}
+#endif
+}
+
+void MessageBuffer::Append(const char* data, size_t size) {
+  // Drop the messages that have already been read before growing the
+  // buffer.
+  if (start_ > 0) {
+    buffer_.erase(0, start_);
+    start_ = 0;
+  }
+
+  buffer_.append(data, size);
+}
+
+std::optional<std::string> MessageBuffer::Next() {
+  const auto end = buffer_.find('\n', start_);
+  if (end == std::string::npos) {
+    return std::nullopt;
+  }
+
+  auto message = buffer_.substr(start_, end - start_);
+  start_ = end + 1;
+
+  return message;
+}
+
+LocalConnection::LocalConnection(NativeHandle handle, bool isServerEnd) :
+    handle_(handle),
+    isServerEnd_(isServerEnd) {}
+
+#ifdef _WIN32
+LocalConnection::LocalConnection(const std::string& endpointName) :
+    handle_(INVALID_HANDLE_VALUE),
+    isServerEnd_(false) {
+  const auto path = getPipePath(endpointName);
+  while (true) {
+    handle_ = CreateFile(path.c_str(),
+                         GENERIC_READ | GENERIC_WRITE,
+                         0,
+                         NULL,
+                         OPEN_EXISTING,
+                         0,
+                         NULL);
+    if (handle_ != INVALID_HANDLE_VALUE) {
+      return;
+    }
+
+    // All the pipe's instances are busy if the server is handling another
+    // connection, so wait for one to be free.
+    auto error = GetLastError();
+    if (error != ERROR_PIPE_BUSY ||
+        !WaitNamedPipe(path.c_str(), PIPE_BUSY_TIMEOUT_MILLISECONDS)) {
+      throw std::system_error(error,
+                              std::system_category(),
+                              "Failed to connect to the pipe \"" +
+                                  endpointName + "\"");
+    }
+  }
+}
+
+LocalConnection::~LocalConnection() {
+  if (isServerEnd_) {
+    // Wait for the client to read everything that was written, as
+    // disconnecting discards any unread data.
+    FlushFileBuffers(handle_);
+    DisconnectNamedPipe(handle_);
+  }
+  CloseHandle(handle_);
+}
+
+std::optional<std::string> LocalConnection::ReadMessage() {
+  char data[READ_BUFFER_SIZE];
+  while (true) {
+    auto message = buffer_.Next();
+    if (message.has_value()) {
+      return message;
+    }
+
+    DWORD bytesRead = 0;
+    if (!ReadFile(handle_, data, READ_BUFFER_SIZE, &bytesRead, NULL)) {
+      // The read is aborted if the connection is shut down while waiting.
+      auto error = GetLastError();
+      if (error == ERROR_BROKEN_PIPE || error == ERROR_PIPE_NOT_CONNECTED ||
+          error == ERROR_OPERATION_ABORTED) {
+        return std::nullopt;
+      }
+      throw std::system_error(
+          error, std::system_category(), "Failed to read from a pipe");
+    }
+
+    buffer_.Append(data, bytesRead);
+  }
+}
+
+void LocalConnection::WriteMessage(const std::string& message) {
+  const auto line = message + '\n';
+  size_t offset = 0;
+  while (offset < line.size()) {
+    DWORD bytesWritten = 0;
+    if (!WriteFile(handle_,
+                   line.data() + offset,
+                   static_cast<DWORD>(line.size() - offset),
+                   &bytesWritten,
+                   NULL)) {
+      throw std::system_error(
+          GetLastError(), std::system_category(), "Failed to write to a pipe");
+    }
+    offset += bytesWritten;
+  }
+}
+
+void LocalConnection::Shutdown() {
+  // Cancel any read or write that another thread is waiting on. Disconnecting
+  // the server end also makes reads that start later fail.
+  CancelIoEx(handle_, NULL);
+  if (isServerEnd_) {
+    DisconnectNamedPipe(handle_);
+  }
+}
+
+LocalListener::LocalListener(const std::string& endpointName) :
+    endpointName_(endpointName),
+    handle_(createPipeInstance(endpointName, true)) {}
+
+LocalListener::~LocalListener() {
+  if (handle_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(handle_);
+  }
+}
+
+std::unique_ptr<LocalConnection> LocalListener::Accept() {
+  // Each connection gets its own instance of the pipe.
+  if (handle_ == INVALID_HANDLE_VALUE) {
+    handle_ = createPipeInstance(endpointName_, false);
+  }
+
+  if (!ConnectNamedPipe(handle_, NULL)) {
+    // The client may have connected between the instance being created and
+    // ConnectNamedPipe() being called.
+    auto error = GetLastError();
+    if (error != ERROR_PIPE_CONNECTED) {
+      CloseHandle(handle_);
+      handle_ = INVALID_HANDLE_VALUE;
+      throw std::system_error(error,
+                              std::system_category(),
+                              "Failed to accept a connection to the pipe \"" +
+                                  endpointName_ + "\"");
+    }
+  }
+
+  std::unique_ptr<LocalConnection> connection(
+      new LocalConnection(handle_, true));
+  handle_ = INVALID_HANDLE_VALUE;
+
+  return connection;
+}
+#else
+LocalConnection::LocalConnection(const std::string& endpointName) :
+    handle_(-1),
+    isServerEnd_(false) {
+  const auto address = getSocketAddress(endpointName);
+  handle_ = createSocket(endpointName);
+  auto error = connectSocket(handle_, address);
+  if (error != 0) {
+    close(handle_);
+    throw std::system_error(error,
+                            std::generic_category(),
+                            "Failed to connect to the socket \"" +
+                                endpointName + "\"");
+  }
+}
+
+LocalConnection::~LocalConnection() { close(handle_); }
+
+std::optional<std::string> LocalConnection::ReadMessage() {
+  char data[READ_BUFFER_SIZE];
+  while (true) {
+    auto message = buffer_.Next();
+    if (message.has_value()) {
+      return message;
+    }
+
+    auto bytesRead = recv(handle_, data, READ_BUFFER_SIZE, 0);
+    if (bytesRead == 0) {
+      return std::nullopt;
+    }
+    if (bytesRead == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == ECONNRESET) {
+        return std::nullopt;
+      }
+      throw std::system_error(
+          errno, std::generic_category(), "Failed to read from a socket");
+    }
+
+    buffer_.Append(data, static_cast<size_t>(bytesRead));
+  }
+}
+
+void LocalConnection::WriteMessage(const std::string& message) {
+  const auto line = message + '\n';
+  size_t offset = 0;
+  while (offset < line.size()) {
+    // Don't raise SIGPIPE if the other end has closed the connection.
+    auto bytesWritten =
+        send(handle_, line.data() + offset, line.size() - offset, MSG_NOSIGNAL);
+    if (bytesWritten == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(
+          errno, std::generic_category(), "Failed to write to a socket");
+    }
+    offset += static_cast<size_t>(bytesWritten);
+  }
+}
+
+void LocalConnection::Shutdown() {
+  // This wakes a thread waiting in recv(), unlike closing the socket.
+  shutdown(handle_, SHUT_RDWR);
+}
+
+LocalListener::LocalListener(const std::string& endpointName) :
+    endpointName_(endpointName),
+    handle_(-1) {
+  const auto address = getSocketAddress(endpointName);
+
+  // A socket file is left behind if its server exits without removing it,
+  // so replace a socket that nothing is listening on. Anything else at the
+  // path isn't LOOT's to remove.
+  struct stat fileStatus;
+  if (lstat(endpointName.c_str(), &fileStatus) == 0) {
+    if (!S_ISSOCK(fileStatus.st_mode)) {
+      throw std::system_error(EEXIST,
+                              std::generic_category(),
+                              "\"" + endpointName + "\" is not a socket");
+    }
+
+    auto probe = createSocket(endpointName);
+    auto error = connectSocket(probe, address);
+    close(probe);
+    if (error == 0) {
+      throw std::system_error(EADDRINUSE,
+                              std::generic_category(),
+                              "The socket \"" + endpointName +
+                                  "\" is already in use");
+    }
+    unlink(endpointName.c_str());
+  }
+
+  handle_ = createSocket(endpointName);
+
+  // Create the socket file with only owner permissions, so that other users
+  // can't connect before its permissions could be changed.
+  const auto previousMask = umask(S_IRWXG | S_IRWXO);
+  const auto bindResult = bind(
+      handle_, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  const auto bindError = errno;
+  umask(previousMask);
+  if (bindResult != 0) {
+    close(handle_);
+    throw std::system_error(bindError,
+                            std::generic_category(),
+                            "Failed to bind the socket \"" + endpointName +
+                                "\"");
+  }
+
+  if (listen(handle_, SOMAXCONN) != 0) {
+    auto error = errno;
+    close(handle_);
+    unlink(endpointName.c_str());
+    throw std::system_error(error,
+                            std::generic_category(),
+                            "Failed to listen on the socket \"" +
+                                endpointName + "\"");
+  }
+}
+
+LocalListener::~LocalListener() {
+  close(handle_);
+  unlink(endpointName_.c_str());
+}
+
+std::unique_ptr<LocalConnection> LocalListener::Accept() {
+  int connectionFd = -1;
+  do {
+    connectionFd = accept4(handle_, nullptr, nullptr, SOCK_CLOEXEC);
+  } while (connectionFd == -1 && errno == EINTR);
+
+  if (connectionFd == -1) {
+    throw std::system_error(errno,
+                            std::generic_category(),
+                            "Failed to accept a connection to the socket \"" +
+                                endpointName_ + "\"");
+  }
+
+  return std::unique_ptr<LocalConnection>(
+      new LocalConnection(connectionFd, true));
+}
+#endif
+}
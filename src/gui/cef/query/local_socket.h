@@ -0,0 +1,116 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_LOCAL_SOCKET
+#define LOOT_GUI_QUERY_LOCAL_SOCKET
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace loot {
+// Splits a stream of bytes into newline-terminated messages.
+class MessageBuffer {
+public:
+  void Append(const char* data, size_t size);
+
+  // Get the next complete message without its newline, or nullopt if the
+  // next message hasn't been completely received.
+  std::optional<std::string> Next();
+
+private:
+  std::string buffer_;
+  size_t start_ = 0;
+};
+
+// One end of a connection to a named pipe on Windows or a Unix domain socket
+// on other platforms. Messages are sent as lines of text, so they must not
+// contain newlines.
+class LocalConnection {
+public:
+  // Connect to the endpoint with the given name. On Windows, the name is the
+  // name of a pipe in \\.\pipe\, and on other platforms it's the path of a
+  // socket file. Throws a std::system_error if nothing is listening on the
+  // endpoint.
+  explicit LocalConnection(const std::string& endpointName);
+  ~LocalConnection();
+
+  LocalConnection(const LocalConnection&) = delete;
+  LocalConnection& operator=(const LocalConnection&) = delete;
+
+  // Wait for the next message. Returns nullopt if the other end closes the
+  // connection first. Throws a std::system_error if reading fails.
+  std::optional<std::string> ReadMessage();
+
+  // Send the message followed by a newline. Throws a std::system_error if
+  // writing fails.
+  void WriteMessage(const std::string& message);
+
+  // Close the connection while it may be in use by another thread, so that a
+  // ReadMessage() call that is waiting returns nullopt, as do later calls.
+  // Later writes throw.
+  void Shutdown();
+
+private:
+#ifdef _WIN32
+  typedef void* NativeHandle;
+#else
+  typedef int NativeHandle;
+#endif
+
+  friend class LocalListener;
+
+  LocalConnection(NativeHandle handle, bool isServerEnd);
+
+  NativeHandle handle_;
+  bool isServerEnd_;
+  MessageBuffer buffer_;
+};
+
+// Listens for connections to a named pipe on Windows or a Unix domain socket
+// on other platforms. Only processes running on the same machine can connect.
+class LocalListener {
+public:
+  // Start listening on the endpoint with the given name, which is
+  // interpreted as for LocalConnection. Throws a std::system_error if the
+  // endpoint is already being listened on or can't be created.
+  explicit LocalListener(const std::string& endpointName);
+  ~LocalListener();
+
+  LocalListener(const LocalListener&) = delete;
+  LocalListener& operator=(const LocalListener&) = delete;
+
+  // Wait for the next connection. Throws a std::system_error if accepting a
+  // connection fails.
+  std::unique_ptr<LocalConnection> Accept();
+
+private:
+  const std::string endpointName_;
+  LocalConnection::NativeHandle handle_;
+};
+}
+
+#endif
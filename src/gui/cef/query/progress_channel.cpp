@@ -0,0 +1,142 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/progress_channel.h"
+
+#include <algorithm>
+
+#include <json.hpp>
+
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace loot {
+ProgressUpdate::ProgressUpdate(const std::string& text) : text(text) {}
+
+ProgressUpdate::ProgressUpdate(const std::string& text,
+                               size_t done,
+                               size_t total) :
+    text(text), done(done), total(total) {}
+
+ProgressChannel::ProgressChannel(size_t maxUpdatesPerSecond,
+                                 Scheduler scheduler,
+                                 Sink sink,
+                                 Clock clock) :
+    interval_(1000 / std::max<size_t>(maxUpdatesPerSecond, 1)),
+    scheduler_(scheduler),
+    sink_(sink),
+    clock_(clock),
+    isFlushScheduled_(false),
+    isClosed_(false),
+    countedStartDone_(0) {}
+
+void ProgressChannel::Report(const ProgressUpdate& update) {
+  const auto now = clock_();
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (isClosed_) {
+    return;
+  }
+
+  pending_ = PendingUpdate{update, estimateSecondsRemaining(update, now)};
+
+  if (isFlushScheduled_) {
+    return;
+  }
+  isFlushScheduled_ = true;
+
+  milliseconds delay(0);
+  if (lastFlush_.has_value()) {
+    delay = std::max(
+        milliseconds(0),
+        duration_cast<milliseconds>(lastFlush_.value() + interval_ - now));
+  }
+
+  auto self = shared_from_this();
+  scheduler_([self]() { self->flush(); }, delay);
+}
+
+void ProgressChannel::Close() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  isClosed_ = true;
+  pending_.reset();
+}
+
+void ProgressChannel::flush() {
+  // The lock is held while the update is delivered so that Close() can't
+  // return until it has been.
+  std::lock_guard<std::mutex> guard(mutex_);
+  isFlushScheduled_ = false;
+  lastFlush_ = clock_();
+  if (isClosed_ || !pending_.has_value()) {
+    return;
+  }
+  const auto pending = std::move(pending_.value());
+  pending_.reset();
+
+  nlohmann::json json = {{"text", pending.update.text}};
+  if (pending.update.done.has_value() && pending.update.total.has_value()) {
+    json["done"] = pending.update.done.value();
+    json["total"] = pending.update.total.value();
+  }
+  if (pending.etaSeconds.has_value()) {
+    json["etaSeconds"] = pending.etaSeconds.value();
+  }
+
+  sink_(json.dump());
+}
+
+std::optional<double> ProgressChannel::estimateSecondsRemaining(
+    const ProgressUpdate& update,
+    steady_clock::time_point now) {
+  if (!update.done.has_value() || !update.total.has_value()) {
+    countedTotal_.reset();
+    lastDone_.reset();
+    return std::nullopt;
+  }
+
+  const auto done = update.done.value();
+  const auto total = update.total.value();
+
+  // A new total or a count that has gone backwards is a new stage of work.
+  if (countedTotal_ != total || !lastDone_.has_value() ||
+      done < lastDone_.value()) {
+    countedTotal_ = total;
+    countedStartDone_ = done;
+    countedStart_ = now;
+  }
+  lastDone_ = done;
+
+  if (done <= countedStartDone_ || done >= total) {
+    return std::nullopt;
+  }
+
+  const duration<double> elapsed = now - countedStart_;
+  const auto rate = (done - countedStartDone_) / elapsed.count();
+  return (total - done) / rate;
+}
+}
@@ -0,0 +1,115 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_PROGRESS_CHANNEL
+#define LOOT_GUI_QUERY_PROGRESS_CHANNEL
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace loot {
+struct ProgressUpdate {
+  ProgressUpdate() = default;
+  explicit ProgressUpdate(const std::string& text);
+  ProgressUpdate(const std::string& text, size_t done, size_t total);
+
+  std::string text;
+  // Both are set for stages that have a known amount of work.
+  std::optional<size_t> done;
+  std::optional<size_t> total;
+};
+
+typedef std::function<void(const ProgressUpdate&)> ProgressCallback;
+
+/**
+ * @brief Coalesces progress updates so that at most a fixed number are
+ *        delivered per second.
+ * @details Updates can be reported from any thread. Only the latest update is
+ *          kept while waiting for the next tick, and it's delivered by a task
+ *          that the scheduler runs, e.g. on the UI thread, as JSON holding
+ *          the update's text, its done and total counts, and the estimated
+ *          number of seconds remaining if the counts have been advancing.
+ *          Scheduled tasks keep the channel alive, so it must be created
+ *          using std::make_shared. Once the channel is closed, it delivers
+ *          no more updates, including any that were already scheduled.
+ */
+class ProgressChannel : public std::enable_shared_from_this<ProgressChannel> {
+public:
+  typedef std::function<void(std::function<void()> task,
+                             std::chrono::milliseconds delay)>
+      Scheduler;
+  typedef std::function<void(const std::string& json)> Sink;
+  typedef std::function<std::chrono::steady_clock::time_point()> Clock;
+
+  ProgressChannel(size_t maxUpdatesPerSecond,
+                  Scheduler scheduler,
+                  Sink sink,
+                  Clock clock = std::chrono::steady_clock::now);
+
+  void Report(const ProgressUpdate& update);
+
+  // Drop any pending update and ignore later ones. Updates are delivered
+  // while holding the channel's lock, so once this returns the sink won't be
+  // called again, and a query can close its channel before responding to
+  // stop its progress being shown after the response.
+  void Close();
+
+private:
+  struct PendingUpdate {
+    ProgressUpdate update;
+    std::optional<double> etaSeconds;
+  };
+
+  void flush();
+
+  // Estimate the time remaining from the rate at which the done count has
+  // advanced since the total last changed.
+  std::optional<double> estimateSecondsRemaining(
+      const ProgressUpdate& update,
+      std::chrono::steady_clock::time_point now);
+
+  const std::chrono::milliseconds interval_;
+  const Scheduler scheduler_;
+  const Sink sink_;
+  const Clock clock_;
+
+  std::mutex mutex_;
+  std::optional<PendingUpdate> pending_;
+  bool isFlushScheduled_;
+  bool isClosed_;
+  std::optional<std::chrono::steady_clock::time_point> lastFlush_;
+
+  std::optional<size_t> countedTotal_;
+  size_t countedStartDone_;
+  std::optional<size_t> lastDone_;
+  std::chrono::steady_clock::time_point countedStart_;
+};
+}
+
+#endif
@@ -26,12 +26,16 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_QUERY
 #define LOOT_GUI_QUERY_QUERY
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
+#include "gui/cef/query/cancellation_token.h"
+#include "gui/cef/query/progress_channel.h"
 #include "gui/state/logging.h"
 #include "gui/state/loot_paths.h"
 #include "gui/state/loot_state.h"
@@ -39,8 +43,55 @@ along with LOOT.  If not, see
 namespace loot {
 class Query {
 public:
+  typedef std::function<void(const std::string&)> ChunkCallback;
+
+  // Sent as the last message of a chunked response.
+  static constexpr const char* CHUNKED_RESPONSE_COMPLETE =
+      "{\"complete\":true}";
+
+  virtual ~Query() = default;
+
   virtual std::string executeLogic() = 0;
   virtual std::optional<std::string> getErrorMessage() { return std::nullopt; };
+
+  // Execute the query, sending its response as a series of messages. Queries
+  // that return lists of plugins can override this to split the list between
+  // messages of up to pluginsPerChunk plugins each, with the first message
+  // also holding all the response's other data. Other queries send their
+  // whole response as one message. A CHUNKED_RESPONSE_COMPLETE message is
+  // always sent last.
+  virtual void executeChunkedLogic(size_t pluginsPerChunk,
+                                   const ChunkCallback& sendChunk) {
+    sendChunk(executeLogic());
+    sendChunk(CHUNKED_RESPONSE_COMPLETE);
+  }
+
+  std::shared_ptr<CancellationToken> getCancellationToken() const {
+    return cancellationToken_;
+  }
+
+  // Queries that send progress updates through a channel are given it so
+  // that it can be closed before their response is sent, as otherwise a
+  // delayed update could arrive after the response.
+  void setProgressChannel(std::shared_ptr<ProgressChannel> channel) {
+    progressChannel_ = channel;
+  }
+
+  void closeProgressChannel() {
+    if (progressChannel_) {
+      progressChannel_->Close();
+    }
+  }
+
+protected:
+  // Long-running queries should call this periodically so that they stop
+  // soon after being cancelled.
+  void throwIfCancelled() const { cancellationToken_->throwIfCancelled(); }
+
+private:
+  const std::shared_ptr<CancellationToken> cancellationToken_ =
+      std::make_shared<CancellationToken>();
+  std::shared_ptr<ProgressChannel> progressChannel_;
 };
 
 template<typename G>
@@ -33,12 +33,16 @@ along with LOOT.  If not, see
 
 #include "gui/cef/query/query.h"
 #include "gui/state/logging.h"
+#include "gui/state/timing.h"
 
 namespace loot {
 class QueryExecutor : public CefBaseRefCounted {
 public:
-  QueryExecutor(std::unique_ptr<Query> query) :
+  // The name is used to record how long the query takes to execute, and so
+  // must outlive the executor.
+  QueryExecutor(std::unique_ptr<Query> query, const char* name) :
       query_(std::move(query)),
+      name_(name),
       genericErrorMessage_(
           boost::locale::translate(
               "Oh no, something went wrong! You can check your "
@@ -46,22 +50,84 @@ public:
               "main menu) for more information.")
               .str()) {}
 
+  // The error code that is passed to the callback's Failure() if the query is
+  // cancelled before it completes.
+  static constexpr int QUERY_CANCELLED_ERROR_CODE = -2;
+
   void execute(CefRefPtr<CefMessageRouterBrowserSide::Callback> callback) {
+    ScopedTimer timer(name_);
+    auto cancellationToken = query_->getCancellationToken();
     try {
-      callback->Success(query_->executeLogic());
+      cancellationToken->throwIfCancelled();
+
+      auto response = query_->executeLogic();
+
+      // Don't send a response that is no longer wanted.
+      cancellationToken->throwIfCancelled();
+
+      sendSuccess(callback, response);
+    } catch (QueryCancelledError& e) {
+      handleCancellation(callback, e);
     } catch (std::exception& e) {
-      auto logger = getLogger();
-      if (logger) {
-        logger->error("Exception while executing query: {}", e.what());
-      }
+      handleException(callback, e);
+    }
+  }
 
-      callback->Failure(
-          -1, query_->getErrorMessage().value_or(genericErrorMessage_));
+  // Used for persistent queries, which can receive more than one response.
+  void executeChunked(CefRefPtr<CefMessageRouterBrowserSide::Callback> callback,
+                      size_t pluginsPerChunk) {
+    ScopedTimer timer(name_);
+    auto cancellationToken = query_->getCancellationToken();
+    try {
+      cancellationToken->throwIfCancelled();
+
+      query_->executeChunkedLogic(
+          pluginsPerChunk,
+          [this, callback, cancellationToken](const std::string& chunk) {
+            cancellationToken->throwIfCancelled();
+            sendSuccess(callback, chunk);
+          });
+    } catch (QueryCancelledError& e) {
+      handleCancellation(callback, e);
+    } catch (std::exception& e) {
+      handleException(callback, e);
     }
   }
 
 private:
+  void sendSuccess(CefRefPtr<CefMessageRouterBrowserSide::Callback> callback,
+                   const std::string& response) {
+    query_->closeProgressChannel();
+    callback->Success(response);
+  }
+
+  void handleCancellation(
+      CefRefPtr<CefMessageRouterBrowserSide::Callback> callback,
+      const QueryCancelledError& e) {
+    query_->closeProgressChannel();
+    auto logger = getLogger();
+    if (logger) {
+      logger->info("Query cancelled before it completed.");
+    }
+
+    callback->Failure(QUERY_CANCELLED_ERROR_CODE, e.what());
+  }
+
+  void handleException(
+      CefRefPtr<CefMessageRouterBrowserSide::Callback> callback,
+      const std::exception& e) {
+    query_->closeProgressChannel();
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Exception while executing query: {}", e.what());
+    }
+
+    callback->Failure(
+        -1, query_->getErrorMessage().value_or(genericErrorMessage_));
+  }
+
   const std::unique_ptr<Query> query_;
+  const char* const name_;
   const std::string genericErrorMessage_;
 
   IMPLEMENT_REFCOUNTING(QueryExecutor);
@@ -26,19 +26,29 @@
 #include "gui/cef/query/query_handler.h"
 
 #include <filesystem>
+#include <future>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <include/base/cef_bind.h>
 #include <include/cef_app.h>
 #include <include/cef_task.h>
 #include <include/wrapper/cef_closure_task.h>
 
+#include "gui/batch_sort.h"
+#include "gui/cef/function_task.h"
 #include "gui/cef/loot_app.h"
 #include "gui/cef/loot_handler.h"
+#include "gui/cef/query/progress_channel.h"
 #include "gui/cef/query/query_executor.h"
+#include "gui/cef/query/query_recording.h"
 #include "gui/cef/query/types/apply_sort_query.h"
+#include "gui/cef/query/types/cancel_query_query.h"
 #include "gui/cef/query/types/cancel_sort_query.h"
 #include "gui/cef/query/types/change_game_query.h"
 #include "gui/cef/query/types/clear_all_metadata_query.h"
@@ -50,12 +60,13 @@
 #include "gui/cef/query/types/discard_unapplied_changes_query.h"
 #include "gui/cef/query/types/editor_closed_query.h"
 #include "gui/cef/query/types/editor_opened_query.h"
-#include "gui/cef/query/types/get_auto_sort_query.h"
+#include "gui/cef/query/types/get_conflict_matrix_query.h"
 #include "gui/cef/query/types/get_conflicting_plugins_query.h"
 #include "gui/cef/query/types/get_game_data_query.h"
 #include "gui/cef/query/types/get_game_types_query.h"
 #include "gui/cef/query/types/get_init_errors_query.h"
 #include "gui/cef/query/types/get_installed_games_query.h"
+#include "gui/cef/query/types/get_performance_stats_query.h"
 #include "gui/cef/query/types/get_settings_query.h"
 #include "gui/cef/query/types/get_themes_query.h"
 #include "gui/cef/query/types/get_version_query.h"
@@ -66,21 +77,119 @@
 #include "gui/cef/query/types/save_user_groups_query.h"
 #include "gui/cef/query/types/sort_plugins_query.h"
 #include "gui/cef/query/types/update_masterlist_query.h"
+#include "gui/state/cache_registry.h"
+#include "gui/state/startup_report.h"
 
 #undef min
 #include <json.hpp>
 
 namespace loot {
-void sendProgressUpdate(CefRefPtr<CefFrame> frame, const std::string& message) {
+// Move the strings out of the given JSON array instead of copying them, as
+// the array may hold every installed plugin's name.
+static std::vector<std::string> takeStrings(nlohmann::json& json) {
+  auto& array = json.get_ref<nlohmann::json::array_t&>();
+
+  std::vector<std::string> strings;
+  strings.reserve(array.size());
+  for (auto& element : array) {
+    strings.push_back(std::move(element.get_ref<std::string&>()));
+  }
+
+  return strings;
+}
+
+// Progress can change with every plugin read, so limit how often the UI is
+// updated.
+static constexpr size_t MAX_PROGRESS_UPDATES_PER_SECOND = 10;
+
+// Get a channel that sends a query's progress updates to the UI, delivering
+// them on the UI thread at most MAX_PROGRESS_UPDATES_PER_SECOND times a
+// second. Returns null if there's no frame to update.
+static std::shared_ptr<ProgressChannel> makeProgressChannel(
+    CefRefPtr<CefFrame> frame) {
+  // Replayed queries have no frame to update.
+  if (!frame) {
+    return nullptr;
+  }
+
+  return std::make_shared<ProgressChannel>(
+      MAX_PROGRESS_UPDATES_PER_SECOND,
+      [](std::function<void()> task, std::chrono::milliseconds delay) {
+        CefPostDelayedTask(TID_UI, new FunctionTask(task), delay.count());
+      },
+      [frame](const std::string& json) {
+        auto logger = getLogger();
+        if (logger) {
+          logger->trace("Sending progress update: {}", json);
+        }
+        RecordStartupMilestone("First progress update");
+        frame->ExecuteJavaScript(
+            "loot.onProgress(" + json + ");", frame->GetURL(), 0);
+      });
+}
+
+static ProgressCallback getProgressCallback(
+    std::shared_ptr<ProgressChannel> channel) {
+  if (!channel) {
+    return [](const ProgressUpdate& update) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->trace("Progress update: {}", update.text);
+      }
+    };
+  }
+
+  return [channel](const ProgressUpdate& update) { channel->Report(update); };
+}
+
+void sendExternalChanges(CefRefPtr<CefFrame> frame,
+                         const gui::Game::ExternalChanges& changes) {
+  nlohmann::json json = {
+      {"plugins", changes.plugins},
+      {"dataDirectory", changes.dataDirectory},
+      {"loadOrder", changes.loadOrder},
+      {"metadataLists", changes.metadataLists},
+  };
+
+  // The frame's browser may have been closed since it was last used.
+  if (!frame->IsValid()) {
+    return;
+  }
+
   auto logger = getLogger();
   if (logger) {
-    logger->trace("Sending progress update: {}", message);
+    logger->debug("Sending external changes: {}", json.dump());
   }
   frame->ExecuteJavaScript(
-      "loot.showProgress('" + message + "');", frame->GetURL(), 0);
+      "loot.onExternalChanges(" + json.dump() + ");", frame->GetURL(), 0);
+}
+
+static void writeStartupReport(const std::filesystem::path& historyPath) {
+  auto& report = GetStartupReport();
+  report.RecordMilestone("getGameData completion");
+  report.Write(historyPath);
 }
 
-QueryHandler::QueryHandler(LootState& lootState) : lootState_(lootState) {}
+QueryHandler::QueryHandler(LootState& lootState) :
+    lootState_(lootState),
+    isWatcherFramed_(false),
+    isFileWatchingStopped_(false),
+    workerPool_(QUERY_THREAD_COUNT) {
+  // Games may be unloaded while queries for them are still running, so do it
+  // on the worker pool.
+  lootState_.SetGameTaskRunner(
+      [this](const std::string& gameFolder, std::function<void()> task) {
+        workerPool_.post(QueryPriority::exclusive, gameFolder, task);
+      });
+}
+
+QueryHandler::~QueryHandler() {
+  lootState_.SetGameTaskRunner(nullptr);
+
+  std::lock_guard<std::mutex> guard(fileWatcherMutex_);
+  isFileWatchingStopped_ = true;
+  fileWatcher_.reset();
+}
 
 // Called due to cefQuery execution in binding.html.
 bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
@@ -90,15 +199,98 @@ bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
                            bool persistent,
                            CefRefPtr<Callback> callback) {
   try {
-    auto query = createQuery(browser, frame, request.ToString());
+    nlohmann::json json = nlohmann::json::parse(request.ToString());
+    const std::string name = json.at("name");
+    GetQueryRecorder().Record(json);
+
+    if (frame) {
+      std::lock_guard<std::mutex> guard(uiFrameMutex_);
+      uiFrame_ = frame;
+    }
+
+    // The UI sends an ID of its own with queries that it may cancel, as it
+    // can't see query_id.
+    std::optional<int64_t> cancellationId;
+    if (json.contains("cancellationId")) {
+      cancellationId = json.at("cancellationId").get<int64_t>();
+    }
+
+    // Large values are moved out of the request rather than copied, so only
+    // fields that haven't been moved can be read after this.
+    auto query = createQuery(browser, frame, name, json);
 
     if (!query)
       return false;
 
-    CefRefPtr<QueryExecutor> executor = new QueryExecutor(std::move(query));
+    activeQueries_.add(query_id, cancellationId, query->getCancellationToken());
+
+    CefRefPtr<QueryExecutor> executor =
+        new QueryExecutor(std::move(query), InternOperationName(name));
+
+    // The UI is interactive once the first game's data has been loaded.
+    const bool isFirstGameData =
+        name == "getGameData" &&
+        GetStartupReport().RecordMilestone("getGameData dispatch");
+    const auto startupHistoryPath = isFirstGameData
+                                        ? lootState_.getStartupHistoryPath()
+                                        : std::filesystem::path();
+
+    auto priority = getQueryPriority(name);
+    auto gameFolder = priority == QueryPriority::interactive
+                          ? ""
+                          : getQueryGameFolder(name, json);
+
+    if (persistent) {
+      // Persistent queries can be sent multiple responses, so use them to
+      // send large responses in chunks.
+      size_t pluginsPerChunk =
+          json.value("pluginsPerChunk", DEFAULT_PLUGINS_PER_CHUNK);
+      if (pluginsPerChunk == 0) {
+        pluginsPerChunk = 1;
+      }
 
-    CefPostTask(TID_FILE,
-                base::Bind(&QueryExecutor::execute, executor, callback));
+      workerPool_.post(priority,
+                       gameFolder,
+                       [this,
+                        query_id,
+                        executor,
+                        callback,
+                        pluginsPerChunk,
+                        isFirstGameData,
+                        startupHistoryPath]() {
+                         executor->executeChunked(callback, pluginsPerChunk);
+                         activeQueries_.remove(query_id);
+                         // Queries are what fill the caches, so check that
+                         // they still fit in their budget afterwards.
+                         GetCacheRegistry().EnforceBudget();
+                         if (isFirstGameData) {
+                           writeStartupReport(startupHistoryPath);
+                         }
+                       });
+    } else {
+      workerPool_.post(priority,
+                       gameFolder,
+                       [this,
+                        query_id,
+                        executor,
+                        callback,
+                        isFirstGameData,
+                        startupHistoryPath]() {
+                         executor->execute(callback);
+                         activeQueries_.remove(query_id);
+                         GetCacheRegistry().EnforceBudget();
+                         if (isFirstGameData) {
+                           writeStartupReport(startupHistoryPath);
+                         }
+                       });
+    }
+
+    // Loading game data is usually followed by sorting, so sort in advance
+    // once the game has no other queries to run.
+    if (name == "getGameData" || name == "changeGame") {
+      postSpeculativeSort(gameFolder);
+      watchGameFiles(frame, gameFolder);
+    }
   } catch (std::exception& e) {
     auto logger = getLogger();
     if (logger) {
@@ -112,106 +304,646 @@ bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
   return true;
 }
 
+std::vector<QueryLatencies> QueryHandler::replayQueries(
+    const std::vector<RecordedQuery>& queries) {
+  // These queries change things outside of LOOT, e.g. the clipboard, or
+  // refer to other queries by ID.
+  static const std::unordered_set<std::string> SKIPPED_QUERIES({
+      "cancelQuery",
+      "copyContent",
+      "copyLoadOrder",
+      "copyMetadata",
+      "openLogLocation",
+      "openReadme",
+  });
+
+  auto logger = getLogger();
+  std::vector<QueryLatency> latencies;
+  for (const auto& recordedQuery : queries) {
+    auto json = recordedQuery.request;
+    const std::string name = json.at("name");
+    if (SKIPPED_QUERIES.count(name) != 0) {
+      continue;
+    }
+
+    QueryLatency latency;
+    latency.name = name;
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      auto query = createQuery(nullptr, nullptr, name, json);
+      if (!query) {
+        continue;
+      }
+
+      query->executeLogic();
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->error("Replayed query \"{}\" failed: {}", name, e.what());
+      }
+      latency.succeeded = false;
+    }
+    latency.durationMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    latencies.push_back(latency);
+  }
+
+  return SummariseQueryLatencies(latencies);
+}
+
+std::string QueryHandler::runQuery(nlohmann::json request) {
+  const std::string name = request.at("name");
+  auto query = createQuery(nullptr, nullptr, name, request);
+  if (!query) {
+    throw std::invalid_argument("Unknown query \"" + name + "\"");
+  }
+
+  auto priority = getQueryPriority(name);
+  auto gameFolder = priority == QueryPriority::interactive
+                        ? ""
+                        : getQueryGameFolder(name, request);
+
+  // Run the query on the worker pool so that it's ordered with respect to
+  // the tasks that the UI or file watcher have posted for the same game.
+  std::shared_ptr<Query> sharedQuery = std::move(query);
+  auto response = std::make_shared<std::promise<std::string>>();
+  auto future = response->get_future();
+  const auto operationName = InternOperationName(name);
+  workerPool_.post(
+      priority, gameFolder, [sharedQuery, response, operationName]() {
+        ScopedTimer timer(operationName);
+        try {
+          response->set_value(sharedQuery->executeLogic());
+        } catch (std::exception& e) {
+          auto logger = getLogger();
+          if (logger) {
+            logger->error("Exception while executing query: {}", e.what());
+          }
+          response->set_exception(std::make_exception_ptr(std::runtime_error(
+              sharedQuery->getErrorMessage().value_or(e.what()))));
+        }
+        GetCacheRegistry().EnforceBudget();
+      });
+
+  // Keep the game's state up to date between queries, as for the UI, which
+  // is told about external changes if there is one.
+  if (name == "getGameData" || name == "changeGame") {
+    postSpeculativeSort(gameFolder);
+    watchGameFiles(getUiFrame(), gameFolder);
+  }
+
+  return future.get();
+}
+
+nlohmann::json QueryHandler::handleForwardedCommandLine(
+    const std::string& gameFolder,
+    bool autoSort) {
+  // The whole command line is handled by one exclusive task, so the UI's
+  // queries can't change the game between checking its state and sorting it.
+  // A game change is ordered with the queries for the game being changed to,
+  // like the UI's changeGame queries.
+  const auto taskGameFolder = gameFolder.empty()
+                                  ? getQueryGameFolder("", nlohmann::json())
+                                  : gameFolder;
+
+  struct Outcome {
+    nlohmann::json result;
+    bool changedGame = false;
+    bool loadedGame = false;
+  };
+  auto promise = std::make_shared<std::promise<Outcome>>();
+  auto future = promise->get_future();
+  workerPool_.post(
+      QueryPriority::exclusive,
+      taskGameFolder,
+      [this, gameFolder, autoSort, promise]() {
+        ScopedTimer timer("QueryHandler::handleForwardedCommandLine");
+        try {
+          if (lootState_.HasUnappliedChanges()) {
+            throw std::runtime_error(
+                "LOOT has unapplied changes, apply or cancel them and try "
+                "again.");
+          }
+
+          Outcome outcome;
+          outcome.changedGame =
+              !gameFolder.empty() &&
+              gameFolder != lootState_.GetCurrentGame().FolderName();
+          outcome.loadedGame =
+              outcome.changedGame ||
+              (autoSort && !lootState_.GetCurrentGame().HasPlugins());
+          if (outcome.loadedGame) {
+            // Changing the game also loads its plugins.
+            const std::string name =
+                outcome.changedGame ? "changeGame" : "getGameData";
+            nlohmann::json request = {{"name", name}};
+            if (outcome.changedGame) {
+              request["gameFolder"] = gameFolder;
+            }
+            createQuery(nullptr, nullptr, name, request)->executeLogic();
+          }
+
+          outcome.result = {
+              {"game", lootState_.GetCurrentGame().FolderName()}};
+          if (autoSort) {
+            // An already loaded game is only sorted, not reloaded.
+            outcome.result["sorted"] = lootState_.sortCurrentGame();
+            outcome.result["messages"] = DescribeMessages(
+                lootState_.GetCurrentGame(), lootState_.getLanguage());
+          }
+
+          promise->set_value(std::move(outcome));
+        } catch (...) {
+          promise->set_exception(std::current_exception());
+        }
+        GetCacheRegistry().EnforceBudget();
+      });
+
+  const auto outcome = future.get();
+  const std::string currentGameFolder = outcome.result.at("game");
+
+  // Keep the game's state up to date between queries, as runQuery() does
+  // after loading a game.
+  if (outcome.loadedGame) {
+    postSpeculativeSort(currentGameFolder);
+    watchGameFiles(getUiFrame(), currentGameFolder);
+  }
+
+  // The UI hasn't loaded any game yet if it hasn't sent a query, and it
+  // loads the current game when it does. The UI may also have been closed
+  // since its last query.
+  auto frame = getUiFrame();
+  if (frame && frame->IsValid()) {
+    if (outcome.changedGame) {
+      frame->ExecuteJavaScript(
+          "loot.onGameChangedExternally();", frame->GetURL(), 0);
+    } else if (autoSort) {
+      gui::Game::ExternalChanges changes;
+      changes.loadOrder = true;
+      sendExternalChanges(frame, changes);
+    }
+  }
+
+  return outcome.result;
+}
+
+CefRefPtr<CefFrame> QueryHandler::getUiFrame() {
+  std::lock_guard<std::mutex> guard(uiFrameMutex_);
+  return uiFrame_;
+}
+
+void QueryHandler::postSpeculativeSort(const std::string& gameFolder) {
+  workerPool_.post(QueryPriority::idle, gameFolder, [this, gameFolder]() {
+    auto& game = lootState_.GetCurrentGame();
+    // The current game may have changed since the task was posted, and
+    // sorting a game that hasn't loaded its plugins would only fail.
+    if (game.FolderName() == gameFolder && game.HasPlugins()) {
+      game.PrecomputeSortResult();
+    }
+  });
+}
+
+void QueryHandler::watchGameFiles(CefRefPtr<CefFrame> frame,
+                                  const std::string& gameFolder) {
+  workerPool_.post(
+      QueryPriority::background, gameFolder, [this, frame, gameFolder]() {
+        auto& game = lootState_.GetCurrentGame();
+        if (game.FolderName() != gameFolder) {
+          return;
+        }
+
+        // A watcher that was created without a frame is replaced by one
+        // with a frame, so that the UI hears about changes.
+        std::lock_guard<std::mutex> guard(fileWatcherMutex_);
+        if (isFileWatchingStopped_ ||
+            (fileWatcher_ && watchedGameFolder_ == gameFolder &&
+             (isWatcherFramed_ || !frame))) {
+          return;
+        }
+
+        // Stop watching the previous game before watching this one.
+        fileWatcher_.reset();
+        fileWatcher_ = std::make_unique<FileWatcher>(
+            game.GetWatchedDirectories(),
+            FILE_CHANGES_DEBOUNCE_INTERVAL,
+            [this, frame, gameFolder](
+                const std::vector<std::filesystem::path>& paths) {
+              onGameFilesChanged(frame, gameFolder, paths);
+            });
+        watchedGameFolder_ = gameFolder;
+        isWatcherFramed_ = frame != nullptr;
+      });
+}
+
+void QueryHandler::onGameFilesChanged(
+    CefRefPtr<CefFrame> frame,
+    const std::string& gameFolder,
+    const std::vector<std::filesystem::path>& paths) {
+  workerPool_.post(
+      QueryPriority::exclusive, gameFolder, [this, frame, gameFolder, paths]() {
+        auto& game = lootState_.GetCurrentGame();
+        if (game.FolderName() != gameFolder) {
+          return;
+        }
+
+        // Queries run without a browser have no frame to update.
+        auto changes = game.RecordExternalChanges(paths);
+        if (frame && !changes.IsEmpty()) {
+          sendExternalChanges(frame, changes);
+        }
+      });
+}
+
+void QueryHandler::OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                                   CefRefPtr<CefFrame> frame,
+                                   int64 query_id) {
+  activeQueries_.cancel(query_id);
+}
+
+QueryPriority QueryHandler::getQueryPriority(const std::string& name) {
+  // These queries don't read or write any game's state.
+  static const std::unordered_set<std::string> INTERACTIVE_QUERIES({
+      "cancelQuery",
+      "copyContent",
+      "editorOpened",
+      "getGameTypes",
+      "getInitErrors",
+      "getInstalledGames",
+      "getPerformanceStats",
+      "getSettings",
+      "getThemes",
+      "getVersion",
+      "openLogLocation",
+      "openReadme",
+      "saveFilterState",
+  });
+
+  // These queries read but don't write the current game's state.
+  static const std::unordered_set<std::string> BACKGROUND_QUERIES({
+      "copyLoadOrder",
+      "copyMetadata",
+      "getConflictMatrix",
+      "getConflictingPlugins",
+  });
+
+  if (INTERACTIVE_QUERIES.count(name) != 0) {
+    return QueryPriority::interactive;
+  }
+
+  if (BACKGROUND_QUERIES.count(name) != 0) {
+    return QueryPriority::background;
+  }
+
+  // Everything else may change the game's state, including getGameData, which
+  // reloads the game's plugins, and discardUnappliedChanges, which writes the
+  // game's pending user metadata edits.
+  return QueryPriority::exclusive;
+}
+
+std::string QueryHandler::getQueryGameFolder(const std::string& name,
+                                             const nlohmann::json& json) {
+  if (name == "changeGame") {
+    return json.at("gameFolder");
+  }
+
+  try {
+    return lootState_.GetCurrentGame().FolderName();
+  } catch (std::exception&) {
+    // There is no current game, e.g. because no games were detected.
+    return "";
+  }
+}
+
 std::unique_ptr<Query> QueryHandler::createQuery(
     CefRefPtr<CefBrowser> browser,
     CefRefPtr<CefFrame> frame,
-    const std::string& requestString) {
-  nlohmann::json json = nlohmann::json::parse(requestString);
-
-  const std::string name = json.at("name");
-
-  if (name == "applySort") {
-    return std::make_unique<ApplySortQuery<>>(
-        lootState_.GetCurrentGame(), lootState_, json.at("pluginNames"));
-  } else if (name == "cancelSort") {
-    return std::make_unique<CancelSortQuery<>>(
-        lootState_.GetCurrentGame(), lootState_, lootState_.getLanguage());
-  } else if (name == "changeGame") {
-    return std::make_unique<ChangeGameQuery<>>(
-        lootState_,
-        lootState_.getLanguage(),
-        json.at("gameFolder"),
-        [frame](std::string message) { sendProgressUpdate(frame, message); });
-  } else if (name == "clearAllMetadata") {
-    return std::make_unique<ClearAllMetadataQuery<>>(lootState_.GetCurrentGame(),
-                                                   lootState_.getLanguage());
-  } else if (name == "clearPluginMetadata") {
-    return std::make_unique<ClearPluginMetadataQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_.getLanguage(),
-        json.at("pluginName"));
-  } else if (name == "closeSettings") {
-    return std::make_unique<CloseSettingsQuery>(lootState_,
-                                                json.at("settings"));
-  } else if (name == "copyContent") {
-    return std::make_unique<CopyContentQuery>(json.at("content"));
-  } else if (name == "copyLoadOrder") {
-    return std::make_unique<CopyLoadOrderQuery<>>(lootState_.GetCurrentGame(),
-                                                json.at("pluginNames"));
-  } else if (name == "copyMetadata") {
-    return std::make_unique<CopyMetadataQuery<>>(lootState_.GetCurrentGame(),
-                                               lootState_.getLanguage(),
-                                               json.at("pluginName"));
-  } else if (name == "discardUnappliedChanges") {
-    return std::make_unique<DiscardUnappliedChangesQuery>(lootState_);
-  } else if (name == "editorClosed") {
-    return std::make_unique<EditorClosedQuery<>>(lootState_.GetCurrentGame(),
-                                               lootState_,
-                                               lootState_.getLanguage(),
-                                               json.at("editorState"));
-  } else if (name == "editorOpened") {
-    return std::make_unique<EditorOpenedQuery>(lootState_);
-  } else if (name == "getConflictingPlugins") {
-    return std::make_unique<GetConflictingPluginsQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_.getLanguage(),
-        json.at("pluginName"));
-  } else if (name == "getGameTypes") {
-    return std::make_unique<GetGameTypesQuery>();
-  } else if (name == "getGameData") {
-    return std::make_unique<GetGameDataQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_.getLanguage(),
-        [frame](std::string message) { sendProgressUpdate(frame, message); });
-  } else if (name == "getInitErrors") {
-    return std::make_unique<GetInitErrorsQuery>(lootState_);
-  } else if (name == "getInstalledGames") {
-    return std::make_unique<GetInstalledGamesQuery>(lootState_);
-  } else if (name == "getSettings") {
-    return std::make_unique<GetSettingsQuery>(lootState_);
-  } else if (name == "getThemes") {
-    return std::make_unique<GetThemesQuery>(lootState_.getResourcesPath());
-  } else if (name == "getVersion") {
-    return std::make_unique<GetVersionQuery>();
-  } else if (name == "openLogLocation") {
-    return std::make_unique<OpenLogLocationQuery>(lootState_.getLogPath());
-  } else if (name == "openReadme") {
-    return std::make_unique<OpenReadmeQuery>(
-        lootState_.getReadmePath(),
-        json.at("relativeFilePath").get<std::string>());
-  } else if (name == "redatePlugins") {
-    return std::make_unique<RedatePluginsQuery<>>(lootState_.GetCurrentGame());
-  } else if (name == "saveUserGroups") {
-    return std::make_unique<SaveUserGroupsQuery<>>(lootState_.GetCurrentGame(),
-                                                 json.at("userGroups"));
-  } else if (name == "saveFilterState") {
-    return std::make_unique<SaveFilterStateQuery>(
-        lootState_,
-        json.at("filter").at("name"),
-        json.at("filter").at("state"));
-  } else if (name == "sortPlugins") {
-    return std::make_unique<SortPluginsQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_,
-        lootState_.getLanguage(),
-        [frame](std::string message) { sendProgressUpdate(frame, message); });
-  } else if (name == "updateMasterlist") {
-    return std::make_unique<UpdateMasterlistQuery<>>(lootState_.GetCurrentGame(),
-                                                   lootState_.getLanguage());
-  } else if (name == "getAutoSort") {
-    return std::make_unique<GetAutoSortQuery>(lootState_);
-  }
-
-  return nullptr;
+    const std::string& name,
+    nlohmann::json& json) {
+  // Built once, so that each request only costs one lookup instead of
+  // comparing its name against every query's name in turn.
+  static const std::unordered_map<std::string_view, QueryFactory>
+      QUERY_FACTORIES({
+          {"applySort",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<ApplySortQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 handler.lootState_,
+                 takeStrings(json.at("pluginNames")));
+           }},
+          {"cancelQuery",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<CancelQueryQuery>(
+                 [&handler](int64_t cancellationId) {
+                   return handler.activeQueries_.cancelByCancellationId(
+                       cancellationId);
+                 },
+                 json.at("cancellationId"));
+           }},
+          {"cancelSort",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<CancelSortQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 handler.lootState_,
+                 settings.language);
+           }},
+          {"changeGame",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             // The game folder is also read after the query is created, so
+             // it can't be moved out of the request.
+             auto progress = makeProgressChannel(frame);
+             auto query = std::make_unique<ChangeGameQuery<>>(
+                 handler.lootState_,
+                 settings.language,
+                 json.at("gameFolder"),
+                 getProgressCallback(progress));
+             query->setProgressChannel(progress);
+             return query;
+           }},
+          {"clearAllMetadata",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<ClearAllMetadataQuery<>>(
+                 handler.lootState_.GetCurrentGame(), settings.language);
+           }},
+          {"clearPluginMetadata",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<ClearPluginMetadataQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 settings.language,
+                 json.at("pluginName"));
+           }},
+          {"closeSettings",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<CloseSettingsQuery>(
+                 handler.lootState_, std::move(json.at("settings")));
+           }},
+          {"copyContent",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<CopyContentQuery>(
+                 std::move(json.at("content")));
+           }},
+          {"copyLoadOrder",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<CopyLoadOrderQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 takeStrings(json.at("pluginNames")),
+                 mapLoadOrderFormat(json.value("format", "table")));
+           }},
+          {"copyMetadata",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<CopyMetadataQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 settings.language,
+                 json.at("pluginName"));
+           }},
+          {"discardUnappliedChanges",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<DiscardUnappliedChangesQuery>(
+                 handler.lootState_, handler.lootState_);
+           }},
+          {"editorClosed",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<EditorClosedQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 handler.lootState_,
+                 settings.language,
+                 std::move(json.at("editorState")));
+           }},
+          {"editorOpened",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<EditorOpenedQuery>(handler.lootState_);
+           }},
+          {"getConflictMatrix",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetConflictMatrixQuery<>>(
+                 handler.lootState_.GetCurrentGame());
+           }},
+          {"getConflictingPlugins",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetConflictingPluginsQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 settings.language,
+                 json.at("pluginName"));
+           }},
+          {"getGameTypes",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetGameTypesQuery>();
+           }},
+          {"getGameData",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             auto progress = makeProgressChannel(frame);
+             auto query = std::make_unique<GetGameDataQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 settings.language,
+                 getProgressCallback(progress),
+                 json.value("incremental", false),
+                 json.value("allowProvisional", false));
+             query->setProgressChannel(progress);
+             return query;
+           }},
+          {"getInitErrors",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetInitErrorsQuery>(handler.lootState_);
+           }},
+          {"getInstalledGames",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetInstalledGamesQuery>(
+                 handler.lootState_);
+           }},
+          {"getPerformanceStats",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetPerformanceStatsQuery>(
+                 json.value("includeTraceEvents", false));
+           }},
+          {"getSettings",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetSettingsQuery>(handler.lootState_);
+           }},
+          {"getThemes",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetThemesQuery>(
+                 handler.lootState_.getResourcesPath());
+           }},
+          {"getVersion",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<GetVersionQuery>();
+           }},
+          {"openLogLocation",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<OpenLogLocationQuery>(
+                 handler.lootState_.getLogPath());
+           }},
+          {"openReadme",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<OpenReadmeQuery>(
+                 handler.lootState_.getReadmePath(),
+                 json.at("relativeFilePath").get<std::string>());
+           }},
+          {"redatePlugins",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<RedatePluginsQuery<>>(
+                 handler.lootState_.GetCurrentGame());
+           }},
+          {"saveUserGroups",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<SaveUserGroupsQuery<>>(
+                 handler.lootState_.GetCurrentGame(), json.at("userGroups"));
+           }},
+          {"saveFilterState",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<SaveFilterStateQuery>(
+                 handler.lootState_,
+                 json.at("filter").at("name"),
+                 json.at("filter").at("state"));
+           }},
+          {"sortPlugins",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             auto progress = makeProgressChannel(frame);
+             auto query = std::make_unique<SortPluginsQuery<>>(
+                 handler.lootState_.GetCurrentGame(),
+                 handler.lootState_,
+                 settings.language,
+                 getProgressCallback(progress),
+                 json.value("compact", false));
+             query->setProgressChannel(progress);
+             return query;
+           }},
+          {"updateMasterlist",
+           [](QueryHandler& handler,
+              CefRefPtr<CefFrame> frame,
+              nlohmann::json& json,
+              const LootSettings::Snapshot& settings)
+               -> std::unique_ptr<Query> {
+             return std::make_unique<UpdateMasterlistQuery<>>(
+                 handler.lootState_.GetCurrentGame(), settings.language);
+           }},
+      });
+
+  auto it = QUERY_FACTORIES.find(name);
+  if (it == QUERY_FACTORIES.end()) {
+    return nullptr;
+  }
+
+  // Read all the settings that queries need from one snapshot, without
+  // locking.
+  const auto settings = lootState_.getSnapshot();
+
+  return it->second(*this, frame, json, *settings);
 }
 }
@@ -26,15 +26,29 @@
 #ifndef LOOT_GUI_QUERY_HANDLER
 #define LOOT_GUI_QUERY_HANDLER
 
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <include/wrapper/cef_message_router.h>
+#include <json.hpp>
 
+#include "gui/cef/query/active_queries.h"
 #include "gui/cef/query/query.h"
+#include "gui/cef/query/query_recording.h"
+#include "gui/cef/query/query_worker_pool.h"
+#include "gui/state/file_watcher.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
 class QueryHandler : public CefMessageRouterBrowserSide::Handler {
 public:
   QueryHandler(LootState& lootState);
+  ~QueryHandler();
 
   // Called due to cefQuery execution in binding.html.
   virtual bool OnQuery(CefRefPtr<CefBrowser> browser,
@@ -44,12 +58,104 @@ public:
                        bool persistent,
                        CefRefPtr<Callback> callback) OVERRIDE;
 
+  // Called when a persistent query is cancelled by the renderer, or when a
+  // query is still pending when its browser or frame is closed.
+  virtual void OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                               CefRefPtr<CefFrame> frame,
+                               int64 query_id) OVERRIDE;
+
+  // Run the recorded queries one after another on the calling thread, without
+  // a browser, and get the latencies of each type of query. Queries that have
+  // effects outside of LOOT are skipped. Queries that fail are logged and
+  // counted, and replaying continues.
+  std::vector<QueryLatencies> replayQueries(
+      const std::vector<RecordedQuery>& queries);
+
+  // Run the request's query without a browser, like a request from the UI,
+  // and wait for its response. Throws if the query is unknown or fails, with
+  // the query's own error message if it has one.
+  std::string runQuery(nlohmann::json request);
+
+  // Handle a command line forwarded from another instance of LOOT: change to
+  // the given game unless it's empty, then sort it and apply the sorted load
+  // order if asked to, unless it has error messages. Unlike --auto-sort, an
+  // already loaded game isn't reloaded. The UI is then told to show the
+  // game's new state. Returns the game's folder and, if it was
+  // auto-sorted, whether sorting succeeded and the game's messages. Throws if
+  // the UI has unapplied changes, as they'd be lost. Everything that reads or
+  // changes LOOT's state runs as one exclusive task on the worker pool, which
+  // this waits for.
+  nlohmann::json handleForwardedCommandLine(const std::string& gameFolder,
+                                            bool autoSort);
+
 private:
+  static constexpr size_t DEFAULT_PLUGINS_PER_CHUNK = 100;
+
+  // One thread is reserved for interactive queries, the rest can run any
+  // query.
+  static constexpr size_t QUERY_THREAD_COUNT = 4;
+
+  // Files are often changed in bursts, e.g. by mod managers installing a mod,
+  // so wait for them to settle before handling the changes.
+  static constexpr std::chrono::milliseconds FILE_CHANGES_DEBOUNCE_INTERVAL{
+      500};
+
+  static QueryPriority getQueryPriority(const std::string& name);
+
+  // Get the folder of the game that the named query will act on.
+  std::string getQueryGameFolder(const std::string& name,
+                                 const nlohmann::json& json);
+
+  CefRefPtr<CefFrame> getUiFrame();
+
+  // Sort the given game's plugins once it has no queries left to run, so that
+  // a later sort can reuse the result.
+  void postSpeculativeSort(const std::string& gameFolder);
+
+  // Watch the given game's files for changes made outside of LOOT, replacing
+  // any existing watcher for another game, or for the same game without a
+  // frame if one is given.
+  void watchGameFiles(CefRefPtr<CefFrame> frame, const std::string& gameFolder);
+
+  // Update the game's state to reflect the changed files and tell the UI what
+  // changed, so that it can refresh.
+  void onGameFilesChanged(CefRefPtr<CefFrame> frame,
+                          const std::string& gameFolder,
+                          const std::vector<std::filesystem::path>& paths);
+
+  // Query factories may move values out of the request's JSON instead of
+  // copying them.
+  typedef std::unique_ptr<Query> (*QueryFactory)(
+      QueryHandler& handler,
+      CefRefPtr<CefFrame> frame,
+      nlohmann::json& json,
+      const LootSettings::Snapshot& settings);
+
   std::unique_ptr<Query> createQuery(CefRefPtr<CefBrowser> browser,
-                               CefRefPtr<CefFrame> frame,
-                               const std::string& request);
+                                     CefRefPtr<CefFrame> frame,
+                                     const std::string& name,
+                                     nlohmann::json& json);
 
   LootState& lootState_;
+
+  // The frame that the UI's queries were last sent from, which is told about
+  // changes made without going through the UI.
+  std::mutex uiFrameMutex_;
+  CefRefPtr<CefFrame> uiFrame_;
+
+  ActiveQueries activeQueries_;
+
+  // The file watcher posts tasks to the worker pool, so it's stopped when the
+  // handler is destroyed, before the worker pool is.
+  std::mutex fileWatcherMutex_;
+  std::string watchedGameFolder_;
+  std::unique_ptr<FileWatcher> fileWatcher_;
+  bool isWatcherFramed_;
+  bool isFileWatchingStopped_;
+
+  // Declared last so that it's destroyed first, as running queries may use
+  // the other members.
+  QueryWorkerPool workerPool_;
 };
 }
 
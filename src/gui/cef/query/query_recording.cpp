@@ -0,0 +1,179 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/query_recording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace loot {
+namespace {
+// The nearest-rank percentile of the given sorted durations.
+std::int64_t getPercentile(const std::vector<std::int64_t>& durations,
+                           double percentile) {
+  if (durations.empty()) {
+    return 0;
+  }
+
+  auto rank = static_cast<size_t>(
+      std::ceil(percentile / 100 * static_cast<double>(durations.size())));
+  if (rank == 0) {
+    rank = 1;
+  }
+
+  return durations[std::min(rank, durations.size()) - 1];
+}
+}
+
+QueryRecorder::QueryRecorder() : start_(steady_clock::now()) {}
+
+void QueryRecorder::Start(const std::filesystem::path& file) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  out_.close();
+  out_.open(file, std::ios::out | std::ios::trunc);
+  if (!out_.is_open()) {
+    throw std::runtime_error("Could not open query recording file: " +
+                             file.u8string());
+  }
+  start_ = steady_clock::now();
+}
+
+void QueryRecorder::Stop() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  out_.close();
+}
+
+bool QueryRecorder::IsRecording() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return out_.is_open();
+}
+
+void QueryRecorder::Record(const nlohmann::json& request) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!out_.is_open()) {
+    return;
+  }
+
+  nlohmann::json line = {
+      {"timeMicroseconds",
+       duration_cast<microseconds>(steady_clock::now() - start_).count()},
+      {"request", request},
+  };
+  out_ << line.dump() << std::endl;
+}
+
+QueryRecorder& GetQueryRecorder() {
+  static QueryRecorder recorder;
+  return recorder;
+}
+
+std::vector<RecordedQuery> ReadQueryRecording(
+    const std::filesystem::path& file) {
+  std::ifstream in(file);
+  if (!in.is_open()) {
+    throw std::runtime_error("Could not open query recording file: " +
+                             file.u8string());
+  }
+
+  std::vector<RecordedQuery> queries;
+  std::string line;
+  for (size_t lineNumber = 1; std::getline(in, line); ++lineNumber) {
+    if (line.empty()) {
+      continue;
+    }
+
+    try {
+      auto json = nlohmann::json::parse(line);
+
+      RecordedQuery query;
+      query.timeMicroseconds = json.at("timeMicroseconds");
+      query.request = std::move(json.at("request"));
+      // Fail early if a query can't be replayed.
+      query.request.at("name").get<std::string>();
+      queries.push_back(std::move(query));
+    } catch (std::exception& e) {
+      throw std::runtime_error("Invalid query recording on line " +
+                               std::to_string(lineNumber) + ": " + e.what());
+    }
+  }
+
+  return queries;
+}
+
+std::vector<QueryLatencies> SummariseQueryLatencies(
+    const std::vector<QueryLatency>& latencies) {
+  std::map<std::string, std::vector<std::int64_t>> durationsMap;
+  std::map<std::string, size_t> failureCounts;
+  for (const auto& latency : latencies) {
+    durationsMap[latency.name].push_back(latency.durationMicroseconds);
+    if (!latency.succeeded) {
+      failureCounts[latency.name] += 1;
+    }
+  }
+
+  std::vector<QueryLatencies> summaries;
+  summaries.reserve(durationsMap.size());
+  for (auto& entry : durationsMap) {
+    auto& durations = entry.second;
+    std::sort(durations.begin(), durations.end());
+
+    QueryLatencies summary;
+    summary.name = entry.first;
+    summary.count = durations.size();
+    summary.failureCount = failureCounts[entry.first];
+    summary.p50Microseconds = getPercentile(durations, 50);
+    summary.p90Microseconds = getPercentile(durations, 90);
+    summary.p99Microseconds = getPercentile(durations, 99);
+    summary.maxMicroseconds = durations.back();
+    summaries.push_back(summary);
+  }
+
+  return summaries;
+}
+
+nlohmann::json ToJson(const std::vector<QueryLatencies>& latencies) {
+  nlohmann::json json = nlohmann::json::array();
+  for (const auto& summary : latencies) {
+    json.push_back({
+        {"name", summary.name},
+        {"count", summary.count},
+        {"failureCount", summary.failureCount},
+        {"p50Microseconds", summary.p50Microseconds},
+        {"p90Microseconds", summary.p90Microseconds},
+        {"p99Microseconds", summary.p99Microseconds},
+        {"maxMicroseconds", summary.maxMicroseconds},
+    });
+  }
+
+  return json;
+}
+}
@@ -0,0 +1,102 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_QUERY_RECORDING
+#define LOOT_GUI_QUERY_QUERY_RECORDING
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+namespace loot {
+struct RecordedQuery {
+  // Relative to when recording started.
+  std::int64_t timeMicroseconds = 0;
+  nlohmann::json request;
+};
+
+struct QueryLatency {
+  std::string name;
+  std::int64_t durationMicroseconds = 0;
+  bool succeeded = true;
+};
+
+struct QueryLatencies {
+  std::string name;
+  size_t count = 0;
+  size_t failureCount = 0;
+  std::int64_t p50Microseconds = 0;
+  std::int64_t p90Microseconds = 0;
+  std::int64_t p99Microseconds = 0;
+  std::int64_t maxMicroseconds = 0;
+};
+
+/**
+ * @brief Writes the requests that the UI sends to a file, one JSON object per
+ *        line, so that a session's queries can be replayed later.
+ * @details Each line is flushed as it's written, so a recording is complete
+ *          up to the last query even if LOOT crashes.
+ */
+class QueryRecorder {
+public:
+  QueryRecorder();
+
+  // Start recording to the given file, replacing its contents. Throws a
+  // std::runtime_error if the file can't be opened.
+  void Start(const std::filesystem::path& file);
+  void Stop();
+  bool IsRecording() const;
+
+  // Does nothing if not recording.
+  void Record(const nlohmann::json& request);
+
+private:
+  mutable std::mutex mutex_;
+  std::ofstream out_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+QueryRecorder& GetQueryRecorder();
+
+// Read the queries that were recorded to the given file. Throws a
+// std::runtime_error if the file can't be read or has an invalid line.
+std::vector<RecordedQuery> ReadQueryRecording(
+    const std::filesystem::path& file);
+
+// Get the number of queries, failures and latency percentiles for each query
+// name, sorted by name. Percentiles use the nearest-rank method.
+std::vector<QueryLatencies> SummariseQueryLatencies(
+    const std::vector<QueryLatency>& latencies);
+
+nlohmann::json ToJson(const std::vector<QueryLatencies>& latencies);
+}
+
+#endif
@@ -0,0 +1,171 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/query_server.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "gui/state/logging.h"
+
+namespace loot {
+static constexpr const char* STOP_SERVER_QUERY = "stopServer";
+
+QueryServer::QueryServer(const std::string& endpointName,
+                         QueryRunner runQuery) :
+    endpointName_(endpointName),
+    runQuery_(runQuery),
+    listener_(endpointName),
+    isStopped_(false) {}
+
+void QueryServer::Run() {
+  auto logger = getLogger();
+  size_t acceptFailureCount = 0;
+  while (!isStopped_) {
+    std::shared_ptr<LocalConnection> connection;
+    try {
+      connection = listener_.Accept();
+      acceptFailureCount = 0;
+    } catch (std::exception& e) {
+      // Failures such as running out of file descriptors may last, so don't
+      // retry straight away, and give up if they don't go away.
+      ++acceptFailureCount;
+      if (logger) {
+        logger->error("Query server failed to accept a connection: {}",
+                      e.what());
+      }
+      if (acceptFailureCount >= MAX_ACCEPT_FAILURES) {
+        if (logger) {
+          logger->error(
+              "Query server stopping after failing to accept {} connections "
+              "in a row.",
+              acceptFailureCount);
+        }
+        isStopped_ = true;
+      } else if (!WaitToRetryAccept(acceptFailureCount)) {
+        break;
+      }
+      continue;
+    }
+
+    {
+      // Stop() may have been called before the connection was stored, in
+      // which case it couldn't shut the connection down.
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (isStopped_) {
+        break;
+      }
+      connection_ = connection;
+    }
+
+    try {
+      while (!isStopped_) {
+        auto message = connection->ReadMessage();
+        if (!message.has_value()) {
+          break;
+        }
+
+        connection->WriteMessage(Reply(message.value()));
+      }
+    } catch (std::exception& e) {
+      // A client that disconnects or misbehaves shouldn't stop the server
+      // from serving other clients.
+      if (logger) {
+        logger->error("Query server connection failed: {}", e.what());
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    connection_.reset();
+  }
+}
+
+void QueryServer::Stop() {
+  if (isStopped_.exchange(true)) {
+    return;
+  }
+
+  // Taking the lock after setting the flag means that Run() either sees the
+  // flag or has stored its connection and is waiting on it.
+  std::shared_ptr<LocalConnection> connection;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    connection = connection_;
+  }
+  stopped_.notify_all();
+
+  // Disconnect a client that the server is waiting on, as it may never send
+  // another request or close its connection.
+  if (connection) {
+    connection->Shutdown();
+  }
+
+  // Wake the server if it's waiting for a connection, so that it sees that
+  // it has been stopped.
+  try {
+    LocalConnection wakeConnection(endpointName_);
+  } catch (std::exception&) {
+  }
+}
+
+bool QueryServer::WaitToRetryAccept(size_t failureCount) {
+  auto delay = MIN_ACCEPT_RETRY_DELAY;
+  for (size_t i = 1; i < failureCount && delay < MAX_ACCEPT_RETRY_DELAY; ++i) {
+    delay *= 2;
+  }
+  delay = std::min(delay, MAX_ACCEPT_RETRY_DELAY);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  return !stopped_.wait_for(
+      lock, delay, [this]() { return isStopped_.load(); });
+}
+
+std::string QueryServer::Reply(const std::string& message) {
+  nlohmann::json reply = nlohmann::json::object();
+  try {
+    auto request = nlohmann::json::parse(message);
+    if (request.contains("id")) {
+      reply["id"] = request.at("id");
+    }
+
+    const std::string name = request.at("name");
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug("Query server received request \"{}\"", name);
+    }
+
+    if (name == STOP_SERVER_QUERY) {
+      isStopped_ = true;
+      reply["response"] = "";
+    } else {
+      reply["response"] = runQuery_(std::move(request));
+    }
+  } catch (std::exception& e) {
+    reply["error"] = e.what();
+  }
+
+  return reply.dump();
+}
+}
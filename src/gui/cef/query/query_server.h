@@ -0,0 +1,97 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_QUERY_SERVER
+#define LOOT_GUI_QUERY_QUERY_SERVER
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <json.hpp>
+
+#include "gui/cef/query/local_socket.h"
+
+namespace loot {
+// Runs the query in the given request and returns its response, or throws
+// if the query is unknown or fails.
+typedef std::function<std::string(nlohmann::json)> QueryRunner;
+
+// Serves queries to other processes on the same machine, such as mod
+// managers, so that they can use a LOOT that has already loaded a game
+// instead of starting a new LOOT each time.
+//
+// Clients send requests in the same JSON format as LOOT's UI, each on its
+// own line, and get a JSON object on its own line in reply to each request.
+// The reply has a "response" string holding the query's response, or an
+// "error" string if the request failed. If the request has an "id" it's
+// copied to the reply. Sending a request with the name "stopServer" stops
+// the server.
+class QueryServer {
+public:
+  // Start listening on the endpoint with the given name, as for
+  // LocalListener. Throws a std::system_error if the endpoint is in use.
+  QueryServer(const std::string& endpointName, QueryRunner runQuery);
+
+  // Handle connections one at a time, and the requests sent on each
+  // connection one at a time, until the server is stopped. If accepting
+  // connections keeps failing, the server waits longer between each attempt,
+  // and stops after MAX_ACCEPT_FAILURES failures in a row.
+  void Run();
+
+  // Stop the server once it has handled any request that it's handling. A
+  // connected client is disconnected instead of waiting for it to close its
+  // connection. Can be called from any thread.
+  void Stop();
+
+  // Get the reply to a message that a client sent.
+  std::string Reply(const std::string& message);
+
+private:
+  static constexpr size_t MAX_ACCEPT_FAILURES = 10;
+  static constexpr std::chrono::milliseconds MIN_ACCEPT_RETRY_DELAY{100};
+  static constexpr std::chrono::milliseconds MAX_ACCEPT_RETRY_DELAY{5000};
+
+  // Wait before accepting connections again after the given number of
+  // failures in a row. Returns false if the server is stopped meanwhile.
+  bool WaitToRetryAccept(size_t failureCount);
+
+  const std::string endpointName_;
+  const QueryRunner runQuery_;
+  LocalListener listener_;
+  std::atomic<bool> isStopped_;
+
+  // Guards the connection being served, so that Stop() can shut it down.
+  std::mutex mutex_;
+  std::condition_variable stopped_;
+  std::shared_ptr<LocalConnection> connection_;
+};
+}
+
+#endif
@@ -0,0 +1,173 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/query_worker_pool.h"
+
+#include "gui/state/logging.h"
+
+namespace loot {
+QueryWorkerPool::QueryWorkerPool(size_t threadCount) : isStopping_(false) {
+  if (threadCount < 2) {
+    threadCount = 2;
+  }
+
+  threads_.emplace_back(&QueryWorkerPool::work, this, true);
+  for (size_t i = 1; i < threadCount; ++i) {
+    threads_.emplace_back(&QueryWorkerPool::work, this, false);
+  }
+}
+
+QueryWorkerPool::~QueryWorkerPool() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    isStopping_ = true;
+  }
+  taskAvailable_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void QueryWorkerPool::post(QueryPriority priority,
+                           const std::string& gameFolder,
+                           std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (priority == QueryPriority::interactive) {
+      interactiveTasks_.push_back({priority, "", task});
+    } else if (priority == QueryPriority::idle) {
+      gameQueues_[gameFolder].idleTask = Task{priority, gameFolder, task};
+    } else {
+      gameQueues_[gameFolder].tasks.push_back({priority, gameFolder, task});
+    }
+  }
+
+  taskAvailable_.notify_all();
+}
+
+void QueryWorkerPool::work(bool interactiveOnly) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    Task task;
+    taskAvailable_.wait(lock, [&]() {
+      return isStopping_ || takeNextTask(interactiveOnly, task);
+    });
+
+    if (isStopping_) {
+      return;
+    }
+
+    lock.unlock();
+
+    try {
+      task.function();
+    } catch (std::exception& e) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->error("Exception while running query task: {}", e.what());
+      }
+    }
+
+    lock.lock();
+    finishTask(task);
+
+    // Finishing a task may allow a queued task for the same game to run.
+    if (task.priority != QueryPriority::interactive) {
+      taskAvailable_.notify_all();
+    }
+  }
+}
+
+bool QueryWorkerPool::takeNextTask(bool interactiveOnly, Task& task) {
+  if (!interactiveTasks_.empty()) {
+    task = std::move(interactiveTasks_.front());
+    interactiveTasks_.pop_front();
+    return true;
+  }
+
+  if (interactiveOnly) {
+    return false;
+  }
+
+  for (auto& [gameFolder, queue] : gameQueues_) {
+    if (queue.isExclusiveTaskRunning) {
+      continue;
+    }
+
+    if (queue.tasks.empty()) {
+      if (!queue.idleTask.has_value() || queue.runningTaskCount != 0) {
+        continue;
+      }
+
+      task = std::move(queue.idleTask.value());
+      queue.idleTask = std::nullopt;
+      queue.isExclusiveTaskRunning = true;
+      queue.runningTaskCount += 1;
+      return true;
+    }
+
+    const auto& nextTask = queue.tasks.front();
+    if (nextTask.priority == QueryPriority::exclusive) {
+      if (queue.runningTaskCount != 0) {
+        continue;
+      }
+
+      queue.isExclusiveTaskRunning = true;
+    }
+
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    queue.runningTaskCount += 1;
+    return true;
+  }
+
+  return false;
+}
+
+void QueryWorkerPool::finishTask(const Task& task) {
+  if (task.priority == QueryPriority::interactive) {
+    return;
+  }
+
+  auto it = gameQueues_.find(task.gameFolder);
+  if (it == gameQueues_.end()) {
+    return;
+  }
+
+  it->second.runningTaskCount -= 1;
+  if (task.priority == QueryPriority::exclusive ||
+      task.priority == QueryPriority::idle) {
+    it->second.isExclusiveTaskRunning = false;
+  }
+
+  if (it->second.tasks.empty() && !it->second.idleTask.has_value() &&
+      it->second.runningTaskCount == 0) {
+    gameQueues_.erase(it);
+  }
+}
+}
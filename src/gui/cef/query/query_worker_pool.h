@@ -0,0 +1,108 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_QUERY_WORKER_POOL
+#define LOOT_GUI_QUERY_QUERY_WORKER_POOL
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace loot {
+enum class QueryPriority {
+  // Cheap queries that don't read or write game state. These run as soon as a
+  // thread is free, and one thread is reserved for them.
+  interactive,
+  // Queries that read a game's state. These can run concurrently with one
+  // another, but not with exclusive queries for the same game.
+  background,
+  // Queries that change a game's state. These run one at a time for each
+  // game.
+  exclusive,
+  // Speculative work that changes a game's state. These run like exclusive
+  // tasks, but only once no other task for the game is queued or running, so
+  // tasks posted later run first.
+  idle,
+};
+
+// Runs query tasks on a fixed set of threads. Background and exclusive tasks
+// for a game are started in the order in which they were posted, so a query
+// always sees the results of any changes posted before it.
+class QueryWorkerPool {
+public:
+  // threadCount must be at least 2, as one thread only runs interactive tasks.
+  explicit QueryWorkerPool(size_t threadCount);
+  ~QueryWorkerPool();
+
+  QueryWorkerPool(const QueryWorkerPool&) = delete;
+  QueryWorkerPool& operator=(const QueryWorkerPool&) = delete;
+
+  // gameFolder is ignored for interactive tasks. Posting an idle task replaces
+  // any idle task for the same game that hasn't started yet.
+  void post(QueryPriority priority,
+            const std::string& gameFolder,
+            std::function<void()> task);
+
+private:
+  struct Task {
+    QueryPriority priority;
+    std::string gameFolder;
+    std::function<void()> function;
+  };
+
+  struct GameQueue {
+    GameQueue() : runningTaskCount(0), isExclusiveTaskRunning(false) {}
+
+    std::deque<Task> tasks;
+    std::optional<Task> idleTask;
+    size_t runningTaskCount;
+    bool isExclusiveTaskRunning;
+  };
+
+  void work(bool interactiveOnly);
+
+  // Must be called with mutex_ locked. Returns false if there is no task that
+  // can be run yet.
+  bool takeNextTask(bool interactiveOnly, Task& task);
+
+  // Must be called with mutex_ locked.
+  void finishTask(const Task& task);
+
+  std::mutex mutex_;
+  std::condition_variable taskAvailable_;
+  std::deque<Task> interactiveTasks_;
+  std::map<std::string, GameQueue> gameQueues_;
+  bool isStopping_;
+  std::vector<std::thread> threads_;
+};
+}
+
+#endif
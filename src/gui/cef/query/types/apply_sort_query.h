@@ -34,10 +34,10 @@ class ApplySortQuery : public Query {
 public:
   ApplySortQuery(G& game,
                  UnappliedChangeCounter& counter,
-                 const std::vector<std::string>& plugins) :
+                 std::vector<std::string> plugins) :
       game_(game),
       counter_(counter),
-      plugins_(plugins) {}
+      plugins_(std::move(plugins)) {}
 
   std::string executeLogic() {
     auto logger = getLogger();
@@ -0,0 +1,65 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_CANCEL_QUERY_QUERY
+#define LOOT_GUI_QUERY_CANCEL_QUERY_QUERY
+
+#include <cstdint>
+#include <functional>
+
+#include "gui/cef/query/query.h"
+
+namespace loot {
+class CancelQueryQuery : public Query {
+public:
+  // cancelQuery should cancel the query with the given cancellation ID,
+  // returning false if there is no such query in progress.
+  CancelQueryQuery(std::function<bool(int64_t)> cancelQuery,
+                   int64_t cancellationId) :
+      cancelQuery_(cancelQuery),
+      cancellationId_(cancellationId) {}
+
+  std::string executeLogic() {
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug("Cancelling query with cancellation ID {}",
+                    cancellationId_);
+    }
+
+    if (!cancelQuery_(cancellationId_) && logger) {
+      logger->debug("No query with cancellation ID {} is in progress",
+                    cancellationId_);
+    }
+
+    return "";
+  }
+
+private:
+  const std::function<bool(int64_t)> cancelQuery_;
+  const int64_t cancellationId_;
+};
+}
+
+#endif
@@ -56,7 +56,7 @@ public:
         continue;
       }
 
-      auto loadOrderIndex = this->getGame().GetActiveLoadOrderIndex(plugin, loadOrder);
+      auto loadOrderIndex = this->getGame().GetActiveLoadOrderIndex(plugin);
 
       nlohmann::json pluginJson = {{"name", pluginName}};
       if (loadOrderIndex.has_value()) {
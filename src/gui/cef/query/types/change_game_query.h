@@ -35,7 +35,7 @@ public:
   ChangeGameQuery(GamesManager& gamesManager,
                   std::string language,
                   std::string gameFolder,
-                  std::function<void(std::string)> sendProgressUpdate) :
+                  ProgressCallback sendProgressUpdate) :
       gamesManager_(gamesManager),
       gameFolder_(gameFolder),
       language_(language),
@@ -53,7 +53,7 @@ private:
   GamesManager& gamesManager_;
   const std::string gameFolder_;
   const std::string language_;
-  const std::function<void(std::string)> sendProgressUpdate_;
+  const ProgressCallback sendProgressUpdate_;
 };
 }
 
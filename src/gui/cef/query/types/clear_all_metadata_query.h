@@ -62,29 +62,32 @@ public:
 
 private:
   std::vector<std::string> getUserlistPluginNames() const {
-    std::vector<std::string> userlistPluginNames;
-    for (const auto& plugin : this->getGame().GetPlugins()) {
-      if (this->getGame().GetUserMetadata(plugin->GetName()).has_value()) {
-        userlistPluginNames.push_back(plugin->GetName());
-      }
-    }
-
-    return userlistPluginNames;
+    return this->getGame().GetPluginsWithUserMetadata();
   }
 
+  // The plugins are derived together so that they share one derivation
+  // context and can be split between threads.
   std::string getDerivedMetadataJson(
       const std::vector<std::string>& userlistPluginNames) {
-    nlohmann::json json;
-
-    json["plugins"] = nlohmann::json::array();
+    std::vector<std::shared_ptr<const PluginInterface>> plugins;
+    plugins.reserve(userlistPluginNames.size());
     for (const auto& pluginName : userlistPluginNames) {
-      auto derivedMetadata = this->generateDerivedMetadata(pluginName);
-      if (derivedMetadata.has_value()) {
-        json["plugins"].push_back(derivedMetadata.value());
+      auto plugin = this->getGame().GetPlugin(pluginName);
+      if (plugin) {
+        plugins.push_back(plugin);
       }
     }
 
-    return json.dump();
+    const auto context = this->createDerivationContext();
+
+    JsonWriter writer;
+    this->writeJsonWithPlugins(
+        writer, nlohmann::json::object(), [&](JsonWriter& pluginsWriter) {
+          this->writeDerivedMetadata(
+              pluginsWriter, plugins.cbegin(), plugins.cend(), context);
+        });
+
+    return writer.release();
   }
 };
 }
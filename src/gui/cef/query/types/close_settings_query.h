@@ -35,7 +35,7 @@ class CloseSettingsQuery : public Query {
 public:
   CloseSettingsQuery(LootState& state, nlohmann::json settings) :
       state_(state),
-      settings_(settings) {}
+      settings_(std::move(settings)) {}
 
   std::string executeLogic() {
     auto logger = getLogger();
@@ -48,12 +48,19 @@ public:
     copyThemeFile();
 
     state_.setDefaultGame(settings_.value("game", ""));
-    state_.setLanguage(settings_.value("language", ""));
+    auto language = settings_.value("language", "");
+    if (language != state_.getLanguage() && !language.empty()) {
+      state_.applyLanguage(language);
+    } else {
+      state_.setLanguage(language);
+    }
     state_.setTheme(settings_.value("theme", "default"));
     state_.enableDebugLogging(settings_.value("enableDebugLogging", false));
     state_.updateMasterlist(settings_.value("updateMasterlist", true));
     state_.enableLootUpdateCheck(
         settings_.value("enableLootUpdateCheck", true));
+    state_.setPreloadGames(settings_.value("preloadGames", false));
+    state_.enableLowFootprintMode(settings_.value("lowFootprintMode", false));
     state_.storeGameSettings(
         settings_.value("games", std::vector<GameSettings>()));
 
@@ -35,7 +35,7 @@ along with LOOT.  If not, see
 namespace loot {
 class CopyContentQuery : public ClipboardQuery {
 public:
-  CopyContentQuery(const nlohmann::json& content) : content_(content) {}
+  CopyContentQuery(nlohmann::json content) : content_(std::move(content)) {}
 
   std::string executeLogic() {
     const std::string text =
@@ -26,61 +26,51 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_COPY_LOAD_ORDER_QUERY
 #define LOOT_GUI_QUERY_COPY_LOAD_ORDER_QUERY
 
+#include "gui/cef/query/load_order_formatter.h"
 #include "gui/cef/query/types/clipboard_query.h"
 
 namespace loot {
-struct Counters {
-  size_t activeNormal = 0;
-  size_t activeLightMasters = 0;
-};
-
 template<typename G = gui::Game>
 class CopyLoadOrderQuery : public ClipboardQuery {
 public:
   CopyLoadOrderQuery(const G& game,
-                     const std::vector<std::string>& plugins) :
+                     std::vector<std::string> plugins,
+                     LoadOrderFormat format = LoadOrderFormat::table) :
       game_(game),
-      plugins_(plugins) {}
+      plugins_(std::move(plugins)),
+      format_(format) {}
 
   std::string executeLogic() {
-    Counters counters;
-    std::stringstream stream;
-    for (const auto& pluginName : plugins_) {
-      writePluginLine(stream, pluginName, counters);
-    }
-
-    copyToClipboard(stream.str());
+    copyToClipboard(formatLoadOrder());
     return "";
   }
 
-private:
-  void writePluginLine(std::ostream& stream,
-                       const std::string& pluginName,
-                       Counters& counters) {
-    auto plugin = game_.GetPlugin(pluginName);
-    if (!plugin) {
-      return;
+  // Plugins that are not loaded are skipped.
+  std::string formatLoadOrder() const {
+    size_t nameLength = 0;
+    for (const auto& pluginName : plugins_) {
+      nameLength += pluginName.size();
     }
 
-    auto isActive = game_.IsPluginActive(pluginName);
-
-    if (isActive && plugin->IsLightMaster()) {
-      stream << "254 FE " << std::setw(3) << std::hex
-             << counters.activeLightMasters << std::dec << " ";
-      counters.activeLightMasters += 1;
-    } else if (isActive) {
-      stream << std::setw(3) << counters.activeNormal << " " << std::hex
-             << std::setw(2) << counters.activeNormal << std::dec << "     ";
-      counters.activeNormal += 1;
-    } else {
-      stream << "           ";
+    LoadOrderFormatter formatter(format_, plugins_.size(), nameLength);
+    for (const auto& pluginName : plugins_) {
+      auto plugin = game_.GetPlugin(pluginName);
+      if (!plugin) {
+        continue;
+      }
+
+      formatter.writePlugin(pluginName,
+                            game_.IsPluginActive(pluginName),
+                            plugin->IsLightMaster());
     }
 
-    stream << pluginName << "\r\n";
+    return formatter.getOutput();
   }
 
+private:
   const G& game_;
   const std::vector<std::string> plugins_;
+  const LoadOrderFormat format_;
 };
 }
 
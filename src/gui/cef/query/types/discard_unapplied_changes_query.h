@@ -27,23 +27,31 @@ along with LOOT.  If not, see
 #define LOOT_GUI_QUERY_DISCARD_UNAPPLIED_CHANGES_QUERY
 
 #include "gui/cef/query/query.h"
+#include "gui/state/game/games_manager.h"
 #include "gui/state/unapplied_change_counter.h"
 
 namespace loot {
 class DiscardUnappliedChangesQuery : public Query {
 public:
-  DiscardUnappliedChangesQuery(UnappliedChangeCounter& unappliedChangeCounter) :
-      unappliedChangeCounter_(unappliedChangeCounter) {}
+  DiscardUnappliedChangesQuery(UnappliedChangeCounter& unappliedChangeCounter,
+                               GamesManager& gamesManager) :
+      unappliedChangeCounter_(unappliedChangeCounter),
+      gamesManager_(gamesManager) {}
 
   std::string executeLogic() {
     while (unappliedChangeCounter_.HasUnappliedChanges())
       unappliedChangeCounter_.DecrementUnappliedChangeCounter();
 
+    // This is usually sent just before LOOT quits, so make sure that user
+    // metadata edits that were applied have been written.
+    gamesManager_.FlushUserMetadata();
+
     return "";
   }
 
 private:
   UnappliedChangeCounter& unappliedChangeCounter_;
+  GamesManager& gamesManager_;
 };
 }
 
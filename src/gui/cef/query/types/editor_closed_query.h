@@ -106,22 +106,21 @@ private:
     // Determine what metadata in the response is user-added.
     auto userMetadata = getUserMetadata();
 
-    // Now erase any existing userlist entry.
+    // Replace any existing userlist entry and save the edited userlist,
+    // undoing the edit if either fails.
     if (logger) {
-      logger->trace("Erasing the existing userlist entry.");
+      logger->trace("Replacing the existing userlist entry.");
     }
-    this->getGame().ClearUserMetadata(metadata_.GetName());
-
-    // Add a new userlist entry if necessary.
-    if (!userMetadata.HasNameOnly()) {
-      if (logger) {
-        logger->trace("Adding new metadata to new userlist entry.");
-      }
-      this->getGame().AddUserMetadata(userMetadata);
+    auto& game = this->getGame();
+    game.BeginUserMetadataTransaction();
+    try {
+      game.ReplaceUserMetadata(userMetadata);
+      game.SaveUserMetadata();
+    } catch (...) {
+      game.RollbackUserMetadataTransaction();
+      throw;
     }
-
-    // Save edited userlist.
-    this->getGame().SaveUserMetadata();
+    game.CommitUserMetadataTransaction();
   }
 
   UnappliedChangeCounter& counter_;
@@ -0,0 +1,81 @@
+/*  LOOT
+
+A load order optimisation tool for
+Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+Copyright (C) 2014 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_GUI_QUERY_GET_CONFLICT_MATRIX_QUERY
+#define LOOT_GUI_QUERY_GET_CONFLICT_MATRIX_QUERY
+
+#include "gui/cef/query/json_writer.h"
+#include "gui/cef/query/query.h"
+#include "gui/state/game/game.h"
+
+namespace loot {
+// Gets every pair of loaded plugins that have overlapping FormIDs, with the
+// number of records they have in common, in one pass over all the plugins'
+// records.
+template<typename G = gui::Game>
+class GetConflictMatrixQuery : public Query {
+public:
+  GetConflictMatrixQuery(const G& game) : game_(game) {}
+
+  std::string executeLogic() {
+    // Scanning can't be interrupted once started, so check if the query has
+    // been cancelled while it was waiting to run.
+    throwIfCancelled();
+
+    auto overlaps = game_.GetFormIdOverlaps();
+
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug("Found {} pairs of plugins with overlapping FormIDs.",
+                    overlaps.size());
+    }
+
+    JsonWriter writer;
+    writer.startObject();
+    writer.key("overlaps");
+    writer.startArray();
+    for (const auto& overlap : overlaps) {
+      writer.startObject();
+      writer.key("plugins");
+      writer.startArray();
+      writer.value(overlap.plugin);
+      writer.value(overlap.otherPlugin);
+      writer.endArray();
+      writer.key("recordCount");
+      writer.value(overlap.recordCount);
+      writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+
+    return writer.release();
+  }
+
+private:
+  const G& game_;
+};
+}
+
+#endif
@@ -41,52 +41,82 @@ public:
       pluginName_(pluginName) {}
 
   std::string executeLogic() {
+    auto plugin = loadPlugins();
+    auto plugins = this->getGame().GetPlugins();
+    const auto context = this->createDerivationContext();
+
+    JsonWriter writer;
+    writer.startObject();
+    writer.key("generalMessages");
+    write_json_array(writer, this->getGeneralMessages());
+    writer.key("plugins");
+    writePlugins(writer, plugin, plugins.cbegin(), plugins.cend(), context);
+    writer.endObject();
+
+    return writer.release();
+  }
+
+  void executeChunkedLogic(size_t pluginsPerChunk,
+                           const Query::ChunkCallback& sendChunk) override {
+    auto plugin = loadPlugins();
+    auto plugins = this->getGame().GetPlugins();
+    const auto context = this->createDerivationContext();
+
+    this->sendChunkedJsonResponse(
+        {{"generalMessages", this->getGeneralMessages()}},
+        plugins.cbegin(),
+        plugins.cend(),
+        pluginsPerChunk,
+        [&](JsonWriter& writer, auto chunkStart, auto chunkEnd) {
+          writePlugins(writer, plugin, chunkStart, chunkEnd, context);
+        },
+        sendChunk);
+  }
+
+private:
+  // Load the plugins and return the plugin that conflicts are being checked
+  // for.
+  std::shared_ptr<const PluginInterface> loadPlugins() {
     auto logger = getLogger();
     if (logger) {
       logger->debug("Searching for plugins that conflict with {}",
                      pluginName_);
     }
 
-    // Checking for FormID overlap will only work if the plugins have been
-    // loaded, so check if the plugins have been fully loaded, and if not load
-    // all plugins.
-    if (!this->getGame().ArePluginsFullyLoaded())
-      this->getGame().LoadAllInstalledPlugins(false);
-
-    return getJsonResponse();
-  }
-
-private:
-  std::string getJsonResponse() {
-    nlohmann::json json = {
-        {"generalMessages", this->getGeneralMessages()},
-        {"plugins", nlohmann::json::array()},
-    };
-
     auto plugin = this->getGame().GetPlugin(pluginName_);
     if (!plugin) {
       throw std::runtime_error("The plugin \"" + pluginName_ +
                                "\" is not loaded.");
     }
 
-    for (const auto& otherPlugin : this->getGame().GetPlugins()) {
-      json["plugins"].push_back({
-          {"metadata", this->generateDerivedMetadata(otherPlugin)},
-          {"conflicts", doPluginsConflict(plugin, otherPlugin)},
-      });
-    }
+    // Checking for FormID overlap needs the plugins' FormIDs, so read them for
+    // the plugins that may overlap this one, instead of fully loading every
+    // installed plugin.
+    this->getGame().LoadFormIDsOfPossibleOverlaps(pluginName_);
 
-    return json.dump();
+    return plugin;
   }
 
-  bool doPluginsConflict(
-      const std::shared_ptr<const PluginInterface>& plugin,
-      const std::shared_ptr<const PluginInterface>& otherPlugin) {
-    if (plugin->DoFormIDsOverlap(*otherPlugin)) {
-      return true;
-    } else {
-      return false;
+  // Derived metadata is reused from previous queries for plugins whose
+  // inputs haven't changed since, so only the metadata of plugins that are
+  // new or have changed is derived.
+  template<typename ForwardIterator>
+  void writePlugins(JsonWriter& writer,
+                    const std::shared_ptr<const PluginInterface>& plugin,
+                    ForwardIterator firstPlugin,
+                    ForwardIterator lastPlugin,
+                    const DerivationContext& context) {
+    writer.startArray();
+    for (auto it = firstPlugin; it != lastPlugin; ++it) {
+      this->throwIfCancelled();
+      writer.startObject();
+      writer.key("conflicts");
+      writer.value(this->getGame().DoFormIDsOverlap(plugin, *it));
+      writer.key("metadata");
+      writer.serialisedValue(this->getDerivedMetadataJson(*it, context));
+      writer.endObject();
     }
+    writer.endArray();
   }
 
   const std::string pluginName_;
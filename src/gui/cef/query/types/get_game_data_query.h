@@ -26,10 +26,17 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_GET_GAME_DATA_QUERY
 #define LOOT_GUI_QUERY_GET_GAME_DATA_QUERY
 
+#include <unordered_map>
+
+#include <boost/format.hpp>
 #include <boost/locale.hpp>
 
+#include "gui/cef/query/game_data_snapshot.h"
+#include "gui/cef/query/progress_channel.h"
 #include "gui/cef/query/types/metadata_query.h"
+#include "gui/helpers.h"
 #include "gui/state/game/game.h"
+#include "gui/version.h"
 #include "loot/loot_version.h"
 
 namespace loot {
@@ -38,22 +45,82 @@ class GetGameDataQuery : public MetadataQuery<G> {
 public:
   GetGameDataQuery(G& game,
                    std::string language,
-                   std::function<void(std::string)> sendProgressUpdate) :
+                   ProgressCallback sendProgressUpdate,
+                   bool incremental = false,
+                   bool allowProvisional = false) :
       MetadataQuery<G>(game, language),
-      sendProgressUpdate_(sendProgressUpdate) {}
+      sendProgressUpdate_(sendProgressUpdate),
+      incremental_(incremental),
+      allowProvisional_(allowProvisional) {}
 
   std::string executeLogic() {
-    sendProgressUpdate_(boost::locale::translate(
-        "Parsing, merging and evaluating metadata..."));
+    auto installed = loadInstalledPlugins();
+
+    auto previousFingerprints = this->getGame().GetDerivedPluginFingerprints();
+    auto fingerprints = this->recordFingerprints(installed);
+
+    if (!incremental_) {
+      return this->generateJsonResponse(installed.cbegin(), installed.cend());
+    }
+
+    return generateDeltaJsonResponse(
+        installed, previousFingerprints, fingerprints);
+  }
+
+  void executeChunkedLogic(size_t pluginsPerChunk,
+                           const Query::ChunkCallback& sendChunk) override {
+    // Incremental responses are usually small, so aren't worth splitting.
+    if (incremental_) {
+      Query::executeChunkedLogic(pluginsPerChunk, sendChunk);
+      return;
+    }
+
+    if (allowProvisional_) {
+      sendRevalidatedResponse(pluginsPerChunk, sendChunk);
+      return;
+    }
+
+    auto installed = loadInstalledPlugins();
+    this->recordFingerprints(installed);
+
+    this->sendChunkedJsonResponse(
+        installed.cbegin(), installed.cend(), pluginsPerChunk, sendChunk);
+  }
+
+private:
+  // Load the installed plugins and return them in load order.
+  std::vector<std::shared_ptr<const PluginInterface>> loadInstalledPlugins() {
+    sendProgressUpdate_(ProgressUpdate(boost::locale::translate(
+        "Parsing, merging and evaluating metadata...")));
 
     /* If the game's plugins object is empty, this is the first time loading
        the game data, so also load the metadata lists. */
-    bool isFirstLoad = this->getGame().GetPlugins().empty();
+    bool isFirstLoad = !this->getGame().HasPlugins();
+
+    // Progress is reported for every plugin read, and the progress channel
+    // limits how often the UI is updated.
+    const std::string readProgressFormat =
+        boost::locale::translate("Reading plugins... (%1% of %2%)");
+    const auto sendReadProgress = [&](const std::string&,
+                                      size_t readCount,
+                                      size_t totalCount) {
+      sendProgressUpdate_(ProgressUpdate(
+          (boost::format(readProgressFormat) % readCount % totalCount).str(),
+          readCount,
+          totalCount));
+    };
 
-    this->getGame().LoadAllInstalledPlugins(true);
+    // The metadata lists also need to be reloaded if they have been changed
+    // outside of LOOT.
+    if (isFirstLoad || this->getGame().AreMetadataListsStale()) {
+      this->getGame().LoadAllInstalledPluginsAndMetadata(
+          true, false, sendReadProgress);
+    } else {
+      this->getGame().LoadAllInstalledPlugins(true, sendReadProgress);
+    }
 
-    if (isFirstLoad)
-      this->getGame().LoadMetadata();
+    sendProgressUpdate_(ProgressUpdate(boost::locale::translate(
+        "Parsing, merging and evaluating metadata...")));
 
     // Sort plugins into their load order.
     std::vector<std::shared_ptr<const PluginInterface>> installed;
@@ -65,11 +132,157 @@ public:
       }
     }
 
-    return this->generateJsonResponse(installed.cbegin(), installed.cend());
+    return installed;
   }
 
-private:
-  std::function<void(std::string)> sendProgressUpdate_;
+  // Generate a response that only includes derived metadata for plugins that
+  // may have changed since metadata was last derived for them, and the
+  // current load order, which the UI can use to update its existing data.
+  std::string generateDeltaJsonResponse(
+      const std::vector<std::shared_ptr<const PluginInterface>>& installed,
+      const std::unordered_map<std::string, gui::PluginFingerprint>&
+          previousFingerprints,
+      const std::unordered_map<std::string, gui::PluginFingerprint>&
+          fingerprints) {
+    return generateDeltaJsonResponse(
+        installed,
+        this->getPluginsToDerive(installed, previousFingerprints, fingerprints),
+        this->generateGameJson());
+  }
+
+  // Generate a response made up of the given JSON object's fields, the
+  // current load order and the derived metadata of the given plugins.
+  std::string generateDeltaJsonResponse(
+      const std::vector<std::shared_ptr<const PluginInterface>>& installed,
+      const std::vector<std::shared_ptr<const PluginInterface>>&
+          pluginsToDerive,
+      nlohmann::json json) {
+    const auto context = this->createDerivationContext();
+
+    nlohmann::json loadOrderJson = nlohmann::json::array();
+    for (const auto& plugin : installed) {
+      nlohmann::json pluginJson = {{"name", plugin->GetName()}};
+      auto loadOrderIndex = context.getActiveLoadOrderIndex(plugin->GetName());
+      if (loadOrderIndex.has_value()) {
+        pluginJson["loadOrderIndex"] = loadOrderIndex.value();
+      }
+      loadOrderJson.push_back(pluginJson);
+    }
+
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug("Deriving metadata for {} of {} installed plugins.",
+                    pluginsToDerive.size(),
+                    installed.size());
+    }
+
+    json["loadOrder"] = loadOrderJson;
+
+    JsonWriter writer;
+    this->writeJsonWithPlugins(writer, json, [&](JsonWriter& pluginsWriter) {
+      this->writeDerivedMetadata(pluginsWriter,
+                                 pluginsToDerive.cbegin(),
+                                 pluginsToDerive.cend(),
+                                 context);
+    });
+
+    return writer.release();
+  }
+
+  // Send the game's data from its snapshot straight away if it's being loaded
+  // for the first time, then load the game's live data and send the
+  // differences from the snapshot, so that the UI can be used while the data
+  // loads. If there's no snapshot, the live data is sent in chunks as usual.
+  // Either way, the snapshot is then updated to match the live data.
+  void sendRevalidatedResponse(size_t pluginsPerChunk,
+                               const Query::ChunkCallback& sendChunk) {
+    const auto snapshotPath = this->getGame().GameDataSnapshotPath();
+
+    GameDataSnapshot snapshot;
+    if (!snapshotPath.empty() && !this->getGame().HasPlugins()) {
+      snapshot.Load(snapshotPath);
+    }
+
+    if (!snapshot.IsEmpty()) {
+      sendChunk(snapshot.GetProvisionalResponse());
+
+      // Don't cover the provisional data with progress messages.
+      sendProgressUpdate_ = [](const ProgressUpdate&) {};
+    }
+
+    auto installed = loadInstalledPlugins();
+    auto fingerprints = this->recordFingerprints(installed);
+    auto metadataKey = getMetadataKey();
+
+    if (snapshot.IsEmpty()) {
+      this->sendChunkedJsonResponse(
+          installed.cbegin(), installed.cend(), pluginsPerChunk, sendChunk);
+
+      if (!snapshotPath.empty()) {
+        saveSnapshot(snapshotPath,
+                     GameDataSnapshot(std::move(metadataKey),
+                                      std::move(fingerprints),
+                                      this->generateJsonResponse(
+                                          installed.cbegin(), installed.cend())));
+      }
+      return;
+    }
+
+    // If anything other than the plugins themselves has changed, any plugin's
+    // derived metadata may have changed.
+    auto pluginsToDerive =
+        snapshot.GetMetadataKey() == metadataKey
+            ? this->getPluginsToDerive(
+                  installed, snapshot.GetPluginFingerprints(), fingerprints)
+            : installed;
+
+    auto json = this->generateGameJson();
+    json["revalidated"] = true;
+    auto response = generateDeltaJsonResponse(installed, pluginsToDerive, json);
+    sendChunk(response);
+    sendChunk(Query::CHUNKED_RESPONSE_COMPLETE);
+
+    auto delta = nlohmann::json::parse(response);
+    delta.erase("revalidated");
+    snapshot.ApplyDelta(delta, std::move(metadataKey), std::move(fingerprints));
+    saveSnapshot(snapshotPath, snapshot);
+  }
+
+  // Identifies everything other than the plugins that their derived metadata
+  // depends on.
+  std::string getMetadataKey() const {
+    const auto toString =
+        [](const std::optional<std::filesystem::file_time_type>& time) {
+          return time.has_value()
+                     ? std::to_string(time.value().time_since_epoch().count())
+                     : std::string();
+        };
+
+    const auto metadataListTimes = this->getGame().GetMetadataListTimes();
+
+    return gui::Version::string() + " " + gui::Version::revision + "\n" +
+           this->getLanguage() + "\n" + toString(metadataListTimes.first) +
+           "\n" + toString(metadataListTimes.second);
+  }
+
+  static void saveSnapshot(const std::filesystem::path& snapshotPath,
+                           const GameDataSnapshot& snapshot) {
+    try {
+      snapshot.Save(snapshotPath);
+    } catch (std::exception& e) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->error("Failed to save the game data snapshot: {}", e.what());
+      }
+    }
+  }
+
+  ProgressCallback sendProgressUpdate_;
+  const bool incremental_;
+  // If true, persistent queries are first sent the game's data from its
+  // snapshot, marked as provisional, and then the differences between it and
+  // the live data, marked as revalidated.
+  const bool allowProvisional_;
 };
 }
 
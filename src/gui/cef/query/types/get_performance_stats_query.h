@@ -0,0 +1,134 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_GET_PERFORMANCE_STATS_QUERY
+#define LOOT_GUI_QUERY_GET_PERFORMANCE_STATS_QUERY
+
+#undef min
+
+#include <json.hpp>
+
+#include "gui/cef/query/query.h"
+#include "gui/state/cache_registry.h"
+#include "gui/state/memory_accounting.h"
+#include "gui/state/timing.h"
+
+namespace loot {
+class GetPerformanceStatsQuery : public Query {
+public:
+  // If includeTraceEvents is true, the response also holds the recorded
+  // events in the Chrome trace event format, so it can be loaded into
+  // chrome://tracing. The response also holds the cache budget and each
+  // registered cache's size and eviction totals, and the recent process
+  // memory samples.
+  GetPerformanceStatsQuery(
+      bool includeTraceEvents,
+      TimingRecorder& recorder = GetTimingRecorder(),
+      CacheRegistry& cacheRegistry = GetCacheRegistry(),
+      ProcessMemoryHistory& memoryHistory = GetProcessMemoryHistory()) :
+      includeTraceEvents_(includeTraceEvents),
+      recorder_(recorder),
+      cacheRegistry_(cacheRegistry),
+      memoryHistory_(memoryHistory) {}
+
+  std::string executeLogic() {
+    auto logger = getLogger();
+    if (logger) {
+      logger->info("Getting performance stats.");
+    }
+
+    const auto events = recorder_.GetEvents();
+
+    nlohmann::json json = {{"operations", nlohmann::json::array()}};
+    for (const auto& timings : SummariseTimings(events)) {
+      json["operations"].push_back({
+          {"name", timings.name},
+          {"count", timings.count},
+          {"totalMicroseconds", timings.totalMicroseconds},
+          {"maxMicroseconds", timings.maxMicroseconds},
+          {"allocationCount", timings.allocationCount},
+          {"allocatedBytes", timings.allocatedBytes},
+          {"maxPeakAllocatedBytes", timings.maxPeakBytes},
+      });
+    }
+    json["allocationAccounting"] = IsAllocationAccountingEnabled();
+
+    json["cacheBudgetBytes"] = cacheRegistry_.GetBudget();
+    json["caches"] = nlohmann::json::array();
+    for (const auto& stats : cacheRegistry_.GetStats()) {
+      json["caches"].push_back({
+          {"name", stats.name},
+          {"estimatedBytes", stats.estimatedBytes},
+          {"evictionCount", stats.evictionCount},
+          {"evictedBytes", stats.evictedBytes},
+      });
+    }
+
+    json["memorySamples"] = nlohmann::json::array();
+    for (const auto& sample : memoryHistory_.GetSamples()) {
+      const auto time = std::chrono::duration_cast<std::chrono::milliseconds>(
+          sample.time.time_since_epoch());
+      json["memorySamples"].push_back({
+          {"timeMilliseconds", time.count()},
+          {"residentBytes", sample.residentBytes},
+          {"committedBytes", sample.committedBytes},
+      });
+    }
+
+    if (includeTraceEvents_) {
+      json["displayTimeUnit"] = "ms";
+      json["traceEvents"] = nlohmann::json::array();
+      for (const auto& event : events) {
+        json["traceEvents"].push_back({
+            {"name", event.name},
+            {"cat", "loot"},
+            {"ph", "X"},
+            {"ts", event.startMicroseconds},
+            {"dur", event.durationMicroseconds},
+            {"pid", 0},
+            {"tid", event.threadId},
+        });
+        if (event.allocations.count > 0) {
+          json["traceEvents"].back()["args"] = {
+              {"allocationCount", event.allocations.count},
+              {"allocatedBytes", event.allocations.bytes},
+              {"peakAllocatedBytes", event.allocations.peakBytes},
+          };
+        }
+      }
+    }
+
+    return json.dump();
+  }
+
+private:
+  const bool includeTraceEvents_;
+  TimingRecorder& recorder_;
+  CacheRegistry& cacheRegistry_;
+  ProcessMemoryHistory& memoryHistory_;
+};
+}
+
+#endif
@@ -44,17 +44,23 @@ public:
       logger->info("Getting LOOT's settings.");
     }
 
+    // Use one snapshot so that the settings are consistent, and to avoid
+    // copying them.
+    auto settings = settings_.getSnapshot();
+
     nlohmann::json json = {
-        {"game", settings_.getGame()},
-        {"lastVersion", settings_.getLastVersion()},
-        {"language", settings_.getLanguage()},
-        {"theme", settings_.getTheme()},
-        {"enableDebugLogging", settings_.isDebugLoggingEnabled()},
-        {"updateMasterlist", settings_.updateMasterlist()},
-        {"enableLootUpdateCheck", settings_.isLootUpdateCheckEnabled()},
-        {"games", settings_.getGameSettings()},
-        {"filters", settings_.getFilters()},
-        {"languages", settings_.getLanguages()}
+        {"game", settings->game},
+        {"lastVersion", settings->lastVersion},
+        {"language", settings->language},
+        {"theme", settings->theme},
+        {"enableDebugLogging", settings->enableDebugLogging},
+        {"updateMasterlist", settings->updateMasterlist},
+        {"enableLootUpdateCheck", settings->enableLootUpdateCheck},
+        {"preloadGames", settings->preloadGames},
+        {"lowFootprintMode", settings->lowFootprintMode},
+        {"games", settings->gameSettings},
+        {"filters", settings->filters},
+        {"languages", settings->languages}
     };
 
     return json.dump();
@@ -26,12 +26,22 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_METADATA_QUERY
 #define LOOT_GUI_QUERY_METADATA_QUERY
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
+#include "gui/cef/query/derivation_context.h"
 #include "gui/cef/query/derived_plugin_metadata.h"
+#include "gui/cef/query/json_writer.h"
 #include "gui/cef/query/query.h"
+#include "gui/helpers.h"
 #include "gui/state/game/helpers.h"
+#include "gui/state/game/plugin_fingerprint.h"
+#include "gui/state/timing.h"
 #include "loot/exception/file_access_error.h"
 #include "loot/exception/git_state_error.h"
 
@@ -44,10 +54,10 @@ protected:
       language_(language),
       logger_(getLogger()) {}
 
-  std::vector<SimpleMessage> getGeneralMessages() const {
-    std::vector<Message> messages = game_.GetMessages();
+  const std::string& getLanguage() const { return language_; }
 
-    return toSimpleMessages(messages, language_);
+  std::vector<SimpleMessage> getGeneralMessages() const {
+    return game_.GetSimpleMessages(language_);
   }
 
   std::optional<PluginMetadata> getNonUserMetadata(
@@ -69,19 +79,26 @@ protected:
     return metadata;
   }
 
-  std::optional<DerivedPluginMetadata<G>> generateDerivedMetadata(
-      const std::string& pluginName) {
-    auto plugin = game_.GetPlugin(pluginName);
-    if (plugin) {
-      return generateDerivedMetadata(plugin);
-    }
+  // Create the state shared by the derivation of each plugin's metadata in a
+  // response, using the game's current load order.
+  DerivationContext createDerivationContext() const {
+    return createDerivationContext(game_.GetLoadOrder());
+  }
 
-    return std::nullopt;
+  DerivationContext createDerivationContext(
+      const std::vector<std::string>& loadOrder) const {
+    return DerivationContext(game_, loadOrder, language_);
   }
 
   DerivedPluginMetadata<G> generateDerivedMetadata(
-      const std::shared_ptr<const PluginInterface>& plugin) {
-    auto derived = DerivedPluginMetadata<G>(plugin, game_, language_);
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const DerivationContext& context) {
+    // This is called for each plugin in the loops over plugins, so is a good
+    // place to check if the query has been cancelled.
+    throwIfCancelled();
+
+    auto derived = DerivedPluginMetadata<G>(plugin, context);
+    derived.setCRC(game_.GetPluginCRC(plugin));
 
     auto nonUserMetadata = getNonUserMetadata(plugin);
     if (nonUserMetadata.has_value()) {
@@ -108,19 +125,127 @@ protected:
     return derived;
   }
 
+  // Get the JSON serialisation of the plugin's derived metadata, reusing the
+  // game's cached serialisation if the plugin's inputs haven't changed since
+  // it was derived.
+  std::string getDerivedMetadataJson(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const DerivationContext& context) {
+    throwIfCancelled();
+
+    const auto isActive = context.isActive(plugin->GetName());
+    const auto loadOrderIndex =
+        context.getActiveLoadOrderIndex(plugin->GetName());
+
+    auto json = game_.GetDerivedMetadataJson(
+        plugin->GetName(), context.getLanguage(), isActive, loadOrderIndex);
+    if (json.has_value()) {
+      return json.value();
+    }
+
+    JsonWriter writer;
+    write_json(writer, generateDerivedMetadata(plugin, context));
+    json = writer.release();
+
+    game_.SetDerivedMetadataJson(plugin->GetName(),
+                                 context.getLanguage(),
+                                 isActive,
+                                 loadOrderIndex,
+                                 mayDependOnOtherFiles(plugin),
+                                 json.value());
+
+    return json.value();
+  }
+
   std::string generateJsonResponse(const std::string& pluginName) {
-    auto derivedMetadata = generateDerivedMetadata(pluginName);
-    if (derivedMetadata.has_value()) {
-      return nlohmann::json(derivedMetadata.value()).dump();
+    auto plugin = game_.GetPlugin(pluginName);
+    if (plugin) {
+      return getDerivedMetadataJson(
+          plugin, DerivationContext::forPlugin(game_, plugin, language_));
     }
 
     return "";
   }
 
-  template<typename InputIterator>
-  std::string generateJsonResponse(InputIterator firstPlugin,
-                                   InputIterator lastPlugin) {
-    nlohmann::json json = {
+  // The response is written directly to a string rather than building a JSON
+  // tree of all the plugins' metadata first, as the latter can take up a lot
+  // of memory for large load orders.
+  template<typename ForwardIterator>
+  std::string generateJsonResponse(ForwardIterator firstPlugin,
+                                   ForwardIterator lastPlugin) {
+    const size_t pluginCount = std::distance(firstPlugin, lastPlugin);
+
+    const auto context = createDerivationContext();
+
+    JsonWriter writer;
+    writer.reserve(pluginCount * ESTIMATED_DERIVED_METADATA_SIZE);
+    writeJsonWithPlugins(
+        writer, generateGameJson(), [&](JsonWriter& pluginsWriter) {
+          writeDerivedMetadata(pluginsWriter, firstPlugin, lastPlugin, context);
+        });
+
+    return writer.release();
+  }
+
+  // Send a response object made up of the given JSON object's fields and a
+  // "plugins" array, split across messages that each hold up to
+  // pluginsPerChunk plugins. Only the first message includes the given
+  // object's fields. writePlugins is called with the writer and the range of
+  // plugins for each chunk, and must write them as an array.
+  template<typename ForwardIterator, typename Function>
+  void sendChunkedJsonResponse(const nlohmann::json& json,
+                               ForwardIterator firstPlugin,
+                               ForwardIterator lastPlugin,
+                               size_t pluginsPerChunk,
+                               Function writePlugins,
+                               const Query::ChunkCallback& sendChunk) {
+    auto chunkJson = json;
+    auto chunkStart = firstPlugin;
+    do {
+      const size_t remaining = std::distance(chunkStart, lastPlugin);
+      auto chunkEnd =
+          std::next(chunkStart, std::min(pluginsPerChunk, remaining));
+
+      JsonWriter writer;
+      writer.reserve(pluginsPerChunk * ESTIMATED_DERIVED_METADATA_SIZE);
+      writeJsonWithPlugins(
+          writer, chunkJson, [&](JsonWriter& pluginsWriter) {
+            writePlugins(pluginsWriter, chunkStart, chunkEnd);
+          });
+      sendChunk(writer.release());
+
+      chunkJson = nlohmann::json::object();
+      chunkStart = chunkEnd;
+    } while (chunkStart != lastPlugin);
+
+    sendChunk(Query::CHUNKED_RESPONSE_COMPLETE);
+  }
+
+  // Send the derived metadata for the given range of plugins along with the
+  // data that isn't specific to any one plugin, in chunks.
+  template<typename ForwardIterator>
+  void sendChunkedJsonResponse(ForwardIterator firstPlugin,
+                               ForwardIterator lastPlugin,
+                               size_t pluginsPerChunk,
+                               const Query::ChunkCallback& sendChunk) {
+    const auto context = createDerivationContext();
+
+    sendChunkedJsonResponse(
+        generateGameJson(),
+        firstPlugin,
+        lastPlugin,
+        pluginsPerChunk,
+        [&](JsonWriter& writer,
+            ForwardIterator chunkStart,
+            ForwardIterator chunkEnd) {
+          writeDerivedMetadata(writer, chunkStart, chunkEnd, context);
+        },
+        sendChunk);
+  }
+
+  // Generate the game data that isn't specific to any one plugin.
+  nlohmann::json generateGameJson() {
+    return {
         {"folder", game_.FolderName()},
         {"masterlist", getMasterlistInfo()},
         {"generalMessages", getGeneralMessages()},
@@ -130,14 +255,107 @@ protected:
              {"masterlist", game_.GetMasterlistGroups()},
              {"userlist", game_.GetUserGroups()},
          }},
-        {"plugins", nlohmann::json::array()},
     };
+  }
 
+  // Write an array of the derived metadata for each plugin in the given
+  // range, reusing the game's cached serialisations where they're still
+  // valid. Plugins are derived one after another on the query's thread: most
+  // of the work reads the game's metadata and install validity under its
+  // mutex, so splitting it between threads wouldn't make it faster.
+  template<typename ForwardIterator>
+  void writeDerivedMetadata(JsonWriter& writer,
+                            ForwardIterator firstPlugin,
+                            ForwardIterator lastPlugin,
+                            const DerivationContext& context) {
+    // Time the batch rather than each plugin, so that a large load order
+    // doesn't fill the timing recorder with per-plugin events.
+    ScopedTimer timer("MetadataQuery::writeDerivedMetadata");
+
+    writer.startArray();
     for (auto it = firstPlugin; it != lastPlugin; ++it) {
-      json["plugins"].push_back(generateDerivedMetadata(*it));
+      writer.serialisedValue(getDerivedMetadataJson(*it, context));
+    }
+    writer.endArray();
+  }
+
+  // Record the fingerprints of the plugins that metadata is derived for, so
+  // that later queries can tell which plugins have changed.
+  std::unordered_map<std::string, gui::PluginFingerprint> recordFingerprints(
+      const std::vector<std::shared_ptr<const PluginInterface>>& plugins) {
+    std::unordered_map<std::string, gui::PluginFingerprint> fingerprints;
+    for (const auto& plugin : plugins) {
+      fingerprints.emplace(NormalizeFilename(plugin->GetName()),
+                           game_.GetPluginFingerprint(plugin));
     }
+    game_.SetDerivedPluginFingerprints(fingerprints);
 
-    return json.dump();
+    return fingerprints;
+  }
+
+  // Get the given plugins that may have changed since metadata
+  // was last derived for them, going by their previous and current
+  // fingerprints. The plugins are returned in the same order as the input.
+  std::vector<std::shared_ptr<const PluginInterface>> getPluginsToDerive(
+      const std::vector<std::shared_ptr<const PluginInterface>>& plugins,
+      const std::unordered_map<std::string, gui::PluginFingerprint>&
+          previousFingerprints,
+      const std::unordered_map<std::string, gui::PluginFingerprint>&
+          fingerprints) {
+    std::unordered_set<std::string> changedPlugins;
+    for (const auto& fingerprint : fingerprints) {
+      auto it = previousFingerprints.find(fingerprint.first);
+      if (it == previousFingerprints.end() ||
+          it->second != fingerprint.second) {
+        changedPlugins.insert(fingerprint.first);
+      }
+    }
+
+    // If any plugin has been added, removed or changed, the metadata of plugins
+    // that depend on other files may also have changed.
+    bool pluginsChanged = !changedPlugins.empty() ||
+                          previousFingerprints.size() != fingerprints.size();
+
+    std::vector<std::shared_ptr<const PluginInterface>> pluginsToDerive;
+    for (const auto& plugin : plugins) {
+      if (changedPlugins.count(NormalizeFilename(plugin->GetName())) != 0 ||
+          (pluginsChanged && mayDependOnOtherFiles(plugin))) {
+        pluginsToDerive.push_back(plugin);
+      }
+    }
+
+    return pluginsToDerive;
+  }
+
+  // Write an object made up of the given JSON object's fields and a "plugins"
+  // value written by the given function. Keys must be written in order, so the
+  // plugins are written between the fields that sort before and after them.
+  template<typename Function>
+  static void writeJsonWithPlugins(JsonWriter& writer,
+                                   const nlohmann::json& json,
+                                   Function writePlugins) {
+    static constexpr auto PLUGINS_KEY = "plugins";
+
+    writer.startObject();
+
+    bool pluginsWritten = false;
+    for (const auto& item : json.items()) {
+      if (!pluginsWritten && item.key() > PLUGINS_KEY) {
+        writer.key(PLUGINS_KEY);
+        writePlugins(writer);
+        pluginsWritten = true;
+      }
+
+      writer.key(item.key());
+      writer.value(item.value());
+    }
+
+    if (!pluginsWritten) {
+      writer.key(PLUGINS_KEY);
+      writePlugins(writer);
+    }
+
+    writer.endObject();
   }
 
   G& getGame() {
@@ -149,18 +367,43 @@ protected:
   }
 
 private:
-  static std::vector<SimpleMessage> toSimpleMessages(
-      const std::vector<Message>& messages,
-      const std::string& language) {
-    std::vector<SimpleMessage> simpleMessages(messages.size());
-    std::transform(begin(messages),
-                   end(messages),
-                   begin(simpleMessages),
-                   [&](const Message& message) {
-                     return message.ToSimpleMessage(language);
-                   });
-
-    return simpleMessages;
+  // Used to size the response buffer up front to avoid repeated reallocation.
+  static constexpr size_t ESTIMATED_DERIVED_METADATA_SIZE = 512;
+
+  // Masters, requirements, incompatibilities and conditions may all refer to
+  // other files, so changes to those files could change the plugin's derived
+  // metadata.
+  bool mayDependOnOtherFiles(
+      const std::shared_ptr<const PluginInterface>& plugin) {
+    if (!plugin->GetMasters().empty()) {
+      return true;
+    }
+
+    auto masterlistMetadata = game_.GetMasterlistMetadata(plugin->GetName());
+    if (masterlistMetadata.has_value() &&
+        mayDependOnOtherFiles(masterlistMetadata.value())) {
+      return true;
+    }
+
+    auto userMetadata = game_.GetUserMetadata(plugin->GetName());
+    return userMetadata.has_value() &&
+           mayDependOnOtherFiles(userMetadata.value());
+  }
+
+  static bool mayDependOnOtherFiles(const PluginMetadata& metadata) {
+    if (!metadata.GetRequirements().empty() ||
+        !metadata.GetIncompatibilities().empty()) {
+      return true;
+    }
+
+    auto isConditional = [](const auto& element) {
+      return element.IsConditional();
+    };
+
+    auto messages = metadata.GetMessages();
+    auto tags = metadata.GetTags();
+    return std::any_of(messages.begin(), messages.end(), isConditional) ||
+           std::any_of(tags.begin(), tags.end(), isConditional);
   }
 
   std::optional<PluginMetadata> evaluateMetadata(
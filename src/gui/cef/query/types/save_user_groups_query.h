@@ -43,8 +43,15 @@ public:
       logger->trace("Setting user groups.");
     }
 
-    game_.SetUserGroups(groups_);
-    game_.SaveUserMetadata();
+    game_.BeginUserMetadataTransaction();
+    try {
+      game_.SetUserGroups(groups_);
+      game_.SaveUserMetadata();
+    } catch (...) {
+      game_.RollbackUserMetadataTransaction();
+      throw;
+    }
+    game_.CommitUserMetadataTransaction();
 
     nlohmann::json json = {
         {"masterlist", game_.GetMasterlistGroups()},
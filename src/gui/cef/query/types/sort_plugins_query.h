@@ -29,6 +29,7 @@ along with LOOT.  If not, see
 #include <boost/locale.hpp>
 
 #include "gui/cef/query/json.h"
+#include "gui/cef/query/progress_channel.h"
 #include "gui/cef/query/types/metadata_query.h"
 #include "gui/state/game/game.h"
 #include "gui/state/unapplied_change_counter.h"
@@ -39,19 +40,79 @@ class SortPluginsQuery : public MetadataQuery<G> {
 public:
   SortPluginsQuery(G& game, UnappliedChangeCounter& counter,
                    std::string language,
-                   std::function<void(std::string)> sendProgressUpdate) :
+                   ProgressCallback sendProgressUpdate,
+                   bool compact = false) :
       MetadataQuery<G>(game, language),
       counter_(counter),
-      sendProgressUpdate_(sendProgressUpdate) {}
+      sendProgressUpdate_(sendProgressUpdate),
+      compact_(compact) {}
 
   std::string executeLogic() {
+    auto previousFingerprints = this->getGame().GetDerivedPluginFingerprints();
+
+    std::vector<std::string> plugins = sortPlugins();
+
+    std::string json = compact_
+                           ? generateCompactJsonResponse(plugins,
+                                                         previousFingerprints)
+                           : generateJsonResponse(plugins);
+
+    // plugins will be empty if there was a sorting error.
+    if (!plugins.empty())
+      counter_.IncrementUnappliedChangeCounter();
+
+    return json;
+  }
+
+  void executeChunkedLogic(size_t pluginsPerChunk,
+                           const Query::ChunkCallback& sendChunk) override {
+    // Compact responses are usually small, so aren't worth splitting.
+    if (compact_) {
+      Query::executeChunkedLogic(pluginsPerChunk, sendChunk);
+      return;
+    }
+
+    std::vector<std::string> plugins = sortPlugins();
+    this->recordFingerprints(getPlugins(plugins));
+    const auto context = this->createDerivationContext(plugins);
+
+    nlohmann::json json = {{"generalMessages", this->getGeneralMessages()}};
+    auto profile = this->getGame().GetLastSortProfile();
+    if (profile.has_value()) {
+      json["profile"] = profile.value();
+    }
+
+    this->sendChunkedJsonResponse(
+        json,
+        plugins.cbegin(),
+        plugins.cend(),
+        pluginsPerChunk,
+        [&](JsonWriter& writer, auto chunkStart, auto chunkEnd) {
+          writePlugins(writer, chunkStart, chunkEnd, context);
+        },
+        sendChunk);
+
+    // plugins will be empty if there was a sorting error.
+    if (!plugins.empty())
+      counter_.IncrementUnappliedChangeCounter();
+  }
+
+  std::optional<std::string> getErrorMessage() override { return errorMessage; }
+
+private:
+  std::vector<std::string> sortPlugins() {
     auto logger = getLogger();
     if (logger) {
       logger->info("Beginning sorting operation.");
     }
 
+    // Sorting can't be interrupted once started, so check if the query has
+    // been cancelled while it was waiting to run.
+    this->throwIfCancelled();
+
     // Sort plugins into their load order.
-    sendProgressUpdate_(boost::locale::translate("Sorting load order..."));
+    sendProgressUpdate_(
+        ProgressUpdate(boost::locale::translate("Sorting load order...")));
     std::vector<std::string> plugins = this->getGame().SortPlugins();
 
     try {
@@ -66,18 +127,9 @@ public:
       throw;
     }
 
-    std::string json = generateJsonResponse(plugins);
-
-    // plugins will be empty if there was a sorting error.
-    if (!plugins.empty())
-      counter_.IncrementUnappliedChangeCounter();
-
-    return json;
+    return plugins;
   }
 
-  std::optional<std::string> getErrorMessage() override { return errorMessage; }
-
-private:
   void applyUnchangedLoadOrder(const std::vector<std::string>& plugins) {
     if (plugins.empty() ||
         !equal(begin(plugins),
@@ -91,33 +143,129 @@ private:
     this->getGame().SetLoadOrder(plugins);
   }
 
+  std::vector<std::shared_ptr<const PluginInterface>> getPlugins(
+      const std::vector<std::string>& pluginNames) {
+    std::vector<std::shared_ptr<const PluginInterface>> plugins;
+    for (const auto& pluginName : pluginNames) {
+      auto plugin = this->getGame().GetPlugin(pluginName);
+      if (plugin) {
+        plugins.push_back(plugin);
+      }
+    }
+
+    return plugins;
+  }
+
   std::string generateJsonResponse(const std::vector<std::string>& plugins) {
-    nlohmann::json json = {
-        {"generalMessages", this->getGeneralMessages()},
-        {"plugins", nlohmann::json::array()},
-    };
+    this->recordFingerprints(getPlugins(plugins));
 
-    for (const auto& pluginName : plugins) {
-      auto plugin = this->getGame().GetPlugin(pluginName);
+    JsonWriter writer;
+    writer.startObject();
+    writer.key("generalMessages");
+    write_json_array(writer, this->getGeneralMessages());
+    writer.key("plugins");
+    writePlugins(writer,
+                 plugins.cbegin(),
+                 plugins.cend(),
+                 this->createDerivationContext(plugins));
+    writeProfile(writer);
+    writer.endObject();
+
+    return writer.release();
+  }
+
+  // Generate a response that holds the sorted load order's plugin names and
+  // their load order indices, and derived metadata only for the plugins that
+  // may have changed since metadata was last derived for them. The UI already
+  // has the metadata of the other plugins.
+  std::string generateCompactJsonResponse(
+      const std::vector<std::string>& sortedPlugins,
+      const std::unordered_map<std::string, gui::PluginFingerprint>&
+          previousFingerprints) {
+    auto plugins = getPlugins(sortedPlugins);
+    auto fingerprints = this->recordFingerprints(plugins);
+    const auto context = this->createDerivationContext(sortedPlugins);
+
+    nlohmann::json loadOrderJson = nlohmann::json::array();
+    for (const auto& plugin : plugins) {
+      nlohmann::json pluginJson = {{"name", plugin->GetName()}};
+      auto index = context.getActiveLoadOrderIndex(plugin->GetName());
+      if (index.has_value()) {
+        pluginJson["loadOrderIndex"] = index.value();
+      }
+      loadOrderJson.push_back(pluginJson);
+    }
+
+    auto pluginsToDerive =
+        this->getPluginsToDerive(plugins, previousFingerprints, fingerprints);
+
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug("Deriving metadata for {} of {} sorted plugins.",
+                    pluginsToDerive.size(),
+                    plugins.size());
+    }
+
+    JsonWriter writer;
+    writer.startObject();
+    writer.key("generalMessages");
+    write_json_array(writer, this->getGeneralMessages());
+    writer.key("loadOrder");
+    writer.value(loadOrderJson);
+    writer.key("plugins");
+    writePlugins(
+        writer, pluginsToDerive.cbegin(), pluginsToDerive.cend(), context);
+    writeProfile(writer);
+    writer.endObject();
+
+    return writer.release();
+  }
+
+  // Write the derived metadata of the given range of plugins, using their
+  // positions in the sorted load order that the given context was created
+  // for.
+  template<typename ForwardIterator>
+  void writePlugins(JsonWriter& writer,
+                    ForwardIterator firstPlugin,
+                    ForwardIterator lastPlugin,
+                    const DerivationContext& context) {
+    writer.startArray();
+
+    for (auto it = firstPlugin; it != lastPlugin; ++it) {
+      auto plugin = getPlugin(*it);
       if (!plugin) {
         continue;
       }
 
-      auto derivedMetadata = this->generateDerivedMetadata(plugin);
-      auto index =
-          this->getGame().GetActiveLoadOrderIndex(plugin, plugins);
-      if (index.has_value()) {
-        derivedMetadata.setLoadOrderIndex(index.value());
-      }
+      writer.serialisedValue(this->getDerivedMetadataJson(plugin, context));
+    }
+
+    writer.endArray();
+  }
 
-      json["plugins"].push_back(derivedMetadata);
+  // Keys must be written in sorted order, so this must be called after the
+  // plugins are written.
+  void writeProfile(JsonWriter& writer) {
+    auto profile = this->getGame().GetLastSortProfile();
+    if (profile.has_value()) {
+      writer.key("profile");
+      writer.value(nlohmann::json(profile.value()));
     }
+  }
+
+  std::shared_ptr<const PluginInterface> getPlugin(
+      const std::string& pluginName) {
+    return this->getGame().GetPlugin(pluginName);
+  }
 
-    return json.dump();
+  static std::shared_ptr<const PluginInterface> getPlugin(
+      const std::shared_ptr<const PluginInterface>& plugin) {
+    return plugin;
   }
 
   UnappliedChangeCounter& counter_;
-  const std::function<void(std::string)> sendProgressUpdate_;
+  const ProgressCallback sendProgressUpdate_;
+  const bool compact_;
   std::optional<std::string> errorMessage;
 };
 }
@@ -26,6 +26,10 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_UPDATE_MASTERLIST_QUERY
 #define LOOT_GUI_QUERY_UPDATE_MASTERLIST_QUERY
 
+#include <unordered_map>
+#include <unordered_set>
+
+#include "gui/cef/query/json.h"
 #include "gui/cef/query/types/metadata_query.h"
 #include "gui/state/game/game.h"
 
@@ -34,7 +38,8 @@ template<typename G = gui::Game>
 class UpdateMasterlistQuery : public MetadataQuery<G> {
 public:
   UpdateMasterlistQuery(G& game, std::string language) :
-      MetadataQuery<G>(game, language) {}
+      MetadataQuery<G>(game, language),
+      language_(language) {}
 
   std::string executeLogic() {
     auto logger = getLogger();
@@ -42,14 +47,33 @@ public:
       logger->debug("Updating and parsing masterlist.");
     }
 
+    // Only plugins whose masterlist entries change need their metadata
+    // derived again, so record the entries as they were before the update.
+    auto plugins = this->getGame().GetPlugins();
+    auto oldGroups = this->getGame().GetMasterlistGroups();
+    auto oldEntries = getMasterlistEntries(plugins);
+
     if (!updateMasterlist())
       return "null";
 
-    auto plugins = this->getGame().GetPlugins();
-    return this->generateJsonResponse(plugins.cbegin(), plugins.cend());
+    this->throwIfCancelled();
+
+    auto changedPlugins = getChangedPlugins(plugins, oldGroups, oldEntries);
+    if (logger) {
+      logger->debug(
+          "The masterlist update changed the entries for {} of {} plugins.",
+          changedPlugins.size(),
+          plugins.size());
+    }
+
+    // The UI only updates the plugins that are in the response.
+    return this->generateJsonResponse(changedPlugins.cbegin(),
+                                      changedPlugins.cend());
   }
 
 private:
+  typedef std::unordered_map<std::string, std::string> MasterlistEntries;
+
   bool updateMasterlist() {
     try {
       return this->getGame().UpdateMasterlist();
@@ -61,6 +85,57 @@ private:
       throw;
     }
   }
+
+  // Get each plugin's unevaluated masterlist entry, serialised in the same
+  // way as in responses, keyed by the plugin's name. Plugins without an entry
+  // are omitted.
+  MasterlistEntries getMasterlistEntries(
+      const gui::PluginView& plugins) {
+    MasterlistEntries entries;
+    for (const auto& plugin : plugins) {
+      auto metadata = this->getGame().GetMasterlistMetadata(plugin->GetName());
+      if (!metadata.has_value()) {
+        continue;
+      }
+
+      JsonWriter writer;
+      write_json_with_language(writer, metadata.value(), language_);
+      entries.emplace(plugin->GetName(), writer.release());
+    }
+
+    return entries;
+  }
+
+  std::vector<std::shared_ptr<const PluginInterface>> getChangedPlugins(
+      const gui::PluginView& plugins,
+      const std::unordered_set<Group>& oldGroups,
+      const MasterlistEntries& oldEntries) {
+    // Whether a plugin's group exists affects its messages, so if the groups
+    // have changed then all plugins may be affected.
+    if (this->getGame().GetMasterlistGroups() != oldGroups) {
+      return std::vector<std::shared_ptr<const PluginInterface>>(
+          plugins.cbegin(), plugins.cend());
+    }
+
+    auto newEntries = getMasterlistEntries(plugins);
+
+    std::vector<std::shared_ptr<const PluginInterface>> changedPlugins;
+    for (const auto& plugin : plugins) {
+      auto oldEntry = oldEntries.find(plugin->GetName());
+      auto newEntry = newEntries.find(plugin->GetName());
+
+      const bool hadEntry = oldEntry != oldEntries.end();
+      const bool hasEntry = newEntry != newEntries.end();
+      if (hadEntry != hasEntry ||
+          (hasEntry && oldEntry->second != newEntry->second)) {
+        changedPlugins.push_back(plugin);
+      }
+    }
+
+    return changedPlugins;
+  }
+
+  const std::string language_;
 };
 }
 
@@ -0,0 +1,247 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/resource_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace loot {
+namespace {
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t INDEX_ENTRY_SIZE = 20;
+
+uint32_t readUint32(const char* bytes) {
+  uint32_t value = 0;
+  for (int i = 3; i >= 0; --i) {
+    value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+  }
+  return value;
+}
+
+uint64_t readUint64(const char* bytes) {
+  return uint64_t(readUint32(bytes)) | (uint64_t(readUint32(bytes + 4)) << 32);
+}
+
+std::runtime_error invalidArchiveError(const std::string& reason) {
+  return std::runtime_error("Invalid resource archive: " + reason);
+}
+}
+
+ResourceArchive::ResourceArchive(const std::filesystem::path& archivePath) :
+    data_(nullptr), size_(0) {
+#ifdef _WIN32
+  HANDLE file = CreateFile(archivePath.wstring().c_str(),
+                           GENERIC_READ,
+                           FILE_SHARE_READ,
+                           NULL,
+                           OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL,
+                           NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::system_error(GetLastError(),
+                            std::system_category(),
+                            "Failed to open resource archive");
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    auto error = GetLastError();
+    CloseHandle(file);
+    throw std::system_error(
+        error, std::system_category(), "Failed to get resource archive size");
+  }
+  size_ = static_cast<size_t>(fileSize.QuadPart);
+
+  if (size_ < HEADER_SIZE) {
+    CloseHandle(file);
+    throw invalidArchiveError("the file is too small");
+  }
+
+  // The view keeps the mapping open, so the handles can be closed once it
+  // has been created.
+  HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  auto error = GetLastError();
+  CloseHandle(file);
+  if (mapping == NULL) {
+    throw std::system_error(
+        error, std::system_category(), "Failed to map resource archive");
+  }
+
+  data_ = static_cast<const char*>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  error = GetLastError();
+  CloseHandle(mapping);
+  if (data_ == nullptr) {
+    throw std::system_error(
+        error, std::system_category(), "Failed to map resource archive");
+  }
+#else
+  int file = open(archivePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file == -1) {
+    throw std::system_error(errno,
+                            std::generic_category(),
+                            "Failed to open resource archive");
+  }
+
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0) {
+    auto error = errno;
+    close(file);
+    throw std::system_error(error,
+                            std::generic_category(),
+                            "Failed to get resource archive size");
+  }
+  size_ = static_cast<size_t>(fileStatus.st_size);
+
+  if (size_ < HEADER_SIZE) {
+    close(file);
+    throw invalidArchiveError("the file is too small");
+  }
+
+  // The mapping stays valid after the file is closed.
+  auto mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+  auto error = errno;
+  close(file);
+  if (mapping == MAP_FAILED) {
+    throw std::system_error(
+        error, std::generic_category(), "Failed to map resource archive");
+  }
+  data_ = static_cast<const char*>(mapping);
+#endif
+
+  try {
+    ReadIndex();
+  } catch (...) {
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char*>(data_), size_);
+#endif
+    throw;
+  }
+}
+
+ResourceArchive::~ResourceArchive() {
+#ifdef _WIN32
+  UnmapViewOfFile(data_);
+#else
+  munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+std::optional<std::string_view> ResourceArchive::Find(
+    std::string_view path) const {
+  auto it = std::lower_bound(
+      entries_.begin(),
+      entries_.end(),
+      path,
+      [](const Entry& entry, std::string_view path) {
+        return entry.path < path;
+      });
+
+  if (it == entries_.end() || it->path != path) {
+    return std::nullopt;
+  }
+
+  return it->data;
+}
+
+size_t ResourceArchive::Size() const { return entries_.size(); }
+
+void ResourceArchive::ReadIndex() {
+  if (std::string_view(data_, MAGIC.size()) != MAGIC) {
+    throw invalidArchiveError("the file has the wrong magic bytes");
+  }
+
+  auto version = readUint32(data_ + MAGIC.size());
+  if (version != VERSION) {
+    throw invalidArchiveError("unsupported version " +
+                              std::to_string(version));
+  }
+
+  auto entryCount = readUint32(data_ + MAGIC.size() + 4);
+  if (entryCount > (size_ - HEADER_SIZE) / INDEX_ENTRY_SIZE) {
+    throw invalidArchiveError("the index is truncated");
+  }
+
+  entries_.reserve(entryCount);
+  size_t offset = HEADER_SIZE;
+  for (uint32_t i = 0; i < entryCount; ++i) {
+    if (size_ - offset < INDEX_ENTRY_SIZE) {
+      throw invalidArchiveError("the index is truncated");
+    }
+
+    size_t pathLength = readUint32(data_ + offset);
+    auto dataOffset = readUint64(data_ + offset + 4);
+    auto dataSize = readUint64(data_ + offset + 12);
+    offset += INDEX_ENTRY_SIZE;
+
+    if (size_ - offset < pathLength) {
+      throw invalidArchiveError("the index is truncated");
+    }
+    if (dataOffset > size_ || dataSize > size_ - dataOffset) {
+      throw invalidArchiveError("an entry's data is out of bounds");
+    }
+
+    entries_.push_back(
+        Entry{std::string_view(data_ + offset, pathLength),
+              std::string_view(data_ + dataOffset,
+                               static_cast<size_t>(dataSize))});
+    offset += pathLength;
+  }
+
+  auto isSorted = std::is_sorted(
+      entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+        return a.path < b.path;
+      });
+  if (!isSorted) {
+    throw invalidArchiveError("the index is not sorted");
+  }
+}
+}
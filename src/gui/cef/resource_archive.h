@@ -0,0 +1,87 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_CEF_RESOURCE_ARCHIVE
+#define LOOT_GUI_CEF_RESOURCE_ARCHIVE
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace loot {
+// A read-only, memory-mapped archive of UI resource files, as written by
+// scripts/pack_ui.js. All values are little-endian. The archive starts with
+// a header:
+//
+//   char[8]  magic "LOOTPACK"
+//   uint32   format version
+//   uint32   entry count
+//
+// followed by an index of the entries, sorted by path byte by byte:
+//
+//   uint32   path length
+//   uint64   data offset from the start of the archive
+//   uint64   data size
+//   char[]   path, using forward slashes and relative to the resources
+//            directory
+//
+// followed by the file data, each starting at a multiple of DATA_ALIGNMENT
+// bytes.
+class ResourceArchive {
+public:
+  static constexpr std::string_view MAGIC = "LOOTPACK";
+  static constexpr uint32_t VERSION = 1;
+  static constexpr size_t DATA_ALIGNMENT = 16;
+
+  // Throws if the archive can't be mapped into memory or is invalid.
+  explicit ResourceArchive(const std::filesystem::path& archivePath);
+  ~ResourceArchive();
+
+  ResourceArchive(const ResourceArchive&) = delete;
+  ResourceArchive& operator=(const ResourceArchive&) = delete;
+
+  // Get a view of the given file's data, which is valid for the lifetime of
+  // the archive.
+  std::optional<std::string_view> Find(std::string_view path) const;
+
+  size_t Size() const;
+
+private:
+  struct Entry {
+    std::string_view path;
+    std::string_view data;
+  };
+
+  void ReadIndex();
+
+  const char* data_;
+  size_t size_;
+  std::vector<Entry> entries_;
+};
+}
+
+#endif
@@ -44,6 +44,10 @@
 using icu::UnicodeString;
 #endif
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 #include "gui/state/logging.h"
 
 namespace loot {
@@ -134,7 +138,68 @@ std::string RegKeyStringValue(const std::string& rootKey,
 }
 #endif
 
+namespace {
+// Checks eight bytes at a time, as filenames are usually ASCII and checking
+// for that is done for every comparison.
+bool isAscii(std::string_view text) {
+  constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+  size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= text.size(); i += sizeof(std::uint64_t)) {
+    std::uint64_t word;
+    std::memcpy(&word, text.data() + i, sizeof(word));
+    if ((word & HIGH_BITS) != 0) {
+      return false;
+    }
+  }
+
+  return std::all_of(text.begin() + i, text.end(), [](char c) {
+    return static_cast<unsigned char>(c) < 0x80;
+  });
+}
+
+// Convert an ASCII character to the case that NormalizeFilename() gives it.
+char normalizeAsciiChar(char c) {
+#ifdef _WIN32
+  return c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c;
+#else
+  return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+#endif
+}
+
+// FNV-1a, which can be computed one character at a time, so the same hash can
+// be calculated for an ASCII filename without first normalising it.
+constexpr size_t FNV_OFFSET_BASIS =
+    sizeof(size_t) == 8 ? size_t(14695981039346656037ULL) : size_t(2166136261U);
+constexpr size_t FNV_PRIME =
+    sizeof(size_t) == 8 ? size_t(1099511628211ULL) : size_t(16777619U);
+
+size_t hashChar(size_t hash, char c) {
+  return (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+}
+}
+
 int CompareFilenames(const std::string& lhs, const std::string& rhs) {
+  // Both the Windows and ICU comparisons below compare ASCII characters after
+  // converting them to the same case that NormalizeFilename() uses, so do
+  // that in place to avoid converting the strings.
+  if (isAscii(lhs) && isAscii(rhs)) {
+    const auto length = std::min(lhs.size(), rhs.size());
+    for (size_t i = 0; i < length; ++i) {
+      const auto left = static_cast<unsigned char>(normalizeAsciiChar(lhs[i]));
+      const auto right =
+          static_cast<unsigned char>(normalizeAsciiChar(rhs[i]));
+      if (left != right) {
+        return left < right ? -1 : 1;
+      }
+    }
+
+    if (lhs.size() == rhs.size()) {
+      return 0;
+    }
+    return lhs.size() < rhs.size() ? -1 : 1;
+  }
+
 #ifdef _WIN32
   // On Windows, use CompareStringOrdinal as that will perform case conversion
   // using the operating system uppercase table information, which (I think)
@@ -158,4 +223,83 @@ int CompareFilenames(const std::string& lhs, const std::string& rhs) {
   return unicodeLhs.caseCompare(unicodeRhs, U_FOLD_CASE_DEFAULT);
 #endif
 }
+
+std::string NormalizeFilename(const std::string& filename) {
+  if (filename.empty()) {
+    return filename;
+  }
+
+  if (isAscii(filename)) {
+    std::string normalizedFilename(filename);
+    for (auto& c : normalizedFilename) {
+      c = normalizeAsciiChar(c);
+    }
+    return normalizedFilename;
+  }
+
+#ifdef _WIN32
+  // Use the same uppercase table that CompareStringOrdinal uses when ignoring
+  // case, so that results are consistent with CompareFilenames().
+  auto wideString = ToWinWide(filename);
+  auto length = LCMapStringEx(LOCALE_NAME_INVARIANT,
+                              LCMAP_UPPERCASE,
+                              wideString.c_str(),
+                              int(wideString.length()),
+                              NULL,
+                              0,
+                              NULL,
+                              NULL,
+                              0);
+  if (length == 0) {
+    throw std::invalid_argument("The filename to normalise was invalid.");
+  }
+
+  std::wstring normalizedWideString(length, 0);
+  LCMapStringEx(LOCALE_NAME_INVARIANT,
+                LCMAP_UPPERCASE,
+                wideString.c_str(),
+                int(wideString.length()),
+                &normalizedWideString[0],
+                length,
+                NULL,
+                NULL,
+                0);
+
+  return FromWinWide(normalizedWideString);
+#else
+  std::string normalizedFilename;
+  UnicodeString::fromUTF8(filename)
+      .foldCase(U_FOLD_CASE_DEFAULT)
+      .toUTF8String(normalizedFilename);
+  return normalizedFilename;
+#endif
+}
+
+size_t FilenameHash::operator()(std::string_view filename) const {
+  size_t hash = FNV_OFFSET_BASIS;
+  if (isAscii(filename)) {
+    for (auto c : filename) {
+      hash = hashChar(hash, normalizeAsciiChar(c));
+    }
+  } else {
+    for (auto c : NormalizeFilename(std::string(filename))) {
+      hash = hashChar(hash, c);
+    }
+  }
+
+  return hash;
+}
+
+bool FilenameEqual::operator()(std::string_view lhs,
+                               std::string_view rhs) const {
+  if (isAscii(lhs) && isAscii(rhs)) {
+    return lhs.size() == rhs.size() &&
+           std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+             return normalizeAsciiChar(a) == normalizeAsciiChar(b);
+           });
+  }
+
+  return NormalizeFilename(std::string(lhs)) ==
+         NormalizeFilename(std::string(rhs));
+}
 }
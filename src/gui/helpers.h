@@ -26,6 +26,8 @@
 #define LOOT_GUI_HELPERS
 
 #include <filesystem>
+#include <string>
+#include <string_view>
 
 namespace loot {
 void OpenInDefaultApplication(const std::filesystem::path& file);
@@ -43,7 +45,24 @@ std::string RegKeyStringValue(const std::string& rootKey,
 // Compare strings as if they're filenames, respecting filesystem case
 // insensitivity on Windows. Returns -1 if lhs < rhs, 0 if lhs == rhs, and 1 if
 // lhs > rhs. The comparison may give different results on Linux, but is still
-// locale-invariant.
+// locale-invariant. ASCII filenames are compared without being converted, as
+// nearly all plugin filenames are ASCII.
 int CompareFilenames(const std::string& lhs, const std::string& rhs);
+
+// Convert a filename to a case-folded form, so that two filenames that compare
+// equal using CompareFilenames() have the same normalised form. Useful for
+// building hash containers keyed by filename.
+std::string NormalizeFilename(const std::string& filename);
+
+// Hash and equality function objects for hash containers keyed by filename,
+// consistent with CompareFilenames(). ASCII filenames are compared and hashed
+// without being normalised, which avoids allocating.
+struct FilenameHash {
+  size_t operator()(std::string_view filename) const;
+};
+
+struct FilenameEqual {
+  bool operator()(std::string_view lhs, std::string_view rhs) const;
+};
 }
 #endif
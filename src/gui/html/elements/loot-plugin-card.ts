@@ -95,7 +95,9 @@ export default class LootPluginCard extends PolymerElement {
           white-space: nowrap;
         }
         :host-context(body[data-state='editing']) #editMetadata,
-        :host-context(body[data-state='sorting']) #editMetadata {
+        :host-context(body[data-state='sorting']) #editMetadata,
+        :host-context(body[data-state='provisional']) #editMetadata,
+        :host-context(body[data-state='provisional']) #clearMetadata {
           color: #9b9b9b;
           pointer-events: none;
         }
@@ -2,10 +2,27 @@ import { PaperDialogElement } from '@polymer/paper-dialog';
 import { PaperToastElement } from '@polymer/paper-toast';
 import LootMessageDialog from '../elements/loot-message-dialog';
 import { getElementById } from './dom/helpers';
+import { ProgressUpdate } from './interfaces';
 
-export function showProgress(text: string): void {
+/* Show the progress dialog with the given text. If the done and total counts
+are given, the progress bar shows them, otherwise it's indeterminate. */
+export function showProgress(
+  text: string,
+  done?: number,
+  total?: number
+): void {
   const progressDialog = getElementById('progressDialog') as PaperDialogElement;
   progressDialog.getElementsByTagName('p')[0].textContent = text;
+
+  const progressBar = progressDialog.getElementsByTagName('paper-progress')[0];
+  if (done !== undefined && total !== undefined && total > 0) {
+    progressBar.removeAttribute('indeterminate');
+    progressBar.setAttribute('max', total.toString());
+    progressBar.setAttribute('value', done.toString());
+  } else {
+    progressBar.setAttribute('indeterminate', '');
+  }
+
   if (!progressDialog.opened) {
     progressDialog.open();
   } else {
@@ -13,6 +30,10 @@ export function showProgress(text: string): void {
   }
 }
 
+export function showProgressUpdate(update: ProgressUpdate): void {
+  showProgress(update.text, update.done, update.total);
+}
+
 export function closeProgress(): void {
   const progressDialog = getElementById('progressDialog') as PaperDialogElement;
   if (progressDialog.opened) {
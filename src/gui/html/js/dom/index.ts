@@ -224,6 +224,12 @@ export function updateSettingsDialog(settings: LootSettings): void {
   (getElementById(
     'enableLootUpdateCheck'
   ) as PaperToggleButtonElement).checked = settings.enableLootUpdateCheck;
+
+  (getElementById('preloadGames') as PaperToggleButtonElement).checked =
+    settings.preloadGames;
+
+  (getElementById('lowFootprintMode') as PaperToggleButtonElement).checked =
+    settings.lowFootprintMode;
 }
 
 export function fillGameTypesList(gameTypes: string[]): void {
@@ -342,7 +348,8 @@ export function onSidebarClick(evt: MouseEvent): void {
 
       if (
         document.body.getAttribute('data-state') !== 'editing' &&
-        document.body.getAttribute('data-state') !== 'sorting'
+        document.body.getAttribute('data-state') !== 'sorting' &&
+        document.body.getAttribute('data-state') !== 'provisional'
       ) {
         const pluginCard = getElementById(
           getAttribute(evt.target, 'data-id')
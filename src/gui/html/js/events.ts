@@ -21,12 +21,14 @@ import Game from './game';
 import handlePromiseError from './handlePromiseError';
 import { Plugin } from './plugin';
 import {
+  cancelLongRunningQueries,
   changeGame,
   updateMasterlist as updateMasterlistQuery,
   sortPlugins,
   cancelSort,
   clearAllMetadata,
   getGameData,
+  getGameDataDelta,
   closeSettings,
   saveUserGroups,
   editorClosed,
@@ -44,8 +46,10 @@ import {
   copyMetadata
 } from './query';
 import {
+  ExternalChanges,
   FilterStates,
   GameContent,
+  GameData,
   GameSettings,
   LootSettings
 } from './interfaces';
@@ -251,6 +255,28 @@ export function onConflictsFilter(evt: Event): void {
   }
 }
 
+function displayNewGame(result: GameData): void {
+  /* Filters should be re-applied on game change, except the conflicts
+   filter. Don't need to deactivate the others beforehand. Strictly not
+   deactivating the conflicts filter either, just resetting it's value.
+   */
+  window.loot.filters.deactivateConflictsFilter();
+
+  /* Clear the UI of all existing game-specific data. Also
+   clear the card and li variables for each plugin object. */
+  const generalMessages = getElementById('summary').getElementsByTagName(
+    'ul'
+  )[0];
+  while (generalMessages.firstElementChild) {
+    generalMessages.removeChild(generalMessages.firstElementChild);
+  }
+
+  window.loot.game = new Game(result, window.loot.l10n);
+  window.loot.game.initialiseUI(window.loot.filters);
+
+  closeProgress();
+}
+
 export function onChangeGame(evt: Event): void {
   if (!isLootDropdownMenuSelectEvent(evt)) {
     throw new TypeError(`Expected a LootDropdownMenuSelectEvent, got ${evt}`);
@@ -266,29 +292,20 @@ export function onChangeGame(evt: Event): void {
     return;
   }
 
-  /* Send off a CEF query with the folder name of the new game. */
-  changeGame(newGameFolder)
-    .then(result => {
-      /* Filters should be re-applied on game change, except the conflicts
-       filter. Don't need to deactivate the others beforehand. Strictly not
-       deactivating the conflicts filter either, just resetting it's value.
-       */
-      window.loot.filters.deactivateConflictsFilter();
-
-      /* Clear the UI of all existing game-specific data. Also
-       clear the card and li variables for each plugin object. */
-      const generalMessages = getElementById('summary').getElementsByTagName(
-        'ul'
-      )[0];
-      while (generalMessages.firstElementChild) {
-        generalMessages.removeChild(generalMessages.firstElementChild);
-      }
-
-      window.loot.game = new Game(result, window.loot.l10n);
-      window.loot.game.initialiseUI(window.loot.filters);
+  /* Stop any work for the current game that is still in progress, then send
+  off a CEF query with the folder name of the new game. */
+  cancelLongRunningQueries()
+    .then(() => changeGame(newGameFolder))
+    .then(displayNewGame)
+    .catch(handlePromiseError);
+}
 
-      closeProgress();
-    })
+/* Called when LOOT's current game has been changed without going through the
+UI, e.g. by a command line forwarded from another instance of LOOT. */
+export function onGameChangedExternally(): void {
+  cancelLongRunningQueries()
+    .then(() => getGameData())
+    .then(displayNewGame)
     .catch(handlePromiseError);
 }
 
@@ -372,7 +389,7 @@ export function onSortPlugins(): Promise<void> {
 
       currentGame.generalMessages = result.generalMessages;
 
-      if (!result.plugins || result.plugins.length === 0) {
+      if (!result.loadOrder || result.loadOrder.length === 0) {
         const message = result.generalMessages.find(item =>
           item.text.startsWith(
             window.loot.l10n.translate('Cyclic interaction detected')
@@ -390,20 +407,14 @@ export function onSortPlugins(): Promise<void> {
       }
 
       /* Check if sorted load order differs from current load order. */
-      const loadOrderIsUnchanged = result.plugins.every(
+      const loadOrderIsUnchanged = result.loadOrder.every(
         (plugin, index) =>
           currentGame.plugins[index] &&
           plugin.name === currentGame.plugins[index].name
       );
       if (loadOrderIsUnchanged) {
-        result.plugins.forEach(plugin => {
-          const existingPlugin = currentGame.plugins.find(
-            item => item.name === plugin.name
-          );
-          if (existingPlugin) {
-            existingPlugin.update(plugin);
-          }
-        });
+        currentGame.applySortDelta(result);
+        currentGame.applySort();
         /* Send discardUnappliedChanges query. Not doing so prevents LOOT's window
          from closing. */
         discardUnappliedChanges();
@@ -415,7 +426,7 @@ export function onSortPlugins(): Promise<void> {
         );
         return;
       }
-      currentGame.setSortedPlugins(result.plugins);
+      currentGame.applySortDelta(result);
 
       /* Now update the UI for the new order. */
       window.loot.filters.apply(currentGame.plugins);
@@ -568,7 +579,21 @@ export function onCopyLoadOrder(): void {
 }
 
 export function onContentRefresh(): void {
-  /* Send a query for updated load order and plugin header info. */
+  /* Send a query for updated load order and plugin header info. If game data
+  has already been loaded, only get data for plugins that have changed. */
+  if (window.loot.game) {
+    const { game } = window.loot;
+    getGameDataDelta()
+      .then(delta => {
+        game.applyGameDataDelta(delta);
+        game.initialiseUI(window.loot.filters);
+
+        closeProgress();
+      })
+      .catch(handlePromiseError);
+    return;
+  }
+
   getGameData()
     .then(result => {
       window.loot.game = new Game(result, window.loot.l10n);
@@ -579,6 +604,33 @@ export function onContentRefresh(): void {
     .catch(handlePromiseError);
 }
 
+export function onExternalChanges(changes: ExternalChanges): void {
+  if (
+    changes.plugins.length === 0 &&
+    !changes.dataDirectory &&
+    !changes.loadOrder &&
+    !changes.metadataLists
+  ) {
+    return;
+  }
+
+  /* Refreshing while sorting or editing metadata would lose the user's
+  unapplied changes, so let them refresh once they're done. */
+  if (
+    window.loot.game === undefined ||
+    !window.loot.state.isInDefaultState()
+  ) {
+    showNotification(
+      window.loot.l10n.translate(
+        'Files have been changed outside of LOOT. Refresh the content to see the changes.'
+      )
+    );
+    return;
+  }
+
+  onContentRefresh();
+}
+
 export function onOpenReadme(evt: Event): void {
   let relativeFilePath = 'index.html';
   if (evt instanceof CustomEvent && evt.detail.relativeFilePath) {
@@ -671,6 +723,12 @@ export function onCloseSettingsDialog(evt: Event): void {
     enableLootUpdateCheck:
       (getElementById('enableLootUpdateCheck') as PaperCheckboxElement)
         .checked || false,
+    preloadGames:
+      (getElementById('preloadGames') as PaperCheckboxElement).checked ||
+      false,
+    lowFootprintMode:
+      (getElementById('lowFootprintMode') as PaperCheckboxElement).checked ||
+      false,
     filters: window.loot.settings.filters,
     lastVersion: window.loot.settings.lastVersion,
     languages: window.loot.settings.languages
@@ -19,13 +19,15 @@ import Translator from './translator';
 import {
   GameContent,
   GameData,
+  GameDataDelta,
   PluginContent,
   SimpleMessage,
   SourcedGroup,
   Masterlist,
   GameGroups,
   DerivedPluginMetadata,
-  PluginLoadOrderIndex
+  PluginLoadOrderIndex,
+  SortDelta
 } from './interfaces';
 import {
   getTextAsInt,
@@ -386,6 +388,57 @@ export default class Game {
     });
   }
 
+  public appendPlugins(plugins: DerivedPluginMetadata[]): void {
+    this.plugins = this.plugins.concat(plugins.map(p => new Plugin(p)));
+  }
+
+  public applyGameDataDelta(delta: GameDataDelta): void {
+    this.generalMessages = delta.generalMessages;
+    this.masterlist = delta.masterlist;
+    this.bashTags = delta.bashTags;
+    this.setGroups(delta.groups);
+
+    this.plugins = this.mergePlugins(delta.loadOrder, delta.plugins);
+  }
+
+  public applySortDelta(delta: SortDelta): void {
+    this.oldLoadOrder = this.plugins;
+    this.plugins = this.mergePlugins(delta.loadOrder, delta.plugins);
+  }
+
+  /* Get the plugins in the given load order, updated with the given changed
+  plugins' metadata. Plugins that are not in the changed plugins array are
+  unchanged apart from their load order index. */
+  private mergePlugins(
+    loadOrder: PluginLoadOrderIndex[],
+    changedPlugins: DerivedPluginMetadata[]
+  ): Plugin[] {
+    const changedPluginsMap = new Map<string, DerivedPluginMetadata>(
+      changedPlugins.map(plugin => [plugin.name, plugin])
+    );
+    const existingPlugins = new Map<string, Plugin>(
+      this.plugins.map(plugin => [plugin.name, plugin])
+    );
+
+    return loadOrder.reduce((plugins: Plugin[], item) => {
+      const changedPlugin = changedPluginsMap.get(item.name);
+      const existingPlugin = existingPlugins.get(item.name);
+      if (changedPlugin !== undefined) {
+        if (existingPlugin !== undefined) {
+          existingPlugin.update(changedPlugin);
+          plugins.push(existingPlugin);
+        } else {
+          plugins.push(new Plugin(changedPlugin));
+        }
+      } else if (existingPlugin !== undefined) {
+        existingPlugin.loadOrderIndex = item.loadOrderIndex;
+        plugins.push(existingPlugin);
+      }
+
+      return plugins;
+    }, []);
+  }
+
   public applySort(): void {
     this.oldLoadOrder = [];
   }
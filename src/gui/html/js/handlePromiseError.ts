@@ -2,6 +2,12 @@
 import { closeProgress, showMessage } from './dialog';
 
 export default function handlePromiseError(error: Error): void {
+  /* Queries are only cancelled when their results are no longer wanted, so
+  there's no need to tell the user. */
+  if (error.name === 'QueryCancelledError') {
+    return;
+  }
+
   /* Error.stack seems to be Chromium-specific. */
   console.error(error.stack); // eslint-disable-line no-console
   closeProgress();
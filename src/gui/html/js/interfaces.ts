@@ -136,6 +136,8 @@ export interface LootSettings {
   enableDebugLogging: boolean;
   updateMasterlist: boolean;
   enableLootUpdateCheck: boolean;
+  preloadGames: boolean;
+  lowFootprintMode: boolean;
   filters: FilterStates;
 }
 
@@ -168,6 +170,33 @@ export interface GameData {
   bashTags: string[];
 }
 
+export interface GameDataDelta {
+  folder: string;
+  generalMessages: SimpleMessage[];
+  masterlist: Masterlist;
+  groups: GameGroups;
+  loadOrder: PluginLoadOrderIndex[];
+  plugins: DerivedPluginMetadata[];
+  bashTags: string[];
+}
+
+/* A progress update sent by LOOT's C++ code. The done and total counts are
+only given for stages with a known amount of work, and the estimated time
+remaining is only given once some of that work has been done. */
+export interface ProgressUpdate {
+  text: string;
+  done?: number;
+  total?: number;
+  etaSeconds?: number;
+}
+
+export interface ExternalChanges {
+  plugins: string[];
+  dataDirectory: boolean;
+  loadOrder: boolean;
+  metadataLists: boolean;
+}
+
 export interface Masterlist {
   revision: string;
   date: string;
@@ -183,6 +212,27 @@ export interface MainContent {
   plugins: DerivedPluginMetadata[];
 }
 
+export interface SortDelta {
+  generalMessages: SimpleMessage[];
+  loadOrder: PluginLoadOrderIndex[];
+  plugins: DerivedPluginMetadata[];
+  profile?: SortProfile;
+}
+
+export interface SortStage {
+  name: string;
+  microseconds: number;
+}
+
+export interface SortProfile {
+  stages: SortStage[];
+  pluginCount: number;
+  movedPluginCount: number;
+  reusedLastResult: boolean;
+  edgeCounts: { [edgeType: string]: number };
+  overlapCandidatePairs: number;
+}
+
 export interface LootVersion {
   release: string;
   build: string;
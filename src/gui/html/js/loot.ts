@@ -21,7 +21,12 @@
     along with LOOT.  If not, see
     <https://www.gnu.org/licenses/>.
 */
-import { LootSettings, LootVersion } from './interfaces';
+import {
+  ExternalChanges,
+  LootSettings,
+  LootVersion,
+  ProgressUpdate
+} from './interfaces';
 import {
   onSidebarFilterToggle,
   onContentFilter,
@@ -36,6 +41,8 @@ import {
   onCopyContent,
   onCopyLoadOrder,
   onContentRefresh,
+  onExternalChanges,
+  onGameChangedExternally,
   onOpenReadme,
   onOpenLogLocation,
   onSaveUserGroups,
@@ -50,7 +57,7 @@ import {
   onSearchEnd,
   onFolderChange
 } from './events';
-import { closeProgress, showProgress } from './dialog';
+import { closeProgress, showProgress, showProgressUpdate } from './dialog';
 import {
   onOpenGroupsEditor,
   onGroupsEditorOpened,
@@ -82,20 +89,14 @@ import {
   getGameTypes,
   getInstalledGames,
   getSettings,
-  getGameData,
-  getAutoSort,
+  getProvisionalGameDataInChunks,
   getThemes
 } from './query';
 import State from './state';
 import translateStaticText from './translateStaticText';
 import Translator from './translator';
 import updateExists from './updateExists';
-import {
-  getElementById,
-  incrementCounterText,
-  querySelector,
-  getTextAsInt
-} from './dom/helpers';
+import { getElementById, querySelector } from './dom/helpers';
 
 function addEventListeners(): void {
   /* Set up handlers for filters. */
@@ -316,48 +317,6 @@ function checkForLootUpdate(l10n: Translator): Promise<void> {
     });
 }
 
-function appendGeneralErrorMessage(content: string): void {
-  appendGeneralMessages([
-    {
-      type: 'error',
-      content
-    }
-  ]);
-
-  incrementCounterText('totalMessageNo', 1);
-  incrementCounterText('totalErrorNo', 1);
-}
-
-function getErrorCount(): number {
-  return getTextAsInt('totalErrorNo');
-}
-
-function autoSort(l10n: Translator): Promise<void> {
-  return getAutoSort()
-    .then(shouldAutoSort => {
-      if (shouldAutoSort) {
-        if (getErrorCount() === 0) {
-          return onSortPlugins()
-            .then(onApplySort)
-            .then(() => {
-              if (getErrorCount() === 0) {
-                onQuit();
-              }
-            });
-        }
-
-        appendGeneralErrorMessage(
-          l10n.translate(
-            'Auto-sort has been cancelled as there is at least one error message displayed.'
-          )
-        );
-      }
-
-      return Promise.resolve(undefined);
-    })
-    .catch(handlePromiseError);
-}
-
 export default class Loot {
   public filters: Filters;
 
@@ -376,9 +335,18 @@ export default class Loot {
   // Used by C++ callbacks.
   public showProgress: (text: string) => void;
 
+  // Used by C++ callbacks.
+  public onProgress: (update: ProgressUpdate) => void;
+
   // Used by C++ callbacks.
   public onQuit: () => void;
 
+  // Used by C++ callbacks.
+  public onExternalChanges: (changes: ExternalChanges) => void;
+
+  // Used by C++ callbacks.
+  public onGameChangedExternally: () => void;
+
   public constructor() {
     this.l10n = new Translator();
     this.filters = new Filters(this.l10n);
@@ -390,7 +358,10 @@ export default class Loot {
     };
 
     this.showProgress = showProgress;
+    this.onProgress = showProgressUpdate;
     this.onQuit = onQuit;
+    this.onExternalChanges = onExternalChanges;
+    this.onGameChangedExternally = onGameChangedExternally;
   }
 
   private async loadLootData(): Promise<void> {
@@ -406,8 +377,34 @@ export default class Loot {
   }
 
   private async loadGameData(): Promise<void> {
-    const gameData = await getGameData();
-    this.game = new Game(gameData, this.l10n);
+    let game: Game | undefined;
+
+    /* Display the first chunk of plugins while the rest are loading, or the
+    game's last loaded data while its live data is loading. */
+    await getProvisionalGameDataInChunks(
+      (gameData, isProvisional) => {
+        game = new Game(gameData, this.l10n);
+        game.initialiseUI(this.filters);
+        if (isProvisional) {
+          this.state.enterProvisionalState();
+        }
+        closeProgress();
+      },
+      plugins => {
+        if (game !== undefined) {
+          game.appendPlugins(plugins);
+        }
+      },
+      delta => {
+        if (game !== undefined) {
+          game.applyGameDataDelta(delta);
+          game.initialiseUI(this.filters);
+        }
+        this.state.exitProvisionalState();
+      }
+    );
+
+    this.game = game;
   }
 
   private async initialiseGeneralUIElements(): Promise<void> {
@@ -460,8 +457,6 @@ export default class Loot {
         this.game.initialiseUI(this.filters);
 
         closeProgress();
-
-        await autoSort(this.l10n);
       }
 
       if (this.settings.lastVersion !== this.version.release) {
@@ -4,12 +4,13 @@ import {
   DerivedPluginMetadata,
   LootSettings,
   GameData,
-  MainContent,
+  GameDataDelta,
   PluginLoadOrderIndex,
   GameGroups,
   RawGroup,
   PluginMetadata,
-  GameContent
+  GameContent,
+  SortDelta
 } from './interfaces';
 
 interface CefQueryParameters {
@@ -22,6 +23,7 @@ interface CefQueryParameters {
 declare global {
   interface Window {
     cefQuery: (query: CefQueryParameters) => number;
+    cefQueryCancel: (queryId: number) => void;
   }
 }
 
@@ -40,28 +42,153 @@ export interface GetConflictingPluginsResponse {
   plugins: PluginData[];
 }
 
+export interface FormIdOverlap {
+  plugins: [string, string];
+  recordCount: number;
+}
+
+export interface GetConflictMatrixResponse {
+  overlaps: FormIdOverlap[];
+}
+
 export interface CancelSortResponse {
   plugins: PluginLoadOrderIndex[];
   generalMessages: SimpleMessage[];
 }
 
+/* The error code that queries fail with if they are cancelled. */
+const QUERY_CANCELLED_ERROR_CODE = -2;
+
+/* Queries that can take a long time and are worth cancelling if their results
+are no longer wanted. */
+const CANCELLABLE_QUERIES = new Set([
+  'getConflictMatrix',
+  'getConflictingPlugins',
+  'sortPlugins',
+  'updateMasterlist'
+]);
+
+/* The IDs that the UI gave to the cancellable queries in progress. These are
+sent with the queries, as the IDs that cefQuery returns aren't the IDs that
+LOOT sees. */
+const inProgressCancellationIds = new Set<number>();
+let nextCancellationId = 0;
+
+function createQueryError(errorCode: number, errorMessage: string): Error {
+  const error = new Error(errorMessage);
+  if (errorCode === QUERY_CANCELLED_ERROR_CODE) {
+    error.name = 'QueryCancelledError';
+  }
+  return error;
+}
+
 function query(requestName: string, payload?: object): Promise<string> {
   if (!requestName) {
     throw new Error('No request name passed');
   }
 
+  let cancellationId: number | undefined;
+  if (CANCELLABLE_QUERIES.has(requestName)) {
+    cancellationId = nextCancellationId;
+    nextCancellationId += 1;
+  }
+
   return new Promise((resolve, reject): void => {
+    let isSettled = false;
+    const settle = (): void => {
+      isSettled = true;
+      if (cancellationId !== undefined) {
+        inProgressCancellationIds.delete(cancellationId);
+      }
+    };
+
     window.cefQuery({
-      request: JSON.stringify(Object.assign({ name: requestName }, payload)),
+      request: JSON.stringify(
+        Object.assign({ name: requestName, cancellationId }, payload)
+      ),
       persistent: false,
-      onSuccess: resolve,
-      onFailure: (_errorCode, errorMessage) => {
-        reject(new Error(errorMessage));
+      onSuccess: response => {
+        settle();
+        resolve(response);
+      },
+      onFailure: (errorCode, errorMessage) => {
+        settle();
+        reject(createQueryError(errorCode, errorMessage));
+      }
+    });
+
+    if (!isSettled && cancellationId !== undefined) {
+      inProgressCancellationIds.add(cancellationId);
+    }
+  });
+}
+
+/* The last response sent for a persistent query. */
+const CHUNKED_RESPONSE_COMPLETE = '{"complete":true}';
+
+/* Send a persistent query, which will have its response sent as a series of
+JSON strings that are each passed to onChunk in order. The first chunk holds
+all of the response's data, except that responses containing a list of
+plugins only hold the first part of the list, and the rest of the list is sent
+in the following chunks. */
+function chunkedQuery(
+  requestName: string,
+  payload: object | undefined,
+  onChunk: (response: string) => void
+): Promise<void> {
+  if (!requestName) {
+    throw new Error('No request name passed');
+  }
+
+  return new Promise((resolve, reject): void => {
+    let queryId: number | undefined;
+    let isComplete = false;
+
+    queryId = window.cefQuery({
+      request: JSON.stringify(Object.assign({ name: requestName }, payload)),
+      persistent: true,
+      onSuccess: response => {
+        if (response === CHUNKED_RESPONSE_COMPLETE) {
+          isComplete = true;
+          if (queryId !== undefined) {
+            window.cefQueryCancel(queryId);
+          }
+          resolve();
+          return;
+        }
+
+        try {
+          onChunk(response);
+        } catch (error) {
+          reject(error);
+        }
+      },
+      onFailure: (errorCode, errorMessage) => {
+        reject(createQueryError(errorCode, errorMessage));
       }
     });
+
+    /* The response may have completed before cefQuery returned. */
+    if (isComplete) {
+      window.cefQueryCancel(queryId);
+    }
   });
 }
 
+/* Cancel any long-running queries that are still in progress, e.g. because
+their results are no longer relevant. Cancelled queries fail with an error
+that has the name 'QueryCancelledError'. */
+export async function cancelLongRunningQueries(): Promise<void> {
+  const cancellationIds = Array.from(inProgressCancellationIds);
+  inProgressCancellationIds.clear();
+
+  await Promise.all(
+    cancellationIds.map(cancellationId =>
+      query('cancelQuery', { cancellationId })
+    )
+  );
+}
+
 export function getVersion(): Promise<LootVersion> {
   return query('getVersion').then(JSON.parse);
 }
@@ -79,6 +206,10 @@ export function getConflictingPlugins(
   );
 }
 
+export function getConflictMatrix(): Promise<GetConflictMatrixResponse> {
+  return query('getConflictMatrix').then(JSON.parse);
+}
+
 export async function getGameTypes(): Promise<string[]> {
   const json = await query('getGameTypes');
   return JSON.parse(json).gameTypes;
@@ -103,9 +234,52 @@ export function getGameData(): Promise<GameData> {
   return query('getGameData').then(JSON.parse);
 }
 
-export async function getAutoSort(): Promise<boolean> {
-  const json = await query('getAutoSort');
-  return JSON.parse(json).autoSort;
+export function getGameDataInChunks(
+  onFirstChunk: (gameData: GameData) => void,
+  onNextChunk: (plugins: DerivedPluginMetadata[]) => void
+): Promise<void> {
+  let isFirstChunk = true;
+
+  return chunkedQuery('getGameData', undefined, response => {
+    const chunk = JSON.parse(response);
+    if (isFirstChunk) {
+      isFirstChunk = false;
+      onFirstChunk(chunk);
+    } else {
+      onNextChunk(chunk.plugins);
+    }
+  });
+}
+
+/* Like getGameDataInChunks, but if the game's data hasn't been loaded yet,
+the first chunk may hold the data that was last loaded for the game instead,
+marked as provisional. In that case, the live data follows as a delta. */
+export function getProvisionalGameDataInChunks(
+  onFirstChunk: (gameData: GameData, isProvisional: boolean) => void,
+  onNextChunk: (plugins: DerivedPluginMetadata[]) => void,
+  onRevalidated: (delta: GameDataDelta) => void
+): Promise<void> {
+  let isFirstChunk = true;
+
+  return chunkedQuery(
+    'getGameData',
+    { allowProvisional: true },
+    response => {
+      const chunk = JSON.parse(response);
+      if (chunk.revalidated) {
+        onRevalidated(chunk);
+      } else if (isFirstChunk) {
+        isFirstChunk = false;
+        onFirstChunk(chunk, chunk.provisional === true);
+      } else {
+        onNextChunk(chunk.plugins);
+      }
+    }
+  );
+}
+
+export function getGameDataDelta(): Promise<GameDataDelta> {
+  return query('getGameData', { incremental: true }).then(JSON.parse);
 }
 
 export function changeGame(gameFolder: string): Promise<GameData> {
@@ -116,8 +290,8 @@ export function updateMasterlist(): Promise<GameData> {
   return query('updateMasterlist').then(JSON.parse);
 }
 
-export function sortPlugins(): Promise<MainContent> {
-  return query('sortPlugins').then(JSON.parse);
+export function sortPlugins(): Promise<SortDelta> {
+  return query('sortPlugins', { compact: true }).then(JSON.parse);
 }
 
 export function cancelSort(): Promise<CancelSortResponse> {
@@ -174,8 +348,11 @@ export function copyContent(content: GameContent): Promise<void> {
   return query('copyContent', { content }).then(() => {});
 }
 
-export function copyLoadOrder(pluginNames: string[]): Promise<void> {
-  return query('copyLoadOrder', { pluginNames }).then(() => {});
+export function copyLoadOrder(
+  pluginNames: string[],
+  format: 'table' | 'names' | 'pluginsTxt' | 'csv' = 'table'
+): Promise<void> {
+  return query('copyLoadOrder', { pluginNames, format }).then(() => {});
 }
 
 export function copyMetadata(pluginName: string): Promise<void> {
@@ -3,7 +3,8 @@ import { show, enable, setUIState } from './dom';
 enum ApplicationState {
   Default,
   Sorting,
-  Editing
+  Editing,
+  Provisional
 }
 
 export default class State {
@@ -25,6 +26,10 @@ export default class State {
     return this.currentState === ApplicationState.Sorting;
   }
 
+  public isInProvisionalState(): boolean {
+    return this.currentState === ApplicationState.Provisional;
+  }
+
   public enterSortingState(): void {
     if (this.isInSortingState()) {
       return;
@@ -32,6 +37,9 @@ export default class State {
     if (this.isInEditingState()) {
       throw new Error('Cannot enter sorting state from editing state');
     }
+    if (this.isInProvisionalState()) {
+      throw new Error('Cannot enter sorting state from provisional state');
+    }
 
     /* Hide the masterlist update buttons, and display the accept and
     cancel sort buttons. */
@@ -80,6 +88,9 @@ export default class State {
     if (this.isInSortingState()) {
       throw new Error('Cannot enter editing state from sorting state');
     }
+    if (this.isInProvisionalState()) {
+      throw new Error('Cannot enter editing state from provisional state');
+    }
 
     /* Disable the toolbar elements. */
     enable('wipeUserlistButton', false);
@@ -116,4 +127,46 @@ export default class State {
 
     this.currentState = ApplicationState.Default;
   }
+
+  /* The provisional state is for while the UI displays the data that was
+  last loaded for the game, until its live data has loaded. Nothing that
+  depends on or changes the game's live state can be done until then. */
+  public enterProvisionalState(): void {
+    if (this.isInProvisionalState()) {
+      return;
+    }
+    if (!this.isInDefaultState()) {
+      throw new Error('Cannot enter provisional state from a non-default state');
+    }
+
+    enable('wipeUserlistButton', false);
+    enable('groupsEditorButton', false);
+    enable('refreshContentButton', false);
+    enable('settingsButton', false);
+    enable('gameMenu', false);
+    enable('updateMasterlistButton', false);
+    enable('sortButton', false);
+
+    setUIState('provisional');
+
+    this.currentState = ApplicationState.Provisional;
+  }
+
+  public exitProvisionalState(): void {
+    if (!this.isInProvisionalState()) {
+      return;
+    }
+
+    enable('wipeUserlistButton');
+    enable('groupsEditorButton');
+    enable('refreshContentButton');
+    enable('settingsButton');
+    enable('gameMenu');
+    enable('updateMasterlistButton');
+    enable('sortButton');
+
+    setUIState('default');
+
+    this.currentState = ApplicationState.Default;
+  }
 }
@@ -689,6 +689,20 @@ function translateSettingsDialog(l10n: Translator): void {
     'enableLootUpdateCheck'
   ).textContent = l10n.translate('Check for LOOT updates on startup');
 
+  getPreviousElementSiblingById('preloadGames').textContent = l10n.translate(
+    'Preload other games in the background'
+  );
+  getNextElementSiblingById('preloadGames').textContent = l10n.translate(
+    'Makes switching games faster, but uses more memory.'
+  );
+
+  getPreviousElementSiblingById(
+    'lowFootprintMode'
+  ).textContent = l10n.translate('Use less memory for the user interface');
+  getNextElementSiblingById('lowFootprintMode').textContent = l10n.translate(
+    'Disables hardware acceleration and limits caches. Takes effect when LOOT is next started.'
+  );
+
   const gameTable = getElementById('gameTable') as EditableTable;
   gameTable.localise(l10n);
   querySelector(gameTable, 'th:first-child').textContent = l10n.translate(
@@ -23,8 +23,16 @@
     <https://www.gnu.org/licenses/>.
     */
 
+#include <iostream>
+
+#include "gui/batch_sort.h"
 #include "gui/cef/loot_app.h"
+#include "gui/cef/query/command_line_forwarding.h"
+#include "gui/cef/query/query_handler.h"
+#include "gui/cef/query/query_server.h"
+#include "gui/state/logging.h"
 #include "gui/state/loot_paths.h"
+#include "gui/state/startup_report.h"
 
 #ifdef _WIN32
 #ifndef UNICODE
@@ -59,6 +67,147 @@ CefSettings GetCefSettings(std::filesystem::path l10nPath) {
   return cef_settings;
 }
 
+void AttachToParentConsole() {
+#ifdef _WIN32
+  // LOOT is a GUI application, so it needs to attach to the console that
+  // launched it to write to stdout.
+  if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+    freopen("CONOUT$", "w", stdout);
+    freopen("CONOUT$", "w", stderr);
+  }
+#endif
+}
+
+// Sort the load orders given on the command line without initialising CEF,
+// so that many games or mod manager profiles can be sorted cheaply.
+int RunHeadless(const loot::CommandLineOptions &options) {
+  AttachToParentConsole();
+
+  std::vector<loot::SortJob> jobs;
+  try {
+    if (!options.sortJobsPath.empty()) {
+      jobs = loot::ReadSortJobs(std::filesystem::u8path(options.sortJobsPath));
+    } else if (!options.defaultGame.empty()) {
+      loot::SortJob job;
+      job.gameFolder = options.defaultGame;
+      job.gamePath = std::filesystem::u8path(options.gamePath);
+      job.gameLocalPath = std::filesystem::u8path(options.gameLocalPath);
+      jobs.push_back(job);
+    } else {
+      std::cerr << "Error: --headless requires --game or --sort-jobs."
+                << std::endl;
+      return 1;
+    }
+  } catch (std::exception &e) {
+    std::cerr << "Error: Could not read sort jobs: " << e.what() << std::endl;
+    return 1;
+  }
+
+  loot::LootState lootState("", options.lootDataPath);
+  lootState.initHeadless();
+
+  int exitCode = loot::RunSortJobs(
+      lootState, jobs, options.applySortedLoadOrder, std::cout);
+
+  loot::shutdownLogging();
+
+  return exitCode;
+}
+
+// Replay recorded queries against the game given on the command line without
+// initialising CEF, and write each type of query's latencies to stdout.
+int RunReplay(const loot::CommandLineOptions &options) {
+  AttachToParentConsole();
+
+  std::vector<loot::RecordedQuery> queries;
+  try {
+    queries = loot::ReadQueryRecording(
+        std::filesystem::u8path(options.replayQueriesPath));
+  } catch (std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  loot::LootState lootState("", options.lootDataPath);
+  lootState.init(options.defaultGame, false);
+  if (!lootState.getInitErrors().empty()) {
+    for (const auto &error : lootState.getInitErrors()) {
+      std::cerr << error << std::endl;
+    }
+    return 1;
+  }
+
+  loot::QueryHandler handler(lootState);
+  const auto latencies = handler.replayQueries(queries);
+  std::cout << loot::ToJson(latencies).dump(2) << std::endl;
+
+  lootState.flushSave();
+  loot::shutdownLogging();
+
+  return 0;
+}
+
+// Serve queries from other processes on the endpoint given on the command
+// line without initialising CEF, keeping the game given by --game loaded
+// between queries.
+int RunServer(const loot::CommandLineOptions &options) {
+  AttachToParentConsole();
+
+  loot::LootState lootState("", options.lootDataPath);
+  lootState.init(options.defaultGame, false);
+  if (!lootState.getInitErrors().empty()) {
+    for (const auto &error : lootState.getInitErrors()) {
+      std::cerr << error << std::endl;
+    }
+    return 1;
+  }
+
+  {
+    loot::QueryHandler handler(lootState);
+    try {
+      loot::QueryServer server(
+          options.serveEndpoint, [&handler](nlohmann::json request) {
+            return handler.runQuery(std::move(request));
+          });
+      std::cout << "Serving queries on " << options.serveEndpoint
+                << std::endl;
+      server.Run();
+    } catch (std::exception &e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  lootState.flushSave();
+  loot::shutdownLogging();
+
+  return 0;
+}
+
+#ifdef _WIN32
+// Pass the --game and --auto-sort options to the instance of LOOT that is
+// already running, so that it can use the game data that it has already
+// loaded, and write its result to stdout.
+int ForwardCommandLine(const loot::CommandLineOptions &options) {
+  AttachToParentConsole();
+
+  try {
+    const auto result =
+        loot::ForwardCommandLine(loot::GetInstanceEndpointName(),
+                                 options.defaultGame,
+                                 options.autoSort);
+    std::cout << result.dump(2) << std::endl;
+
+    return result.value("sorted", true) ? 0 : 1;
+  } catch (std::exception &e) {
+    std::cerr << "Error: Could not pass the command line to the running "
+                 "instance of LOOT: "
+              << e.what() << std::endl;
+    return 1;
+  }
+}
+#endif
+
 #ifndef _WIN32
 namespace {
 int XErrorHandlerImpl(Display *display, XErrorEvent *event) {
@@ -93,6 +242,18 @@ int APIENTRY wWinMain(HINSTANCE hInstance,
   CefMainArgs main_args(hInstance);
   const auto cliOptions = loot::CommandLineOptions();
 
+  if (cliOptions.headless) {
+    return RunHeadless(cliOptions);
+  }
+
+  if (!cliOptions.replayQueriesPath.empty()) {
+    return RunReplay(cliOptions);
+  }
+
+  if (!cliOptions.serveEndpoint.empty()) {
+    return RunServer(cliOptions);
+  }
+
   // Create the process reference.
   CefRefPtr<loot::LootApp> app(new loot::LootApp(cliOptions));
 
@@ -102,16 +263,23 @@ int APIENTRY wWinMain(HINSTANCE hInstance,
     // The sub-process has completed so return here.
     return exit_code;
   }
+  loot::RecordStartupMilestone("CefExecuteProcess");
 
   // Check if LOOT is already running
   //---------------------------------
 
   HANDLE hMutex = ::OpenMutex(MUTEX_ALL_ACCESS, FALSE, L"LOOT.Shell.Instance");
   if (hMutex != NULL) {
-    // An instance of LOOT is already running, so focus its window then quit.
+    // An instance of LOOT is already running, so pass it this instance's
+    // command line, focus its window, then quit.
+    int exitCode = 0;
+    if (!cliOptions.defaultGame.empty() || cliOptions.autoSort) {
+      exitCode = ForwardCommandLine(cliOptions);
+    }
+
     HWND hWnd = ::FindWindow(NULL, L"LOOT");
     ::SetForegroundWindow(hWnd);
-    return 0;
+    return exitCode;
   }
   else {
     // Create the mutex so that future instances will not run.
@@ -131,9 +299,20 @@ int APIENTRY wWinMain(HINSTANCE hInstance,
   // called.
   CefRunMessageLoop();
 
+  // Background threads may be waiting for the CEF UI thread, so they're
+  // joined here rather than on it.
+  app->joinBackgroundThreads();
+
   // Shut down CEF.
   CefShutdown();
 
+  // Settings are saved in the background, so make sure that they're written
+  // before exiting.
+  app->flushSettings();
+
+  // Make sure that any queued log messages get written.
+  loot::shutdownLogging();
+
   // Release the program instance mutex.
   if (hMutex != NULL) {
     ReleaseMutex(hMutex);
@@ -152,6 +331,18 @@ int main(int argc, char *argv[]) {
   CefMainArgs main_args(argc, argv);
   const auto cliOptions = loot::CommandLineOptions(argc, argv);
 
+  if (cliOptions.headless) {
+    return RunHeadless(cliOptions);
+  }
+
+  if (!cliOptions.replayQueriesPath.empty()) {
+    return RunReplay(cliOptions);
+  }
+
+  if (!cliOptions.serveEndpoint.empty()) {
+    return RunServer(cliOptions);
+  }
+
   // Create the process reference.
   CefRefPtr<loot::LootApp> app(new loot::LootApp(cliOptions));
 
@@ -161,6 +352,7 @@ int main(int argc, char *argv[]) {
     // The sub-process has completed so return here.
     return exit_code;
   }
+  loot::RecordStartupMilestone("CefExecuteProcess");
 
   // Initialise CEF settings.
   CefSettings cef_settings = GetCefSettings(app.get()->getL10nPath());
@@ -177,9 +369,20 @@ int main(int argc, char *argv[]) {
   // called.
   CefRunMessageLoop();
 
+  // Background threads may be waiting for the CEF UI thread, so they're
+  // joined here rather than on it.
+  app->joinBackgroundThreads();
+
   // Shut down CEF.
   CefShutdown();
 
+  // Settings are saved in the background, so make sure that they're written
+  // before exiting.
+  app->flushSettings();
+
+  // Make sure that any queued log messages get written.
+  loot::shutdownLogging();
+
   return 0;
 }
 #endif
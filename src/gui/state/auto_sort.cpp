@@ -0,0 +1,143 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/auto_sort.h"
+
+#include <algorithm>
+
+#include <boost/locale.hpp>
+
+#include "gui/state/game/helpers.h"
+#include "gui/state/logging.h"
+#include "gui/state/startup_report.h"
+#include "gui/state/timing.h"
+
+using boost::locale::translate;
+
+namespace loot {
+static bool isError(const Message& message) {
+  return message.GetType() == MessageType::error;
+}
+
+bool HasErrorMessages(gui::Game& game) {
+  ScopedTimer timer("HasErrorMessages");
+
+  auto messages = game.GetMessages();
+  if (std::any_of(messages.cbegin(), messages.cend(), isError)) {
+    return true;
+  }
+
+  for (const auto& plugin : game.GetPlugins()) {
+    std::optional<PluginMetadata> metadata;
+    try {
+      metadata = game.GetMasterlistMetadata(plugin->GetName(), true);
+      auto userMetadata = game.GetUserMetadata(plugin->GetName(), true);
+      if (!metadata.has_value()) {
+        metadata = userMetadata;
+      } else if (userMetadata.has_value()) {
+        metadata.value().MergeMetadata(userMetadata.value());
+      }
+    } catch (std::exception&) {
+      // The UI displays an error for metadata that can't be evaluated.
+      return true;
+    }
+
+    if (!metadata.has_value()) {
+      continue;
+    }
+
+    messages = metadata.value().GetMessages();
+    if (std::any_of(messages.cbegin(), messages.cend(), isError)) {
+      return true;
+    }
+
+    messages = game.CheckInstallValidity(plugin, metadata.value());
+    if (std::any_of(messages.cbegin(), messages.cend(), isError)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool SortAndApplyLoadOrder(gui::Game& game) {
+  const auto sortedLoadOrder = game.SortPlugins();
+
+  // An empty load order means that sorting failed, and the game's messages
+  // say why.
+  if (sortedLoadOrder.empty()) {
+    return false;
+  }
+
+  if (sortedLoadOrder != game.GetLoadOrder()) {
+    game.SetLoadOrder(sortedLoadOrder);
+  }
+
+  const auto messages = game.GetMessages();
+  return std::none_of(messages.cbegin(), messages.cend(), isError);
+}
+
+bool AutoSort(gui::Game& game, bool updateMasterlist) {
+  auto logger = getLogger();
+
+  try {
+    if (logger) {
+      logger->info("Auto-sorting the load order of {}.", game.Name());
+    }
+
+    game.LoadAllInstalledPluginsAndMetadata(true, updateMasterlist);
+    RecordStartupMilestone("Auto-sort load");
+
+    if (updateMasterlist) {
+      // This returns the result of the update made while loading, or
+      // retries the update if it failed, so that the failure is reported.
+      game.UpdateMasterlist();
+    }
+
+    if (HasErrorMessages(game)) {
+      if (logger) {
+        logger->warn(
+            "Auto-sort has been cancelled as there is at least one error "
+            "message.");
+      }
+      game.AppendMessage(PlainTextMessage(
+          MessageType::error,
+          translate("Auto-sort has been cancelled as there is at least one "
+                    "error message displayed.")));
+      return false;
+    }
+
+    const auto sorted = SortAndApplyLoadOrder(game);
+    RecordStartupMilestone("Auto-sort sort");
+
+    return sorted;
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error("Auto-sort failed: {}", e.what());
+    }
+    return false;
+  }
+}
+}
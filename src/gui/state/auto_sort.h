@@ -0,0 +1,49 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_AUTO_SORT
+#define LOOT_GUI_STATE_AUTO_SORT
+
+#include "gui/state/game/game.h"
+
+namespace loot {
+// Check if the UI would display any error messages for the game, without
+// deriving its plugins' metadata for display.
+bool HasErrorMessages(gui::Game& game);
+
+// Sort the game's loaded plugins and apply the sorted load order. Returns
+// false if sorting fails or leaves the game with any error messages, though
+// the sorted load order is still applied in the latter case.
+bool SortAndApplyLoadOrder(gui::Game& game);
+
+// Load the game's plugin headers and metadata, updating the masterlist first
+// if requested, then sort and apply the sorted load order. Returns false if
+// loading or sorting fails, or if the UI would display any error messages.
+// The load order isn't changed if there are any errors before sorting, and
+// an error message is added to say that auto-sort was cancelled.
+bool AutoSort(gui::Game& game, bool updateMasterlist);
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_BINARY_IO
+#define LOOT_GUI_STATE_BINARY_IO
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace loot {
+// Helpers for the binary cache files that LOOT keeps between sessions. Values
+// are written in the host's byte order, as the files are only read by the
+// LOOT install that wrote them.
+
+template<typename T>
+void WriteBinary(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+T ReadBinary(std::istream& in) {
+  T value;
+  in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  if (!in) {
+    throw std::runtime_error("Unexpected end of file");
+  }
+  return value;
+}
+
+// The string is prefixed by its length as a Size.
+template<typename Size>
+void WriteBinaryString(std::ostream& out, const std::string& value) {
+  WriteBinary<Size>(out, static_cast<Size>(value.size()));
+  out.write(value.data(), value.size());
+}
+
+template<typename Size>
+std::string ReadBinaryString(std::istream& in) {
+  std::string value(ReadBinary<Size>(in), '\0');
+  in.read(&value[0], value.size());
+  if (!in) {
+    throw std::runtime_error("Unexpected end of file");
+  }
+  return value;
+}
+
+// Files start with a signature that identifies what they hold, followed by
+// the version of their format.
+template<size_t N>
+void WriteBinaryHeader(std::ostream& out,
+                       const char (&magic)[N],
+                       uint32_t version) {
+  out.write(magic, N);
+  WriteBinary<uint32_t>(out, version);
+}
+
+// Throws if the file doesn't start with the given signature, and otherwise
+// returns the file's format version.
+template<size_t N>
+uint32_t ReadBinaryHeader(std::istream& in, const char (&magic)[N]) {
+  char fileMagic[N];
+  in.read(fileMagic, N);
+  if (!in || !std::equal(std::begin(fileMagic), std::end(fileMagic), magic)) {
+    throw std::runtime_error("Invalid file signature");
+  }
+
+  return ReadBinary<uint32_t>(in);
+}
+
+// Write to a temporary file that then replaces the given file, so that an
+// interrupted write doesn't leave a truncated file behind.
+inline void WriteBinaryFile(
+    const std::filesystem::path& path,
+    const std::function<void(std::ostream& out)>& writeContents) {
+  auto tempPath = path;
+  tempPath += ".tmp";
+
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    out.exceptions(std::ios::failbit | std::ios::badbit);
+    writeContents(out);
+  }
+
+  std::filesystem::rename(tempPath, path);
+}
+}
+
+#endif
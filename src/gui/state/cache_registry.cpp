@@ -0,0 +1,217 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/cache_registry.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace loot {
+CacheRegistry::Entry::Entry(std::string name,
+                            SizeCallback size,
+                            EvictCallback evict) :
+    name(std::move(name)),
+    size(std::move(size)),
+    evict(std::move(evict)),
+    isRegistered(true) {}
+
+CacheRegistry::Registration::Registration(std::shared_ptr<Entry> entry) :
+    entry_(std::move(entry)) {}
+
+CacheRegistry::Registration::~Registration() { Reset(); }
+
+CacheRegistry::Registration& CacheRegistry::Registration::operator=(
+    Registration&& other) {
+  if (&other != this) {
+    Reset();
+    entry_ = std::move(other.entry_);
+  }
+
+  return *this;
+}
+
+void CacheRegistry::Registration::Reset() {
+  if (!entry_) {
+    return;
+  }
+
+  // Wait for any running callback to finish.
+  std::lock_guard<std::mutex> guard(entry_->mutex);
+  entry_->isRegistered = false;
+  entry_.reset();
+}
+
+CacheRegistry::CacheRegistry() : budgetBytes_(0) {}
+
+CacheRegistry::Registration CacheRegistry::Register(const std::string& name,
+                                                    SizeCallback size,
+                                                    EvictCallback evict) {
+  auto entry =
+      std::make_shared<Entry>(name, std::move(size), std::move(evict));
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.erase(std::remove_if(entries_.begin(),
+                                entries_.end(),
+                                [](const auto& entry) {
+                                  return entry.expired();
+                                }),
+                 entries_.end());
+  entries_.push_back(entry);
+  stats_[name].name = name;
+
+  return Registration(entry);
+}
+
+void CacheRegistry::SetBudget(std::uintmax_t budgetBytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  budgetBytes_ = budgetBytes;
+}
+
+std::uintmax_t CacheRegistry::GetBudget() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return budgetBytes_;
+}
+
+std::uintmax_t CacheRegistry::EnforceBudget() {
+  const auto budgetBytes = GetBudget();
+  if (budgetBytes == 0) {
+    return 0;
+  }
+
+  auto entries = GetSizedEntries();
+  std::uintmax_t totalBytes = 0;
+  for (const auto& entry : entries) {
+    totalBytes += entry.estimatedBytes;
+  }
+
+  std::sort(entries.begin(),
+            entries.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.estimatedBytes > rhs.estimatedBytes;
+            });
+
+  std::uintmax_t freedBytes = 0;
+  for (const auto& entry : entries) {
+    if (totalBytes <= budgetBytes) {
+      break;
+    }
+
+    const auto excessBytes = totalBytes - budgetBytes;
+    const auto targetBytes = entry.estimatedBytes > excessBytes
+                                 ? entry.estimatedBytes - excessBytes
+                                 : 0;
+    const auto entryFreedBytes = Evict(*entry.entry, targetBytes);
+
+    totalBytes -= std::min(totalBytes, entryFreedBytes);
+    freedBytes += entryFreedBytes;
+  }
+
+  return freedBytes;
+}
+
+std::uintmax_t CacheRegistry::EvictAll() {
+  std::uintmax_t freedBytes = 0;
+  for (const auto& entry : GetSizedEntries()) {
+    if (entry.estimatedBytes > 0) {
+      freedBytes += Evict(*entry.entry, 0);
+    }
+  }
+
+  return freedBytes;
+}
+
+std::vector<CacheStats> CacheRegistry::GetStats() const {
+  std::map<std::string, CacheStats> stats;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats = stats_;
+  }
+
+  for (const auto& entry : GetSizedEntries()) {
+    stats[entry.entry->name].estimatedBytes += entry.estimatedBytes;
+  }
+
+  std::vector<CacheStats> statsVector;
+  statsVector.reserve(stats.size());
+  for (auto& entry : stats) {
+    statsVector.push_back(std::move(entry.second));
+  }
+
+  return statsVector;
+}
+
+std::vector<CacheRegistry::SizedEntry> CacheRegistry::GetSizedEntries()
+    const {
+  std::vector<std::shared_ptr<Entry>> entries;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const auto& weakEntry : entries_) {
+      auto entry = weakEntry.lock();
+      if (entry) {
+        entries.push_back(entry);
+      }
+    }
+  }
+
+  std::vector<SizedEntry> sizedEntries;
+  sizedEntries.reserve(entries.size());
+  for (auto& entry : entries) {
+    std::lock_guard<std::mutex> guard(entry->mutex);
+    if (entry->isRegistered) {
+      const auto estimatedBytes = entry->size();
+      sizedEntries.push_back({std::move(entry), estimatedBytes});
+    }
+  }
+
+  return sizedEntries;
+}
+
+std::uintmax_t CacheRegistry::Evict(Entry& entry, std::uintmax_t targetBytes) {
+  std::uintmax_t freedBytes = 0;
+  {
+    std::lock_guard<std::mutex> guard(entry.mutex);
+    if (!entry.isRegistered) {
+      return 0;
+    }
+    freedBytes = entry.evict(targetBytes);
+  }
+
+  if (freedBytes == 0) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& stats = stats_[entry.name];
+  stats.evictionCount += 1;
+  stats.evictedBytes += freedBytes;
+
+  return freedBytes;
+}
+
+CacheRegistry& GetCacheRegistry() {
+  static CacheRegistry registry;
+  return registry;
+}
+}
@@ -0,0 +1,137 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_CACHE_REGISTRY
+#define LOOT_GUI_STATE_CACHE_REGISTRY
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace loot {
+struct CacheStats {
+  std::string name;
+  std::uintmax_t estimatedBytes = 0;
+  size_t evictionCount = 0;
+  std::uintmax_t evictedBytes = 0;
+};
+
+/**
+ * @brief Keeps the estimated total size of registered caches within a budget.
+ * @details Each cache registers a callback that estimates its size and a
+ *          callback that evicts entries from it until it's no larger than a
+ *          target size. Callbacks are never called while the registry's own
+ *          lock is held, so they may take the cache's locks, but only one
+ *          callback runs at a time for each registration, and none run once
+ *          its Registration has been destroyed.
+ */
+class CacheRegistry {
+  struct Entry;
+
+public:
+  typedef std::function<std::uintmax_t()> SizeCallback;
+  // Evict entries until the cache's estimated size is at most the given
+  // number of bytes, returning the number of bytes freed.
+  typedef std::function<std::uintmax_t(std::uintmax_t)> EvictCallback;
+
+  /**
+   * @brief Unregisters its cache when destroyed.
+   */
+  class Registration {
+  public:
+    Registration() = default;
+    explicit Registration(std::shared_ptr<Entry> entry);
+    ~Registration();
+
+    Registration(Registration&& other) = default;
+    Registration& operator=(Registration&& other);
+
+    Registration(const Registration&) = delete;
+    Registration& operator=(const Registration&) = delete;
+
+  private:
+    void Reset();
+
+    std::shared_ptr<Entry> entry_;
+  };
+
+  CacheRegistry();
+
+  // Caches that are registered with the same name share their stats.
+  Registration Register(const std::string& name,
+                        SizeCallback size,
+                        EvictCallback evict);
+
+  // A budget of 0 means that caches are never evicted from to fit it.
+  void SetBudget(std::uintmax_t budgetBytes);
+  std::uintmax_t GetBudget() const;
+
+  // Evict from the largest caches first until their estimated total size
+  // fits in the budget. Returns the number of bytes freed.
+  std::uintmax_t EnforceBudget();
+
+  // Evict everything from every cache, e.g. because the system is low on
+  // memory. Returns the number of bytes freed.
+  std::uintmax_t EvictAll();
+
+  // Get each cache name's current estimated size and eviction totals, sorted
+  // by name. Evictions that free nothing aren't counted.
+  std::vector<CacheStats> GetStats() const;
+
+private:
+  struct Entry {
+    Entry(std::string name, SizeCallback size, EvictCallback evict);
+
+    const std::string name;
+    const SizeCallback size;
+    const EvictCallback evict;
+
+    // Held while a callback runs, so that unregistering waits for it.
+    std::mutex mutex;
+    bool isRegistered;
+  };
+
+  struct SizedEntry {
+    std::shared_ptr<Entry> entry;
+    std::uintmax_t estimatedBytes;
+  };
+
+  std::vector<SizedEntry> GetSizedEntries() const;
+  std::uintmax_t Evict(Entry& entry, std::uintmax_t targetBytes);
+
+  mutable std::mutex mutex_;
+  std::uintmax_t budgetBytes_;
+  std::vector<std::weak_ptr<Entry>> entries_;
+  std::map<std::string, CacheStats> stats_;
+};
+
+CacheRegistry& GetCacheRegistry();
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/debounced_task.h"
+
+#include "gui/state/logging.h"
+
+namespace loot {
+DebouncedTask::DebouncedTask(std::chrono::milliseconds debounceInterval,
+                             std::function<void()> task) :
+    debounceInterval_(debounceInterval),
+    task_(task),
+    isScheduled_(false),
+    isStopping_(false),
+    thread_(&DebouncedTask::Run, this) {}
+
+DebouncedTask::~DebouncedTask() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    isStopping_ = true;
+  }
+  scheduled_.notify_all();
+  thread_.join();
+
+  Flush();
+}
+
+void DebouncedTask::Schedule() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    isScheduled_ = true;
+    deadline_ = std::chrono::steady_clock::now() + debounceInterval_;
+  }
+  scheduled_.notify_all();
+}
+
+void DebouncedTask::Flush() {
+  std::lock_guard<std::mutex> runGuard(runMutex_);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!isScheduled_) {
+      return;
+    }
+    isScheduled_ = false;
+  }
+
+  RunTask();
+}
+
+void DebouncedTask::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!isStopping_) {
+    if (!isScheduled_) {
+      scheduled_.wait(lock);
+      continue;
+    }
+
+    if (std::chrono::steady_clock::now() < deadline_) {
+      // The deadline may be pushed back while waiting.
+      scheduled_.wait_until(lock, deadline_);
+      continue;
+    }
+
+    // Take the run lock before unscheduling the task so that a concurrent
+    // Flush() waits for this run.
+    lock.unlock();
+    std::lock_guard<std::mutex> runGuard(runMutex_);
+    lock.lock();
+
+    if (!isScheduled_ || std::chrono::steady_clock::now() < deadline_) {
+      continue;
+    }
+    isScheduled_ = false;
+
+    lock.unlock();
+    RunTask();
+    lock.lock();
+  }
+}
+
+void DebouncedTask::RunTask() {
+  try {
+    task_();
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("A debounced task failed. Details: {}", e.what());
+    }
+  }
+}
+}
@@ -0,0 +1,79 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_DEBOUNCED_TASK
+#define LOOT_GUI_STATE_DEBOUNCED_TASK
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace loot {
+/**
+ * @brief Runs a task on a background thread once it has stopped being
+ *        scheduled for the debounce interval.
+ * @details However many times the task is scheduled within the interval, it
+ *          only runs once. Any exception the task throws is logged.
+ */
+class DebouncedTask {
+public:
+  DebouncedTask(std::chrono::milliseconds debounceInterval,
+                std::function<void()> task);
+
+  // Runs the task if it is scheduled, then stops the background thread.
+  ~DebouncedTask();
+
+  DebouncedTask(const DebouncedTask&) = delete;
+  DebouncedTask& operator=(const DebouncedTask&) = delete;
+
+  void Schedule();
+
+  // If the task is scheduled, run it now on the calling thread. Otherwise
+  // wait for any run that is in progress to finish.
+  void Flush();
+
+private:
+  void Run();
+  void RunTask();
+
+  const std::chrono::milliseconds debounceInterval_;
+  const std::function<void()> task_;
+
+  // Held while the task runs, so that Flush() can wait for a run in progress.
+  std::mutex runMutex_;
+
+  std::mutex mutex_;
+  std::condition_variable scheduled_;
+  bool isScheduled_;
+  bool isStopping_;
+  std::chrono::steady_clock::time_point deadline_;
+
+  std::thread thread_;
+};
+}
+
+#endif
@@ -0,0 +1,400 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/file_watcher.h"
+
+#include <set>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#endif
+
+#include "gui/state/logging.h"
+
+namespace loot {
+namespace {
+void notify(const FileWatcher::Callback& callback,
+            std::set<std::filesystem::path>& changedPaths) {
+  if (changedPaths.empty()) {
+    return;
+  }
+
+  std::vector<std::filesystem::path> paths(changedPaths.begin(),
+                                           changedPaths.end());
+  changedPaths.clear();
+
+  try {
+    callback(paths);
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Failed to handle file changes: {}", e.what());
+    }
+  }
+}
+
+#ifdef _WIN32
+// Large enough to hold many changes, but within the 64 KB limit for
+// watching directories over a network.
+static constexpr DWORD CHANGES_BUFFER_SIZE = 32 * 1024;
+
+struct WatchedDirectory {
+  std::filesystem::path path;
+  HANDLE handle = INVALID_HANDLE_VALUE;
+  OVERLAPPED overlapped{};
+  // ReadDirectoryChangesW requires a DWORD-aligned buffer.
+  std::vector<DWORD> buffer =
+      std::vector<DWORD>(CHANGES_BUFFER_SIZE / sizeof(DWORD));
+  bool isReading = false;
+};
+
+bool readChanges(WatchedDirectory& directory) {
+  static constexpr DWORD NOTIFY_FILTER =
+      FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+      FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+  directory.isReading = ReadDirectoryChangesW(directory.handle,
+                                              directory.buffer.data(),
+                                              CHANGES_BUFFER_SIZE,
+                                              FALSE,
+                                              NOTIFY_FILTER,
+                                              nullptr,
+                                              &directory.overlapped,
+                                              nullptr) != 0;
+  return directory.isReading;
+}
+
+bool openDirectory(WatchedDirectory& directory) {
+  directory.handle =
+      CreateFile(directory.path.wstring().c_str(),
+                 FILE_LIST_DIRECTORY,
+                 FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                 nullptr,
+                 OPEN_EXISTING,
+                 FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                 nullptr);
+
+  return directory.handle != INVALID_HANDLE_VALUE && readChanges(directory);
+}
+
+void closeDirectory(WatchedDirectory& directory) {
+  if (directory.isReading) {
+    // Wait for the cancelled read to finish so that it doesn't write to the
+    // buffer after it's freed.
+    CancelIoEx(directory.handle, &directory.overlapped);
+    DWORD bytesTransferred = 0;
+    GetOverlappedResult(
+        directory.handle, &directory.overlapped, &bytesTransferred, TRUE);
+    directory.isReading = false;
+  }
+  if (directory.handle != INVALID_HANDLE_VALUE) {
+    CloseHandle(directory.handle);
+    directory.handle = INVALID_HANDLE_VALUE;
+  }
+}
+
+void recordChanges(const WatchedDirectory& directory,
+                   DWORD bytesTransferred,
+                   std::set<std::filesystem::path>& changedPaths) {
+  // No bytes are transferred if the buffer overflowed.
+  if (bytesTransferred == 0) {
+    changedPaths.insert(directory.path);
+    return;
+  }
+
+  auto bytes = reinterpret_cast<const BYTE*>(directory.buffer.data());
+  for (DWORD offset = 0;;) {
+    auto info =
+        reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(bytes + offset);
+    std::wstring filename(info->FileName,
+                          info->FileNameLength / sizeof(WCHAR));
+    changedPaths.insert(directory.path / filename);
+
+    if (info->NextEntryOffset == 0) {
+      break;
+    }
+    offset += info->NextEntryOffset;
+  }
+}
+#else
+static constexpr size_t EVENTS_BUFFER_SIZE = 64 * 1024;
+#endif
+}
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& directories,
+                         std::chrono::milliseconds debounceInterval,
+                         Callback callback) :
+    directories_(directories),
+    debounceInterval_(debounceInterval),
+    callback_(callback) {
+#ifdef _WIN32
+  stopEvent_ = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+  if (stopEvent_ == nullptr) {
+    throw std::system_error(GetLastError(),
+                            std::system_category(),
+                            "Failed to create the file watcher's stop event");
+  }
+#else
+  if (pipe2(stopPipe_, O_CLOEXEC) != 0) {
+    throw std::system_error(errno,
+                            std::generic_category(),
+                            "Failed to create the file watcher's stop pipe");
+  }
+#endif
+
+  std::promise<void> watching;
+  thread_ = std::thread(&FileWatcher::watch, this, std::ref(watching));
+  watching.get_future().wait();
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef _WIN32
+  SetEvent(stopEvent_);
+#else
+  const char stop = 0;
+  while (write(stopPipe_[1], &stop, 1) < 0 && errno == EINTR) {
+  }
+#endif
+
+  thread_.join();
+
+#ifdef _WIN32
+  CloseHandle(stopEvent_);
+#else
+  close(stopPipe_[0]);
+  close(stopPipe_[1]);
+#endif
+}
+
+#ifdef _WIN32
+void FileWatcher::watch(std::promise<void>& watching) {
+  auto logger = getLogger();
+
+  // The stop event is the first wait handle, and has no directory.
+  std::vector<WatchedDirectory> directories(directories_.size());
+  std::vector<HANDLE> waitHandles{stopEvent_};
+  std::vector<WatchedDirectory*> waitDirectories{nullptr};
+  for (size_t i = 0; i < directories_.size(); ++i) {
+    auto& directory = directories[i];
+    directory.path = directories_[i];
+    directory.overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+    if (directory.overlapped.hEvent == nullptr || !openDirectory(directory)) {
+      if (logger) {
+        logger->warn("Unable to watch {} for changes, error code: {}",
+                     directory.path.u8string(),
+                     GetLastError());
+      }
+      continue;
+    }
+
+    waitHandles.push_back(directory.overlapped.hEvent);
+    waitDirectories.push_back(&directory);
+  }
+  watching.set_value();
+
+  std::set<std::filesystem::path> changedPaths;
+  while (true) {
+    DWORD timeout = changedPaths.empty()
+                        ? INFINITE
+                        : static_cast<DWORD>(debounceInterval_.count());
+    DWORD result = WaitForMultipleObjects(
+        static_cast<DWORD>(waitHandles.size()), waitHandles.data(), FALSE,
+        timeout);
+
+    if (result == WAIT_TIMEOUT) {
+      notify(callback_, changedPaths);
+      continue;
+    }
+
+    // Stop if the stop event was signalled or waiting failed.
+    if (result <= WAIT_OBJECT_0 ||
+        result >= WAIT_OBJECT_0 + waitHandles.size()) {
+      break;
+    }
+
+    const auto waitIndex = result - WAIT_OBJECT_0;
+    auto& directory = *waitDirectories[waitIndex];
+    directory.isReading = false;
+    DWORD bytesTransferred = 0;
+    if (GetOverlappedResult(directory.handle,
+                            &directory.overlapped,
+                            &bytesTransferred,
+                            FALSE)) {
+      recordChanges(directory, bytesTransferred, changedPaths);
+    } else {
+      changedPaths.insert(directory.path);
+    }
+
+    ResetEvent(directory.overlapped.hEvent);
+    if (readChanges(directory)) {
+      continue;
+    }
+
+    // The directory's handle may no longer be usable, e.g. because the
+    // directory was deleted and recreated, so watch it again using a new
+    // handle. Any changes made in between are lost.
+    const auto error = GetLastError();
+    closeDirectory(directory);
+    changedPaths.insert(directory.path);
+    if (openDirectory(directory)) {
+      if (logger) {
+        logger->info("Restarted watching {} for changes after error code: {}",
+                     directory.path.u8string(),
+                     error);
+      }
+      continue;
+    }
+
+    if (logger) {
+      logger->warn("Stopped watching {} for changes, error code: {}",
+                   directory.path.u8string(),
+                   GetLastError());
+    }
+    closeDirectory(directory);
+    waitHandles.erase(waitHandles.begin() + waitIndex);
+    waitDirectories.erase(waitDirectories.begin() + waitIndex);
+  }
+
+  for (auto& directory : directories) {
+    closeDirectory(directory);
+    if (directory.overlapped.hEvent != nullptr) {
+      CloseHandle(directory.overlapped.hEvent);
+    }
+  }
+}
+#else
+void FileWatcher::watch(std::promise<void>& watching) {
+  auto logger = getLogger();
+
+  int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd < 0) {
+    if (logger) {
+      logger->warn("Unable to watch for file changes: {}",
+                   std::strerror(errno));
+    }
+    watching.set_value();
+    return;
+  }
+
+  std::map<int, std::filesystem::path> watchedDirectories;
+  for (const auto& directory : directories_) {
+    int watchDescriptor = inotify_add_watch(
+        inotifyFd,
+        directory.c_str(),
+        IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_FROM |
+            IN_MOVED_TO | IN_ONLYDIR);
+    if (watchDescriptor < 0) {
+      if (logger) {
+        logger->warn("Unable to watch {} for changes: {}",
+                     directory.u8string(),
+                     std::strerror(errno));
+      }
+      continue;
+    }
+
+    watchedDirectories.emplace(watchDescriptor, directory);
+  }
+  watching.set_value();
+
+  std::vector<char> buffer(EVENTS_BUFFER_SIZE);
+  std::set<std::filesystem::path> changedPaths;
+  while (true) {
+    pollfd fds[] = {{stopPipe_[0], POLLIN, 0}, {inotifyFd, POLLIN, 0}};
+    int timeout =
+        changedPaths.empty() ? -1 : static_cast<int>(debounceInterval_.count());
+    int result = poll(fds, 2, timeout);
+
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (logger) {
+        logger->warn("Stopped watching for file changes: {}",
+                     std::strerror(errno));
+      }
+      break;
+    }
+
+    if (result == 0) {
+      notify(callback_, changedPaths);
+      continue;
+    }
+
+    if (fds[0].revents != 0) {
+      break;
+    }
+
+    ssize_t length;
+    while ((length = read(inotifyFd, buffer.data(), buffer.size())) > 0) {
+      for (ssize_t offset = 0; offset < length;) {
+        auto event = reinterpret_cast<const inotify_event*>(&buffer[offset]);
+        offset += sizeof(inotify_event) + event->len;
+
+        if ((event->mask & IN_Q_OVERFLOW) != 0) {
+          for (const auto& directory : watchedDirectories) {
+            changedPaths.insert(directory.second);
+          }
+          continue;
+        }
+
+        auto it = watchedDirectories.find(event->wd);
+        if (it == watchedDirectories.end()) {
+          continue;
+        }
+
+        if (event->len == 0) {
+          changedPaths.insert(it->second);
+        } else {
+          changedPaths.insert(it->second /
+                              std::filesystem::u8path(event->name));
+        }
+      }
+    }
+  }
+
+  close(inotifyFd);
+}
+#endif
+}
@@ -0,0 +1,80 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_FILE_WATCHER
+#define LOOT_GUI_STATE_FILE_WATCHER
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace loot {
+/**
+ * @brief Watches directories for changes to the files directly inside them.
+ * @details Changes are collected until none have been seen for the debounce
+ *          interval, and then passed to the callback together. The callback
+ *          is called on the watcher's own thread. If a directory's changes
+ *          were lost, e.g. because too many happened at once, the directory's
+ *          own path is passed to the callback.
+ */
+class FileWatcher {
+public:
+  typedef std::function<void(const std::vector<std::filesystem::path>&)>
+      Callback;
+
+  // Directories that can't be watched are logged and skipped. Changes made
+  // once the constructor returns are seen.
+  FileWatcher(const std::vector<std::filesystem::path>& directories,
+              std::chrono::milliseconds debounceInterval,
+              Callback callback);
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+private:
+  // The promise is fulfilled once the directories are being watched.
+  void watch(std::promise<void>& watching);
+
+  const std::vector<std::filesystem::path> directories_;
+  const std::chrono::milliseconds debounceInterval_;
+  const Callback callback_;
+
+#ifdef _WIN32
+  // A HANDLE to an event that is signalled to stop watching.
+  void* stopEvent_;
+#else
+  // Writing to the pipe stops watching.
+  int stopPipe_[2];
+#endif
+
+  std::thread thread_;
+};
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/bash_tag_set.h"
+
+namespace loot {
+namespace gui {
+BashTagTable::BashTagTable(const std::set<std::string>& knownTags) :
+    names_(knownTags.begin(), knownTags.end()) {
+  ids_.reserve(names_.size());
+  for (size_t id = 0; id < names_.size(); ++id) {
+    ids_.emplace(names_[id], id);
+  }
+}
+
+std::optional<size_t> BashTagTable::GetId(const std::string& name) const {
+  auto it = ids_.find(name);
+  if (it == ids_.end()) {
+    return std::nullopt;
+  }
+
+  return it->second;
+}
+
+const std::string& BashTagTable::GetName(size_t id) const {
+  return names_.at(id);
+}
+
+size_t BashTagTable::size() const { return names_.size(); }
+
+BashTagSet::BashTagSet(std::shared_ptr<const BashTagTable> table) :
+    table_(table),
+    additions_(table->size()),
+    removals_(table->size()) {}
+
+BashTagSet::BashTagSet(std::shared_ptr<const BashTagTable> table,
+                       const std::set<Tag>& tags) :
+    BashTagSet(table) {
+  for (const auto& tag : tags) {
+    Add(tag);
+  }
+}
+
+void BashTagSet::Add(const Tag& tag) {
+  auto id = tag.IsConditional() ? std::nullopt : table_->GetId(tag.GetName());
+  if (!id.has_value()) {
+    otherTags_.insert(tag);
+  } else if (tag.IsAddition()) {
+    additions_.set(id.value());
+  } else {
+    removals_.set(id.value());
+  }
+}
+
+bool BashTagSet::empty() const {
+  return additions_.none() && removals_.none() && otherTags_.empty();
+}
+
+std::set<Tag> BashTagSet::ToTags() const {
+  std::set<Tag> tags;
+  ForEach([&](const Tag& tag) { tags.insert(tag); });
+  return tags;
+}
+}
+}
@@ -0,0 +1,124 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_BASH_TAG_SET
+#define LOOT_GUI_STATE_GAME_BASH_TAG_SET
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "loot/metadata/tag.h"
+
+namespace loot {
+namespace gui {
+/**
+ * @brief Assigns each of a game's known Bash Tags an ID, which is its index
+ *        in the lexicographically-sorted list of known tags.
+ */
+class BashTagTable {
+public:
+  BashTagTable() = default;
+  explicit BashTagTable(const std::set<std::string>& knownTags);
+
+  // Get the ID of the tag with the given name, which is case-sensitive.
+  std::optional<size_t> GetId(const std::string& name) const;
+  const std::string& GetName(size_t id) const;
+
+  size_t size() const;
+
+private:
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, size_t> ids_;
+};
+
+/**
+ * @brief A set of Bash Tag suggestions.
+ * @details Unconditional suggestions of known tags are held as bits in
+ *          addition and removal masks, so each takes one bit per set.
+ *          Conditional suggestions and suggestions of tags that aren't in
+ *          the table are held as Tag objects.
+ */
+class BashTagSet {
+public:
+  explicit BashTagSet(std::shared_ptr<const BashTagTable> table);
+  BashTagSet(std::shared_ptr<const BashTagTable> table,
+             const std::set<Tag>& tags);
+
+  void Add(const Tag& tag);
+
+  bool empty() const;
+
+  // Call the callback with each suggestion as a Tag, in the same order as a
+  // std::set<Tag> of the suggestions would hold them, so that serialised
+  // tags are in the same order whether or not they're known.
+  template<typename Callback>
+  void ForEach(Callback callback) const {
+    std::vector<Tag> knownTags;
+    knownTags.reserve(additions_.count() + removals_.count());
+    for (auto id = additions_.find_first(); id != Mask::npos;
+         id = additions_.find_next(id)) {
+      knownTags.emplace_back(table_->GetName(id), true);
+    }
+    for (auto id = removals_.find_first(); id != Mask::npos;
+         id = removals_.find_next(id)) {
+      knownTags.emplace_back(table_->GetName(id), false);
+    }
+    std::sort(knownTags.begin(), knownTags.end());
+
+    // Known tags are never also held as other tags.
+    auto otherTag = otherTags_.begin();
+    for (const auto& tag : knownTags) {
+      for (; otherTag != otherTags_.end() && *otherTag < tag; ++otherTag) {
+        callback(*otherTag);
+      }
+      callback(tag);
+    }
+    for (; otherTag != otherTags_.end(); ++otherTag) {
+      callback(*otherTag);
+    }
+  }
+
+  std::set<Tag> ToTags() const;
+
+private:
+  typedef boost::dynamic_bitset<std::uint64_t> Mask;
+
+  std::shared_ptr<const BashTagTable> table_;
+  Mask additions_;
+  Mask removals_;
+  std::set<Tag> otherTags_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/condition_dependency_index.h"
+
+#include <regex>
+
+#include <boost/algorithm/string.hpp>
+
+#include "gui/helpers.h"
+
+namespace loot {
+namespace gui {
+namespace {
+// Matches a condition function and its first argument, which is a path or
+// regex for all the functions that take a string argument.
+const std::regex CONDITION_FUNCTION_REGEX("([a-z_]+)\\s*\\(\\s*\"([^\"]*)\"",
+                                          std::regex::ECMAScript |
+                                              std::regex::optimize);
+
+// The functions whose first argument is a single file or plugin path. Paths
+// with regex characters match any file with a matching name.
+const std::unordered_set<std::string> PATH_FUNCTIONS({
+    "active",
+    "checksum",
+    "file",
+    "is_master",
+    "product_version",
+    "readable",
+    "version",
+});
+
+// libloot treats a path as a regex if it contains any of these characters.
+constexpr char REGEX_CHARACTERS[] = ":\\*?|";
+
+const std::string GHOST_EXTENSION = ".ghost";
+}
+
+void ConditionDependencyIndex::AddPlugin(PluginId pluginId) {
+  plugins_.insert(pluginId);
+}
+
+void ConditionDependencyIndex::AddCondition(PluginId pluginId,
+                                            const std::string& condition) {
+  AddPlugin(pluginId);
+
+  for (std::sregex_iterator it(
+           condition.begin(), condition.end(), CONDITION_FUNCTION_REGEX);
+       it != std::sregex_iterator();
+       ++it) {
+    const auto function = (*it)[1].str();
+    auto path = (*it)[2].str();
+    if (PATH_FUNCTIONS.count(function) == 0) {
+      // many() and many_active() take a regex that can match any file.
+      AddWildcard(pluginId);
+      continue;
+    }
+
+    // Only a regex's filename can have regex characters, so a regex in a
+    // subdirectory still only depends on the top-level directory.
+    const auto separator = path.find('/');
+    if (separator == std::string::npos &&
+        path.find_first_of(REGEX_CHARACTERS) != std::string::npos) {
+      AddWildcard(pluginId);
+      continue;
+    }
+
+    AddFile(pluginId, path);
+  }
+}
+
+void ConditionDependencyIndex::AddFile(PluginId pluginId,
+                                       const std::string& path) {
+  AddPlugin(pluginId);
+
+  auto key = GetKey(path);
+  if (!key.has_value()) {
+    AddWildcard(pluginId);
+    return;
+  }
+
+  auto& dependents = dependents_[key.value()];
+  if (dependents.empty() || dependents.back() != pluginId) {
+    dependents.push_back(pluginId);
+  }
+}
+
+bool ConditionDependencyIndex::HasPlugin(PluginId pluginId) const {
+  return plugins_.count(pluginId) != 0;
+}
+
+std::unordered_set<PluginId> ConditionDependencyIndex::GetDependents(
+    const std::unordered_set<std::string>& changedNames) const {
+  if (changedNames.empty()) {
+    return {};
+  }
+
+  auto dependents = wildcardDependents_;
+  for (const auto& name : changedNames) {
+    auto it = dependents_.find(name);
+    if (it != dependents_.end()) {
+      dependents.insert(it->second.begin(), it->second.end());
+    }
+  }
+
+  return dependents;
+}
+
+std::optional<std::string> ConditionDependencyIndex::GetKey(
+    const std::string& path) {
+  auto name = path.substr(0, path.find_first_of("/\\"));
+  if (name.empty() || name == "." || name == ".." ||
+      name.find(':') != std::string::npos) {
+    return std::nullopt;
+  }
+
+  if (boost::iends_with(name, GHOST_EXTENSION)) {
+    name.erase(name.length() - GHOST_EXTENSION.length());
+  }
+
+  return NormalizeFilename(name);
+}
+
+void ConditionDependencyIndex::AddWildcard(PluginId pluginId) {
+  wildcardDependents_.insert(pluginId);
+}
+}
+}
@@ -0,0 +1,102 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_CONDITION_DEPENDENCY_INDEX
+#define LOOT_GUI_STATE_GAME_CONDITION_DEPENDENCY_INDEX
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "gui/state/game/plugin_name_table.h"
+
+namespace loot {
+namespace gui {
+/**
+ * @brief A reverse index from the files and plugins that plugins' metadata
+ *        and masters refer to, to the plugins that refer to them.
+ *
+ * The index is keyed by the normalised names of entries in the Data
+ * directory, without any .ghost extension, so a file and the plugin of the
+ * same name share a key, and a file in a subdirectory is keyed by the
+ * top-level directory that holds it. The Data directory snapshot only holds
+ * top-level entries, so a change to a file in a subdirectory is only noticed
+ * if it also changes its top-level directory's modification time, i.e. if
+ * the file is a direct child of that directory and is added, removed or
+ * renamed. Other nested changes are picked up when the metadata lists are
+ * next loaded. Conditions that could refer to any file,
+ * e.g. many() or a regex file path, or to a file outside the Data directory
+ * make their plugin depend on every change.
+ */
+class ConditionDependencyIndex {
+public:
+  /**
+   * Record that the plugin has been indexed, even if its metadata has no
+   * dependencies.
+   */
+  void AddPlugin(PluginId pluginId);
+
+  /**
+   * Add the files and plugins that the given condition refers to as
+   * dependencies of the plugin.
+   */
+  void AddCondition(PluginId pluginId, const std::string& condition);
+
+  /**
+   * Add a dependency of the plugin on the given file, e.g. because the file
+   * is a requirement, so the plugin's metadata depends on whether the file
+   * exists or is active. The path is relative to the Data directory.
+   */
+  void AddFile(PluginId pluginId, const std::string& path);
+
+  bool HasPlugin(PluginId pluginId) const;
+
+  /**
+   * Get the indexed plugins that depend on any of the given names, which
+   * must be normalised and have no .ghost extension.
+   */
+  std::unordered_set<PluginId> GetDependents(
+      const std::unordered_set<std::string>& changedNames) const;
+
+  /**
+   * Get the index key for the given path, relative to the Data directory, or
+   * nullopt if the path may be outside the Data directory.
+   */
+  static std::optional<std::string> GetKey(const std::string& path);
+
+private:
+  void AddWildcard(PluginId pluginId);
+
+  std::unordered_set<PluginId> plugins_;
+  std::unordered_map<std::string, std::vector<PluginId>> dependents_;
+  // Plugins that depend on every change.
+  std::unordered_set<PluginId> wildcardDependents_;
+};
+}
+}
+
+#endif
@@ -26,8 +26,11 @@
 #include "gui/state/game/game.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <fstream>
+#include <future>
+#include <iterator>
 #include <thread>
 
 #ifdef _WIN32
@@ -52,7 +55,12 @@
 #include "gui/helpers.h"
 #include "gui/state/game/game_detection_error.h"
 #include "gui/state/game/helpers.h"
+#include "gui/state/game/mapped_plugin_file.h"
+#include "gui/state/game/message_templates.h"
+#include "gui/state/log_bridge.h"
 #include "gui/state/logging.h"
+#include "gui/state/timing.h"
+#include "gui/version.h"
 #include "loot/exception/file_access_error.h"
 #include "loot/exception/undefined_group_error.h"
 
@@ -68,36 +76,313 @@ namespace fs = std::filesystem;
 
 namespace loot {
 namespace gui {
+// Loaded plugin headers hold little more than the plugin's name, version,
+// masters and Bash Tags.
+static constexpr std::uintmax_t ESTIMATED_PLUGIN_HEADER_BYTES = 4096;
+// The number of bytes at the start of each plugin to read ahead when loading
+// headers, which is enough to hold the header records of all but plugins with
+// very many masters or overridden records.
+static constexpr size_t HEADER_READ_AHEAD_BYTES = 64 * 1024;
+// The most plugin files that are mapped and read ahead at once, so that a
+// large load order doesn't hold thousands of files open and the read-ahead
+// doesn't get so far ahead of the reads that its pages are evicted first.
+static constexpr size_t READ_AHEAD_WINDOW_FILES = 256;
+// The most bytes of whole plugin files that are read ahead for one full load,
+// as more would just push the first files out of the page cache again.
+static constexpr std::uintmax_t READ_AHEAD_WINDOW_BYTES = 256 * 1024 * 1024;
+// Fully loaded plugins also hold their FormIDs, which take up roughly a
+// quarter of the plugin's size for typical plugins.
+static constexpr std::uintmax_t FILE_BYTES_PER_ESTIMATED_FORMID_BYTE = 4;
+// The estimated memory that plugins fully loaded on demand may use before the
+// least recently used are evicted.
+static constexpr std::uintmax_t FULLY_LOADED_PLUGINS_BUDGET_BYTES =
+    256 * 1024 * 1024;
+
+// The minimum number of files to check the validity of per thread when
+// scanning for plugins.
+static constexpr size_t MIN_PLUGINS_PER_VALIDITY_THREAD = 16;
+
 bool hasPluginFileExtension(const std::string& filename) {
   return boost::iends_with(filename, ".esp") ||
          boost::iends_with(filename, ".esm") ||
          boost::iends_with(filename, ".esl");
 }
 
+static constexpr size_t GHOST_EXTENSION_LENGTH = 6;
+
+// Get a name for the directory that holds the shared masterlist for the given
+// repository branch. The name needs to be the same each time LOOT runs, so
+// it's an FNV-1a hash instead of a std::hash.
+std::string getMasterlistDirectoryName(const std::string& repoUrl,
+                                       const std::string& repoBranch) {
+  static constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+  static constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+  std::uint64_t hash = FNV_OFFSET_BASIS;
+  auto hashString = [&](const std::string& string) {
+    for (const auto character : string) {
+      hash ^= static_cast<unsigned char>(character);
+      hash *= FNV_PRIME;
+    }
+  };
+  hashString(repoUrl);
+  // Separate the URL and branch so that moving characters between them
+  // changes the hash.
+  hashString(std::string(1, '\0'));
+  hashString(repoBranch);
+
+  return (boost::format("%016x") % hash).str();
+}
+
+// Games that share a masterlist may update it at the same time, e.g. when one
+// is being preloaded, so updates to each masterlist path are serialised.
+std::shared_ptr<std::mutex> getMasterlistUpdateMutex(const fs::path& path) {
+  static std::mutex mapMutex;
+  static std::unordered_map<std::string, std::shared_ptr<std::mutex>> mutexes;
+
+  lock_guard<mutex> guard(mapMutex);
+  auto& updateMutex = mutexes[path.u8string()];
+  if (!updateMutex) {
+    updateMutex = std::make_shared<std::mutex>();
+  }
+
+  return updateMutex;
+}
+
+// These games' load orders are stored as the plugins' modification times.
+bool hasTimestampLoadOrder(GameType gameType) {
+  return gameType == GameType::tes3 || gameType == GameType::tes4 ||
+         gameType == GameType::fo3 || gameType == GameType::fonv;
+}
+
+// Plugins may be ghosted, in which case they have a .ghost extension after
+// their plugin extension.
+bool isPluginFilename(const std::string& filename) {
+  if (boost::iends_with(filename, ".ghost")) {
+    return hasPluginFileExtension(
+        filename.substr(0, filename.length() - GHOST_EXTENSION_LENGTH));
+  }
+
+  return hasPluginFileExtension(filename);
+}
+
+// A sorted load order remains valid after a plugin's user metadata is edited if
+// the plugin's group is unchanged and all the plugins that it must load after
+// already do. Removed rules can't make the load order invalid.
+bool isSortedLoadOrderValidAfterEdit(
+    const std::vector<std::string>& sortedPlugins,
+    const std::optional<PluginMetadata>& oldMetadata,
+    const PluginMetadata& newMetadata) {
+  auto oldGroup =
+      oldMetadata.has_value() ? oldMetadata.value().GetGroup() : std::nullopt;
+  if (oldGroup != newMetadata.GetGroup()) {
+    return false;
+  }
+
+  std::unordered_map<std::string, size_t> positions;
+  for (size_t i = 0; i < sortedPlugins.size(); ++i) {
+    positions.emplace(NormalizeFilename(sortedPlugins[i]), i);
+  }
+
+  auto pluginPosition =
+      positions.find(NormalizeFilename(newMetadata.GetName()));
+  if (pluginPosition == positions.end()) {
+    // The plugin isn't sorted, so its metadata doesn't affect the load order.
+    return true;
+  }
+
+  auto loadsBefore = [&](const File& file) {
+    auto it = positions.find(NormalizeFilename(file.GetName()));
+    // Rules for plugins that aren't sorted are ignored.
+    return it == positions.end() || it->second < pluginPosition->second;
+  };
+
+  auto after = newMetadata.GetLoadAfterFiles();
+  auto requirements = newMetadata.GetRequirements();
+  return std::all_of(after.cbegin(), after.cend(), loadsBefore) &&
+         std::all_of(requirements.cbegin(), requirements.cend(), loadsBefore);
+}
+
+// Light masters with a .esp extension are loaded as normal plugins, so can
+// have non-master masters.
+void addToMasterGraph(MasterGraph& graph,
+                      PluginNameTable& pluginNames,
+                      const PluginInterface& plugin) {
+  std::vector<PluginId> masters;
+  for (const auto& master : plugin.GetMasters()) {
+    masters.push_back(pluginNames.Intern(master));
+  }
+
+  graph.AddPlugin(pluginNames.Intern(plugin.GetName()),
+                  masters,
+                  plugin.IsMaster() || plugin.IsLightMaster(),
+                  plugin.IsLightMaster() &&
+                      !boost::iends_with(plugin.GetName(), ".esp"));
+}
+
+// Records the time taken by a stage of sorting in a sort profile, as well as
+// in the timing recorder.
+class SortStageTimer {
+public:
+  SortStageTimer(const char* timerName,
+                 const char* stageName,
+                 SortProfile& profile) :
+      timer_(timerName),
+      stageName_(stageName),
+      profile_(profile),
+      start_(std::chrono::steady_clock::now()) {}
+
+  ~SortStageTimer() {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_);
+    profile_.stages.push_back({stageName_, duration.count()});
+  }
+
+  SortStageTimer(const SortStageTimer&) = delete;
+  SortStageTimer& operator=(const SortStageTimer&) = delete;
+
+private:
+  ScopedTimer timer_;
+  const char* stageName_;
+  SortProfile& profile_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+bool Game::ExternalChanges::IsEmpty() const {
+  return plugins.empty() && !dataDirectory && !loadOrder && !metadataLists;
+}
+
 Game::Game(const GameSettings& gameSettings,
            const std::filesystem::path& lootDataPath) :
     GameSettings(gameSettings),
     lootDataPath_(lootDataPath),
     pluginsFullyLoaded_(false),
-    loadOrderSortCount_(0) {}
+    loadOrderSortCount_(0),
+    messagesRevision_(0),
+    derivedMetadataRevision_(0),
+    metadataRevision_(0),
+    groupsRevision_(0),
+    metadataListsStale_(false),
+    pluginViewGeneration_(0),
+    pluginReadingThreads_(0),
+    dataDirectoryGeneration_(0),
+    pluginNames_(std::make_shared<PluginNameTable>()),
+    fullyLoadedPluginsBytes_(0),
+    fullyLoadedPluginsUseCount_(0),
+    isUserMetadataTransactionOpen_(false),
+    userMetadataTransactionHasEdits_(false),
+    userMetadataSaveRequested_(false) {
+  RegisterCaches();
+}
 
 Game::Game(const Game& game) :
+    Game(game, lock_guard<mutex>(game.mutex_)) {}
+
+Game::Game(const Game& game, const lock_guard<mutex>&) :
     GameSettings(game),
     lootDataPath_(game.lootDataPath_),
     gameHandle_(game.gameHandle_),
     pluginsFullyLoaded_(game.pluginsFullyLoaded_),
+    dataDirectoryEntries_(game.dataDirectoryEntries_),
+    pluginValidityCache_(game.pluginValidityCache_),
+    derivedPluginFingerprints_(game.derivedPluginFingerprints_),
+    derivedMetadataJson_(game.derivedMetadataJson_),
+    derivedMetadataRevision_(game.derivedMetadataRevision_),
+    metadataRevision_(game.metadataRevision_),
+    groupIndex_(game.groupIndex_),
+    groupsRevision_(game.groupsRevision_),
+    lastSortResult_(game.lastSortResult_),
+    lastSortProfile_(game.lastSortProfile_),
+    metadataListTimes_(game.metadataListTimes_),
+    metadataListsStale_(game.metadataListsStale_),
+    loadedMetadataListPaths_(game.loadedMetadataListPaths_),
+    lastSetLoadOrder_(game.lastSetLoadOrder_),
+    loadOrderStateFingerprint_(game.loadOrderStateFingerprint_),
+    ownWriteTimes_(game.ownWriteTimes_),
+    dataDirectoryGeneration_(game.dataDirectoryGeneration_),
+    pluginNames_(game.pluginNames_),
+    formIdOverlaps_(game.formIdOverlaps_),
+    lightMasterValidity_(game.lightMasterValidity_),
+    fullyLoadedPlugins_(game.fullyLoadedPlugins_),
+    fullyLoadedPluginsBytes_(game.fullyLoadedPluginsBytes_),
+    fullyLoadedPluginsUseCount_(game.fullyLoadedPluginsUseCount_),
+    evaluatedMasterlistMetadata_(game.evaluatedMasterlistMetadata_),
+    evaluatedUserMetadata_(game.evaluatedUserMetadata_),
+    evaluatedActivePlugins_(game.evaluatedActivePlugins_),
+    evaluatedDataDirectoryEntries_(game.evaluatedDataDirectoryEntries_),
+    conditionDependencies_(game.conditionDependencies_),
+    masterGraph_(game.masterGraph_),
+    prefetchedMasterlistUpdate_(game.prefetchedMasterlistUpdate_),
     messages_(game.messages_),
-    loadOrderSortCount_(0) {}
+    messagesRevision_(game.messagesRevision_),
+    pluginView_(game.pluginView_),
+    pluginViewGeneration_(game.pluginViewGeneration_),
+    pluginReadingThreads_(game.pluginReadingThreads_),
+    loadOrderSortCount_(0),
+    isUserMetadataTransactionOpen_(false),
+    userMetadataTransactionHasEdits_(false),
+    userMetadataSaveRequested_(false) {
+  RegisterCaches();
+}
+
+Game::~Game() {
+  // The task writes the userlist using this game's handle.
+  userMetadataSaveTask_.reset();
+}
 
 Game& Game::operator=(const Game& game) {
   if (&game != this) {
+    // The registered caches of both games may be evicted from on other
+    // threads.
+    std::scoped_lock guard(mutex_, game.mutex_);
+
     GameSettings::operator=(game);
 
     lootDataPath_ = game.lootDataPath_;
     gameHandle_ = game.gameHandle_;
     pluginsFullyLoaded_ = game.pluginsFullyLoaded_;
+    dataDirectoryEntries_ = game.dataDirectoryEntries_;
+    pluginValidityCache_ = game.pluginValidityCache_;
+    derivedPluginFingerprints_ = game.derivedPluginFingerprints_;
+    derivedMetadataJson_ = game.derivedMetadataJson_;
+    derivedMetadataRevision_ = game.derivedMetadataRevision_;
+    metadataRevision_ = game.metadataRevision_;
+    groupIndex_ = game.groupIndex_;
+    groupsRevision_ = game.groupsRevision_;
+    lastSortResult_ = game.lastSortResult_;
+    lastSortProfile_ = game.lastSortProfile_;
+    metadataListTimes_ = game.metadataListTimes_;
+    metadataListsStale_ = game.metadataListsStale_;
+    loadedMetadataListPaths_ = game.loadedMetadataListPaths_;
+    lastSetLoadOrder_ = game.lastSetLoadOrder_;
+    loadOrderStateFingerprint_ = game.loadOrderStateFingerprint_;
+    ownWriteTimes_ = game.ownWriteTimes_;
+    dataDirectoryGeneration_ = game.dataDirectoryGeneration_;
+    pluginNames_ = game.pluginNames_;
+    formIdOverlaps_ = game.formIdOverlaps_;
+    lightMasterValidity_ = game.lightMasterValidity_;
+    fullyLoadedPlugins_ = game.fullyLoadedPlugins_;
+    fullyLoadedPluginsBytes_ = game.fullyLoadedPluginsBytes_;
+    fullyLoadedPluginsUseCount_ = game.fullyLoadedPluginsUseCount_;
+    evaluatedMasterlistMetadata_ = game.evaluatedMasterlistMetadata_;
+    evaluatedUserMetadata_ = game.evaluatedUserMetadata_;
+    evaluatedActivePlugins_ = game.evaluatedActivePlugins_;
+    evaluatedDataDirectoryEntries_ = game.evaluatedDataDirectoryEntries_;
+    conditionDependencies_ = game.conditionDependencies_;
+    masterGraph_ = game.masterGraph_;
+    prefetchedMasterlistUpdate_ = game.prefetchedMasterlistUpdate_;
     messages_ = game.messages_;
+    messagesRevision_ = game.messagesRevision_;
     loadOrderSortCount_ = game.loadOrderSortCount_;
+    simpleMessages_ = std::nullopt;
+    currentLoadOrderIndices_ = std::nullopt;
+    otherLoadOrderIndices_ = std::nullopt;
+    activePlugins_ = std::nullopt;
+    userMetadataPlugins_ = std::nullopt;
+    resolvedMetadata_ = std::nullopt;
+    pluginView_ = game.pluginView_;
+    pluginViewGeneration_ = game.pluginViewGeneration_;
+    pluginReadingThreads_ = game.pluginReadingThreads_;
   }
 
   return *this;
@@ -109,13 +394,17 @@ void Game::Init() {
     logger->info("Initialising filesystem-related data for game: {}", Name());
   }
 
-  // Reset data that is dependent on the libloot game handle.
-  messages_.clear();
-  loadOrderSortCount_ = 0;
-  pluginsFullyLoaded_ = false;
+  FlushUserMetadata();
+  ClearGameHandleData();
+
+  auto gameHandle = CreateGameHandle(Type(), GamePath(), GameLocalPath());
+  gameHandle->IdentifyMainMasterFile(Master());
 
-  gameHandle_ = CreateGameHandle(Type(), GamePath(), GameLocalPath());
-  gameHandle_->IdentifyMainMasterFile(Master());
+  {
+    // The handle is read from other threads by GetMemoryUsage().
+    lock_guard<mutex> guard(mutex_);
+    gameHandle_ = gameHandle;
+  }
 
   if (!lootDataPath_.empty()) {
     // Make sure that the LOOT game path exists.
@@ -131,65 +420,171 @@ void Game::Init() {
   }
 }
 
+void Game::Unload() {
+  auto logger = getLogger();
+  if (logger) {
+    logger->info("Unloading data for game: {}", Name());
+  }
+
+  FlushUserMetadata();
+  ClearGameHandleData();
+
+  lock_guard<mutex> guard(mutex_);
+  gameHandle_.reset();
+}
+
+Game::MemoryUsage Game::GetMemoryUsage() const {
+  // Memory usage is checked from other threads, so hold on to the handle in
+  // case the game is unloaded meanwhile.
+  std::shared_ptr<GameInterface> gameHandle;
+  bool pluginsFullyLoaded = false;
+  {
+    lock_guard<mutex> guard(mutex_);
+    gameHandle = gameHandle_;
+    pluginsFullyLoaded = pluginsFullyLoaded_;
+  }
+
+  MemoryUsage usage;
+  if (!gameHandle) {
+    return usage;
+  }
+
+  for (const auto& plugin : gameHandle->GetLoadedPlugins()) {
+    ++usage.pluginCount;
+    usage.estimatedBytes += ESTIMATED_PLUGIN_HEADER_BYTES;
+
+    if (pluginsFullyLoaded) {
+      usage.estimatedBytes += GetEstimatedFormIdBytes(plugin->GetName());
+    }
+  }
+
+  lock_guard<mutex> guard(mutex_);
+  usage.estimatedBytes += fullyLoadedPluginsBytes_;
+  usage.estimatedBytes += GetDerivedMetadataJsonBytesLocked();
+
+  return usage;
+}
+
 std::shared_ptr<const PluginInterface> Game::GetPlugin(
     const std::string& name) const {
   return gameHandle_->GetPlugin(name);
 }
 
-std::set<std::shared_ptr<const PluginInterface>> Game::GetPlugins() const {
-  return gameHandle_->GetLoadedPlugins();
+PluginView Game::GetPlugins() const {
+  unsigned int generation;
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (pluginView_.has_value()) {
+      return pluginView_.value();
+    }
+    generation = ++pluginViewGeneration_;
+  }
+
+  auto loadedPlugins = gameHandle_->GetLoadedPlugins();
+  std::unordered_map<std::string, std::shared_ptr<const PluginInterface>>
+      pluginsByName;
+  pluginsByName.reserve(loadedPlugins.size());
+  for (const auto& plugin : loadedPlugins) {
+    pluginsByName.emplace(NormalizeFilename(plugin->GetName()), plugin);
+  }
+
+  auto plugins = std::make_shared<PluginView::Plugins>();
+  plugins->reserve(loadedPlugins.size());
+  for (const auto& pluginName : gameHandle_->GetLoadOrder()) {
+    auto it = pluginsByName.find(NormalizeFilename(pluginName));
+    if (it != pluginsByName.end()) {
+      plugins->push_back(it->second);
+      pluginsByName.erase(it);
+    }
+  }
+
+  // Loaded plugins that aren't in the load order go at the end, in name
+  // order so that the view's order is stable.
+  std::vector<std::shared_ptr<const PluginInterface>> unorderedPlugins;
+  for (const auto& entry : pluginsByName) {
+    unorderedPlugins.push_back(entry.second);
+  }
+  std::sort(unorderedPlugins.begin(),
+            unorderedPlugins.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return CompareFilenames(lhs->GetName(), rhs->GetName()) < 0;
+            });
+  plugins->insert(
+      plugins->end(), unorderedPlugins.cbegin(), unorderedPlugins.cend());
+
+  PluginView view(plugins, generation);
+
+  // Don't replace a view that was created after this one started, or cache
+  // this one if the plugins or load order have changed since it started.
+  lock_guard<mutex> guard(mutex_);
+  if (generation == pluginViewGeneration_) {
+    pluginView_ = view;
+  }
+
+  return view;
 }
 
+size_t Game::PluginCount() const { return GetPlugins().size(); }
+
+bool Game::HasPlugins() const { return !GetPlugins().empty(); }
+
 std::vector<Message> Game::CheckInstallValidity(
     const std::shared_ptr<const PluginInterface>& plugin,
     const PluginMetadata& metadata) {
   auto logger = getLogger();
 
-  if (logger) {
+  // This is called for every plugin, so avoid constructing the log message's
+  // arguments unless they'll be used.
+  if (logger && logger->should_log(spdlog::level::trace)) {
     logger->trace(
         "Checking that the current install is valid according to {}'s data.",
         plugin->GetName());
   }
   std::vector<Message> messages;
-  if (IsPluginActive(plugin->GetName())) {
+  const auto templates = GetMessageTemplates();
+
+  // The problems with the plugin's masters are found for all plugins at
+  // once, and kept up to date as plugins change.
+  bool isActive = false;
+  std::vector<MasterGraph::Problem> masterProblems;
+  {
+    lock_guard<mutex> guard(mutex_);
+    isActive = IsPluginActiveLocked(plugin->GetName());
+    masterProblems = GetMasterProblemsLocked(*plugin);
+  }
+
+  if (isActive) {
     auto fileExists = [&](const std::string& file) {
-      return std::filesystem::exists(DataPath() / u8path(file)) ||
-             (hasPluginFileExtension(file) &&
-              std::filesystem::exists(DataPath() / u8path(file + ".ghost")));
+      return DataFileExists(file) ||
+             (hasPluginFileExtension(file) && DataFileExists(file + ".ghost"));
     };
     auto tags = metadata.GetTags();
     if (tags.find(Tag("Filter")) == std::end(tags)) {
-      for (const auto& master : plugin->GetMasters()) {
-        if (!fileExists(master)) {
+      for (const auto& problem : masterProblems) {
+        const auto& master = pluginNames_->GetName(problem.master);
+        if (problem.type == MasterGraph::ProblemType::missingMaster) {
           if (logger) {
             logger->error("\"{}\" requires \"{}\", but it is missing.",
                           plugin->GetName(),
                           master);
           }
-          messages.push_back(
-              PlainTextMessage(MessageType::error,
-                               (boost::format(boost::locale::translate(
-                                    "This plugin requires \"%1%\" to be "
-                                    "installed, but it is missing.")) %
-                                master)
-                                   .str()));
-        } else if (!IsPluginActive(master)) {
+          messages.push_back(PlainTextMessage(
+              MessageType::error,
+              (templates->Format(MessageTemplate::missingMaster) % master)
+                  .str()));
+        } else if (problem.type == MasterGraph::ProblemType::inactiveMaster) {
           if (logger) {
             logger->error("\"{}\" requires \"{}\", but it is inactive.",
                           plugin->GetName(),
                           master);
           }
-          messages.push_back(
-              PlainTextMessage(MessageType::error,
-                               (boost::format(boost::locale::translate(
-                                    "This plugin requires \"%1%\" to be "
-                                    "active, but it is inactive.")) %
-                                master)
-                                   .str()));
+          messages.push_back(PlainTextMessage(
+              MessageType::error,
+              (templates->Format(MessageTemplate::inactiveMaster) % master)
+                  .str()));
         }
       }
     }
-
     for (const auto& req : metadata.GetRequirements()) {
       if (!fileExists(req.GetName())) {
         if (logger) {
@@ -197,12 +592,11 @@ std::vector<Message> Game::CheckInstallValidity(
                         plugin->GetName(),
                         req.GetName());
         }
-        messages.push_back(Message(MessageType::error,
-                                   (boost::format(boost::locale::translate(
-                                        "This plugin requires \"%1%\" to be "
-                                        "installed, but it is missing.")) %
-                                    req.GetDisplayName())
-                                       .str()));
+        messages.push_back(
+            Message(MessageType::error,
+                    (templates->Format(MessageTemplate::missingRequirement) %
+                     req.GetDisplayName())
+                        .str()));
       }
     }
     for (const auto& inc : metadata.GetIncompatibilities()) {
@@ -215,54 +609,37 @@ std::vector<Message> Game::CheckInstallValidity(
               plugin->GetName(),
               inc.GetName());
         }
-        messages.push_back(
-            Message(MessageType::error,
-                    (boost::format(boost::locale::translate(
-                         "This plugin is incompatible with \"%1%\", but both "
-                         "files are present.")) %
-                     inc.GetDisplayName())
-                        .str()));
+        messages.push_back(Message(
+            MessageType::error,
+            (templates->Format(MessageTemplate::incompatibilityPresent) %
+             inc.GetDisplayName())
+                .str()));
       }
     }
   }
 
-  if (plugin->IsLightMaster() &&
-      !boost::iends_with(plugin->GetName(), ".esp")) {
-    for (const auto& masterName : plugin->GetMasters()) {
-      auto master = GetPlugin(masterName);
-      if (!master) {
-        if (logger) {
-          logger->info(
-              "Tried to get plugin object for master \"{}\" of \"{}\" but it "
-              "was not loaded.",
-              masterName,
-              plugin->GetName());
-        }
-        continue;
-      }
+  for (const auto& problem : masterProblems) {
+    if (problem.type != MasterGraph::ProblemType::nonMasterMaster) {
+      continue;
+    }
 
-      if (!master->IsLightMaster() && !master->IsMaster()) {
-        if (logger) {
-          logger->error(
-              "\"{}\" is a light master and requires the non-master plugin "
-              "\"{}\". This can cause issues in-game, and sorting will fail "
-              "while this plugin is installed.",
-              plugin->GetName(),
-              masterName);
-        }
-        messages.push_back(PlainTextMessage(
-            MessageType::error,
-            (boost::format(boost::locale::translate(
-                 "This plugin is a light master and requires the non-master "
-                 "plugin \"%1%\". This can cause issues in-game, and sorting "
-                 "will fail while this plugin is installed.")) %
-             masterName)
-                .str()));
-      }
+    const auto& masterName = pluginNames_->GetName(problem.master);
+    if (logger) {
+      logger->error(
+          "\"{}\" is a light master and requires the non-master plugin "
+          "\"{}\". This can cause issues in-game, and sorting will fail "
+          "while this plugin is installed.",
+          plugin->GetName(),
+          masterName);
     }
+    messages.push_back(PlainTextMessage(
+        MessageType::error,
+        (templates->Format(MessageTemplate::lightMasterRequiresNonMaster) %
+         masterName)
+            .str()));
   }
 
-  if (plugin->IsLightMaster() && !plugin->IsValidAsLightMaster()) {
+  if (plugin->IsLightMaster() && !IsValidAsLightMaster(*plugin)) {
     if (logger) {
       logger->error(
           "\"{}\" contains records that have FormIDs outside the valid range "
@@ -272,10 +649,7 @@ std::vector<Message> Game::CheckInstallValidity(
     }
     messages.push_back(PlainTextMessage(
         MessageType::error,
-        boost::locale::translate(
-            "This plugin contains records that have FormIDs outside "
-            "the valid range for an ESL plugin. Using this plugin "
-            "will cause irreversible damage to your game saves.")));
+        templates->Translate(MessageTemplate::invalidLightMaster)));
   }
 
   if (plugin->GetHeaderVersion() < MinimumHeaderVersion()) {
@@ -289,20 +663,17 @@ std::vector<Message> Game::CheckInstallValidity(
     }
     messages.push_back(PlainTextMessage(
         MessageType::warn,
-        (boost::format(boost::locale::translate(
-             "This plugin has a header version of %1%, which is less than the "
-             "game's minimum supported header version of %2%.")) %
+        (templates->Format(MessageTemplate::headerVersionTooLow) %
          plugin->GetHeaderVersion() % MinimumHeaderVersion())
             .str()));
   }
 
   if (metadata.GetGroup().has_value()) {
     auto group = Group(metadata.GetGroup().value());
-    if (gameHandle_->GetDatabase()->GetGroups().count(group) == 0) {
+    if (!GroupExists(group.GetName())) {
       messages.push_back(PlainTextMessage(
         MessageType::error,
-        (boost::format(boost::locale::translate(
-          "This plugin belongs to the group \"%1%\", which does not exist.")) %
+        (templates->Format(MessageTemplate::nonExistentGroup) %
           group.GetName())
         .str()));
     }
@@ -316,53 +687,86 @@ std::vector<Message> Game::CheckInstallValidity(
   return messages;
 }
 
-void Game::RedatePlugins() {
+size_t Game::RedatePlugins() {
   auto logger = getLogger();
 
   if (Type() != GameType::tes5 && Type() != GameType::tes5se) {
     if (logger) {
       logger->warn("Cannot redate plugins for game {}.", Name());
     }
-    return;
+    return 0;
   }
 
+  ScopedTimer timer("Game::RedatePlugins");
+
   vector<string> loadorder = gameHandle_->GetLoadOrder();
-  if (!loadorder.empty()) {
-    std::filesystem::file_time_type lastTime =
-        std::filesystem::file_time_type::clock::time_point::min();
-    for (const auto& pluginName : loadorder) {
-      fs::path filepath = DataPath() / u8path(pluginName);
-      if (!fs::exists(filepath)) {
-        filepath += ".ghost";
-        if (!fs::exists(filepath)) {
-          continue;
-        }
+  if (loadorder.empty()) {
+    return 0;
+  }
+
+  // Read all the Data directory's timestamps in one pass instead of checking
+  // each plugin's paths separately.
+  std::unordered_map<std::string, FileTimestamp> dataTimestamps;
+  for (fs::directory_iterator it(DataPath()); it != fs::directory_iterator();
+       ++it) {
+    std::error_code errorCode;
+    auto time = it->last_write_time(errorCode);
+    if (!errorCode) {
+      dataTimestamps.emplace(
+          NormalizeFilename(it->path().filename().u8string()),
+          FileTimestamp{it->path(), time});
+    }
+  }
+
+  std::vector<FileTimestamp> timestamps;
+  timestamps.reserve(loadorder.size());
+  for (const auto& pluginName : loadorder) {
+    auto normalizedName = NormalizeFilename(pluginName);
+    auto it = dataTimestamps.find(normalizedName);
+    if (it == dataTimestamps.end()) {
+      it = dataTimestamps.find(normalizedName + ".ghost");
+      if (it == dataTimestamps.end()) {
+        continue;
       }
+    }
 
-      auto thisTime = fs::last_write_time(filepath);
-      if (thisTime >= lastTime) {
-        lastTime = thisTime;
+    timestamps.push_back(it->second);
+  }
 
-        if (logger) {
-          logger->trace("No need to redate \"{}\".",
-                        filepath.filename().u8string());
-        }
-      } else {
-        lastTime += std::chrono::seconds(60);
-        fs::last_write_time(filepath,
-                            lastTime);  // Space timestamps by a minute.
+  auto redatedTimestamps = GetRedatedTimestamps(timestamps);
+  auto redatedCount = SetTimestamps(redatedTimestamps);
 
-        if (logger) {
-          logger->info("Redated \"{}\"", filepath.filename().u8string());
-        }
+  std::vector<fs::path> redatedPaths;
+  for (const auto& timestamp : redatedTimestamps) {
+    redatedPaths.push_back(timestamp.path);
+  }
+  RecordOwnWrites(redatedPaths);
+
+  if (logger) {
+    if (logger->should_log(spdlog::level::info)) {
+      for (const auto& timestamp : redatedTimestamps) {
+        logger->info("Redated \"{}\"", timestamp.path.filename().u8string());
       }
     }
+    logger->info("Redated {} of {} plugins.", redatedCount, timestamps.size());
   }
+
+  return redatedCount;
 }
 
-void Game::LoadAllInstalledPlugins(bool headersOnly) {
+void Game::LoadAllInstalledPlugins(
+    bool headersOnly,
+    const PluginReadProgressCallback& progressCallback) {
+  ScopedTimer timer("Game::LoadAllInstalledPlugins");
+  ScopedLogSummary logSummary("loading plugins");
+
+  auto previousDataDirectoryEntries = dataDirectoryEntries_;
+  auto installedPluginNames = GetInstalledPluginNames();
+
+  // The Data directory is scanned first so that the load order state is only
+  // reloaded if it or the installed plugins have changed.
   try {
-    gameHandle_->LoadCurrentLoadOrderState();
+    ReloadLoadOrderStateIfChanged();
   } catch (std::exception& e) {
     auto logger = getLogger();
     if (logger) {
@@ -374,10 +778,16 @@ void Game::LoadAllInstalledPlugins(bool headersOnly) {
                                  "information displayed may be incorrect.")
             .str()));
   }
-
-  auto installedPluginNames = GetInstalledPluginNames();
+  ReadPluginFiles(installedPluginNames, headersOnly, progressCallback);
   gameHandle_->LoadPlugins(installedPluginNames, headersOnly);
 
+  // Calculating a CRC involves reading the whole file, so remember the CRCs
+  // that libloot calculated so that they're known when only headers are
+  // loaded.
+  if (!headersOnly) {
+    CachePluginCRCs();
+  }
+
   // Check if any plugins have been removed.
   std::vector<std::string> loadedPluginNames;
   for (auto plugin : gameHandle_->GetLoadedPlugins()) {
@@ -387,12 +797,67 @@ void Game::LoadAllInstalledPlugins(bool headersOnly) {
   AppendMessages(
       CheckForRemovedPlugins(installedPluginNames, loadedPluginNames));
 
-  pluginsFullyLoaded_ = !headersOnly;
+  ClearActiveLoadOrderIndices();
+  IncrementDerivedMetadataRevision();
+  {
+    lock_guard<mutex> guard(mutex_);
+    formIdOverlaps_.clear();
+    lightMasterValidity_.clear();
+    fullyLoadedPlugins_.clear();
+    fullyLoadedPluginsBytes_ = 0;
+    userMetadataPlugins_ = std::nullopt;
+    resolvedMetadata_ = std::nullopt;
+    conditionDependencies_ = std::nullopt;
+    masterGraph_ = std::nullopt;
+  }
+  ClearEvaluatedMetadataIfStale();
+
+  bool wereFullyLoaded = false;
+  {
+    // Read from other threads by GetMemoryUsage().
+    lock_guard<mutex> guard(mutex_);
+    wereFullyLoaded = pluginsFullyLoaded_;
+    pluginsFullyLoaded_ = !headersOnly;
+  }
+  ClearChangedPluginsDerivedMetadataJson(previousDataDirectoryEntries,
+                                         wereFullyLoaded);
+}
+
+void Game::LoadAllInstalledPluginsAndMetadata(
+    bool headersOnly,
+    bool updateMasterlist,
+    const PluginReadProgressCallback& progressCallback) {
+  // Updating and parsing the metadata lists doesn't depend on the installed
+  // plugins, so do it while the plugins are loaded.
+  auto metadataFuture =
+      std::async(std::launch::async, [this, updateMasterlist]() {
+        if (updateMasterlist) {
+          PrefetchMasterlistUpdate();
+        }
+        LoadMetadata();
+      });
+
+  LoadAllInstalledPlugins(headersOnly, progressCallback);
+
+  metadataFuture.get();
+
+  // Deriving metadata looks up every plugin's metadata, so resolve it all up
+  // front.
+  ResolveAllMetadata();
+}
+
+void Game::SetPluginReadingThreads(unsigned int threads) {
+  pluginReadingThreads_ = threads;
 }
 
 bool Game::ArePluginsFullyLoaded() const { return pluginsFullyLoaded_; }
 
 fs::path Game::MasterlistPath() const {
+  auto updatePath = MasterlistUpdatePath();
+  if (fs::exists(updatePath)) {
+    return updatePath;
+  }
+
   return lootDataPath_ / u8path(FolderName()) / "masterlist.yaml";
 }
 
@@ -404,320 +869,3120 @@ fs::path Game::PluginsTxtPath() const {
   return lootDataPath_.parent_path() / u8path(FolderName()) / "plugins.txt";
 }
 
+fs::path Game::PluginValidityCachePath() const {
+  return lootDataPath_ / u8path(FolderName()) / "plugin_validity.bin";
+}
+
+fs::path Game::GameDataSnapshotPath() const {
+  if (lootDataPath_.empty()) {
+    return fs::path();
+  }
+
+  return lootDataPath_ / u8path(FolderName()) / "game_data_snapshot.bin";
+}
+
+fs::path Game::SortResultCachePath() const {
+  if (lootDataPath_.empty()) {
+    return fs::path();
+  }
+
+  return lootDataPath_ / u8path(FolderName()) / "sort_result.bin";
+}
+
 std::vector<std::string> Game::GetLoadOrder() const {
   return gameHandle_->GetLoadOrder();
 }
 
 void Game::SetLoadOrder(const std::vector<std::string>& loadOrder) {
-  BackupLoadOrder(GetLoadOrder(), lootDataPath_ / u8path(FolderName()));
+  auto currentLoadOrder = GetLoadOrder();
+  {
+    lock_guard<mutex> guard(mutex_);
+    // If this load order was the last one set and is still current, e.g.
+    // because the same sorted load order was applied more than once in quick
+    // succession, setting it again wouldn't change anything on disk.
+    if (lastSetLoadOrder_.has_value() && lastSetLoadOrder_ == loadOrder &&
+        currentLoadOrder == loadOrder) {
+      return;
+    }
+  }
+
+  BackupLoadOrder(currentLoadOrder, lootDataPath_ / u8path(FolderName()));
   gameHandle_->SetLoadOrder(loadOrder);
+  bool wasLoadOrderStateLoaded = false;
+  {
+    lock_guard<mutex> guard(mutex_);
+    lastSetLoadOrder_ = loadOrder;
+    wasLoadOrderStateLoaded = loadOrderStateFingerprint_.has_value();
+  }
+
+  // The game handle's state now matches the files that it just wrote.
+  if (wasLoadOrderStateLoaded) {
+    RecordLoadOrderState();
+  }
+
+  auto writtenPaths = GetLoadOrderStatePaths();
+  if (hasTimestampLoadOrder(Type())) {
+    auto pluginPaths = GetPluginFilePaths(loadOrder);
+    writtenPaths.insert(
+        writtenPaths.end(), pluginPaths.begin(), pluginPaths.end());
+  }
+  RecordOwnWrites(writtenPaths);
+
+  ClearActiveLoadOrderIndices();
+  IncrementDerivedMetadataRevision();
+  ClearEvaluatedMetadataIfStale();
 }
 
 bool Game::IsPluginActive(const std::string& pluginName) const {
-  return gameHandle_->IsPluginActive(pluginName);
+  lock_guard<mutex> guard(mutex_);
+
+  return IsPluginActiveLocked(pluginName);
 }
 
 std::optional<short> Game::GetActiveLoadOrderIndex(
-    const std::shared_ptr<const PluginInterface>& plugin,
-    const std::vector<std::string>& loadOrder) const {
-  // Get the full load order, then count the number of active plugins until the
-  // given plugin is encountered. If the plugin isn't active or in the load
-  // order, return nullopt.
+    const std::shared_ptr<const PluginInterface>& plugin) const {
+  lock_guard<mutex> guard(mutex_);
 
-  if (!IsPluginActive(plugin->GetName()))
-    return std::nullopt;
+  if (!currentLoadOrderIndices_.has_value()) {
+    currentLoadOrderIndices_ =
+        GetActiveLoadOrderIndices(gameHandle_->GetLoadOrder());
+  }
 
-  short numberOfActivePlugins = 0;
-  for (const std::string& otherPluginName : loadOrder) {
-    if (CompareFilenames(plugin->GetName(), otherPluginName) == 0) {
-      return numberOfActivePlugins;
-    }
+  auto id = pluginNames_->Find(plugin->GetName());
+  if (!id.has_value()) {
+    return std::nullopt;
+  }
 
-    auto otherPlugin = GetPlugin(otherPluginName);
-    if (otherPlugin &&
-        plugin->IsLightMaster() == otherPlugin->IsLightMaster() &&
-        IsPluginActive(otherPluginName)) {
-      ++numberOfActivePlugins;
-    }
+  auto it = currentLoadOrderIndices_->indices.find(id.value());
+  if (it == currentLoadOrderIndices_->indices.end()) {
+    return std::nullopt;
   }
 
-  return std::nullopt;
+  return it->second;
 }
 
-std::vector<std::string> Game::SortPlugins() {
-  auto logger = getLogger();
+std::optional<short> Game::GetActiveLoadOrderIndex(
+    const std::shared_ptr<const PluginInterface>& plugin,
+    const std::vector<std::string>& loadOrder) const {
+  lock_guard<mutex> guard(mutex_);
 
-  try {
-    gameHandle_->LoadCurrentLoadOrderState();
-  } catch (std::exception& e) {
-    if (logger) {
-      logger->error("Failed to load current load order. Details: {}", e.what());
+  // Comparing the load order against the cached copy is much cheaper than
+  // recounting the active plugins, as that involves querying the game handle
+  // for each plugin.
+  const ActiveLoadOrderIndices* loadOrderIndices = nullptr;
+  if (currentLoadOrderIndices_.has_value() &&
+      currentLoadOrderIndices_->loadOrder == loadOrder) {
+    loadOrderIndices = &currentLoadOrderIndices_.value();
+  } else {
+    if (!otherLoadOrderIndices_.has_value() ||
+        otherLoadOrderIndices_->loadOrder != loadOrder) {
+      otherLoadOrderIndices_ = GetActiveLoadOrderIndices(loadOrder);
     }
-    AppendMessage(PlainTextMessage(
-        MessageType::error,
-        boost::locale::translate("Failed to load the current load order, "
-                                 "information displayed may be incorrect.")
-            .str()));
+    loadOrderIndices = &otherLoadOrderIndices_.value();
   }
 
-  std::vector<std::string> sortedPlugins;
-  try {
-    // Clear any existing game-specific messages, as these only relate to
-    // state that has been changed by sorting.
-    ClearMessages();
+  auto id = pluginNames_->Find(plugin->GetName());
+  if (!id.has_value()) {
+    return std::nullopt;
+  }
 
-    auto currentLoadOrder = gameHandle_->GetLoadOrder();
+  auto it = loadOrderIndices->indices.find(id.value());
+  if (it == loadOrderIndices->indices.end()) {
+    return std::nullopt;
+  }
 
-    sortedPlugins = gameHandle_->SortPlugins(currentLoadOrder);
+  return it->second;
+}
 
-    AppendMessages(CheckForRemovedPlugins(currentLoadOrder, sortedPlugins));
+std::vector<Game::FormIdOverlap> Game::GetFormIdOverlaps() const {
+  ScopedTimer timer("Game::GetFormIdOverlaps");
+
+  auto plugins = GetPlugins();
+
+  // Resolve each record's FormID to the plugin that owns it, so that records
+  // can be compared between plugins with different masters. The owner's ID
+  // goes in the high bits and the object index in the low 24 bits.
+  std::vector<std::vector<std::uint64_t>> pluginFormIds(plugins.size());
+  std::atomic<size_t> nextPlugin(0);
+  const auto scanPlugins = [&]() {
+    for (auto i = nextPlugin++; i < plugins.size(); i = nextPlugin++) {
+      const auto& plugin = plugins[i];
+      std::optional<std::vector<std::uint32_t>> formIds;
+      try {
+        formIds = MappedPluginFile(GetPluginFilePath(plugin->GetName()))
+                      .GetRecordFormIds(Type());
+      } catch (const std::exception& e) {
+        auto logger = getLogger();
+        if (logger) {
+          logger->debug("Failed to scan \"{}\". Details: {}",
+                        plugin->GetName(),
+                        e.what());
+        }
+      }
+      if (!formIds.has_value()) {
+        continue;
+      }
 
-    IncrementLoadOrderSortCount();
-  } catch (CyclicInteractionError& e) {
-    if (logger) {
-      logger->error("Failed to sort plugins. Details: {}", e.what());
+      std::vector<PluginId> ownerIds;
+      for (const auto& master : plugin->GetMasters()) {
+        ownerIds.push_back(pluginNames_->Intern(master));
+      }
+      const auto pluginId = pluginNames_->Intern(plugin->GetName());
+
+      auto& resolvedFormIds = pluginFormIds[i];
+      resolvedFormIds.reserve(formIds.value().size());
+      for (const auto formId : formIds.value()) {
+        const auto masterIndex = formId >> 24;
+        const auto ownerId =
+            masterIndex < ownerIds.size() ? ownerIds[masterIndex] : pluginId;
+        resolvedFormIds.push_back(static_cast<std::uint64_t>(ownerId) << 24 |
+                                  (formId & 0xFFFFFF));
+      }
+      std::sort(resolvedFormIds.begin(), resolvedFormIds.end());
+      resolvedFormIds.erase(
+          std::unique(resolvedFormIds.begin(), resolvedFormIds.end()),
+          resolvedFormIds.end());
     }
-    AppendMessage(Message(
-        MessageType::error,
-        (boost::format(boost::locale::translate(
-             "Cyclic interaction detected between \"%1%\" and \"%2%\": %3%")) %
-         EscapeMarkdownSpecialChars(e.GetCycle().front().GetName()) %
-         EscapeMarkdownSpecialChars(e.GetCycle().back().GetName()) %
-         DescribeCycle(e.GetCycle()))
-            .str()));
-    sortedPlugins.clear();
-  } catch (UndefinedGroupError& e) {
-    if (logger) {
-      logger->error("Failed to sort plugins. Details: {}", e.what());
+  };
+
+  const size_t threadCount =
+      std::max(size_t(1),
+               std::min(size_t(std::thread::hardware_concurrency()),
+                        plugins.size()));
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < threadCount; ++i) {
+    futures.push_back(std::async(std::launch::async, scanPlugins));
+  }
+  scanPlugins();
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  // Group each FormID with the plugins that have it, so that each FormID is
+  // compared once instead of once per pair of plugins.
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> formIdPlugins;
+  size_t formIdCount = 0;
+  for (const auto& formIds : pluginFormIds) {
+    formIdCount += formIds.size();
+  }
+  formIdPlugins.reserve(formIdCount);
+  for (size_t i = 0; i < pluginFormIds.size(); ++i) {
+    for (const auto formId : pluginFormIds[i]) {
+      formIdPlugins.emplace_back(formId, static_cast<std::uint32_t>(i));
     }
-    AppendMessage(PlainTextMessage(MessageType::error,
-                                   (boost::format(boost::locale::translate(
-                                        "The group \"%1%\" does not exist.")) %
-                                    e.GetGroupName())
-                                       .str()));
-    sortedPlugins.clear();
-  } catch (std::exception& e) {
-    if (logger) {
-      logger->error("Failed to sort plugins. Details: {}", e.what());
+    // Free each plugin's FormIDs as soon as they've been copied.
+    std::vector<std::uint64_t>().swap(pluginFormIds[i]);
+  }
+  std::sort(formIdPlugins.begin(), formIdPlugins.end());
+
+  // Keyed by the two plugins' positions in load order.
+  std::unordered_map<std::uint64_t, size_t> overlapCounts;
+  for (size_t first = 0; first < formIdPlugins.size();) {
+    auto last = first + 1;
+    while (last < formIdPlugins.size() &&
+           formIdPlugins[last].first == formIdPlugins[first].first) {
+      ++last;
     }
-    sortedPlugins.clear();
+
+    // The plugins are in load order within each run, as they're sorted.
+    for (auto i = first; i < last; ++i) {
+      for (auto j = i + 1; j < last; ++j) {
+        const auto pairKey =
+            static_cast<std::uint64_t>(formIdPlugins[i].second) << 32 |
+            formIdPlugins[j].second;
+        ++overlapCounts[pairKey];
+      }
+    }
+
+    first = last;
+  }
+
+  std::vector<std::pair<std::uint64_t, size_t>> sortedCounts(
+      overlapCounts.cbegin(), overlapCounts.cend());
+  std::sort(sortedCounts.begin(), sortedCounts.end());
+
+  std::vector<FormIdOverlap> overlaps;
+  overlaps.reserve(sortedCounts.size());
+  for (const auto& count : sortedCounts) {
+    const auto& plugin = plugins[count.first >> 32];
+    const auto& otherPlugin = plugins[count.first & 0xFFFFFFFF];
+    overlaps.push_back(
+        FormIdOverlap{plugin->GetName(), otherPlugin->GetName(), count.second});
+  }
+
+  return overlaps;
+}
+
+bool Game::DoFormIDsOverlap(
+    const std::shared_ptr<const PluginInterface>& plugin,
+    const std::shared_ptr<const PluginInterface>& otherPlugin) const {
+  std::uint64_t id = pluginNames_->Intern(plugin->GetName());
+  std::uint64_t otherId = pluginNames_->Intern(otherPlugin->GetName());
+  auto key = id < otherId ? (id << 32) | otherId : (otherId << 32) | id;
+
+  {
+    lock_guard<mutex> guard(mutex_);
+    auto it = formIdOverlaps_.find(key);
+    if (it != formIdOverlaps_.end()) {
+      return it->second;
+    }
+  }
+
+  bool overlap = false;
+  if (pluginsFullyLoaded_) {
+    overlap = plugin->DoFormIDsOverlap(*otherPlugin);
+  } else if (MayFormIDsOverlap(*plugin, *otherPlugin)) {
+    auto fullPlugins =
+        GetFullyLoadedPlugins({plugin->GetName(), otherPlugin->GetName()});
+    overlap = fullPlugins[0] && fullPlugins[1] &&
+              fullPlugins[0]->DoFormIDsOverlap(*fullPlugins[1]);
+  }
+
+  lock_guard<mutex> guard(mutex_);
+  formIdOverlaps_.emplace(key, overlap);
+
+  return overlap;
+}
+
+void Game::LoadFormIDsOfPossibleOverlaps(const std::string& pluginName) const {
+  if (pluginsFullyLoaded_) {
+    return;
+  }
+
+  auto plugin = GetPlugin(pluginName);
+  if (!plugin) {
+    return;
+  }
+
+  std::vector<std::string> pluginNames{plugin->GetName()};
+  for (const auto& otherPlugin : GetPlugins()) {
+    if (otherPlugin != plugin && MayFormIDsOverlap(*plugin, *otherPlugin)) {
+      pluginNames.push_back(otherPlugin->GetName());
+    }
+  }
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Loading the FormIDs of {} plugins that may overlap {}",
+                  pluginNames.size(),
+                  pluginName);
+  }
+
+  GetFullyLoadedPlugins(pluginNames);
+}
+
+bool Game::MayFormIDsOverlap(const PluginInterface& plugin,
+                             const PluginInterface& otherPlugin) const {
+  // Morrowind records are identified by their IDs, which aren't tied to the
+  // plugin that first defined them.
+  if (Type() == GameType::tes3) {
+    return true;
+  }
+
+  // A FormID belongs to the plugin that first defined its record, which must
+  // be the plugin itself or one of its masters.
+  auto origins = plugin.GetMasters();
+  origins.push_back(plugin.GetName());
+
+  auto otherOrigins = otherPlugin.GetMasters();
+  otherOrigins.push_back(otherPlugin.GetName());
+
+  for (const auto& origin : origins) {
+    for (const auto& otherOrigin : otherOrigins) {
+      if (CompareFilenames(origin, otherOrigin) == 0) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+std::vector<std::shared_ptr<const PluginInterface>> Game::GetFullyLoadedPlugins(
+    const std::vector<std::string>& pluginNames) const {
+  lock_guard<mutex> loadGuard(fullLoadMutex_);
+
+  std::vector<PluginId> ids;
+  std::vector<std::string> unloadedPluginNames;
+  {
+    lock_guard<mutex> guard(mutex_);
+    ++fullyLoadedPluginsUseCount_;
+    for (const auto& pluginName : pluginNames) {
+      auto id = pluginNames_->Intern(pluginName);
+      ids.push_back(id);
+
+      auto it = fullyLoadedPlugins_.find(id);
+      if (it == fullyLoadedPlugins_.end()) {
+        unloadedPluginNames.push_back(pluginName);
+      } else {
+        it->second.lastUsed = fullyLoadedPluginsUseCount_;
+      }
+    }
+  }
+
+  if (!unloadedPluginNames.empty()) {
+    ScopedTimer timer("Game::GetFullyLoadedPlugins");
+
+    // Loading plugins into the game handle would replace their headers, so
+    // use a temporary handle that's only kept alive by the plugins it loaded.
+    // libloot loads the plugins in parallel.
+    ReadAheadPluginFiles(unloadedPluginNames);
+    auto handle = CreateGameHandle(Type(), GamePath(), GameLocalPath());
+    handle->IdentifyMainMasterFile(Master());
+    handle->LoadPlugins(unloadedPluginNames, false);
+
+    std::vector<FullyLoadedPlugin> loadedPlugins;
+    for (const auto& pluginName : unloadedPluginNames) {
+      auto plugin = handle->GetPlugin(pluginName);
+      if (plugin) {
+        loadedPlugins.push_back(
+            {plugin, GetEstimatedFormIdBytes(pluginName), 0});
+      }
+    }
+
+    lock_guard<mutex> guard(mutex_);
+    for (auto& loadedPlugin : loadedPlugins) {
+      auto id = pluginNames_->Intern(loadedPlugin.plugin->GetName());
+      loadedPlugin.lastUsed = fullyLoadedPluginsUseCount_;
+      fullyLoadedPluginsBytes_ += loadedPlugin.estimatedBytes;
+      fullyLoadedPlugins_.emplace(id, std::move(loadedPlugin));
+    }
+
+    // Plugins that were just used are never evicted, so the budget may be
+    // exceeded if they don't fit in it.
+    EvictFullyLoadedPluginsLocked(FULLY_LOADED_PLUGINS_BUDGET_BYTES,
+                                  fullyLoadedPluginsUseCount_);
+  }
+
+  std::vector<std::shared_ptr<const PluginInterface>> plugins;
+  lock_guard<mutex> guard(mutex_);
+  for (const auto id : ids) {
+    auto it = fullyLoadedPlugins_.find(id);
+    plugins.push_back(it == fullyLoadedPlugins_.end() ? nullptr
+                                                      : it->second.plugin);
+  }
+
+  return plugins;
+}
+
+bool Game::IsValidAsLightMaster(const PluginInterface& plugin) const {
+  if (pluginsFullyLoaded_) {
+    return plugin.IsValidAsLightMaster();
+  }
+
+  // Plugins that have only had their headers loaded have no records, so
+  // libloot would always say that they're valid.
+  auto id = pluginNames_->Intern(plugin.GetName());
+  {
+    lock_guard<mutex> guard(mutex_);
+    auto it = lightMasterValidity_.find(id);
+    if (it != lightMasterValidity_.end()) {
+      return it->second;
+    }
+
+    auto fullyLoadedIt = fullyLoadedPlugins_.find(id);
+    if (fullyLoadedIt != fullyLoadedPlugins_.end()) {
+      auto isValid = fullyLoadedIt->second.plugin->IsValidAsLightMaster();
+      lightMasterValidity_.emplace(id, isValid);
+      return isValid;
+    }
+  }
+
+  // Scanning the mapped file's record headers avoids reading the plugin's
+  // records into memory, and only falls back to fully loading the plugin if
+  // the file can't be scanned.
+  std::optional<bool> isValid;
+  try {
+    MappedPluginFile file(GetPluginFilePath(plugin.GetName()));
+    isValid = file.IsValidAsLightMaster(Type(), plugin.GetMasters().size());
+  } catch (const std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn("Failed to map \"{}\" to scan its records. Details: {}",
+                   plugin.GetName(),
+                   e.what());
+    }
+  }
+
+  if (!isValid.has_value()) {
+    auto fullPlugin = GetFullyLoadedPlugins({plugin.GetName()})[0];
+    isValid = !fullPlugin || fullPlugin->IsValidAsLightMaster();
+  }
+
+  lock_guard<mutex> guard(mutex_);
+  lightMasterValidity_.emplace(id, isValid.value());
+
+  return isValid.value();
+}
+
+unsigned int Game::GetDerivedMetadataRevision() const {
+  lock_guard<mutex> guard(mutex_);
+
+  return derivedMetadataRevision_;
+}
+
+PluginFingerprint Game::GetPluginFingerprint(
+    const std::shared_ptr<const PluginInterface>& plugin) const {
+  PluginFingerprint fingerprint;
+  fingerprint.crc = GetPluginCRC(plugin);
+  fingerprint.isActive = IsPluginActive(plugin->GetName());
+
+  auto filePath = DataPath() / u8path(plugin->GetName());
+  if (!DataFileExists(plugin->GetName())) {
+    filePath += ".ghost";
+  }
+
+  std::error_code errorCode;
+  auto fileSize = fs::file_size(filePath, errorCode);
+  if (!errorCode) {
+    fingerprint.fileSize = fileSize;
+  }
+
+  auto modificationTime = fs::last_write_time(filePath, errorCode);
+  if (!errorCode) {
+    fingerprint.modificationTime = modificationTime;
+  }
+
+  return fingerprint;
+}
+
+std::unordered_map<std::string, PluginFingerprint>
+Game::GetDerivedPluginFingerprints() const {
+  lock_guard<mutex> guard(mutex_);
+
+  return derivedPluginFingerprints_;
+}
+
+std::optional<std::string> Game::GetDerivedMetadataJson(
+    const std::string& pluginName,
+    const std::string& language,
+    bool isActive,
+    std::optional<short> loadOrderIndex) const {
+  auto id = pluginNames_->Find(pluginName);
+  if (!id.has_value()) {
+    return std::nullopt;
+  }
+
+  lock_guard<mutex> guard(mutex_);
+
+  auto it = derivedMetadataJson_.find(id.value());
+  if (it == derivedMetadataJson_.end() || it->second.language != language ||
+      it->second.isActive != isActive ||
+      it->second.loadOrderIndex != loadOrderIndex) {
+    return std::nullopt;
+  }
+
+  return it->second.json;
+}
+
+void Game::SetDerivedMetadataJson(const std::string& pluginName,
+                                  const std::string& language,
+                                  bool isActive,
+                                  std::optional<short> loadOrderIndex,
+                                  bool dependsOnOtherFiles,
+                                  std::string json) {
+  auto id = pluginNames_->Intern(pluginName);
+
+  lock_guard<mutex> guard(mutex_);
+
+  derivedMetadataJson_.insert_or_assign(id,
+                                        DerivedMetadataJson{language,
+                                                            isActive,
+                                                            loadOrderIndex,
+                                                            dependsOnOtherFiles,
+                                                            std::move(json)});
+}
+
+void Game::SetDerivedPluginFingerprints(
+    const std::unordered_map<std::string, PluginFingerprint>& fingerprints) {
+  lock_guard<mutex> guard(mutex_);
+
+  derivedPluginFingerprints_ = fingerprints;
+}
+
+std::vector<std::string> Game::SortPlugins() {
+  ScopedTimer timer("Game::SortPlugins");
+  ScopedLogSummary logSummary("sorting plugins");
+  auto logger = getLogger();
+  SortProfile profile;
+
+  {
+    SortStageTimer stageTimer("Game::SortPlugins::LoadCurrentLoadOrderState",
+                              "loadLoadOrderState",
+                              profile);
+    // The load order state is only reloaded if its files or the installed
+    // plugins have changed since it was last loaded, which the file watcher
+    // otherwise picks up.
+    bool reloaded = true;
+    try {
+      reloaded = ReloadLoadOrderStateIfChanged();
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->error("Failed to load current load order. Details: {}",
+                      e.what());
+      }
+      AppendMessage(PlainTextMessage(
+          MessageType::error,
+          boost::locale::translate("Failed to load the current load order, "
+                                   "information displayed may be incorrect.")
+              .str()));
+    }
+
+    // Loading the current load order state may have changed which plugins
+    // are active.
+    if (reloaded) {
+      ClearActiveLoadOrderIndices();
+      IncrementDerivedMetadataRevision();
+      ClearEvaluatedMetadataIfStale();
+    }
+  }
+
+  std::vector<std::string> sortedPlugins;
+  try {
+    // Clear any existing game-specific messages, as these only relate to
+    // state that has been changed by sorting.
+    ClearMessages();
+
+    auto currentLoadOrder = gameHandle_->GetLoadOrder();
+    profile.pluginCount = currentLoadOrder.size();
+
+    // If nothing that sorting depends on has changed since the last sort,
+    // its result is still valid.
+    SortInputs sortInputs;
+    std::optional<SortResult> lastSortResult;
+    std::optional<std::vector<std::string>> persistedSortedPlugins;
+    {
+      SortStageTimer stageTimer(
+          "Game::SortPlugins::GetSortInputs", "checkSortInputs", profile);
+      sortInputs = GetSortInputs(currentLoadOrder);
+      {
+        lock_guard<mutex> guard(mutex_);
+        lastSortResult = lastSortResult_;
+      }
+
+      // An earlier session may have sorted the same inputs.
+      if (!lastSortResult.has_value() ||
+          !lastSortResult->inputs.Matches(sortInputs)) {
+        persistedSortedPlugins = LoadPersistedSortResult(sortInputs);
+      }
+    }
+    if (lastSortResult.has_value() &&
+        lastSortResult->inputs.Matches(sortInputs)) {
+      if (logger) {
+        logger->info("Sorting inputs are unchanged, reusing the last result.");
+      }
+      AppendMessages(lastSortResult->messages);
+      IncrementLoadOrderSortCount();
+
+      auto stages = profile.stages;
+      profile = lastSortResult->profile;
+      profile.stages = stages;
+      profile.reusedLastResult = true;
+      SetLastSortProfile(profile);
+
+      return lastSortResult->sortedPlugins;
+    }
+
+    if (persistedSortedPlugins.has_value()) {
+      if (logger) {
+        logger->info(
+            "Sorting inputs are unchanged since an earlier session, reusing "
+            "its result.");
+      }
+      sortedPlugins = std::move(persistedSortedPlugins.value());
+      profile.reusedLastResult = true;
+    } else {
+      {
+        SortStageTimer stageTimer("Game::SortPlugins::LoadAndSortPlugins",
+                                  "loadAndSortPlugins",
+                                  profile);
+        sortedPlugins = gameHandle_->SortPlugins(currentLoadOrder);
+      }
+      PersistSortResult(sortInputs, sortedPlugins);
+    }
+
+    std::vector<Message> messages;
+    {
+      SortStageTimer stageTimer("Game::SortPlugins::CheckForRemovedPlugins",
+                                "checkForRemovedPlugins",
+                                profile);
+      auto diff = DiffPluginLists(currentLoadOrder, sortedPlugins);
+      if (logger) {
+        logger->info("Sorting moves {} of {} plugins.",
+                     diff.moved.size(),
+                     sortedPlugins.size());
+      }
+      profile.movedPluginCount = diff.moved.size();
+
+      messages = CheckForRemovedPlugins(diff);
+    }
+    AppendMessages(messages);
+
+    IncrementLoadOrderSortCount();
+
+    {
+      SortStageTimer stageTimer(
+          "Game::SortPlugins::CountSortEdges", "countEdges", profile);
+      CountSortEdges(sortedPlugins, profile);
+    }
+    SetLastSortProfile(profile);
+
+    lock_guard<mutex> guard(mutex_);
+    lastSortResult_ = SortResult{sortInputs, sortedPlugins, messages, profile};
+  } catch (CyclicInteractionError& e) {
+    if (logger) {
+      logger->error("Failed to sort plugins. Details: {}", e.what());
+    }
+    AppendMessage(Message(
+        MessageType::error,
+        (boost::format(boost::locale::translate(
+             "Cyclic interaction detected between \"%1%\" and \"%2%\": %3%")) %
+         EscapeMarkdownSpecialChars(e.GetCycle().front().GetName()) %
+         EscapeMarkdownSpecialChars(e.GetCycle().back().GetName()) %
+         DescribeCycle(e.GetCycle()))
+            .str()));
+    sortedPlugins.clear();
+    SetLastSortProfile(profile);
+  } catch (UndefinedGroupError& e) {
+    if (logger) {
+      logger->error("Failed to sort plugins. Details: {}", e.what());
+    }
+    AppendMessage(PlainTextMessage(MessageType::error,
+                                   (boost::format(boost::locale::translate(
+                                        "The group \"%1%\" does not exist.")) %
+                                    e.GetGroupName())
+                                       .str()));
+    sortedPlugins.clear();
+    SetLastSortProfile(profile);
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error("Failed to sort plugins. Details: {}", e.what());
+    }
+    sortedPlugins.clear();
+    SetLastSortProfile(profile);
   }
 
   return sortedPlugins;
 }
 
-void Game::IncrementLoadOrderSortCount() {
+std::optional<SortProfile> Game::GetLastSortProfile() const {
+  lock_guard<mutex> guard(mutex_);
+
+  return lastSortProfile_;
+}
+
+bool Game::PrecomputeSortResult() {
+  ScopedTimer timer("Game::PrecomputeSortResult");
+  auto logger = getLogger();
+
+  try {
+    if (ReloadLoadOrderStateIfChanged()) {
+      ClearActiveLoadOrderIndices();
+      IncrementDerivedMetadataRevision();
+      ClearEvaluatedMetadataIfStale();
+    }
+
+    auto currentLoadOrder = gameHandle_->GetLoadOrder();
+    auto sortInputs = GetSortInputs(currentLoadOrder);
+    {
+      lock_guard<mutex> guard(mutex_);
+      if (lastSortResult_.has_value() &&
+          lastSortResult_->inputs.Matches(sortInputs)) {
+        return true;
+      }
+    }
+
+    auto sortedPlugins = LoadPersistedSortResult(sortInputs);
+    if (!sortedPlugins.has_value()) {
+      if (logger) {
+        logger->debug("Sorting plugins in the background.");
+      }
+
+      sortedPlugins = gameHandle_->SortPlugins(currentLoadOrder);
+      PersistSortResult(sortInputs, sortedPlugins.value());
+    }
+    auto diff = DiffPluginLists(currentLoadOrder, sortedPlugins.value());
+    auto messages = CheckForRemovedPlugins(diff);
+
+    // The profile's stages are those of the SortPlugins() call that reuses
+    // this result, so only the counts are needed.
+    SortProfile profile;
+    profile.pluginCount = currentLoadOrder.size();
+    profile.movedPluginCount = diff.moved.size();
+    CountSortEdges(sortedPlugins.value(), profile);
+
+    lock_guard<mutex> guard(mutex_);
+    lastSortResult_ =
+        SortResult{sortInputs, sortedPlugins.value(), messages, profile};
+
+    return true;
+  } catch (std::exception& e) {
+    // Any error will happen again when the plugins are next sorted, and be
+    // reported then.
+    if (logger) {
+      logger->debug("Failed to sort plugins in the background. Details: {}",
+                    e.what());
+    }
+    return false;
+  }
+}
+
+void Game::IncrementLoadOrderSortCount() {
+  lock_guard<mutex> guard(mutex_);
+
+  ++loadOrderSortCount_;
+}
+
+void Game::DecrementLoadOrderSortCount() {
+  lock_guard<mutex> guard(mutex_);
+
+  if (loadOrderSortCount_ > 0)
+    --loadOrderSortCount_;
+}
+
+std::vector<Message> Game::GetMessages() const {
+  lock_guard<mutex> guard(mutex_);
+
+  return GetMessagesLocked();
+}
+
+std::vector<SimpleMessage> Game::GetSimpleMessages(
+    const std::string& language) const {
+  lock_guard<mutex> guard(mutex_);
+
+  const bool loadOrderSorted = loadOrderSortCount_ != 0;
+  if (simpleMessages_.has_value() && simpleMessages_->language == language &&
+      simpleMessages_->messagesRevision == messagesRevision_ &&
+      simpleMessages_->derivedMetadataRevision == derivedMetadataRevision_ &&
+      simpleMessages_->loadOrderSorted == loadOrderSorted) {
+    return simpleMessages_->messages;
+  }
+
+  const auto messages = GetMessagesLocked();
+
+  std::vector<SimpleMessage> simpleMessages;
+  simpleMessages.reserve(messages.size());
+  for (const auto& message : messages) {
+    simpleMessages.push_back(message.ToSimpleMessage(language));
+  }
+
+  simpleMessages_ = SimpleMessages{language,
+                                   messagesRevision_,
+                                   derivedMetadataRevision_,
+                                   loadOrderSorted,
+                                   simpleMessages};
+
+  return simpleMessages;
+}
+
+void Game::AppendMessage(const Message& message) {
+  lock_guard<mutex> guard(mutex_);
+
+  messages_.push_back(message);
+  ++messagesRevision_;
+}
+
+void Game::ClearMessages() {
+  lock_guard<mutex> guard(mutex_);
+
+  messages_.clear();
+  ++messagesRevision_;
+}
+
+bool Game::UpdateMasterlist() {
+  ScopedTimer timer("Game::UpdateMasterlist");
+  ScopedLogSummary logSummary("updating the masterlist");
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (prefetchedMasterlistUpdate_.has_value()) {
+      auto wasUpdated = prefetchedMasterlistUpdate_.value();
+      prefetchedMasterlistUpdate_ = std::nullopt;
+      return wasUpdated;
+    }
+  }
+
+  return UpdateMasterlistFromRemote();
+}
+
+void Game::PrefetchMasterlistUpdate() {
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Updating masterlist in the background.");
+  }
+
+  try {
+    auto wasUpdated = UpdateMasterlistFromRemote();
+
+    lock_guard<mutex> guard(mutex_);
+    prefetchedMasterlistUpdate_ = wasUpdated;
+  } catch (std::exception& e) {
+    // The update will be tried again the next time the masterlist is
+    // updated, so that the error is reported then.
+    if (logger) {
+      logger->error("Failed to update the masterlist in the background: {}",
+                    e.what());
+    }
+  }
+}
+
+bool Game::UpdateMasterlistFromRemote() {
+  const auto masterlistPath = MasterlistUpdatePath();
+  const auto previousMasterlistPath = MasterlistPath();
+
+  bool wasUpdated = false;
+  {
+    auto updateMutex = getMasterlistUpdateMutex(masterlistPath);
+    lock_guard<mutex> updateGuard(*updateMutex);
+
+    fs::create_directories(masterlistPath.parent_path());
+    wasUpdated = gameHandle_->GetDatabase()->UpdateMasterlist(
+        masterlistPath, RepoURL(), RepoBranch());
+  }
+
+  if (wasUpdated) {
+    ClearGroupIndex();
+  }
+
+  if (!wasUpdated) {
+    // Another game that shares the masterlist may have updated it since this
+    // game loaded it, or this game may have been using its own masterlist
+    // until now, so check if the loaded masterlist is still current.
+    std::optional<fs::file_time_type> loadedMasterlistTime;
+    {
+      lock_guard<mutex> guard(mutex_);
+      loadedMasterlistTime = metadataListTimes_.first;
+    }
+
+    if (masterlistPath != previousMasterlistPath ||
+        GetMetadataListTimes().first != loadedMasterlistTime) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->debug(
+            "The masterlist has changed since it was loaded, loading it "
+            "again.");
+      }
+      LoadMetadata();
+      return true;
+    }
+  }
+
+  if (wasUpdated) {
+    ClearDerivedPluginFingerprints();
+    IncrementMetadataRevision();
+
+    auto metadataListTimes = GetMetadataListTimes();
+    lock_guard<mutex> guard(mutex_);
+    metadataListTimes_.first = metadataListTimes.first;
+    resolvedMetadata_ = std::nullopt;
+
+    // libloot loads the updated masterlist into the database.
+    if (loadedMetadataListPaths_.has_value()) {
+      loadedMetadataListPaths_->first = masterlistPath;
+    }
+  }
+  if (wasUpdated && !gameHandle_->GetDatabase()->IsLatestMasterlist(
+                        masterlistPath, RepoBranch())) {
+    AppendMessage(PlainTextMessage(
+        MessageType::error,
+        boost::locale::translate(
+            "The latest masterlist revision contains a syntax error, LOOT is "
+            "using the most recent valid revision instead. Syntax errors are "
+            "usually minor and fixed within hours.")));
+  }
+
+  return wasUpdated;
+}
+
+fs::path Game::MasterlistUpdatePath() const {
+  if (lootDataPath_.empty() || RepoURL().empty()) {
+    return lootDataPath_ / u8path(FolderName()) / "masterlist.yaml";
+  }
+
+  return lootDataPath_ / "masterlists" /
+         getMasterlistDirectoryName(RepoURL(), RepoBranch()) /
+         "masterlist.yaml";
+}
+
+MasterlistInfo Game::GetMasterlistInfo() const {
+  return gameHandle_->GetDatabase()->GetMasterlistRevision(MasterlistPath(),
+                                                           true);
+}
+
+void Game::LoadMetadata() {
+  ScopedTimer timer("Game::LoadMetadata");
+  ScopedLogSummary logSummary("loading metadata");
+  auto logger = getLogger();
+
+  std::filesystem::path masterlistPath;
+  std::filesystem::path userlistPath;
+  if (std::filesystem::exists(MasterlistPath())) {
+    if (logger) {
+      logger->debug("Preparing to parse masterlist.");
+    }
+    masterlistPath = MasterlistPath();
+  }
+
+  if (std::filesystem::exists(UserlistPath())) {
+    if (logger) {
+      logger->debug("Preparing to parse userlist.");
+    }
+    userlistPath = UserlistPath();
+  }
+
+  // Parsing the masterlist is slow, so don't parse the lists again if the
+  // database already holds them and they haven't changed since.
+  const auto metadataListPaths = std::make_pair(masterlistPath, userlistPath);
+  auto metadataListTimes = GetMetadataListTimes();
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (loadedMetadataListPaths_ == metadataListPaths &&
+        metadataListTimes == metadataListTimes_ && !metadataListsStale_) {
+      if (logger) {
+        logger->debug(
+            "The metadata list(s) haven't changed since they were parsed, "
+            "skipping parsing.");
+      }
+      return;
+    }
+  }
+
+  if (logger) {
+    logger->debug("Parsing metadata list(s).");
+  }
+  ClearDerivedPluginFingerprints();
+  IncrementMetadataRevision();
+  {
+    lock_guard<mutex> guard(mutex_);
+    metadataListTimes_ = metadataListTimes;
+    metadataListsStale_ = false;
+    loadedMetadataListPaths_ = std::nullopt;
+    userMetadataPlugins_ = std::nullopt;
+    resolvedMetadata_ = std::nullopt;
+  }
+  try {
+    {
+      lock_guard<mutex> userlistGuard(userlistMutex_);
+      gameHandle_->GetDatabase()->LoadLists(masterlistPath, userlistPath);
+    }
+
+    lock_guard<mutex> guard(mutex_);
+    loadedMetadataListPaths_ = metadataListPaths;
+    // Metadata may have been resolved from the old lists while they were
+    // being replaced.
+    resolvedMetadata_ = std::nullopt;
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error("An error occurred while parsing the metadata list(s): {}",
+                    e.what());
+    }
+    AppendMessage(Message(
+        MessageType::error,
+        (boost::format(boost::locale::translate(
+             "An error occurred while parsing the metadata list(s): "
+             "%1%.\n\nTry updating your masterlist to resolve the error. If "
+             "the error is with your user metadata, this probably happened "
+             "because an update to LOOT changed its metadata syntax support. "
+             "Your user metadata will have to be updated manually.\n\nTo do "
+             "so, use the 'Open Debug Log Location' in LOOT's main menu to "
+             "open its data folder, then open your 'userlist.yaml' file in the "
+             "relevant game folder. You can then edit the metadata it contains "
+             "with reference to the documentation, which is accessible through "
+             "LOOT's main menu.\n\nYou can also seek support on LOOT's forum "
+             "thread, which is linked to on [LOOT's "
+             "website](https://loot.github.io/).")) %
+         EscapeMarkdownSpecialChars(e.what()))
+            .str()));
+  }
+
+  ClearGroupIndex();
+}
+
+bool Game::AreMetadataListsStale() const {
+  lock_guard<mutex> guard(mutex_);
+  return metadataListsStale_;
+}
+
+std::set<std::string> Game::GetKnownBashTags() const {
+  return gameHandle_->GetDatabase()->GetKnownBashTags();
+}
+
+std::shared_ptr<const BashTagTable> Game::GetBashTagTable() const {
+  return GetGroupIndex()->bashTagTable;
+}
+
+bool Game::GroupExists(const std::string& groupName) const {
+  return GetGroupIndex()->names.count(groupName) != 0;
+}
+
+std::unordered_set<Group> Game::GetMasterlistGroups() const {
+  return GetGroupIndex()->masterlistGroups;
+}
+
+std::unordered_set<Group> Game::GetUserGroups() const {
+  return GetGroupIndex()->userGroups;
+}
+
+std::optional<PluginMetadata> Game::GetMasterlistMetadata(
+    const std::string& pluginName,
+    bool evaluateConditions) const {
+  if (!evaluateConditions) {
+    lock_guard<mutex> guard(mutex_);
+    return GetResolvedMetadataLocked(pluginName).masterlist;
+  }
+
+  // Condition evaluation isn't thread-safe, as it caches results.
+  lock_guard<mutex> guard(mutex_);
+
+  auto key = pluginNames_->Intern(pluginName);
+  auto it = evaluatedMasterlistMetadata_.find(key);
+  if (it != evaluatedMasterlistMetadata_.end()) {
+    return it->second;
+  }
+
+  auto metadata =
+      gameHandle_->GetDatabase()->GetPluginMetadata(pluginName, false, true);
+  evaluatedMasterlistMetadata_.emplace(key, metadata);
+
+  return metadata;
+}
+
+std::optional<PluginMetadata> Game::GetUserMetadata(
+    const std::string& pluginName,
+    bool evaluateConditions) const {
+  if (!evaluateConditions) {
+    lock_guard<mutex> guard(mutex_);
+    return GetResolvedMetadataLocked(pluginName).user;
+  }
+
+  lock_guard<mutex> guard(mutex_);
+
+  auto key = pluginNames_->Intern(pluginName);
+  auto it = evaluatedUserMetadata_.find(key);
+  if (it != evaluatedUserMetadata_.end()) {
+    return it->second;
+  }
+
+  auto metadata =
+      gameHandle_->GetDatabase()->GetPluginUserMetadata(pluginName, true);
+  evaluatedUserMetadata_.emplace(key, metadata);
+
+  return metadata;
+}
+
+void Game::ResolveAllMetadata() const {
+  lock_guard<mutex> guard(mutex_);
+
+  ResolveAllMetadataLocked();
+}
+
+std::vector<std::string> Game::GetPluginsWithUserMetadata() const {
+  lock_guard<mutex> guard(mutex_);
+
+  // libloot can't list the plugins that have user metadata, so check each
+  // loaded plugin once and then keep the index up to date as user metadata
+  // is changed.
+  if (!userMetadataPlugins_.has_value()) {
+    std::unordered_set<PluginId> userMetadataPlugins;
+    for (const auto& plugin : gameHandle_->GetLoadedPlugins()) {
+      if (GetResolvedMetadataLocked(plugin->GetName()).user.has_value()) {
+        userMetadataPlugins.insert(pluginNames_->Intern(plugin->GetName()));
+      }
+    }
+    userMetadataPlugins_ = std::move(userMetadataPlugins);
+  }
+
+  std::vector<std::string> pluginNames;
+  pluginNames.reserve(userMetadataPlugins_->size());
+  for (const auto id : userMetadataPlugins_.value()) {
+    pluginNames.push_back(pluginNames_->GetName(id));
+  }
+
+  return pluginNames;
+}
+
+void Game::SetUserGroups(const std::unordered_set<Group>& groups) {
+  // Plugins' install validity depends on which groups exist.
+  ClearDerivedPluginFingerprints();
+  IncrementMetadataRevision();
+  RecordUserMetadataEdit();
+
+  {
+    lock_guard<mutex> userlistGuard(userlistMutex_);
+    gameHandle_->GetDatabase()->SetUserGroups(groups);
+  }
+  ClearGroupIndex();
+}
+
+void Game::AddUserMetadata(const PluginMetadata& metadata) {
+  ClearDerivedPluginFingerprint(metadata.GetName());
+  IncrementMetadataRevision();
+  RecordUserMetadataEdit();
+
+  {
+    lock_guard<mutex> userlistGuard(userlistMutex_);
+    gameHandle_->GetDatabase()->SetPluginUserMetadata(metadata);
+  }
+  DiscardResolvedMetadata(metadata.GetName());
+  UpdateUserMetadataIndex(metadata.GetName());
+}
+
+void Game::ClearUserMetadata(const std::string& pluginName) {
+  ClearDerivedPluginFingerprint(pluginName);
+  IncrementMetadataRevision();
+  RecordUserMetadataEdit();
+
+  {
+    lock_guard<mutex> userlistGuard(userlistMutex_);
+    gameHandle_->GetDatabase()->DiscardPluginUserMetadata(pluginName);
+  }
+  DiscardResolvedMetadata(pluginName);
+  UpdateUserMetadataIndex(pluginName);
+}
+
+void Game::ClearAllUserMetadata() {
+  ClearDerivedPluginFingerprints();
+  IncrementMetadataRevision();
+  RecordUserMetadataEdit();
+
+  {
+    lock_guard<mutex> userlistGuard(userlistMutex_);
+    gameHandle_->GetDatabase()->DiscardAllUserMetadata();
+  }
+
+  lock_guard<mutex> guard(mutex_);
+  userMetadataPlugins_ = std::unordered_set<PluginId>();
+  resolvedMetadata_ = std::nullopt;
+}
+
+void Game::ReplaceUserMetadata(const PluginMetadata& metadata) {
+  auto database = gameHandle_->GetDatabase();
+  auto oldMetadata = database->GetPluginUserMetadata(metadata.GetName());
+
+  ClearDerivedPluginFingerprint(metadata.GetName());
+  RecordUserMetadataEdit();
+
+  {
+    lock_guard<mutex> userlistGuard(userlistMutex_);
+    database->DiscardPluginUserMetadata(metadata.GetName());
+    if (!metadata.HasNameOnly()) {
+      database->SetPluginUserMetadata(metadata);
+    }
+  }
+  DiscardResolvedMetadata(metadata.GetName());
+  UpdateUserMetadataIndex(metadata.GetName());
+
+  lock_guard<mutex> guard(mutex_);
+
+  // If the last sort result was up to date before the edit and is still
+  // valid, carry it forward to the new metadata revision.
+  const bool isLastSortResultCurrent =
+      lastSortResult_.has_value() &&
+      lastSortResult_->inputs.metadataRevision == metadataRevision_;
+
+  ++metadataRevision_;
+
+  if (isLastSortResultCurrent &&
+      isSortedLoadOrderValidAfterEdit(
+          lastSortResult_->sortedPlugins, oldMetadata, metadata)) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug(
+          "The last sorted load order is still valid after editing the user "
+          "metadata for \"{}\".",
+          metadata.GetName());
+    }
+    lastSortResult_->inputs.metadataRevision = metadataRevision_;
+  }
+}
+
+void Game::SaveUserMetadata() {
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (isUserMetadataTransactionOpen_) {
+      userMetadataSaveRequested_ = true;
+      return;
+    }
+
+    if (userMetadataSaveInterval_.has_value()) {
+      if (!userMetadataSaveTask_) {
+        userMetadataSaveTask_ = std::make_unique<DebouncedTask>(
+            userMetadataSaveInterval_.value(),
+            [this]() { WriteDeferredUserMetadata(); });
+      }
+      userMetadataSaveTask_->Schedule();
+      return;
+    }
+  }
+
+  WriteUserMetadata();
+}
+
+void Game::EnableDeferredUserMetadataSaves(
+    std::chrono::milliseconds debounceInterval) {
+  FlushUserMetadata();
+
+  lock_guard<mutex> guard(mutex_);
+  userMetadataSaveTask_.reset();
+  userMetadataSaveInterval_ = debounceInterval;
+}
+
+void Game::FlushUserMetadata() {
+  // The task is only destroyed by EnableDeferredUserMetadataSaves(), copy
+  // assignment and the destructor, which aren't called while other threads
+  // are using the game, so the pointer stays valid once the mutex has been
+  // released. The mutex can't be held during the flush, as the write needs it.
+  DebouncedTask* task = nullptr;
+  {
+    lock_guard<mutex> guard(mutex_);
+    task = userMetadataSaveTask_.get();
+  }
+
+  if (task != nullptr) {
+    task->Flush();
+  }
+}
+
+void Game::BeginUserMetadataTransaction() {
+  userMetadataTransactionMutex_.lock();
+
+  // The userlist is what a rollback restores, so it must hold every edit
+  // that was saved before the transaction began.
+  FlushUserMetadata();
+
+  lock_guard<mutex> guard(mutex_);
+  isUserMetadataTransactionOpen_ = true;
+  userMetadataTransactionHasEdits_ = false;
+  userMetadataSaveRequested_ = false;
+}
+
+void Game::CommitUserMetadataTransaction() {
+  bool saveRequested = false;
+  bool hasEdits = false;
+  {
+    lock_guard<mutex> guard(mutex_);
+    saveRequested = userMetadataSaveRequested_;
+    hasEdits = userMetadataTransactionHasEdits_;
+    isUserMetadataTransactionOpen_ = false;
+    userMetadataTransactionHasEdits_ = false;
+    userMetadataSaveRequested_ = false;
+  }
+
+  // The write isn't deferred, so that if it fails the edits can still be
+  // rolled back and the failure reported to whoever committed them.
+  try {
+    if (saveRequested) {
+      WriteUserMetadata();
+    }
+  } catch (...) {
+    if (hasEdits) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->debug(
+            "Rolling back user metadata edits after failing to save them.");
+      }
+      LoadMetadata();
+    }
+    userMetadataTransactionMutex_.unlock();
+    throw;
+  }
+
+  userMetadataTransactionMutex_.unlock();
+}
+
+void Game::RollbackUserMetadataTransaction() {
+  bool hasEdits = false;
+  {
+    lock_guard<mutex> guard(mutex_);
+    hasEdits = userMetadataTransactionHasEdits_;
+    isUserMetadataTransactionOpen_ = false;
+    userMetadataTransactionHasEdits_ = false;
+    userMetadataSaveRequested_ = false;
+  }
+
+  // libloot can't undo edits, so restore the last saved user metadata by
+  // reloading the metadata lists.
+  if (hasEdits) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug("Rolling back user metadata edits.");
+    }
+    LoadMetadata();
+  }
+
+  userMetadataTransactionMutex_.unlock();
+}
+
+std::vector<std::filesystem::path> Game::GetWatchedDirectories() const {
+  std::vector<std::filesystem::path> directories{
+      DataPath(),
+      lootDataPath_ / u8path(FolderName()),
+  };
+
+  auto masterlistDirectory = MasterlistUpdatePath().parent_path();
+  if (masterlistDirectory != directories.back()) {
+    directories.push_back(masterlistDirectory);
+  }
+
+  if (Type() == GameType::tes3) {
+    // Morrowind's load order is stored in Morrowind.ini.
+    directories.push_back(GamePath());
+  } else if (!GameLocalPath().empty()) {
+    directories.push_back(GameLocalPath());
+  } else {
+    directories.push_back(PluginsTxtPath().parent_path());
+  }
+
+  return directories;
+}
+
+std::vector<std::filesystem::path> Game::GetLoadOrderStatePaths() const {
+  if (Type() == GameType::tes3) {
+    return {GamePath() / "Morrowind.ini"};
+  }
+
+  const auto directory = GameLocalPath().empty()
+                             ? PluginsTxtPath().parent_path()
+                             : GameLocalPath();
+
+  return {directory / "plugins.txt", directory / "loadorder.txt"};
+}
+
+Game::LoadOrderStateFingerprint Game::GetLoadOrderStateFingerprint(
+    const std::optional<LoadOrderStateFingerprint>& previous) const {
+  LoadOrderStateFingerprint fingerprint;
+  {
+    lock_guard<mutex> guard(mutex_);
+    fingerprint.dataDirectoryGeneration = dataDirectoryGeneration_;
+  }
+
+  for (const auto& path : GetLoadOrderStatePaths()) {
+    LoadOrderFileFingerprint file;
+    file.path = path;
+
+    std::error_code errorCode;
+    file.size = fs::file_size(path, errorCode);
+    if (!errorCode) {
+      file.modificationTime = fs::last_write_time(path, errorCode);
+    }
+    file.exists = !errorCode;
+    if (!file.exists) {
+      file.size = 0;
+      fingerprint.files.push_back(file);
+      continue;
+    }
+
+    const LoadOrderFileFingerprint* previousFile = nullptr;
+    if (previous.has_value()) {
+      for (const auto& candidate : previous->files) {
+        if (candidate.path == path) {
+          previousFile = &candidate;
+          break;
+        }
+      }
+    }
+
+    if (previousFile != nullptr && previousFile->exists &&
+        previousFile->size == file.size &&
+        previousFile->modificationTime == file.modificationTime) {
+      file.contentHash = previousFile->contentHash;
+    } else {
+      std::ifstream in(path, std::ios::binary);
+      std::string content((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+      file.contentHash = std::hash<std::string>()(content);
+    }
+
+    fingerprint.files.push_back(file);
+  }
+
+  return fingerprint;
+}
+
+void Game::RecordLoadOrderState() {
+  std::optional<LoadOrderStateFingerprint> previous;
+  {
+    lock_guard<mutex> guard(mutex_);
+    previous = loadOrderStateFingerprint_;
+  }
+
+  auto fingerprint = GetLoadOrderStateFingerprint(previous);
+
+  lock_guard<mutex> guard(mutex_);
+  loadOrderStateFingerprint_ = fingerprint;
+}
+
+void Game::ReloadLoadOrderState() {
+  ScopedTimer timer("Game::ReloadLoadOrderState");
+
+  // Take the fingerprint first, so that changes made while the state is
+  // loaded cause another reload.
+  std::optional<LoadOrderStateFingerprint> previous;
+  {
+    lock_guard<mutex> guard(mutex_);
+    previous = loadOrderStateFingerprint_;
+    loadOrderStateFingerprint_ = std::nullopt;
+  }
+  auto fingerprint = GetLoadOrderStateFingerprint(previous);
+
+  gameHandle_->LoadCurrentLoadOrderState();
+
+  lock_guard<mutex> guard(mutex_);
+  loadOrderStateFingerprint_ = fingerprint;
+}
+
+bool Game::ReloadLoadOrderStateIfChanged() {
+  std::optional<LoadOrderStateFingerprint> previous;
+  {
+    lock_guard<mutex> guard(mutex_);
+    previous = loadOrderStateFingerprint_;
+  }
+
+  if (previous.has_value()) {
+    auto fingerprint = GetLoadOrderStateFingerprint(previous);
+    if (fingerprint == previous.value()) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->debug(
+            "The load order state is unchanged since it was last loaded, "
+            "skipping reloading it.");
+      }
+
+      // Remember any new modification times so that unchanged content isn't
+      // hashed again.
+      lock_guard<mutex> guard(mutex_);
+      loadOrderStateFingerprint_ = fingerprint;
+      return false;
+    }
+  }
+
+  ReloadLoadOrderState();
+  return true;
+}
+
+Game::ExternalChanges Game::RecordExternalChanges(
+    const std::vector<std::filesystem::path>& paths) {
+  static const std::set<std::string> LOAD_ORDER_FILENAMES({
+      "loadorder.txt",
+      "morrowind.ini",
+      "plugins.txt",
+  });
+
+  ExternalChanges changes;
+  // Files may change after the game has been unloaded, in which case there's
+  // no state to update.
+  if (!gameHandle_) {
+    return changes;
+  }
+
+  const auto watchedDirectories = GetWatchedDirectories();
+  const auto metadataDirectory = lootDataPath_ / u8path(FolderName());
+  const auto masterlistPath = MasterlistPath();
+  const auto masterlistDirectory = MasterlistUpdatePath().parent_path();
+
+  bool metadataListsMayHaveChanged = false;
+  bool loadOrderMayHaveChanged = false;
+  for (const auto& path : paths) {
+    if (IsOwnWrite(path)) {
+      continue;
+    }
+
+    if (path == DataPath()) {
+      // The directory's changes were lost, so any file may have changed.
+      changes.dataDirectory = true;
+      for (const auto& plugin : GetPlugins()) {
+        changes.plugins.insert(plugin->GetName());
+      }
+      ClearDerivedPluginFingerprints();
+      loadOrderMayHaveChanged = true;
+    } else if (path == metadataDirectory || path == masterlistDirectory ||
+               path == masterlistPath || path == MasterlistUpdatePath() ||
+               path == UserlistPath()) {
+      metadataListsMayHaveChanged = true;
+    } else if (path.parent_path() == DataPath()) {
+      auto filename = path.filename().u8string();
+      if (!isPluginFilename(filename)) {
+        changes.dataDirectory = true;
+        continue;
+      }
+
+      if (boost::iends_with(filename, ".ghost")) {
+        filename.erase(filename.length() - GHOST_EXTENSION_LENGTH);
+      }
+      changes.plugins.insert(filename);
+      ClearDerivedPluginFingerprint(filename);
+      ClearDependentDerivedMetadataJson(filename);
+      // Plugins may have been added or removed, and some games' load orders
+      // are based on plugin timestamps.
+      loadOrderMayHaveChanged = true;
+    } else if (LOAD_ORDER_FILENAMES.count(
+                   NormalizeFilename(path.filename().u8string())) != 0 ||
+               std::find(watchedDirectories.cbegin(),
+                         watchedDirectories.cend(),
+                         path) != watchedDirectories.cend()) {
+      loadOrderMayHaveChanged = true;
+    }
+  }
+
+  // LOOT's own writes to the metadata lists also trigger changes, so compare
+  // the lists' timestamps to when LOOT last read or wrote them.
+  if (metadataListsMayHaveChanged) {
+    auto metadataListTimes = GetMetadataListTimes();
+
+    lock_guard<mutex> guard(mutex_);
+    if (metadataListTimes != metadataListTimes_) {
+      metadataListsStale_ = true;
+      changes.metadataLists = true;
+    }
+  }
+
+  // Similarly, only report the load order as changed if reloading it gives a
+  // different result.
+  if (loadOrderMayHaveChanged) {
+    auto getLoadOrderState = [this]() {
+      std::vector<std::pair<std::string, bool>> state;
+      for (const auto& pluginName : GetLoadOrder()) {
+        state.push_back({pluginName, IsPluginActive(pluginName)});
+      }
+      return state;
+    };
+
+    auto previousState = getLoadOrderState();
+    try {
+      ReloadLoadOrderState();
+      // The snapshot of active states is of the state before it was reloaded.
+      ClearActiveLoadOrderIndices();
+      changes.loadOrder = getLoadOrderState() != previousState;
+    } catch (std::exception& e) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->error("Failed to reload the load order. Details: {}",
+                      e.what());
+      }
+      changes.loadOrder = true;
+    }
+
+    if (changes.loadOrder) {
+      ClearActiveLoadOrderIndices();
+      IncrementDerivedMetadataRevision();
+      ClearEvaluatedMetadataIfStale();
+    }
+  }
+
+  return changes;
+}
+
+void Game::RecordOwnWrites(const std::vector<std::filesystem::path>& paths) {
+  std::vector<std::pair<fs::path, fs::file_time_type>> writeTimes;
+  for (const auto& path : paths) {
+    std::error_code errorCode;
+    auto time = fs::last_write_time(path, errorCode);
+    if (!errorCode) {
+      writeTimes.emplace_back(path, time);
+    }
+  }
+
+  lock_guard<mutex> guard(mutex_);
+  for (const auto& writeTime : writeTimes) {
+    ownWriteTimes_[writeTime.first] = writeTime.second;
+  }
+}
+
+bool Game::IsOwnWrite(const std::filesystem::path& path) {
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (ownWriteTimes_.count(path) == 0) {
+      return false;
+    }
+  }
+
+  std::error_code errorCode;
+  auto time = fs::last_write_time(path, errorCode);
+
+  lock_guard<mutex> guard(mutex_);
+  auto it = ownWriteTimes_.find(path);
+  if (it == ownWriteTimes_.end()) {
+    return false;
+  }
+  if (!errorCode && time == it->second) {
+    return true;
+  }
+
+  // Something else has changed the file since LOOT wrote it.
+  ownWriteTimes_.erase(it);
+  return false;
+}
+
+std::vector<std::filesystem::path> Game::GetPluginFilePaths(
+    const std::vector<std::string>& pluginNames) const {
+  std::unordered_map<std::string, fs::path> dataPaths;
+  std::error_code errorCode;
+  for (fs::directory_iterator it(DataPath(), errorCode);
+       !errorCode && it != fs::directory_iterator();
+       it.increment(errorCode)) {
+    auto filename = it->path().filename().u8string();
+    if (boost::iends_with(filename, ".ghost")) {
+      filename.erase(filename.length() - GHOST_EXTENSION_LENGTH);
+    }
+    dataPaths.emplace(NormalizeFilename(filename), it->path());
+  }
+
+  std::vector<fs::path> paths;
+  for (const auto& pluginName : pluginNames) {
+    auto it = dataPaths.find(NormalizeFilename(pluginName));
+    if (it != dataPaths.end()) {
+      paths.push_back(it->second);
+    }
+  }
+
+  return paths;
+}
+
+std::pair<std::optional<std::filesystem::file_time_type>,
+          std::optional<std::filesystem::file_time_type>>
+Game::GetMetadataListTimes() const {
+  auto getTime = [](const std::filesystem::path& path)
+      -> std::optional<std::filesystem::file_time_type> {
+    std::error_code errorCode;
+    auto time = std::filesystem::last_write_time(path, errorCode);
+    if (errorCode) {
+      return std::nullopt;
+    }
+    return time;
+  };
+
+  return {getTime(MasterlistPath()), getTime(UserlistPath())};
+}
+
+std::vector<std::string> Game::GetInstalledPluginNames() {
+  std::vector<std::string> plugins;
+  std::unordered_map<std::string, PluginFingerprint> dataDirectoryEntries;
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->trace("Scanning for plugins in {}", this->DataPath().u8string());
+  }
+
+  // Checking if a file is a valid plugin involves reading its header, so
+  // reuse the results of previous checks for files that haven't changed.
+  bool canCacheValidity = !lootDataPath_.empty();
+  if (canCacheValidity && !pluginValidityCache_.has_value()) {
+    pluginValidityCache_ = PluginValidityCache();
+    pluginValidityCache_->Load(PluginValidityCachePath());
+  }
+  PluginValidityCache newPluginValidityCache;
+
+  // Only files with plugin extensions can be plugins, so only their validity
+  // needs to be checked. The snapshot records every entry, as conditions can
+  // refer to any file.
+  struct Candidate {
+    string name;
+    PluginFingerprint fingerprint;
+    std::optional<bool> isValid;
+  };
+  std::vector<Candidate> candidates;
+  for (fs::directory_iterator it(this->DataPath());
+       it != fs::directory_iterator();
+       ++it) {
+    string name = it->path().filename().u8string();
+
+    // Use the attributes cached by the directory entry where possible, to
+    // avoid another stat per entry.
+    std::error_code errorCode;
+    bool isCandidate = isPluginFilename(name) &&
+                       it->is_regular_file(errorCode) && !errorCode;
+
+    PluginFingerprint entryFingerprint;
+    auto modificationTime = it->last_write_time(errorCode);
+    if (!errorCode) {
+      entryFingerprint.modificationTime = modificationTime;
+    }
+    if (isCandidate) {
+      auto fileSize = it->file_size(errorCode);
+      if (!errorCode) {
+        entryFingerprint.fileSize = fileSize;
+      }
+    }
+    dataDirectoryEntries.emplace(NormalizeFilename(name), entryFingerprint);
+
+    if (!isCandidate) {
+      continue;
+    }
+
+    std::optional<bool> isValid;
+    if (canCacheValidity) {
+      isValid = pluginValidityCache_->IsValidPlugin(
+          name, entryFingerprint.fileSize, entryFingerprint.modificationTime);
+    }
+    candidates.push_back(Candidate{name, entryFingerprint, isValid});
+  }
+
+  // Checking a file's validity involves reading its header, so check the
+  // uncached candidates in parallel.
+  std::vector<Candidate*> uncachedCandidates;
+  for (auto& candidate : candidates) {
+    if (!candidate.isValid.has_value()) {
+      uncachedCandidates.push_back(&candidate);
+    }
+  }
+
+  const auto checkValidity = [this, &uncachedCandidates](size_t first,
+                                                         size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      uncachedCandidates[i]->isValid =
+          gameHandle_->IsValidPlugin(uncachedCandidates[i]->name);
+    }
+  };
+
+  const size_t threadCount = std::max(
+      size_t(1),
+      std::min(size_t(std::thread::hardware_concurrency()),
+               uncachedCandidates.size() / MIN_PLUGINS_PER_VALIDITY_THREAD));
+  if (threadCount < 2) {
+    checkValidity(0, uncachedCandidates.size());
+  } else {
+    if (logger) {
+      logger->trace("Checking the validity of {} files using {} threads.",
+                    uncachedCandidates.size(),
+                    threadCount);
+    }
+
+    const size_t chunkSize =
+        (uncachedCandidates.size() + threadCount - 1) / threadCount;
+    std::vector<std::future<void>> chunks;
+    for (size_t first = 0; first < uncachedCandidates.size();
+         first += chunkSize) {
+      const size_t last =
+          std::min(first + chunkSize, uncachedCandidates.size());
+      chunks.push_back(
+          std::async(std::launch::async, checkValidity, first, last));
+    }
+
+    for (auto& chunk : chunks) {
+      chunk.get();
+    }
+  }
+
+  for (const auto& candidate : candidates) {
+    if (canCacheValidity) {
+      newPluginValidityCache.SetIsValidPlugin(
+          candidate.name,
+          candidate.fingerprint.fileSize,
+          candidate.fingerprint.modificationTime,
+          candidate.isValid.value());
+
+      // Keep the CRCs of plugins that haven't changed.
+      auto crc =
+          pluginValidityCache_->GetCRC(candidate.name,
+                                       candidate.fingerprint.fileSize,
+                                       candidate.fingerprint.modificationTime);
+      if (crc.has_value()) {
+        newPluginValidityCache.SetCRC(candidate.name,
+                                      candidate.fingerprint.fileSize,
+                                      candidate.fingerprint.modificationTime,
+                                      crc.value());
+      }
+    }
+
+    if (candidate.isValid.value()) {
+      if (logger) {
+        logger->info("Found plugin: {}", candidate.name);
+      }
+
+      plugins.push_back(candidate.name);
+    }
+  }
+
+  if (dataDirectoryEntries_ != dataDirectoryEntries) {
+    lock_guard<mutex> guard(mutex_);
+    ++dataDirectoryGeneration_;
+  }
+  dataDirectoryEntries_ = dataDirectoryEntries;
+
+  if (canCacheValidity && newPluginValidityCache != pluginValidityCache_) {
+    try {
+      newPluginValidityCache.Save(PluginValidityCachePath());
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->error("Failed to save the plugin validity cache: {}",
+                      e.what());
+      }
+    }
+    pluginValidityCache_ = newPluginValidityCache;
+  }
+
+  return plugins;
+}
+
+std::vector<Message> Game::GetMessagesLocked() const {
+  std::vector<Message> output(
+      gameHandle_->GetDatabase()->GetGeneralMessages(true));
+  output.insert(end(output), begin(messages_), end(messages_));
+
+  if (loadOrderSortCount_ == 0)
+    output.push_back(PlainTextMessage(
+        MessageType::warn,
+        boost::locale::translate(
+            "You have not sorted your load order this session.")));
+
+  // The current load order's indices count its active plugins, so reuse them
+  // instead of checking every plugin for each call.
+  if (!currentLoadOrderIndices_.has_value()) {
+    currentLoadOrderIndices_ =
+        GetActiveLoadOrderIndices(gameHandle_->GetLoadOrder());
+  }
+
+  if (currentLoadOrderIndices_->activeNormalPluginCount > 254 &&
+      currentLoadOrderIndices_->activeLightMasterCount > 0) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn(
+          "255 normal plugins and at least one light master are active at the "
+          "same time.");
+    }
+    output.push_back(PlainTextMessage(
+        MessageType::warn,
+        boost::locale::translate(
+            "You have a normal plugin and at least one light master sharing "
+            "the FE load order index. Deactivate a normal plugin or all your "
+            "light masters to avoid potential issues.")));
+  }
+
+  return output;
+}
+
+void Game::AppendMessages(std::vector<Message> messages) {
+  for (auto message : messages) {
+    AppendMessage(message);
+  }
+}
+
+bool Game::DataFileExists(const std::string& filename) const {
+  // The snapshot only holds the Data directory's direct children, so check
+  // the filesystem for paths that include subdirectories.
+  if (!dataDirectoryEntries_.has_value() ||
+      filename.find_first_of("/\\") != std::string::npos) {
+    return fs::exists(DataPath() / u8path(filename));
+  }
+
+  return dataDirectoryEntries_->count(NormalizeFilename(filename)) != 0;
+}
+
+fs::path Game::GetPluginFilePath(const std::string& pluginName) const {
+  auto filePath = DataPath() / u8path(pluginName);
+  if (!DataFileExists(pluginName)) {
+    filePath += ".ghost";
+  }
+
+  return filePath;
+}
+
+std::vector<Game::MappedPluginFileEntry> Game::MapPluginFiles(
+    const std::vector<std::string>& pluginNames,
+    size_t begin,
+    size_t end) const {
+  std::vector<MappedPluginFileEntry> files;
+  files.reserve(end - begin);
+  for (size_t i = begin; i < end; ++i) {
+    try {
+      files.push_back(
+          {i,
+           std::make_unique<MappedPluginFile>(
+               GetPluginFilePath(pluginNames[i]))});
+    } catch (const std::exception& e) {
+      // libloot will report any error when it reads the file.
+      auto logger = getLogger();
+      if (logger) {
+        logger->debug("Failed to map \"{}\". Details: {}",
+                      pluginNames[i],
+                      e.what());
+      }
+    }
+  }
+
+  // Directory order has nothing to do with where files are on disk, so
+  // request the reads in file ID order, which is usually closer to disk
+  // order, so that the OS can queue them with fewer seeks.
+  std::stable_sort(
+      files.begin(),
+      files.end(),
+      [](const MappedPluginFileEntry& lhs, const MappedPluginFileEntry& rhs) {
+        return lhs.file->FileId() < rhs.file->FileId();
+      });
+
+  return files;
+}
+
+void Game::ReadAheadPluginFiles(
+    const std::vector<std::string>& pluginNames) const {
+  // The pages that are read ahead stay in the OS page cache after the files
+  // are unmapped, so libloot's reads of the files are served from memory
+  // instead of waiting on the disk one read at a time.
+  std::uintmax_t readAheadBytes = 0;
+  for (size_t begin = 0; begin < pluginNames.size();
+       begin += READ_AHEAD_WINDOW_FILES) {
+    const auto end =
+        std::min(begin + READ_AHEAD_WINDOW_FILES, pluginNames.size());
+    for (const auto& entry : MapPluginFiles(pluginNames, begin, end)) {
+      if (readAheadBytes >= READ_AHEAD_WINDOW_BYTES) {
+        return;
+      }
+
+      entry.file->WillNeed();
+      readAheadBytes += entry.file->Size();
+    }
+  }
+}
+
+std::shared_ptr<const Game::GroupIndex> Game::GetGroupIndex() const {
+  unsigned int revision;
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (groupIndex_ && groupIndex_->revision == groupsRevision_) {
+      return groupIndex_;
+    }
+    revision = groupsRevision_;
+  }
+
+  ScopedTimer timer("Game::GetGroupIndex");
+  auto database = gameHandle_->GetDatabase();
+  auto index = std::make_shared<GroupIndex>();
+  index->revision = revision;
+  index->masterlistGroups = database->GetGroups(false);
+  index->userGroups = database->GetUserGroups();
+  for (const auto& group : index->masterlistGroups) {
+    index->names.insert(group.GetName());
+  }
+  for (const auto& group : index->userGroups) {
+    index->names.insert(group.GetName());
+  }
+  index->bashTagTable =
+      std::make_shared<BashTagTable>(database->GetKnownBashTags());
+
+  // Don't replace an index built for a later revision.
+  lock_guard<mutex> guard(mutex_);
+  if (revision == groupsRevision_) {
+    groupIndex_ = index;
+  }
+
+  return index;
+}
+
+void Game::ClearGroupIndex() {
+  lock_guard<mutex> guard(mutex_);
+
+  groupIndex_ = nullptr;
+  ++groupsRevision_;
+}
+
+void Game::ReadPluginFiles(
+    const std::vector<std::string>& pluginNames,
+    bool headersOnly,
+    const PluginReadProgressCallback& progressCallback) const {
+  if (pluginNames.empty()) {
+    return;
+  }
+
+  ScopedTimer timer("Game::ReadPluginFiles");
+
+  size_t threadCount = pluginReadingThreads_ == 0
+                           ? std::thread::hardware_concurrency()
+                           : pluginReadingThreads_;
+  threadCount = std::max(
+      size_t(1),
+      std::min({threadCount, pluginNames.size(), READ_AHEAD_WINDOW_FILES}));
+
+  mutex progressMutex;
+  size_t readCount = 0;
+  const auto recordRead = [&](const std::string& pluginName) {
+    lock_guard<mutex> guard(progressMutex);
+    ++readCount;
+    if (progressCallback) {
+      progressCallback(pluginName, readCount, pluginNames.size());
+    }
+  };
+
+  // Each window of plugins is mapped once, and the same mappings are used to
+  // read ahead and then read the files.
+  for (size_t begin = 0; begin < pluginNames.size();
+       begin += READ_AHEAD_WINDOW_FILES) {
+    const auto end =
+        std::min(begin + READ_AHEAD_WINDOW_FILES, pluginNames.size());
+    auto files = MapPluginFiles(pluginNames, begin, end);
+
+    // Files that couldn't be mapped are left for libloot to report.
+    std::vector<bool> isMapped(end - begin, false);
+    for (const auto& entry : files) {
+      isMapped[entry.index - begin] = true;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      if (!isMapped[i - begin]) {
+        recordRead(pluginNames[i]);
+      }
+    }
+
+    // Full reads are long sequential reads that the OS already reads ahead
+    // for, but header reads are short reads spread across many files, so ask
+    // for them all up front for the OS to read in the background while the
+    // threads below wait on them in turn.
+    if (headersOnly) {
+      for (const auto& entry : files) {
+        entry.file->WillNeed(HEADER_READ_AHEAD_BYTES);
+      }
+    }
+
+    // Only a plugin's header record is read when loading headers, which is
+    // usually a small fraction of the file, but the file size is still the
+    // best available estimate of how long the read will take relative to
+    // other plugins. Assign the largest plugins first, each to the thread
+    // with the least to read so far, so that a few large masters don't leave
+    // one thread reading long after the others have finished.
+    std::vector<const MappedPluginFileEntry*> sortedFiles;
+    sortedFiles.reserve(files.size());
+    for (const auto& entry : files) {
+      sortedFiles.push_back(&entry);
+    }
+    std::stable_sort(sortedFiles.begin(),
+                     sortedFiles.end(),
+                     [](const MappedPluginFileEntry* lhs,
+                        const MappedPluginFileEntry* rhs) {
+                       return lhs->file->Size() > rhs->file->Size();
+                     });
+
+    std::vector<std::vector<const MappedPluginFileEntry*>> threadFiles(
+        threadCount);
+    std::vector<std::uintmax_t> threadBytes(threadCount, 0);
+    for (const auto entry : sortedFiles) {
+      auto leastLoaded = std::distance(
+          threadBytes.begin(),
+          std::min_element(threadBytes.begin(), threadBytes.end()));
+      threadFiles[leastLoaded].push_back(entry);
+      threadBytes[leastLoaded] += entry->file->Size();
+    }
+
+    const auto readFiles =
+        [&](const std::vector<const MappedPluginFileEntry*>& entries) {
+          for (const auto entry : entries) {
+            const auto& pluginName = pluginNames[entry->index];
+            try {
+              entry->file->Read(headersOnly
+                                    ? entry->file->GetHeaderRecordLength(Type())
+                                    : entry->file->Size());
+            } catch (const std::exception& e) {
+              // libloot will report any error when it reads the file.
+              auto logger = getLogger();
+              if (logger) {
+                logger->debug(
+                    "Failed to read \"{}\". Details: {}", pluginName, e.what());
+              }
+            }
+
+            recordRead(pluginName);
+          }
+        };
+
+    // This thread reads the first share of plugins.
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < threadCount; ++i) {
+      if (!threadFiles[i].empty()) {
+        futures.push_back(std::async(
+            std::launch::async, readFiles, std::cref(threadFiles[i])));
+      }
+    }
+    readFiles(threadFiles[0]);
+
+    for (auto& future : futures) {
+      future.get();
+    }
+  }
+}
+
+std::optional<uint32_t> Game::GetPluginCRC(
+    const std::shared_ptr<const PluginInterface>& plugin) const {
+  auto crc = plugin->GetCRC();
+  if (crc.has_value() || !pluginValidityCache_.has_value() ||
+      !dataDirectoryEntries_.has_value()) {
+    return crc;
+  }
+
+  auto name = NormalizeFilename(plugin->GetName());
+  auto it = dataDirectoryEntries_->find(name);
+  if (it == dataDirectoryEntries_->end()) {
+    it = dataDirectoryEntries_->find(name + ".ghost");
+  }
+  if (it == dataDirectoryEntries_->end()) {
+    return std::nullopt;
+  }
+
+  return pluginValidityCache_->GetCRC(
+      it->first, it->second.fileSize, it->second.modificationTime);
+}
+
+void Game::CachePluginCRCs() {
+  if (!pluginValidityCache_.has_value() ||
+      !dataDirectoryEntries_.has_value()) {
+    return;
+  }
+
+  auto newPluginValidityCache = pluginValidityCache_.value();
+  for (const auto& plugin : gameHandle_->GetLoadedPlugins()) {
+    auto crc = plugin->GetCRC();
+    if (!crc.has_value()) {
+      continue;
+    }
+
+    auto name = NormalizeFilename(plugin->GetName());
+    auto it = dataDirectoryEntries_->find(name);
+    if (it == dataDirectoryEntries_->end()) {
+      it = dataDirectoryEntries_->find(name + ".ghost");
+    }
+    if (it != dataDirectoryEntries_->end()) {
+      newPluginValidityCache.SetCRC(it->first,
+                                    it->second.fileSize,
+                                    it->second.modificationTime,
+                                    crc.value());
+    }
+  }
+
+  if (newPluginValidityCache == pluginValidityCache_) {
+    return;
+  }
+
+  try {
+    newPluginValidityCache.Save(PluginValidityCachePath());
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Failed to save the plugin validity cache: {}", e.what());
+    }
+  }
+  pluginValidityCache_ = newPluginValidityCache;
+}
+
+std::uintmax_t Game::GetEstimatedFormIdBytes(
+    const std::string& pluginName) const {
+  return GetPluginFileSize(pluginName) / FILE_BYTES_PER_ESTIMATED_FORMID_BYTE;
+}
+
+std::uintmax_t Game::EvictFullyLoadedPluginsLocked(
+    std::uintmax_t targetBytes,
+    std::uint64_t keepUsedSince) const {
+  std::uintmax_t freedBytes = 0;
+  while (fullyLoadedPluginsBytes_ > targetBytes) {
+    auto leastRecentlyUsed = std::min_element(
+        fullyLoadedPlugins_.begin(),
+        fullyLoadedPlugins_.end(),
+        [](const auto& lhs, const auto& rhs) {
+          return lhs.second.lastUsed < rhs.second.lastUsed;
+        });
+    if (leastRecentlyUsed == fullyLoadedPlugins_.end() ||
+        leastRecentlyUsed->second.lastUsed >= keepUsedSince) {
+      break;
+    }
+
+    fullyLoadedPluginsBytes_ -= leastRecentlyUsed->second.estimatedBytes;
+    freedBytes += leastRecentlyUsed->second.estimatedBytes;
+    fullyLoadedPlugins_.erase(leastRecentlyUsed);
+  }
+
+  return freedBytes;
+}
+
+std::uintmax_t Game::GetDerivedMetadataJsonBytesLocked() const {
+  std::uintmax_t bytes = 0;
+  for (const auto& entry : derivedMetadataJson_) {
+    bytes += entry.second.json.size();
+  }
+
+  return bytes;
+}
+
+void Game::RegisterCaches() {
+  auto& registry = GetCacheRegistry();
+
+  // Fully loaded plugins that are still in use are kept alive by their
+  // users, so evicting them only stops them being reused.
+  fullyLoadedPluginsRegistration_ = registry.Register(
+      "fullyLoadedPlugins",
+      [this]() {
+        lock_guard<mutex> guard(mutex_);
+        return fullyLoadedPluginsBytes_;
+      },
+      [this](std::uintmax_t targetBytes) {
+        lock_guard<mutex> guard(mutex_);
+        return EvictFullyLoadedPluginsLocked(targetBytes,
+                                             fullyLoadedPluginsUseCount_ + 1);
+      });
+
+  // Serialisations don't record when they were last used, so they're all
+  // discarded together. They're recreated when they're next needed.
+  derivedMetadataJsonRegistration_ = registry.Register(
+      "derivedMetadataJson",
+      [this]() {
+        lock_guard<mutex> guard(mutex_);
+        return GetDerivedMetadataJsonBytesLocked();
+      },
+      [this](std::uintmax_t targetBytes) {
+        lock_guard<mutex> guard(mutex_);
+        const auto bytes = GetDerivedMetadataJsonBytesLocked();
+        if (bytes <= targetBytes) {
+          return std::uintmax_t(0);
+        }
+
+        derivedMetadataJson_.clear();
+        return bytes;
+      });
+
+  // There's an entry for each pair of plugins that has been checked, so the
+  // cache can grow with the square of the number of plugins.
+  formIdOverlapsRegistration_ = registry.Register(
+      "formIdOverlaps",
+      [this]() {
+        lock_guard<mutex> guard(mutex_);
+        return GetFormIdOverlapsBytesLocked();
+      },
+      [this](std::uintmax_t targetBytes) {
+        lock_guard<mutex> guard(mutex_);
+        const auto bytes = GetFormIdOverlapsBytesLocked();
+        if (bytes <= targetBytes) {
+          return std::uintmax_t(0);
+        }
+
+        formIdOverlaps_.clear();
+        return bytes;
+      });
+
+  // The other caches aren't registered. Evaluated and resolved metadata, the
+  // condition dependency index and the master graph are kept up to date
+  // incrementally and would all have to be rebuilt for every plugin the next
+  // time any plugin is used. The remaining caches hold a few small values per
+  // plugin.
+}
+
+std::uintmax_t Game::GetFormIdOverlapsBytesLocked() const {
+  // Each entry is also referred to by a bucket and links to the next entry.
+  static constexpr std::uintmax_t ENTRY_BYTES =
+      sizeof(std::pair<const std::uint64_t, bool>) + 2 * sizeof(void*);
+
+  return formIdOverlaps_.size() * ENTRY_BYTES;
+}
+
+std::uintmax_t Game::GetPluginFileSize(const std::string& pluginName) const {
+  auto name = NormalizeFilename(pluginName);
+  if (dataDirectoryEntries_.has_value()) {
+    auto it = dataDirectoryEntries_->find(name);
+    if (it == dataDirectoryEntries_->end()) {
+      it = dataDirectoryEntries_->find(name + ".ghost");
+    }
+    if (it != dataDirectoryEntries_->end()) {
+      return it->second.fileSize;
+    }
+  }
+
+  auto filePath = DataPath() / u8path(pluginName);
+  if (!DataFileExists(pluginName)) {
+    filePath += ".ghost";
+  }
+
+  std::error_code errorCode;
+  auto fileSize = fs::file_size(filePath, errorCode);
+  if (errorCode) {
+    return 0;
+  }
+
+  return fileSize;
+}
+
+bool Game::IsPluginActiveLocked(const std::string& pluginName) const {
+  const auto& activePlugins = GetActivePluginsLocked();
+
+  // A plugin that has never been seen can't be active.
+  auto id = pluginNames_->Find(pluginName);
+
+  return id.has_value() && id.value() < activePlugins.size() &&
+         activePlugins[id.value()];
+}
+
+const std::vector<bool>& Game::GetActivePluginsLocked() const {
+  if (activePlugins_.has_value()) {
+    return activePlugins_.value();
+  }
+
+  ScopedTimer timer("Game::GetActivePlugins");
+
+  // libloot can only be asked about one plugin at a time, so ask about each
+  // plugin in the load order once and remember the answers until the load
+  // order state next changes.
+  std::vector<bool> activePlugins;
+  for (const auto& pluginName : gameHandle_->GetLoadOrder()) {
+    if (!gameHandle_->IsPluginActive(pluginName)) {
+      continue;
+    }
+
+    auto id = pluginNames_->Intern(pluginName);
+    if (id >= activePlugins.size()) {
+      activePlugins.resize(id + 1);
+    }
+    activePlugins[id] = true;
+  }
+
+  activePlugins_ = std::move(activePlugins);
+
+  return activePlugins_.value();
+}
+
+Game::ActiveLoadOrderIndices Game::GetActiveLoadOrderIndices(
+    const std::vector<std::string>& loadOrder) const {
+  ScopedTimer timer("Game::GetActiveLoadOrderIndices");
+
+  // Count the number of active plugins before each active plugin in the given
+  // load order. Inactive plugins and plugins that aren't loaded have no index.
+  ActiveLoadOrderIndices loadOrderIndices;
+  loadOrderIndices.loadOrder = loadOrder;
+
+  short numberOfActiveLightMasters = 0;
+  short numberOfActiveNormalPlugins = 0;
+  for (const auto& pluginName : loadOrder) {
+    auto plugin = GetPlugin(pluginName);
+    if (!plugin || !IsPluginActiveLocked(pluginName)) {
+      continue;
+    }
+
+    auto& counter = plugin->IsLightMaster() ? numberOfActiveLightMasters
+                                            : numberOfActiveNormalPlugins;
+    loadOrderIndices.indices.emplace(pluginNames_->Intern(pluginName),
+                                     counter);
+    ++counter;
+  }
+
+  loadOrderIndices.activeLightMasterCount = numberOfActiveLightMasters;
+  loadOrderIndices.activeNormalPluginCount = numberOfActiveNormalPlugins;
+
+  return loadOrderIndices;
+}
+
+void Game::ClearDerivedPluginFingerprint(const std::string& pluginName) {
+  lock_guard<mutex> guard(mutex_);
+
+  derivedPluginFingerprints_.erase(NormalizeFilename(pluginName));
+  // Only the plugin's user metadata has changed, and conditions don't depend
+  // on metadata, so other plugins' evaluated metadata is unaffected.
+  auto id = pluginNames_->Find(pluginName);
+  if (id.has_value()) {
+    evaluatedUserMetadata_.erase(id.value());
+    derivedMetadataJson_.erase(id.value());
+  }
+  ++derivedMetadataRevision_;
+}
+
+void Game::ClearDerivedPluginFingerprints() {
+  lock_guard<mutex> guard(mutex_);
+
+  derivedPluginFingerprints_.clear();
+  derivedMetadataJson_.clear();
+  evaluatedMasterlistMetadata_.clear();
+  evaluatedUserMetadata_.clear();
+  conditionDependencies_ = std::nullopt;
+  ++derivedMetadataRevision_;
+}
+
+void Game::ClearDependentDerivedMetadataJson(const std::string& filename) {
+  lock_guard<mutex> guard(mutex_);
+
+  auto key = ConditionDependencyIndex::GetKey(filename);
+  if (!key.has_value()) {
+    ClearDependentMetadataLocked(std::nullopt, false);
+    return;
+  }
+
+  ClearDependentMetadataLocked(std::unordered_set<std::string>({key.value()}),
+                               false);
+}
+
+void Game::ClearDependentMetadataLocked(
+    const std::optional<std::unordered_set<std::string>>& changedNames,
+    bool clearEvaluatedMetadata) {
+  std::function<bool(PluginId)> isStale = [](PluginId) { return true; };
+  std::unordered_set<PluginId> dependents;
+  if (!changedNames.has_value()) {
+    masterGraph_ = std::nullopt;
+  } else {
+    const auto& index = GetConditionDependencyIndexLocked();
+    dependents = index.GetDependents(changedNames.value());
+
+    // Plugins' masters aren't part of their metadata, so the master graph
+    // holds the plugins that depend on changed plugins as masters.
+    std::unordered_set<PluginId> changedPlugins;
+    for (const auto& name : changedNames.value()) {
+      auto id = pluginNames_->Find(name);
+      if (id.has_value()) {
+        changedPlugins.insert(id.value());
+      }
+    }
+    const auto predicates = GetMasterGraphPredicatesLocked();
+    auto masterDependents = GetMasterGraphLocked().ValidateDependents(
+        changedPlugins, predicates.first, predicates.second);
+    dependents.insert(masterDependents.begin(), masterDependents.end());
+
+    // Plugins that weren't loaded when the index was built may depend on
+    // anything.
+    isStale = [&](PluginId id) {
+      return !index.HasPlugin(id) || dependents.count(id) != 0;
+    };
+  }
+
+  size_t clearedCount = 0;
+  const auto eraseStale = [&](auto& cache, const auto& dependsOnOtherFiles) {
+    for (auto it = cache.begin(); it != cache.end();) {
+      if (dependsOnOtherFiles(it->second) && isStale(it->first)) {
+        it = cache.erase(it);
+        ++clearedCount;
+      } else {
+        ++it;
+      }
+    }
+  };
+
+  if (clearEvaluatedMetadata) {
+    const auto always = [](const auto&) { return true; };
+    eraseStale(evaluatedMasterlistMetadata_, always);
+    eraseStale(evaluatedUserMetadata_, always);
+  }
+  eraseStale(derivedMetadataJson_, [](const DerivedMetadataJson& json) {
+    return json.dependsOnOtherFiles;
+  });
+
+  auto logger = getLogger();
+  if (logger && changedNames.has_value()) {
+    logger->debug(
+        "{} files or active states changed, discarded {} cached metadata "
+        "entries for the plugins that depend on them.",
+        changedNames->size(),
+        clearedCount);
+  }
+}
+
+const ConditionDependencyIndex& Game::GetConditionDependencyIndexLocked()
+    const {
+  if (conditionDependencies_.has_value()) {
+    return conditionDependencies_.value();
+  }
+
+  ScopedTimer timer("Game::GetConditionDependencyIndex");
+
+  ConditionDependencyIndex index;
+  const auto addConditions = [&](PluginId id, const auto& elements) {
+    for (const auto& element : elements) {
+      index.AddCondition(id, element.GetCondition());
+    }
+  };
+  const auto addFiles = [&](PluginId id, const auto& files) {
+    for (const auto& file : files) {
+      index.AddFile(id, file.GetName());
+    }
+  };
+
+  const auto addMetadata = [&](PluginId id,
+                               const std::optional<PluginMetadata>& metadata) {
+    if (!metadata.has_value()) {
+      return;
+    }
+
+    addConditions(id, metadata->GetLoadAfterFiles());
+    addConditions(id, metadata->GetRequirements());
+    addConditions(id, metadata->GetIncompatibilities());
+    addConditions(id, metadata->GetMessages());
+    addConditions(id, metadata->GetTags());
+
+    // Whether requirements and incompatibilities are installed is checked
+    // when deriving metadata.
+    addFiles(id, metadata->GetRequirements());
+    addFiles(id, metadata->GetIncompatibilities());
+  };
+
+  for (const auto& plugin : gameHandle_->GetLoadedPlugins()) {
+    const auto id = pluginNames_->Intern(plugin->GetName());
+    index.AddPlugin(id);
+
+    // Whether masters are installed and active is checked when deriving
+    // metadata. The master graph only covers masters that are loaded, so a
+    // missing master being installed would otherwise be missed.
+    for (const auto& master : plugin->GetMasters()) {
+      index.AddFile(id, master);
+    }
+
+    const auto& metadata = GetResolvedMetadataLocked(plugin->GetName());
+    addMetadata(id, metadata.masterlist);
+    addMetadata(id, metadata.user);
+  }
+
+  conditionDependencies_ = std::move(index);
+
+  return conditionDependencies_.value();
+}
+
+MasterGraph& Game::GetMasterGraphLocked() const {
+  if (masterGraph_.has_value()) {
+    return masterGraph_.value();
+  }
+
+  ScopedTimer timer("Game::GetMasterGraph");
+
+  MasterGraph graph;
+  for (const auto& plugin : gameHandle_->GetLoadedPlugins()) {
+    addToMasterGraph(graph, *pluginNames_, *plugin);
+  }
+
+  const auto predicates = GetMasterGraphPredicatesLocked();
+  graph.ValidateAll(predicates.first, predicates.second);
+
+  masterGraph_ = std::move(graph);
+
+  return masterGraph_.value();
+}
+
+std::vector<MasterGraph::Problem> Game::GetMasterProblemsLocked(
+    const PluginInterface& plugin) const {
+  auto& graph = GetMasterGraphLocked();
+  const auto id = pluginNames_->Intern(plugin.GetName());
+  if (graph.HasPlugin(id)) {
+    return graph.GetProblems(id);
+  }
+
+  addToMasterGraph(graph, *pluginNames_, plugin);
+
+  const auto predicates = GetMasterGraphPredicatesLocked();
+  graph.Validate(id, predicates.first, predicates.second);
+
+  return graph.GetProblems(id);
+}
+
+std::pair<MasterGraph::Predicate, MasterGraph::Predicate>
+Game::GetMasterGraphPredicatesLocked() const {
+  // Masters are always plugins, so may be ghosted.
+  auto exists = [this](PluginId id) {
+    const auto& name = pluginNames_->GetName(id);
+    return DataFileExists(name) || DataFileExists(name + ".ghost");
+  };
+  auto isActive = [this](PluginId id) {
+    const auto& activePlugins = GetActivePluginsLocked();
+    return id < activePlugins.size() && activePlugins[id];
+  };
+
+  return {exists, isActive};
+}
+
+void Game::ClearChangedPluginsDerivedMetadataJson(
+    const std::optional<std::unordered_map<std::string, PluginFingerprint>>&
+        previousDataDirectoryEntries,
+    bool wereFullyLoaded) {
   lock_guard<mutex> guard(mutex_);
 
-  ++loadOrderSortCount_;
+  // Fully loaded plugins have CRCs, which header-only plugins don't.
+  if (!previousDataDirectoryEntries.has_value() ||
+      !dataDirectoryEntries_.has_value() ||
+      wereFullyLoaded != pluginsFullyLoaded_) {
+    derivedMetadataJson_.clear();
+    return;
+  }
+
+  auto clearEntry = [this](std::string filename) {
+    if (boost::iends_with(filename, ".ghost")) {
+      filename.erase(filename.length() - GHOST_EXTENSION_LENGTH);
+    }
+    auto id = pluginNames_->Find(filename);
+    if (id.has_value()) {
+      derivedMetadataJson_.erase(id.value());
+    }
+  };
+
+  for (const auto& entry : previousDataDirectoryEntries.value()) {
+    auto it = dataDirectoryEntries_->find(entry.first);
+    if (it == dataDirectoryEntries_->end() || it->second != entry.second) {
+      clearEntry(entry.first);
+    }
+  }
+  for (const auto& entry : dataDirectoryEntries_.value()) {
+    if (previousDataDirectoryEntries->count(entry.first) == 0) {
+      clearEntry(entry.first);
+    }
+  }
 }
 
-void Game::DecrementLoadOrderSortCount() {
+Game::SortInputs Game::GetSortInputs(
+    const std::vector<std::string>& loadOrder) const {
+  SortInputs inputs;
+  inputs.loadOrder = loadOrder;
+  for (const auto& plugin : GetPlugins()) {
+    inputs.plugins.emplace(pluginNames_->Intern(plugin->GetName()),
+                           GetPluginFingerprint(plugin));
+  }
+
   lock_guard<mutex> guard(mutex_);
+  inputs.dataDirectoryEntries = dataDirectoryEntries_;
+  inputs.metadataRevision = metadataRevision_;
+
+  if (loadedMetadataListPaths_.has_value()) {
+    const auto toString = [](const std::optional<fs::file_time_type>& time) {
+      return time.has_value()
+                 ? std::to_string(time.value().time_since_epoch().count())
+                 : std::string();
+    };
 
-  if (loadOrderSortCount_ > 0)
-    --loadOrderSortCount_;
+    inputs.metadataListsKey =
+        Version::string() + " " + Version::revision + "\n" +
+        loadedMetadataListPaths_->first.u8string() + "\n" +
+        toString(metadataListTimes_.first) + "\n" +
+        loadedMetadataListPaths_->second.u8string() + "\n" +
+        toString(metadataListTimes_.second);
+  }
+
+  return inputs;
 }
 
-std::vector<Message> Game::GetMessages() const {
-  std::vector<Message> output(
-      gameHandle_->GetDatabase()->GetGeneralMessages(true));
-  output.insert(end(output), begin(messages_), end(messages_));
+std::optional<std::vector<std::string>> Game::LoadPersistedSortResult(
+    const SortInputs& inputs) const {
+  auto persistentInputs = GetPersistentSortInputs(inputs);
+  if (!persistentInputs.has_value()) {
+    return std::nullopt;
+  }
 
-  if (loadOrderSortCount_ == 0)
-    output.push_back(PlainTextMessage(
-        MessageType::warn,
-        boost::locale::translate(
-            "You have not sorted your load order this session.")));
+  SortResultCache cache;
+  cache.Load(SortResultCachePath());
 
-  size_t activeNormalPluginsCount = 0;
-  bool hasActiveEsl = false;
-  for (const auto& plugin : GetPlugins()) {
-    if (IsPluginActive(plugin->GetName())) {
-      if (plugin->IsLightMaster()) {
-        hasActiveEsl = true;
-      } else {
-        ++activeNormalPluginsCount;
-      }
-    }
+  return cache.GetSortedPlugins(persistentInputs.value());
+}
+
+void Game::PersistSortResult(
+    const SortInputs& inputs,
+    const std::vector<std::string>& sortedPlugins) const {
+  auto persistentInputs = GetPersistentSortInputs(inputs);
+  if (!persistentInputs.has_value()) {
+    return;
   }
 
-  if (activeNormalPluginsCount > 254 && hasActiveEsl) {
+  try {
+    SortResultCache(std::move(persistentInputs.value()), sortedPlugins)
+        .Save(SortResultCachePath());
+  } catch (std::exception& e) {
     auto logger = getLogger();
     if (logger) {
-      logger->warn(
-          "255 normal plugins and at least one light master are active at the "
-          "same time.");
+      logger->error("Failed to save the sort result cache: {}", e.what());
     }
-    output.push_back(PlainTextMessage(
-        MessageType::warn,
-        boost::locale::translate(
-            "You have a normal plugin and at least one light master sharing "
-            "the FE load order index. Deactivate a normal plugin or all your "
-            "light masters to avoid potential issues.")));
   }
-
-  return output;
 }
 
-void Game::AppendMessage(const Message& message) {
-  lock_guard<mutex> guard(mutex_);
+std::optional<SortResultCache::Inputs> Game::GetPersistentSortInputs(
+    const SortInputs& inputs) const {
+  // Conditions in metadata can depend on any file in the Data directory, so
+  // the result can't be persisted without a snapshot of its entries.
+  if (SortResultCachePath().empty() || !inputs.metadataListsKey.has_value() ||
+      !inputs.dataDirectoryEntries.has_value()) {
+    return std::nullopt;
+  }
 
-  messages_.push_back(message);
+  SortResultCache::Inputs persistentInputs;
+  persistentInputs.metadataKey = inputs.metadataListsKey.value();
+  persistentInputs.loadOrder = inputs.loadOrder;
+  for (const auto& plugin : inputs.plugins) {
+    persistentInputs.plugins.emplace(
+        NormalizeFilename(pluginNames_->GetName(plugin.first)), plugin.second);
+  }
+  persistentInputs.dataDirectoryEntries = inputs.dataDirectoryEntries.value();
+
+  return persistentInputs;
 }
 
-void Game::ClearMessages() {
-  lock_guard<mutex> guard(mutex_);
+bool Game::LoadOrderFileFingerprint::operator==(
+    const LoadOrderFileFingerprint& other) const {
+  return path == other.path && exists == other.exists &&
+         size == other.size && contentHash == other.contentHash;
+}
 
-  messages_.clear();
+bool Game::LoadOrderStateFingerprint::operator==(
+    const LoadOrderStateFingerprint& other) const {
+  return dataDirectoryGeneration == other.dataDirectoryGeneration &&
+         files == other.files;
 }
 
-bool Game::UpdateMasterlist() {
-  bool wasUpdated = gameHandle_->GetDatabase()->UpdateMasterlist(
-      MasterlistPath(), RepoURL(), RepoBranch());
-  if (wasUpdated && !gameHandle_->GetDatabase()->IsLatestMasterlist(
-                        MasterlistPath(), RepoBranch())) {
-    AppendMessage(PlainTextMessage(
-        MessageType::error,
-        boost::locale::translate(
-            "The latest masterlist revision contains a syntax error, LOOT is "
-            "using the most recent valid revision instead. Syntax errors are "
-            "usually minor and fixed within hours.")));
+bool Game::SortInputs::Matches(const SortInputs& other) const {
+  if (metadataRevision != other.metadataRevision ||
+      loadOrder != other.loadOrder || plugins.size() != other.plugins.size() ||
+      dataDirectoryEntries != other.dataDirectoryEntries) {
+    return false;
   }
 
-  return wasUpdated;
-}
+  for (const auto& plugin : plugins) {
+    auto it = other.plugins.find(plugin.first);
+    if (it == other.plugins.end()) {
+      return false;
+    }
 
-MasterlistInfo Game::GetMasterlistInfo() const {
-  return gameHandle_->GetDatabase()->GetMasterlistRevision(MasterlistPath(),
-                                                           true);
+    auto fingerprint = plugin.second;
+    if (!fingerprint.crc.has_value() || !it->second.crc.has_value()) {
+      fingerprint.crc = it->second.crc;
+    }
+
+    if (fingerprint != it->second) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
-void Game::LoadMetadata() {
-  auto logger = getLogger();
+void Game::CountSortEdges(const std::vector<std::string>& sortedPlugins,
+                          SortProfile& profile) const {
+  std::unordered_set<std::string> normalizedNames;
+  for (const auto& pluginName : sortedPlugins) {
+    normalizedNames.insert(NormalizeFilename(pluginName));
+  }
 
-  std::filesystem::path masterlistPath;
-  std::filesystem::path userlistPath;
-  if (std::filesystem::exists(MasterlistPath())) {
-    if (logger) {
-      logger->debug("Preparing to parse masterlist.");
+  // Rules for plugins that aren't sorted don't produce edges.
+  auto countSortedFiles = [&](const auto& files) {
+    return static_cast<size_t>(
+        std::count_if(files.cbegin(), files.cend(), [&](const File& file) {
+          return normalizedNames.count(NormalizeFilename(file.GetName())) != 0;
+        }));
+  };
+
+  size_t masters = 0;
+  size_t nonMasters = 0;
+  size_t pluginsWithRecords = 0;
+  size_t masterEdges = 0;
+  size_t masterlistRequirementEdges = 0;
+  size_t userRequirementEdges = 0;
+  size_t masterlistLoadAfterEdges = 0;
+  size_t userLoadAfterEdges = 0;
+  for (const auto& pluginName : sortedPlugins) {
+    auto plugin = GetPlugin(pluginName);
+    if (!plugin) {
+      continue;
     }
-    masterlistPath = MasterlistPath();
-  }
 
-  if (std::filesystem::exists(UserlistPath())) {
-    if (logger) {
-      logger->debug("Preparing to parse userlist.");
+    if (plugin->IsMaster()) {
+      ++masters;
+    } else {
+      ++nonMasters;
+    }
+
+    if (!plugin->IsEmpty()) {
+      ++pluginsWithRecords;
+    }
+
+    for (const auto& master : plugin->GetMasters()) {
+      if (normalizedNames.count(NormalizeFilename(master)) != 0) {
+        ++masterEdges;
+      }
+    }
+
+    auto masterlistMetadata = GetMasterlistMetadata(pluginName, true);
+    if (masterlistMetadata.has_value()) {
+      masterlistRequirementEdges +=
+          countSortedFiles(masterlistMetadata.value().GetRequirements());
+      masterlistLoadAfterEdges +=
+          countSortedFiles(masterlistMetadata.value().GetLoadAfterFiles());
+    }
+
+    auto userMetadata = GetUserMetadata(pluginName, true);
+    if (userMetadata.has_value()) {
+      userRequirementEdges +=
+          countSortedFiles(userMetadata.value().GetRequirements());
+      userLoadAfterEdges +=
+          countSortedFiles(userMetadata.value().GetLoadAfterFiles());
     }
-    userlistPath = UserlistPath();
   }
 
+  // Every master loads before every non-master.
+  profile.edgeCounts = {
+      {DescribeEdgeType(EdgeType::masterFlag), masters * nonMasters},
+      {DescribeEdgeType(EdgeType::master), masterEdges},
+      {DescribeEdgeType(EdgeType::masterlistRequirement),
+       masterlistRequirementEdges},
+      {DescribeEdgeType(EdgeType::userRequirement), userRequirementEdges},
+      {DescribeEdgeType(EdgeType::masterlistLoadAfter),
+       masterlistLoadAfterEdges},
+      {DescribeEdgeType(EdgeType::userLoadAfter), userLoadAfterEdges},
+  };
+  profile.overlapCandidatePairs =
+      pluginsWithRecords > 1
+          ? pluginsWithRecords * (pluginsWithRecords - 1) / 2
+          : 0;
+}
+
+void Game::SetLastSortProfile(const SortProfile& profile) {
+  auto logger = getLogger();
   if (logger) {
-    logger->debug("Parsing metadata list(s).");
-  }
-  try {
-    gameHandle_->GetDatabase()->LoadLists(masterlistPath, userlistPath);
-  } catch (std::exception& e) {
-    if (logger) {
-      logger->error("An error occurred while parsing the metadata list(s): {}",
-                    e.what());
+    for (const auto& stage : profile.stages) {
+      logger->info(
+          "Sorting stage \"{}\" took {} us.", stage.name, stage.microseconds);
     }
-    AppendMessage(Message(
-        MessageType::error,
-        (boost::format(boost::locale::translate(
-             "An error occurred while parsing the metadata list(s): "
-             "%1%.\n\nTry updating your masterlist to resolve the error. If "
-             "the error is with your user metadata, this probably happened "
-             "because an update to LOOT changed its metadata syntax support. "
-             "Your user metadata will have to be updated manually.\n\nTo do "
-             "so, use the 'Open Debug Log Location' in LOOT's main menu to "
-             "open its data folder, then open your 'userlist.yaml' file in the "
-             "relevant game folder. You can then edit the metadata it contains "
-             "with reference to the documentation, which is accessible through "
-             "LOOT's main menu.\n\nYou can also seek support on LOOT's forum "
-             "thread, which is linked to on [LOOT's "
-             "website](https://loot.github.io/).")) %
-         EscapeMarkdownSpecialChars(e.what()))
-            .str()));
+    for (const auto& edgeCount : profile.edgeCounts) {
+      logger->debug("Sorting graph has up to {} edges of type \"{}\".",
+                    edgeCount.second,
+                    edgeCount.first);
+    }
+    logger->debug("Sorting may check {} pairs of plugins for overlap.",
+                  profile.overlapCandidatePairs);
   }
-}
 
-std::set<std::string> Game::GetKnownBashTags() const {
-  return gameHandle_->GetDatabase()->GetKnownBashTags();
+  lock_guard<mutex> guard(mutex_);
+  lastSortProfile_ = profile;
 }
 
-std::unordered_set<Group> Game::GetMasterlistGroups() const {
-  return gameHandle_->GetDatabase()->GetGroups(false);
+void Game::IncrementMetadataRevision() {
+  lock_guard<mutex> guard(mutex_);
+
+  ++metadataRevision_;
 }
 
-std::unordered_set<Group> Game::GetUserGroups() const {
-  return gameHandle_->GetDatabase()->GetUserGroups();
+void Game::IncrementDerivedMetadataRevision() {
+  lock_guard<mutex> guard(mutex_);
+
+  ++derivedMetadataRevision_;
 }
 
-std::optional<PluginMetadata> Game::GetMasterlistMetadata(
-    const std::string& pluginName,
-    bool evaluateConditions) const {
-  return gameHandle_->GetDatabase()->GetPluginMetadata(
-      pluginName, false, evaluateConditions);
+void Game::ClearEvaluatedMetadataIfStale() {
+  lock_guard<mutex> guard(mutex_);
+
+  const auto& activePlugins = GetActivePluginsLocked();
+  if (dataDirectoryEntries_ == evaluatedDataDirectoryEntries_ &&
+      activePlugins == evaluatedActivePlugins_) {
+    return;
+  }
+
+  // Without both snapshots of the Data directory, any file may have changed.
+  std::optional<std::unordered_set<std::string>> changedNames;
+  if (dataDirectoryEntries_.has_value() &&
+      evaluatedDataDirectoryEntries_.has_value()) {
+    changedNames = std::unordered_set<std::string>();
+    const auto addChangedEntries = [&](const auto& entries,
+                                       const auto& otherEntries) {
+      for (const auto& entry : entries) {
+        auto it = otherEntries.find(entry.first);
+        if (it == otherEntries.end() || it->second != entry.second) {
+          auto key = ConditionDependencyIndex::GetKey(entry.first);
+          if (key.has_value()) {
+            changedNames->insert(key.value());
+          }
+        }
+      }
+    };
+    addChangedEntries(dataDirectoryEntries_.value(),
+                      evaluatedDataDirectoryEntries_.value());
+    addChangedEntries(evaluatedDataDirectoryEntries_.value(),
+                      dataDirectoryEntries_.value());
+
+    const auto maxSize =
+        std::max(activePlugins.size(), evaluatedActivePlugins_.size());
+    for (PluginId id = 0; id < maxSize; ++id) {
+      const bool isActive = id < activePlugins.size() && activePlugins[id];
+      const bool wasActive =
+          id < evaluatedActivePlugins_.size() && evaluatedActivePlugins_[id];
+      if (isActive != wasActive) {
+        changedNames->insert(NormalizeFilename(pluginNames_->GetName(id)));
+      }
+    }
+  } else {
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug(
+          "The installed or active plugins have changed, discarding cached "
+          "evaluated metadata.");
+    }
+  }
+
+  ClearDependentMetadataLocked(changedNames, true);
+  evaluatedActivePlugins_ = activePlugins;
+  evaluatedDataDirectoryEntries_ = dataDirectoryEntries_;
 }
 
-std::optional<PluginMetadata> Game::GetUserMetadata(
-    const std::string& pluginName,
-    bool evaluateConditions) const {
-  return gameHandle_->GetDatabase()->GetPluginUserMetadata(pluginName,
-                                                           evaluateConditions);
+void Game::ClearGameHandleData() {
+  // The registered caches may be evicted from on other threads.
+  lock_guard<mutex> guard(mutex_);
+
+  messages_.clear();
+  simpleMessages_ = std::nullopt;
+  loadOrderSortCount_ = 0;
+  pluginsFullyLoaded_ = false;
+  dataDirectoryEntries_ = std::nullopt;
+  pluginValidityCache_ = std::nullopt;
+  derivedPluginFingerprints_.clear();
+  derivedMetadataJson_.clear();
+  groupIndex_ = nullptr;
+  ++groupsRevision_;
+  formIdOverlaps_.clear();
+  lightMasterValidity_.clear();
+  fullyLoadedPlugins_.clear();
+  fullyLoadedPluginsBytes_ = 0;
+  evaluatedMasterlistMetadata_.clear();
+  evaluatedUserMetadata_.clear();
+  evaluatedActivePlugins_.clear();
+  evaluatedDataDirectoryEntries_ = std::nullopt;
+  conditionDependencies_ = std::nullopt;
+  masterGraph_ = std::nullopt;
+  userMetadataPlugins_ = std::nullopt;
+  resolvedMetadata_ = std::nullopt;
+  prefetchedMasterlistUpdate_ = std::nullopt;
+  ++derivedMetadataRevision_;
+  lastSortResult_ = std::nullopt;
+  lastSortProfile_ = std::nullopt;
+  metadataListTimes_ = {};
+  metadataListsStale_ = false;
+  loadedMetadataListPaths_ = std::nullopt;
+  lastSetLoadOrder_ = std::nullopt;
+  loadOrderStateFingerprint_ = std::nullopt;
+  currentLoadOrderIndices_ = std::nullopt;
+  otherLoadOrderIndices_ = std::nullopt;
+  activePlugins_ = std::nullopt;
+  pluginView_ = std::nullopt;
+  ++pluginViewGeneration_;
 }
 
-void Game::SetUserGroups(const std::unordered_set<Group>& groups) {
-  return gameHandle_->GetDatabase()->SetUserGroups(groups);
+void Game::UpdateUserMetadataIndex(const std::string& pluginName) {
+  lock_guard<mutex> guard(mutex_);
+
+  // The index only holds loaded plugins.
+  if (!userMetadataPlugins_.has_value() ||
+      !gameHandle_->GetPlugin(pluginName)) {
+    return;
+  }
+
+  // The plugin may still have user metadata from a regex entry after its own
+  // entry is discarded, so check instead of assuming.
+  auto id = pluginNames_->Intern(pluginName);
+  if (GetResolvedMetadataLocked(pluginName).user.has_value()) {
+    userMetadataPlugins_->insert(id);
+  } else {
+    userMetadataPlugins_->erase(id);
+  }
 }
 
-void Game::AddUserMetadata(const PluginMetadata& metadata) {
-  gameHandle_->GetDatabase()->SetPluginUserMetadata(metadata);
+Game::ResolvedMetadata Game::ResolveMetadata(
+    const std::string& pluginName) const {
+  auto database = gameHandle_->GetDatabase();
+
+  return ResolvedMetadata{
+      database->GetPluginMetadata(pluginName, false, false),
+      database->GetPluginUserMetadata(pluginName, false),
+  };
 }
 
-void Game::ClearUserMetadata(const std::string& pluginName) {
-  gameHandle_->GetDatabase()->DiscardPluginUserMetadata(pluginName);
+void Game::ResolveAllMetadataLocked() const {
+  if (resolvedMetadata_.has_value()) {
+    return;
+  }
+
+  ScopedTimer timer("Game::ResolveAllMetadata");
+
+  // libloot doesn't expose the metadata lists' entries, so each plugin is
+  // still looked up separately, but only once per list.
+  std::unordered_map<PluginId, ResolvedMetadata> resolvedMetadata;
+  for (const auto& plugin : gameHandle_->GetLoadedPlugins()) {
+    resolvedMetadata.emplace(pluginNames_->Intern(plugin->GetName()),
+                             ResolveMetadata(plugin->GetName()));
+  }
+
+  resolvedMetadata_ = std::move(resolvedMetadata);
 }
 
-void Game::ClearAllUserMetadata() {
-  gameHandle_->GetDatabase()->DiscardAllUserMetadata();
+const Game::ResolvedMetadata& Game::GetResolvedMetadataLocked(
+    const std::string& pluginName) const {
+  ResolveAllMetadataLocked();
+
+  const auto id = pluginNames_->Intern(pluginName);
+  auto it = resolvedMetadata_->find(id);
+  if (it == resolvedMetadata_->end()) {
+    it = resolvedMetadata_->emplace(id, ResolveMetadata(pluginName)).first;
+  }
+
+  return it->second;
 }
 
-void Game::SaveUserMetadata() {
-  gameHandle_->GetDatabase()->WriteUserMetadata(UserlistPath(), true);
+void Game::DiscardResolvedMetadata(const std::string& pluginName) {
+  lock_guard<mutex> guard(mutex_);
+
+  if (!resolvedMetadata_.has_value()) {
+    return;
+  }
+
+  // A regex entry may apply to any plugin.
+  if (PluginMetadata(pluginName).IsRegexPlugin()) {
+    resolvedMetadata_ = std::nullopt;
+    return;
+  }
+
+  auto id = pluginNames_->Find(pluginName);
+  if (id.has_value()) {
+    resolvedMetadata_->erase(id.value());
+  }
 }
 
-std::vector<std::string> Game::GetInstalledPluginNames() {
-  std::vector<std::string> plugins;
+void Game::RecordUserMetadataEdit() {
+  lock_guard<mutex> guard(mutex_);
 
-  auto logger = getLogger();
-  if (logger) {
-    logger->trace("Scanning for plugins in {}", this->DataPath().u8string());
+  // The edit isn't in the userlist until it's saved, so the lists must be
+  // parsed again to discard it.
+  loadedMetadataListPaths_ = std::nullopt;
+  // The edited plugins' conditions may have changed.
+  conditionDependencies_ = std::nullopt;
+
+  if (isUserMetadataTransactionOpen_) {
+    userMetadataTransactionHasEdits_ = true;
   }
+}
 
-  for (fs::directory_iterator it(this->DataPath());
-       it != fs::directory_iterator();
-       ++it) {
-    if (fs::is_regular_file(it->status()) &&
-        gameHandle_->IsValidPlugin(it->path().filename().u8string())) {
-      string name = it->path().filename().u8string();
+void Game::WriteUserMetadata() {
+  // A deferred write may run after the game has been unloaded.
+  if (!gameHandle_) {
+    return;
+  }
 
-      if (logger) {
-        logger->info("Found plugin: {}", name);
-      }
+  auto tempPath = UserlistPath();
+  tempPath += ".tmp";
 
-      plugins.push_back(name);
-    }
+  {
+    // Deferred writes run on their own thread, so may otherwise read user
+    // metadata while a query is changing it.
+    lock_guard<mutex> userlistGuard(userlistMutex_);
+    gameHandle_->GetDatabase()->WriteUserMetadata(tempPath, true);
+    fs::rename(tempPath, UserlistPath());
   }
 
-  return plugins;
+  // Record the userlist's new modification time so that the write isn't
+  // mistaken for an external change.
+  auto metadataListTimes = GetMetadataListTimes();
+  lock_guard<mutex> guard(mutex_);
+  metadataListTimes_.second = metadataListTimes.second;
 }
 
-void Game::AppendMessages(std::vector<Message> messages) {
-  for (auto message : messages) {
-    AppendMessage(message);
+void Game::WriteDeferredUserMetadata() {
+  try {
+    WriteUserMetadata();
+  } catch (std::exception& e) {
+    // Nothing is waiting for a deferred write, so report its failure in the
+    // game's general messages.
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Failed to save the userlist. Details: {}", e.what());
+    }
+    AppendMessage(PlainTextMessage(
+        MessageType::error,
+        (boost::format(boost::locale::translate(
+             "Failed to save your metadata edits, they will be lost when "
+             "LOOT closes. Details: %1%")) %
+         e.what())
+            .str()));
   }
 }
+
+void Game::ClearActiveLoadOrderIndices() {
+  lock_guard<mutex> guard(mutex_);
+
+  currentLoadOrderIndices_ = std::nullopt;
+  otherLoadOrderIndices_ = std::nullopt;
+  activePlugins_ = std::nullopt;
+  pluginView_ = std::nullopt;
+  ++pluginViewGeneration_;
+}
 }
 }
@@ -26,60 +26,258 @@
 #ifndef LOOT_GUI_STATE_GAME_GAME
 #define LOOT_GUI_STATE_GAME_GAME
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
+#include "gui/state/cache_registry.h"
+#include "gui/state/debounced_task.h"
+#include "gui/state/game/bash_tag_set.h"
+#include "gui/state/game/condition_dependency_index.h"
 #include "gui/state/game/game_settings.h"
+#include "gui/state/game/master_graph.h"
+#include "gui/state/game/plugin_fingerprint.h"
+#include "gui/state/game/plugin_name_table.h"
+#include "gui/state/game/plugin_validity_cache.h"
+#include "gui/state/game/plugin_view.h"
+#include "gui/state/game/sort_profile.h"
+#include "gui/state/game/sort_result_cache.h"
 #include "loot/api.h"
 
 namespace loot {
 namespace gui {
+class MappedPluginFile;
+
+/**
+ * @brief A game's plugins, load order and metadata.
+ *
+ * Games use a reader/writer model for concurrency. Const member functions
+ * only read the game's plugins, load order and metadata, and guard the caches
+ * that they update with an internal mutex, so they can be called concurrently
+ * with each other. Non-const member functions may change what the const
+ * functions read, so must not be called concurrently with any other member
+ * function, unless they're documented as being safe to do so.
+ *
+ * The query worker pool is what provides exclusive access: queries that only
+ * call const functions run in the background and may run alongside each other
+ * for the same game, and all other queries run alone. The games manager also
+ * preloads and unloads games as exclusive tasks on the pool. A few functions
+ * are called from other threads and are synchronised internally instead:
+ * deferred userlist writes run on their own thread, and GetMemoryUsage() is
+ * called by the games manager and the memory monitor at any time.
+ */
 class Game : public GameSettings {
 public:
+  // Called with the name of a plugin and the number of plugins that have been
+  // read so far, out of the total number being read. Calls are serialised.
+  typedef std::function<void(const std::string& pluginName,
+                             size_t readCount,
+                             size_t totalCount)>
+      PluginReadProgressCallback;
+
+  struct MemoryUsage {
+    size_t pluginCount = 0;
+    std::uintmax_t estimatedBytes = 0;
+  };
+
+  // Two loaded plugins that have records with the same FormIDs. The first
+  // plugin loads before the second.
+  struct FormIdOverlap {
+    std::string plugin;
+    std::string otherPlugin;
+    size_t recordCount = 0;
+  };
+
+  // Changes made to the game's files by something other than LOOT.
+  struct ExternalChanges {
+    // The names of plugins that were added, removed or changed, without any
+    // .ghost extension.
+    std::set<std::string> plugins;
+    // Non-plugin files in the Data directory changed, which conditions may
+    // depend on.
+    bool dataDirectory = false;
+    bool loadOrder = false;
+    bool metadataLists = false;
+
+    bool IsEmpty() const;
+  };
+
   Game(const GameSettings& gameSettings,
        const std::filesystem::path& lootDataPath);
+  // Copying holds the other game's mutex, as its caches may be evicted from
+  // on other threads.
   Game(const Game& game);
+  // Completes any deferred userlist write.
+  ~Game();
 
   Game& operator=(const Game& game);
 
   using GameSettings::Type;
 
   void Init();
+  // Releases the libloot game handle and all data that depends on it. The
+  // game must be initialised again before it is next used.
+  void Unload();
+
+  // The estimate only covers loaded plugins, which use most of the memory.
+  MemoryUsage GetMemoryUsage() const;
 
   std::shared_ptr<const PluginInterface> GetPlugin(
       const std::string& name) const;
-  std::set<std::shared_ptr<const PluginInterface>> GetPlugins() const;
+  // The view is of a snapshot of the loaded plugins in load order, which is
+  // reused until plugins are loaded or the load order changes. Loaded plugins
+  // that aren't in the load order are at the end.
+  PluginView GetPlugins() const;
+  size_t PluginCount() const;
+  bool HasPlugins() const;
+  // Problems with the plugin's masters are read from a graph of all loaded
+  // plugins' masters that is validated once and then only revalidated for
+  // the dependents of plugins that change.
   std::vector<Message> CheckInstallValidity(
       const std::shared_ptr<const PluginInterface>& plugin,
       const PluginMetadata& metadata);
 
-  void RedatePlugins();  // Change timestamps to match load order (Skyrim only).
+  // Change timestamps to match load order (Skyrim only), returning the number
+  // of plugins that were redated.
+  size_t RedatePlugins();
 
+  // Loads all installed plugins. Their files are first read into the OS page
+  // cache in parallel, so that libloot's reads of them don't wait on the disk,
+  // and progress is reported as each file is read.
   void LoadAllInstalledPlugins(
-      bool headersOnly);  // Loads all installed plugins.
+      bool headersOnly,
+      const PluginReadProgressCallback& progressCallback =
+          PluginReadProgressCallback());
+  // Also loads the metadata lists, in parallel with the plugins, and then
+  // resolves all the loaded plugins' metadata. If
+  // updateMasterlist is true, the masterlist is updated before it is loaded,
+  // and the next call to UpdateMasterlist() returns the result of that update
+  // instead of updating the masterlist again.
+  void LoadAllInstalledPluginsAndMetadata(
+      bool headersOnly,
+      bool updateMasterlist,
+      const PluginReadProgressCallback& progressCallback =
+          PluginReadProgressCallback());
+  // The number of threads to read plugin files with when loading all
+  // installed plugins. 0 uses one thread per hardware thread.
+  void SetPluginReadingThreads(unsigned int threads);
   bool ArePluginsFullyLoaded()
       const;  // Checks if the game's plugins have already been loaded.
 
+  // Games that get their masterlists from the same repository branch share a
+  // copy of it, so that it's only cloned and fetched once. A game's own
+  // masterlist from before masterlists were shared is used until the shared
+  // copy is first created by a masterlist update. The path may therefore
+  // change when the masterlist is updated.
   std::filesystem::path MasterlistPath() const;
+  // The path that masterlist updates write to, which is the shared copy of
+  // the masterlist unless the game has no repository or LOOT data path.
+  std::filesystem::path MasterlistUpdatePath() const;
   std::filesystem::path UserlistPath() const;
   std::filesystem::path PluginsTxtPath() const;
+  std::filesystem::path PluginValidityCachePath() const;
+  // Empty if the game has no LOOT data path to keep a snapshot in.
+  std::filesystem::path GameDataSnapshotPath() const;
+  // Empty if the game has no LOOT data path to keep a cache in.
+  std::filesystem::path SortResultCachePath() const;
 
   std::vector<std::string> GetLoadOrder() const;
   void SetLoadOrder(const std::vector<std::string>& loadOrder);
 
+  // Active states are read from a snapshot of the load order state that is
+  // taken when it is first needed after the load order state is loaded or
+  // changed, so checking many plugins doesn't query the game handle for each.
   bool IsPluginActive(const std::string& pluginName) const;
+  std::optional<short> GetActiveLoadOrderIndex(
+      const std::shared_ptr<const PluginInterface>& plugin) const;
   std::optional<short> GetActiveLoadOrderIndex(
       const std::shared_ptr<const PluginInterface>& plugin,
       const std::vector<std::string>& loadOrder) const;
 
+  // Results are cached until plugins are next loaded. If plugins have only
+  // had their headers loaded, the FormIDs of the two plugins are read on
+  // demand, unless their masters show that they can't overlap.
+  bool DoFormIDsOverlap(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const std::shared_ptr<const PluginInterface>& otherPlugin) const;
+
+  // Reads the FormIDs of the given plugin and of the loaded plugins that may
+  // overlap it, so that they're read together instead of one at a time by
+  // DoFormIDsOverlap(). Does nothing if plugins are fully loaded.
+  void LoadFormIDsOfPossibleOverlaps(const std::string& pluginName) const;
+
+  // Get every pair of loaded plugins with overlapping FormIDs, in load order.
+  // Plugin files are scanned for their records' FormIDs in parallel, so this
+  // doesn't need plugins to be fully loaded, and each FormID is compared once
+  // instead of once per pair of plugins. Plugins that can't be scanned, and
+  // all Morrowind plugins, are skipped.
+  std::vector<FormIdOverlap> GetFormIdOverlaps() const;
+
+  // The revision is incremented whenever a change is made that could affect
+  // any plugin's derived metadata, so it can be used to invalidate caches of
+  // derived metadata.
+  unsigned int GetDerivedMetadataRevision() const;
+
+  PluginFingerprint GetPluginFingerprint(
+      const std::shared_ptr<const PluginInterface>& plugin) const;
+
+  // Plugins only have CRCs once they've been fully loaded, so if the plugin
+  // doesn't have one, this returns the CRC that was cached when it was last
+  // fully loaded, if its file hasn't changed since. CRCs are never
+  // calculated just to be returned.
+  std::optional<uint32_t> GetPluginCRC(
+      const std::shared_ptr<const PluginInterface>& plugin) const;
+
+  // Get and set the fingerprints of plugins at the time their derived metadata
+  // was last generated, keyed by normalised filename. Fingerprints are cleared
+  // when a change to metadata may affect plugins' derived metadata.
+  std::unordered_map<std::string, PluginFingerprint>
+  GetDerivedPluginFingerprints() const;
+  void SetDerivedPluginFingerprints(
+      const std::unordered_map<std::string, PluginFingerprint>& fingerprints);
+
+  // Get and set the JSON serialisations of plugins' derived metadata. A
+  // serialisation is only returned if it was derived in the same language and
+  // with the plugin at the same active load order index. It's discarded when
+  // the plugin, its metadata or the metadata lists change, or if it depends on
+  // other files and they or the active plugins change.
+  std::optional<std::string> GetDerivedMetadataJson(
+      const std::string& pluginName,
+      const std::string& language,
+      bool isActive,
+      std::optional<short> loadOrderIndex) const;
+  void SetDerivedMetadataJson(const std::string& pluginName,
+                              const std::string& language,
+                              bool isActive,
+                              std::optional<short> loadOrderIndex,
+                              bool dependsOnOtherFiles,
+                              std::string json);
+
   std::vector<std::string> SortPlugins();
+  // Get the profile of the last call to SortPlugins(), including calls that
+  // failed.
+  std::optional<SortProfile> GetLastSortProfile() const;
+  // Sort the plugins and store the result for SortPlugins() to reuse if its
+  // inputs haven't changed by the time it is called. Unlike SortPlugins(), this
+  // doesn't change the game's messages or load order sort count, and errors
+  // are only logged. Returns true if a result is stored.
+  bool PrecomputeSortResult();
   void IncrementLoadOrderSortCount();
   void DecrementLoadOrderSortCount();
 
   std::vector<Message> GetMessages() const;
+  // Get the game's messages in the given language. The result is cached until
+  // the messages or anything they depend on change.
+  std::vector<SimpleMessage> GetSimpleMessages(
+      const std::string& language) const;
   void AppendMessage(const Message& message);
   void ClearMessages();
 
@@ -87,11 +285,28 @@ public:
   MasterlistInfo GetMasterlistInfo() const;
 
   void LoadMetadata();
+  // True if the metadata lists have changed since they were loaded, and
+  // should be loaded again.
+  bool AreMetadataListsStale() const;
+  // Get the current modification times of the masterlist and userlist, or
+  // nullopt for lists that don't exist.
+  std::pair<std::optional<std::filesystem::file_time_type>,
+            std::optional<std::filesystem::file_time_type>>
+  GetMetadataListTimes() const;
   std::set<std::string> GetKnownBashTags() const;
+  // The table is shared until the metadata lists or groups next change.
+  std::shared_ptr<const BashTagTable> GetBashTagTable() const;
 
+  // Groups are indexed when they're first needed after the metadata lists or
+  // user groups change, so checking if a group exists is a single lookup
+  // instead of copying every group.
+  bool GroupExists(const std::string& groupName) const;
   std::unordered_set<Group> GetMasterlistGroups() const;
   std::unordered_set<Group> GetUserGroups() const;
 
+  // Evaluated metadata is cached until the metadata lists, load order or
+  // installed plugins change. Unevaluated metadata is read from the results
+  // of resolving all loaded plugins' metadata at once.
   std::optional<PluginMetadata> GetMasterlistMetadata(
       const std::string& pluginName,
       bool evaluateConditions = false) const;
@@ -99,23 +314,513 @@ public:
       const std::string& pluginName,
       bool evaluateConditions = false) const;
 
+  // Resolve the unevaluated masterlist and user metadata of all loaded
+  // plugins in one pass, if it hasn't already been resolved, so that later
+  // lookups don't each check a plugin's name against the metadata lists'
+  // regex entries. The results are kept until the metadata lists or loaded
+  // plugins change, and a plugin's user metadata is resolved again when it's
+  // edited.
+  void ResolveAllMetadata() const;
+
+  // Get the names of the loaded plugins that have user metadata, without
+  // copying their metadata. The names are in no particular order.
+  std::vector<std::string> GetPluginsWithUserMetadata() const;
+
   void SetUserGroups(const std::unordered_set<Group>& groups);
   void AddUserMetadata(const PluginMetadata& metadata);
   void ClearUserMetadata(const std::string& pluginName);
   void ClearAllUserMetadata();
+  // The userlist is written to a temporary file that then replaces it, so it
+  // is never left partially written. If a user metadata transaction is open,
+  // the write is deferred until the transaction is committed. If deferred
+  // saves are enabled, the write happens on a background thread once no other
+  // saves have been requested for the debounce interval, and if it fails an
+  // error message is added to the game's general messages.
   void SaveUserMetadata();
+  void EnableDeferredUserMetadataSaves(
+      std::chrono::milliseconds debounceInterval);
+  // Complete any deferred userlist write.
+  void FlushUserMetadata();
+
+  // A transaction groups user metadata edits so that they are saved once when
+  // it is committed, or discarded if it is rolled back. Committing writes the
+  // userlist immediately, even if deferred saves are enabled, and if the write
+  // fails the edits are rolled back and the error is thrown. Rolling back
+  // reloads the metadata lists, so beginning a transaction completes any
+  // deferred userlist write, and edits that were not saved before the
+  // transaction began are also discarded. Only one transaction can be open at a time:
+  // beginning another waits until the open transaction ends, so transactions
+  // must not be nested.
+  void BeginUserMetadataTransaction();
+  void CommitUserMetadataTransaction();
+  void RollbackUserMetadataTransaction();
+
+  // The directories that hold the files that the game's state is read from.
+  std::vector<std::filesystem::path> GetWatchedDirectories() const;
+  // Update the game's state to reflect the given changed paths, which are in
+  // or are one of the watched directories, and return what changed. The load
+  // order is reloaded if its files changed, metadata lists are marked as stale
+  // and changed plugins are marked as needing their metadata derived again.
+  // Changes that LOOT made itself are ignored.
+  ExternalChanges RecordExternalChanges(
+      const std::vector<std::filesystem::path>& paths);
+
+  // Replace the plugin's user metadata with the given metadata, or remove it if
+  // the given metadata only has a name. If the last sorted load order is still
+  // valid after the edit, the next sort reuses it instead of sorting again.
+  void ReplaceUserMetadata(const PluginMetadata& metadata);
 
 private:
+  // Light masters are counted separately from other plugins.
+  struct ActiveLoadOrderIndices {
+    std::vector<std::string> loadOrder;
+    std::unordered_map<PluginId, short> indices;
+    size_t activeLightMasterCount;
+    size_t activeNormalPluginCount;
+  };
+
+  struct SimpleMessages {
+    std::string language;
+    unsigned int messagesRevision;
+    unsigned int derivedMetadataRevision;
+    bool loadOrderSorted;
+    std::vector<SimpleMessage> messages;
+  };
+
+  // The state that sorting depends on, used to tell if the last sorted load
+  // order is still valid.
+  struct SortInputs {
+    std::vector<std::string> loadOrder;
+    std::unordered_map<PluginId, PluginFingerprint> plugins;
+    std::optional<std::unordered_map<std::string, PluginFingerprint>>
+        dataDirectoryEntries;
+    unsigned int metadataRevision;
+    // Identifies the metadata lists that the database was loaded from, or
+    // nullopt if the database may not match them, in which case the sort
+    // result isn't persisted.
+    std::optional<std::string> metadataListsKey;
+
+    // CRCs are only known for plugins that have been fully loaded, so they
+    // are only compared if both inputs have them.
+    bool Matches(const SortInputs& other) const;
+  };
+
+  struct SortResult {
+    SortInputs inputs;
+    std::vector<std::string> sortedPlugins;
+    std::vector<Message> messages;
+    SortProfile profile;
+  };
+
+  // Identifies a file that the load order state is read from, so that it
+  // can be checked for changes without reading it.
+  struct LoadOrderFileFingerprint {
+    std::filesystem::path path;
+    bool exists = false;
+    std::uintmax_t size = 0;
+    std::filesystem::file_time_type modificationTime;
+    // Only recalculated if the file's size or modification time change, so
+    // a file that's rewritten with the same content is unchanged.
+    size_t contentHash = 0;
+
+    bool operator==(const LoadOrderFileFingerprint& other) const;
+  };
+
+  struct LoadOrderStateFingerprint {
+    std::vector<LoadOrderFileFingerprint> files;
+    // Some games' load orders depend on the plugins in the Data directory
+    // and their timestamps.
+    unsigned int dataDirectoryGeneration = 0;
+
+    bool operator==(const LoadOrderStateFingerprint& other) const;
+  };
+
+  struct ResolvedMetadata {
+    std::optional<PluginMetadata> masterlist;
+    std::optional<PluginMetadata> user;
+  };
+
+  struct DerivedMetadataJson {
+    std::string language;
+    bool isActive;
+    std::optional<short> loadOrderIndex;
+    bool dependsOnOtherFiles;
+    std::string json;
+  };
+
+  struct GroupIndex {
+    unsigned int revision;
+    std::unordered_set<Group> masterlistGroups;
+    std::unordered_set<Group> userGroups;
+    // The names of the masterlist and user groups.
+    std::unordered_set<std::string> names;
+    // The known Bash Tags are indexed alongside the groups as both only
+    // change when the metadata lists are reloaded.
+    std::shared_ptr<const BashTagTable> bashTagTable;
+  };
+
+  struct FullyLoadedPlugin {
+    std::shared_ptr<const PluginInterface> plugin;
+    std::uintmax_t estimatedBytes;
+    std::uint64_t lastUsed;
+  };
+
+  // Delegated to by the copy constructor, with the other game's mutex held.
+  Game(const Game& game, const std::lock_guard<std::mutex>&);
+
+  struct MappedPluginFileEntry {
+    // The index of the plugin's name in the list that it was mapped from.
+    size_t index;
+    std::unique_ptr<MappedPluginFile> file;
+  };
+
+  // Also takes a snapshot of the Data directory's entries.
   std::vector<std::string> GetInstalledPluginNames();
+  // Must be called with the mutex held.
+  std::vector<Message> GetMessagesLocked() const;
   void AppendMessages(std::vector<Message> messages);
 
+  void PrefetchMasterlistUpdate();
+  bool UpdateMasterlistFromRemote();
+
+  bool DataFileExists(const std::string& filename) const;
+
+  std::shared_ptr<const GroupIndex> GetGroupIndex() const;
+  // Called after the metadata lists or user groups change.
+  void ClearGroupIndex();
+  // Adds a .ghost extension if the plugin is ghosted.
+  std::filesystem::path GetPluginFilePath(const std::string& pluginName) const;
+  // Map the files of the plugins in [begin, end) of the given names, sorted
+  // by file ID. Files that can't be mapped are skipped.
+  std::vector<MappedPluginFileEntry> MapPluginFiles(
+      const std::vector<std::string>& pluginNames,
+      size_t begin,
+      size_t end) const;
+  // Advise the OS to read the given plugins' whole files into its page cache
+  // ahead of them being loaded, up to a limited number of bytes. Returns
+  // without waiting for the reads.
+  void ReadAheadPluginFiles(const std::vector<std::string>& pluginNames) const;
+  // Read the given plugins' files, or only their header records if
+  // headersOnly is true, into the OS page cache, waiting for them to be read.
+  // The plugins are mapped, read ahead and read a window at a time, and each
+  // window is divided between threads by file size so that each thread reads
+  // about the same amount.
+  void ReadPluginFiles(
+      const std::vector<std::string>& pluginNames,
+      bool headersOnly,
+      const PluginReadProgressCallback& progressCallback) const;
+  // Uses the size recorded when the Data directory was last scanned, if
+  // there is one.
+  std::uintmax_t GetPluginFileSize(const std::string& pluginName) const;
+  // Cache the CRCs of loaded plugins that have them in the plugin validity
+  // cache, and save it if any were added.
+  void CachePluginCRCs();
+  std::uintmax_t GetEstimatedFormIdBytes(const std::string& pluginName) const;
+  // Evict the least recently used fully loaded plugins until their estimated
+  // size is at most targetBytes, keeping plugins last used at or after
+  // keepUsedSince. Must be called with the mutex held. Returns the estimated
+  // bytes freed.
+  std::uintmax_t EvictFullyLoadedPluginsLocked(
+      std::uintmax_t targetBytes,
+      std::uint64_t keepUsedSince) const;
+  // These must be called with the mutex held.
+  std::uintmax_t GetDerivedMetadataJsonBytesLocked() const;
+  std::uintmax_t GetFormIdOverlapsBytesLocked() const;
+  // Register the game's largest caches with the global cache registry.
+  void RegisterCaches();
+
+  // Compares the plugins' names and masters, so works when only the plugins'
+  // headers have been loaded.
+  bool MayFormIDsOverlap(const PluginInterface& plugin,
+                         const PluginInterface& otherPlugin) const;
+  // If only plugin headers are loaded, the plugin's record headers are
+  // scanned from a memory-mapped view of its file. Results are cached until
+  // plugins are next loaded.
+  bool IsValidAsLightMaster(const PluginInterface& plugin) const;
+  // Fully loads any of the given plugins that aren't already loaded, evicting
+  // the least recently used other fully loaded plugins to stay within budget.
+  std::vector<std::shared_ptr<const PluginInterface>> GetFullyLoadedPlugins(
+      const std::vector<std::string>& pluginNames) const;
+
+  // Must be called with the mutex held.
+  bool IsPluginActiveLocked(const std::string& pluginName) const;
+  // Must be called with the mutex held.
+  const std::vector<bool>& GetActivePluginsLocked() const;
+
+  // Must be called with the mutex held.
+  ActiveLoadOrderIndices GetActiveLoadOrderIndices(
+      const std::vector<std::string>& loadOrder) const;
+  // Also clears the snapshots of plugins' active states and of the loaded
+  // plugins.
+  void ClearActiveLoadOrderIndices();
+
+  void ClearDerivedPluginFingerprint(const std::string& pluginName);
+  void ClearDerivedPluginFingerprints();
+  // Discard the derived metadata serialisations that may depend on the given
+  // file or plugin.
+  void ClearDependentDerivedMetadataJson(const std::string& filename);
+  // Must be called with the mutex held. Discards the cached evaluated
+  // metadata, if clearEvaluatedMetadata is true, and the derived metadata
+  // serialisations that depend on other files, of the plugins whose metadata
+  // may depend on the given normalised file and plugin names, or of all
+  // plugins if changedNames is nullopt. Plugins that have changed plugins as
+  // masters are validated again.
+  void ClearDependentMetadataLocked(
+      const std::optional<std::unordered_set<std::string>>& changedNames,
+      bool clearEvaluatedMetadata);
+  // Must be called with the mutex held. Builds the index from the loaded
+  // plugins' unevaluated metadata if it has been discarded.
+  const ConditionDependencyIndex& GetConditionDependencyIndexLocked() const;
+  // Must be called with the mutex held. Builds the graph from the loaded
+  // plugins and validates all of them if it has been discarded.
+  MasterGraph& GetMasterGraphLocked() const;
+  // Must be called with the mutex held. The plugin is added to the graph if
+  // it wasn't loaded when the graph was built.
+  std::vector<MasterGraph::Problem> GetMasterProblemsLocked(
+      const PluginInterface& plugin) const;
+  // Must be called with the mutex held, as must the predicates. Get
+  // predicates for whether a plugin file exists and whether a plugin is
+  // active.
+  std::pair<MasterGraph::Predicate, MasterGraph::Predicate>
+  GetMasterGraphPredicatesLocked() const;
+  // Discard the derived metadata serialisations of plugins whose files were
+  // added, removed or changed when plugins were last loaded, or of all plugins
+  // if they were loaded differently.
+  void ClearChangedPluginsDerivedMetadataJson(
+      const std::optional<std::unordered_map<std::string, PluginFingerprint>>&
+          previousDataDirectoryEntries,
+      bool wereFullyLoaded);
+  void IncrementDerivedMetadataRevision();
+
+  // The files that the game's load order state is read from, which may not
+  // all exist.
+  std::vector<std::filesystem::path> GetLoadOrderStatePaths() const;
+  // File content hashes are reused from the previous fingerprint for files
+  // that have the same size and modification time.
+  LoadOrderStateFingerprint GetLoadOrderStateFingerprint(
+      const std::optional<LoadOrderStateFingerprint>& previous) const;
+  // Record the fingerprint of the load order state, which must match the
+  // game handle's state.
+  void RecordLoadOrderState();
+  // Reload the load order state from its files unconditionally, e.g. because
+  // they are known to have changed.
+  void ReloadLoadOrderState();
+  // Only reload the load order state if its files or the plugins in the
+  // Data directory have changed since it was last loaded or set, returning
+  // true if it was reloaded.
+  bool ReloadLoadOrderStateIfChanged();
+
+  // Record the current modification times of files that LOOT has just
+  // written, so that RecordExternalChanges() ignores them.
+  void RecordOwnWrites(const std::vector<std::filesystem::path>& paths);
+  // Returns true if the file is unchanged since LOOT last wrote it.
+  bool IsOwnWrite(const std::filesystem::path& path);
+  // The paths of the given plugins' files in the Data directory, including
+  // any .ghost extension, as the directory lists them.
+  std::vector<std::filesystem::path> GetPluginFilePaths(
+      const std::vector<std::string>& pluginNames) const;
+
+  SortInputs GetSortInputs(const std::vector<std::string>& loadOrder) const;
+  // Get the sorted load order that was persisted by an earlier session, if it
+  // was sorted from inputs that match the given inputs.
+  std::optional<std::vector<std::string>> LoadPersistedSortResult(
+      const SortInputs& inputs) const;
+  // Persist the sorted load order for later sessions. Errors are only logged.
+  void PersistSortResult(const SortInputs& inputs,
+                         const std::vector<std::string>& sortedPlugins) const;
+  // Returns nullopt if the inputs can't be persisted.
+  std::optional<SortResultCache::Inputs> GetPersistentSortInputs(
+      const SortInputs& inputs) const;
+  // Count the relationships between the given sorted plugins that produce
+  // sorting graph edges, and the plugin pairs that may be checked for overlap.
+  void CountSortEdges(const std::vector<std::string>& sortedPlugins,
+                      SortProfile& profile) const;
+  // Store the profile and log its stages.
+  void SetLastSortProfile(const SortProfile& profile);
+  // The revision is incremented whenever the loaded metadata lists change.
+  void IncrementMetadataRevision();
+
+  // Conditions can depend on the contents of the Data directory and on which
+  // plugins are active, so discard the cached evaluated metadata of the
+  // plugins with conditions on entries or active states that have changed
+  // since the metadata was evaluated. Only the Data directory's top-level
+  // entries are compared, so changes deeper inside its subdirectories may go
+  // unnoticed until the metadata lists are next loaded: see
+  // ConditionDependencyIndex.
+  void ClearEvaluatedMetadataIfStale();
+
+  void ClearGameHandleData();
+
+  // Record that user metadata has been edited, for rolling back transactions.
+  void RecordUserMetadataEdit();
+  void WriteUserMetadata();
+  // Write the userlist, adding an error message if that fails.
+  void WriteDeferredUserMetadata();
+
+  // Check if the plugin has user metadata after its user metadata changed,
+  // and update the index of plugins with user metadata if it has been built.
+  void UpdateUserMetadataIndex(const std::string& pluginName);
+
+  ResolvedMetadata ResolveMetadata(const std::string& pluginName) const;
+  // Must be called with the mutex held.
+  void ResolveAllMetadataLocked() const;
+  // Must be called with the mutex held. Plugins that weren't loaded when all
+  // metadata was resolved have their metadata resolved on demand.
+  const ResolvedMetadata& GetResolvedMetadataLocked(
+      const std::string& pluginName) const;
+  // Discard the plugin's resolved metadata after its user metadata changed,
+  // or all resolved metadata if the name is a regex.
+  void DiscardResolvedMetadata(const std::string& pluginName);
+
   std::shared_ptr<GameInterface> gameHandle_;
   std::vector<Message> messages_;
+  // Incremented whenever messages_ changes.
+  unsigned int messagesRevision_;
   std::filesystem::path lootDataPath_;
   unsigned short loadOrderSortCount_;
   bool pluginsFullyLoaded_;
 
+  // Fingerprints of the entries in the Data directory when plugins were last
+  // loaded, keyed by normalised filename, or nullopt if they haven't been
+  // loaded yet. Entry fingerprints have no CRC and are never active. The
+  // directory isn't scanned recursively, as it can hold hundreds of thousands
+  // of files.
+  std::optional<std::unordered_map<std::string, PluginFingerprint>>
+      dataDirectoryEntries_;
+  std::optional<PluginValidityCache> pluginValidityCache_;
+
+  std::unordered_map<std::string, PluginFingerprint> derivedPluginFingerprints_;
+  std::unordered_map<PluginId, DerivedMetadataJson> derivedMetadataJson_;
+  unsigned int derivedMetadataRevision_;
+
+  unsigned int metadataRevision_;
+  // The index of the loaded groups, shared between copies of the game as it's
+  // never modified. The revision is incremented whenever the groups change.
+  mutable std::shared_ptr<const GroupIndex> groupIndex_;
+  unsigned int groupsRevision_;
+  // The last successful sort's result, which is reused if sorting's inputs
+  // haven't changed since.
+  std::optional<SortResult> lastSortResult_;
+  std::optional<SortProfile> lastSortProfile_;
+  // The modification times of the masterlist and userlist when they were last
+  // read or written by LOOT, or nullopt if they didn't exist.
+  std::pair<std::optional<std::filesystem::file_time_type>,
+            std::optional<std::filesystem::file_time_type>>
+      metadataListTimes_;
+  bool metadataListsStale_;
+  // The masterlist and userlist paths that the database's metadata was last
+  // parsed from, with empty paths for lists that didn't exist, or nullopt if
+  // the database may no longer match the files.
+  std::optional<std::pair<std::filesystem::path, std::filesystem::path>>
+      loadedMetadataListPaths_;
+
+  // The load order that was last successfully set.
+  std::optional<std::vector<std::string>> lastSetLoadOrder_;
+  // The fingerprint of the load order state when the game handle's state was
+  // last loaded or set, or nullopt if it hasn't been loaded.
+  std::optional<LoadOrderStateFingerprint> loadOrderStateFingerprint_;
+  // The modification times of files that LOOT wrote itself, by path.
+  std::map<std::filesystem::path, std::filesystem::file_time_type>
+      ownWriteTimes_;
+  // Incremented whenever the snapshot of the Data directory's entries
+  // changes.
+  unsigned int dataDirectoryGeneration_;
+
+  // Shared between copies of the game, so that IDs mean the same thing in
+  // each copy's caches.
+  std::shared_ptr<PluginNameTable> pluginNames_;
+
+  // Keyed by the IDs of the two plugins, with the lower ID in the upper bits.
+  mutable std::unordered_map<std::uint64_t, bool> formIdOverlaps_;
+  // Whether light masters' records have FormIDs in the valid range.
+  mutable std::unordered_map<PluginId, bool> lightMasterValidity_;
+
+  // Plugins that have been fully loaded on demand while the game handle only
+  // holds plugin headers. They're loaded using temporary game handles, so
+  // this is what keeps them in memory.
+  mutable std::unordered_map<PluginId, FullyLoadedPlugin> fullyLoadedPlugins_;
+  mutable std::uintmax_t fullyLoadedPluginsBytes_;
+  mutable std::uint64_t fullyLoadedPluginsUseCount_;
+
+  mutable std::unordered_map<PluginId, std::optional<PluginMetadata>>
+      evaluatedMasterlistMetadata_;
+  mutable std::unordered_map<PluginId, std::optional<PluginMetadata>>
+      evaluatedUserMetadata_;
+  // The plugins that were active and the Data directory's entries when the
+  // cached evaluated metadata was last known to be valid, in the same forms
+  // as activePlugins_ and dataDirectoryEntries_.
+  std::vector<bool> evaluatedActivePlugins_;
+  std::optional<std::unordered_map<std::string, PluginFingerprint>>
+      evaluatedDataDirectoryEntries_;
+  // Maps the files and plugins that the loaded plugins' metadata refers to,
+  // to the plugins that refer to them, or nullopt if the index needs to be
+  // rebuilt.
+  mutable std::optional<ConditionDependencyIndex> conditionDependencies_;
+  // The loaded plugins' masters and the problems with them, which are kept
+  // up to date with the same changes as the cached evaluated metadata, or
+  // nullopt if the graph needs to be rebuilt.
+  mutable std::optional<MasterGraph> masterGraph_;
+
+  // The unevaluated metadata of the loaded plugins, or nullopt if it needs to
+  // be resolved again.
+  mutable std::optional<std::unordered_map<PluginId, ResolvedMetadata>>
+      resolvedMetadata_;
+
+  // The IDs of the loaded plugins that have user metadata, or nullopt if the
+  // index needs to be rebuilt.
+  mutable std::optional<std::unordered_set<PluginId>> userMetadataPlugins_;
+
+  // The result of a masterlist update that has not yet been returned by
+  // UpdateMasterlist().
+  std::optional<bool> prefetchedMasterlistUpdate_;
+
+  // The first cache is for the game's current load order, the second is for
+  // the last other load order that indices were requested for (e.g. a sorted
+  // load order that has not yet been applied).
+  mutable std::optional<ActiveLoadOrderIndices> currentLoadOrderIndices_;
+  mutable std::optional<ActiveLoadOrderIndices> otherLoadOrderIndices_;
+
+  // Whether each plugin is active, indexed by plugin ID. The vector is only
+  // as long as is needed to hold the highest active plugin ID, so two
+  // snapshots with the same active plugins are equal.
+  mutable std::optional<std::vector<bool>> activePlugins_;
+
+  // The last view returned by GetPlugins(). The generation is incremented
+  // whenever a view is created or the view is cleared.
+  mutable std::optional<PluginView> pluginView_;
+  mutable unsigned int pluginViewGeneration_;
+
+  // The last messages returned by GetSimpleMessages().
+  mutable std::optional<SimpleMessages> simpleMessages_;
+
+  // Held by the thread that has a user metadata transaction open.
+  std::mutex userMetadataTransactionMutex_;
+  bool isUserMetadataTransactionOpen_;
+  bool userMetadataTransactionHasEdits_;
+  bool userMetadataSaveRequested_;
+
+  std::optional<std::chrono::milliseconds> userMetadataSaveInterval_;
+  unsigned int pluginReadingThreads_;
+
   mutable std::mutex mutex_;
+  // Held while the database's user metadata is changed or written to the
+  // userlist. It's never held while waiting for a deferred write, as the
+  // write needs it.
+  std::mutex userlistMutex_;
+  // Held while plugins are fully loaded on demand, so that concurrent
+  // overlap checks don't load the same plugins twice.
+  mutable std::mutex fullLoadMutex_;
+
+  // Created when a save is first deferred. The task writes the userlist, so
+  // it's declared last so that it's destroyed before anything it uses.
+  std::unique_ptr<DebouncedTask> userMetadataSaveTask_;
+
+  // Their callbacks use the caches above, so they're declared after them so
+  // that they're unregistered before the caches are destroyed. They aren't
+  // copied with the game, as each game registers its own caches.
+  CacheRegistry::Registration fullyLoadedPluginsRegistration_;
+  CacheRegistry::Registration derivedMetadataJsonRegistration_;
+  CacheRegistry::Registration formIdOverlapsRegistration_;
 };
 }
 }
@@ -26,11 +26,22 @@
 #ifndef LOOT_GUI_STATE_GAME_GAMES_MANAGER
 #define LOOT_GUI_STATE_GAME_GAMES_MANAGER
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/locale.hpp>
@@ -43,64 +54,188 @@
 namespace loot {
 class GamesManager {
 public:
-  GamesManager() : currentGame_(installedGames_.end()) {}
+  // Runs a task that changes the given game's state once no queries for the
+  // game are running, e.g. by posting it to a query worker pool.
+  typedef std::function<void(const std::string& gameFolder,
+                             std::function<void()> task)>
+      GameTaskRunner;
+  typedef std::function<std::optional<std::filesystem::path>(
+      const GameSettings& gameSettings)>
+      GamePathFinder;
+
+  GamesManager() :
+      currentGame_(nullptr),
+      keepGamesLoaded_(false),
+      maxLoadedGames_(std::numeric_limits<size_t>::max()),
+      pluginReadingThreads_(0),
+      stopPreloading_(false),
+      gameDetectionTimeout_(DEFAULT_GAME_DETECTION_TIMEOUT) {}
+
+  // Derived classes must call StopPreloadingGames() in their destructors, as
+  // preloading calls PreloadGameData().
+  virtual ~GamesManager() {
+    InterruptPreloading();
+
+    // Searches that timed out may still be running. They don't refer to
+    // the manager, so those that haven't finished are left to run to
+    // completion rather than blocking destruction.
+    std::lock_guard<std::mutex> guard(gameDetectionMutex_);
+    for (auto& detection : gameDetections_) {
+      if (*detection.isFinished) {
+        detection.thread.join();
+      } else {
+        detection.thread.detach();
+      }
+    }
+  }
+
+  // Games are preloaded, and games that are over the loaded games limit are
+  // unloaded, through the given runner, so that they don't change while
+  // queries for them are running. If no runner is set, games are preloaded on
+  // the preloading thread and unloaded immediately.
+  void SetGameTaskRunner(GameTaskRunner runner) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    gameTaskRunner_ = runner;
+  }
+
+  // Games whose paths aren't found within the timeout are treated as not
+  // installed, so that an unreachable drive can't block loading the others.
+  void SetGameDetectionTimeout(std::chrono::milliseconds timeout) {
+    gameDetectionTimeout_ = timeout;
+  }
+
+  // Defer userlist writes for all installed games, including games that are
+  // installed later. See gui::Game::EnableDeferredUserMetadataSaves().
+  void EnableDeferredUserMetadataSaves(
+      std::chrono::milliseconds debounceInterval) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    userMetadataSaveInterval_ = debounceInterval;
+    for (auto& game : installedGames_) {
+      game->EnableDeferredUserMetadataSaves(debounceInterval);
+    }
+  }
+
+  // Set the number of threads that all installed games, including games that
+  // are installed later, read plugin files with. See
+  // gui::Game::SetPluginReadingThreads().
+  void SetPluginReadingThreads(unsigned int threads) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    pluginReadingThreads_ = threads;
+    for (auto& game : installedGames_) {
+      game->SetPluginReadingThreads(threads);
+    }
+  }
+
+  // Complete any deferred userlist writes for all installed games.
+  void FlushUserMetadata() {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    for (auto& game : installedGames_) {
+      game->FlushUserMetadata();
+    }
+  }
 
   // Installed games have their game paths set in the returned settings.
   std::vector<GameSettings> LoadInstalledGames(
       std::vector<GameSettings> gamesSettings,
       const std::filesystem::path& lootDataPath) {
+    // Preloading uses references to installed games, so must be stopped
+    // before any are replaced or removed.
+    InterruptPreloading();
+
+    // Finding game paths doesn't touch any members, so is done before
+    // locking to avoid blocking access to the current game while waiting.
+    auto gamePaths = FindGamePaths(gamesSettings);
+
+    std::lock_guard<std::mutex> preloadGuard(preloadMutex_);
     std::lock_guard<std::recursive_mutex> guard(mutex_);
 
     auto logger = getLogger();
 
     std::optional<std::string> currentGameFolder;
-    if (currentGame_ != installedGames_.end()) {
+    if (currentGame_ != nullptr) {
       currentGameFolder = currentGame_->FolderName();
     }
 
+    // Games that are kept are moved into the new list, so they keep their
+    // addresses and references to them stay valid.
     bool currentGameUpdated = false;
-    std::vector<gui::Game> installedGames;
-    for (auto& gameSettings : gamesSettings) {
-      auto gamePath = FindGamePath(gameSettings);
+    std::vector<std::unique_ptr<gui::Game>> installedGames;
+    std::unordered_set<std::string> preloadedGames;
+    for (size_t i = 0; i < gamesSettings.size(); ++i) {
+      auto& gameSettings = gamesSettings[i];
+      const auto& gamePath = gamePaths[i];
       if (!gamePath.has_value()) {
         continue;
       }
       gameSettings.SetGamePath(gamePath.value());
 
-      if (currentGameFolder.has_value() &&
-          currentGameFolder.value() == gameSettings.FolderName() &&
-          !GameNeedsRecreating(GetCurrentGame(), gameSettings)) {
+      // Keep the data of games that have been loaded if possible.
+      bool isCurrentGame =
+          currentGameFolder.has_value() &&
+          currentGameFolder.value() == gameSettings.FolderName();
+      bool isPreloadedGame =
+          preloadedGames_.count(gameSettings.FolderName()) != 0;
+      auto existingGame = std::find_if(
+          installedGames_.begin(),
+          installedGames_.end(),
+          [&](const std::unique_ptr<gui::Game>& game) {
+            return game && game->FolderName() == gameSettings.FolderName();
+          });
+
+      if ((isCurrentGame || isPreloadedGame) &&
+          existingGame != installedGames_.end() &&
+          !GameNeedsRecreating(**existingGame, gameSettings)) {
         if (logger) {
           logger->trace("Updating game entry for: {}",
                         gameSettings.FolderName());
         }
 
-        GetCurrentGame()
-            .SetName(gameSettings.Name())
+        (*existingGame)
+            ->SetName(gameSettings.Name())
             .SetMinimumHeaderVersion(gameSettings.MinimumHeaderVersion())
             .SetRegistryKey(gameSettings.RegistryKey())
             .SetRepoURL(gameSettings.RepoURL())
             .SetRepoBranch(gameSettings.RepoBranch());
 
-        installedGames.push_back(GetCurrentGame());
-        currentGameUpdated = true;
+        installedGames.push_back(std::move(*existingGame));
+        if (isCurrentGame) {
+          currentGameUpdated = true;
+        } else {
+          preloadedGames.insert(gameSettings.FolderName());
+        }
       } else {
         if (logger) {
           logger->trace("Adding new installed game entry for: {}",
                         gameSettings.FolderName());
         }
 
-        installedGames.push_back(gui::Game(gameSettings, lootDataPath));
+        installedGames.push_back(
+            std::make_unique<gui::Game>(gameSettings, lootDataPath));
+        installedGames.back()->SetPluginReadingThreads(pluginReadingThreads_);
+        if (userMetadataSaveInterval_.has_value()) {
+          installedGames.back()->EnableDeferredUserMetadataSaves(
+              userMetadataSaveInterval_.value());
+        }
       }
     }
-    installedGames_ = installedGames;
+    installedGames_ = std::move(installedGames);
+    preloadedGames_ = preloadedGames;
+    currentGame_ = nullptr;
+
+    // Recreated games don't have any data loaded.
+    loadedGames_.remove_if([&](const std::string& folderName) {
+      return preloadedGames_.count(folderName) == 0 &&
+             !(currentGameUpdated && folderName == currentGameFolder.value());
+    });
 
     if (currentGameUpdated) {
       SetCurrentGameWithoutInit(currentGameFolder.value());
     } else if (currentGameFolder.has_value()) {
-      SetCurrentGame(currentGameFolder.value());
-    } else {
-      currentGame_ = installedGames_.end();
+      SetCurrentGameWithPreloadLock(currentGameFolder.value());
     }
 
     return gamesSettings;
@@ -109,7 +244,7 @@ public:
   gui::Game& GetCurrentGame() {
     std::lock_guard<std::recursive_mutex> guard(mutex_);
 
-    if (currentGame_ == installedGames_.end()) {
+    if (currentGame_ == nullptr) {
       throw std::runtime_error("No current game to get.");
     }
 
@@ -119,7 +254,7 @@ public:
   const gui::Game& GetCurrentGame() const {
     std::lock_guard<std::recursive_mutex> guard(mutex_);
 
-    if (currentGame_ == installedGames_.end()) {
+    if (currentGame_ == nullptr) {
       throw std::runtime_error("No current game to get.");
     }
 
@@ -127,8 +262,80 @@ public:
   }
 
   void SetCurrentGame(const std::string& newGameFolder) {
-    SetCurrentGameWithoutInit(newGameFolder);
-    InitialiseGameData(GetCurrentGame());
+    // If the new game is being preloaded, wait for that to finish.
+    std::unique_lock<std::mutex> preloadLock(preloadMutex_);
+    preloadFinished_.wait(preloadLock, [&]() {
+      return preloadingGameFolder_ != newGameFolder;
+    });
+
+    SetCurrentGameWithPreloadLock(newGameFolder);
+  }
+
+  // Initialise and load the plugin headers and metadata of installed games
+  // other than the current game on a background thread, so that switching to
+  // them is quick. Games stay loaded once they've been switched away from.
+  void PreloadGames() {
+    std::lock_guard<std::mutex> threadGuard(preloadThreadMutex_);
+
+    StopPreloadThread();
+
+    keepGamesLoaded_ = true;
+    stopPreloading_ = false;
+    preloadThread_ = std::thread([this]() { PreloadGamesInBackground(); });
+  }
+
+  void StopPreloadingGames() {
+    std::lock_guard<std::mutex> threadGuard(preloadThreadMutex_);
+
+    keepGamesLoaded_ = false;
+    StopPreloadThread();
+  }
+
+  // Unload games that were preloaded or kept loaded after being switched away
+  // from, so that turning preloading off frees their memory. Preloading must
+  // be stopped first, so that no more games are preloaded.
+  void UnloadPreloadedGames() {
+    std::lock_guard<std::mutex> preloadGuard(preloadMutex_);
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    for (const auto& folderName : preloadedGames_) {
+      loadedGames_.remove(folderName);
+
+      auto game = FindInstalledGame(folderName);
+      if (game == nullptr || game == currentGame_) {
+        continue;
+      }
+
+      if (gameTaskRunner_) {
+        gameTaskRunner_(folderName,
+                        [this, folderName]() { UnloadUnusedGame(folderName); });
+      } else {
+        UnloadGameData(*game);
+      }
+    }
+
+    preloadedGames_.clear();
+  }
+
+  // Games other than the current game are unloaded, least recently used
+  // first, until no more than the given number of games have data loaded.
+  // The limit can't be below 2, as queries for the previous game may still be
+  // running just after the current game is changed.
+  void SetMaxLoadedGames(size_t maxLoadedGames) {
+    std::lock_guard<std::mutex> preloadGuard(preloadMutex_);
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    maxLoadedGames_ = maxLoadedGames < 2 ? 2 : maxLoadedGames;
+    UnloadLeastRecentlyUsedGames();
+  }
+
+  // Block until all games that can be preloaded have been.
+  void WaitForPreloadedGames() {
+    std::lock_guard<std::mutex> threadGuard(preloadThreadMutex_);
+
+    if (preloadThread_.joinable()) {
+      preloadThread_.join();
+    }
   }
 
   std::vector<std::string> GetInstalledGameFolderNames() const {
@@ -136,7 +343,7 @@ public:
 
     std::vector<std::string> installedGames;
     for (const auto& game : installedGames_) {
-      installedGames.push_back(game.FolderName());
+      installedGames.push_back(game->FolderName());
     }
 
     return installedGames;
@@ -144,16 +351,121 @@ public:
 
   std::optional<std::string> GetFirstInstalledGameFolderName() const {
     if (!installedGames_.empty()) {
-      return installedGames_.front().FolderName();
+      return installedGames_.front()->FolderName();
     }
 
     return std::nullopt;
   }
 
 private:
-  virtual std::optional<std::filesystem::path> FindGamePath(
-      const GameSettings& gameSettings) const = 0;
+  // The returned function is called on game detection threads, which may
+  // outlive the manager, so it must not refer to the manager.
+  virtual GamePathFinder GetGamePathFinder() const = 0;
   virtual void InitialiseGameData(gui::Game& game) = 0;
+  // Called through the game task runner, or on the preloading thread if no
+  // runner is set.
+  virtual void PreloadGameData(gui::Game& game) = 0;
+  virtual void UnloadGameData(gui::Game& game) = 0;
+  virtual gui::Game::MemoryUsage GetMemoryUsage(const gui::Game& game) const {
+    return game.GetMemoryUsage();
+  }
+
+  // Loaded plugin headers are a similar size, so the number of plugins
+  // loaded is used to limit how much memory preloaded games may take up.
+  static constexpr size_t MAX_PRELOADED_PLUGINS = 1000;
+
+  // Checking a path on a disconnected network drive can take tens of seconds
+  // to fail, while checking an available path usually takes milliseconds.
+  static constexpr std::chrono::milliseconds DEFAULT_GAME_DETECTION_TIMEOUT{
+      5000};
+
+  struct GameDetection {
+    std::thread thread;
+    std::shared_ptr<std::atomic<bool>> isFinished;
+  };
+
+  // Join the threads of earlier searches that have since finished, so that
+  // repeated detection doesn't accumulate threads.
+  void JoinFinishedGameDetections() {
+    std::lock_guard<std::mutex> guard(gameDetectionMutex_);
+    auto it = gameDetections_.begin();
+    while (it != gameDetections_.end()) {
+      if (*it->isFinished) {
+        it->thread.join();
+        it = gameDetections_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // Find the paths of the given games concurrently, waiting no longer than
+  // the detection timeout in total. Games that are still being looked for
+  // when it expires are treated as not installed, and the search for them is
+  // left to finish in the background. GameSettings::FindGamePath() checks the
+  // last known path first, so games that haven't moved are found quickly.
+  std::vector<std::optional<std::filesystem::path>> FindGamePaths(
+      const std::vector<GameSettings>& gamesSettings) {
+    typedef std::promise<std::optional<std::filesystem::path>> PathPromise;
+
+    JoinFinishedGameDetections();
+
+    const auto findGamePath = GetGamePathFinder();
+
+    std::vector<std::future<std::optional<std::filesystem::path>>> futures;
+    for (const auto& gameSettings : gamesSettings) {
+      auto promise = std::make_shared<PathPromise>();
+      futures.push_back(promise->get_future());
+
+      GameDetection detection;
+      detection.isFinished = std::make_shared<std::atomic<bool>>(false);
+      detection.thread =
+          std::thread([findGamePath,
+                       promise,
+                       gameSettings,
+                       isFinished = detection.isFinished]() {
+            try {
+              promise->set_value(findGamePath(gameSettings));
+            } catch (...) {
+              promise->set_exception(std::current_exception());
+            }
+
+            *isFinished = true;
+          });
+
+      std::lock_guard<std::mutex> guard(gameDetectionMutex_);
+      gameDetections_.push_back(std::move(detection));
+    }
+
+    auto logger = getLogger();
+    const auto deadline =
+        std::chrono::steady_clock::now() + gameDetectionTimeout_.load();
+
+    std::vector<std::optional<std::filesystem::path>> gamePaths;
+    for (size_t i = 0; i < futures.size(); ++i) {
+      if (futures[i].wait_until(deadline) == std::future_status::ready) {
+        try {
+          gamePaths.push_back(futures[i].get());
+          continue;
+        } catch (std::exception& e) {
+          if (logger) {
+            logger->error("Failed to check if game \"{}\" is installed: {}",
+                          gamesSettings[i].Name(),
+                          e.what());
+          }
+        }
+      } else if (logger) {
+        logger->warn(
+            "Timed out while checking if game \"{}\" is installed, treating "
+            "it as not installed.",
+            gamesSettings[i].Name());
+      }
+
+      gamePaths.push_back(std::nullopt);
+    }
+
+    return gamePaths;
+  }
 
   static bool GameNeedsRecreating(const gui::Game& game,
                                   const GameSettings& newSettings) {
@@ -169,12 +481,9 @@ private:
                     newGameFolder);
     }
 
-    currentGame_ = find_if(
-        installedGames_.begin(), installedGames_.end(), [&](const gui::Game& game) {
-          return newGameFolder == game.FolderName();
-        });
+    currentGame_ = FindInstalledGame(newGameFolder);
 
-    if (currentGame_ == installedGames_.end()) {
+    if (currentGame_ == nullptr) {
       logger->error(
           "Cannot set the current game: the game with folder \"{}\" is not "
           "installed.",
@@ -189,11 +498,301 @@ private:
     }
   }
 
-  std::vector<gui::Game> installedGames_;
-  std::vector<gui::Game>::iterator currentGame_;
+  // Must be called with preloadMutex_ locked.
+  void SetCurrentGameWithPreloadLock(const std::string& newGameFolder) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    std::optional<std::string> previousGameFolder;
+    if (currentGame_ != nullptr) {
+      previousGameFolder = currentGame_->FolderName();
+    }
+
+    SetCurrentGameWithoutInit(newGameFolder);
+
+    bool wasPreloaded = preloadedGames_.erase(newGameFolder) != 0;
+
+    // Keep the previous game's data so that switching back to it is quick.
+    if (keepGamesLoaded_ && previousGameFolder.has_value() &&
+        previousGameFolder.value() != newGameFolder &&
+        GetPreloadedPluginCount() < MAX_PRELOADED_PLUGINS) {
+      preloadedGames_.insert(previousGameFolder.value());
+    }
+
+    loadedGames_.remove(newGameFolder);
+    loadedGames_.push_front(newGameFolder);
+
+    if (wasPreloaded) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->debug("Using preloaded data for game: {}", newGameFolder);
+      }
+    } else {
+      InitialiseGameData(GetCurrentGame());
+    }
+
+    UnloadLeastRecentlyUsedGames();
+  }
+
+  // Must be called with preloadMutex_ and mutex_ locked.
+  void UnloadLeastRecentlyUsedGames() {
+    auto logger = getLogger();
+
+    while (loadedGames_.size() > maxLoadedGames_) {
+      auto folderName = loadedGames_.back();
+      loadedGames_.pop_back();
+      preloadedGames_.erase(folderName);
+
+      auto game = FindInstalledGame(folderName);
+      if (game == nullptr || game == currentGame_) {
+        continue;
+      }
+
+      if (logger) {
+        auto usage = GetMemoryUsage(*game);
+        logger->info(
+            "Unloading the least recently used game {}, which has {} plugins "
+            "loaded using an estimated {} KiB of memory.",
+            folderName,
+            usage.pluginCount,
+            usage.estimatedBytes / 1024);
+      }
+
+      if (gameTaskRunner_) {
+        gameTaskRunner_(folderName,
+                        [this, folderName]() { UnloadUnusedGame(folderName); });
+      } else {
+        UnloadGameData(*game);
+      }
+    }
+  }
+
+  // Unload the game unless it has been loaded again since it was chosen to
+  // be unloaded, or it's being preloaded.
+  void UnloadUnusedGame(const std::string& folderName) {
+    std::lock_guard<std::mutex> preloadGuard(preloadMutex_);
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    auto game = FindInstalledGame(folderName);
+    if (game == nullptr || game == currentGame_ ||
+        preloadingGameFolder_ == folderName ||
+        std::find(loadedGames_.begin(), loadedGames_.end(), folderName) !=
+            loadedGames_.end()) {
+      return;
+    }
+
+    UnloadGameData(*game);
+  }
+
+  // Returns nullptr if there is no installed game with the given folder.
+  gui::Game* FindInstalledGame(const std::string& folderName) {
+    auto it = find_if(installedGames_.begin(),
+                      installedGames_.end(),
+                      [&](const std::unique_ptr<gui::Game>& game) {
+                        return folderName == game->FolderName();
+                      });
+
+    return it == installedGames_.end() ? nullptr : it->get();
+  }
+
+  size_t GetPreloadedPluginCount() {
+    size_t pluginCount = 0;
+    for (const auto& folderName : preloadedGames_) {
+      auto game = FindInstalledGame(folderName);
+      if (game != nullptr) {
+        pluginCount += GetMemoryUsage(*game).pluginCount;
+      }
+    }
+
+    return pluginCount;
+  }
+
+  void PreloadGamesInBackground() {
+    auto logger = getLogger();
+
+    for (const auto& folderName : GetInstalledGameFolderNames()) {
+      if (stopPreloading_) {
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> preloadGuard(preloadMutex_);
+        std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+        if (GetPreloadedPluginCount() >= MAX_PRELOADED_PLUGINS) {
+          if (logger) {
+            logger->info(
+                "Not preloading any more games, as the preloaded games' "
+                "plugin limit has been reached.");
+          }
+          return;
+        }
+
+        auto installedGame = FindInstalledGame(folderName);
+        if (installedGame == nullptr || installedGame == currentGame_ ||
+            preloadedGames_.count(folderName) != 0) {
+          continue;
+        }
+
+        bool isLoaded = std::find(loadedGames_.begin(),
+                                  loadedGames_.end(),
+                                  folderName) != loadedGames_.end();
+        if (!isLoaded && loadedGames_.size() >= maxLoadedGames_) {
+          if (logger) {
+            logger->info(
+                "Not preloading any more games, as the limit of loaded games "
+                "has been reached.");
+          }
+          return;
+        }
+      }
+
+      RunPreloadTask(folderName);
+    }
+  }
+
+  // Preloading changes the game's state, so it's run through the game task
+  // runner if one is set, so that it doesn't run alongside queries for the
+  // game. The preloading thread waits for each game to be preloaded before
+  // moving on to the next.
+  void RunPreloadTask(const std::string& folderName) {
+    GameTaskRunner runner;
+    {
+      std::lock_guard<std::recursive_mutex> guard(mutex_);
+      runner = gameTaskRunner_;
+    }
+
+    if (!runner) {
+      PreloadGame(folderName);
+      return;
+    }
+
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    runner(folderName, [this, folderName, promise]() {
+      PreloadGame(folderName);
+      promise->set_value();
+    });
+
+    try {
+      future.get();
+    } catch (std::future_error&) {
+      // The runner discarded the task without running it, e.g. because it
+      // is being destroyed.
+    }
+  }
+
+  // The game may have become the current game or preloading may have been
+  // stopped since the preload was requested, in which case it's skipped.
+  void PreloadGame(const std::string& folderName) {
+    auto logger = getLogger();
+
+    gui::Game* game = nullptr;
+    {
+      std::lock_guard<std::mutex> preloadGuard(preloadMutex_);
+      std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+      game = FindInstalledGame(folderName);
+      if (stopPreloading_ || game == nullptr || game == currentGame_) {
+        return;
+      }
+
+      preloadingGameFolder_ = folderName;
+    }
+
+    if (logger) {
+      logger->debug("Preloading data for game: {}", folderName);
+    }
+
+    bool wasPreloaded = false;
+    try {
+      PreloadGameData(*game);
+      wasPreloaded = true;
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->error(
+            "Failed to preload data for game {}: {}", folderName, e.what());
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> preloadGuard(preloadMutex_);
+      std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+      preloadingGameFolder_ = std::nullopt;
+      if (wasPreloaded) {
+        preloadedGames_.insert(folderName);
+      }
+
+      // Preloaded games haven't been used yet, so are the least recently
+      // used games. A game that failed to preload may still have some data
+      // loaded.
+      loadedGames_.remove(folderName);
+      loadedGames_.push_back(folderName);
+
+      if (wasPreloaded && logger) {
+        auto usage = GetMemoryUsage(*game);
+        logger->debug(
+            "Preloaded game {} has {} plugins loaded using an estimated {} "
+            "KiB of memory.",
+            folderName,
+            usage.pluginCount,
+            usage.estimatedBytes / 1024);
+      }
+    }
+    preloadFinished_.notify_all();
+  }
+
+  // Must be called with preloadThreadMutex_ locked.
+  void StopPreloadThread() {
+    stopPreloading_ = true;
+    if (preloadThread_.joinable()) {
+      preloadThread_.join();
+    }
+  }
+
+  void InterruptPreloading() {
+    std::lock_guard<std::mutex> threadGuard(preloadThreadMutex_);
+
+    StopPreloadThread();
+  }
+
+  // Games are held by pointer so that their addresses don't change when the
+  // list of installed games is updated, as references to them are held by
+  // running queries and the preloading thread.
+  std::vector<std::unique_ptr<gui::Game>> installedGames_;
+  // Points into installedGames_, or is nullptr if there is no current game.
+  gui::Game* currentGame_;
+
+  // The folder names of games other than the current game that have been
+  // initialised and had their plugins and metadata loaded.
+  std::unordered_set<std::string> preloadedGames_;
+  std::atomic<bool> keepGamesLoaded_;
+
+  // The folder names of the games that have data loaded, including the current
+  // game, in order of most to least recently used.
+  std::list<std::string> loadedGames_;
+  size_t maxLoadedGames_;
+  GameTaskRunner gameTaskRunner_;
+  unsigned int pluginReadingThreads_;
 
   // Mutex used to protect access to member variables.
   mutable std::recursive_mutex mutex_;
+
+  // Used to wait for a game that is being preloaded. Must be locked before
+  // mutex_ if both are locked.
+  std::mutex preloadMutex_;
+  std::condition_variable preloadFinished_;
+  std::optional<std::string> preloadingGameFolder_;
+
+  std::mutex preloadThreadMutex_;
+  std::thread preloadThread_;
+  std::atomic<bool> stopPreloading_;
+
+  std::optional<std::chrono::milliseconds> userMetadataSaveInterval_;
+
+  std::atomic<std::chrono::milliseconds> gameDetectionTimeout_;
+  std::mutex gameDetectionMutex_;
+  std::vector<GameDetection> gameDetections_;
 };
 }
 
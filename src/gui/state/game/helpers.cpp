@@ -25,13 +25,24 @@
 
 #include "gui/state/game/helpers.h"
 
+#include <algorithm>
+#include <array>
 #include <fstream>
-#include <regex>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
+#include "gui/helpers.h"
+#include "gui/state/game/message_templates.h"
+
 namespace loot {
 bool ExecutableExists(const GameType& gameType,
                       const std::filesystem::path& gamePath) {
@@ -49,55 +60,162 @@ void BackupLoadOrder(const std::vector<std::string>& loadOrder,
   const int maxBackupIndex = 2;
   boost::format filenameFormat = boost::format("loadorder.bak.%1%");
 
-  std::filesystem::path backupFilePath =
-      backupDirectory / (filenameFormat % 2).str();
-  if (std::filesystem::exists(backupFilePath)) {
-    std::filesystem::remove(backupFilePath);
+  // Write the new backup in one go to a temporary file, so that an interrupted
+  // write can't leave a truncated backup in place of a good one.
+  std::string content;
+  for (const auto& plugin : loadOrder) {
+    content.append(plugin).push_back('\n');
   }
 
+  const auto tempFilePath = backupDirectory / "loadorder.bak.tmp";
+  std::ofstream out(tempFilePath);
+  out.write(content.data(), content.size());
+  out.close();
+  if (out.fail()) {
+    throw std::runtime_error("Failed to write load order backup to " +
+                             tempFilePath.u8string());
+  }
+
+  // Renaming a file replaces any file at its destination, so the oldest backup
+  // doesn't need to be removed first, and missing backups can be skipped
+  // without checking for them.
   for (int i = maxBackupIndex - 1; i > -1; --i) {
-    const std::filesystem::path backupFilePath =
-        backupDirectory / (filenameFormat % i).str();
-    if (std::filesystem::exists(backupFilePath)) {
-      std::filesystem::rename(
-          backupFilePath, backupDirectory / (filenameFormat % (i + 1)).str());
+    std::error_code errorCode;
+    std::filesystem::rename(backupDirectory / (filenameFormat % i).str(),
+                            backupDirectory / (filenameFormat % (i + 1)).str(),
+                            errorCode);
+    if (errorCode && errorCode != std::errc::no_such_file_or_directory) {
+      throw std::filesystem::filesystem_error(
+          "Failed to roll over load order backup", errorCode);
     }
   }
 
-  std::ofstream out(backupDirectory / (filenameFormat % 0).str());
-  for (const auto& plugin : loadOrder) {
-    out << plugin << std::endl;
+  std::filesystem::rename(tempFilePath,
+                          backupDirectory / (filenameFormat % 0).str());
+}
+
+std::vector<FileTimestamp> GetRedatedTimestamps(
+    const std::vector<FileTimestamp>& timestamps) {
+  std::vector<FileTimestamp> redatedTimestamps;
+  auto lastTime = std::filesystem::file_time_type::min();
+  for (const auto& timestamp : timestamps) {
+    if (timestamp.time >= lastTime) {
+      lastTime = timestamp.time;
+    } else {
+      lastTime += std::chrono::seconds(60);
+      redatedTimestamps.push_back(FileTimestamp{timestamp.path, lastTime});
+    }
   }
+
+  return redatedTimestamps;
+}
+
+size_t SetTimestamps(const std::vector<FileTimestamp>& timestamps) {
+  // Setting a timestamp is a syscall per file, so for large numbers of files
+  // it's worth spreading them across a few threads.
+  static constexpr size_t MIN_FILES_PER_THREAD = 64;
+
+  const size_t threadCount = std::max(
+      size_t(1),
+      std::min(size_t(std::thread::hardware_concurrency()),
+               timestamps.size() / MIN_FILES_PER_THREAD));
+
+  const auto setTimestamps = [&timestamps](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      std::filesystem::last_write_time(timestamps[i].path, timestamps[i].time);
+    }
+  };
+
+  if (threadCount < 2) {
+    setTimestamps(0, timestamps.size());
+    return timestamps.size();
+  }
+
+  const size_t chunkSize = (timestamps.size() + threadCount - 1) / threadCount;
+  std::vector<std::future<void>> chunks;
+  for (size_t first = 0; first < timestamps.size(); first += chunkSize) {
+    const size_t last = std::min(first + chunkSize, timestamps.size());
+    chunks.push_back(
+        std::async(std::launch::async, setTimestamps, first, last));
+  }
+
+  // If a chunk failed, get() will rethrow its exception once the other
+  // chunks' threads have finished.
+  for (auto& chunk : chunks) {
+    chunk.get();
+  }
+
+  return timestamps.size();
 }
 
 Message PlainTextMessage(MessageType type, std::string text) {
   return Message(type, EscapeMarkdownSpecialChars(text));
 }
 
-std::string EscapeMarkdownSpecialChars(std::string text) { 
-  auto specialCharsRegex = std::regex("([\\\\`*_{}\\[\\]()#+.!-])");
-  return std::regex_replace(text, specialCharsRegex, "\\$1");
+constexpr std::array<bool, 256> GetMarkdownSpecialCharsTable() {
+  constexpr char specialChars[] = "\\`*_{}[]()#+.!-";
+
+  std::array<bool, 256> table{};
+  for (auto c : specialChars) {
+    if (c != '\0') {
+      table[static_cast<unsigned char>(c)] = true;
+    }
+  }
+
+  return table;
+}
+
+constexpr std::array<bool, 256> MARKDOWN_SPECIAL_CHARS =
+    GetMarkdownSpecialCharsTable();
+
+constexpr bool IsMarkdownSpecialChar(char c) {
+  return MARKDOWN_SPECIAL_CHARS[static_cast<unsigned char>(c)];
+}
+
+std::string EscapeMarkdownSpecialChars(std::string text) {
+  size_t specialCharsCount = 0;
+  for (auto c : text) {
+    if (IsMarkdownSpecialChar(c)) {
+      ++specialCharsCount;
+    }
+  }
+
+  if (specialCharsCount == 0) {
+    return text;
+  }
+
+  std::string escaped;
+  escaped.reserve(text.size() + specialCharsCount);
+  for (auto c : text) {
+    if (IsMarkdownSpecialChar(c)) {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(c);
+  }
+
+  return escaped;
 }
 
 Message ToMessage(const PluginCleaningData& cleaningData) {
   using boost::format;
-  using boost::locale::translate;
+  using gui::MessageTemplate;
+  using gui::PluralMessageTemplate;
+
+  const auto templates = gui::GetMessageTemplates();
 
   const std::string itmRecords =
-      (format(translate(
-           "%1% ITM record", "%1% ITM records", cleaningData.GetITMCount())) %
+      (templates->Format(PluralMessageTemplate::itmRecords,
+                         cleaningData.GetITMCount()) %
        cleaningData.GetITMCount())
           .str();
   const std::string deletedReferences =
-      (format(translate("%1% deleted reference",
-                        "%1% deleted references",
-                        cleaningData.GetDeletedReferenceCount())) %
+      (templates->Format(PluralMessageTemplate::deletedReferences,
+                         cleaningData.GetDeletedReferenceCount()) %
        cleaningData.GetDeletedReferenceCount())
           .str();
   const std::string deletedNavmeshes =
-      (format(translate("%1% deleted navmesh",
-                        "%1% deleted navmeshes",
-                        cleaningData.GetDeletedNavmeshCount())) %
+      (templates->Format(PluralMessageTemplate::deletedNavmeshes,
+                         cleaningData.GetDeletedNavmeshCount()) %
        cleaningData.GetDeletedNavmeshCount())
           .str();
 
@@ -105,40 +223,40 @@ Message ToMessage(const PluginCleaningData& cleaningData) {
   if (cleaningData.GetITMCount() > 0 &&
       cleaningData.GetDeletedReferenceCount() > 0 &&
       cleaningData.GetDeletedNavmeshCount() > 0)
-    f = format(translate("%1% found %2%, %3% and %4%.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithThreeCounts) %
         cleaningData.GetCleaningUtility() % itmRecords % deletedReferences %
         deletedNavmeshes;
   else if (cleaningData.GetITMCount() == 0 &&
            cleaningData.GetDeletedReferenceCount() == 0 &&
            cleaningData.GetDeletedNavmeshCount() == 0)
-    f = format(translate("%1% found dirty edits.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithNoCounts) %
         cleaningData.GetCleaningUtility();
 
   else if (cleaningData.GetITMCount() == 0 &&
            cleaningData.GetDeletedReferenceCount() > 0 &&
            cleaningData.GetDeletedNavmeshCount() > 0)
-    f = format(translate("%1% found %2% and %3%.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithTwoCounts) %
         cleaningData.GetCleaningUtility() % deletedReferences %
         deletedNavmeshes;
   else if (cleaningData.GetITMCount() > 0 &&
            cleaningData.GetDeletedReferenceCount() == 0 &&
            cleaningData.GetDeletedNavmeshCount() > 0)
-    f = format(translate("%1% found %2% and %3%.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithTwoCounts) %
         cleaningData.GetCleaningUtility() % itmRecords % deletedNavmeshes;
   else if (cleaningData.GetITMCount() > 0 &&
            cleaningData.GetDeletedReferenceCount() > 0 &&
            cleaningData.GetDeletedNavmeshCount() == 0)
-    f = format(translate("%1% found %2% and %3%.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithTwoCounts) %
         cleaningData.GetCleaningUtility() % itmRecords % deletedReferences;
 
   else if (cleaningData.GetITMCount() > 0)
-    f = format(translate("%1% found %2%.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithOneCount) %
         cleaningData.GetCleaningUtility() % itmRecords;
   else if (cleaningData.GetDeletedReferenceCount() > 0)
-    f = format(translate("%1% found %2%.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithOneCount) %
         cleaningData.GetCleaningUtility() % deletedReferences;
   else if (cleaningData.GetDeletedNavmeshCount() > 0)
-    f = format(translate("%1% found %2%.")) %
+    f = templates->Format(MessageTemplate::dirtyEditsWithOneCount) %
         cleaningData.GetCleaningUtility() % deletedNavmeshes;
 
   std::string message = f.str();
@@ -199,36 +317,124 @@ std::string DescribeCycle(const std::vector<Vertex>& cycle) {
   return text;
 }
 
-std::vector<Message> CheckForRemovedPlugins(
-    const std::vector<std::string> pluginsBefore,
-    const std::vector<std::string> pluginsAfter) {
-  // Plugin name case won't change, so can compare strings
-  // without normalising case.
-  std::set<std::string> pluginsSet(pluginsAfter.cbegin(), pluginsAfter.cend());
+namespace {
+std::string_view trimGhostExtension(std::string_view pluginName) {
+  static constexpr std::string_view GHOST_EXTENSION = ".ghost";
 
-  std::vector<Message> messages;
-  for (auto& plugin : pluginsBefore) {
-    std::string unghostedPluginName;
-    if (boost::iends_with(plugin, ".ghost")) {
-      unghostedPluginName = plugin.substr(0, plugin.length() - 6);
+  if (pluginName.size() > GHOST_EXTENSION.size() &&
+      FilenameEqual()(
+          pluginName.substr(pluginName.size() - GHOST_EXTENSION.size()),
+          GHOST_EXTENSION)) {
+    return pluginName.substr(0, pluginName.size() - GHOST_EXTENSION.size());
+  }
+
+  return pluginName;
+}
+}
+
+PluginListDiff DiffPluginLists(const std::vector<std::string>& pluginsBefore,
+                               const std::vector<std::string>& pluginsAfter) {
+  // The keys are views of the input strings, so building the map doesn't
+  // copy any plugin names.
+  std::unordered_map<std::string_view, size_t, FilenameHash, FilenameEqual>
+      indicesBefore;
+  indicesBefore.reserve(pluginsBefore.size());
+  for (size_t i = 0; i < pluginsBefore.size(); ++i) {
+    indicesBefore.emplace(trimGhostExtension(pluginsBefore[i]), i);
+  }
+
+  PluginListDiff diff;
+
+  // The positions in the first list of the plugins that are in both lists,
+  // in the second list's order, with the indices of those plugins in the
+  // second list.
+  std::vector<size_t> commonPositions;
+  std::vector<size_t> commonIndicesAfter;
+  std::vector<bool> isInBothLists(pluginsBefore.size(), false);
+  for (size_t i = 0; i < pluginsAfter.size(); ++i) {
+    auto it = indicesBefore.find(trimGhostExtension(pluginsAfter[i]));
+    if (it == indicesBefore.end()) {
+      diff.added.push_back(pluginsAfter[i]);
     } else {
-      unghostedPluginName = plugin;
+      isInBothLists[it->second] = true;
+      commonPositions.push_back(it->second);
+      commonIndicesAfter.push_back(i);
     }
+  }
 
-    if (pluginsSet.count(unghostedPluginName) == 0) {
-      messages.push_back(PlainTextMessage(
-          MessageType::warn,
-          (boost::format(
-               boost::locale::translate("LOOT has detected that \"%1%\" is "
-                                        "invalid and is now ignoring it.")) %
-           plugin)
-              .str()));
+  for (size_t i = 0; i < pluginsBefore.size(); ++i) {
+    // If the first list contains the same plugin more than once, only the
+    // first occurrence is in the map, so check that instead.
+    if (!isInBothLists[i] &&
+        !isInBothLists[indicesBefore.at(
+            trimGhostExtension(pluginsBefore[i]))]) {
+      diff.removed.push_back(pluginsBefore[i]);
     }
   }
 
+  // The plugins that can stay where they are form the longest subsequence of
+  // common plugins that have increasing positions in the first list, so every
+  // other common plugin needs to be moved. Find that subsequence in
+  // O(n log n) time by keeping the index of the smallest tail position of
+  // each length of increasing subsequence found so far.
+  static constexpr size_t NO_PREDECESSOR = std::numeric_limits<size_t>::max();
+  std::vector<size_t> tails;
+  std::vector<size_t> predecessors(commonPositions.size(), NO_PREDECESSOR);
+  for (size_t i = 0; i < commonPositions.size(); ++i) {
+    auto it = std::lower_bound(tails.begin(),
+                               tails.end(),
+                               commonPositions[i],
+                               [&](size_t tail, size_t position) {
+                                 return commonPositions[tail] < position;
+                               });
+    if (it != tails.begin()) {
+      predecessors[i] = *(it - 1);
+    }
+
+    if (it == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *it = i;
+    }
+  }
+
+  std::vector<bool> isInPlace(commonPositions.size(), false);
+  if (!tails.empty()) {
+    for (auto i = tails.back(); i != NO_PREDECESSOR; i = predecessors[i]) {
+      isInPlace[i] = true;
+    }
+  }
+
+  for (size_t i = 0; i < commonPositions.size(); ++i) {
+    if (!isInPlace[i]) {
+      diff.moved.push_back(pluginsAfter[commonIndicesAfter[i]]);
+    }
+  }
+
+  return diff;
+}
+
+std::vector<Message> CheckForRemovedPlugins(const PluginListDiff& diff) {
+  std::vector<Message> messages;
+  for (const auto& plugin : diff.removed) {
+    messages.push_back(PlainTextMessage(
+        MessageType::warn,
+        (boost::format(
+             boost::locale::translate("LOOT has detected that \"%1%\" is "
+                                      "invalid and is now ignoring it.")) %
+         plugin)
+            .str()));
+  }
+
   return messages;
 }
 
+std::vector<Message> CheckForRemovedPlugins(
+    const std::vector<std::string>& pluginsBefore,
+    const std::vector<std::string>& pluginsAfter) {
+  return CheckForRemovedPlugins(DiffPluginLists(pluginsBefore, pluginsAfter));
+}
+
 std::tuple<std::string, std::string, std::string> SplitRegistryPath(
   const std::string& registryPath) {
   std::string rootKey;
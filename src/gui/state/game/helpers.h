@@ -27,6 +27,7 @@
 #define LOOT_GUI_STATE_GAME_HELPERS
 
 #include <filesystem>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -42,6 +43,21 @@ bool ExecutableExists(const GameType& gameType,
 void BackupLoadOrder(const std::vector<std::string>& loadOrder,
                      const std::filesystem::path& backupDirectory);
 
+struct FileTimestamp {
+  std::filesystem::path path;
+  std::filesystem::file_time_type time;
+};
+
+// Get the new timestamps of the given files, which are in load order, so that
+// each file is newer than the files before it. Only files that need to be
+// redated are returned, and each is dated a minute after the file before it.
+std::vector<FileTimestamp> GetRedatedTimestamps(
+    const std::vector<FileTimestamp>& timestamps);
+
+// Set the given timestamps concurrently, returning the number of files that
+// were redated.
+size_t SetTimestamps(const std::vector<FileTimestamp>& timestamps);
+
 // Escape any Markdown special characters in the input text.
 std::string EscapeMarkdownSpecialChars(std::string text);
 
@@ -52,9 +68,26 @@ Message ToMessage(const PluginCleaningData& cleaningData);
 
 std::string DescribeCycle(const std::vector<Vertex>& cycle);
 
+struct PluginListDiff {
+  // Plugins that are only in the second list, in that list's order.
+  std::vector<std::string> added;
+  // Plugins that are only in the first list, in that list's order.
+  std::vector<std::string> removed;
+  // The fewest plugins that are in both lists that need to be moved to turn
+  // the first list's order into the second's, in the second list's order.
+  std::vector<std::string> moved;
+};
+
+// Compare two lists of plugin filenames case-insensitively, ignoring any
+// .ghost extensions.
+PluginListDiff DiffPluginLists(const std::vector<std::string>& pluginsBefore,
+                               const std::vector<std::string>& pluginsAfter);
+
+std::vector<Message> CheckForRemovedPlugins(const PluginListDiff& diff);
+
 std::vector<Message> CheckForRemovedPlugins(
-    const std::vector<std::string> pluginsBefore,
-    const std::vector<std::string> pluginsAfter);
+    const std::vector<std::string>& pluginsBefore,
+    const std::vector<std::string>& pluginsAfter);
 
 std::tuple<std::string, std::string, std::string> SplitRegistryPath(
   const std::string& registryPath);
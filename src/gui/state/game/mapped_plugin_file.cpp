@@ -0,0 +1,366 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/mapped_plugin_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace loot {
+namespace gui {
+namespace {
+// Light masters can only add records with object indices in this range.
+constexpr std::uint32_t MIN_LIGHT_MASTER_OBJECT_INDEX = 0x800;
+constexpr std::uint32_t MAX_LIGHT_MASTER_OBJECT_INDEX = 0xFFF;
+
+// Record and group headers share the same layout up to the FormID, which is
+// the group's label for groups.
+constexpr std::size_t TYPE_OFFSET = 0;
+constexpr std::size_t SIZE_OFFSET = 4;
+constexpr std::size_t FORMID_OFFSET = 12;
+
+std::uint32_t readUint32(const unsigned char* data) {
+  return static_cast<std::uint32_t>(data[0]) |
+         static_cast<std::uint32_t>(data[1]) << 8 |
+         static_cast<std::uint32_t>(data[2]) << 16 |
+         static_cast<std::uint32_t>(data[3]) << 24;
+}
+
+bool hasType(const unsigned char* header, const char* type) {
+  return std::memcmp(header + TYPE_OFFSET, type, 4) == 0;
+}
+
+// Reading one byte from each page is enough to read the whole page.
+constexpr std::size_t PAGE_STRIDE = 4096;
+
+// Morrowind's record headers have no FormID or version fields.
+constexpr std::size_t TES3_RECORD_HEADER_SIZE = 16;
+
+std::optional<std::size_t> getRecordHeaderSize(GameType gameType) {
+  switch (gameType) {
+    case GameType::tes3:
+      // Morrowind records have no FormIDs.
+      return std::nullopt;
+    case GameType::tes4:
+      return 20;
+    default:
+      return 24;
+  }
+}
+}
+
+#ifdef _WIN32
+MappedPluginFile::MappedPluginFile(const fs::path& filePath) :
+    data_(nullptr),
+    size_(0),
+    fileId_(0) {
+  HANDLE file = CreateFile(filePath.wstring().c_str(),
+                           GENERIC_READ,
+                           FILE_SHARE_READ,
+                           NULL,
+                           OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                           NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::system_error(GetLastError(),
+                            std::system_category(),
+                            "Failed to open \"" + filePath.u8string() + "\"");
+  }
+
+  BY_HANDLE_FILE_INFORMATION fileInfo;
+  if (!GetFileInformationByHandle(file, &fileInfo)) {
+    auto error = GetLastError();
+    CloseHandle(file);
+    throw std::system_error(error,
+                            std::system_category(),
+                            "Failed to get the size of \"" +
+                                filePath.u8string() + "\"");
+  }
+
+  size_ = static_cast<std::size_t>(
+      static_cast<std::uint64_t>(fileInfo.nFileSizeHigh) << 32 |
+      fileInfo.nFileSizeLow);
+  fileId_ = static_cast<std::uint64_t>(fileInfo.nFileIndexHigh) << 32 |
+            fileInfo.nFileIndexLow;
+  if (size_ == 0) {
+    // Empty files can't be mapped.
+    CloseHandle(file);
+    return;
+  }
+
+  HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  auto error = GetLastError();
+  CloseHandle(file);
+  if (mapping == NULL) {
+    throw std::system_error(error,
+                            std::system_category(),
+                            "Failed to map \"" + filePath.u8string() + "\"");
+  }
+
+  // The view keeps the mapping alive, so its handle isn't needed.
+  data_ = static_cast<const unsigned char*>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  error = GetLastError();
+  CloseHandle(mapping);
+  if (data_ == nullptr) {
+    throw std::system_error(error,
+                            std::system_category(),
+                            "Failed to map \"" + filePath.u8string() + "\"");
+  }
+}
+
+MappedPluginFile::~MappedPluginFile() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+}
+
+void MappedPluginFile::WillNeed(std::size_t length) const {
+  length = std::min(length, size_);
+  if (data_ == nullptr || length == 0) {
+    return;
+  }
+
+  // PrefetchVirtualMemory() was added in Windows 8, so look it up at runtime.
+  typedef BOOL(WINAPI * PrefetchVirtualMemoryFunction)(
+      HANDLE, ULONG_PTR, PWIN32_MEMORY_RANGE_ENTRY, ULONG);
+  static const auto prefetchVirtualMemory =
+      reinterpret_cast<PrefetchVirtualMemoryFunction>(GetProcAddress(
+          GetModuleHandle(L"kernel32.dll"), "PrefetchVirtualMemory"));
+  if (prefetchVirtualMemory == nullptr) {
+    return;
+  }
+
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = const_cast<unsigned char*>(data_);
+  range.NumberOfBytes = length;
+  prefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+#else
+MappedPluginFile::MappedPluginFile(const fs::path& filePath) :
+    data_(nullptr),
+    size_(0),
+    fileId_(0) {
+  int file = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file == -1) {
+    throw std::system_error(errno,
+                            std::generic_category(),
+                            "Failed to open \"" + filePath.u8string() + "\"");
+  }
+
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0) {
+    auto error = errno;
+    close(file);
+    throw std::system_error(error,
+                            std::generic_category(),
+                            "Failed to get the size of \"" +
+                                filePath.u8string() + "\"");
+  }
+
+  size_ = static_cast<std::size_t>(fileStatus.st_size);
+  fileId_ = static_cast<std::uint64_t>(fileStatus.st_ino);
+  if (size_ == 0) {
+    // Empty files can't be mapped.
+    close(file);
+    return;
+  }
+
+  // The mapping keeps the file open, so its descriptor isn't needed.
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+  auto error = errno;
+  close(file);
+  if (data == MAP_FAILED) {
+    throw std::system_error(error,
+                            std::generic_category(),
+                            "Failed to map \"" + filePath.u8string() + "\"");
+  }
+
+  data_ = static_cast<const unsigned char*>(data);
+}
+
+MappedPluginFile::~MappedPluginFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<unsigned char*>(data_), size_);
+  }
+}
+
+void MappedPluginFile::WillNeed(std::size_t length) const {
+  length = std::min(length, size_);
+  if (data_ == nullptr || length == 0) {
+    return;
+  }
+
+  // MADV_WILLNEED starts asynchronous readahead of the file's pages, like
+  // posix_fadvise(POSIX_FADV_WILLNEED) does for a file descriptor.
+  auto data = const_cast<unsigned char*>(data_);
+  madvise(data, length, MADV_SEQUENTIAL);
+  madvise(data, length, MADV_WILLNEED);
+}
+#endif
+
+void MappedPluginFile::WillNeed() const { WillNeed(size_); }
+
+void MappedPluginFile::Read(std::size_t length) const {
+  length = std::min(length, size_);
+
+  // The sum stops the reads from being optimised away.
+  volatile unsigned char sum = 0;
+  for (std::size_t offset = 0; offset < length; offset += PAGE_STRIDE) {
+    sum += data_[offset];
+  }
+  if (length > 0) {
+    sum += data_[length - 1];
+  }
+}
+
+std::size_t MappedPluginFile::GetHeaderRecordLength(GameType gameType) const {
+  auto headerSize =
+      getRecordHeaderSize(gameType).value_or(TES3_RECORD_HEADER_SIZE);
+  if (size_ < headerSize) {
+    return size_;
+  }
+
+  auto length = headerSize + readUint32(data_ + SIZE_OFFSET);
+  return std::min(length, size_);
+}
+
+const unsigned char* MappedPluginFile::Data() const { return data_; }
+
+std::size_t MappedPluginFile::Size() const { return size_; }
+
+std::uint64_t MappedPluginFile::FileId() const { return fileId_; }
+
+std::optional<bool> MappedPluginFile::IsValidAsLightMaster(
+    GameType gameType,
+    std::size_t masterCount) const {
+  bool isValid = true;
+  auto isWellFormed = ForEachRecordFormId(gameType, [&](std::uint32_t formId) {
+    auto masterIndex = formId >> 24;
+    auto objectIndex = formId & 0xFFFFFF;
+    if (masterIndex >= masterCount &&
+        (objectIndex < MIN_LIGHT_MASTER_OBJECT_INDEX ||
+         objectIndex > MAX_LIGHT_MASTER_OBJECT_INDEX)) {
+      isValid = false;
+    }
+    return isValid;
+  });
+
+  if (!isValid) {
+    return false;
+  }
+
+  if (!isWellFormed) {
+    return std::nullopt;
+  }
+
+  return true;
+}
+
+std::optional<std::vector<std::uint32_t>> MappedPluginFile::GetRecordFormIds(
+    GameType gameType) const {
+  std::vector<std::uint32_t> formIds;
+  auto isWellFormed = ForEachRecordFormId(gameType, [&](std::uint32_t formId) {
+    formIds.push_back(formId);
+    return true;
+  });
+
+  if (!isWellFormed) {
+    return std::nullopt;
+  }
+
+  return formIds;
+}
+
+bool MappedPluginFile::ForEachRecordFormId(
+    GameType gameType,
+    const std::function<bool(std::uint32_t)>& callback) const {
+  auto headerSize = getRecordHeaderSize(gameType);
+  if (!headerSize.has_value() || size_ < headerSize.value() ||
+      !hasType(data_, "TES4")) {
+    return false;
+  }
+
+  // Skip the plugin's header record. Groups are entered instead of skipped,
+  // so that every record in the plugin is visited in file order, touching
+  // only the pages that hold record headers and the records that are too
+  // small to span a page.
+  std::size_t offset =
+      headerSize.value() + readUint32(data_ + SIZE_OFFSET);
+  while (offset < size_) {
+    if (size_ - offset < headerSize.value()) {
+      return false;
+    }
+
+    const auto header = data_ + offset;
+    auto size = readUint32(header + SIZE_OFFSET);
+
+    if (hasType(header, "GRUP")) {
+      // A group's size includes its header.
+      if (size < headerSize.value() || size > size_ - offset) {
+        return false;
+      }
+      offset += headerSize.value();
+      continue;
+    }
+
+    // Stop early if the callback asks to, as the records seen so far are
+    // well-formed.
+    if (!callback(readUint32(header + FORMID_OFFSET))) {
+      return true;
+    }
+
+    if (size > size_ - offset - headerSize.value()) {
+      return false;
+    }
+    offset += headerSize.value() + size;
+  }
+
+  return true;
+}
+}
+}
@@ -0,0 +1,131 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_MAPPED_PLUGIN_FILE
+#define LOOT_GUI_STATE_GAME_MAPPED_PLUGIN_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "loot/enum/game_type.h"
+
+namespace loot {
+namespace gui {
+/**
+ * @brief A read-only memory mapping of a plugin file.
+ *
+ * The file's pages are only read when they're accessed, and they belong to
+ * the OS page cache, so scanning a large plugin doesn't copy it into the
+ * process' heap and the OS can evict the pages whenever it needs to.
+ */
+class MappedPluginFile {
+public:
+  /**
+   * Map the given file. Throws a std::system_error if the file can't be
+   * opened or mapped.
+   */
+  explicit MappedPluginFile(const std::filesystem::path& filePath);
+  ~MappedPluginFile();
+
+  MappedPluginFile(const MappedPluginFile&) = delete;
+  MappedPluginFile& operator=(const MappedPluginFile&) = delete;
+
+  const unsigned char* Data() const;
+  std::size_t Size() const;
+
+  /**
+   * Get the file's ID on its volume, i.e. its inode number or NTFS file
+   * index. Files that were written together usually have nearby IDs and are
+   * stored near each other, so reading files in ID order is closer to disk
+   * order than reading them in directory order. Returns 0 if the ID can't be
+   * read.
+   */
+  std::uint64_t FileId() const;
+
+  /**
+   * Advise the OS that the whole file will be read soon and in order, so that
+   * it can read ahead into the page cache. The advice is ignored if the OS
+   * doesn't support it.
+   */
+  void WillNeed() const;
+
+  /**
+   * Advise the OS that the first length bytes of the file will be read soon
+   * and in order. The OS reads them in the background, so this doesn't wait
+   * for the reads. Advice beyond the end of the file is ignored.
+   */
+  void WillNeed(std::size_t length) const;
+
+  /**
+   * Read the first length bytes of the file into the OS page cache, waiting
+   * for them to be read. Reading stops at the end of the file.
+   */
+  void Read(std::size_t length) const;
+
+  /**
+   * Get the length of the plugin's header record, including its record
+   * header, which is at the start of the file. Returns the size of the file
+   * if the header record's length can't be read.
+   */
+  std::size_t GetHeaderRecordLength(GameType gameType) const;
+
+  /**
+   * Check if the FormIDs of all the records that the plugin adds are in the
+   * range that's valid for a light master, by scanning its record headers.
+   * Records with a master index lower than masterCount override records from
+   * the plugin's masters, so are ignored. Returns nullopt if the game's
+   * plugins can't be scanned or the plugin's records are malformed.
+   */
+  std::optional<bool> IsValidAsLightMaster(GameType gameType,
+                                           std::size_t masterCount) const;
+
+  /**
+   * Get the FormIDs of all the records in the plugin, in file order, as they
+   * are written in the file. Returns nullopt if the game's plugins can't be
+   * scanned or the plugin's records are malformed.
+   */
+  std::optional<std::vector<std::uint32_t>> GetRecordFormIds(
+      GameType gameType) const;
+
+private:
+  // Call the callback with the FormID of each record in file order until it
+  // returns false. Returns false if the game's plugins can't be scanned or a
+  // malformed record is found before the callback returns false.
+  bool ForEachRecordFormId(
+      GameType gameType,
+      const std::function<bool(std::uint32_t)>& callback) const;
+
+  const unsigned char* data_;
+  std::size_t size_;
+  std::uint64_t fileId_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/master_graph.h"
+
+#include <algorithm>
+
+namespace loot {
+namespace gui {
+namespace {
+const std::vector<PluginId> NO_DEPENDENTS;
+const std::vector<MasterGraph::Problem> NO_PROBLEMS;
+}
+
+void MasterGraph::AddPlugin(PluginId pluginId,
+                            const std::vector<PluginId>& masters,
+                            bool isMaster,
+                            bool isLightMaster) {
+  // Grow the nodes before taking any references to them.
+  auto maxId = pluginId;
+  for (const auto master : masters) {
+    maxId = std::max(maxId, master);
+  }
+  GetNode(maxId);
+
+  auto& node = nodes_[pluginId];
+  if (node.isAdded) {
+    return;
+  }
+
+  node.isAdded = true;
+  node.isMaster = isMaster;
+  node.isLightMaster = isLightMaster;
+  node.masters = masters;
+
+  for (const auto master : masters) {
+    nodes_[master].dependents.push_back(pluginId);
+  }
+}
+
+bool MasterGraph::HasPlugin(PluginId pluginId) const {
+  return pluginId < nodes_.size() && nodes_[pluginId].isAdded;
+}
+
+const std::vector<PluginId>& MasterGraph::GetDependents(
+    PluginId pluginId) const {
+  if (pluginId >= nodes_.size()) {
+    return NO_DEPENDENTS;
+  }
+
+  return nodes_[pluginId].dependents;
+}
+
+void MasterGraph::ValidateAll(const Predicate& exists,
+                              const Predicate& isActive) {
+  for (auto& node : nodes_) {
+    if (node.isAdded) {
+      Validate(node, exists, isActive);
+    }
+  }
+}
+
+void MasterGraph::Validate(PluginId pluginId,
+                           const Predicate& exists,
+                           const Predicate& isActive) {
+  if (HasPlugin(pluginId)) {
+    Validate(nodes_[pluginId], exists, isActive);
+  }
+}
+
+std::unordered_set<PluginId> MasterGraph::ValidateDependents(
+    const std::unordered_set<PluginId>& changedPlugins,
+    const Predicate& exists,
+    const Predicate& isActive) {
+  std::unordered_set<PluginId> dependents;
+  for (const auto changedPlugin : changedPlugins) {
+    for (const auto dependent : GetDependents(changedPlugin)) {
+      if (dependents.insert(dependent).second) {
+        Validate(nodes_[dependent], exists, isActive);
+      }
+    }
+  }
+
+  return dependents;
+}
+
+const std::vector<MasterGraph::Problem>& MasterGraph::GetProblems(
+    PluginId pluginId) const {
+  if (pluginId >= nodes_.size()) {
+    return NO_PROBLEMS;
+  }
+
+  return nodes_[pluginId].problems;
+}
+
+MasterGraph::Node& MasterGraph::GetNode(PluginId pluginId) {
+  if (pluginId >= nodes_.size()) {
+    nodes_.resize(pluginId + 1);
+  }
+
+  return nodes_[pluginId];
+}
+
+void MasterGraph::Validate(Node& node,
+                           const Predicate& exists,
+                           const Predicate& isActive) {
+  node.problems.clear();
+
+  for (const auto master : node.masters) {
+    if (!exists(master)) {
+      node.problems.push_back(Problem{ProblemType::missingMaster, master});
+    } else if (!isActive(master)) {
+      node.problems.push_back(Problem{ProblemType::inactiveMaster, master});
+    }
+  }
+
+  if (!node.isLightMaster) {
+    return;
+  }
+
+  // Masters that haven't been added can't be checked.
+  for (const auto master : node.masters) {
+    const auto& masterNode = nodes_[master];
+    if (masterNode.isAdded && !masterNode.isMaster) {
+      node.problems.push_back(Problem{ProblemType::nonMasterMaster, master});
+    }
+  }
+}
+}
+}
@@ -0,0 +1,131 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_MASTER_GRAPH
+#define LOOT_GUI_STATE_GAME_MASTER_GRAPH
+
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+#include "gui/state/game/plugin_name_table.h"
+
+namespace loot {
+namespace gui {
+/**
+ * @brief The graph of the installed plugins' masters, with reverse edges
+ *        from each plugin to the plugins that have it as a master, and the
+ *        problems with each plugin's masters.
+ *
+ * Validating every plugin visits each plugin and master once, and a plugin's
+ * problems only depend on its masters, so when plugins are added, removed,
+ * activated or deactivated, only the plugins that have them as masters need
+ * to be validated again.
+ */
+class MasterGraph {
+public:
+  enum class ProblemType {
+    missingMaster,
+    inactiveMaster,
+    // The plugin is a light master that has a master that is neither a
+    // master nor a light master.
+    nonMasterMaster,
+  };
+
+  struct Problem {
+    ProblemType type;
+    PluginId master;
+
+    bool operator==(const Problem& other) const {
+      return type == other.type && master == other.master;
+    }
+  };
+
+  typedef std::function<bool(PluginId)> Predicate;
+
+  /**
+   * Add a plugin and the edges to and from its masters. isMaster is true if
+   * the plugin is a master or a light master, and isLightMaster is true if
+   * the plugin is a light master that can't have non-master masters.
+   */
+  void AddPlugin(PluginId pluginId,
+                 const std::vector<PluginId>& masters,
+                 bool isMaster,
+                 bool isLightMaster);
+
+  bool HasPlugin(PluginId pluginId) const;
+
+  // Get the added plugins that have the given plugin as a master.
+  const std::vector<PluginId>& GetDependents(PluginId pluginId) const;
+
+  /**
+   * Validate every added plugin, using the given predicates to check if a
+   * plugin file exists and if a plugin is active. Each plugin is validated
+   * independently of the others.
+   */
+  void ValidateAll(const Predicate& exists, const Predicate& isActive);
+
+  // Validate one added plugin.
+  void Validate(PluginId pluginId,
+                const Predicate& exists,
+                const Predicate& isActive);
+
+  /**
+   * Validate only the added plugins that have any of the given plugins as a
+   * master, returning them.
+   */
+  std::unordered_set<PluginId> ValidateDependents(
+      const std::unordered_set<PluginId>& changedPlugins,
+      const Predicate& exists,
+      const Predicate& isActive);
+
+  /**
+   * Get the problems with the plugin's masters when it was last validated,
+   * in the order of its masters, with all missing and inactive master
+   * problems before any non-master master problems.
+   */
+  const std::vector<Problem>& GetProblems(PluginId pluginId) const;
+
+private:
+  struct Node {
+    bool isAdded = false;
+    bool isMaster = false;
+    bool isLightMaster = false;
+    std::vector<PluginId> masters;
+    std::vector<PluginId> dependents;
+    std::vector<Problem> problems;
+  };
+
+  Node& GetNode(PluginId pluginId);
+  void Validate(Node& node, const Predicate& exists, const Predicate& isActive);
+
+  // Indexed by plugin ID, which are dense. Masters that haven't been added
+  // have nodes so that their dependents can be recorded.
+  std::vector<Node> nodes_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/message_templates.h"
+
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+#include <boost/locale.hpp>
+
+namespace loot {
+namespace gui {
+namespace {
+constexpr unsigned int MESSAGE_TEMPLATE_COUNT =
+    static_cast<unsigned int>(MessageTemplate::dirtyEditsWithNoCounts) + 1;
+constexpr unsigned int PLURAL_MESSAGE_TEMPLATE_COUNT =
+    static_cast<unsigned int>(PluralMessageTemplate::deletedNavmeshes) + 1;
+
+std::string TranslateTemplate(MessageTemplate messageTemplate) {
+  using boost::locale::translate;
+
+  switch (messageTemplate) {
+    case MessageTemplate::missingMaster:
+    case MessageTemplate::missingRequirement:
+      return translate(
+          "This plugin requires \"%1%\" to be installed, but it is missing.");
+    case MessageTemplate::inactiveMaster:
+      return translate(
+          "This plugin requires \"%1%\" to be active, but it is inactive.");
+    case MessageTemplate::incompatibilityPresent:
+      return translate(
+          "This plugin is incompatible with \"%1%\", but both files are "
+          "present.");
+    case MessageTemplate::lightMasterRequiresNonMaster:
+      return translate(
+          "This plugin is a light master and requires the non-master plugin "
+          "\"%1%\". This can cause issues in-game, and sorting will fail "
+          "while this plugin is installed.");
+    case MessageTemplate::invalidLightMaster:
+      return translate(
+          "This plugin contains records that have FormIDs outside the valid "
+          "range for an ESL plugin. Using this plugin will cause irreversible "
+          "damage to your game saves.");
+    case MessageTemplate::headerVersionTooLow:
+      return translate(
+          "This plugin has a header version of %1%, which is less than the "
+          "game's minimum supported header version of %2%.");
+    case MessageTemplate::nonExistentGroup:
+      return translate(
+          "This plugin belongs to the group \"%1%\", which does not exist.");
+    case MessageTemplate::dirtyEditsWithThreeCounts:
+      return translate("%1% found %2%, %3% and %4%.");
+    case MessageTemplate::dirtyEditsWithTwoCounts:
+      return translate("%1% found %2% and %3%.");
+    case MessageTemplate::dirtyEditsWithOneCount:
+      return translate("%1% found %2%.");
+    case MessageTemplate::dirtyEditsWithNoCounts:
+      return translate("%1% found dirty edits.");
+    default:
+      throw std::invalid_argument("Unrecognised message template");
+  }
+}
+
+std::string TranslateTemplate(PluralMessageTemplate messageTemplate,
+                              std::uintmax_t count) {
+  using boost::locale::translate;
+
+  switch (messageTemplate) {
+    case PluralMessageTemplate::itmRecords:
+      return translate("%1% ITM record", "%1% ITM records", count);
+    case PluralMessageTemplate::deletedReferences:
+      return translate(
+          "%1% deleted reference", "%1% deleted references", count);
+    case PluralMessageTemplate::deletedNavmeshes:
+      return translate("%1% deleted navmesh", "%1% deleted navmeshes", count);
+    default:
+      throw std::invalid_argument("Unrecognised plural message template");
+  }
+}
+
+std::mutex messageTemplatesMutex;
+std::shared_ptr<const MessageTemplates> messageTemplates;
+std::optional<std::string> messageTemplatesLanguage;
+}
+
+MessageTemplates::MessageTemplates(const std::string& language) :
+    language_(language) {
+  translations_.reserve(MESSAGE_TEMPLATE_COUNT);
+  formats_.reserve(MESSAGE_TEMPLATE_COUNT);
+  for (unsigned int i = 0; i < MESSAGE_TEMPLATE_COUNT; ++i) {
+    translations_.push_back(TranslateTemplate(MessageTemplate(i)));
+    formats_.push_back(boost::format(translations_.back()));
+  }
+
+  pluralFormats_.resize(PLURAL_MESSAGE_TEMPLATE_COUNT);
+  for (unsigned int i = 0; i < PLURAL_MESSAGE_TEMPLATE_COUNT; ++i) {
+    pluralFormats_[i].reserve(CACHED_PLURAL_COUNTS);
+    for (std::uintmax_t count = 0; count < CACHED_PLURAL_COUNTS; ++count) {
+      pluralFormats_[i].push_back(boost::format(
+          TranslateTemplate(PluralMessageTemplate(i), count)));
+    }
+  }
+}
+
+const std::string& MessageTemplates::GetLanguage() const { return language_; }
+
+boost::format MessageTemplates::Format(MessageTemplate messageTemplate) const {
+  return formats_.at(static_cast<unsigned int>(messageTemplate));
+}
+
+std::string MessageTemplates::Translate(
+    MessageTemplate messageTemplate) const {
+  return translations_.at(static_cast<unsigned int>(messageTemplate));
+}
+
+boost::format MessageTemplates::Format(PluralMessageTemplate messageTemplate,
+                                       std::uintmax_t count) const {
+  const auto& formats =
+      pluralFormats_.at(static_cast<unsigned int>(messageTemplate));
+  if (count < formats.size()) {
+    return formats[count];
+  }
+
+  return boost::format(TranslateTemplate(messageTemplate, count));
+}
+
+std::shared_ptr<const MessageTemplates> GetMessageTemplates() {
+  std::lock_guard<std::mutex> guard(messageTemplatesMutex);
+
+  if (!messageTemplates) {
+    messageTemplates = std::make_shared<const MessageTemplates>(
+        messageTemplatesLanguage.value_or(std::locale().name()));
+  }
+
+  return messageTemplates;
+}
+
+void LoadMessageTemplates(const std::string& language) {
+  std::lock_guard<std::mutex> guard(messageTemplatesMutex);
+
+  if (messageTemplatesLanguage == language) {
+    return;
+  }
+
+  messageTemplates = nullptr;
+  messageTemplatesLanguage = language;
+}
+}
+}
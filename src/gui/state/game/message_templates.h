@@ -0,0 +1,114 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_MESSAGE_TEMPLATES
+#define LOOT_GUI_STATE_GAME_MESSAGE_TEMPLATES
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+namespace loot {
+namespace gui {
+enum class MessageTemplate : unsigned int {
+  missingMaster,
+  inactiveMaster,
+  missingRequirement,
+  incompatibilityPresent,
+  lightMasterRequiresNonMaster,
+  invalidLightMaster,
+  headerVersionTooLow,
+  nonExistentGroup,
+  dirtyEditsWithThreeCounts,
+  dirtyEditsWithTwoCounts,
+  dirtyEditsWithOneCount,
+  dirtyEditsWithNoCounts,
+};
+
+enum class PluralMessageTemplate : unsigned int {
+  itmRecords,
+  deletedReferences,
+  deletedNavmeshes,
+};
+
+/**
+ * @brief A catalog of the translated and pre-parsed format strings used for
+ *        the messages that LOOT generates for plugins.
+ * @details The same few templates are used for every plugin, so translating
+ *          and parsing them once per language means that each message only
+ *          costs the substitution of its arguments.
+ */
+class MessageTemplates {
+public:
+  /**
+   * Translate all templates using the current global locale.
+   */
+  explicit MessageTemplates(const std::string& language);
+
+  const std::string& GetLanguage() const;
+
+  /**
+   * Get a copy of the given template that has been translated and parsed,
+   * ready for arguments to be fed to it.
+   */
+  boost::format Format(MessageTemplate messageTemplate) const;
+
+  std::string Translate(MessageTemplate messageTemplate) const;
+
+  boost::format Format(PluralMessageTemplate messageTemplate,
+                       std::uintmax_t count) const;
+
+private:
+  // Plural forms are cached for counts below this limit, larger counts are
+  // translated on demand.
+  static constexpr std::uintmax_t CACHED_PLURAL_COUNTS = 100;
+
+  std::string language_;
+  std::vector<std::string> translations_;
+  std::vector<boost::format> formats_;
+  std::vector<std::vector<boost::format>> pluralFormats_;
+};
+
+/**
+ * Get the message templates for the currently loaded language, translating
+ * them using the current global locale if they haven't been used since the
+ * language was loaded. If no language has been loaded, the templates are
+ * loaded for the current global locale.
+ */
+std::shared_ptr<const MessageTemplates> GetMessageTemplates();
+
+/**
+ * Load the message templates for the given language, if they're not already
+ * loaded for that language. The templates aren't translated until they're
+ * first used, so that loading a language doesn't slow down startup.
+ */
+void LoadMessageTemplates(const std::string& language);
+}
+}
+
+#endif
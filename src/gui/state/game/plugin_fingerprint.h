@@ -0,0 +1,61 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_PLUGIN_FINGERPRINT
+#define LOOT_GUI_STATE_GAME_PLUGIN_FINGERPRINT
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace loot {
+namespace gui {
+/**
+ * @brief The state of a plugin that its derived metadata depends on, used to
+ *        detect plugins that have changed since their metadata was derived.
+ */
+struct PluginFingerprint {
+  std::uintmax_t fileSize = 0;
+  std::filesystem::file_time_type modificationTime =
+      std::filesystem::file_time_type::min();
+  std::optional<uint32_t> crc;
+  bool isActive = false;
+};
+
+inline bool operator==(const PluginFingerprint& lhs,
+                       const PluginFingerprint& rhs) {
+  return lhs.fileSize == rhs.fileSize &&
+         lhs.modificationTime == rhs.modificationTime && lhs.crc == rhs.crc &&
+         lhs.isActive == rhs.isActive;
+}
+
+inline bool operator!=(const PluginFingerprint& lhs,
+                       const PluginFingerprint& rhs) {
+  return !(lhs == rhs);
+}
+}
+}
+
+#endif
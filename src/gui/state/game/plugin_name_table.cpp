@@ -0,0 +1,89 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/plugin_name_table.h"
+
+#include <stdexcept>
+
+#include "gui/helpers.h"
+
+namespace loot {
+namespace gui {
+PluginId PluginNameTable::Intern(const std::string& name) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto id = FindLocked(name);
+  if (id.has_value()) {
+    return id.value();
+  }
+
+  auto newId = static_cast<PluginId>(names_.size());
+  names_.push_back(name);
+  idsByNormalizedName_.emplace(NormalizeFilename(name), newId);
+  idsByExactName_.emplace(name, newId);
+
+  return newId;
+}
+
+std::optional<PluginId> PluginNameTable::Find(const std::string& name) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  return FindLocked(name);
+}
+
+const std::string& PluginNameTable::GetName(PluginId id) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (id >= names_.size()) {
+    throw std::out_of_range("No plugin name has the ID " +
+                            std::to_string(id));
+  }
+
+  return names_[id];
+}
+
+size_t PluginNameTable::Size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  return names_.size();
+}
+
+std::optional<PluginId> PluginNameTable::FindLocked(
+    const std::string& name) const {
+  auto exactIt = idsByExactName_.find(name);
+  if (exactIt != idsByExactName_.end()) {
+    return exactIt->second;
+  }
+
+  auto it = idsByNormalizedName_.find(NormalizeFilename(name));
+  if (it == idsByNormalizedName_.end()) {
+    return std::nullopt;
+  }
+
+  idsByExactName_.emplace(name, it->second);
+  return it->second;
+}
+}
+}
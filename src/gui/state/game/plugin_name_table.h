@@ -0,0 +1,78 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_PLUGIN_NAME_TABLE
+#define LOOT_GUI_STATE_GAME_PLUGIN_NAME_TABLE
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace loot {
+namespace gui {
+typedef std::uint32_t PluginId;
+
+/**
+ * @brief Gives each distinct plugin name a dense integer ID, so that plugins
+ *        can be compared, hashed and used as keys without normalising the
+ *        case of their names each time.
+ * @details Names that are equal when compared using CompareFilenames() share
+ *          an ID. IDs are never reused, and names are never removed, so IDs
+ *          remain valid for the lifetime of the table. The table can be used
+ *          from multiple threads.
+ */
+class PluginNameTable {
+public:
+  // Get the ID of the given name, adding the name to the table if necessary.
+  PluginId Intern(const std::string& name);
+
+  // Get the ID of the given name, if it is in the table.
+  std::optional<PluginId> Find(const std::string& name) const;
+
+  // Get the name of the given ID as it was first interned.
+  const std::string& GetName(PluginId id) const;
+
+  size_t Size() const;
+
+private:
+  // Must be called with mutex_ locked.
+  std::optional<PluginId> FindLocked(const std::string& name) const;
+
+  mutable std::mutex mutex_;
+  // A deque's elements stay in place as it grows, so references to names can
+  // be handed out.
+  std::deque<std::string> names_;
+  std::unordered_map<std::string, PluginId> idsByNormalizedName_;
+  // Plugin names are usually looked up using the same case each time, so
+  // remember the exact names that have been seen to skip normalising them.
+  mutable std::unordered_map<std::string, PluginId> idsByExactName_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/plugin_validity_cache.h"
+
+#include <fstream>
+
+#include "gui/helpers.h"
+#include "gui/state/binary_io.h"
+#include "gui/state/logging.h"
+
+namespace fs = std::filesystem;
+
+namespace loot {
+namespace gui {
+namespace {
+constexpr char MAGIC[] = {'L', 'O', 'O', 'T', 'P', 'V', 'C', '\0'};
+}
+
+void PluginValidityCache::Load(const fs::path& cachePath) {
+  entries_.clear();
+
+  if (!fs::exists(cachePath)) {
+    return;
+  }
+
+  auto logger = getLogger();
+  try {
+    std::ifstream in(cachePath, std::ios::binary);
+    in.exceptions(std::ios::badbit);
+
+    auto version = ReadBinaryHeader(in, MAGIC);
+    if (version != VERSION) {
+      if (logger) {
+        logger->info(
+            "Ignoring plugin validity cache with unsupported version {}.",
+            version);
+      }
+      return;
+    }
+
+    auto entryCount = ReadBinary<uint64_t>(in);
+    for (uint64_t i = 0; i < entryCount; ++i) {
+      auto filename = ReadBinaryString<uint32_t>(in);
+
+      Entry entry;
+      entry.fileSize = ReadBinary<uint64_t>(in);
+      entry.modificationTime = ReadBinary<int64_t>(in);
+      entry.isValid = ReadBinary<uint8_t>(in) != 0;
+      if (ReadBinary<uint8_t>(in) != 0) {
+        entry.crc = ReadBinary<uint32_t>(in);
+      }
+
+      entries_.emplace(filename, entry);
+    }
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->warn("Failed to read plugin validity cache at \"{}\": {}",
+                   cachePath.u8string(),
+                   e.what());
+    }
+    entries_.clear();
+  }
+}
+
+void PluginValidityCache::Save(const fs::path& cachePath) const {
+  WriteBinaryFile(cachePath, [&](std::ostream& out) {
+    WriteBinaryHeader(out, MAGIC, VERSION);
+    WriteBinary<uint64_t>(out, entries_.size());
+    for (const auto& entry : entries_) {
+      WriteBinaryString<uint32_t>(out, entry.first);
+      WriteBinary<uint64_t>(out, entry.second.fileSize);
+      WriteBinary<int64_t>(out, entry.second.modificationTime);
+      WriteBinary<uint8_t>(out, entry.second.isValid ? 1 : 0);
+      WriteBinary<uint8_t>(out, entry.second.crc.has_value() ? 1 : 0);
+      if (entry.second.crc.has_value()) {
+        WriteBinary<uint32_t>(out, entry.second.crc.value());
+      }
+    }
+  });
+}
+
+std::optional<bool> PluginValidityCache::IsValidPlugin(
+    const std::string& filename,
+    std::uintmax_t fileSize,
+    fs::file_time_type modificationTime) const {
+  auto entry = FindEntry(filename, fileSize, modificationTime);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+
+  return entry->isValid;
+}
+
+void PluginValidityCache::SetIsValidPlugin(const std::string& filename,
+                                           std::uintmax_t fileSize,
+                                           fs::file_time_type modificationTime,
+                                           bool isValid) {
+  entries_[NormalizeFilename(filename)] = {
+      fileSize, modificationTime.time_since_epoch().count(), isValid};
+}
+
+std::optional<uint32_t> PluginValidityCache::GetCRC(
+    const std::string& filename,
+    std::uintmax_t fileSize,
+    fs::file_time_type modificationTime) const {
+  auto entry = FindEntry(filename, fileSize, modificationTime);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+
+  return entry->crc;
+}
+
+void PluginValidityCache::SetCRC(const std::string& filename,
+                                 std::uintmax_t fileSize,
+                                 fs::file_time_type modificationTime,
+                                 uint32_t crc) {
+  auto it = entries_.find(NormalizeFilename(filename));
+  if (it != entries_.end() && it->second.fileSize == fileSize &&
+      it->second.modificationTime ==
+          modificationTime.time_since_epoch().count()) {
+    it->second.crc = crc;
+  }
+}
+
+bool PluginValidityCache::operator==(const PluginValidityCache& rhs) const {
+  return entries_.size() == rhs.entries_.size() &&
+         std::all_of(entries_.begin(), entries_.end(), [&](const auto& entry) {
+           auto it = rhs.entries_.find(entry.first);
+           return it != rhs.entries_.end() &&
+                  it->second.fileSize == entry.second.fileSize &&
+                  it->second.modificationTime ==
+                      entry.second.modificationTime &&
+                  it->second.isValid == entry.second.isValid &&
+                  it->second.crc == entry.second.crc;
+         });
+}
+
+bool PluginValidityCache::operator!=(const PluginValidityCache& rhs) const {
+  return !(*this == rhs);
+}
+
+const PluginValidityCache::Entry* PluginValidityCache::FindEntry(
+    const std::string& filename,
+    std::uintmax_t fileSize,
+    fs::file_time_type modificationTime) const {
+  auto it = entries_.find(NormalizeFilename(filename));
+  if (it == entries_.end() || it->second.fileSize != fileSize ||
+      it->second.modificationTime !=
+          modificationTime.time_since_epoch().count()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+}
+}
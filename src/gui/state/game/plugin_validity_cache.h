@@ -0,0 +1,119 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_PLUGIN_VALIDITY_CACHE
+#define LOOT_GUI_STATE_GAME_PLUGIN_VALIDITY_CACHE
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace loot {
+namespace gui {
+/**
+ * @brief A persistent record of which files in a game's Data directory are
+ *        valid plugins, so that unchanged files don't need to have their
+ *        headers read to check their validity every time LOOT starts.
+ *
+ * The cache also records the CRCs of plugins that have been fully loaded, as
+ * calculating a CRC involves reading the whole file, so that they're known
+ * when only plugins' headers have been loaded.
+ */
+class PluginValidityCache {
+public:
+  /**
+   * Load the cache from the given file. If the file doesn't exist, was
+   * written by an incompatible version of LOOT or is corrupt, the cache is
+   * left empty.
+   */
+  void Load(const std::filesystem::path& cachePath);
+
+  /**
+   * Write the cache to the given file, replacing any existing file.
+   */
+  void Save(const std::filesystem::path& cachePath) const;
+
+  /**
+   * Get the cached validity of the given file, if it has been cached and the
+   * file's size and modification time haven't changed since.
+   */
+  std::optional<bool> IsValidPlugin(
+      const std::string& filename,
+      std::uintmax_t fileSize,
+      std::filesystem::file_time_type modificationTime) const;
+
+  void SetIsValidPlugin(const std::string& filename,
+                        std::uintmax_t fileSize,
+                        std::filesystem::file_time_type modificationTime,
+                        bool isValid);
+
+  /**
+   * Get the cached CRC of the given file, if it has been cached and the
+   * file's size and modification time haven't changed since.
+   */
+  std::optional<uint32_t> GetCRC(
+      const std::string& filename,
+      std::uintmax_t fileSize,
+      std::filesystem::file_time_type modificationTime) const;
+
+  /**
+   * Cache the CRC of the given file. The CRC is only cached if the file's
+   * validity has been cached for the same size and modification time, and it
+   * is kept until the file's validity is next set.
+   */
+  void SetCRC(const std::string& filename,
+              std::uintmax_t fileSize,
+              std::filesystem::file_time_type modificationTime,
+              uint32_t crc);
+
+  bool operator==(const PluginValidityCache& rhs) const;
+  bool operator!=(const PluginValidityCache& rhs) const;
+
+private:
+  struct Entry {
+    std::uintmax_t fileSize;
+    std::filesystem::file_time_type::rep modificationTime;
+    bool isValid;
+    std::optional<uint32_t> crc;
+  };
+
+  // Get the entry for the given file if it's for the given size and
+  // modification time.
+  const Entry* FindEntry(
+      const std::string& filename,
+      std::uintmax_t fileSize,
+      std::filesystem::file_time_type modificationTime) const;
+
+  static constexpr uint32_t VERSION = 2;
+
+  // Keyed by normalised filename.
+  std::unordered_map<std::string, Entry> entries_;
+};
+}
+}
+
+#endif
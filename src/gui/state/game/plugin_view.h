@@ -0,0 +1,78 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_PLUGIN_VIEW
+#define LOOT_GUI_STATE_GAME_PLUGIN_VIEW
+
+#include <memory>
+#include <vector>
+
+#include "loot/plugin_interface.h"
+
+namespace loot {
+namespace gui {
+/**
+ * @brief A read-only view of a snapshot of a game's loaded plugins, in load
+ *        order.
+ *
+ * Copying a view only copies a pointer to its snapshot, which isn't modified
+ * after it's created, so views can be passed around and used by multiple
+ * threads without copying the plugins. The snapshot's generation is different
+ * for each snapshot that a game creates, so it can be used to tell if two
+ * views are of the same snapshot.
+ */
+class PluginView {
+public:
+  typedef std::vector<std::shared_ptr<const PluginInterface>> Plugins;
+  typedef Plugins::const_iterator const_iterator;
+
+  PluginView() : plugins_(std::make_shared<Plugins>()), generation_(0) {}
+
+  PluginView(std::shared_ptr<const Plugins> plugins, unsigned int generation) :
+      plugins_(plugins),
+      generation_(generation) {}
+
+  const_iterator begin() const { return plugins_->cbegin(); }
+  const_iterator end() const { return plugins_->cend(); }
+  const_iterator cbegin() const { return plugins_->cbegin(); }
+  const_iterator cend() const { return plugins_->cend(); }
+
+  size_t size() const { return plugins_->size(); }
+  bool empty() const { return plugins_->empty(); }
+
+  const std::shared_ptr<const PluginInterface>& operator[](size_t i) const {
+    return (*plugins_)[i];
+  }
+
+  unsigned int generation() const { return generation_; }
+
+private:
+  std::shared_ptr<const Plugins> plugins_;
+  unsigned int generation_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_SORT_PROFILE
+#define LOOT_GUI_STATE_GAME_SORT_PROFILE
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace loot {
+namespace gui {
+/**
+ * @brief How long each stage of sorting took, and counts of what was sorted,
+ *        used to find out what makes sorting a load order slow.
+ */
+struct SortProfile {
+  struct Stage {
+    std::string name;
+    std::int64_t microseconds = 0;
+  };
+
+  // In the order that they ran. libloot loads plugins as part of sorting
+  // them, so that's one stage.
+  std::vector<Stage> stages;
+
+  size_t pluginCount = 0;
+  size_t movedPluginCount = 0;
+  // True if the result of an earlier sort, possibly from an earlier session,
+  // was reused because nothing that sorting depends on had changed. The
+  // counts are then those of the earlier sort.
+  bool reusedLastResult = false;
+
+  // Keyed by DescribeEdgeType(). libloot doesn't expose its plugin graph, so
+  // these count the relationships between loaded plugins that produce edges
+  // of each type, before edges that duplicate others are skipped. Types that
+  // can't be counted from outside libloot are omitted.
+  std::map<std::string, size_t> edgeCounts;
+  // The number of pairs of plugins that have records, which is how many pairs
+  // libloot may check for overlapping records.
+  size_t overlapCandidatePairs = 0;
+};
+}
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/sort_result_cache.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "gui/state/binary_io.h"
+#include "gui/state/logging.h"
+
+namespace fs = std::filesystem;
+
+namespace loot {
+namespace gui {
+namespace {
+constexpr char MAGIC[] = {'L', 'O', 'O', 'T', 'S', 'R', 'C', '\0'};
+
+void writeStrings(std::ostream& out, const std::vector<std::string>& values) {
+  WriteBinary<uint64_t>(out, values.size());
+  for (const auto& value : values) {
+    WriteBinaryString<uint32_t>(out, value);
+  }
+}
+
+std::vector<std::string> readStrings(std::istream& in) {
+  std::vector<std::string> values;
+  auto count = ReadBinary<uint64_t>(in);
+  for (uint64_t i = 0; i < count; ++i) {
+    values.push_back(ReadBinaryString<uint32_t>(in));
+  }
+  return values;
+}
+
+void writeFingerprints(
+    std::ostream& out,
+    const std::unordered_map<std::string, PluginFingerprint>& fingerprints) {
+  WriteBinary<uint64_t>(out, fingerprints.size());
+  for (const auto& entry : fingerprints) {
+    WriteBinaryString<uint32_t>(out, entry.first);
+    WriteBinary<uint64_t>(out, entry.second.fileSize);
+    WriteBinary<int64_t>(
+        out, entry.second.modificationTime.time_since_epoch().count());
+    WriteBinary<uint8_t>(out, entry.second.isActive ? 1 : 0);
+  }
+}
+
+std::unordered_map<std::string, PluginFingerprint> readFingerprints(
+    std::istream& in) {
+  std::unordered_map<std::string, PluginFingerprint> fingerprints;
+  auto count = ReadBinary<uint64_t>(in);
+  for (uint64_t i = 0; i < count; ++i) {
+    auto filename = ReadBinaryString<uint32_t>(in);
+
+    PluginFingerprint fingerprint;
+    fingerprint.fileSize = ReadBinary<uint64_t>(in);
+    fingerprint.modificationTime = fs::file_time_type(
+        fs::file_time_type::duration(ReadBinary<int64_t>(in)));
+    fingerprint.isActive = ReadBinary<uint8_t>(in) != 0;
+
+    fingerprints.emplace(filename, fingerprint);
+  }
+  return fingerprints;
+}
+
+bool fingerprintsMatch(
+    const std::unordered_map<std::string, PluginFingerprint>& lhs,
+    const std::unordered_map<std::string, PluginFingerprint>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::all_of(lhs.begin(), lhs.end(), [&](const auto& entry) {
+           auto it = rhs.find(entry.first);
+           return it != rhs.end() &&
+                  it->second.fileSize == entry.second.fileSize &&
+                  it->second.modificationTime ==
+                      entry.second.modificationTime &&
+                  it->second.isActive == entry.second.isActive;
+         });
+}
+}
+
+bool SortResultCache::Inputs::Matches(const Inputs& other) const {
+  return metadataKey == other.metadataKey && loadOrder == other.loadOrder &&
+         fingerprintsMatch(plugins, other.plugins) &&
+         fingerprintsMatch(dataDirectoryEntries, other.dataDirectoryEntries);
+}
+
+SortResultCache::SortResultCache(Inputs inputs,
+                                 std::vector<std::string> sortedPlugins) :
+    inputs_(std::move(inputs)),
+    sortedPlugins_(std::move(sortedPlugins)) {}
+
+void SortResultCache::Load(const fs::path& cachePath) {
+  *this = SortResultCache();
+
+  if (!fs::exists(cachePath)) {
+    return;
+  }
+
+  auto logger = getLogger();
+  try {
+    std::ifstream in(cachePath, std::ios::binary);
+    in.exceptions(std::ios::badbit);
+
+    auto version = ReadBinaryHeader(in, MAGIC);
+    if (version != VERSION) {
+      if (logger) {
+        logger->info("Ignoring sort result cache with unsupported version {}.",
+                     version);
+      }
+      return;
+    }
+
+    Inputs inputs;
+    inputs.metadataKey = ReadBinaryString<uint32_t>(in);
+    inputs.loadOrder = readStrings(in);
+    inputs.plugins = readFingerprints(in);
+    inputs.dataDirectoryEntries = readFingerprints(in);
+    auto sortedPlugins = readStrings(in);
+
+    *this = SortResultCache(std::move(inputs), std::move(sortedPlugins));
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->warn("Failed to read sort result cache at \"{}\": {}",
+                   cachePath.u8string(),
+                   e.what());
+    }
+  }
+}
+
+void SortResultCache::Save(const fs::path& cachePath) const {
+  if (!inputs_.has_value()) {
+    return;
+  }
+
+  WriteBinaryFile(cachePath, [&](std::ostream& out) {
+    WriteBinaryHeader(out, MAGIC, VERSION);
+    WriteBinaryString<uint32_t>(out, inputs_->metadataKey);
+    writeStrings(out, inputs_->loadOrder);
+    writeFingerprints(out, inputs_->plugins);
+    writeFingerprints(out, inputs_->dataDirectoryEntries);
+    writeStrings(out, sortedPlugins_);
+  });
+}
+
+std::optional<std::vector<std::string>> SortResultCache::GetSortedPlugins(
+    const Inputs& inputs) const {
+  if (!inputs_.has_value() || !inputs_->Matches(inputs)) {
+    return std::nullopt;
+  }
+
+  return sortedPlugins_;
+}
+}
+}
@@ -0,0 +1,96 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_SORT_RESULT_CACHE
+#define LOOT_GUI_STATE_GAME_SORT_RESULT_CACHE
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gui/state/game/plugin_fingerprint.h"
+
+namespace loot {
+namespace gui {
+/**
+ * @brief A persistent record of a game's last sorted load order and the
+ *        inputs it was sorted from, so that LOOT doesn't need to load every
+ *        plugin and build the plugin graph again to sort an unchanged load
+ *        order in a later session.
+ */
+class SortResultCache {
+public:
+  /**
+   * @brief The state that a sorted load order depends on.
+   */
+  struct Inputs {
+    // Identifies everything other than the plugins and Data directory that
+    // sorting depends on, i.e. the LOOT version and the metadata lists.
+    std::string metadataKey;
+    std::vector<std::string> loadOrder;
+    // Keyed by normalised filename.
+    std::unordered_map<std::string, PluginFingerprint> plugins;
+    std::unordered_map<std::string, PluginFingerprint> dataDirectoryEntries;
+
+    // CRCs aren't cached, as they're only known for plugins that have been
+    // fully loaded, so they are ignored.
+    bool Matches(const Inputs& other) const;
+  };
+
+  SortResultCache() = default;
+  SortResultCache(Inputs inputs, std::vector<std::string> sortedPlugins);
+
+  /**
+   * Load the cache from the given file. If the file doesn't exist, was
+   * written by an incompatible version of LOOT or is corrupt, the cache is
+   * left empty.
+   */
+  void Load(const std::filesystem::path& cachePath);
+
+  /**
+   * Write the cache to the given file, replacing any existing file.
+   */
+  void Save(const std::filesystem::path& cachePath) const;
+
+  /**
+   * Get the cached sorted load order if it was sorted from inputs that match
+   * the given inputs.
+   */
+  std::optional<std::vector<std::string>> GetSortedPlugins(
+      const Inputs& inputs) const;
+
+private:
+  static constexpr uint32_t VERSION = 1;
+
+  std::optional<Inputs> inputs_;
+  std::vector<std::string> sortedPlugins_;
+};
+}
+}
+
+#endif
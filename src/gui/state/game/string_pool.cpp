@@ -0,0 +1,88 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/string_pool.h"
+
+namespace loot {
+namespace gui {
+StringPool::Shard& StringPool::State::GetShard(std::string_view value) {
+  return shards[std::hash<std::string_view>()(value) % SHARD_COUNT];
+}
+
+StringPool::StringPool() : state_(std::make_shared<State>()) {}
+
+PooledString StringPool::Intern(std::string_view value) {
+  auto& shard = state_->GetShard(value);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+
+  auto it = shard.strings.find(value);
+  if (it != shard.strings.end()) {
+    auto string = it->second.lock();
+    if (string) {
+      return string;
+    }
+
+    // The string is being destroyed, and its deleter is waiting for the
+    // mutex. The entry's key views the old string, so it must be replaced.
+    shard.strings.erase(it);
+  }
+
+  std::weak_ptr<State> weakState = state_;
+  auto deleter = [weakState](const std::string* value) {
+    auto state = weakState.lock();
+    if (state) {
+      auto& shard = state->GetShard(*value);
+      std::lock_guard<std::mutex> guard(shard.mutex);
+      // The entry may have been replaced by a new copy of the string.
+      auto it = shard.strings.find(*value);
+      if (it != shard.strings.end() && it->first.data() == value->data()) {
+        shard.strings.erase(it);
+      }
+    }
+    delete value;
+  };
+  PooledString string(new std::string(value), deleter);
+
+  shard.strings.emplace(*string, string);
+
+  return string;
+}
+
+size_t StringPool::Size() const {
+  size_t size = 0;
+  for (auto& shard : state_->shards) {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    size += shard.strings.size();
+  }
+
+  return size;
+}
+
+StringPool& GetStringPool() {
+  static StringPool pool;
+  return pool;
+}
+}
+}
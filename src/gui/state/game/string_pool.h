@@ -0,0 +1,88 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_STRING_POOL
+#define LOOT_GUI_STATE_GAME_STRING_POOL
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace loot {
+namespace gui {
+typedef std::shared_ptr<const std::string> PooledString;
+
+/**
+ * @brief Shares one copy of each distinct string between everything that
+ *        holds it, e.g. the same group or cleaning utility name across
+ *        thousands of plugins.
+ * @details A pooled string lives as long as something holds it: the pool
+ *          doesn't keep strings alive, and a string's entry is removed when
+ *          it's destroyed. The pool can be used from multiple threads. Its
+ *          strings are split between shards by hash, each with its own lock,
+ *          so threads interning different strings rarely wait on each other.
+ */
+class StringPool {
+public:
+  StringPool();
+
+  // Get the pooled copy of the given string, adding it if necessary.
+  PooledString Intern(std::string_view value);
+
+  // The number of distinct strings that are held.
+  size_t Size() const;
+
+private:
+  static constexpr size_t SHARD_COUNT = 16;
+
+  // Shards are aligned to cache lines so that locking one doesn't slow down
+  // access to its neighbours.
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    // Keys view the strings that the values point to.
+    std::unordered_map<std::string_view, std::weak_ptr<const std::string>>
+        strings;
+  };
+
+  struct State {
+    Shard& GetShard(std::string_view value);
+
+    std::array<Shard, SHARD_COUNT> shards;
+  };
+
+  // Pooled strings' deleters remove their entries from the state, and can
+  // outlive the pool.
+  std::shared_ptr<State> state_;
+};
+
+// The pool used for strings that are shared between plugins' metadata.
+StringPool& GetStringPool();
+}
+}
+
+#endif
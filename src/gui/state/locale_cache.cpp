@@ -0,0 +1,65 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/locale_cache.h"
+
+#include <boost/locale.hpp>
+
+namespace loot {
+LocaleCache::LocaleCache(const std::filesystem::path& messagesPath) :
+    messagesPath_(messagesPath.u8string()) {}
+
+void LocaleCache::Prefetch(const std::string& language) {
+  GetFuture(language, std::launch::async);
+}
+
+std::locale LocaleCache::Get(const std::string& language) {
+  // If the locale hasn't been prefetched, there's no point generating it on
+  // another thread just to wait for it.
+  return GetFuture(language, std::launch::deferred).get();
+}
+
+std::shared_future<std::locale> LocaleCache::GetFuture(
+    const std::string& language,
+    std::launch policy) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto it = locales_.find(language);
+  if (it != locales_.end()) {
+    return it->second;
+  }
+
+  auto future = std::async(policy, [messagesPath = messagesPath_, language]() {
+                  boost::locale::generator generator;
+                  generator.add_messages_path(messagesPath);
+                  generator.add_messages_domain("loot");
+
+                  return generator(language + ".UTF-8");
+                }).share();
+  locales_.emplace(language, future);
+
+  return future;
+}
+}
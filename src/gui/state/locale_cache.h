@@ -0,0 +1,66 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_LOCALE_CACHE
+#define LOOT_GUI_STATE_LOCALE_CACHE
+
+#include <filesystem>
+#include <future>
+#include <locale>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace loot {
+/**
+ * @brief Generates the UTF-8 locale for each language, including its
+ *        translations, at most once.
+ * @details Generating a locale loads and parses its language's translation
+ *          catalog, which is slow enough to be noticeable during startup, so
+ *          locales can be generated in the background before they're needed.
+ */
+class LocaleCache {
+public:
+  explicit LocaleCache(const std::filesystem::path& messagesPath);
+
+  // Start generating the locale for the given language on another thread, if
+  // it hasn't already been generated or started.
+  void Prefetch(const std::string& language);
+
+  // Get the locale for the given language, generating it if necessary, or
+  // waiting for it to finish generating if it was prefetched.
+  std::locale Get(const std::string& language);
+
+private:
+  std::shared_future<std::locale> GetFuture(const std::string& language,
+                                            std::launch policy);
+
+  const std::string messagesPath_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_future<std::locale>> locales_;
+};
+}
+
+#endif
@@ -0,0 +1,247 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/log_bridge.h"
+
+#include <cctype>
+
+namespace loot {
+static constexpr std::chrono::seconds RATE_LIMIT_WINDOW(1);
+
+// The innermost operation in progress on the current thread, for any bridge.
+static thread_local LogBridge::Operation* currentOperation = nullptr;
+
+LogBridge::Operation::Operation(LogBridge& bridge, const std::string& name) :
+    bridge_(bridge), name_(name), previous_(currentOperation) {
+  currentOperation = this;
+}
+
+LogBridge::Operation::~Operation() {
+  bridge_.EndOperation(*this);
+  currentOperation = previous_;
+}
+
+LogBridge::LogBridge(Sink sink) : LogBridge(sink, Limits()) {}
+
+LogBridge::LogBridge(Sink sink, Limits limits) :
+    sink_(sink),
+    limits_(limits),
+    lastLevel_(spdlog::level::trace),
+    repeatCount_(0),
+    linesInWindow_(0) {}
+
+void LogBridge::SetLimits(const Limits& limits) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  limits_ = limits;
+  while (backtrace_.size() > limits_.backtraceSize) {
+    backtrace_.pop_front();
+  }
+}
+
+void LogBridge::Log(spdlog::level::level_enum level,
+                    const std::string& message,
+                    std::chrono::steady_clock::time_point time) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (level >= spdlog::level::warn) {
+    FlushRepeatsLocked();
+    if (level >= spdlog::level::err) {
+      FlushBacktraceLocked();
+    }
+    sink_(level, message);
+    lastMessage_.clear();
+    return;
+  }
+
+  if (message == lastMessage_) {
+    ++repeatCount_;
+    return;
+  }
+
+  FlushRepeatsLocked();
+  lastMessage_ = message;
+  lastLevel_ = level;
+
+  auto& counts = GetCurrentCounts();
+  if (IsSampled(counts, message) && IsWithinRateLimit(time)) {
+    sink_(level, message);
+  } else {
+    Suppress(counts, level, message);
+  }
+}
+
+void LogBridge::Summarise(const std::string& operation) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  FlushRepeatsLocked();
+  lastMessage_.clear();
+
+  SummariseLocked(unattributedCounts_, operation);
+}
+
+std::string LogBridge::GetCategory(const std::string& message) {
+  std::string category;
+  category.reserve(message.size());
+
+  bool isInQuotes = false;
+  bool isInNumber = false;
+  for (const auto character : message) {
+    if (character == '"') {
+      if (!isInQuotes) {
+        category += "\"\"";
+      }
+      isInQuotes = !isInQuotes;
+      isInNumber = false;
+      continue;
+    }
+
+    if (isInQuotes) {
+      continue;
+    }
+
+    if (std::isdigit(static_cast<unsigned char>(character))) {
+      if (!isInNumber) {
+        category += '#';
+      }
+      isInNumber = true;
+      continue;
+    }
+
+    isInNumber = false;
+    category += character;
+  }
+
+  return category;
+}
+
+LogBridge::LineCounts& LogBridge::GetCurrentCounts() {
+  for (auto operation = currentOperation; operation != nullptr;
+       operation = operation->previous_) {
+    if (&operation->bridge_ == this) {
+      return operation->counts_;
+    }
+  }
+
+  return unattributedCounts_;
+}
+
+void LogBridge::EndOperation(Operation& operation) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  FlushRepeatsLocked();
+  lastMessage_.clear();
+
+  SummariseLocked(operation.counts_, operation.name_);
+}
+
+bool LogBridge::IsSampled(LineCounts& counts, const std::string& message) {
+  const auto count = ++counts.categoryCounts[GetCategory(message)];
+  if (count <= limits_.linesPerCategory) {
+    return true;
+  }
+
+  return limits_.sampleInterval != 0 &&
+         (count - limits_.linesPerCategory) % limits_.sampleInterval == 0;
+}
+
+bool LogBridge::IsWithinRateLimit(std::chrono::steady_clock::time_point time) {
+  if (time - windowStart_ >= RATE_LIMIT_WINDOW) {
+    windowStart_ = time;
+    linesInWindow_ = 0;
+  }
+
+  if (linesInWindow_ >= limits_.linesPerSecond) {
+    return false;
+  }
+
+  ++linesInWindow_;
+  return true;
+}
+
+void LogBridge::Suppress(LineCounts& counts,
+                         spdlog::level::level_enum level,
+                         const std::string& message) {
+  ++counts.suppressedCount;
+
+  if (limits_.backtraceSize == 0) {
+    return;
+  }
+
+  if (backtrace_.size() == limits_.backtraceSize) {
+    backtrace_.pop_front();
+  }
+  backtrace_.emplace_back(level, message);
+}
+
+void LogBridge::SummariseLocked(LineCounts& counts,
+                                const std::string& operation) {
+  if (counts.suppressedCount > 0) {
+    sink_(spdlog::level::info,
+          "Suppressed " + std::to_string(counts.suppressedCount) +
+              " similar lines while " + operation + ".");
+  }
+
+  counts.categoryCounts.clear();
+  counts.suppressedCount = 0;
+}
+
+void LogBridge::FlushRepeatsLocked() {
+  if (repeatCount_ == 0) {
+    return;
+  }
+
+  sink_(lastLevel_,
+        "The previous message was repeated " + std::to_string(repeatCount_) +
+            " times.");
+  repeatCount_ = 0;
+}
+
+void LogBridge::FlushBacktraceLocked() {
+  if (backtrace_.empty()) {
+    return;
+  }
+
+  sink_(spdlog::level::err,
+        "Writing the " + std::to_string(backtrace_.size()) +
+            " most recent suppressed lines before the following error:");
+  for (const auto& line : backtrace_) {
+    sink_(line.first, line.second);
+  }
+  backtrace_.clear();
+}
+
+LogBridge& GetLibraryLogBridge() {
+  static LogBridge bridge(
+      [](spdlog::level::level_enum level, const std::string& message) {
+        auto logger = getLogger();
+        if (logger) {
+          logger->log(level, message);
+        }
+      });
+
+  return bridge;
+}
+}
@@ -0,0 +1,171 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_LOG_BRIDGE
+#define LOOT_GUI_STATE_LOG_BRIDGE
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "gui/state/logging.h"
+
+namespace loot {
+/**
+ * @brief Forwards messages from libloot to the log, limiting how many
+ *        similar low-severity messages are written.
+ * @details libloot can log a line for every plugin or sorting graph edge,
+ *          and most of those lines only differ in the names and numbers that
+ *          they contain. Messages are grouped into categories by replacing
+ *          quoted text and numbers, and once a category has logged enough
+ *          lines in an operation only a sample of its later lines are
+ *          logged. Exact repeats of the previous message are counted
+ *          instead of logged, and low-severity lines are also limited to a
+ *          maximum rate. Warnings and errors are always logged.
+ */
+class LogBridge {
+private:
+  struct LineCounts {
+    std::unordered_map<std::string, size_t> categoryCounts;
+    size_t suppressedCount = 0;
+  };
+
+public:
+  /**
+   * @brief An operation whose suppressed lines are summarised when it ends.
+   * @details Lines are counted against the innermost operation in progress
+   *          on the thread that logs them, so operations running on other
+   *          threads don't share or reset each other's counts. Lines logged
+   *          on threads with no operation in progress, e.g. libloot's own
+   *          worker threads, are counted separately by the bridge.
+   */
+  class Operation {
+  public:
+    Operation(LogBridge& bridge, const std::string& name);
+    ~Operation();
+
+    Operation(const Operation&) = delete;
+    Operation& operator=(const Operation&) = delete;
+
+  private:
+    friend class LogBridge;
+
+    LogBridge& bridge_;
+    const std::string name_;
+    Operation* const previous_;
+    LineCounts counts_;
+  };
+
+  struct Limits {
+    // The number of lines per category that are always logged in an
+    // operation.
+    size_t linesPerCategory = 100;
+    // After that, every nth line of the category is logged. 0 means that no
+    // more lines are logged.
+    size_t sampleInterval = 1000;
+    // The number of low-severity lines that can be logged each second.
+    size_t linesPerSecond = 2000;
+    // The number of suppressed lines to keep, so that they can be written
+    // out if an error is logged. 0 means that no lines are kept.
+    size_t backtraceSize = 0;
+  };
+
+  typedef std::function<void(spdlog::level::level_enum, const std::string&)>
+      Sink;
+
+  explicit LogBridge(Sink sink);
+  LogBridge(Sink sink, Limits limits);
+
+  void SetLimits(const Limits& limits);
+
+  void Log(spdlog::level::level_enum level,
+           const std::string& message,
+           std::chrono::steady_clock::time_point time =
+               std::chrono::steady_clock::now());
+
+  // Log how many lines that were logged outside of any operation were
+  // suppressed since the last summary, if any were, and reset their
+  // per-category counts.
+  void Summarise(const std::string& operation);
+
+  // Get the category that a message belongs to, which is the message with
+  // quoted text and numbers replaced.
+  static std::string GetCategory(const std::string& message);
+
+private:
+  // Get the counts for lines logged on the calling thread.
+  LineCounts& GetCurrentCounts();
+  void EndOperation(Operation& operation);
+  bool IsSampled(LineCounts& counts, const std::string& message);
+  bool IsWithinRateLimit(std::chrono::steady_clock::time_point time);
+  void Suppress(LineCounts& counts,
+                spdlog::level::level_enum level,
+                const std::string& message);
+  void SummariseLocked(LineCounts& counts, const std::string& operation);
+  void FlushRepeatsLocked();
+  void FlushBacktraceLocked();
+
+  const Sink sink_;
+  std::mutex mutex_;
+  Limits limits_;
+
+  // Counts for lines logged on threads with no operation in progress.
+  LineCounts unattributedCounts_;
+
+  std::string lastMessage_;
+  spdlog::level::level_enum lastLevel_;
+  size_t repeatCount_;
+
+  std::chrono::steady_clock::time_point windowStart_;
+  size_t linesInWindow_;
+
+  std::deque<std::pair<spdlog::level::level_enum, std::string>> backtrace_;
+};
+
+// Get the bridge that libloot's log messages are passed through.
+LogBridge& GetLibraryLogBridge();
+
+/**
+ * @brief Summarises the library log lines suppressed on the current thread
+ *        during its lifetime when it is destroyed.
+ */
+class ScopedLogSummary {
+public:
+  explicit ScopedLogSummary(const char* operation) :
+      operation_(GetLibraryLogBridge(), operation) {}
+
+  ScopedLogSummary(const ScopedLogSummary&) = delete;
+  ScopedLogSummary& operator=(const ScopedLogSummary&) = delete;
+
+private:
+  LogBridge::Operation operation_;
+};
+}
+
+#endif
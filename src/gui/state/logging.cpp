@@ -25,11 +25,58 @@
 
 #include "gui/state/logging.h"
 
+#include <exception>
+
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_sinks.h>
 
 namespace loot {
 static const char* LOGGER_NAME = "loot_logger";
+// The queue is bounded, and logging blocks while it is full so that no
+// messages are lost.
+static constexpr size_t ASYNC_LOG_QUEUE_SIZE = 8192;
+static constexpr std::chrono::seconds ASYNC_LOG_FLUSH_INTERVAL(1);
+
+static bool isTerminateHandlerSet = false;
+static std::terminate_handler previousTerminateHandler = nullptr;
+
+static void flushLogAndTerminate() {
+  shutdownLogging();
+
+  if (previousTerminateHandler) {
+    previousTerminateHandler();
+  }
+  std::abort();
+}
+
+static std::shared_ptr<spdlog::logger> createAsyncFileLogger(
+    const std::filesystem::path& outputFile) {
+  if (!spdlog::thread_pool()) {
+    spdlog::init_thread_pool(ASYNC_LOG_QUEUE_SIZE, 1);
+  }
+
+  if (!isTerminateHandlerSet) {
+    previousTerminateHandler = std::set_terminate(flushLogAndTerminate);
+    isTerminateHandlerSet = true;
+  }
+
+#if defined(_WIN32) && defined(SPDLOG_WCHAR_FILENAMES)
+  auto logger = spdlog::create_async<spdlog::sinks::basic_file_sink_mt>(
+      LOGGER_NAME, outputFile.wstring());
+#else
+  auto logger = spdlog::create_async<spdlog::sinks::basic_file_sink_mt>(
+      LOGGER_NAME, outputFile.u8string());
+#endif
+
+  if (logger) {
+    // Write errors out promptly, everything else is written in batches.
+    logger->flush_on(spdlog::level::err);
+    spdlog::flush_every(ASYNC_LOG_FLUSH_INTERVAL);
+  }
+
+  return logger;
+}
 
 std::shared_ptr<spdlog::logger> getLogger() {
   auto logger = spdlog::get(LOGGER_NAME);
@@ -46,10 +93,19 @@ std::shared_ptr<spdlog::logger> getLogger() {
   return logger;
 }
 
-void setLogPath(const std::filesystem::path& outputFile) {
+void setLogPath(const std::filesystem::path& outputFile, bool asynchronous) {
   spdlog::set_pattern("[%T.%f] [%l]: %v");
 
   spdlog::drop(LOGGER_NAME);
+
+  if (asynchronous) {
+    auto logger = createAsyncFileLogger(outputFile);
+    if (!logger) {
+      throw std::runtime_error("Error: Could not initialise logging.");
+    }
+    return;
+  }
+
 #if defined(_WIN32) && defined(SPDLOG_WCHAR_FILENAMES)
   auto logger = spdlog::basic_logger_mt(LOGGER_NAME,
                                         outputFile.wstring());
@@ -64,6 +120,12 @@ void setLogPath(const std::filesystem::path& outputFile) {
   logger->flush_on(spdlog::level::trace);
 }
 
+void shutdownLogging() {
+  // Dropping the loggers blocks until the async logger's queue has been
+  // written out.
+  spdlog::shutdown();
+}
+
 void enableDebugLogging(bool enable) {
   auto logger = getLogger();
   if (logger) {
@@ -35,7 +35,14 @@
 namespace loot {
 std::shared_ptr<spdlog::logger> getLogger();
 
-void setLogPath(const std::filesystem::path& outputFile);
+// If asynchronous is true, messages are queued and written to the log file in
+// batches on a background thread, with errors being written out promptly.
+void setLogPath(const std::filesystem::path& outputFile,
+                bool asynchronous = true);
+
+// Write out any queued log messages and stop logging to the log file. This is
+// also done if the program terminates due to an unhandled exception.
+void shutdownLogging();
 
 void enableDebugLogging(bool enable);
 }
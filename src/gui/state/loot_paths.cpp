@@ -123,6 +123,10 @@ std::filesystem::path LootPaths::getLogPath() const {
   return lootDataPath_ / "LOOTDebugLog.txt";
 }
 
+std::filesystem::path LootPaths::getStartupHistoryPath() const {
+  return lootDataPath_ / "startup_history.jsonl";
+}
+
 std::filesystem::path LootPaths::getLocalAppDataPath() {
 #ifdef _WIN32
   HWND owner = 0;
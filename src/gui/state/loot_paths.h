@@ -40,6 +40,7 @@ public:
   std::filesystem::path getLootDataPath() const;
   std::filesystem::path getSettingsPath() const;
   std::filesystem::path getLogPath() const;
+  std::filesystem::path getStartupHistoryPath() const;
 
 private:
   // Get the local application data path.
@@ -25,7 +25,9 @@
 
 #include "gui/state/loot_settings.h"
 
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <thread>
 
 #include <cpptoml.h>
@@ -35,7 +37,7 @@
 #include "gui/version.h"
 
 using std::lock_guard;
-using std::recursive_mutex;
+using std::mutex;
 using std::string;
 using std::filesystem::u8path;
 
@@ -159,6 +161,58 @@ LootSettings::Language convert(const std::shared_ptr<cpptoml::table>& table) {
   return language;
 }
 
+void appendBaseGames(std::vector<GameSettings>& gameSettings) {
+  static const std::vector<GameType> BASE_GAME_TYPES({
+      GameType::tes3,
+      GameType::tes4,
+      GameType::tes5,
+      GameType::tes5se,
+      GameType::tes5vr,
+      GameType::fo3,
+      GameType::fonv,
+      GameType::fo4,
+      GameType::fo4vr,
+  });
+
+  for (auto gameType : BASE_GAME_TYPES) {
+    if (find(begin(gameSettings), end(gameSettings), GameSettings(gameType)) ==
+        end(gameSettings))
+      gameSettings.push_back(GameSettings(gameType));
+  }
+}
+
+// GameSettings' equality operator only compares identities, so compare
+// everything that's saved instead.
+bool hasEqualSavedValues(const GameSettings& lhs, const GameSettings& rhs) {
+  return lhs.Type() == rhs.Type() && lhs.Name() == rhs.Name() &&
+         lhs.FolderName() == rhs.FolderName() &&
+         lhs.Master() == rhs.Master() &&
+         lhs.MinimumHeaderVersion() == rhs.MinimumHeaderVersion() &&
+         lhs.RepoURL() == rhs.RepoURL() &&
+         lhs.RepoBranch() == rhs.RepoBranch() &&
+         lhs.GamePath() == rhs.GamePath() &&
+         lhs.GameLocalPath() == rhs.GameLocalPath() &&
+         lhs.RegistryKey() == rhs.RegistryKey();
+}
+
+bool hasEqualSavedValues(const std::vector<GameSettings>& lhs,
+                         const std::vector<GameSettings>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.begin(),
+                    lhs.end(),
+                    rhs.begin(),
+                    [](const GameSettings& left, const GameSettings& right) {
+                      return hasEqualSavedValues(left, right);
+                    });
+}
+
+bool hasEqualSavedValues(const LootSettings::WindowPosition& lhs,
+                         const LootSettings::WindowPosition& rhs) {
+  return lhs.top == rhs.top && lhs.bottom == rhs.bottom &&
+         lhs.left == rhs.left && lhs.right == rhs.right &&
+         lhs.maximised == rhs.maximised;
+}
+
 LootSettings::WindowPosition::WindowPosition() :
     top(0),
     bottom(0),
@@ -166,52 +220,53 @@ LootSettings::WindowPosition::WindowPosition() :
     right(0),
     maximised(false) {}
 
-LootSettings::LootSettings() :
-    gameSettings_({
-        GameSettings(GameType::tes3),
-        GameSettings(GameType::tes4),
-        GameSettings(GameType::tes5),
-        GameSettings(GameType::tes5se),
-        GameSettings(GameType::tes5vr),
-        GameSettings(GameType::fo3),
-        GameSettings(GameType::fonv),
-        GameSettings(GameType::fo4),
-        GameSettings(GameType::fo4vr),
-        GameSettings(GameType::tes4, "Nehrim")
-            .SetName("Nehrim - At Fate's Edge")
-            .SetMaster("Nehrim.esm")
-            .SetRegistryKey("Software\\Microsoft\\Windows\\CurrentVersion\\Unin"
-                            "stall\\Nehrim - At Fate's "
-                            "Edge_is1\\InstallLocation"),
-    }),
-    languages_({
-        Language({"cs", "Čeština", std::nullopt}),
-        Language({"da", "Dansk", std::nullopt}),
-        Language({"de", "Deutsch", std::nullopt}),
-        Language({"en", "English", std::nullopt}),
-        Language({"es", "Español", std::nullopt}),
-        Language({"fi", "suomi", std::nullopt}),
-        Language({"fr", "Français", std::nullopt}),
-        Language({"ko", "한국어", "Malgun Gothic"}),
-        Language({"pl", "Polski", std::nullopt}),
-        Language({"pt_BR", "Português do Brasil", std::nullopt}),
-        Language({"ru", "Русский", std::nullopt}),
-        Language({"sv", "Svenska", std::nullopt}),
-        Language({"zh_CN", "简体中文", "Microsoft Yahei"}),
-        Language({"ja", "日本語", "Meiryo"}),
-      }),
-    autoSort_(false),
-    enableDebugLogging_(false),
-    updateMasterlist_(true),
-    enableLootUpdateCheck_(true),
-    game_("auto"),
-    language_("en"),
-    theme_("default"),
-    lastGame_("auto") {}
+LootSettings::LootSettings() {
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->gameSettings = {
+      GameSettings(GameType::tes3),
+      GameSettings(GameType::tes4),
+      GameSettings(GameType::tes5),
+      GameSettings(GameType::tes5se),
+      GameSettings(GameType::tes5vr),
+      GameSettings(GameType::fo3),
+      GameSettings(GameType::fonv),
+      GameSettings(GameType::fo4),
+      GameSettings(GameType::fo4vr),
+      GameSettings(GameType::tes4, "Nehrim")
+          .SetName("Nehrim - At Fate's Edge")
+          .SetMaster("Nehrim.esm")
+          .SetRegistryKey("Software\\Microsoft\\Windows\\CurrentVersion\\Unin"
+                          "stall\\Nehrim - At Fate's "
+                          "Edge_is1\\InstallLocation"),
+  };
+  snapshot->languages = {
+      Language({"cs", "Čeština", std::nullopt}),
+      Language({"da", "Dansk", std::nullopt}),
+      Language({"de", "Deutsch", std::nullopt}),
+      Language({"en", "English", std::nullopt}),
+      Language({"es", "Español", std::nullopt}),
+      Language({"fi", "suomi", std::nullopt}),
+      Language({"fr", "Français", std::nullopt}),
+      Language({"ko", "한국어", "Malgun Gothic"}),
+      Language({"pl", "Polski", std::nullopt}),
+      Language({"pt_BR", "Português do Brasil", std::nullopt}),
+      Language({"ru", "Русский", std::nullopt}),
+      Language({"sv", "Svenska", std::nullopt}),
+      Language({"zh_CN", "简体中文", "Microsoft Yahei"}),
+      Language({"ja", "日本語", "Meiryo"}),
+  };
+
+  snapshot_ = snapshot;
+}
+
+LootSettings::~LootSettings() {
+  // Complete any pending save while the settings are still intact.
+  saveTask_.reset();
+}
 
 void LootSettings::load(const std::filesystem::path& file,
                         const std::filesystem::path& lootDataPath) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
 
   // Don't use cpptoml::parse_file() as it just uses a std stream,
   // which don't support UTF-8 paths on Windows.
@@ -222,18 +277,36 @@ void LootSettings::load(const std::filesystem::path& file,
 
   auto settings = cpptoml::parser(in).parse();
 
-  enableDebugLogging_ = settings->get_as<bool>("enableDebugLogging")
-                            .value_or(enableDebugLogging_);
-  updateMasterlist_ =
-      settings->get_as<bool>("updateMasterlist").value_or(updateMasterlist_);
-  enableLootUpdateCheck_ = settings->get_as<bool>("enableLootUpdateCheck")
-                               .value_or(enableLootUpdateCheck_);
-  game_ = settings->get_as<std::string>("game").value_or(game_);
-  language_ = settings->get_as<std::string>("language").value_or(language_);
-  theme_ = settings->get_as<std::string>("theme").value_or(theme_);
-  lastGame_ = settings->get_as<std::string>("lastGame").value_or(lastGame_);
-  lastVersion_ =
-      settings->get_as<std::string>("lastVersion").value_or(lastVersion_);
+  auto snapshot = copySnapshot();
+
+  snapshot->enableDebugLogging = settings->get_as<bool>("enableDebugLogging")
+                                     .value_or(snapshot->enableDebugLogging);
+  snapshot->updateMasterlist = settings->get_as<bool>("updateMasterlist")
+                                   .value_or(snapshot->updateMasterlist);
+  snapshot->enableLootUpdateCheck =
+      settings->get_as<bool>("enableLootUpdateCheck")
+          .value_or(snapshot->enableLootUpdateCheck);
+  snapshot->preloadGames =
+      settings->get_as<bool>("preloadGames").value_or(snapshot->preloadGames);
+  snapshot->lowFootprintMode = settings->get_as<bool>("lowFootprintMode")
+                                   .value_or(snapshot->lowFootprintMode);
+  snapshot->maxLoadedGames = settings->get_as<unsigned int>("maxLoadedGames")
+                                 .value_or(snapshot->maxLoadedGames);
+  snapshot->pluginReadingThreads =
+      settings->get_as<unsigned int>("pluginReadingThreads")
+          .value_or(snapshot->pluginReadingThreads);
+  snapshot->cacheBudgetMiB = settings->get_as<unsigned int>("cacheBudgetMiB")
+                                 .value_or(snapshot->cacheBudgetMiB);
+  snapshot->game =
+      settings->get_as<std::string>("game").value_or(snapshot->game);
+  snapshot->language =
+      settings->get_as<std::string>("language").value_or(snapshot->language);
+  snapshot->theme =
+      settings->get_as<std::string>("theme").value_or(snapshot->theme);
+  snapshot->lastGame =
+      settings->get_as<std::string>("lastGame").value_or(snapshot->lastGame);
+  snapshot->lastVersion = settings->get_as<std::string>("lastVersion")
+                              .value_or(snapshot->lastVersion);
 
   auto windowTop = settings->get_qualified_as<long>("window.top");
   auto windowBottom = settings->get_qualified_as<long>("window.bottom");
@@ -248,60 +321,68 @@ void LootSettings::load(const std::filesystem::path& file,
     windowPosition.left = *windowLeft;
     windowPosition.right = *windowRight;
     windowPosition.maximised = *windowMaximised;
-    windowPosition_ = windowPosition;
+    snapshot->windowPosition = windowPosition;
   }
 
   auto games = settings->get_table_array("games");
   if (games) {
-    gameSettings_.clear();
+    snapshot->gameSettings.clear();
 
     for (const auto& game : *games) {
       try {
-        gameSettings_.push_back(convert(game, lootDataPath));
+        snapshot->gameSettings.push_back(convert(game, lootDataPath));
       } catch (...) {
         // Skip invalid games.
       }
     }
 
-    appendBaseGames();
+    appendBaseGames(snapshot->gameSettings);
   }
 
   auto filters = settings->get_table("filters");
   if (filters) {
-    filters_.clear();
+    snapshot->filters.clear();
     for (const auto& filter : *filters) {
       auto value = filter.second->as<bool>();
       if (value) {
-        filters_.emplace(filter.first, value->get());
+        snapshot->filters.emplace(filter.first, value->get());
       }
     }
   }
 
   auto languages = settings->get_table_array("languages");
   if (languages) {
-    languages_.clear();
+    snapshot->languages.clear();
     for (const auto& language : *languages) {
-      languages_.push_back(convert(language));
+      snapshot->languages.push_back(convert(language));
     }
   }
+
+  publish(snapshot);
 }
 
 void LootSettings::save(const std::filesystem::path& file) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  // The snapshot can't change, so no lock is needed.
+  auto snapshot = getSnapshot();
 
   auto root = cpptoml::make_table();
 
-  root->insert("enableDebugLogging", enableDebugLogging_);
-  root->insert("updateMasterlist", updateMasterlist_);
-  root->insert("enableLootUpdateCheck", enableLootUpdateCheck_);
-  root->insert("game", game_);
-  root->insert("language", language_);
-  root->insert("theme", theme_);
-  root->insert("lastGame", lastGame_);
-  root->insert("lastVersion", lastVersion_);
-
-  if (windowPosition_.has_value()) {
-    auto windowPosition = windowPosition_.value();
+  root->insert("enableDebugLogging", snapshot->enableDebugLogging);
+  root->insert("updateMasterlist", snapshot->updateMasterlist);
+  root->insert("enableLootUpdateCheck", snapshot->enableLootUpdateCheck);
+  root->insert("preloadGames", snapshot->preloadGames);
+  root->insert("lowFootprintMode", snapshot->lowFootprintMode);
+  root->insert("maxLoadedGames", snapshot->maxLoadedGames);
+  root->insert("pluginReadingThreads", snapshot->pluginReadingThreads);
+  root->insert("cacheBudgetMiB", snapshot->cacheBudgetMiB);
+  root->insert("game", snapshot->game);
+  root->insert("language", snapshot->language);
+  root->insert("theme", snapshot->theme);
+  root->insert("lastGame", snapshot->lastGame);
+  root->insert("lastVersion", snapshot->lastVersion);
+
+  if (snapshot->windowPosition.has_value()) {
+    auto windowPosition = snapshot->windowPosition.value();
     auto window = cpptoml::make_table();
     window->insert("top", windowPosition.top);
     window->insert("bottom", windowPosition.bottom);
@@ -311,10 +392,10 @@ void LootSettings::save(const std::filesystem::path& file) {
     root->insert("window", window);
   }
 
-  if (!gameSettings_.empty()) {
+  if (!snapshot->gameSettings.empty()) {
     auto games = cpptoml::make_table_array();
 
-    for (const auto& gameSettings : gameSettings_) {
+    for (const auto& gameSettings : snapshot->gameSettings) {
       auto game = cpptoml::make_table();
       game->insert("type", GameSettings(gameSettings.Type()).FolderName());
       game->insert("name", gameSettings.Name());
@@ -332,18 +413,18 @@ void LootSettings::save(const std::filesystem::path& file) {
     root->insert("games", games);
   }
 
-  if (!filters_.empty()) {
+  if (!snapshot->filters.empty()) {
     auto filters = cpptoml::make_table();
-    for (const auto& filter : filters_) {
+    for (const auto& filter : snapshot->filters) {
       filters->insert(filter.first, filter.second);
     }
     root->insert("filters", filters);
   }
 
-  if (!languages_.empty()) {
+  if (!snapshot->languages.empty()) {
     auto languageTables = cpptoml::make_table_array();
 
-    for (const auto& language : languages_) {
+    for (const auto& language : snapshot->languages) {
       auto languageTable = cpptoml::make_table();
       languageTable->insert("locale", language.locale);
       languageTable->insert("name", language.name);
@@ -355,207 +436,300 @@ void LootSettings::save(const std::filesystem::path& file) {
     root->insert("languages", languageTables);
   }
 
-  std::ofstream out(file);
-  out << *root;
-}
+  std::ostringstream content;
+  content << *root;
 
-bool LootSettings::shouldAutoSort() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+  auto tempPath = file;
+  tempPath += ".tmp";
+
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    out.exceptions(std::ios::failbit | std::ios::badbit);
+    out << content.str();
+  }
 
-  return autoSort_;
+  std::filesystem::rename(tempPath, file);
 }
 
-bool LootSettings::isDebugLoggingEnabled() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+void LootSettings::enableAutosave(const std::filesystem::path& file,
+                                  std::chrono::milliseconds debounceInterval) {
+  saveTask_ = std::make_unique<DebouncedTask>(debounceInterval, [this, file]() {
+    save(file);
 
-  return enableDebugLogging_;
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug("Saved settings to {}", file.u8string());
+    }
+  });
 }
 
-bool LootSettings::updateMasterlist() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+bool LootSettings::scheduleSave() {
+  if (!saveTask_) {
+    return false;
+  }
 
-  return updateMasterlist_;
+  saveTask_->Schedule();
+  return true;
 }
 
-bool LootSettings::isLootUpdateCheckEnabled() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+void LootSettings::flushSave() {
+  if (saveTask_) {
+    saveTask_->Flush();
+  }
+}
 
-  return enableLootUpdateCheck_;
+std::shared_ptr<const LootSettings::Snapshot> LootSettings::getSnapshot()
+    const {
+  return std::atomic_load(&snapshot_);
 }
 
-std::string LootSettings::getGame() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+bool LootSettings::shouldAutoSort() const { return getSnapshot()->autoSort; }
 
-  return game_;
+bool LootSettings::isDebugLoggingEnabled() const {
+  return getSnapshot()->enableDebugLogging;
 }
 
-std::string LootSettings::getLastGame() const {
-  lock_guard<recursive_mutex> guard(mutex_);
-
-  return lastGame_;
+bool LootSettings::updateMasterlist() const {
+  return getSnapshot()->updateMasterlist;
 }
 
-std::string LootSettings::getLastVersion() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+bool LootSettings::isLootUpdateCheckEnabled() const {
+  return getSnapshot()->enableLootUpdateCheck;
+}
 
-  return lastVersion_;
+bool LootSettings::shouldPreloadGames() const {
+  return getSnapshot()->preloadGames;
 }
 
-std::string LootSettings::getLanguage() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+bool LootSettings::isLowFootprintModeEnabled() const {
+  return getSnapshot()->lowFootprintMode;
+}
 
-  return language_;
+unsigned int LootSettings::getMaxLoadedGames() const {
+  return getSnapshot()->maxLoadedGames;
 }
 
-std::string LootSettings::getTheme() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+unsigned int LootSettings::getPluginReadingThreads() const {
+  return getSnapshot()->pluginReadingThreads;
+}
 
-  return theme_;
+unsigned int LootSettings::getCacheBudgetMiB() const {
+  return getSnapshot()->cacheBudgetMiB;
 }
 
-std::optional<LootSettings::WindowPosition> LootSettings::getWindowPosition()
-    const {
-  lock_guard<recursive_mutex> guard(mutex_);
+std::string LootSettings::getGame() const { return getSnapshot()->game; }
 
-  return windowPosition_;
+std::string LootSettings::getLastGame() const {
+  return getSnapshot()->lastGame;
 }
 
-const std::vector<GameSettings>& LootSettings::getGameSettings() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+std::string LootSettings::getLastVersion() const {
+  return getSnapshot()->lastVersion;
+}
 
-  return gameSettings_;
+std::string LootSettings::getLanguage() const {
+  return getSnapshot()->language;
 }
 
-const std::map<std::string, bool>& LootSettings::getFilters() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+std::string LootSettings::getTheme() const { return getSnapshot()->theme; }
+
+std::optional<LootSettings::WindowPosition> LootSettings::getWindowPosition()
+    const {
+  return getSnapshot()->windowPosition;
+}
 
-  return filters_;
+std::vector<GameSettings> LootSettings::getGameSettings() const {
+  return getSnapshot()->gameSettings;
 }
 
-const std::vector<LootSettings::Language>& LootSettings::getLanguages() const {
-  lock_guard<recursive_mutex> guard(mutex_);
+std::map<std::string, bool> LootSettings::getFilters() const {
+  return getSnapshot()->filters;
+}
 
-  return languages_;
+std::vector<LootSettings::Language> LootSettings::getLanguages() const {
+  return getSnapshot()->languages;
 }
 
 void LootSettings::setDefaultGame(const std::string& game) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
 
-  game_ = game;
+  auto snapshot = copySnapshot();
+  snapshot->game = game;
+  publish(snapshot);
 }
 
 void LootSettings::setLanguage(const std::string& language) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
 
-  language_ = language;
+  auto snapshot = copySnapshot();
+  snapshot->language = language;
+  publish(snapshot);
 }
 
 void LootSettings::setTheme(const std::string& theme) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
 
-  theme_ = theme;
+  auto snapshot = copySnapshot();
+  snapshot->theme = theme;
+  publish(snapshot);
 }
 
 void LootSettings::setAutoSort(bool autoSort) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
 
-  autoSort_ = autoSort;
+  auto snapshot = copySnapshot();
+  snapshot->autoSort = autoSort;
+  publish(snapshot);
 }
 
 void LootSettings::enableDebugLogging(bool enable) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
+
+  auto snapshot = copySnapshot();
+  snapshot->enableDebugLogging = enable;
+  publish(snapshot);
 
-  enableDebugLogging_ = enable;
   loot::enableDebugLogging(enable);
 }
 
 void LootSettings::updateMasterlist(bool update) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
 
-  updateMasterlist_ = update;
+  auto snapshot = copySnapshot();
+  snapshot->updateMasterlist = update;
+  publish(snapshot);
 }
 
 void LootSettings::enableLootUpdateCheck(bool enable) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  lock_guard<mutex> guard(mutex_);
+
+  auto snapshot = copySnapshot();
+  snapshot->enableLootUpdateCheck = enable;
+  publish(snapshot);
+}
+
+void LootSettings::setPreloadGames(bool preload) {
+  lock_guard<mutex> guard(mutex_);
+
+  auto snapshot = copySnapshot();
+  snapshot->preloadGames = preload;
+  publish(snapshot);
+}
+
+void LootSettings::enableLowFootprintMode(bool enable) {
+  lock_guard<mutex> guard(mutex_);
 
-  enableLootUpdateCheck_ = enable;
+  auto snapshot = copySnapshot();
+  snapshot->lowFootprintMode = enable;
+  publish(snapshot);
+}
+
+void LootSettings::setMaxLoadedGames(unsigned int maxLoadedGames) {
+  lock_guard<mutex> guard(mutex_);
+
+  auto snapshot = copySnapshot();
+  snapshot->maxLoadedGames = maxLoadedGames;
+  publish(snapshot);
+}
+
+void LootSettings::setPluginReadingThreads(unsigned int threads) {
+  lock_guard<mutex> guard(mutex_);
+
+  auto snapshot = copySnapshot();
+  snapshot->pluginReadingThreads = threads;
+  publish(snapshot);
+}
+
+void LootSettings::setCacheBudgetMiB(unsigned int cacheBudgetMiB) {
+  lock_guard<mutex> guard(mutex_);
+
+  auto snapshot = copySnapshot();
+  snapshot->cacheBudgetMiB = cacheBudgetMiB;
+  publish(snapshot);
 }
 
 void LootSettings::storeLastGame(const std::string& lastGame) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  {
+    lock_guard<mutex> guard(mutex_);
 
-  this->lastGame_ = lastGame;
+    if (getSnapshot()->lastGame == lastGame) {
+      return;
+    }
+
+    auto snapshot = copySnapshot();
+    snapshot->lastGame = lastGame;
+    publish(snapshot);
+  }
+
+  scheduleSave();
 }
 
 void LootSettings::storeWindowPosition(const WindowPosition& position) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    auto current = getSnapshot();
+    if (current->windowPosition.has_value() &&
+        hasEqualSavedValues(current->windowPosition.value(), position)) {
+      return;
+    }
 
-  windowPosition_ = position;
+    auto snapshot = copySnapshot();
+    snapshot->windowPosition = position;
+    publish(snapshot);
+  }
+
+  scheduleSave();
 }
 
 void LootSettings::storeGameSettings(
     const std::vector<GameSettings>& gameSettings) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    if (hasEqualSavedValues(getSnapshot()->gameSettings, gameSettings)) {
+      return;
+    }
+
+    auto snapshot = copySnapshot();
+    snapshot->gameSettings = gameSettings;
+    publish(snapshot);
+  }
 
-  this->gameSettings_ = gameSettings;
+  scheduleSave();
 }
 
 void LootSettings::storeFilterState(const std::string& filterId, bool enabled) {
-  lock_guard<recursive_mutex> guard(mutex_);
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    auto current = getSnapshot();
+    auto filter = current->filters.find(filterId);
+    if (filter != current->filters.end() && filter->second == enabled) {
+      return;
+    }
+
+    auto snapshot = copySnapshot();
+    snapshot->filters[filterId] = enabled;
+    publish(snapshot);
+  }
 
-  filters_[filterId] = enabled;
+  scheduleSave();
 }
 
 void LootSettings::updateLastVersion() {
-  lock_guard<recursive_mutex> guard(mutex_);
-
-  lastVersion_ = gui::Version::string();
-}
-
-void LootSettings::appendBaseGames() {
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::tes3)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::tes3));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::tes4)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::tes4));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::tes5)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::tes5));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::tes5se)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::tes5se));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::tes5vr)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::tes5vr));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::fo3)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::fo3));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::fonv)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::fonv));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::fo4)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::fo4));
-
-  if (find(begin(gameSettings_),
-           end(gameSettings_),
-           GameSettings(GameType::fo4vr)) == end(gameSettings_))
-    gameSettings_.push_back(GameSettings(GameType::fo4vr));
+  lock_guard<mutex> guard(mutex_);
+
+  auto snapshot = copySnapshot();
+  snapshot->lastVersion = gui::Version::string();
+  publish(snapshot);
+}
+
+std::shared_ptr<LootSettings::Snapshot> LootSettings::copySnapshot() const {
+  return std::make_shared<Snapshot>(*getSnapshot());
+}
+
+void LootSettings::publish(std::shared_ptr<const Snapshot> snapshot) {
+  std::atomic_store(&snapshot_, snapshot);
 }
 }
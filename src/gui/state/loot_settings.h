@@ -26,13 +26,16 @@
 #ifndef LOOT_GUI_STATE_LOOT_SETTINGS
 #define LOOT_GUI_STATE_LOOT_SETTINGS
 
+#include <chrono>
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "gui/state/debounced_task.h"
 #include "gui/state/game/game_settings.h"
 
 namespace loot {
@@ -54,25 +57,76 @@ public:
     std::optional<std::string> fontFamily;
   };
 
+  // An immutable copy of all the settings. Changing a setting publishes a
+  // new snapshot, so a snapshot can be read without locking.
+  struct Snapshot {
+    bool autoSort = false;
+    bool enableDebugLogging = false;
+    bool updateMasterlist = true;
+    bool enableLootUpdateCheck = true;
+    bool preloadGames = false;
+    // Start CEF with settings that use less memory. Only read at startup.
+    bool lowFootprintMode = false;
+    unsigned int maxLoadedGames = 3;
+    // 0 uses one thread per hardware thread.
+    unsigned int pluginReadingThreads = 0;
+    // The estimated memory that caches may use before they are evicted from.
+    // 0 means no limit.
+    unsigned int cacheBudgetMiB = 1024;
+    std::string game = "auto";
+    std::string lastGame = "auto";
+    std::string lastVersion;
+    std::string language = "en";
+    std::string theme = "default";
+    std::optional<WindowPosition> windowPosition;
+    std::vector<GameSettings> gameSettings;
+    std::map<std::string, bool> filters;
+    std::vector<Language> languages;
+  };
+
   LootSettings();
+  ~LootSettings();
 
   void load(const std::filesystem::path& file,
             const std::filesystem::path& lootDataPath);
+
+  // Writes the settings to a temporary file that then replaces the given
+  // file, so the file is never left partially written.
   void save(const std::filesystem::path& file);
 
+  // Save the settings to the given file on a background thread whenever a
+  // stored value changes and no other changes are made for the debounce
+  // interval. Any pending save is completed when the settings are destroyed.
+  void enableAutosave(const std::filesystem::path& file,
+                      std::chrono::milliseconds debounceInterval);
+
+  // Schedule an autosave, returning false if autosave is not enabled.
+  bool scheduleSave();
+
+  // Complete any pending autosave.
+  void flushSave();
+
+  // Get the current settings without locking or copying them.
+  std::shared_ptr<const Snapshot> getSnapshot() const;
+
   bool shouldAutoSort() const;
   bool isDebugLoggingEnabled() const;
   bool updateMasterlist() const;
   bool isLootUpdateCheckEnabled() const;
+  bool shouldPreloadGames() const;
+  bool isLowFootprintModeEnabled() const;
+  unsigned int getMaxLoadedGames() const;
+  unsigned int getPluginReadingThreads() const;
+  unsigned int getCacheBudgetMiB() const;
   std::string getGame() const;
   std::string getLastGame() const;
   std::string getLastVersion() const;
   std::string getLanguage() const;
   std::string getTheme() const;
   std::optional<WindowPosition> getWindowPosition() const;
-  const std::vector<GameSettings>& getGameSettings() const;
-  const std::map<std::string, bool>& getFilters() const;
-  const std::vector<Language>& getLanguages() const;
+  std::vector<GameSettings> getGameSettings() const;
+  std::map<std::string, bool> getFilters() const;
+  std::vector<Language> getLanguages() const;
 
   void setDefaultGame(const std::string& game);
   void setLanguage(const std::string& language);
@@ -81,6 +135,11 @@ public:
   void enableDebugLogging(bool enable);
   void updateMasterlist(bool update);
   void enableLootUpdateCheck(bool enable);
+  void setPreloadGames(bool preload);
+  void enableLowFootprintMode(bool enable);
+  void setMaxLoadedGames(unsigned int maxLoadedGames);
+  void setPluginReadingThreads(unsigned int threads);
+  void setCacheBudgetMiB(unsigned int cacheBudgetMiB);
 
   void storeLastGame(const std::string& lastGame);
   void storeWindowPosition(const WindowPosition& position);
@@ -89,23 +148,17 @@ public:
   void updateLastVersion();
 
 private:
-  bool autoSort_;
-  bool enableDebugLogging_;
-  bool updateMasterlist_;
-  bool enableLootUpdateCheck_;
-  std::string game_;
-  std::string lastGame_;
-  std::string lastVersion_;
-  std::string language_;
-  std::string theme_;
-  std::optional<WindowPosition> windowPosition_;
-  std::vector<GameSettings> gameSettings_;
-  std::map<std::string, bool> filters_;
-  std::vector<Language> languages_;
-
-  mutable std::recursive_mutex mutex_;
-
-  void appendBaseGames();
+  // Writers hold mutex_ while they change a copy of the current snapshot and
+  // then publish it. Readers don't lock.
+  std::shared_ptr<Snapshot> copySnapshot() const;
+  void publish(std::shared_ptr<const Snapshot> snapshot);
+
+  std::shared_ptr<const Snapshot> snapshot_;
+  std::mutex mutex_;
+
+  // This isn't guarded by mutex_, and is only changed by enableAutosave() and
+  // the destructor.
+  std::unique_ptr<DebouncedTask> saveTask_;
 };
 }
 
@@ -25,6 +25,7 @@
 
 #include "gui/state/loot_state.h"
 
+#include <algorithm>
 #include <unordered_set>
 
 #ifdef _WIN32
@@ -46,9 +47,15 @@
 #include <boost/locale.hpp>
 
 #include "gui/helpers.h"
+#include "gui/state/auto_sort.h"
+#include "gui/state/cache_registry.h"
 #include "gui/state/game/game_detection_error.h"
+#include "gui/state/game/helpers.h"
+#include "gui/state/game/message_templates.h"
+#include "gui/state/log_bridge.h"
 #include "gui/state/logging.h"
 #include "gui/state/loot_paths.h"
+#include "gui/state/startup_report.h"
 #include "gui/version.h"
 #include "loot/api.h"
 
@@ -64,40 +71,62 @@ using std::vector;
 namespace fs = std::filesystem;
 
 namespace loot {
+static constexpr std::chrono::seconds SETTINGS_SAVE_DEBOUNCE_INTERVAL(1);
+// Long enough to cover editing a few plugins' metadata one after another.
+static constexpr std::chrono::seconds USERLIST_SAVE_DEBOUNCE_INTERVAL(3);
+// The number of suppressed libloot log lines to write out if an error occurs.
+static constexpr size_t LIBRARY_LOG_BACKTRACE_SIZE = 200;
+// Evicted caches take a while to fill up again, so there's no point evicting
+// them more often than this.
+static constexpr std::chrono::seconds MEMORY_PRESSURE_EVICTION_INTERVAL(10);
+
 void apiLogCallback(LogLevel level, const char* message) {
   auto logger = getLogger();
   if (!logger) {
     return;
   }
 
+  spdlog::level::level_enum spdlogLevel;
   switch (level) {
     case LogLevel::trace:
-      logger->trace(message);
+      spdlogLevel = spdlog::level::trace;
       break;
     case LogLevel::debug:
-      logger->debug(message);
+      spdlogLevel = spdlog::level::debug;
       break;
     case LogLevel::info:
-      logger->info(message);
+      spdlogLevel = spdlog::level::info;
       break;
     case LogLevel::warning:
-      logger->warn(message);
+      spdlogLevel = spdlog::level::warn;
       break;
     case LogLevel::error:
-      logger->error(message);
+      spdlogLevel = spdlog::level::err;
       break;
     case LogLevel::fatal:
-      logger->critical(message);
+      spdlogLevel = spdlog::level::critical;
       break;
     default:
-      logger->trace(message);
+      spdlogLevel = spdlog::level::trace;
       break;
   }
+
+  // Avoid copying messages that won't be logged.
+  if (logger->should_log(spdlogLevel)) {
+    GetLibraryLogBridge().Log(spdlogLevel, message);
+  }
 }
 
 LootState::LootState(const std::filesystem::path& lootAppPath,
                      const std::filesystem::path& lootDataPath) :
-    LootPaths(lootAppPath, lootDataPath) {}
+    LootPaths(lootAppPath, lootDataPath),
+    localeCache_(LootPaths::getL10nPath()) {}
+
+LootState::~LootState() {
+  // The monitor's callback evicts from the games' caches.
+  memoryPressureMonitor_.reset();
+  StopPreloadingGames();
+}
 
 void LootState::init(const std::string& cmdLineGame, bool autoSort) {
   if (autoSort && cmdLineGame.empty()) {
@@ -107,15 +136,133 @@ void LootState::init(const std::string& cmdLineGame, bool autoSort) {
     setAutoSort(autoSort);
   }
 
-  // Do some preliminary locale / UTF-8 support setup here, in case the settings
-  // file reading requires it.
-  // Boost.Locale initialisation: Specify location of language dictionaries.
-  boost::locale::generator gen;
-  gen.add_messages_path(LootPaths::getL10nPath().u8string());
-  gen.add_messages_domain("loot");
+  initSettings();
+  initCacheBudget();
+
+  // Detect games & select startup game
+  //-----------------------------------
+
+  // Detect installed games.
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Detecting installed games.");
+  }
+  SetMaxLoadedGames(getMaxLoadedGames());
+  SetPluginReadingThreads(getPluginReadingThreads());
+  LoadInstalledGames(getGameSettings(), LootPaths::getLootDataPath());
+  RecordStartupMilestone("LoadInstalledGames");
+
+  try {
+    SetInitialGame(cmdLineGame);
+    RecordStartupMilestone("SetInitialGame");
+    if (logger) {
+      logger->debug("Game selected is {}", GetCurrentGame().Name());
+    }
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error("Game-specific settings could not be initialised: {}",
+                     e.what());
+    }
+    initErrors_.push_back(
+        (format(translate(
+             "Error: Game-specific settings could not be initialised. %1%")) %
+         e.what())
+            .str());
+  }
 
-  // Boost.Locale initialisation: Generate and imbue locales.
-  locale::global(gen("en.UTF-8"));
+  // Auto-sort usually quits without showing the UI, so preloading would only
+  // delay exiting. If the UI is shown instead, preloading starts then.
+  if (shouldPreloadGames() && !autoSort) {
+    PreloadGames();
+  }
+
+  enableAutosave(LootPaths::getSettingsPath(), SETTINGS_SAVE_DEBOUNCE_INTERVAL);
+  EnableDeferredUserMetadataSaves(USERLIST_SAVE_DEBOUNCE_INTERVAL);
+}
+
+void LootState::initHeadless() { initSettings(); }
+
+bool LootState::runAutoSort() {
+  if (!initErrors_.empty()) {
+    return false;
+  }
+
+  try {
+    return AutoSort(GetCurrentGame(), updateMasterlist());
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Auto-sort failed: {}", e.what());
+    }
+    return false;
+  }
+}
+
+bool LootState::sortCurrentGame() {
+  auto& game = GetCurrentGame();
+  if (HasErrorMessages(game)) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn(
+          "Not sorting {} as there is at least one error message.",
+          game.Name());
+    }
+    return false;
+  }
+
+  return SortAndApplyLoadOrder(game);
+}
+
+const std::vector<std::string>& LootState::getInitErrors() const {
+  return initErrors_;
+}
+
+void LootState::save(const std::filesystem::path& file) {
+  try {
+    storeLastGame(GetCurrentGame().FolderName());
+  } catch (std::runtime_error& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Couldn't set last game: {}", e.what());
+    }
+  }
+  updateLastVersion();
+
+  // If autosave is enabled, the settings will be saved in the background
+  // and any pending save is completed when LOOT exits.
+  if (!scheduleSave()) {
+    LootSettings::save(file);
+  }
+}
+
+LootState::GamePathFinder LootState::GetGamePathFinder() const {
+  return [](const GameSettings& gameSettings) {
+    return gameSettings.FindGamePath();
+  };
+}
+
+void LootState::InitialiseGameData(gui::Game& game) {
+  game.Init();
+  RecordStartupMilestone("Game::Init");
+}
+
+void LootState::PreloadGameData(gui::Game& game) {
+#ifdef _WIN32
+  // Preloading shouldn't slow down work for the current game.
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+
+  game.Init();
+  game.LoadAllInstalledPluginsAndMetadata(true, false);
+}
+
+void LootState::UnloadGameData(gui::Game& game) { game.Unload(); }
+
+void LootState::initSettings() {
+  // UTF-8 conversions were set up when the paths were initialised, and any
+  // errors before the language is known are in English, which doesn't need a
+  // translation catalog, so the locale is only generated once the settings
+  // have been loaded.
 
   // Check if the LOOT local app data folder exists, and create it if not.
   if (!fs::exists(LootPaths::getLootDataPath())) {
@@ -138,6 +285,10 @@ void LootState::init(const std::string& cmdLineGame, bool autoSort) {
               .str());
     }
   }
+  RecordStartupMilestone("Settings load");
+
+  // Generate the selected language's locale while logging is set up.
+  localeCache_.Prefetch(getLanguage());
 
   // Set up logging.
   fs::remove(LootPaths::getLogPath());
@@ -145,6 +296,14 @@ void LootState::init(const std::string& cmdLineGame, bool autoSort) {
   SetLoggingCallback(apiLogCallback);
   enableDebugLogging(isDebugLoggingEnabled());
 
+  // Only lines that would otherwise be logged can be suppressed, so there's
+  // only a backtrace to keep if debug logging is enabled.
+  LogBridge::Limits libraryLogLimits;
+  if (isDebugLoggingEnabled()) {
+    libraryLogLimits.backtraceSize = LIBRARY_LOG_BACKTRACE_SIZE;
+  }
+  GetLibraryLogBridge().SetLimits(libraryLogLimits);
+
   // Log some useful info.
   auto logger = getLogger();
   if (logger) {
@@ -163,68 +322,51 @@ void LootState::init(const std::string& cmdLineGame, bool autoSort) {
   }
 #endif
 
-  // Now that settings have been loaded, set the locale again to handle
+  // Now that settings have been loaded, set the locale to handle
   // translations.
-  if (getLanguage() != MessageContent::defaultLanguage) {
-    if (logger) {
-      logger->debug("Initialising language settings.");
-      logger->debug("Selected language: {}", getLanguage());
-    }
-
-    // Boost.Locale initialisation: Generate and imbue locales.
-    locale::global(gen(getLanguage() + ".UTF-8"));
+  if (logger && getLanguage() != MessageContent::defaultLanguage) {
+    logger->debug("Initialising language settings.");
+    logger->debug("Selected language: {}", getLanguage());
   }
+  locale::global(localeCache_.Get(getLanguage()));
+  RecordStartupMilestone("Locale generation");
 
-  // Detect games & select startup game
-  //-----------------------------------
+  gui::LoadMessageTemplates(getLanguage());
+}
 
-  // Detect installed games.
-  if (logger) {
-    logger->debug("Detecting installed games.");
-  }
-  LoadInstalledGames(getGameSettings(), LootPaths::getLootDataPath());
+void LootState::initCacheBudget() {
+  const std::uintmax_t budgetBytes = getCacheBudgetMiB();
+  GetCacheRegistry().SetBudget(budgetBytes * 1024 * 1024);
 
   try {
-    SetInitialGame(cmdLineGame);
-    if (logger) {
-      logger->debug("Game selected is {}", GetCurrentGame().Name());
-    }
+    memoryPressureMonitor_ = std::make_unique<MemoryPressureMonitor>(
+        MEMORY_PRESSURE_EVICTION_INTERVAL, []() {
+          auto freedBytes = GetCacheRegistry().EvictAll();
+
+          auto logger = getLogger();
+          if (logger) {
+            logger->info("Evicted an estimated {} bytes from caches.",
+                         freedBytes);
+          }
+        });
   } catch (std::exception& e) {
+    auto logger = getLogger();
     if (logger) {
-      logger->error("Game-specific settings could not be initialised: {}",
-                     e.what());
+      logger->warn("Unable to monitor memory pressure: {}", e.what());
     }
-    initErrors_.push_back(
-        (format(translate(
-             "Error: Game-specific settings could not be initialised. %1%")) %
-         e.what())
-            .str());
   }
 }
 
-const std::vector<std::string>& LootState::getInitErrors() const {
-  return initErrors_;
-}
+void LootState::applyLanguage(const std::string& language) {
+  setLanguage(language);
 
-void LootState::save(const std::filesystem::path& file) {
-  try {
-    storeLastGame(GetCurrentGame().FolderName());
-  } catch (std::runtime_error& e) {
-    auto logger = getLogger();
-    if (logger) {
-      logger->error("Couldn't set last game: {}", e.what());
-    }
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Switching language to: {}", language);
   }
-  updateLastVersion();
-  LootSettings::save(file);
-}
-
-std::optional<std::filesystem::path> LootState::FindGamePath(const GameSettings& gameSettings) const {
-  return gameSettings.FindGamePath();
-}
 
-void LootState::InitialiseGameData(gui::Game& game) {
-  game.Init();
+  locale::global(localeCache_.Get(language));
+  gui::LoadMessageTemplates(language);
 }
 
 void LootState::SetInitialGame(std::string preferredGame) {
@@ -255,5 +397,12 @@ void LootState::storeGameSettings(std::vector<GameSettings> gameSettings) {
 
   gameSettings = LoadInstalledGames(gameSettings, LootPaths::getLootDataPath());
   LootSettings::storeGameSettings(gameSettings);
+
+  if (shouldPreloadGames()) {
+    PreloadGames();
+  } else {
+    StopPreloadingGames();
+    UnloadPreloadedGames();
+  }
 }
 }
@@ -27,7 +27,9 @@
 #define LOOT_GUI_STATE_LOOT_STATE
 
 #include "gui/state/game/games_manager.h"
+#include "gui/state/locale_cache.h"
 #include "gui/state/loot_settings.h"
+#include "gui/state/memory_pressure_monitor.h"
 #include "gui/state/unapplied_change_counter.h"
 
 namespace loot {
@@ -35,21 +37,51 @@ class LootState : public LootSettings, public UnappliedChangeCounter, public Gam
 public:
   LootState(const std::filesystem::path& lootAppPath, 
             const std::filesystem::path& lootDataPath);
+  ~LootState();
 
   void init(const std::string& cmdLineGame, bool autoSort);
+
+  // Load settings and set up logging and translations, without detecting
+  // installed games.
+  void initHeadless();
+
+  // Load the current game's plugins and metadata, sort them and apply the
+  // sorted load order without going through the UI. Returns false if there
+  // are init errors, if loading or sorting fails, or if the UI would display
+  // any error messages, so that the UI can be shown instead. The load order
+  // isn't changed if there are any errors before sorting. This can take a
+  // while, so it shouldn't be run on the CEF UI thread.
+  bool runAutoSort();
+
+  // Sort the current game's already loaded plugins and apply the sorted load
+  // order. Returns false without changing the load order if the UI would
+  // display any error messages, and false if sorting fails.
+  bool sortCurrentGame();
   const std::vector<std::string>& getInitErrors() const;
 
   void save(const std::filesystem::path& file);
 
   void storeGameSettings(std::vector<GameSettings> gameSettings);
 
+  // Set the language and switch the global locale and message templates to
+  // it, reusing its locale if it has been used before.
+  void applyLanguage(const std::string& language);
+
 private:
-  std::optional<std::filesystem::path> FindGamePath(const GameSettings& gameSettings) const;
+  GamePathFinder GetGamePathFinder() const;
   void InitialiseGameData(gui::Game& game);
+  void PreloadGameData(gui::Game& game);
+  void UnloadGameData(gui::Game& game);
 
+  void initSettings();
+  // Apply the cache budget and evict from caches when the system is low on
+  // memory.
+  void initCacheBudget();
   void SetInitialGame(std::string cmdLineGame);
 
   std::vector<std::string> initErrors_;
+  LocaleCache localeCache_;
+  std::unique_ptr<MemoryPressureMonitor> memoryPressureMonitor_;
 
   // Mutex used to protect access to member variables.
   std::mutex mutex_;
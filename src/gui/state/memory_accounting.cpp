@@ -0,0 +1,310 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/memory_accounting.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+
+#include <fstream>
+#endif
+
+#include "gui/state/logging.h"
+
+namespace loot {
+namespace {
+std::atomic<bool> accountingEnabled(false);
+
+// This has a constant initialiser, so it's safe to use while allocating
+// memory for other thread-local or static variables.
+struct ThreadAllocationCounts {
+  std::uint64_t count;
+  std::uint64_t bytes;
+  // Can be negative, as memory can be freed by a different thread to the one
+  // that allocated it.
+  std::int64_t liveBytes;
+  std::int64_t peakLiveBytes;
+};
+
+thread_local ThreadAllocationCounts threadCounts = {0, 0, 0, 0};
+
+// Use the size of the block that was actually allocated, as it's also known
+// when the block is freed.
+std::size_t getAllocationSize(void* pointer) {
+#ifdef _WIN32
+  return _msize(pointer);
+#else
+  return malloc_usable_size(pointer);
+#endif
+}
+
+void recordAllocation(void* pointer) {
+  if (pointer == nullptr ||
+      !accountingEnabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  const auto size = static_cast<std::int64_t>(getAllocationSize(pointer));
+  auto& counts = threadCounts;
+  counts.count += 1;
+  counts.bytes += size;
+  counts.liveBytes += size;
+  counts.peakLiveBytes = std::max(counts.peakLiveBytes, counts.liveBytes);
+}
+
+void recordDeallocation(void* pointer) {
+  if (pointer == nullptr ||
+      !accountingEnabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  threadCounts.liveBytes -=
+      static_cast<std::int64_t>(getAllocationSize(pointer));
+}
+
+void* allocate(std::size_t size) {
+  // malloc(0) may return a null pointer, but operator new must not.
+  if (size == 0) {
+    size = 1;
+  }
+
+  void* pointer;
+  while ((pointer = std::malloc(size)) == nullptr) {
+    auto handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+
+  recordAllocation(pointer);
+  return pointer;
+}
+
+void* allocateNoThrow(std::size_t size) noexcept {
+  try {
+    return allocate(size);
+  } catch (std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void deallocate(void* pointer) noexcept {
+  recordDeallocation(pointer);
+  std::free(pointer);
+}
+}
+
+void SetAllocationAccountingEnabled(bool enabled) {
+  accountingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsAllocationAccountingEnabled() {
+  return accountingEnabled.load(std::memory_order_relaxed);
+}
+
+ScopedAllocationCounter::ScopedAllocationCounter() :
+    startCount_(threadCounts.count),
+    startBytes_(threadCounts.bytes),
+    startLiveBytes_(threadCounts.liveBytes),
+    outerPeakLiveBytes_(threadCounts.peakLiveBytes) {
+  // Track this scope's peak from the current live bytes, and restore the
+  // enclosing scope's peak on destruction if it's higher.
+  threadCounts.peakLiveBytes = startLiveBytes_;
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter() {
+  threadCounts.peakLiveBytes =
+      std::max(outerPeakLiveBytes_, threadCounts.peakLiveBytes);
+}
+
+AllocationCounts ScopedAllocationCounter::GetCounts() const {
+  AllocationCounts counts;
+  counts.count = threadCounts.count - startCount_;
+  counts.bytes = threadCounts.bytes - startBytes_;
+  counts.peakBytes = static_cast<std::uint64_t>(
+      std::max<std::int64_t>(0, threadCounts.peakLiveBytes - startLiveBytes_));
+  return counts;
+}
+
+#ifdef _WIN32
+std::optional<ProcessMemorySample> SampleProcessMemory() {
+  PROCESS_MEMORY_COUNTERS_EX counters;
+  if (!GetProcessMemoryInfo(
+          GetCurrentProcess(),
+          reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
+          sizeof(counters))) {
+    return std::nullopt;
+  }
+
+  ProcessMemorySample sample;
+  sample.time = std::chrono::system_clock::now();
+  sample.residentBytes = counters.WorkingSetSize;
+  sample.committedBytes = counters.PrivateUsage;
+  return sample;
+}
+#else
+std::optional<ProcessMemorySample> SampleProcessMemory() {
+  // The fields are sizes in pages: total, resident, shared, text, library
+  // (unused), data and stack, and dirty (unused).
+  std::ifstream statm("/proc/self/statm");
+  std::uint64_t totalPages = 0;
+  std::uint64_t residentPages = 0;
+  std::uint64_t sharedPages = 0;
+  std::uint64_t textPages = 0;
+  std::uint64_t libraryPages = 0;
+  std::uint64_t dataPages = 0;
+  if (!(statm >> totalPages >> residentPages >> sharedPages >> textPages >>
+        libraryPages >> dataPages)) {
+    return std::nullopt;
+  }
+
+  const auto pageSize = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+
+  ProcessMemorySample sample;
+  sample.time = std::chrono::system_clock::now();
+  sample.residentBytes = residentPages * pageSize;
+  sample.committedBytes = dataPages * pageSize;
+  return sample;
+}
+#endif
+
+void ProcessMemoryHistory::Record(const ProcessMemorySample& sample) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (samples_.size() == CAPACITY) {
+    samples_.pop_front();
+  }
+  samples_.push_back(sample);
+}
+
+std::vector<ProcessMemorySample> ProcessMemoryHistory::GetSamples() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return std::vector<ProcessMemorySample>(samples_.begin(), samples_.end());
+}
+
+ProcessMemoryHistory& GetProcessMemoryHistory() {
+  static ProcessMemoryHistory history;
+  return history;
+}
+
+ProcessMemorySampler::ProcessMemorySampler(std::chrono::milliseconds interval,
+                                           ProcessMemoryHistory& history) :
+    interval_(interval), history_(history), stop_(false) {
+  thread_ = std::thread([this]() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    do {
+      lock.unlock();
+      sample();
+      lock.lock();
+    } while (!stopCondition_.wait_for(lock, interval_, [this]() {
+      return stop_;
+    }));
+  });
+}
+
+ProcessMemorySampler::~ProcessMemorySampler() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  stopCondition_.notify_all();
+  thread_.join();
+}
+
+void ProcessMemorySampler::sample() {
+  auto logger = getLogger();
+
+  const auto sample = SampleProcessMemory();
+  if (!sample.has_value()) {
+    if (logger) {
+      logger->debug("Unable to read the process' memory usage.");
+    }
+    return;
+  }
+
+  history_.Record(sample.value());
+
+  if (logger) {
+    logger->debug(
+        "Process memory usage: {} bytes resident, {} bytes committed.",
+        sample.value().residentBytes,
+        sample.value().committedBytes);
+  }
+}
+}
+
+// Replace the global allocation functions so that allocations can be
+// accounted for. Over-aligned allocations use the default allocation
+// functions and aren't accounted for.
+void* operator new(std::size_t size) { return loot::allocate(size); }
+
+void* operator new[](std::size_t size) { return loot::allocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return loot::allocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return loot::allocateNoThrow(size);
+}
+
+void operator delete(void* pointer) noexcept { loot::deallocate(pointer); }
+
+void operator delete[](void* pointer) noexcept { loot::deallocate(pointer); }
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  loot::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  loot::deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  loot::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  loot::deallocate(pointer);
+}
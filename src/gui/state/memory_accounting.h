@@ -0,0 +1,135 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_MEMORY_ACCOUNTING
+#define LOOT_GUI_STATE_MEMORY_ACCOUNTING
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace loot {
+struct AllocationCounts {
+  std::uint64_t count = 0;
+  std::uint64_t bytes = 0;
+  // The most bytes that were allocated and not yet freed at any one time.
+  std::uint64_t peakBytes = 0;
+};
+
+// Allocation accounting counts the allocations that are made through
+// operator new on each thread. It's off by default, as it adds a little
+// overhead to every allocation and deallocation.
+void SetAllocationAccountingEnabled(bool enabled);
+bool IsAllocationAccountingEnabled();
+
+/**
+ * @brief Counts the allocations made by the current thread between its
+ *        construction and destruction.
+ * @details Counters can be nested. Allocations made by other threads, e.g.
+ *          worker threads that a scope waits on, are not counted, and memory
+ *          that is freed by a different thread to the one that allocated it
+ *          lowers the peak of the thread that frees it. Counts are only
+ *          non-zero while allocation accounting is enabled.
+ */
+class ScopedAllocationCounter {
+public:
+  ScopedAllocationCounter();
+  ~ScopedAllocationCounter();
+
+  ScopedAllocationCounter(const ScopedAllocationCounter&) = delete;
+  ScopedAllocationCounter& operator=(const ScopedAllocationCounter&) = delete;
+
+  // Get the counts since construction.
+  AllocationCounts GetCounts() const;
+
+private:
+  const std::uint64_t startCount_;
+  const std::uint64_t startBytes_;
+  const std::int64_t startLiveBytes_;
+  const std::int64_t outerPeakLiveBytes_;
+};
+
+struct ProcessMemorySample {
+  std::chrono::system_clock::time_point time;
+  // The process' working set on Windows, or its resident set on Linux.
+  std::uint64_t residentBytes = 0;
+  // The process' private committed memory on Windows, or its data and stack
+  // size on Linux.
+  std::uint64_t committedBytes = 0;
+};
+
+// Returns nullopt if the process' memory usage can't be read.
+std::optional<ProcessMemorySample> SampleProcessMemory();
+
+/**
+ * @brief Holds the most recent process memory samples, oldest first.
+ */
+class ProcessMemoryHistory {
+public:
+  static constexpr size_t CAPACITY = 240;
+
+  void Record(const ProcessMemorySample& sample);
+  std::vector<ProcessMemorySample> GetSamples() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::deque<ProcessMemorySample> samples_;
+};
+
+ProcessMemoryHistory& GetProcessMemoryHistory();
+
+/**
+ * @brief Samples the process' memory usage on its own thread at a fixed
+ *        interval, recording each sample and writing it to the debug log.
+ */
+class ProcessMemorySampler {
+public:
+  explicit ProcessMemorySampler(
+      std::chrono::milliseconds interval,
+      ProcessMemoryHistory& history = GetProcessMemoryHistory());
+  ~ProcessMemorySampler();
+
+  ProcessMemorySampler(const ProcessMemorySampler&) = delete;
+  ProcessMemorySampler& operator=(const ProcessMemorySampler&) = delete;
+
+private:
+  void sample();
+
+  const std::chrono::milliseconds interval_;
+  ProcessMemoryHistory& history_;
+
+  std::mutex mutex_;
+  std::condition_variable stopCondition_;
+  bool stop_;
+  std::thread thread_;
+};
+}
+
+#endif
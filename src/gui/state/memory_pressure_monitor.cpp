@@ -0,0 +1,229 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/memory_pressure_monitor.h"
+
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include "gui/state/logging.h"
+
+namespace loot {
+#ifndef _WIN32
+namespace {
+// Trigger when some tasks are stalled waiting for memory for at least 150 ms
+// in a 2 second window. Unprivileged processes can only use windows that are
+// multiples of 2 seconds.
+constexpr const char PRESSURE_TRIGGER[] = "some 150000 2000000";
+}
+#endif
+
+MemoryPressureMonitor::MemoryPressureMonitor(
+    std::chrono::milliseconds minInterval,
+    Callback callback) :
+    minInterval_(minInterval), callback_(callback) {
+#ifdef _WIN32
+  stopEvent_ = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+  if (stopEvent_ == nullptr) {
+    throw std::system_error(
+        GetLastError(),
+        std::system_category(),
+        "Failed to create the memory pressure monitor's stop event");
+  }
+#else
+  if (pipe2(stopPipe_, O_CLOEXEC) != 0) {
+    throw std::system_error(
+        errno,
+        std::generic_category(),
+        "Failed to create the memory pressure monitor's stop pipe");
+  }
+#endif
+
+  std::promise<void> monitoring;
+  thread_ = std::thread(
+      &MemoryPressureMonitor::monitor, this, std::ref(monitoring));
+  monitoring.get_future().wait();
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor() {
+#ifdef _WIN32
+  SetEvent(stopEvent_);
+#else
+  const char stop = 0;
+  while (write(stopPipe_[1], &stop, 1) < 0 && errno == EINTR) {
+  }
+#endif
+
+  thread_.join();
+
+#ifdef _WIN32
+  CloseHandle(stopEvent_);
+#else
+  close(stopPipe_[0]);
+  close(stopPipe_[1]);
+#endif
+}
+
+void MemoryPressureMonitor::notify() {
+  auto logger = getLogger();
+  if (logger) {
+    logger->info("The system is low on memory.");
+  }
+
+  try {
+    callback_();
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error("Failed to handle low memory: {}", e.what());
+    }
+  }
+}
+
+#ifdef _WIN32
+void MemoryPressureMonitor::monitor(std::promise<void>& monitoring) {
+  HANDLE notification =
+      CreateMemoryResourceNotification(LowMemoryResourceNotification);
+  monitoring.set_value();
+  if (notification == nullptr) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn("Unable to monitor memory pressure, error code: {}",
+                   GetLastError());
+    }
+    return;
+  }
+
+  HANDLE waitHandles[] = {stopEvent_, notification};
+  while (true) {
+    auto result = WaitForMultipleObjects(2, waitHandles, FALSE, INFINITE);
+    if (result != WAIT_OBJECT_0 + 1) {
+      break;
+    }
+
+    notify();
+
+    // The notification stays signalled for as long as memory is low.
+    if (!waitForMinInterval()) {
+      break;
+    }
+  }
+
+  CloseHandle(notification);
+}
+
+bool MemoryPressureMonitor::waitForMinInterval() {
+  return WaitForSingleObject(stopEvent_,
+                             static_cast<DWORD>(minInterval_.count())) ==
+         WAIT_TIMEOUT;
+}
+#else
+void MemoryPressureMonitor::monitor(std::promise<void>& monitoring) {
+  auto logger = getLogger();
+
+  int pressureFd =
+      open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (pressureFd < 0 ||
+      write(pressureFd, PRESSURE_TRIGGER, sizeof(PRESSURE_TRIGGER)) < 0) {
+    if (logger) {
+      logger->warn("Unable to monitor memory pressure: {}",
+                   std::strerror(errno));
+    }
+    if (pressureFd >= 0) {
+      close(pressureFd);
+    }
+    monitoring.set_value();
+    return;
+  }
+  monitoring.set_value();
+
+  while (true) {
+    pollfd fds[] = {{stopPipe_[0], POLLIN, 0}, {pressureFd, POLLPRI, 0}};
+    int result = poll(fds, 2, -1);
+
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (logger) {
+        logger->warn("Stopped monitoring memory pressure: {}",
+                     std::strerror(errno));
+      }
+      break;
+    }
+
+    if (fds[0].revents != 0) {
+      break;
+    }
+
+    // POLLERR means that the trigger has been removed.
+    if ((fds[1].revents & POLLERR) != 0) {
+      if (logger) {
+        logger->warn("Stopped monitoring memory pressure.");
+      }
+      break;
+    }
+
+    if ((fds[1].revents & POLLPRI) != 0) {
+      notify();
+
+      if (!waitForMinInterval()) {
+        break;
+      }
+    }
+  }
+
+  close(pressureFd);
+}
+
+bool MemoryPressureMonitor::waitForMinInterval() {
+  pollfd fds[] = {{stopPipe_[0], POLLIN, 0}};
+  int result;
+  while ((result = poll(fds, 1, static_cast<int>(minInterval_.count()))) < 0 &&
+         errno == EINTR) {
+  }
+
+  return result == 0;
+}
+#endif
+}
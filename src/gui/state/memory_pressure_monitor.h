@@ -0,0 +1,78 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_MEMORY_PRESSURE_MONITOR
+#define LOOT_GUI_STATE_MEMORY_PRESSURE_MONITOR
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <thread>
+
+namespace loot {
+/**
+ * @brief Calls a callback when the OS reports that the system is low on
+ *        memory.
+ * @details On Windows this uses a low memory resource notification, and on
+ *          Linux a memory pressure stall trigger, which needs a kernel with
+ *          pressure stall information enabled. If neither is available, the
+ *          callback is never called. The callback is called on the monitor's
+ *          own thread, and not again until the minimum interval has passed,
+ *          as low memory can last for some time.
+ */
+class MemoryPressureMonitor {
+public:
+  typedef std::function<void()> Callback;
+
+  MemoryPressureMonitor(std::chrono::milliseconds minInterval,
+                        Callback callback);
+  ~MemoryPressureMonitor();
+
+  MemoryPressureMonitor(const MemoryPressureMonitor&) = delete;
+  MemoryPressureMonitor& operator=(const MemoryPressureMonitor&) = delete;
+
+private:
+  // The promise is fulfilled once memory pressure is being monitored.
+  void monitor(std::promise<void>& monitoring);
+  // Returns false if monitoring should stop.
+  bool waitForMinInterval();
+  void notify();
+
+  const std::chrono::milliseconds minInterval_;
+  const Callback callback_;
+
+#ifdef _WIN32
+  // A HANDLE to an event that is signalled to stop monitoring.
+  void* stopEvent_;
+#else
+  // Writing to the pipe stops monitoring.
+  int stopPipe_[2];
+#endif
+
+  std::thread thread_;
+};
+}
+
+#endif
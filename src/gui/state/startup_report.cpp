@@ -0,0 +1,165 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/startup_report.h"
+
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "gui/state/logging.h"
+#include "gui/version.h"
+
+#undef min
+#include <json.hpp>
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace loot {
+namespace {
+// Static initialisation happens before main() is called, so this is as
+// close to the process' start as can be measured portably.
+const steady_clock::time_point PROCESS_START = steady_clock::now();
+
+std::string getCurrentUtcTime() {
+  const auto now = std::time(nullptr);
+  std::tm time;
+#ifdef _WIN32
+  gmtime_s(&time, &now);
+#else
+  gmtime_r(&now, &time);
+#endif
+
+  std::ostringstream stream;
+  stream << std::put_time(&time, "%Y-%m-%dT%H:%M:%SZ");
+  return stream.str();
+}
+}
+
+StartupReport::StartupReport(steady_clock::time_point processStart) :
+    processStart_(processStart), isWritten_(false) {}
+
+bool StartupReport::RecordMilestone(const std::string& name,
+                                    steady_clock::time_point time) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  // Milestones reached after the report was written aren't part of startup.
+  if (isWritten_) {
+    return false;
+  }
+
+  for (const auto& milestone : milestones_) {
+    if (milestone.name == name) {
+      return false;
+    }
+  }
+
+  milestones_.push_back(StartupMilestone{
+      name, duration_cast<microseconds>(time - processStart_).count()});
+
+  return true;
+}
+
+std::vector<StartupMilestone> StartupReport::GetMilestones() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  return milestones_;
+}
+
+bool StartupReport::Write(const std::filesystem::path& historyPath,
+                          size_t maxEntries) {
+  std::vector<StartupMilestone> milestones;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (isWritten_) {
+      return false;
+    }
+    isWritten_ = true;
+    milestones = milestones_;
+  }
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->info("Startup report, in milliseconds since the process started:");
+    for (const auto& milestone : milestones) {
+      logger->info(
+          "  {}: {:.1f}", milestone.name, milestone.microseconds / 1000.0);
+    }
+  }
+
+  nlohmann::json entry = {
+      {"time", getCurrentUtcTime()},
+      {"version", gui::Version::string()},
+      {"revision", gui::Version::revision},
+      {"milestones", nlohmann::json::array()},
+  };
+  for (const auto& milestone : milestones) {
+    entry["milestones"].push_back({
+        {"name", milestone.name},
+        {"microseconds", milestone.microseconds},
+    });
+  }
+
+  // The history has one startup per line, oldest first.
+  std::vector<std::string> lines;
+  {
+    std::ifstream in(historyPath);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (!line.empty()) {
+        lines.push_back(line);
+      }
+    }
+  }
+  lines.push_back(entry.dump());
+
+  const auto firstLine =
+      lines.size() > maxEntries ? lines.end() - maxEntries : lines.begin();
+
+  std::ofstream out(historyPath);
+  for (auto it = firstLine; it != lines.end(); ++it) {
+    out << *it << '\n';
+  }
+
+  if (!out && logger) {
+    logger->error("Failed to write the startup history to \"{}\"",
+                  historyPath.u8string());
+  }
+
+  return true;
+}
+
+StartupReport& GetStartupReport() {
+  static StartupReport report(PROCESS_START);
+  return report;
+}
+
+void RecordStartupMilestone(const std::string& name) {
+  GetStartupReport().RecordMilestone(name);
+}
+}
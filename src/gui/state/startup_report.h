@@ -0,0 +1,82 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_STARTUP_REPORT
+#define LOOT_GUI_STATE_STARTUP_REPORT
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace loot {
+struct StartupMilestone {
+  std::string name;
+  // Relative to when the report's process started.
+  std::int64_t microseconds;
+};
+
+/**
+ * @brief Records when each of the milestones on the way to LOOT becoming
+ *        interactive are first reached, so that slow startups can be broken
+ *        down and compared between releases and machines.
+ */
+class StartupReport {
+public:
+  static constexpr size_t DEFAULT_HISTORY_SIZE = 50;
+
+  explicit StartupReport(std::chrono::steady_clock::time_point processStart);
+
+  // Record that the named milestone has been reached, unless it has already
+  // been recorded, as only the first time is part of startup. Returns true if
+  // the milestone was recorded.
+  bool RecordMilestone(const std::string& name,
+                       std::chrono::steady_clock::time_point time =
+                           std::chrono::steady_clock::now());
+
+  // Get the recorded milestones in the order they were reached.
+  std::vector<StartupMilestone> GetMilestones() const;
+
+  // Write the milestones to the log and append them to the history file,
+  // which only keeps the maxEntries most recent startups. A report is only
+  // written once, and later calls return false without doing anything.
+  bool Write(const std::filesystem::path& historyPath,
+             size_t maxEntries = DEFAULT_HISTORY_SIZE);
+
+private:
+  mutable std::mutex mutex_;
+  const std::chrono::steady_clock::time_point processStart_;
+  std::vector<StartupMilestone> milestones_;
+  bool isWritten_;
+};
+
+StartupReport& GetStartupReport();
+
+void RecordStartupMilestone(const std::string& name);
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/timing.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace loot {
+TimingRecorder::TimingRecorder() :
+    epoch_(steady_clock::now()), nextIndex_(0), firstIndex_(0) {}
+
+void TimingRecorder::Record(const char* name,
+                            steady_clock::time_point start,
+                            steady_clock::time_point end,
+                            const AllocationCounts& allocations) {
+  const auto index = nextIndex_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = slots_[index % CAPACITY];
+
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.startMicroseconds.store(
+      duration_cast<microseconds>(start - epoch_).count(),
+      std::memory_order_relaxed);
+  slot.durationMicroseconds.store(
+      duration_cast<microseconds>(end - start).count(),
+      std::memory_order_relaxed);
+  slot.threadId.store(
+      static_cast<std::uint32_t>(
+          std::hash<std::thread::id>()(std::this_thread::get_id())),
+      std::memory_order_relaxed);
+  slot.allocationCount.store(allocations.count, std::memory_order_relaxed);
+  slot.allocatedBytes.store(allocations.bytes, std::memory_order_relaxed);
+  slot.peakBytes.store(allocations.peakBytes, std::memory_order_relaxed);
+
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+std::vector<TimingEvent> TimingRecorder::GetEvents() const {
+  const auto end = nextIndex_.load(std::memory_order_acquire);
+  auto begin = firstIndex_.load(std::memory_order_acquire);
+  if (end - begin > CAPACITY) {
+    begin = end - CAPACITY;
+  }
+
+  std::vector<TimingEvent> events;
+  events.reserve(end - begin);
+  for (auto index = begin; index < end; ++index) {
+    const auto& slot = slots_[index % CAPACITY];
+
+    const auto sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != index + 1) {
+      continue;
+    }
+
+    TimingEvent event;
+    event.name = slot.name.load(std::memory_order_relaxed);
+    event.startMicroseconds =
+        slot.startMicroseconds.load(std::memory_order_relaxed);
+    event.durationMicroseconds =
+        slot.durationMicroseconds.load(std::memory_order_relaxed);
+    event.threadId = slot.threadId.load(std::memory_order_relaxed);
+    event.allocations.count =
+        slot.allocationCount.load(std::memory_order_relaxed);
+    event.allocations.bytes =
+        slot.allocatedBytes.load(std::memory_order_relaxed);
+    event.allocations.peakBytes =
+        slot.peakBytes.load(std::memory_order_relaxed);
+
+    // If the slot was overwritten while being read, discard what was read.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+      events.push_back(event);
+    }
+  }
+
+  return events;
+}
+
+void TimingRecorder::Clear() {
+  firstIndex_.store(nextIndex_.load(std::memory_order_acquire),
+                    std::memory_order_release);
+}
+
+TimingRecorder& GetTimingRecorder() {
+  static TimingRecorder recorder;
+  return recorder;
+}
+
+const char* InternOperationName(const std::string& name) {
+  static std::mutex mutex;
+  static std::unordered_set<std::string> names;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  return names.insert(name).first->c_str();
+}
+
+std::vector<OperationTimings> SummariseTimings(
+    const std::vector<TimingEvent>& events) {
+  std::map<std::string, OperationTimings> timingsMap;
+  for (const auto& event : events) {
+    auto& timings = timingsMap[event.name];
+    if (timings.count == 0) {
+      timings.name = event.name;
+    }
+    timings.count += 1;
+    timings.totalMicroseconds += event.durationMicroseconds;
+    timings.maxMicroseconds =
+        std::max(timings.maxMicroseconds, event.durationMicroseconds);
+    timings.allocationCount += event.allocations.count;
+    timings.allocatedBytes += event.allocations.bytes;
+    timings.maxPeakBytes =
+        std::max(timings.maxPeakBytes, event.allocations.peakBytes);
+  }
+
+  std::vector<OperationTimings> timings;
+  timings.reserve(timingsMap.size());
+  for (auto& entry : timingsMap) {
+    timings.push_back(std::move(entry.second));
+  }
+
+  return timings;
+}
+
+ScopedTimer::ScopedTimer(const char* name, TimingRecorder& recorder) :
+    name_(name), recorder_(recorder), start_(steady_clock::now()) {
+  if (IsAllocationAccountingEnabled()) {
+    allocationCounter_.emplace();
+  }
+}
+
+ScopedTimer::~ScopedTimer() {
+  const auto end = steady_clock::now();
+  if (allocationCounter_.has_value()) {
+    recorder_.Record(name_, start_, end, allocationCounter_->GetCounts());
+  } else {
+    recorder_.Record(name_, start_, end);
+  }
+}
+}
@@ -0,0 +1,138 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_TIMING
+#define LOOT_GUI_STATE_TIMING
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gui/state/memory_accounting.h"
+
+namespace loot {
+struct TimingEvent {
+  const char* name;
+  // Relative to when the recorder was created.
+  std::int64_t startMicroseconds;
+  std::int64_t durationMicroseconds;
+  std::uint32_t threadId;
+  // All zero unless allocation accounting was enabled.
+  AllocationCounts allocations;
+};
+
+struct OperationTimings {
+  std::string name;
+  size_t count = 0;
+  std::int64_t totalMicroseconds = 0;
+  std::int64_t maxMicroseconds = 0;
+  std::uint64_t allocationCount = 0;
+  std::uint64_t allocatedBytes = 0;
+  std::uint64_t maxPeakBytes = 0;
+};
+
+/**
+ * @brief Records the durations of operations in a fixed-size ring buffer,
+ *        overwriting the oldest events once it is full.
+ * @details Recording an event doesn't take a lock, so it can be done from
+ *          any thread and in hot code paths.
+ */
+class TimingRecorder {
+public:
+  static constexpr size_t CAPACITY = 4096;
+
+  TimingRecorder();
+
+  // The name must outlive the recorder, e.g. a string literal or a name
+  // returned by InternOperationName().
+  void Record(const char* name,
+              std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point end,
+              const AllocationCounts& allocations = AllocationCounts());
+
+  // Get the recorded events that haven't been overwritten, oldest first.
+  // Events that are being written while this is called are skipped.
+  std::vector<TimingEvent> GetEvents() const;
+
+  void Clear();
+
+private:
+  struct Slot {
+    // 0 while the slot is being written, otherwise one more than the index
+    // of the event that it holds.
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::int64_t> startMicroseconds{0};
+    std::atomic<std::int64_t> durationMicroseconds{0};
+    std::atomic<std::uint32_t> threadId{0};
+    std::atomic<std::uint64_t> allocationCount{0};
+    std::atomic<std::uint64_t> allocatedBytes{0};
+    std::atomic<std::uint64_t> peakBytes{0};
+  };
+
+  const std::chrono::steady_clock::time_point epoch_;
+  std::atomic<std::uint64_t> nextIndex_;
+  std::atomic<std::uint64_t> firstIndex_;
+  std::array<Slot, CAPACITY> slots_;
+};
+
+TimingRecorder& GetTimingRecorder();
+
+// Get a pointer to a copy of the given name that lives until the program
+// exits, so that it can be recorded.
+const char* InternOperationName(const std::string& name);
+
+// Get the count, total and maximum duration for each operation name, and the
+// total allocations and maximum peak allocated bytes.
+std::vector<OperationTimings> SummariseTimings(
+    const std::vector<TimingEvent>& events);
+
+/**
+ * @brief Records the time between its construction and destruction, and the
+ *        allocations made by the current thread in that time if allocation
+ *        accounting was enabled on construction.
+ */
+class ScopedTimer {
+public:
+  explicit ScopedTimer(const char* name,
+                       TimingRecorder& recorder = GetTimingRecorder());
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  const char* name_;
+  TimingRecorder& recorder_;
+  const std::chrono::steady_clock::time_point start_;
+  std::optional<ScopedAllocationCounter> allocationCounter_;
+};
+}
+
+#endif
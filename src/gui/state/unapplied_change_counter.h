@@ -26,27 +26,30 @@
 #ifndef LOOT_GUI_STATE_UNAPPLIED_CHANGE_COUNTER
 #define LOOT_GUI_STATE_UNAPPLIED_CHANGE_COUNTER
 
+#include <atomic>
+
 namespace loot {
+// Queries that change the counter can run concurrently on the query worker
+// pool, so it's atomic.
 class UnappliedChangeCounter {
 public:
   UnappliedChangeCounter() : unappliedChangeCounter_(0) {}
 
   bool HasUnappliedChanges() const {
-    return unappliedChangeCounter_ > 0;
+    return unappliedChangeCounter_.load() > 0;
   }
 
-  void IncrementUnappliedChangeCounter() {
-    ++unappliedChangeCounter_;
-  }
+  void IncrementUnappliedChangeCounter() { ++unappliedChangeCounter_; }
 
-  void DecrementUnappliedChangeCounter()  {
-    if (unappliedChangeCounter_ > 0) {
-      --unappliedChangeCounter_;
+  void DecrementUnappliedChangeCounter() {
+    auto count = unappliedChangeCounter_.load();
+    while (count > 0 &&
+           !unappliedChangeCounter_.compare_exchange_weak(count, count - 1)) {
     }
   }
 
 private:
-  size_t unappliedChangeCounter_;
+  std::atomic<size_t> unappliedChangeCounter_;
 };
 }
 
@@ -37,6 +37,7 @@ along with LOOT.  If not, see
 #include <boost/uuid/uuid_io.hpp>
 
 #include "loot/enum/game_type.h"
+#include "tests/synthetic_plugins.h"
 
 namespace loot {
 namespace test {
@@ -202,6 +203,24 @@ protected:
     return actual;
   }
 
+  // Create plugins in the data path as described by the given options, and
+  // append them to the initial load order. Returns the plugins' filenames in
+  // load order.
+  std::vector<std::string> createSyntheticPlugins(
+      const SyntheticPluginOptions& options) {
+    auto loadOrder = getInitialLoadOrder();
+    std::vector<std::string> plugins;
+    for (const auto& plugin : loot::test::createSyntheticPlugins(
+             GetParam(), dataPath, masterFile, options)) {
+      plugins.push_back(plugin.first);
+      loadOrder.push_back(plugin);
+    }
+
+    setLoadOrder(loadOrder);
+
+    return plugins;
+  }
+
   inline std::vector<std::pair<std::string, bool>> getInitialLoadOrder() const {
     return std::vector<std::pair<std::string, bool>>({
         {masterFile, true},
@@ -0,0 +1,134 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_BATCH_SORT_TEST
+#define LOOT_TESTS_GUI_BATCH_SORT_TEST
+
+#include "gui/batch_sort.h"
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace test {
+TEST(ParseSortJobs, shouldReadTheGameAndOptionalPathsOfEachJob) {
+  auto json = nlohmann::json::parse(R"([
+    {"game": "Skyrim"},
+    {"game": "Oblivion", "gamePath": "game", "gameLocalPath": "local"}
+  ])");
+
+  auto jobs = ParseSortJobs(json);
+
+  ASSERT_EQ(2, jobs.size());
+  EXPECT_EQ("Skyrim", jobs[0].gameFolder);
+  EXPECT_TRUE(jobs[0].gamePath.empty());
+  EXPECT_TRUE(jobs[0].gameLocalPath.empty());
+  EXPECT_EQ("Oblivion", jobs[1].gameFolder);
+  EXPECT_EQ(std::filesystem::u8path("game"), jobs[1].gamePath);
+  EXPECT_EQ(std::filesystem::u8path("local"), jobs[1].gameLocalPath);
+}
+
+TEST(ParseSortJobs, shouldThrowIfAJobHasNoGame) {
+  auto json = nlohmann::json::parse(R"([{"gamePath": "game"}])");
+
+  EXPECT_ANY_THROW(ParseSortJobs(json));
+}
+
+TEST(ReadSortJobs, shouldThrowIfTheFileDoesNotExist) {
+  EXPECT_THROW(ReadSortJobs("missing.json"), std::runtime_error);
+}
+
+class BatchSortTest : public CommonGameTestFixture {
+protected:
+  BatchSortTest() :
+      gameSettings_(GameSettings(GetParam(), "folder")
+                        .SetMinimumHeaderVersion(0.0f)
+                        .SetGamePath(dataPath.parent_path())
+                        .SetGameLocalPath(localPath)) {}
+
+  SortJob job_() const {
+    SortJob job;
+    job.gameFolder = gameSettings_.FolderName();
+    return job;
+  }
+
+  const GameSettings gameSettings_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        BatchSortTest,
+                        ::testing::Values(GameType::tes4, GameType::tes5se));
+
+TEST_P(BatchSortTest, resolveSortJobShouldThrowIfTheGameIsUnknown) {
+  SortJob job;
+  job.gameFolder = "unknown";
+
+  EXPECT_THROW(ResolveSortJob(job, {gameSettings_}), std::invalid_argument);
+}
+
+TEST_P(BatchSortTest, resolveSortJobShouldApplyTheJobPaths) {
+  auto job = job_();
+  job.gamePath = dataPath;
+  job.gameLocalPath = dataPath;
+
+  auto settings = ResolveSortJob(job, {gameSettings_});
+
+  EXPECT_EQ(dataPath, settings.GamePath());
+  EXPECT_EQ(dataPath, settings.GameLocalPath());
+}
+
+TEST_P(BatchSortTest, resolveSortJobShouldKeepConfiguredPathsIfNoneAreGiven) {
+  auto settings = ResolveSortJob(job_(), {gameSettings_});
+
+  EXPECT_EQ(gameSettings_.GamePath(), settings.GamePath());
+  EXPECT_EQ(gameSettings_.GameLocalPath(), settings.GameLocalPath());
+}
+
+TEST_P(BatchSortTest, sortGameShouldNotChangeTheLoadOrderIfNotApplying) {
+  gui::Game game(gameSettings_, lootDataPath);
+  auto initialLoadOrder = getLoadOrder();
+
+  auto result = SortGame(game, false, false, "en");
+
+  EXPECT_EQ(0, result.count("error"));
+  EXPECT_EQ(initialLoadOrder.size(), result.at("loadOrder").size());
+  EXPECT_FALSE(result.at("applied").get<bool>());
+  EXPECT_EQ(initialLoadOrder, getLoadOrder());
+}
+
+TEST_P(BatchSortTest, sortGameShouldSetTheSortedLoadOrderIfApplying) {
+  gui::Game game(gameSettings_, lootDataPath);
+
+  auto result = SortGame(game, true, false, "en");
+
+  EXPECT_EQ(result.at("changed"), result.at("applied"));
+  EXPECT_EQ(result.at("loadOrder").get<std::vector<std::string>>(),
+            game.GetLoadOrder());
+}
+}
+}
+
+#endif
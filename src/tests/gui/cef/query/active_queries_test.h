@@ -0,0 +1,95 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_ACTIVE_QUERIES_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_ACTIVE_QUERIES_TEST
+
+#include "gui/cef/query/active_queries.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class ActiveQueriesTest : public ::testing::Test {
+protected:
+  ActiveQueriesTest() :
+      token_(std::make_shared<CancellationToken>()),
+      otherToken_(std::make_shared<CancellationToken>()) {}
+
+  // The browser-side query IDs that CEF gives queries are unrelated to the
+  // cancellation IDs that the UI sends with them.
+  static constexpr int64_t QUERY_ID = 7;
+  static constexpr int64_t OTHER_QUERY_ID = 8;
+  static constexpr int64_t CANCELLATION_ID = 0;
+  static constexpr int64_t OTHER_CANCELLATION_ID = 1;
+
+  ActiveQueries activeQueries_;
+  std::shared_ptr<CancellationToken> token_;
+  std::shared_ptr<CancellationToken> otherToken_;
+};
+
+TEST_F(ActiveQueriesTest,
+       cancelByCancellationIdShouldCancelTheQuerySentWithThatId) {
+  activeQueries_.add(QUERY_ID, CANCELLATION_ID, token_);
+  activeQueries_.add(OTHER_QUERY_ID, OTHER_CANCELLATION_ID, otherToken_);
+
+  EXPECT_TRUE(activeQueries_.cancelByCancellationId(CANCELLATION_ID));
+
+  EXPECT_TRUE(token_->isCancelled());
+  EXPECT_FALSE(otherToken_->isCancelled());
+}
+
+TEST_F(ActiveQueriesTest,
+       cancelByCancellationIdShouldNotTreatTheIdAsAQueryId) {
+  activeQueries_.add(CANCELLATION_ID, std::nullopt, token_);
+  activeQueries_.add(QUERY_ID, OTHER_CANCELLATION_ID, otherToken_);
+
+  EXPECT_FALSE(activeQueries_.cancelByCancellationId(CANCELLATION_ID));
+
+  EXPECT_FALSE(token_->isCancelled());
+  EXPECT_FALSE(otherToken_->isCancelled());
+}
+
+TEST_F(ActiveQueriesTest, cancelShouldCancelTheQueryWithTheGivenQueryId) {
+  activeQueries_.add(QUERY_ID, CANCELLATION_ID, token_);
+
+  EXPECT_TRUE(activeQueries_.cancel(QUERY_ID));
+
+  EXPECT_TRUE(token_->isCancelled());
+  EXPECT_FALSE(activeQueries_.cancelByCancellationId(CANCELLATION_ID));
+}
+
+TEST_F(ActiveQueriesTest, cancelShouldReturnFalseForAQueryThatWasRemoved) {
+  activeQueries_.add(QUERY_ID, CANCELLATION_ID, token_);
+  activeQueries_.remove(QUERY_ID);
+
+  EXPECT_FALSE(activeQueries_.cancel(QUERY_ID));
+  EXPECT_FALSE(activeQueries_.cancelByCancellationId(CANCELLATION_ID));
+  EXPECT_FALSE(token_->isCancelled());
+}
+}
+}
+
+#endif
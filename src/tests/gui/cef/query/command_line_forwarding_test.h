@@ -0,0 +1,130 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_COMMAND_LINE_FORWARDING_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_COMMAND_LINE_FORWARDING_TEST
+
+#include "gui/cef/query/command_line_forwarding.h"
+
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class CommandLineForwardingTest : public ::testing::Test {
+protected:
+  CommandLineForwardingTest() :
+#ifdef _WIN32
+      endpointName_("LOOT-command-line-forwarding-test"),
+#else
+      endpointName_((std::filesystem::temp_directory_path() /
+                     "LOOT-command-line-forwarding-test.sock")
+                        .u8string()),
+#endif
+      autoSort_(false) {
+  }
+
+  // Run a server that handles forwarded command lines until the test ends.
+  void startServer() {
+    server_ = std::make_unique<QueryServer>(
+        endpointName_,
+        GetForwardedCommandLineRunner(
+            [this](const std::string& gameFolder, bool autoSort) {
+              if (gameFolder == "Unknown") {
+                throw std::runtime_error("Unknown game");
+              }
+              gameFolder_ = gameFolder;
+              autoSort_ = autoSort;
+              return nlohmann::json({{"game", gameFolder}});
+            }));
+    serverThread_ = std::thread([this]() { server_->Run(); });
+  }
+
+  void TearDown() override {
+    if (server_) {
+      server_->Stop();
+      serverThread_.join();
+    }
+  }
+
+  const std::string endpointName_;
+  std::unique_ptr<QueryServer> server_;
+  std::thread serverThread_;
+  std::string gameFolder_;
+  bool autoSort_;
+};
+
+TEST_F(CommandLineForwardingTest,
+       forwardCommandLineShouldThrowIfNoInstanceIsListening) {
+  EXPECT_THROW(ForwardCommandLine(endpointName_, "Oblivion", true),
+               std::system_error);
+}
+
+TEST_F(CommandLineForwardingTest,
+       forwardCommandLineShouldReturnTheResultOfHandlingTheCommandLine) {
+  startServer();
+
+  auto result = ForwardCommandLine(endpointName_, "Oblivion", true);
+
+  EXPECT_EQ("Oblivion", result.at("game"));
+  EXPECT_EQ("Oblivion", gameFolder_);
+  EXPECT_TRUE(autoSort_);
+}
+
+TEST_F(CommandLineForwardingTest,
+       forwardCommandLineShouldThrowIfHandlingTheCommandLineFails) {
+  startServer();
+
+  EXPECT_THROW(ForwardCommandLine(endpointName_, "Unknown", false),
+               std::runtime_error);
+  EXPECT_NO_THROW(ForwardCommandLine(endpointName_, "", false));
+  EXPECT_EQ("", gameFolder_);
+  EXPECT_FALSE(autoSort_);
+}
+
+TEST_F(CommandLineForwardingTest,
+       forwardedCommandLineRunnerShouldRejectOtherQueries) {
+  auto runner = GetForwardedCommandLineRunner(
+      [](const std::string&, bool) { return nlohmann::json::object(); });
+
+  EXPECT_THROW(runner({{"name", "getGameData"}}), std::invalid_argument);
+}
+
+TEST_F(CommandLineForwardingTest,
+       instanceEndpointNameShouldBeTheSameWithinAProcess) {
+  const auto name = GetInstanceEndpointName();
+
+  EXPECT_EQ(0u, name.find("LOOT.Shell.Instance"));
+  EXPECT_EQ(name, GetInstanceEndpointName());
+}
+}
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_DERIVATION_CONTEXT_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_DERIVATION_CONTEXT_TEST
+
+#include "gui/cef/query/derivation_context.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class DerivationContextTestPlugin : public PluginInterface {
+public:
+  DerivationContextTestPlugin(std::string name, bool isLightMaster) :
+      name_(name),
+      isLightMaster_(isLightMaster) {}
+
+  std::string GetName() const override { return name_; }
+
+  float GetHeaderVersion() const { return 0.0f; }
+
+  std::optional<std::string> GetVersion() const { return std::nullopt; }
+
+  std::vector<std::string> GetMasters() const { return {}; }
+
+  std::set<Tag> GetBashTags() const { return {}; }
+
+  std::optional<uint32_t> GetCRC() const { return std::nullopt; }
+
+  bool IsMaster() const { return false; }
+
+  bool IsLightMaster() const { return isLightMaster_; }
+
+  bool IsValidAsLightMaster() const { return false; }
+
+  bool IsEmpty() const { return false; }
+
+  bool LoadsArchive() const { return false; }
+
+  bool DoFormIDsOverlap(const PluginInterface& plugin) const { return false; }
+
+private:
+  const std::string name_;
+  const bool isLightMaster_;
+};
+
+class DerivationContextTestGame {
+public:
+  std::shared_ptr<const PluginInterface> GetPlugin(
+      const std::string& name) const {
+    if (name == "unloaded.esp") {
+      return nullptr;
+    }
+
+    return std::make_shared<DerivationContextTestPlugin>(
+        name, name.find(".esl") != std::string::npos);
+  }
+
+  bool IsPluginActive(const std::string& pluginName) const {
+    return pluginName != "inactive.esp";
+  }
+
+  std::optional<short> GetActiveLoadOrderIndex(
+      const std::shared_ptr<const PluginInterface>& plugin) const {
+    return 7;
+  }
+
+  std::shared_ptr<const gui::BashTagTable> GetBashTagTable() const {
+    return std::make_shared<gui::BashTagTable>(
+        std::set<std::string>({"C.Water"}));
+  }
+};
+
+TEST(DerivationContext,
+     shouldCountActiveLightMastersSeparatelyFromOtherActivePlugins) {
+  DerivationContextTestGame game;
+  DerivationContext context(
+      game, {"a.esm", "inactive.esp", "b.esl", "c.esp", "d.esl"}, "en");
+
+  EXPECT_EQ(0, context.getActiveLoadOrderIndex("a.esm"));
+  EXPECT_EQ(std::nullopt, context.getActiveLoadOrderIndex("inactive.esp"));
+  EXPECT_EQ(0, context.getActiveLoadOrderIndex("b.esl"));
+  EXPECT_EQ(1, context.getActiveLoadOrderIndex("c.esp"));
+  EXPECT_EQ(1, context.getActiveLoadOrderIndex("d.esl"));
+  EXPECT_EQ("en", context.getLanguage());
+}
+
+TEST(DerivationContext, shouldLookUpPluginsCaseInsensitively) {
+  DerivationContextTestGame game;
+  DerivationContext context(game, {"a.esm", "b.esp"}, "en");
+
+  EXPECT_TRUE(context.isActive("A.ESM"));
+  EXPECT_EQ(1, context.getActiveLoadOrderIndex("B.esp"));
+}
+
+TEST(DerivationContext,
+     activePluginsThatAreNotLoadedShouldBeActiveWithoutAnIndex) {
+  DerivationContextTestGame game;
+  DerivationContext context(
+      game, {"a.esm", "unloaded.esp", "inactive.esp", "b.esp"}, "en");
+
+  EXPECT_TRUE(context.isActive("unloaded.esp"));
+  EXPECT_EQ(std::nullopt, context.getActiveLoadOrderIndex("unloaded.esp"));
+  EXPECT_FALSE(context.isActive("inactive.esp"));
+  EXPECT_FALSE(context.isActive("missing.esp"));
+  EXPECT_EQ(1, context.getActiveLoadOrderIndex("b.esp"));
+}
+
+TEST(DerivationContext, forPluginShouldOnlyHoldTheGivenPlugin) {
+  DerivationContextTestGame game;
+  auto plugin = game.GetPlugin("a.esm");
+  auto context = DerivationContext::forPlugin(game, plugin, "fr");
+
+  EXPECT_TRUE(context.isActive("a.esm"));
+  EXPECT_EQ(7, context.getActiveLoadOrderIndex("a.esm"));
+  EXPECT_FALSE(context.isActive("b.esp"));
+  EXPECT_EQ("fr", context.getLanguage());
+}
+
+TEST(DerivationContext, shouldHoldATableOfTheGamesKnownBashTags) {
+  DerivationContextTestGame game;
+  DerivationContext context(game, {"a.esm"}, "en");
+  auto plugin = game.GetPlugin("a.esm");
+  auto pluginContext = DerivationContext::forPlugin(game, plugin, "en");
+
+  EXPECT_EQ(0, context.getBashTagTable()->GetId("C.Water"));
+  EXPECT_EQ(0, pluginContext.getBashTagTable()->GetId("C.Water"));
+}
+}
+}
+
+#endif
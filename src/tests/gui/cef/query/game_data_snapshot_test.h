@@ -0,0 +1,152 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_GAME_DATA_SNAPSHOT_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_GAME_DATA_SNAPSHOT_TEST
+
+#include "gui/cef/query/game_data_snapshot.h"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+class GameDataSnapshotTest : public ::testing::Test {
+protected:
+  GameDataSnapshotTest() : snapshotPath_(getTempPath()) {}
+
+  void SetUp() override { std::filesystem::remove(snapshotPath_); }
+
+  void TearDown() override {
+    std::filesystem::remove(snapshotPath_);
+    std::filesystem::remove(snapshotPath_.u8string() + ".tmp");
+  }
+
+  static gui::PluginFingerprint fingerprint(std::uintmax_t fileSize) {
+    gui::PluginFingerprint fingerprint;
+    fingerprint.fileSize = fileSize;
+    fingerprint.modificationTime = std::filesystem::file_time_type(
+        std::filesystem::file_time_type::duration(fileSize * 10));
+    return fingerprint;
+  }
+
+  const std::filesystem::path snapshotPath_;
+};
+
+TEST_F(GameDataSnapshotTest, loadShouldLeaveTheSnapshotEmptyIfTheFileIsMissing) {
+  GameDataSnapshot snapshot("key", {}, "{}");
+
+  snapshot.Load(snapshotPath_);
+
+  EXPECT_TRUE(snapshot.IsEmpty());
+}
+
+TEST_F(GameDataSnapshotTest, loadShouldLeaveTheSnapshotEmptyIfTheFileIsInvalid) {
+  std::ofstream(snapshotPath_) << "This isn't a snapshot.";
+  GameDataSnapshot snapshot;
+
+  snapshot.Load(snapshotPath_);
+
+  EXPECT_TRUE(snapshot.IsEmpty());
+}
+
+TEST_F(GameDataSnapshotTest, loadShouldReadWhatSaveWrote) {
+  auto crcFingerprint = fingerprint(2);
+  crcFingerprint.crc = 0xDEADBEEF;
+  crcFingerprint.isActive = true;
+  GameDataSnapshot saved("key",
+                         {{"a.esp", fingerprint(1)}, {"b.esp", crcFingerprint}},
+                         R"({"plugins":[]})");
+  saved.Save(snapshotPath_);
+
+  GameDataSnapshot loaded;
+  loaded.Load(snapshotPath_);
+
+  EXPECT_EQ("key", loaded.GetMetadataKey());
+  EXPECT_EQ(saved.GetPluginFingerprints(), loaded.GetPluginFingerprints());
+  EXPECT_EQ(R"({"plugins":[]})", loaded.GetResponse());
+}
+
+TEST_F(GameDataSnapshotTest, provisionalResponseShouldAddAProvisionalField) {
+  GameDataSnapshot snapshot("", {}, R"({"folder":"Skyrim","plugins":[]})");
+  GameDataSnapshot emptyObjectSnapshot("", {}, "{ }");
+
+  auto json = nlohmann::json::parse(snapshot.GetProvisionalResponse());
+  auto emptyObjectJson =
+      nlohmann::json::parse(emptyObjectSnapshot.GetProvisionalResponse());
+
+  EXPECT_EQ(true, json.at("provisional"));
+  EXPECT_EQ("Skyrim", json.at("folder"));
+  EXPECT_EQ(nlohmann::json({{"provisional", true}}), emptyObjectJson);
+}
+
+TEST_F(GameDataSnapshotTest,
+       applyDeltaShouldReplaceChangedPluginsAndFollowTheNewLoadOrder) {
+  GameDataSnapshot snapshot("old key", {{"a.esp", fingerprint(1)}}, R"({
+    "folder": "Skyrim",
+    "generalMessages": [{"text": "old"}],
+    "plugins": [
+      {"name": "A.esp", "loadOrderIndex": 0, "version": "1"},
+      {"name": "B.esp", "loadOrderIndex": 1},
+      {"name": "C.esp"}
+    ]
+  })");
+
+  auto delta = nlohmann::json::parse(R"({
+    "folder": "Skyrim",
+    "generalMessages": [],
+    "loadOrder": [
+      {"name": "B.esp", "loadOrderIndex": 0},
+      {"name": "D.esp", "loadOrderIndex": 1},
+      {"name": "A.esp"}
+    ],
+    "plugins": [
+      {"name": "D.esp", "loadOrderIndex": 1},
+      {"name": "A.esp", "version": "2"}
+    ]
+  })");
+  snapshot.ApplyDelta(delta, "new key", {{"b.esp", fingerprint(2)}});
+
+  EXPECT_EQ("new key", snapshot.GetMetadataKey());
+  EXPECT_EQ(1, snapshot.GetPluginFingerprints().count("b.esp"));
+  EXPECT_EQ(0, snapshot.GetPluginFingerprints().count("a.esp"));
+  EXPECT_EQ(nlohmann::json::parse(R"({
+    "folder": "Skyrim",
+    "generalMessages": [],
+    "plugins": [
+      {"name": "B.esp", "loadOrderIndex": 0},
+      {"name": "D.esp", "loadOrderIndex": 1},
+      {"name": "A.esp", "version": "2"}
+    ]
+  })"),
+            nlohmann::json::parse(snapshot.GetResponse()));
+}
+}
+}
+
+#endif
@@ -123,6 +123,57 @@ TEST(to_json, shouldNotIncludeLanguageFontFamilyKeyIfNoFontFamilyIsSpecified) {
   EXPECT_EQ(language.name, json.at("name"));
   EXPECT_EQ(0, json.count("fontFamily"));
 }
+
+TEST(write_json, shouldMatchToJsonForASimpleMessage) {
+  SimpleMessage message;
+  message.type = MessageType::warn;
+  message.text = u8"non\u00C1scii \"text\"";
+  message.language = "en";
+  message.condition = "file(\"test.esp\")";
+
+  nlohmann::json json = message;
+  JsonWriter writer;
+  write_json(writer, message);
+
+  EXPECT_EQ(json.dump(), writer.release());
+}
+
+TEST(write_json, shouldMatchToJsonForPluginMetadataWithAllFieldsSet) {
+  PluginMetadata metadata("test.esp");
+  metadata.SetEnabled(false);
+  metadata.SetGroup("group");
+  metadata.SetLoadAfterFiles({File("a.esp", "A", "file(\"b.esp\")")});
+  metadata.SetRequirements({File("b.esp")});
+  metadata.SetIncompatibilities({File("c.esp"), File("d.esp")});
+  metadata.SetMessages({
+      Message(MessageType::say, "content"),
+      Message(MessageType::error, "error content", "file(\"c.esp\")"),
+  });
+  metadata.SetTags({Tag("Relev"), Tag("Delev", false)});
+  metadata.SetDirtyInfo({PluginCleaningData(
+      0x12345678,
+      "utility",
+      {MessageContent("info", MessageContent::defaultLanguage)},
+      1,
+      2,
+      3)});
+  metadata.SetCleanInfo({PluginCleaningData(0xDEADBEEF, "utility")});
+  metadata.SetLocations({Location("https://www.example.com", "example")});
+
+  JsonWriter writer;
+  write_json_with_language(writer, metadata, "en");
+
+  EXPECT_EQ(to_json_with_language(metadata, "en").dump(), writer.release());
+}
+
+TEST(write_json, shouldMatchToJsonForPluginMetadataWithNoGroup) {
+  PluginMetadata metadata("test.esp");
+
+  JsonWriter writer;
+  write_json_with_language(writer, metadata, "en");
+
+  EXPECT_EQ(to_json_with_language(metadata, "en").dump(), writer.release());
+}
 }
 }
 #endif
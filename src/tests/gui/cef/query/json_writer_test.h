@@ -0,0 +1,134 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_JSON_WRITER_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_JSON_WRITER_TEST
+
+#include "gui/cef/query/json_writer.h"
+
+#include <limits>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(JsonWriter, shouldWriteNestedObjectsAndArraysLikeNlohmannJson) {
+  nlohmann::json json = {
+      {"array", {1, 2, 3}},
+      {"bool", true},
+      {"empty", nlohmann::json::object()},
+      {"object", {{"a", nlohmann::json::array()}, {"b", "value"}}},
+  };
+
+  JsonWriter writer;
+  writer.startObject();
+  writer.key("array");
+  writer.startArray();
+  writer.value(1);
+  writer.value(2);
+  writer.value(3);
+  writer.endArray();
+  writer.key("bool");
+  writer.value(true);
+  writer.key("empty");
+  writer.startObject();
+  writer.endObject();
+  writer.key("object");
+  writer.startObject();
+  writer.key("a");
+  writer.startArray();
+  writer.endArray();
+  writer.key("b");
+  writer.value("value");
+  writer.endObject();
+  writer.endObject();
+
+  EXPECT_EQ(json.dump(), writer.release());
+}
+
+TEST(JsonWriter, shouldEscapeStringsLikeNlohmannJson) {
+  std::string value = u8"\"quoted\" back\\slash \b\f\n\r\t \x01\x1F\x7F "
+                      u8"non\u00C1scii \u20AC \U0001F600";
+
+  JsonWriter writer;
+  writer.value(value);
+
+  EXPECT_EQ(nlohmann::json(value).dump(), writer.release());
+}
+
+TEST(JsonWriter, shouldThrowIfAStringIsNotValidUtf8) {
+  JsonWriter writer;
+
+  EXPECT_THROW(writer.value("\xC3"), std::runtime_error);
+  EXPECT_THROW(writer.value("\xC0\xAF"), std::runtime_error);
+  EXPECT_THROW(writer.value("\xED\xA0\x80"), std::runtime_error);
+  EXPECT_THROW(writer.value("\xF4\x90\x80\x80"), std::runtime_error);
+}
+
+TEST(JsonWriter, shouldWriteSerialisedValuesAndJsonTreesAsArrayElements) {
+  nlohmann::json json = {{"key", "value"}};
+
+  JsonWriter writer;
+  writer.startArray();
+  writer.serialisedValue("{\"a\":1}");
+  writer.value(json);
+  writer.endArray();
+
+  EXPECT_EQ("[{\"a\":1}," + json.dump() + "]", writer.release());
+}
+
+TEST(JsonWriter, shouldWriteSerialisedElementsAndSkipEmptySequences) {
+  JsonWriter writer;
+  writer.startArray();
+  writer.serialisedElements("");
+  writer.serialisedElements("1,2");
+  writer.serialisedElements("");
+  writer.serialisedElements("3");
+  writer.endArray();
+
+  EXPECT_EQ("[1,2,3]", writer.release());
+}
+
+TEST(JsonWriter, shouldWriteIntegerLimitsAndStringViewsLikeNlohmannJson) {
+  nlohmann::json json = {
+      std::numeric_limits<int64_t>::min(),
+      std::numeric_limits<uint64_t>::max(),
+      "view",
+  };
+
+  JsonWriter writer;
+  writer.startArray();
+  writer.value(std::numeric_limits<int64_t>::min());
+  writer.value(std::numeric_limits<uint64_t>::max());
+  writer.value(std::string_view("view and more").substr(0, 4));
+  writer.endArray();
+
+  EXPECT_EQ(json.dump(), writer.release());
+}
+}
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_LOAD_ORDER_FORMATTER_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_LOAD_ORDER_FORMATTER_TEST
+
+#include "gui/cef/query/load_order_formatter.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+std::string formatTestLoadOrder(LoadOrderFormat format) {
+  LoadOrderFormatter formatter(format, 4, 0);
+  formatter.writePlugin("Blank.esm", true, false);
+  formatter.writePlugin("Blank.esl", true, true);
+  formatter.writePlugin("Blank.esp", false, false);
+  formatter.writePlugin("Blank, \"Quoted\".esp", true, false);
+
+  return formatter.getOutput();
+}
+
+TEST(LoadOrderFormatter, tableFormatShouldMatchTheStreamedFormat) {
+  EXPECT_EQ(
+      "  0  0     Blank.esm\r\n"
+      "254 FE   0 Blank.esl\r\n"
+      "           Blank.esp\r\n"
+      "  1  1     Blank, \"Quoted\".esp\r\n",
+      formatTestLoadOrder(LoadOrderFormat::table));
+}
+
+TEST(LoadOrderFormatter, tableFormatShouldWriteIndicesInDecimalAndHex) {
+  LoadOrderFormatter formatter(LoadOrderFormat::table, 256, 0);
+  for (int i = 0; i < 255; ++i) {
+    formatter.writePlugin("Blank.esp", true, false);
+  }
+  for (int i = 0; i < 300; ++i) {
+    formatter.writePlugin("Blank.esl", true, true);
+  }
+
+  auto output = formatter.getOutput();
+
+  EXPECT_NE(std::string::npos, output.find("\r\n 26 1a     Blank.esp\r\n"));
+  EXPECT_NE(std::string::npos, output.find("\r\n254 fe     Blank.esp\r\n"));
+  EXPECT_NE(std::string::npos, output.find("\r\n254 FE 12b Blank.esl\r\n"));
+}
+
+TEST(LoadOrderFormatter, namesFormatShouldOnlyWriteNames) {
+  EXPECT_EQ(
+      "Blank.esm\r\n"
+      "Blank.esl\r\n"
+      "Blank.esp\r\n"
+      "Blank, \"Quoted\".esp\r\n",
+      formatTestLoadOrder(LoadOrderFormat::names));
+}
+
+TEST(LoadOrderFormatter,
+     pluginsTxtFormatShouldPrefixActivePluginsWithAnAsterisk) {
+  EXPECT_EQ(
+      "*Blank.esm\r\n"
+      "*Blank.esl\r\n"
+      "Blank.esp\r\n"
+      "*Blank, \"Quoted\".esp\r\n",
+      formatTestLoadOrder(LoadOrderFormat::pluginsTxt));
+}
+
+TEST(LoadOrderFormatter, csvFormatShouldWriteAHeaderAndQuoteNamesIfNecessary) {
+  EXPECT_EQ(
+      "Position,Active Index,Hex Index,Name\r\n"
+      "0,0,00,Blank.esm\r\n"
+      "1,0,FE 000,Blank.esl\r\n"
+      "2,,,Blank.esp\r\n"
+      "3,1,01,\"Blank, \"\"Quoted\"\".esp\"\r\n",
+      formatTestLoadOrder(LoadOrderFormat::csv));
+}
+
+TEST(LoadOrderFormatter, mapLoadOrderFormatShouldThrowIfTheFormatIsUnknown) {
+  EXPECT_EQ(LoadOrderFormat::table, mapLoadOrderFormat("table"));
+  EXPECT_EQ(LoadOrderFormat::names, mapLoadOrderFormat("names"));
+  EXPECT_EQ(LoadOrderFormat::pluginsTxt, mapLoadOrderFormat("pluginsTxt"));
+  EXPECT_EQ(LoadOrderFormat::csv, mapLoadOrderFormat("csv"));
+  EXPECT_THROW(mapLoadOrderFormat("xml"), std::runtime_error);
+}
+}
+}
+
+#endif
@@ -0,0 +1,187 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_LOCAL_SOCKET_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_LOCAL_SOCKET_TEST
+
+#include "gui/cef/query/local_socket.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace loot {
+namespace test {
+TEST(MessageBuffer, nextShouldReturnNulloptUntilAMessageHasBeenCompleted) {
+  MessageBuffer buffer;
+
+  EXPECT_FALSE(buffer.Next().has_value());
+
+  buffer.Append("abc", 3);
+  EXPECT_FALSE(buffer.Next().has_value());
+
+  buffer.Append("d\n", 2);
+  EXPECT_EQ("abcd", buffer.Next());
+  EXPECT_FALSE(buffer.Next().has_value());
+}
+
+TEST(MessageBuffer, nextShouldReturnEachMessageInOrder) {
+  MessageBuffer buffer;
+
+  buffer.Append("a\n\nb", 4);
+  buffer.Append("c\nd", 3);
+
+  EXPECT_EQ("a", buffer.Next());
+  EXPECT_EQ("", buffer.Next());
+  EXPECT_EQ("bc", buffer.Next());
+  EXPECT_FALSE(buffer.Next().has_value());
+
+  buffer.Append("\n", 1);
+  EXPECT_EQ("d", buffer.Next());
+}
+
+class LocalSocketTest : public ::testing::Test {
+protected:
+  LocalSocketTest() :
+#ifdef _WIN32
+      endpointName_("LOOT-local-socket-test") {
+  }
+#else
+      endpointName_((std::filesystem::temp_directory_path() /
+                     "LOOT-local-socket-test.sock")
+                        .u8string()) {
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(std::filesystem::u8path(endpointName_));
+  }
+#endif
+
+  const std::string endpointName_;
+};
+
+TEST_F(LocalSocketTest, connectionConstructorShouldThrowIfNothingIsListening) {
+  EXPECT_THROW(LocalConnection connection(endpointName_), std::system_error);
+}
+
+TEST_F(LocalSocketTest, listenerConstructorShouldThrowIfTheEndpointIsInUse) {
+  LocalListener listener(endpointName_);
+
+  EXPECT_THROW(LocalListener other(endpointName_), std::system_error);
+}
+
+TEST_F(LocalSocketTest, messagesShouldBeSentInBothDirections) {
+  LocalListener listener(endpointName_);
+
+  std::thread client([&]() {
+    LocalConnection connection(endpointName_);
+    connection.WriteMessage("ping");
+    connection.WriteMessage(std::string(10000, 'a'));
+    EXPECT_EQ("pong", connection.ReadMessage());
+  });
+
+  auto connection = listener.Accept();
+  EXPECT_EQ("ping", connection->ReadMessage());
+  EXPECT_EQ(std::string(10000, 'a'), connection->ReadMessage());
+  connection->WriteMessage("pong");
+
+  client.join();
+}
+
+TEST_F(LocalSocketTest,
+       readMessageShouldReturnNulloptWhenTheOtherEndClosesTheConnection) {
+  LocalListener listener(endpointName_);
+
+  std::thread client([&]() {
+    LocalConnection connection(endpointName_);
+    connection.WriteMessage("message");
+  });
+
+  auto connection = listener.Accept();
+  client.join();
+
+  EXPECT_EQ("message", connection->ReadMessage());
+  EXPECT_FALSE(connection->ReadMessage().has_value());
+}
+
+#ifndef _WIN32
+TEST_F(LocalSocketTest, listenerConstructorShouldReplaceAStaleSocket) {
+  // Leave a socket file behind, as if its server had crashed.
+  {
+    auto staleSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    endpointName_.copy(address.sun_path, endpointName_.size());
+    ASSERT_EQ(0,
+              bind(staleSocket,
+                   reinterpret_cast<const sockaddr*>(&address),
+                   sizeof(address)));
+    close(staleSocket);
+  }
+  ASSERT_TRUE(std::filesystem::exists(std::filesystem::u8path(endpointName_)));
+
+  LocalListener listener(endpointName_);
+
+  std::thread client([&]() { LocalConnection connection(endpointName_); });
+  EXPECT_NO_THROW(listener.Accept());
+  client.join();
+}
+
+TEST_F(LocalSocketTest, listenerConstructorShouldThrowIfTheFileIsNotASocket) {
+  const auto path = std::filesystem::u8path(endpointName_);
+  std::ofstream(path) << "notes";
+
+  EXPECT_THROW(LocalListener listener(endpointName_), std::system_error);
+
+  std::ifstream in(path);
+  std::string content;
+  in >> content;
+  EXPECT_EQ("notes", content);
+}
+
+TEST_F(LocalSocketTest, listenerShouldOnlyLetItsOwnerUseTheSocket) {
+  LocalListener listener(endpointName_);
+
+  auto permissions =
+      std::filesystem::status(std::filesystem::u8path(endpointName_))
+          .permissions();
+  EXPECT_EQ(std::filesystem::perms::none,
+            permissions & (std::filesystem::perms::group_all |
+                           std::filesystem::perms::others_all));
+}
+#endif
+}
+}
+
+#endif
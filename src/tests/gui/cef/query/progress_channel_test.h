@@ -0,0 +1,165 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_PROGRESS_CHANNEL_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_PROGRESS_CHANNEL_TEST
+
+#include "gui/cef/query/progress_channel.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <json.hpp>
+
+namespace loot {
+namespace test {
+class ProgressChannelTest : public ::testing::Test {
+protected:
+  ProgressChannelTest() :
+      channel(std::make_shared<ProgressChannel>(
+          10,
+          [this](std::function<void()> task, std::chrono::milliseconds delay) {
+            tasks.push_back(task);
+            delays.push_back(delay);
+          },
+          [this](const std::string& json) {
+            updates.push_back(nlohmann::json::parse(json));
+          },
+          [this]() { return now; })) {}
+
+  void runTasks() {
+    auto tasksToRun = tasks;
+    tasks.clear();
+    for (const auto& task : tasksToRun) {
+      task();
+    }
+  }
+
+  std::vector<std::function<void()>> tasks;
+  std::vector<std::chrono::milliseconds> delays;
+  std::vector<nlohmann::json> updates;
+  std::chrono::steady_clock::time_point now;
+  std::shared_ptr<ProgressChannel> channel;
+};
+
+TEST_F(ProgressChannelTest, reportShouldScheduleTheFirstUpdateWithoutDelay) {
+  channel->Report(ProgressUpdate("Sorting..."));
+
+  ASSERT_EQ(1, tasks.size());
+  EXPECT_EQ(0, delays[0].count());
+  EXPECT_TRUE(updates.empty());
+
+  runTasks();
+
+  ASSERT_EQ(1, updates.size());
+  EXPECT_EQ("Sorting...", updates[0].at("text"));
+  EXPECT_EQ(0, updates[0].count("done"));
+  EXPECT_EQ(0, updates[0].count("total"));
+  EXPECT_EQ(0, updates[0].count("etaSeconds"));
+}
+
+TEST_F(ProgressChannelTest, reportShouldOnlyDeliverTheLatestUpdateEachTick) {
+  channel->Report(ProgressUpdate("Reading 1", 1, 3));
+  channel->Report(ProgressUpdate("Reading 2", 2, 3));
+  channel->Report(ProgressUpdate("Reading 3", 3, 3));
+
+  ASSERT_EQ(1, tasks.size());
+  runTasks();
+
+  ASSERT_EQ(1, updates.size());
+  EXPECT_EQ("Reading 3", updates[0].at("text"));
+  EXPECT_EQ(3, updates[0].at("done"));
+  EXPECT_EQ(3, updates[0].at("total"));
+}
+
+TEST_F(ProgressChannelTest,
+       reportShouldDelayTheNextUpdateUntilTheIntervalHasPassed) {
+  channel->Report(ProgressUpdate("first"));
+  runTasks();
+
+  channel->Report(ProgressUpdate("second"));
+
+  ASSERT_EQ(1, tasks.size());
+  EXPECT_LT(0, delays[1].count());
+  EXPECT_GE(100, delays[1].count());
+}
+
+TEST_F(ProgressChannelTest, updatesShouldBeSafeForAnyText) {
+  const std::string text = "It's \"quoted\"\n');alert('";
+  channel->Report(ProgressUpdate(text));
+  runTasks();
+
+  ASSERT_EQ(1, updates.size());
+  EXPECT_EQ(text, updates[0].at("text"));
+}
+
+TEST_F(ProgressChannelTest,
+       reportShouldEstimateTheTimeRemainingOnceTheCountHasAdvanced) {
+  channel->Report(ProgressUpdate("Reading", 0, 4));
+  now += std::chrono::seconds(1);
+  channel->Report(ProgressUpdate("Reading", 1, 4));
+  runTasks();
+
+  ASSERT_EQ(1, updates.size());
+  EXPECT_DOUBLE_EQ(3.0, updates[0].at("etaSeconds").get<double>());
+}
+
+TEST_F(ProgressChannelTest, reportShouldRestartTheEstimateWhenTheTotalChanges) {
+  channel->Report(ProgressUpdate("Reading", 0, 4));
+  now += std::chrono::seconds(1);
+  channel->Report(ProgressUpdate("Reading", 2, 4));
+  channel->Report(ProgressUpdate("Evaluating", 2, 10));
+  runTasks();
+
+  ASSERT_EQ(1, updates.size());
+  EXPECT_EQ(0, updates[0].count("etaSeconds"));
+}
+
+TEST_F(ProgressChannelTest, closeShouldDropAnUpdateThatIsAlreadyScheduled) {
+  channel->Report(ProgressUpdate("first"));
+  runTasks();
+  channel->Report(ProgressUpdate("second"));
+  ASSERT_EQ(1, tasks.size());
+
+  // The query responds before the delayed update's task runs.
+  channel->Close();
+  runTasks();
+
+  ASSERT_EQ(1, updates.size());
+  EXPECT_EQ("first", updates[0].at("text"));
+}
+
+TEST_F(ProgressChannelTest, reportShouldDoNothingOnceTheChannelIsClosed) {
+  channel->Close();
+  channel->Report(ProgressUpdate("Sorting..."));
+
+  EXPECT_TRUE(tasks.empty());
+  runTasks();
+  EXPECT_TRUE(updates.empty());
+}
+}
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_QUERY_RECORDING_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_QUERY_RECORDING_TEST
+
+#include "gui/cef/query/query_recording.h"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class QueryRecordingTest : public ::testing::Test {
+protected:
+  QueryRecordingTest() :
+      recordingPath_(std::filesystem::temp_directory_path() /
+                     "LOOT-query-recording-test.jsonl") {}
+
+  void SetUp() override { std::filesystem::remove(recordingPath_); }
+
+  void TearDown() override { std::filesystem::remove(recordingPath_); }
+
+  const std::filesystem::path recordingPath_;
+};
+
+TEST_F(QueryRecordingTest, recordShouldDoNothingIfNotRecording) {
+  QueryRecorder recorder;
+
+  recorder.Record({{"name", "getVersion"}});
+
+  EXPECT_FALSE(recorder.IsRecording());
+  EXPECT_FALSE(std::filesystem::exists(recordingPath_));
+}
+
+TEST_F(QueryRecordingTest, recordedQueriesShouldBeReadBackInOrder) {
+  QueryRecorder recorder;
+  recorder.Start(recordingPath_);
+
+  recorder.Record({{"name", "getGameData"}});
+  recorder.Record({{"name", "editorClosed"}, {"editorState", {{"a", 1}}}});
+  recorder.Stop();
+  recorder.Record({{"name", "getVersion"}});
+
+  const auto queries = ReadQueryRecording(recordingPath_);
+
+  ASSERT_EQ(2, queries.size());
+  EXPECT_EQ("getGameData", queries[0].request.at("name"));
+  EXPECT_EQ("editorClosed", queries[1].request.at("name"));
+  EXPECT_EQ(1, queries[1].request.at("editorState").at("a"));
+  EXPECT_LE(queries[0].timeMicroseconds, queries[1].timeMicroseconds);
+}
+
+TEST_F(QueryRecordingTest, readQueryRecordingShouldThrowIfALineIsInvalid) {
+  std::ofstream out(recordingPath_);
+  out << R"({"timeMicroseconds":0,"request":{"name":"getVersion"}})" << '\n'
+      << R"({"timeMicroseconds":1,"request":{}})" << '\n';
+  out.close();
+
+  EXPECT_THROW(ReadQueryRecording(recordingPath_), std::runtime_error);
+}
+
+TEST_F(QueryRecordingTest, readQueryRecordingShouldThrowIfTheFileIsMissing) {
+  EXPECT_THROW(ReadQueryRecording(recordingPath_), std::runtime_error);
+}
+
+TEST(SummariseQueryLatencies, shouldGetNearestRankPercentilesForEachName) {
+  std::vector<QueryLatency> latencies;
+  for (std::int64_t i = 100; i > 0; --i) {
+    latencies.push_back({"sortPlugins", i, i != 1});
+  }
+  latencies.push_back({"applySort", 7, true});
+
+  const auto summaries = SummariseQueryLatencies(latencies);
+
+  ASSERT_EQ(2, summaries.size());
+  EXPECT_EQ("applySort", summaries[0].name);
+  EXPECT_EQ(1, summaries[0].count);
+  EXPECT_EQ(7, summaries[0].p50Microseconds);
+  EXPECT_EQ(7, summaries[0].p99Microseconds);
+  EXPECT_EQ(7, summaries[0].maxMicroseconds);
+
+  EXPECT_EQ("sortPlugins", summaries[1].name);
+  EXPECT_EQ(100, summaries[1].count);
+  EXPECT_EQ(1, summaries[1].failureCount);
+  EXPECT_EQ(50, summaries[1].p50Microseconds);
+  EXPECT_EQ(90, summaries[1].p90Microseconds);
+  EXPECT_EQ(99, summaries[1].p99Microseconds);
+  EXPECT_EQ(100, summaries[1].maxMicroseconds);
+
+  const auto json = ToJson(summaries);
+  ASSERT_EQ(2, json.size());
+  EXPECT_EQ(90, json[1].at("p90Microseconds"));
+}
+}
+}
+
+#endif
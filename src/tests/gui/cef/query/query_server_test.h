@@ -0,0 +1,149 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_QUERY_SERVER_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_QUERY_SERVER_TEST
+
+#include "gui/cef/query/query_server.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class QueryServerTest : public ::testing::Test {
+protected:
+  QueryServerTest() :
+#ifdef _WIN32
+      endpointName_("LOOT-query-server-test"),
+#else
+      endpointName_((std::filesystem::temp_directory_path() /
+                     "LOOT-query-server-test.sock")
+                        .u8string()),
+#endif
+      runQuery_([](nlohmann::json request) -> std::string {
+        const std::string name = request.at("name");
+        if (name == "fail") {
+          throw std::runtime_error("The query failed");
+        }
+        return "{\"query\":\"" + name + "\"}";
+      }) {
+  }
+
+  const std::string endpointName_;
+  const QueryRunner runQuery_;
+};
+
+TEST_F(QueryServerTest, replyShouldHoldTheQueryResponseAndTheRequestId) {
+  QueryServer server(endpointName_, runQuery_);
+
+  auto reply = nlohmann::json::parse(
+      server.Reply(R"({"name":"getVersion","id":5})"));
+
+  EXPECT_EQ(5, reply.at("id"));
+  EXPECT_EQ("{\"query\":\"getVersion\"}", reply.at("response"));
+  EXPECT_EQ(0, reply.count("error"));
+}
+
+TEST_F(QueryServerTest, replyShouldHoldAnErrorIfTheQueryFails) {
+  QueryServer server(endpointName_, runQuery_);
+
+  auto reply = nlohmann::json::parse(server.Reply(R"({"name":"fail"})"));
+
+  EXPECT_EQ("The query failed", reply.at("error"));
+  EXPECT_EQ(0, reply.count("id"));
+  EXPECT_EQ(0, reply.count("response"));
+}
+
+TEST_F(QueryServerTest, replyShouldHoldAnErrorIfTheRequestIsInvalid) {
+  QueryServer server(endpointName_, runQuery_);
+
+  auto reply = nlohmann::json::parse(server.Reply("{"));
+  EXPECT_EQ(1, reply.count("error"));
+
+  reply = nlohmann::json::parse(server.Reply(R"({"id":1})"));
+  EXPECT_EQ(1, reply.at("id"));
+  EXPECT_EQ(1, reply.count("error"));
+}
+
+TEST_F(QueryServerTest, runShouldServeRequestsUntilAStopServerRequest) {
+  QueryServer server(endpointName_, runQuery_);
+  std::thread serverThread([&]() { server.Run(); });
+
+  {
+    LocalConnection connection(endpointName_);
+    connection.WriteMessage(R"({"name":"getGameData"})");
+    connection.WriteMessage(R"({"name":"sortPlugins"})");
+
+    auto reply = nlohmann::json::parse(connection.ReadMessage().value());
+    EXPECT_EQ("{\"query\":\"getGameData\"}", reply.at("response"));
+    reply = nlohmann::json::parse(connection.ReadMessage().value());
+    EXPECT_EQ("{\"query\":\"sortPlugins\"}", reply.at("response"));
+  }
+
+  {
+    // The server handles the next connection once the last one closes.
+    LocalConnection connection(endpointName_);
+    connection.WriteMessage(R"({"name":"stopServer"})");
+
+    auto reply = nlohmann::json::parse(connection.ReadMessage().value());
+    EXPECT_EQ("", reply.at("response"));
+  }
+
+  serverThread.join();
+}
+
+TEST_F(QueryServerTest, stopShouldStopAServerThatIsWaitingForAConnection) {
+  QueryServer server(endpointName_, runQuery_);
+  std::thread serverThread([&]() { server.Run(); });
+
+  server.Stop();
+  serverThread.join();
+
+  EXPECT_NO_THROW(server.Stop());
+}
+
+TEST_F(QueryServerTest, stopShouldDisconnectAClientThatIsNotSendingRequests) {
+  QueryServer server(endpointName_, runQuery_);
+  std::thread serverThread([&]() { server.Run(); });
+
+  LocalConnection connection(endpointName_);
+  // Once the reply has been received, the server is waiting for the next
+  // request.
+  connection.WriteMessage(R"({"name":"getGameData"})");
+  ASSERT_TRUE(connection.ReadMessage().has_value());
+
+  server.Stop();
+  serverThread.join();
+
+  EXPECT_FALSE(connection.ReadMessage().has_value());
+}
+}
+}
+
+#endif
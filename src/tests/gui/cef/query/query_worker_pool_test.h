@@ -0,0 +1,218 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_QUERY_WORKER_POOL_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_QUERY_WORKER_POOL_TEST
+
+#include "gui/cef/query/query_worker_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+static constexpr auto TASK_TIMEOUT = std::chrono::seconds(10);
+
+TEST(QueryWorkerPool, interactiveTasksShouldRunWhileAnExclusiveTaskIsRunning) {
+  QueryWorkerPool pool(2);
+  std::promise<void> exclusiveStarted;
+  std::promise<void> releaseExclusive;
+  auto releaseFuture = releaseExclusive.get_future().share();
+  std::promise<void> interactiveFinished;
+
+  pool.post(QueryPriority::exclusive, "game", [&, releaseFuture]() {
+    exclusiveStarted.set_value();
+    releaseFuture.wait();
+  });
+  ASSERT_EQ(std::future_status::ready,
+            exclusiveStarted.get_future().wait_for(TASK_TIMEOUT));
+
+  pool.post(QueryPriority::interactive, "", [&]() {
+    interactiveFinished.set_value();
+  });
+
+  EXPECT_EQ(std::future_status::ready,
+            interactiveFinished.get_future().wait_for(TASK_TIMEOUT));
+
+  releaseExclusive.set_value();
+}
+
+TEST(QueryWorkerPool, exclusiveTasksForAGameShouldRunOneAtATimeInOrder) {
+  QueryWorkerPool pool(4);
+  std::mutex mutex;
+  std::vector<int> order;
+  std::atomic<int> runningCount(0);
+  std::atomic<bool> ranConcurrently(false);
+  std::promise<void> lastFinished;
+
+  for (int i = 0; i < 10; ++i) {
+    pool.post(QueryPriority::exclusive, "game", [&, i]() {
+      if (++runningCount > 1) {
+        ranConcurrently = true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        order.push_back(i);
+      }
+      --runningCount;
+
+      if (i == 9) {
+        lastFinished.set_value();
+      }
+    });
+  }
+
+  ASSERT_EQ(std::future_status::ready,
+            lastFinished.get_future().wait_for(TASK_TIMEOUT));
+
+  EXPECT_FALSE(ranConcurrently);
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), order);
+}
+
+TEST(QueryWorkerPool, backgroundTasksForAGameShouldRunConcurrently) {
+  QueryWorkerPool pool(3);
+  std::promise<void> firstStarted;
+  std::promise<void> secondStarted;
+  auto firstFuture = firstStarted.get_future().share();
+  auto secondFuture = secondStarted.get_future().share();
+  std::promise<bool> firstSawSecond;
+
+  pool.post(QueryPriority::background, "game", [&, secondFuture]() {
+    firstStarted.set_value();
+    firstSawSecond.set_value(secondFuture.wait_for(TASK_TIMEOUT) ==
+                             std::future_status::ready);
+  });
+  pool.post(QueryPriority::background, "game", [&, firstFuture]() {
+    firstFuture.wait();
+    secondStarted.set_value();
+  });
+
+  auto result = firstSawSecond.get_future();
+  ASSERT_EQ(std::future_status::ready, result.wait_for(TASK_TIMEOUT * 2));
+  EXPECT_TRUE(result.get());
+}
+
+TEST(QueryWorkerPool, backgroundTasksShouldWaitForEarlierExclusiveTasks) {
+  QueryWorkerPool pool(3);
+  std::atomic<bool> exclusiveFinished(false);
+  std::promise<bool> backgroundSawExclusive;
+
+  pool.post(QueryPriority::exclusive, "game", [&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    exclusiveFinished = true;
+  });
+  pool.post(QueryPriority::background, "game", [&]() {
+    backgroundSawExclusive.set_value(exclusiveFinished);
+  });
+
+  auto result = backgroundSawExclusive.get_future();
+  ASSERT_EQ(std::future_status::ready, result.wait_for(TASK_TIMEOUT));
+  EXPECT_TRUE(result.get());
+}
+
+TEST(QueryWorkerPool, idleTasksShouldRunAfterTasksThatArePostedLater) {
+  QueryWorkerPool pool(3);
+  std::mutex mutex;
+  std::vector<std::string> order;
+  std::promise<void> releaseFirst;
+  auto releaseFuture = releaseFirst.get_future().share();
+  std::promise<void> idleFinished;
+
+  auto record = [&](const std::string& name) {
+    std::lock_guard<std::mutex> guard(mutex);
+    order.push_back(name);
+  };
+
+  pool.post(QueryPriority::exclusive, "game", [&, releaseFuture]() {
+    releaseFuture.wait();
+    record("first");
+  });
+  pool.post(QueryPriority::idle, "game", [&]() {
+    record("idle");
+    idleFinished.set_value();
+  });
+  pool.post(QueryPriority::background, "game", [&]() { record("second"); });
+  releaseFirst.set_value();
+
+  ASSERT_EQ(std::future_status::ready,
+            idleFinished.get_future().wait_for(TASK_TIMEOUT));
+
+  EXPECT_EQ(std::vector<std::string>({"first", "second", "idle"}), order);
+}
+
+TEST(QueryWorkerPool, postingAnIdleTaskShouldReplaceAQueuedIdleTask) {
+  QueryWorkerPool pool(2);
+  std::atomic<bool> firstIdleRan(false);
+  std::promise<void> releaseExclusive;
+  auto releaseFuture = releaseExclusive.get_future().share();
+  std::promise<void> secondIdleFinished;
+
+  pool.post(QueryPriority::exclusive, "game", [releaseFuture]() {
+    releaseFuture.wait();
+  });
+  pool.post(QueryPriority::idle, "game", [&]() { firstIdleRan = true; });
+  pool.post(QueryPriority::idle, "game", [&]() {
+    secondIdleFinished.set_value();
+  });
+  releaseExclusive.set_value();
+
+  ASSERT_EQ(std::future_status::ready,
+            secondIdleFinished.get_future().wait_for(TASK_TIMEOUT));
+
+  EXPECT_FALSE(firstIdleRan);
+}
+
+TEST(QueryWorkerPool, exclusiveTasksForDifferentGamesShouldRunConcurrently) {
+  QueryWorkerPool pool(3);
+  std::promise<void> firstStarted;
+  auto firstFuture = firstStarted.get_future().share();
+  std::promise<bool> firstSawSecond;
+  std::promise<void> secondStarted;
+  auto secondFuture = secondStarted.get_future().share();
+
+  pool.post(QueryPriority::exclusive, "game1", [&, secondFuture]() {
+    firstStarted.set_value();
+    firstSawSecond.set_value(secondFuture.wait_for(TASK_TIMEOUT) ==
+                             std::future_status::ready);
+  });
+  pool.post(QueryPriority::exclusive, "game2", [&, firstFuture]() {
+    firstFuture.wait();
+    secondStarted.set_value();
+  });
+
+  auto result = firstSawSecond.get_future();
+  ASSERT_EQ(std::future_status::ready, result.wait_for(TASK_TIMEOUT * 2));
+  EXPECT_TRUE(result.get());
+}
+}
+}
+
+#endif
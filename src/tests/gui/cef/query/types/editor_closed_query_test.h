@@ -75,6 +75,10 @@ public:
   }
 
   bool IsPluginActive(const std::string& pluginName) const { return false; }
+  std::optional<short> GetActiveLoadOrderIndex(
+      const std::shared_ptr<const PluginInterface>& plugin) const {
+    return std::nullopt;
+  }
   std::optional<short> GetActiveLoadOrderIndex(
       const std::shared_ptr<const PluginInterface>& plugin,
       const std::vector<std::string>& loadOrder) const {
@@ -83,6 +87,15 @@ public:
 
   std::vector<std::string> GetLoadOrder() const { return {}; }
 
+  std::shared_ptr<const gui::BashTagTable> GetBashTagTable() const {
+    return std::make_shared<gui::BashTagTable>();
+  }
+
+  std::optional<uint32_t> GetPluginCRC(
+      const std::shared_ptr<const PluginInterface>& plugin) const {
+    return std::nullopt;
+  }
+
   std::optional<PluginMetadata> GetUserMetadata(std::string name,
                                                 bool eval = true) const {
     return userMetadata;
@@ -110,16 +123,39 @@ public:
     return metadata;
   }
 
+  std::optional<std::string> GetDerivedMetadataJson(
+      const std::string& pluginName,
+      const std::string& language,
+      bool isActive,
+      std::optional<short> loadOrderIndex) const {
+    return std::nullopt;
+  }
+  void SetDerivedMetadataJson(const std::string& pluginName,
+                              const std::string& language,
+                              bool isActive,
+                              std::optional<short> loadOrderIndex,
+                              bool dependsOnOtherFiles,
+                              std::string json) {}
+
   std::vector<Message> CheckInstallValidity(
       std::shared_ptr<const PluginInterface> file,
       PluginMetadata metadata) {
     return {};
   }
 
-  void ClearUserMetadata(std::string name) { userMetadata = std::nullopt; }
-  void AddUserMetadata(PluginMetadata metadata) { userMetadata = metadata; }
+  void ReplaceUserMetadata(PluginMetadata metadata) {
+    if (metadata.HasNameOnly()) {
+      userMetadata = std::nullopt;
+    } else {
+      userMetadata = metadata;
+    }
+  }
   void SaveUserMetadata() {}
 
+  void BeginUserMetadataTransaction() {}
+  void CommitUserMetadataTransaction() {}
+  void RollbackUserMetadataTransaction() {}
+
   static constexpr auto NO_MASTERLIST_METADATA_PLUGIN = "no non-user metadata";
   static constexpr auto MASTERLIST_LATE_GROUP_PLUGIN =
       "masterlist metadata with Late group";
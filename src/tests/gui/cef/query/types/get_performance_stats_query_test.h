@@ -0,0 +1,123 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_TYPES_GET_PERFORMANCE_STATS_QUERY_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_TYPES_GET_PERFORMANCE_STATS_QUERY_TEST
+
+#include "gui/cef/query/types/get_performance_stats_query.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class GetPerformanceStatsQueryTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    const auto start = std::chrono::steady_clock::now();
+    recorder.Record("a", start, start + std::chrono::microseconds(3));
+    recorder.Record("a", start, start + std::chrono::microseconds(5));
+  }
+
+  TimingRecorder recorder;
+  CacheRegistry cacheRegistry;
+  ProcessMemoryHistory memoryHistory;
+};
+
+TEST_F(GetPerformanceStatsQueryTest,
+       executeLogicShouldReturnTimingsSummarisedByOperation) {
+  GetPerformanceStatsQuery query(false, recorder, cacheRegistry);
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  ASSERT_EQ(1, json.at("operations").size());
+  EXPECT_EQ("a", json["operations"][0].at("name"));
+  EXPECT_EQ(2, json["operations"][0].at("count"));
+  EXPECT_EQ(8, json["operations"][0].at("totalMicroseconds"));
+  EXPECT_EQ(5, json["operations"][0].at("maxMicroseconds"));
+  EXPECT_EQ(0, json["operations"][0].at("allocationCount"));
+  EXPECT_EQ(0, json.count("traceEvents"));
+}
+
+TEST_F(GetPerformanceStatsQueryTest,
+       executeLogicShouldIncludeTraceEventsIfRequested) {
+  GetPerformanceStatsQuery query(true, recorder, cacheRegistry);
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  ASSERT_EQ(2, json.at("traceEvents").size());
+  EXPECT_EQ("a", json["traceEvents"][0].at("name"));
+  EXPECT_EQ("X", json["traceEvents"][0].at("ph"));
+  EXPECT_EQ(3, json["traceEvents"][0].at("dur"));
+  EXPECT_EQ(5, json["traceEvents"][1].at("dur"));
+}
+
+TEST_F(GetPerformanceStatsQueryTest,
+       executeLogicShouldIncludeTheCacheBudgetAndCacheStats) {
+  std::uintmax_t cacheBytes = 300;
+  auto registration = cacheRegistry.Register(
+      "cache",
+      [&]() { return cacheBytes; },
+      [&](std::uintmax_t targetBytes) {
+        auto freedBytes = cacheBytes - targetBytes;
+        cacheBytes = targetBytes;
+        return freedBytes;
+      });
+  cacheRegistry.SetBudget(100);
+  cacheRegistry.EnforceBudget();
+  GetPerformanceStatsQuery query(false, recorder, cacheRegistry);
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_EQ(100, json.at("cacheBudgetBytes"));
+  ASSERT_EQ(1, json.at("caches").size());
+  EXPECT_EQ("cache", json["caches"][0].at("name"));
+  EXPECT_EQ(100, json["caches"][0].at("estimatedBytes"));
+  EXPECT_EQ(1, json["caches"][0].at("evictionCount"));
+  EXPECT_EQ(200, json["caches"][0].at("evictedBytes"));
+}
+
+TEST_F(GetPerformanceStatsQueryTest,
+       executeLogicShouldIncludeTheRecordedProcessMemorySamples) {
+  ProcessMemorySample sample;
+  sample.time = std::chrono::system_clock::time_point(
+      std::chrono::milliseconds(1000));
+  sample.residentBytes = 300;
+  sample.committedBytes = 200;
+  memoryHistory.Record(sample);
+  GetPerformanceStatsQuery query(
+      false, recorder, cacheRegistry, memoryHistory);
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_FALSE(json.at("allocationAccounting"));
+  ASSERT_EQ(1, json.at("memorySamples").size());
+  EXPECT_EQ(1000, json["memorySamples"][0].at("timeMilliseconds"));
+  EXPECT_EQ(300, json["memorySamples"][0].at("residentBytes"));
+  EXPECT_EQ(200, json["memorySamples"][0].at("committedBytes"));
+}
+}
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_RESOURCE_ARCHIVE_TEST
+#define LOOT_TESTS_GUI_CEF_RESOURCE_ARCHIVE_TEST
+
+#include "gui/cef/resource_archive.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class ResourceArchiveTest : public ::testing::Test {
+protected:
+  ResourceArchiveTest() :
+      archivePath_(std::filesystem::absolute("./testing-ui.pack")) {}
+
+  void TearDown() override { std::filesystem::remove(archivePath_); }
+
+  static void appendUint32(std::string& bytes, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  static void appendUint64(std::string& bytes, uint64_t value) {
+    appendUint32(bytes, static_cast<uint32_t>(value));
+    appendUint32(bytes, static_cast<uint32_t>(value >> 32));
+  }
+
+  // Pack the given files in the same way as scripts/pack_ui.js.
+  static std::string pack(const std::map<std::string, std::string>& files) {
+    std::string bytes(ResourceArchive::MAGIC);
+    appendUint32(bytes, ResourceArchive::VERSION);
+    appendUint32(bytes, static_cast<uint32_t>(files.size()));
+
+    size_t indexSize = 0;
+    for (const auto& file : files) {
+      indexSize += 20 + file.first.size();
+    }
+
+    std::string data;
+    auto dataStart = align(bytes.size() + indexSize);
+    for (const auto& file : files) {
+      data.resize(align(data.size()), '\0');
+
+      appendUint32(bytes, static_cast<uint32_t>(file.first.size()));
+      appendUint64(bytes, dataStart + data.size());
+      appendUint64(bytes, file.second.size());
+      bytes += file.first;
+
+      data += file.second;
+    }
+
+    bytes.resize(dataStart, '\0');
+    return bytes + data;
+  }
+
+  void write(const std::string& bytes) {
+    std::ofstream out(archivePath_, std::ios::binary);
+    out << bytes;
+  }
+
+  const std::filesystem::path archivePath_;
+
+private:
+  static size_t align(size_t offset) {
+    auto alignment = ResourceArchive::DATA_ALIGNMENT;
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+};
+
+TEST_F(ResourceArchiveTest, constructorShouldThrowIfTheArchiveDoesNotExist) {
+  EXPECT_THROW(ResourceArchive archive(archivePath_), std::system_error);
+}
+
+TEST_F(ResourceArchiveTest, constructorShouldThrowIfTheMagicBytesAreWrong) {
+  auto bytes = pack({{"ui/index.html", "<html></html>"}});
+  bytes[0] = 'X';
+  write(bytes);
+
+  EXPECT_THROW(ResourceArchive archive(archivePath_), std::runtime_error);
+}
+
+TEST_F(ResourceArchiveTest, constructorShouldThrowIfTheArchiveIsTruncated) {
+  auto bytes = pack({{"ui/index.html", "<html></html>"}});
+  bytes.resize(bytes.size() - 1);
+  write(bytes);
+
+  EXPECT_THROW(ResourceArchive archive(archivePath_), std::runtime_error);
+}
+
+TEST_F(ResourceArchiveTest, findShouldReturnTheDataOfEachFileInTheArchive) {
+  std::map<std::string, std::string> files{
+      {"ui/app.bundle.js", "console.log('loaded');"},
+      {"ui/css/style.css", "body {}"},
+      {"ui/empty.txt", ""},
+      {"ui/index.html", "<html></html>"},
+  };
+  write(pack(files));
+
+  ResourceArchive archive(archivePath_);
+
+  ASSERT_EQ(files.size(), archive.Size());
+  for (const auto& file : files) {
+    auto data = archive.Find(file.first);
+    ASSERT_TRUE(data.has_value());
+    EXPECT_EQ(file.second, data.value());
+  }
+}
+
+TEST_F(ResourceArchiveTest, findShouldReturnNothingIfAPathIsNotInTheArchive) {
+  write(pack({{"ui/index.html", "<html></html>"}}));
+
+  ResourceArchive archive(archivePath_);
+
+  EXPECT_FALSE(archive.Find("ui/missing.html").has_value());
+  EXPECT_FALSE(archive.Find("ui/INDEX.html").has_value());
+  EXPECT_FALSE(archive.Find("").has_value());
+}
+}
+}
+
+#endif
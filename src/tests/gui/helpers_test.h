@@ -98,6 +98,71 @@ TEST(CompareFilenames, shouldBeCaseInsensitiveAndLocaleInvariant) {
   // Reset locale.
   std::locale::global(boost::locale::generator().generate(""));
 }
+
+TEST(CompareFilenames, shouldOrderAsciiFilenamesLikeNonAsciiFilenames) {
+  // Appending the same non-ASCII suffix doesn't change the order of
+  // filenames that differ before their ends, but means they can't be
+  // compared as ASCII.
+  const std::vector<std::pair<std::string, std::string>> pairs({
+      {"Blank.esm", "blank.ESM"},
+      {"Blank.esm", "Blank.esp"},
+      {"Blank_1.esp", "BlankA.esp"},
+      {"Blank - Different.esm", "Blank.esm"},
+      {"[Blank].esp", "Blank.esp"},
+  });
+
+  for (const auto& pair : pairs) {
+    EXPECT_EQ(CompareFilenames(pair.first + u8"\u00C1",
+                               pair.second + u8"\u00C1"),
+              CompareFilenames(pair.first, pair.second))
+        << pair.first << " vs " << pair.second;
+  }
+
+  EXPECT_EQ(-1, CompareFilenames("Blank.esp", "Blank.esp.ghost"));
+  EXPECT_EQ(1, CompareFilenames("Blank.esp.ghost", "Blank.esp"));
+}
+
+TEST(CompareFilenames, shouldFindNonAsciiCharactersAnywhereInLongFilenames) {
+  EXPECT_EQ(0,
+            CompareFilenames(u8"Some Long Plugin Name \u00C1.esp",
+                             u8"some long plugin name \u00E1.esp"));
+  EXPECT_EQ(1,
+            CompareFilenames(u8"Some Long Plugin Name.esp",
+                             u8"Some Long Plugin Name \u00E1.esp"));
+}
+
+TEST(NormalizeFilename, shouldGiveEqualResultsForFilenamesThatCompareEqual) {
+  EXPECT_EQ(NormalizeFilename("Blank.esm"), NormalizeFilename("blank.ESM"));
+  EXPECT_EQ(NormalizeFilename(u8"non\u00C1scii.esp"),
+            NormalizeFilename(u8"non\u00E1scii.esp"));
+  EXPECT_NE(NormalizeFilename("i"), NormalizeFilename(u8"\u0130"));
+  EXPECT_NE(NormalizeFilename("i"), NormalizeFilename(u8"\u0131"));
+  EXPECT_EQ("", NormalizeFilename(""));
+}
+
+TEST(NormalizeFilename, shouldGiveTheSameResultForAsciiAndNonAsciiFilenames) {
+  auto asciiSuffixed = NormalizeFilename("Blank.esm") + u8"\u00E1";
+  EXPECT_EQ(NormalizeFilename(u8"Blank.esm\u00C1"), asciiSuffixed);
+}
+
+TEST(FilenameEqual, shouldGiveTheSameResultsAsCompareFilenames) {
+  FilenameEqual equal;
+
+  EXPECT_TRUE(equal("Blank.esm", "blank.ESM"));
+  EXPECT_FALSE(equal("Blank.esm", "Blank.esp"));
+  EXPECT_FALSE(equal("Blank.esm", "Blank.esm.ghost"));
+  EXPECT_TRUE(equal(u8"non\u00C1scii.esp", u8"non\u00E1scii.esp"));
+  EXPECT_FALSE(equal("i", u8"\u0130"));
+  EXPECT_TRUE(equal("", ""));
+}
+
+TEST(FilenameHash, shouldGiveEqualResultsForFilenamesThatAreEqual) {
+  FilenameHash hash;
+
+  EXPECT_EQ(hash("Blank.esm"), hash("blank.ESM"));
+  EXPECT_EQ(hash(u8"non\u00C1scii.esp"), hash(u8"non\u00E1scii.esp"));
+  EXPECT_NE(hash("Blank.esm"), hash("Blank.esp"));
+}
 }
 }
 
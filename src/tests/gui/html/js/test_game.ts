@@ -627,6 +627,151 @@ describe('Game', () => {
     });
   });
 
+  describe('#applySortDelta', () => {
+    let game: Game;
+
+    beforeEach(() => {
+      game = new Game(gameData, l10n);
+    });
+
+    test('should order plugins using the delta load order', () => {
+      const foo = new Plugin({ ...defaultDerivedPluginMetadata, name: 'foo' });
+      const bar = new Plugin({ ...defaultDerivedPluginMetadata, name: 'bar' });
+      game.plugins = [foo, bar];
+
+      game.applySortDelta({
+        generalMessages: [],
+        loadOrder: [{ name: 'bar', loadOrderIndex: 0 }, { name: 'foo' }],
+        plugins: []
+      });
+
+      expect(game.plugins).toEqual([bar, foo]);
+      expect(game.plugins[0].loadOrderIndex).toBe(0);
+      expect(game.plugins[1].loadOrderIndex).toBe(undefined);
+    });
+
+    test('should update changed plugins', () => {
+      const foo = new Plugin({ ...defaultDerivedPluginMetadata, name: 'foo' });
+      game.plugins = [foo];
+
+      game.applySortDelta({
+        generalMessages: [],
+        loadOrder: [{ name: 'foo' }],
+        plugins: [{ ...defaultDerivedPluginMetadata, name: 'foo', crc: 0xdead }]
+      });
+
+      expect(game.plugins[0]).toBe(foo);
+      expect(game.plugins[0].crc).toBe(0xdead);
+    });
+
+    test('should store old load order', () => {
+      const foo = new Plugin({ ...defaultDerivedPluginMetadata, name: 'foo' });
+      const bar = new Plugin({ ...defaultDerivedPluginMetadata, name: 'bar' });
+      game.plugins = [foo, bar];
+
+      game.applySortDelta({
+        generalMessages: [],
+        loadOrder: [{ name: 'bar' }, { name: 'foo' }],
+        plugins: []
+      });
+
+      expect(game.oldLoadOrder).toEqual([foo, bar]);
+    });
+  });
+
+  describe('#appendPlugins', () => {
+    test('should add the given plugins after the existing plugins', () => {
+      const game = new Game(gameData, l10n);
+      const foo = new Plugin({ ...defaultDerivedPluginMetadata, name: 'foo' });
+      game.plugins = [foo];
+
+      game.appendPlugins([{ ...defaultDerivedPluginMetadata, name: 'bar' }]);
+
+      expect(game.plugins.length).toBe(2);
+      expect(game.plugins[0]).toBe(foo);
+      expect(game.plugins[1].name).toBe('bar');
+    });
+  });
+
+  describe('#applyGameDataDelta', () => {
+    let game: Game;
+
+    beforeEach(() => {
+      game = new Game(gameData, l10n);
+    });
+
+    test('should set general data to the values in the delta', () => {
+      const messages = [
+        {
+          type: 'warn',
+          text: 'foo',
+          language: 'en',
+          condition: ''
+        }
+      ];
+
+      game.applyGameDataDelta({
+        ...gameData,
+        generalMessages: messages,
+        masterlist: { revision: '1', date: 'today' },
+        loadOrder: [],
+        plugins: []
+      });
+
+      expect(game.generalMessages).toEqual(messages);
+      expect(game.masterlist).toEqual({ revision: '1', date: 'today' });
+    });
+
+    test('should order plugins using the delta load order', () => {
+      const foo = new Plugin({ ...defaultDerivedPluginMetadata, name: 'foo' });
+      const bar = new Plugin({ ...defaultDerivedPluginMetadata, name: 'bar' });
+      game.plugins = [foo, bar];
+
+      game.applyGameDataDelta({
+        ...gameData,
+        loadOrder: [{ name: 'bar', loadOrderIndex: 0 }, { name: 'foo' }],
+        plugins: []
+      });
+
+      expect(game.plugins).toEqual([bar, foo]);
+      expect(game.plugins[0].loadOrderIndex).toBe(0);
+      expect(game.plugins[1].loadOrderIndex).toBe(undefined);
+    });
+
+    test('should update changed plugins and add new plugins', () => {
+      const foo = new Plugin({ ...defaultDerivedPluginMetadata, name: 'foo' });
+      game.plugins = [foo];
+
+      game.applyGameDataDelta({
+        ...gameData,
+        loadOrder: [{ name: 'foo' }, { name: 'bar' }],
+        plugins: [
+          { ...defaultDerivedPluginMetadata, name: 'foo', crc: 0xdeadbeef },
+          { ...defaultDerivedPluginMetadata, name: 'bar' }
+        ]
+      });
+
+      expect(game.plugins.length).toBe(2);
+      expect(game.plugins[0]).toBe(foo);
+      expect(game.plugins[0].crc).toBe(0xdeadbeef);
+      expect(game.plugins[1].name).toBe('bar');
+    });
+
+    test('should remove plugins that are not in the delta load order', () => {
+      game.plugins = [
+        new Plugin({ ...defaultDerivedPluginMetadata, name: 'foo' })
+      ];
+
+      game.applyGameDataDelta({
+        ...gameData,
+        loadOrder: [],
+        plugins: []
+      });
+
+      expect(game.plugins).toEqual([]);
+    });
+  });
+
   describe('#applySort', () => {
     let game: Game;
 
@@ -2,7 +2,10 @@ import { mocked } from 'ts-jest/utils';
 import {
   getVersion,
   getInitErrors,
-  getConflictingPlugins
+  getConflictingPlugins,
+  getGameDataInChunks,
+  sortPlugins,
+  cancelLongRunningQueries
 } from '../../../../gui/html/js/query';
 
 describe('query()', () => {
@@ -44,3 +47,115 @@ describe('query()', () => {
       expect(error).toEqual(new Error('error message'));
     }));
 });
+
+describe('chunkedQuery()', () => {
+  beforeAll(() => {
+    window.cefQuery = jest
+      .fn()
+      .mockImplementation(({ persistent, onSuccess }) => {
+        expect(persistent).toBe(true);
+        onSuccess('{"folder": "Skyrim", "plugins": [{"name": "a.esp"}]}');
+        onSuccess('{"plugins": [{"name": "b.esp"}, {"name": "c.esp"}]}');
+        onSuccess('{"complete":true}');
+        return 1;
+      });
+    window.cefQueryCancel = jest.fn();
+  });
+
+  beforeEach(() => {
+    mocked(window.cefQuery).mockClear();
+    mocked(window.cefQueryCancel).mockClear();
+  });
+
+  test('should pass each chunk to the callbacks in order', () => {
+    const chunks: string[][] = [];
+
+    return getGameDataInChunks(
+      gameData => {
+        expect(gameData.folder).toBe('Skyrim');
+        chunks.push(gameData.plugins.map(plugin => plugin.name));
+      },
+      plugins => {
+        chunks.push(plugins.map(plugin => plugin.name));
+      }
+    ).then(() => {
+      expect(chunks).toEqual([['a.esp'], ['b.esp', 'c.esp']]);
+    });
+  });
+
+  test('should cancel the query once the response is complete', () =>
+    getGameDataInChunks(() => {}, () => {}).then(() => {
+      expect(mocked(window.cefQueryCancel).mock.calls).toEqual([[1]]);
+    }));
+});
+
+describe('cancelLongRunningQueries()', () => {
+  const pendingFailures = new Map<number, (code: number, msg: string) => void>();
+
+  beforeAll(() => {
+    /* LOOT doesn't see the IDs that cefQuery returns, so they're made to
+    differ from the cancellation IDs that the UI sends. */
+    let nextQueryId = 100;
+    window.cefQuery = jest
+      .fn()
+      .mockImplementation(({ request, onSuccess, onFailure }) => {
+        const queryId = nextQueryId;
+        nextQueryId += 1;
+
+        const { name, cancellationId } = JSON.parse(request);
+        if (name === 'sortPlugins') {
+          pendingFailures.set(cancellationId, onFailure);
+        } else if (name === 'cancelQuery') {
+          const fail = pendingFailures.get(cancellationId);
+          if (fail) {
+            fail(-2, 'The query was cancelled.');
+          }
+          onSuccess('');
+        }
+
+        return queryId;
+      });
+  });
+
+  test('should send the cancellation ID that the query was sent with', () => {
+    mocked(window.cefQuery).mockClear();
+    const sortPromise = sortPlugins().catch(() => {});
+
+    return cancelLongRunningQueries()
+      .then(() => sortPromise)
+      .then(() => {
+        const requests = mocked(window.cefQuery).mock.calls.map(call =>
+          JSON.parse(call[0].request)
+        );
+        expect(requests.length).toBe(2);
+        expect(requests[0].cancellationId).toBeDefined();
+        expect(requests[1]).toEqual({
+          name: 'cancelQuery',
+          cancellationId: requests[0].cancellationId
+        });
+      });
+  });
+
+  test('should cancel in-progress long-running queries', () => {
+    const sortPromise = sortPlugins();
+
+    return cancelLongRunningQueries()
+      .then(() => sortPromise)
+      .then(
+        () => {
+          throw new Error('Expected sortPlugins() to fail');
+        },
+        error => {
+          expect(error.name).toBe('QueryCancelledError');
+        }
+      );
+  });
+
+  test('should not send anything if no queries are in progress', () => {
+    mocked(window.cefQuery).mockClear();
+
+    return cancelLongRunningQueries().then(() => {
+      expect(mocked(window.cefQuery).mock.calls.length).toBe(0);
+    });
+  });
+});
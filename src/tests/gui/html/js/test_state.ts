@@ -274,4 +274,80 @@ describe('State', () => {
       expect(mocked(DOM.setUIState).mock.calls.length).toBe(0);
     });
   });
+
+  describe('enterProvisionalState()', () => {
+    test('should disable game operations and set the UI state', () => {
+      const state = new State();
+
+      state.enterProvisionalState();
+
+      expect(state.isInDefaultState()).toBe(false);
+      expect(state.isInProvisionalState()).toBe(true);
+
+      expect(mocked(DOM.enable).mock.calls).toEqual([
+        ['wipeUserlistButton', false],
+        ['groupsEditorButton', false],
+        ['refreshContentButton', false],
+        ['settingsButton', false],
+        ['gameMenu', false],
+        ['updateMasterlistButton', false],
+        ['sortButton', false]
+      ]);
+      expect(mocked(DOM.setUIState).mock.calls).toEqual([['provisional']]);
+    });
+
+    test('should throw an error if called in the sorting state', () => {
+      const state = new State();
+      state.enterSortingState();
+
+      expect(() => {
+        state.enterProvisionalState();
+      }).toThrow(Error);
+    });
+
+    test('should prevent entering the sorting and editing states', () => {
+      const state = new State();
+      state.enterProvisionalState();
+
+      expect(() => {
+        state.enterSortingState();
+      }).toThrow(Error);
+      expect(() => {
+        state.enterEditingState();
+      }).toThrow(Error);
+    });
+  });
+
+  describe('exitProvisionalState()', () => {
+    test('should re-enable game operations and reset the UI state', () => {
+      const state = new State();
+      state.enterProvisionalState();
+
+      clearMocks();
+
+      state.exitProvisionalState();
+
+      expect(state.isInDefaultState()).toBe(true);
+      expect(state.isInProvisionalState()).toBe(false);
+
+      expect(mocked(DOM.enable).mock.calls).toEqual([
+        ['wipeUserlistButton'],
+        ['groupsEditorButton'],
+        ['refreshContentButton'],
+        ['settingsButton'],
+        ['gameMenu'],
+        ['updateMasterlistButton'],
+        ['sortButton']
+      ]);
+      expect(mocked(DOM.setUIState).mock.calls).toEqual([['default']]);
+    });
+
+    test('should have no effect if not in the provisional state', () => {
+      const state = new State();
+      state.exitProvisionalState();
+
+      expect(mocked(DOM.enable).mock.calls.length).toBe(0);
+      expect(mocked(DOM.setUIState).mock.calls.length).toBe(0);
+    });
+  });
 });
@@ -26,17 +26,50 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/null_sink.h>
 
+#include "tests/gui/batch_sort_test.h"
+#include "tests/gui/cef/query/active_queries_test.h"
+#include "tests/gui/cef/query/command_line_forwarding_test.h"
+#include "tests/gui/cef/query/derivation_context_test.h"
+#include "tests/gui/cef/query/game_data_snapshot_test.h"
 #include "tests/gui/cef/query/json_test.h"
+#include "tests/gui/cef/query/json_writer_test.h"
+#include "tests/gui/cef/query/load_order_formatter_test.h"
+#include "tests/gui/cef/query/local_socket_test.h"
+#include "tests/gui/cef/query/progress_channel_test.h"
+#include "tests/gui/cef/query/query_recording_test.h"
+#include "tests/gui/cef/query/query_server_test.h"
+#include "tests/gui/cef/query/query_worker_pool_test.h"
 #include "tests/gui/cef/query/types/close_settings_query_test.h"
 #include "tests/gui/cef/query/types/editor_closed_query_test.h"
+#include "tests/gui/cef/query/types/get_performance_stats_query_test.h"
 #include "tests/gui/cef/query/types/get_settings_query_test.h"
 #include "tests/gui/cef/query/types/get_themes_query_test.h"
+#include "tests/gui/cef/resource_archive_test.h"
+#include "tests/gui/state/game/bash_tag_set_test.h"
+#include "tests/gui/state/game/condition_dependency_index_test.h"
+#include "tests/gui/state/game/game_scale_test.h"
 #include "tests/gui/state/game/game_settings_test.h"
 #include "tests/gui/state/game/game_test.h"
 #include "tests/gui/state/game/games_manager_test.h"
 #include "tests/gui/state/game/helpers_test.h"
+#include "tests/gui/state/game/mapped_plugin_file_test.h"
+#include "tests/gui/state/game/master_graph_test.h"
+#include "tests/gui/state/game/message_templates_test.h"
+#include "tests/gui/state/game/plugin_name_table_test.h"
+#include "tests/gui/state/game/plugin_validity_cache_test.h"
+#include "tests/gui/state/game/sort_result_cache_test.h"
+#include "tests/gui/state/game/string_pool_test.h"
+#include "tests/gui/state/auto_sort_test.h"
+#include "tests/gui/state/cache_registry_test.h"
+#include "tests/gui/state/debounced_task_test.h"
+#include "tests/gui/state/file_watcher_test.h"
+#include "tests/gui/state/locale_cache_test.h"
+#include "tests/gui/state/log_bridge_test.h"
 #include "tests/gui/state/loot_paths_test.h"
 #include "tests/gui/state/loot_settings_test.h"
+#include "tests/gui/state/memory_accounting_test.h"
+#include "tests/gui/state/startup_report_test.h"
+#include "tests/gui/state/timing_test.h"
 #include "tests/gui/state/unapplied_change_counter_test.h"
 #include "tests/gui/helpers_test.h"
 
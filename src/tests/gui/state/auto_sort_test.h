@@ -0,0 +1,124 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_AUTO_SORT_TEST
+#define LOOT_TESTS_GUI_STATE_AUTO_SORT_TEST
+
+#include <fstream>
+
+#include "gui/state/auto_sort.h"
+
+#include "gui/state/game/helpers.h"
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace test {
+class AutoSortTest : public CommonGameTestFixture {
+protected:
+  AutoSortTest() :
+      game_(GameSettings(GetParam(), "folder")
+                .SetMinimumHeaderVersion(0.0f)
+                .SetGamePath(dataPath.parent_path())
+                .SetGameLocalPath(localPath),
+            lootDataPath) {}
+
+  void SetUp() override { game_.Init(); }
+
+  void TearDown() { CommonGameTestFixture::TearDown(); }
+
+  void WriteUserlistWithAnErrorMessage() {
+    std::filesystem::create_directories(game_.UserlistPath().parent_path());
+    std::ofstream out(game_.UserlistPath());
+    out << "plugins:" << std::endl
+        << "  - name: " << blankEsp << std::endl
+        << "    msg:" << std::endl
+        << "      - type: error" << std::endl
+        << "        content: 'error'" << std::endl;
+  }
+
+  gui::Game game_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        AutoSortTest,
+                        ::testing::Values(GameType::tes4, GameType::fo4));
+
+TEST_P(AutoSortTest, hasErrorMessagesShouldBeFalseIfThereAreNoErrors) {
+  game_.LoadAllInstalledPluginsAndMetadata(true, false);
+
+  EXPECT_FALSE(HasErrorMessages(game_));
+}
+
+TEST_P(AutoSortTest, hasErrorMessagesShouldBeTrueIfAGeneralMessageIsAnError) {
+  game_.LoadAllInstalledPluginsAndMetadata(true, false);
+  game_.AppendMessage(PlainTextMessage(MessageType::error, "error"));
+
+  EXPECT_TRUE(HasErrorMessages(game_));
+}
+
+TEST_P(AutoSortTest,
+       hasErrorMessagesShouldBeTrueIfAPluginsMetadataHasAnErrorMessage) {
+  game_.LoadAllInstalledPluginsAndMetadata(true, false);
+
+  PluginMetadata metadata(blankEsp);
+  metadata.SetMessages({PlainTextMessage(MessageType::error, "error")});
+  game_.AddUserMetadata(metadata);
+
+  EXPECT_TRUE(HasErrorMessages(game_));
+}
+
+TEST_P(AutoSortTest, hasErrorMessagesShouldIgnoreMessagesThatAreNotErrors) {
+  game_.LoadAllInstalledPluginsAndMetadata(true, false);
+
+  PluginMetadata metadata(blankEsp);
+  metadata.SetMessages({PlainTextMessage(MessageType::warn, "warning")});
+  game_.AddUserMetadata(metadata);
+  game_.AppendMessage(PlainTextMessage(MessageType::say, "note"));
+
+  EXPECT_FALSE(HasErrorMessages(game_));
+}
+
+TEST_P(AutoSortTest, autoSortShouldApplyTheSortedLoadOrder) {
+  EXPECT_TRUE(AutoSort(game_, false));
+
+  EXPECT_EQ(game_.SortPlugins(), game_.GetLoadOrder());
+}
+
+TEST_P(AutoSortTest,
+       autoSortShouldNotChangeTheLoadOrderIfThereAreErrorsBeforeSorting) {
+  WriteUserlistWithAnErrorMessage();
+  const auto loadOrder = getLoadOrder();
+
+  EXPECT_FALSE(AutoSort(game_, false));
+
+  EXPECT_EQ(loadOrder, getLoadOrder());
+  EXPECT_TRUE(HasErrorMessages(game_));
+}
+}
+}
+
+#endif
@@ -0,0 +1,186 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_CACHE_REGISTRY_TEST
+#define LOOT_TESTS_GUI_STATE_CACHE_REGISTRY_TEST
+
+#include "gui/state/cache_registry.h"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class CacheRegistryTest : public ::testing::Test {
+protected:
+  // A cache that evicts whole entries of the given sizes from the front.
+  struct TestCache {
+    std::uintmax_t Size() const {
+      std::uintmax_t size = 0;
+      for (const auto entrySize : entrySizes) {
+        size += entrySize;
+      }
+      return size;
+    }
+
+    std::uintmax_t Evict(std::uintmax_t targetBytes) {
+      std::uintmax_t freedBytes = 0;
+      while (!entrySizes.empty() && Size() > targetBytes) {
+        freedBytes += entrySizes.front();
+        entrySizes.erase(entrySizes.begin());
+      }
+      return freedBytes;
+    }
+
+    std::vector<std::uintmax_t> entrySizes;
+  };
+
+  CacheRegistry::Registration Register(const std::string& name,
+                                       TestCache& cache) {
+    return registry_.Register(
+        name,
+        [&cache]() { return cache.Size(); },
+        [&cache](std::uintmax_t targetBytes) {
+          return cache.Evict(targetBytes);
+        });
+  }
+
+  CacheRegistry registry_;
+};
+
+TEST_F(CacheRegistryTest, budgetShouldBeUnlimitedByDefault) {
+  TestCache cache{{100, 200}};
+  auto registration = Register("cache", cache);
+
+  EXPECT_EQ(0, registry_.GetBudget());
+  EXPECT_EQ(0, registry_.EnforceBudget());
+  EXPECT_EQ(300, cache.Size());
+}
+
+TEST_F(CacheRegistryTest, enforceBudgetShouldDoNothingIfCachesFitInTheBudget) {
+  TestCache cache{{100, 200}};
+  auto registration = Register("cache", cache);
+  registry_.SetBudget(300);
+
+  EXPECT_EQ(0, registry_.EnforceBudget());
+  EXPECT_EQ(300, cache.Size());
+}
+
+TEST_F(CacheRegistryTest, enforceBudgetShouldEvictFromTheLargestCacheFirst) {
+  TestCache small{{100}};
+  TestCache large{{200, 200}};
+  auto smallRegistration = Register("small", small);
+  auto largeRegistration = Register("large", large);
+  registry_.SetBudget(300);
+
+  EXPECT_EQ(200, registry_.EnforceBudget());
+  EXPECT_EQ(100, small.Size());
+  EXPECT_EQ(200, large.Size());
+}
+
+TEST_F(CacheRegistryTest,
+       enforceBudgetShouldEvictFromSmallerCachesIfTheLargestIsNotEnough) {
+  TestCache small{{100, 100}};
+  TestCache large{{300}};
+  auto smallRegistration = Register("small", small);
+  auto largeRegistration = Register("large", large);
+  registry_.SetBudget(50);
+
+  EXPECT_EQ(500, registry_.EnforceBudget());
+  EXPECT_EQ(0, small.Size());
+  EXPECT_EQ(0, large.Size());
+}
+
+TEST_F(CacheRegistryTest, evictAllShouldEvictEverythingEvenWithNoBudget) {
+  TestCache first{{100}};
+  TestCache second{{200, 300}};
+  auto firstRegistration = Register("first", first);
+  auto secondRegistration = Register("second", second);
+
+  EXPECT_EQ(600, registry_.EvictAll());
+  EXPECT_EQ(0, first.Size());
+  EXPECT_EQ(0, second.Size());
+}
+
+TEST_F(CacheRegistryTest, destroyingARegistrationShouldUnregisterItsCache) {
+  TestCache cache{{100, 200}};
+  {
+    auto registration = Register("cache", cache);
+  }
+
+  EXPECT_EQ(0, registry_.EvictAll());
+  EXPECT_EQ(300, cache.Size());
+}
+
+TEST_F(CacheRegistryTest, movedRegistrationsShouldStayRegistered) {
+  TestCache cache{{100, 200}};
+  CacheRegistry::Registration registration;
+  registration = Register("cache", cache);
+
+  EXPECT_EQ(300, registry_.EvictAll());
+}
+
+TEST_F(CacheRegistryTest, getStatsShouldSumSizesAndEvictionsByName) {
+  TestCache first{{100, 100}};
+  TestCache second{{200}};
+  TestCache other{{50}};
+  auto firstRegistration = Register("cache", first);
+  auto secondRegistration = Register("cache", second);
+  auto otherRegistration = Register("other", other);
+  registry_.SetBudget(300);
+
+  registry_.EnforceBudget();
+  auto stats = registry_.GetStats();
+
+  ASSERT_EQ(2, stats.size());
+  EXPECT_EQ("cache", stats[0].name);
+  EXPECT_EQ(200, stats[0].estimatedBytes);
+  EXPECT_EQ(1, stats[0].evictionCount);
+  EXPECT_EQ(200, stats[0].evictedBytes);
+  EXPECT_EQ("other", stats[1].name);
+  EXPECT_EQ(50, stats[1].estimatedBytes);
+  EXPECT_EQ(0, stats[1].evictionCount);
+  EXPECT_EQ(0, stats[1].evictedBytes);
+}
+
+TEST_F(CacheRegistryTest, getStatsShouldKeepTheStatsOfUnregisteredCaches) {
+  TestCache cache{{100}};
+  {
+    auto registration = Register("cache", cache);
+    registry_.EvictAll();
+  }
+
+  auto stats = registry_.GetStats();
+
+  ASSERT_EQ(1, stats.size());
+  EXPECT_EQ(0, stats[0].estimatedBytes);
+  EXPECT_EQ(1, stats[0].evictionCount);
+  EXPECT_EQ(100, stats[0].evictedBytes);
+}
+}
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_DEBOUNCED_TASK_TEST
+#define LOOT_TESTS_GUI_STATE_DEBOUNCED_TASK_TEST
+
+#include "gui/state/debounced_task.h"
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+TEST(DebouncedTask, shouldNotRunTheTaskIfItIsNotScheduled) {
+  std::atomic<int> runCount(0);
+  {
+    DebouncedTask task(std::chrono::milliseconds(10), [&]() { ++runCount; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  EXPECT_EQ(0, runCount);
+}
+
+TEST(DebouncedTask, shouldRunTheTaskOnceAfterItIsScheduledManyTimes) {
+  std::atomic<int> runCount(0);
+  DebouncedTask task(std::chrono::milliseconds(100), [&]() { ++runCount; });
+
+  for (int i = 0; i < 5; ++i) {
+    task.Schedule();
+  }
+  ASSERT_TRUE(waitUntil([&]() { return runCount > 0; }));
+
+  // Nothing is scheduled, so this only waits for the run to finish.
+  task.Flush();
+  EXPECT_EQ(1, runCount);
+}
+
+TEST(DebouncedTask, flushShouldRunAScheduledTaskImmediately) {
+  std::atomic<int> runCount(0);
+  DebouncedTask task(std::chrono::seconds(60), [&]() { ++runCount; });
+
+  task.Schedule();
+  task.Flush();
+  EXPECT_EQ(1, runCount);
+
+  task.Flush();
+  EXPECT_EQ(1, runCount);
+}
+
+TEST(DebouncedTask, destructorShouldRunAScheduledTask) {
+  std::atomic<int> runCount(0);
+  {
+    DebouncedTask task(std::chrono::seconds(60), [&]() { ++runCount; });
+    task.Schedule();
+  }
+
+  EXPECT_EQ(1, runCount);
+}
+
+TEST(DebouncedTask, shouldKeepRunningAfterTheTaskThrows) {
+  std::atomic<int> runCount(0);
+  DebouncedTask task(std::chrono::milliseconds(10), [&]() {
+    ++runCount;
+    throw std::runtime_error("error");
+  });
+
+  task.Schedule();
+  ASSERT_TRUE(waitUntil([&]() { return runCount == 1; }));
+  task.Schedule();
+
+  EXPECT_TRUE(waitUntil([&]() { return runCount == 2; }));
+}
+}
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_FILE_WATCHER_TEST
+#define LOOT_TESTS_GUI_STATE_FILE_WATCHER_TEST
+
+#include "gui/state/file_watcher.h"
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class FileWatcherTest : public ::testing::Test {
+protected:
+  FileWatcherTest() :
+      directory_(std::filesystem::absolute("./testing-file-watcher")) {}
+
+  void SetUp() override {
+    std::filesystem::remove_all(directory_);
+    std::filesystem::create_directory(directory_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  FileWatcher::Callback recordChanges() {
+    return [this](const std::vector<std::filesystem::path>& paths) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      changes_.push_back(paths);
+      changed_.notify_all();
+    };
+  }
+
+  std::vector<std::vector<std::filesystem::path>> waitForChanges() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait_for(
+        lock, std::chrono::seconds(5), [this]() { return !changes_.empty(); });
+    return changes_;
+  }
+
+  const std::filesystem::path directory_;
+
+private:
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::vector<std::vector<std::filesystem::path>> changes_;
+};
+
+TEST_F(FileWatcherTest, shouldPassChangedFilesToTheCallbackTogether) {
+  FileWatcher watcher(
+      {directory_}, std::chrono::milliseconds(200), recordChanges());
+
+  std::ofstream(directory_ / "Blank.esp") << "a";
+  std::ofstream(directory_ / "plugins.txt") << "b";
+
+  auto changes = waitForChanges();
+
+  ASSERT_EQ(1, changes.size());
+  EXPECT_EQ(std::vector<std::filesystem::path>({
+                directory_ / "Blank.esp",
+                directory_ / "plugins.txt",
+            }),
+            changes[0]);
+}
+
+TEST_F(FileWatcherTest, shouldIgnoreDirectoriesThatDoNotExist) {
+  FileWatcher watcher({directory_ / "missing", directory_},
+                      std::chrono::milliseconds(200),
+                      recordChanges());
+
+  std::ofstream(directory_ / "Blank.esp") << "a";
+
+  auto changes = waitForChanges();
+
+  ASSERT_EQ(1, changes.size());
+  EXPECT_EQ(std::vector<std::filesystem::path>({directory_ / "Blank.esp"}),
+            changes[0]);
+}
+
+TEST_F(FileWatcherTest, destructorShouldStopWatchingWithoutAnyChanges) {
+  EXPECT_NO_THROW(FileWatcher(
+      {directory_}, std::chrono::milliseconds(200), recordChanges()));
+}
+}
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_BASH_TAG_SET_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_BASH_TAG_SET_TEST
+
+#include "gui/state/game/bash_tag_set.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+class BashTagSetTest : public ::testing::Test {
+protected:
+  BashTagSetTest() :
+      table_(std::make_shared<BashTagTable>(
+          std::set<std::string>({"Relev", "C.Water", "Delev"}))) {}
+
+  std::shared_ptr<const BashTagTable> table_;
+};
+
+TEST_F(BashTagSetTest, tableIdsShouldBeIndicesInTheSortedListOfKnownTags) {
+  EXPECT_EQ(3, table_->size());
+  EXPECT_EQ(0, table_->GetId("C.Water"));
+  EXPECT_EQ(1, table_->GetId("Delev"));
+  EXPECT_EQ(2, table_->GetId("Relev"));
+  EXPECT_EQ("Delev", table_->GetName(1));
+  EXPECT_FALSE(table_->GetId("Unknown").has_value());
+}
+
+TEST_F(BashTagSetTest, toTagsShouldRoundTripTheTagsThatTheSetWasCreatedWith) {
+  std::set<Tag> tags({
+      Tag("Relev"),
+      Tag("Delev", false),
+      Tag("C.Water", true, "file(\"a.esp\")"),
+      Tag("Unknown"),
+  });
+  BashTagSet set(table_, tags);
+
+  EXPECT_FALSE(set.empty());
+  EXPECT_EQ(tags, set.ToTags());
+}
+
+TEST_F(BashTagSetTest, addingAnAdditionAndARemovalOfTheSameTagShouldKeepBoth) {
+  BashTagSet set(table_);
+  set.Add(Tag("Relev"));
+  set.Add(Tag("Relev", false));
+
+  EXPECT_EQ(std::set<Tag>({Tag("Relev"), Tag("Relev", false)}),
+            set.ToTags());
+}
+
+TEST_F(BashTagSetTest, forEachShouldVisitTagsInTheSameOrderAsASetOfTags) {
+  std::set<Tag> tags({
+      Tag("Relev"),
+      Tag("Delev", false),
+      Tag("Actors.ACBS"),
+      Tag("Unknown", false),
+      Tag("C.Water", true, "file(\"a.esp\")"),
+      Tag("C.Water"),
+  });
+  BashTagSet set(table_, tags);
+
+  std::vector<Tag> visitedTags;
+  set.ForEach([&](const Tag& tag) { visitedTags.push_back(tag); });
+
+  EXPECT_EQ(std::vector<Tag>(tags.begin(), tags.end()), visitedTags);
+}
+
+TEST_F(BashTagSetTest, aSetWithNoTagsShouldBeEmpty) {
+  EXPECT_TRUE(BashTagSet(table_).empty());
+  EXPECT_TRUE(BashTagSet(std::make_shared<BashTagTable>()).empty());
+}
+}
+}
+}
+
+#endif
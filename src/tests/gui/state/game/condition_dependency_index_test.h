@@ -0,0 +1,121 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_CONDITION_DEPENDENCY_INDEX_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_CONDITION_DEPENDENCY_INDEX_TEST
+
+#include "gui/state/game/condition_dependency_index.h"
+
+#include <gtest/gtest.h>
+
+#include "gui/helpers.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+inline std::unordered_set<std::string> normalizeNames(
+    const std::unordered_set<std::string>& names) {
+  std::unordered_set<std::string> normalizedNames;
+  for (const auto& name : names) {
+    normalizedNames.insert(NormalizeFilename(name));
+  }
+  return normalizedNames;
+}
+
+TEST(ConditionDependencyIndex,
+     getDependentsShouldReturnPluginsWithConditionsOnTheChangedNames) {
+  ConditionDependencyIndex index;
+  index.AddCondition(0, "file(\"Blank.esm\") and not active(\"Blank.esp\")");
+  index.AddCondition(1, "checksum(\"other.txt\", DEADBEEF)");
+  index.AddCondition(2, "version(\"Blank.esp\", \"1.0\", ==)");
+
+  EXPECT_EQ(std::unordered_set<PluginId>({0}),
+            index.GetDependents(normalizeNames({"blank.esm"})));
+  EXPECT_EQ(std::unordered_set<PluginId>({0, 2}),
+            index.GetDependents(normalizeNames({"blank.esp"})));
+  EXPECT_EQ(std::unordered_set<PluginId>({0, 1, 2}),
+            index.GetDependents(
+                normalizeNames({"blank.esm", "other.txt", "blank.esp"})));
+  EXPECT_TRUE(index.GetDependents(normalizeNames({"unrelated.esp"})).empty());
+}
+
+TEST(ConditionDependencyIndex,
+     getDependentsShouldReturnPluginsThatDependOnAFileInAChangedDirectory) {
+  ConditionDependencyIndex index;
+  index.AddCondition(0, "file(\"Textures/Blank.dds\")");
+  index.AddCondition(1, "file(\"Meshes/.+\\.nif\")");
+
+  EXPECT_EQ(std::unordered_set<PluginId>({0}),
+            index.GetDependents(normalizeNames({"textures"})));
+  EXPECT_EQ(std::unordered_set<PluginId>({1}),
+            index.GetDependents(normalizeNames({"meshes"})));
+}
+
+TEST(ConditionDependencyIndex,
+     getDependentsShouldReturnPluginsWithConditionsThatCouldMatchAnyFile) {
+  ConditionDependencyIndex index;
+  index.AddCondition(0, "many(\"Blank.*\\.esp\")");
+  index.AddCondition(1, "file(\"Blank.*\\.esp\")");
+  index.AddCondition(2, "file(\"../SKSE/skse.ini\")");
+  index.AddCondition(3, "file(\"Blank.esm\")");
+
+  EXPECT_EQ(std::unordered_set<PluginId>({0, 1, 2}),
+            index.GetDependents(normalizeNames({"unrelated.esp"})));
+  EXPECT_TRUE(index.GetDependents({}).empty());
+}
+
+TEST(ConditionDependencyIndex,
+     getDependentsShouldReturnPluginsThatDependOnAFile) {
+  ConditionDependencyIndex index;
+  index.AddFile(0, "Blank.esm");
+
+  EXPECT_EQ(std::unordered_set<PluginId>({0}),
+            index.GetDependents(normalizeNames({"blank.esm"})));
+}
+
+TEST(ConditionDependencyIndex, hasPluginShouldBeTrueOnlyForIndexedPlugins) {
+  ConditionDependencyIndex index;
+  index.AddPlugin(0);
+  index.AddCondition(1, "");
+
+  EXPECT_TRUE(index.HasPlugin(0));
+  EXPECT_TRUE(index.HasPlugin(1));
+  EXPECT_FALSE(index.HasPlugin(2));
+}
+
+TEST(ConditionDependencyIndex,
+     getKeyShouldNormaliseNamesAndRemoveGhostExtensions) {
+  EXPECT_EQ(NormalizeFilename("Blank.esm"),
+            ConditionDependencyIndex::GetKey("Blank.esm.ghost"));
+  EXPECT_EQ(NormalizeFilename("Textures"),
+            ConditionDependencyIndex::GetKey("Textures\\Blank.dds"));
+  EXPECT_FALSE(ConditionDependencyIndex::GetKey("../Blank.esm").has_value());
+  EXPECT_FALSE(ConditionDependencyIndex::GetKey("C:/Blank.esm").has_value());
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_GAME_SCALE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_GAME_SCALE_TEST
+
+#include <algorithm>
+
+#include "gui/cef/query/types/get_game_data_query.h"
+#include "gui/state/game/game.h"
+#include "gui/state/timing.h"
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+// These tests check that operations that should only be done once for a load
+// order of hundreds of plugins aren't done once per plugin, by counting the
+// operations' timing events.
+class GameScaleTest : public loot::test::CommonGameTestFixture {
+protected:
+  GameScaleTest() :
+      defaultGameSettings(GameSettings(GetParam(), "folder")
+                              .SetMinimumHeaderVersion(0.0f)
+                              .SetGamePath(dataPath.parent_path())
+                              .SetGameLocalPath(localPath)) {}
+
+  void SetUp() override {
+    loot::test::SyntheticPluginOptions options;
+    options.pluginCount = 200;
+    syntheticPlugins_ = createSyntheticPlugins(options);
+  }
+
+  Game CreateLoadedGame() {
+    Game game(defaultGameSettings, lootDataPath);
+    game.Init();
+    loot::test::writeSyntheticMetadataLists(game.MasterlistPath(),
+                                            game.UserlistPath(),
+                                            masterFile,
+                                            syntheticPlugins_,
+                                            10);
+    game.LoadAllInstalledPluginsAndMetadata(true, false);
+
+    GetTimingRecorder().Clear();
+
+    return game;
+  }
+
+  static size_t countEvents(const std::string& name) {
+    const auto events = GetTimingRecorder().GetEvents();
+    return std::count_if(
+        events.begin(), events.end(), [&](const TimingEvent& event) {
+          return name == event.name;
+        });
+  }
+
+  std::vector<std::string> syntheticPlugins_;
+
+  const GameSettings defaultGameSettings;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        GameScaleTest,
+                        ::testing::Values(GameType::tes4,
+                                          GameType::tes5,
+                                          GameType::fo4,
+                                          GameType::tes5se));
+
+TEST_P(GameScaleTest, syntheticPluginsShouldBeLoadedInTheirLoadOrder) {
+  Game game = CreateLoadedGame();
+
+  EXPECT_EQ(12 + syntheticPlugins_.size(), game.PluginCount());
+
+  auto loadOrder = game.GetLoadOrder();
+  ASSERT_LE(syntheticPlugins_.size(), loadOrder.size());
+  EXPECT_TRUE(std::equal(syntheticPlugins_.begin(),
+                         syntheticPlugins_.end(),
+                         loadOrder.end() - syntheticPlugins_.size()));
+
+  // The 10th plugin is ghosted and the 4th is a light master.
+  EXPECT_NE(nullptr, game.GetPlugin(syntheticPlugins_[9]));
+  const bool supportsLightMasters =
+      GetParam() == GameType::fo4 || GetParam() == GameType::tes5se;
+  EXPECT_EQ(supportsLightMasters,
+            game.GetPlugin(syntheticPlugins_[3])->IsLightMaster());
+  EXPECT_FALSE(game.GetPlugin(syntheticPlugins_[2])->IsLightMaster());
+
+  EXPECT_TRUE(game.IsPluginActive(syntheticPlugins_[1]));
+  EXPECT_FALSE(game.IsPluginActive(syntheticPlugins_[0]));
+}
+
+TEST_P(GameScaleTest,
+       getActiveLoadOrderIndexShouldCountActivePluginsOnceForAllPlugins) {
+  Game game = CreateLoadedGame();
+
+  std::vector<short> indices;
+  for (const auto& plugin : game.GetPlugins()) {
+    auto index = game.GetActiveLoadOrderIndex(plugin);
+    if (index.has_value() && !plugin->IsLightMaster()) {
+      indices.push_back(index.value());
+    }
+  }
+
+  EXPECT_GE(1, countEvents("Game::GetActiveLoadOrderIndices"));
+  EXPECT_GE(1, countEvents("Game::GetActivePlugins"));
+
+  std::sort(indices.begin(), indices.end());
+  EXPECT_EQ(indices.end(), std::unique(indices.begin(), indices.end()));
+}
+
+TEST_P(GameScaleTest,
+       getActiveLoadOrderIndexWithALoadOrderShouldCountOnceForAllPlugins) {
+  Game game = CreateLoadedGame();
+  auto loadOrder = game.GetLoadOrder();
+  std::reverse(loadOrder.begin(), loadOrder.end());
+
+  for (const auto& plugin : game.GetPlugins()) {
+    game.GetActiveLoadOrderIndex(plugin, loadOrder);
+  }
+
+  EXPECT_EQ(1, countEvents("Game::GetActiveLoadOrderIndices"));
+  EXPECT_GE(1, countEvents("Game::GetActivePlugins"));
+}
+
+TEST_P(GameScaleTest,
+       checkInstallValidityShouldReadGroupsAndActivePluginsOnceForAllPlugins) {
+  Game game = CreateLoadedGame();
+
+  for (const auto& plugin : game.GetPlugins()) {
+    auto metadata = game.GetMasterlistMetadata(plugin->GetName(), true);
+    game.CheckInstallValidity(
+        plugin, metadata.value_or(PluginMetadata(plugin->GetName())));
+  }
+
+  EXPECT_GE(1, countEvents("Game::GetGroupIndex"));
+  EXPECT_GE(1, countEvents("Game::GetActivePlugins"));
+}
+
+TEST_P(GameScaleTest,
+       unevaluatedMetadataLookupsShouldUseTheMetadataResolvedForAllPlugins) {
+  Game game = CreateLoadedGame();
+
+  for (const auto& plugin : game.GetPlugins()) {
+    game.GetMasterlistMetadata(plugin->GetName());
+    game.GetUserMetadata(plugin->GetName());
+  }
+  game.GetPluginsWithUserMetadata();
+
+  EXPECT_EQ(0, countEvents("Game::ResolveAllMetadata"));
+}
+
+TEST_P(GameScaleTest,
+       sortingAndReloadingPluginsShouldNotReloadAnUnchangedLoadOrderState) {
+  Game game = CreateLoadedGame();
+
+  game.SortPlugins();
+  game.SortPlugins();
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_EQ(0, countEvents("Game::ReloadLoadOrderState"));
+}
+
+TEST_P(GameScaleTest, getGameDataQueryShouldDeriveAllPluginsInOneBatch) {
+  Game game = CreateLoadedGame();
+
+  GetGameDataQuery<Game> query(game, "en", [](const ProgressUpdate&) {});
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_EQ(game.PluginCount(), json.at("plugins").size());
+  EXPECT_EQ(1, countEvents("MetadataQuery::writeDerivedMetadata"));
+  EXPECT_GE(1, countEvents("Game::GetGroupIndex"));
+  EXPECT_GE(1, countEvents("Game::GetActivePlugins"));
+}
+}
+}
+}
+
+#endif
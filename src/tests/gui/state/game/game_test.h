@@ -25,10 +25,12 @@ along with LOOT.  If not, see
 #ifndef LOOT_TESTS_GUI_STATE_GAME_GAME_TEST
 #define LOOT_TESTS_GUI_STATE_GAME_GAME_TEST
 
+#include <algorithm>
 #include <fstream>
 
 #include "gui/state/game/game.h"
 
+#include "gui/helpers.h"
 #include "gui/state/game/game_detection_error.h"
 #include "gui/state/game/helpers.h"
 #include "tests/common_game_test_fixture.h"
@@ -119,6 +121,39 @@ TEST_P(GameTest, constructingFromGameSettingsShouldUseTheirValues) {
   EXPECT_EQ(lootGamePath / "userlist.yaml", game.UserlistPath());
 }
 
+TEST_P(GameTest, masterlistPathShouldBeSharedByGamesWithTheSameSource) {
+  const auto settings = GameSettings(GetParam(), "otherFolder")
+                            .SetGamePath(dataPath.parent_path())
+                            .SetGameLocalPath(localPath);
+  Game game1(defaultGameSettings, lootDataPath);
+  Game game2(settings, lootDataPath);
+
+  ASSERT_EQ(game1.RepoURL(), game2.RepoURL());
+  ASSERT_EQ(game1.RepoBranch(), game2.RepoBranch());
+  ASSERT_NE(game1.MasterlistUpdatePath(), game2.MasterlistPath());
+
+  EXPECT_EQ(game1.MasterlistUpdatePath(), game2.MasterlistUpdatePath());
+  EXPECT_EQ(lootDataPath / "masterlists",
+            game1.MasterlistUpdatePath().parent_path().parent_path());
+
+  std::filesystem::create_directories(
+      game1.MasterlistUpdatePath().parent_path());
+  std::ofstream out(game1.MasterlistUpdatePath());
+  out.close();
+
+  EXPECT_EQ(game1.MasterlistUpdatePath(), game1.MasterlistPath());
+  EXPECT_EQ(game1.MasterlistUpdatePath(), game2.MasterlistPath());
+}
+
+TEST_P(GameTest, masterlistUpdatePathShouldDependOnTheRepositoryBranch) {
+  auto settings = defaultGameSettings;
+  settings.SetRepoBranch(settings.RepoBranch() + "-other");
+  Game game1(defaultGameSettings, lootDataPath);
+  Game game2(settings, lootDataPath);
+
+  EXPECT_NE(game1.MasterlistUpdatePath(), game2.MasterlistUpdatePath());
+}
+
 TEST_P(GameTest, copyConstructorShouldCopyGameData) {
   Game game1 = CreateInitialisedGame(lootDataPath);
   game1.AppendMessage(Message(MessageType::say, "1"));
@@ -287,13 +322,13 @@ TEST_P(GameTest,
 TEST_P(
     GameTest,
     checkInstallValidityShouldShowAMessageForIncompatibleNonPluginFilesThatArePresent) {
-  Game game = CreateInitialisedGame("");
-  game.LoadAllInstalledPlugins(true);
-
   std::string incompatibleFilename = "incompatible.txt";
   std::ofstream out(dataPath / incompatibleFilename);
   out.close();
 
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
   PluginMetadata metadata(blankEsm);
   metadata.SetIncompatibilities({
       File(incompatibleFilename),
@@ -309,6 +344,30 @@ TEST_P(
       messages);
 }
 
+TEST_P(
+    GameTest,
+    checkInstallValidityShouldUseTheDataDirectoryContentsFromWhenPluginsWereLastLoaded) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  std::string incompatibleFilename = "incompatible.txt";
+  std::ofstream out(dataPath / incompatibleFilename);
+  out.close();
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetIncompatibilities({
+      File(incompatibleFilename),
+  });
+
+  auto messages = game.CheckInstallValidity(game.GetPlugin(blankEsm), metadata);
+  EXPECT_TRUE(messages.empty());
+
+  game.LoadAllInstalledPlugins(true);
+
+  messages = game.CheckInstallValidity(game.GetPlugin(blankEsm), metadata);
+  EXPECT_EQ(1, messages.size());
+}
+
 TEST_P(
     GameTest,
     checkInstallValidityShouldUseDisplayNamesInIncompatibilityMessagesIfPresent) {
@@ -386,6 +445,45 @@ TEST_P(
   EXPECT_TRUE(messages.empty());
 }
 
+TEST_P(GameTest,
+       checkInstallValidityShouldRevalidateMastersWhenTheirActiveStatesChange) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankDifferentMasterDependentEsp);
+  ASSERT_EQ(1,
+            game.CheckInstallValidity(
+                    game.GetPlugin(blankDifferentMasterDependentEsp), metadata)
+                .size());
+
+  auto loadOrder = getInitialLoadOrder();
+  for (auto& plugin : loadOrder) {
+    if (plugin.first == blankDifferentEsm) {
+      plugin.second = true;
+    }
+  }
+  setLoadOrder(loadOrder);
+
+  // Make sure that the load order files don't look unchanged.
+  const std::vector<std::filesystem::path> loadOrderPaths({
+      localPath / "plugins.txt",
+      localPath / "loadorder.txt",
+      dataPath.parent_path() / "Morrowind.ini",
+  });
+  for (const auto& path : loadOrderPaths) {
+    if (std::filesystem::exists(path)) {
+      std::filesystem::last_write_time(
+          path,
+          std::filesystem::last_write_time(path) + std::chrono::hours(1));
+    }
+  }
+  ASSERT_TRUE(game.RecordExternalChanges(loadOrderPaths).loadOrder);
+
+  auto messages = game.CheckInstallValidity(
+      game.GetPlugin(blankDifferentMasterDependentEsp), metadata);
+  EXPECT_TRUE(messages.empty());
+}
+
 TEST_P(GameTest, checkInstallValidityShouldCheckThatAnEslIsValid) {
   if (GetParam() != GameType::tes5se) {
     return;
@@ -462,6 +560,24 @@ TEST_P(GameTest,
     messages);
 }
 
+TEST_P(GameTest, groupExistsShouldReflectChangesToUserGroups) {
+  Game game = CreateInitialisedGame("");
+  game.LoadMetadata();
+
+  EXPECT_TRUE(game.GroupExists(Group().GetName()));
+  EXPECT_FALSE(game.GroupExists("group"));
+
+  game.SetUserGroups({Group("group")});
+
+  EXPECT_TRUE(game.GroupExists("group"));
+  EXPECT_EQ(1, game.GetUserGroups().count(Group("group")));
+
+  game.SetUserGroups({});
+
+  EXPECT_FALSE(game.GroupExists("group"));
+  EXPECT_TRUE(game.GetUserGroups().empty());
+}
+
 TEST_P(
     GameTest,
     redatePluginsShouldRedatePluginsForSkyrimAndSkyrimSEAndDoNothingForOtherGames) {
@@ -486,11 +602,16 @@ TEST_P(
               std::filesystem::last_write_time(pluginPath));
   }
 
-  EXPECT_NO_THROW(game.RedatePlugins());
+  size_t redatedCount = 0;
+  EXPECT_NO_THROW(redatedCount = game.RedatePlugins());
 
   auto interval = std::chrono::seconds(60);
-  if (GetParam() != GameType::tes5 && GetParam() != GameType::tes5se)
+  if (GetParam() != GameType::tes5 && GetParam() != GameType::tes5se) {
     interval *= -1;
+    EXPECT_EQ(0, redatedCount);
+  } else {
+    EXPECT_EQ(loadOrder.size() - 1, redatedCount);
+  }
 
   for (size_t i = 0; i < loadOrder.size(); ++i) {
     auto pluginPath = dataPath / u8path(loadOrder[i].first);
@@ -502,6 +623,28 @@ TEST_P(
   }
 }
 
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldReportProgressForEachPluginFileRead) {
+  Game game = CreateInitialisedGame("");
+  game.SetPluginReadingThreads(3);
+
+  std::set<std::string> readPlugins;
+  size_t lastReadCount = 0;
+  game.LoadAllInstalledPlugins(true,
+                               [&](const std::string& pluginName,
+                                   size_t readCount,
+                                   size_t totalCount) {
+                                 readPlugins.insert(pluginName);
+                                 EXPECT_EQ(lastReadCount + 1, readCount);
+                                 EXPECT_EQ(12, totalCount);
+                                 lastReadCount = readCount;
+                               });
+
+  EXPECT_EQ(12, readPlugins.size());
+  EXPECT_EQ(12, lastReadCount);
+  EXPECT_EQ(12, game.PluginCount());
+}
+
 TEST_P(
     GameTest,
     loadAllInstalledPluginsWithHeadersOnlyTrueShouldLoadTheHeadersOfAllInstalledPlugins) {
@@ -509,7 +652,7 @@ TEST_P(
   ASSERT_NO_THROW(game.Init());
 
   EXPECT_NO_THROW(game.LoadAllInstalledPlugins(true));
-  EXPECT_EQ(12, game.GetPlugins().size());
+  EXPECT_EQ(12, game.PluginCount());
 
   // Check that one plugin's header has been read.
   ASSERT_NO_THROW(game.GetPlugin(masterFile));
@@ -527,7 +670,7 @@ TEST_P(
   ASSERT_NO_THROW(game.Init());
 
   EXPECT_NO_THROW(game.LoadAllInstalledPlugins(false));
-  EXPECT_EQ(12, game.GetPlugins().size());
+  EXPECT_EQ(12, game.PluginCount());
 
   // Check that one plugin's header has been read.
   ASSERT_NO_THROW(game.GetPlugin(blankEsm));
@@ -538,6 +681,67 @@ TEST_P(
   EXPECT_EQ(blankEsmCrc, plugin->GetCRC().value());
 }
 
+TEST_P(GameTest,
+       getPluginCRCShouldReturnTheCRCCachedWhenThePluginWasLastFullyLoaded) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(false);
+
+  Game otherGame = CreateInitialisedGame(lootDataPath);
+  otherGame.LoadAllInstalledPlugins(true);
+
+  auto plugin = otherGame.GetPlugin(blankEsm);
+  EXPECT_FALSE(plugin->GetCRC().has_value());
+  EXPECT_EQ(blankEsmCrc, otherGame.GetPluginCRC(plugin));
+}
+
+TEST_P(GameTest, getPluginCRCShouldNotReturnACachedCRCIfThePluginHasChanged) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(false);
+
+  std::filesystem::last_write_time(
+      dataPath / blankEsm,
+      std::filesystem::last_write_time(dataPath / blankEsm) +
+          std::chrono::seconds(10));
+
+  Game otherGame = CreateInitialisedGame(lootDataPath);
+  otherGame.LoadAllInstalledPlugins(true);
+
+  EXPECT_FALSE(otherGame.GetPluginCRC(otherGame.GetPlugin(blankEsm)));
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldIgnoreFilesWithoutPluginFileExtensions) {
+  ASSERT_NO_THROW(std::filesystem::copy_file(dataPath / blankEsm,
+                                             dataPath / "Blank.esm.bak"));
+  ASSERT_NO_THROW(std::filesystem::copy_file(dataPath / blankEsm,
+                                             dataPath / "Blank.ghost"));
+
+  Game game = CreateInitialisedGame("");
+  ASSERT_NO_THROW(game.Init());
+
+  EXPECT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  EXPECT_EQ(12, game.PluginCount());
+  EXPECT_FALSE(game.GetPlugin("Blank.esm.bak"));
+  EXPECT_FALSE(game.GetPlugin("Blank.ghost"));
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldFindAllPluginsInALargeDataDirectory) {
+  const size_t extraPluginCount = 100;
+  for (size_t i = 0; i < extraPluginCount; ++i) {
+    auto filename = "Blank " + std::to_string(i) + ".esp";
+    ASSERT_NO_THROW(
+        std::filesystem::copy_file(dataPath / blankEsp, dataPath / filename));
+    ASSERT_NO_THROW(std::ofstream(dataPath / (filename + ".txt")));
+  }
+
+  Game game = CreateInitialisedGame("");
+  ASSERT_NO_THROW(game.Init());
+
+  EXPECT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  EXPECT_EQ(12 + extraPluginCount, game.PluginCount());
+}
+
 TEST_P(GameTest,
        loadAllInstalledPluginsShouldNotGenerateWarningsForGhostedPlugins) {
   Game game = CreateInitialisedGame("");
@@ -550,6 +754,43 @@ TEST_P(GameTest,
             game.GetMessages()[0].GetContent()[0].GetText());
 }
 
+TEST_P(GameTest, getMemoryUsageShouldBeZeroIfTheGameIsNotInitialised) {
+  Game game(defaultGameSettings, "");
+
+  auto usage = game.GetMemoryUsage();
+
+  EXPECT_EQ(0, usage.pluginCount);
+  EXPECT_EQ(0, usage.estimatedBytes);
+}
+
+TEST_P(GameTest, getMemoryUsageShouldCountLoadedPlugins) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  auto headersUsage = game.GetMemoryUsage();
+  EXPECT_EQ(12, headersUsage.pluginCount);
+  EXPECT_LT(0, headersUsage.estimatedBytes);
+
+  game.LoadAllInstalledPlugins(false);
+
+  auto fullUsage = game.GetMemoryUsage();
+  EXPECT_EQ(12, fullUsage.pluginCount);
+  EXPECT_LT(headersUsage.estimatedBytes, fullUsage.estimatedBytes);
+}
+
+TEST_P(GameTest, unloadShouldReleaseLoadedPlugins) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(false);
+
+  game.Unload();
+
+  EXPECT_EQ(0, game.GetMemoryUsage().pluginCount);
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+
+  game.Init();
+  EXPECT_FALSE(game.HasPlugins());
+}
+
 TEST_P(GameTest, pluginsShouldNotBeFullyLoadedByDefault) {
   Game game = CreateInitialisedGame("");
 
@@ -615,148 +856,1266 @@ TEST_P(
   EXPECT_EQ(0, index.value());
 }
 
-TEST_P(GameTest, setLoadOrderWithoutLoadedPluginsShouldIgnoreCurrentState) {
-  using std::filesystem::u8path;
-  Game game(defaultGameSettings, lootDataPath);
+TEST_P(
+    GameTest,
+    GetActiveLoadOrderIndexWithoutALoadOrderShouldUseTheCurrentLoadOrder) {
+  Game game(defaultGameSettings, "");
   game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  auto lootGamePath = lootDataPath / u8path(game.FolderName());
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+  EXPECT_FALSE(game.GetActiveLoadOrderIndex(game.GetPlugin(blankEsp)));
+  EXPECT_EQ(0, game.GetActiveLoadOrderIndex(game.GetPlugin(masterFile)));
+  EXPECT_EQ(1, game.GetActiveLoadOrderIndex(game.GetPlugin(blankEsm)));
+  EXPECT_EQ(2,
+            game.GetActiveLoadOrderIndex(
+                game.GetPlugin(blankDifferentMasterDependentEsp)));
+}
 
-  auto initialLoadOrder = getLoadOrder();
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+TEST_P(GameTest,
+       GetActiveLoadOrderIndexShouldUseTheGivenLoadOrderIfItIsNotCurrent) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+  std::vector<std::string> loadOrder({blankEsm, masterFile});
 
-  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
+  EXPECT_EQ(
+      1, game.GetActiveLoadOrderIndex(game.GetPlugin(masterFile), loadOrder));
+  EXPECT_EQ(0,
+            game.GetActiveLoadOrderIndex(game.GetPlugin(blankEsm), loadOrder));
+  EXPECT_FALSE(game.GetActiveLoadOrderIndex(
+      game.GetPlugin(blankDifferentMasterDependentEsp), loadOrder));
 
-  EXPECT_TRUE(loadOrder.empty());
+  EXPECT_EQ(0, game.GetActiveLoadOrderIndex(game.GetPlugin(masterFile)));
 }
 
-TEST_P(GameTest, setLoadOrderShouldCreateABackupOfTheCurrentLoadOrder) {
-  using std::filesystem::u8path;
+TEST_P(GameTest, GetActiveLoadOrderIndexShouldReflectChangesToTheLoadOrder) {
   Game game(defaultGameSettings, lootDataPath);
   game.Init();
   game.LoadAllInstalledPlugins(true);
 
-  auto lootGamePath = lootDataPath / u8path(game.FolderName());
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
-
-  auto initialLoadOrder = getLoadOrder();
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
-
-  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+  ASSERT_EQ(2,
+            game.GetActiveLoadOrderIndex(
+                game.GetPlugin(blankDifferentMasterDependentEsp)));
+  ASSERT_EQ(3, game.GetActiveLoadOrderIndex(game.GetPlugin(nonAsciiEsp)));
+
+  auto loadOrder = game.GetLoadOrder();
+  auto first = std::find(
+      loadOrder.begin(), loadOrder.end(), blankDifferentMasterDependentEsp);
+  auto second = std::find(loadOrder.begin(), loadOrder.end(), nonAsciiEsp);
+  ASSERT_NE(loadOrder.end(), first);
+  ASSERT_NE(loadOrder.end(), second);
+  std::iter_swap(first, second);
+  game.SetLoadOrder(loadOrder);
+
+  EXPECT_EQ(3,
+            game.GetActiveLoadOrderIndex(
+                game.GetPlugin(blankDifferentMasterDependentEsp)));
+  EXPECT_EQ(2, game.GetActiveLoadOrderIndex(game.GetPlugin(nonAsciiEsp)));
+}
 
-  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
+TEST_P(GameTest, isPluginActiveShouldReturnTheActiveStateOfTheGivenPlugin) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  EXPECT_EQ(initialLoadOrder, loadOrder);
+  for (const auto& plugin : getInitialLoadOrder()) {
+    EXPECT_EQ(plugin.second, game.IsPluginActive(plugin.first))
+        << plugin.first;
+  }
+  EXPECT_TRUE(game.IsPluginActive("blank.ESM"));
+  EXPECT_FALSE(game.IsPluginActive("missing.esp"));
 }
 
-TEST_P(GameTest, setLoadOrderShouldRollOverExistingBackups) {
-  using std::filesystem::u8path;
+TEST_P(GameTest, isPluginActiveShouldBeUnaffectedByChangesToTheLoadOrder) {
   Game game(defaultGameSettings, lootDataPath);
   game.Init();
   game.LoadAllInstalledPlugins(true);
 
-  auto lootGamePath = lootDataPath / u8path(game.FolderName());
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
-
-  auto initialLoadOrder = getLoadOrder();
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
-
-  auto firstSetLoadOrder = loadOrderToSet_;
-
-  ASSERT_NE(blankPluginDependentEsp, loadOrderToSet_[9]);
-  ASSERT_NE(blankDifferentMasterDependentEsp, loadOrderToSet_[10]);
-  loadOrderToSet_[9] = blankPluginDependentEsp;
-  loadOrderToSet_[10] = blankDifferentMasterDependentEsp;
+  auto loadOrder = game.GetLoadOrder();
+  auto first = std::find(
+      loadOrder.begin(), loadOrder.end(), blankDifferentMasterDependentEsp);
+  auto second = std::find(loadOrder.begin(), loadOrder.end(), blankEsp);
+  ASSERT_NE(loadOrder.end(), first);
+  ASSERT_NE(loadOrder.end(), second);
+  std::iter_swap(first, second);
+  game.SetLoadOrder(loadOrder);
+
+  EXPECT_TRUE(game.IsPluginActive(blankDifferentMasterDependentEsp));
+  EXPECT_FALSE(game.IsPluginActive(blankEsp));
+}
 
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+TEST_P(GameTest, getPluginsShouldReturnTheLoadedPluginsInLoadOrder) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+  std::vector<std::string> pluginNames;
+  for (const auto& plugin : game.GetPlugins()) {
+    pluginNames.push_back(plugin->GetName());
+  }
 
-  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
-  EXPECT_EQ(firstSetLoadOrder, loadOrder);
+  std::vector<std::string> expectedPluginNames;
+  for (const auto& pluginName : game.GetLoadOrder()) {
+    if (game.GetPlugin(pluginName)) {
+      expectedPluginNames.push_back(pluginName);
+    }
+  }
 
-  loadOrder = readFileLines(lootGamePath / loadOrderBackupFile1);
-  EXPECT_EQ(initialLoadOrder, loadOrder);
+  EXPECT_EQ(expectedPluginNames, pluginNames);
+  EXPECT_EQ(game.PluginCount(), pluginNames.size());
 }
 
-TEST_P(GameTest, setLoadOrderShouldKeepUpToThreeBackups) {
-  using std::filesystem::u8path;
+TEST_P(GameTest, getPluginsShouldReturnANewViewIfTheLoadOrderChanges) {
   Game game(defaultGameSettings, lootDataPath);
   game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  auto lootGamePath = lootDataPath / u8path(game.FolderName());
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+  auto view = game.GetPlugins();
+  EXPECT_EQ(view.generation(), game.GetPlugins().generation());
+
+  auto loadOrder = game.GetLoadOrder();
+  auto first = std::find(
+      loadOrder.begin(), loadOrder.end(), blankDifferentMasterDependentEsp);
+  auto second = std::find(loadOrder.begin(), loadOrder.end(), nonAsciiEsp);
+  ASSERT_NE(loadOrder.end(), first);
+  ASSERT_NE(loadOrder.end(), second);
+  std::iter_swap(first, second);
+  game.SetLoadOrder(loadOrder);
+
+  auto newView = game.GetPlugins();
+  EXPECT_NE(view.generation(), newView.generation());
+  ASSERT_EQ(view.size(), newView.size());
+
+  std::vector<std::string> pluginNames;
+  for (const auto& plugin : newView) {
+    pluginNames.push_back(plugin->GetName());
+  }
+  auto newFirst =
+      std::find(pluginNames.begin(), pluginNames.end(), nonAsciiEsp);
+  auto newSecond = std::find(
+      pluginNames.begin(), pluginNames.end(), blankDifferentMasterDependentEsp);
+  EXPECT_LT(newFirst, newSecond);
+}
 
-  auto initialLoadOrder = getLoadOrder();
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+TEST_P(GameTest, GetPluginFingerprintShouldChangeIfThePluginFileChanges) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  auto firstSetLoadOrder = loadOrderToSet_;
+  auto fingerprint = game.GetPluginFingerprint(game.GetPlugin(blankEsp));
+  EXPECT_NE(0, fingerprint.fileSize);
+  EXPECT_FALSE(fingerprint.isActive);
 
-  ASSERT_NE(blankPluginDependentEsp, loadOrderToSet_[9]);
-  ASSERT_NE(blankDifferentMasterDependentEsp, loadOrderToSet_[10]);
-  loadOrderToSet_[9] = blankPluginDependentEsp;
-  loadOrderToSet_[10] = blankDifferentMasterDependentEsp;
+  EXPECT_EQ(fingerprint, game.GetPluginFingerprint(game.GetPlugin(blankEsp)));
 
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+  std::filesystem::last_write_time(
+      dataPath / blankEsp,
+      fingerprint.modificationTime - std::chrono::seconds(60));
 
-  auto secondSetLoadOrder = loadOrderToSet_;
+  EXPECT_NE(fingerprint, game.GetPluginFingerprint(game.GetPlugin(blankEsp)));
+}
 
-  ASSERT_NE(blankMasterDependentEsp, loadOrderToSet_[7]);
-  ASSERT_NE(blankEsp, loadOrderToSet_[8]);
-  loadOrderToSet_[7] = blankMasterDependentEsp;
-  loadOrderToSet_[8] = blankEsp;
+TEST_P(GameTest,
+       addingOrClearingUserMetadataShouldClearThatPluginsDerivedFingerprint) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+  game.SetDerivedPluginFingerprints({
+      {NormalizeFilename(blankEsm), PluginFingerprint()},
+      {NormalizeFilename(blankEsp), PluginFingerprint()},
+  });
 
-  auto thirdSetLoadOrder = loadOrderToSet_;
+  game.AddUserMetadata(PluginMetadata(blankEsm));
 
-  ASSERT_NE(blankDifferentMasterDependentEsm, loadOrderToSet_[3]);
-  ASSERT_NE(blankDifferentEsm, loadOrderToSet_[4]);
-  loadOrderToSet_[3] = blankDifferentMasterDependentEsm;
-  loadOrderToSet_[4] = blankDifferentEsm;
+  auto fingerprints = game.GetDerivedPluginFingerprints();
+  EXPECT_EQ(1, fingerprints.size());
+  EXPECT_EQ(1, fingerprints.count(NormalizeFilename(blankEsp)));
 
-  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+  game.ClearUserMetadata(blankEsp);
 
-  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
-  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
-  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
-  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+  EXPECT_TRUE(game.GetDerivedPluginFingerprints().empty());
+}
 
-  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
-  EXPECT_EQ(thirdSetLoadOrder, loadOrder);
+TEST_P(GameTest, loadingMetadataShouldClearAllDerivedFingerprints) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
 
-  loadOrder = readFileLines(lootGamePath / loadOrderBackupFile1);
-  EXPECT_EQ(secondSetLoadOrder, loadOrder);
+  game.SetDerivedPluginFingerprints({
+      {NormalizeFilename(blankEsm), PluginFingerprint()},
+  });
 
-  loadOrder = readFileLines(lootGamePath / loadOrderBackupFile2);
-  EXPECT_EQ(firstSetLoadOrder, loadOrder);
+  game.LoadMetadata();
+
+  EXPECT_TRUE(game.GetDerivedPluginFingerprints().empty());
 }
 
-TEST_P(GameTest, aMessageShouldBeCachedByDefault) {
+TEST_P(GameTest,
+       getDerivedMetadataJsonShouldOnlyReturnJsonWithTheSameLanguageAndIndex) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  game.SetDerivedMetadataJson(blankEsm, "en", true, 0, false, "{}");
+
+  EXPECT_EQ("{}", game.GetDerivedMetadataJson(blankEsm, "en", true, 0));
+  EXPECT_FALSE(game.GetDerivedMetadataJson(blankEsm, "fr", true, 0));
+  EXPECT_FALSE(game.GetDerivedMetadataJson(blankEsm, "en", false, 0));
+  EXPECT_FALSE(game.GetDerivedMetadataJson(blankEsm, "en", true, 1));
+  EXPECT_FALSE(game.GetDerivedMetadataJson(blankEsp, "en", true, 0));
+}
+
+TEST_P(GameTest, editingUserMetadataShouldOnlyDiscardThatPluginsDerivedJson) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  game.SetDerivedMetadataJson(blankEsm, "en", false, std::nullopt, true, "1");
+  game.SetDerivedMetadataJson(blankEsp, "en", false, std::nullopt, true, "2");
+
+  game.AddUserMetadata(PluginMetadata(blankEsm));
+
+  EXPECT_FALSE(
+      game.GetDerivedMetadataJson(blankEsm, "en", false, std::nullopt));
+  EXPECT_EQ("2",
+            game.GetDerivedMetadataJson(blankEsp, "en", false, std::nullopt));
+}
+
+TEST_P(GameTest,
+       installingAMissingMasterShouldDiscardItsDependentsDerivedJson) {
+  std::filesystem::rename(dataPath / blankEsm, dataPath / (blankEsm + ".bak"));
+
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  game.SetDerivedMetadataJson(
+      blankMasterDependentEsp, "en", false, std::nullopt, true, "1");
+  game.SetDerivedMetadataJson(blankEsp, "en", false, std::nullopt, true, "2");
+
+  std::filesystem::rename(dataPath / (blankEsm + ".bak"), dataPath / blankEsm);
+  game.RecordExternalChanges({dataPath / blankEsm});
+
+  EXPECT_FALSE(game.GetDerivedMetadataJson(
+      blankMasterDependentEsp, "en", false, std::nullopt));
+  EXPECT_EQ("2",
+            game.GetDerivedMetadataJson(blankEsp, "en", false, std::nullopt));
+}
+
+TEST_P(GameTest,
+       reloadingUnchangedPluginsShouldKeepDerivedJsonUnlessLoadedDifferently) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  game.SetDerivedMetadataJson(blankEsm, "en", false, std::nullopt, true, "1");
+
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_EQ("1",
+            game.GetDerivedMetadataJson(blankEsm, "en", false, std::nullopt));
+
+  game.LoadAllInstalledPlugins(false);
+
+  EXPECT_FALSE(
+      game.GetDerivedMetadataJson(blankEsm, "en", false, std::nullopt));
+}
+
+TEST_P(GameTest, loadingMetadataShouldDiscardAllDerivedJson) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  game.SetDerivedMetadataJson(blankEsm, "en", false, std::nullopt, false, "1");
+
+  game.LoadMetadata();
+
+  EXPECT_FALSE(
+      game.GetDerivedMetadataJson(blankEsm, "en", false, std::nullopt));
+}
+
+TEST_P(GameTest, evictingAllCachesShouldDiscardDerivedJson) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  game.SetDerivedMetadataJson(blankEsm, "en", false, std::nullopt, false, "1");
+
+  GetCacheRegistry().EvictAll();
+
+  EXPECT_FALSE(
+      game.GetDerivedMetadataJson(blankEsm, "en", false, std::nullopt));
+}
+
+TEST_P(GameTest,
+       doFormIDsOverlapShouldGiveTheSameResultAsThePluginsInEitherOrder) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(false);
+
+  auto esm = game.GetPlugin(blankEsm);
+  auto dependentEsm = game.GetPlugin(blankMasterDependentEsm);
+  auto differentEsm = game.GetPlugin(blankDifferentEsm);
+
+  EXPECT_EQ(esm->DoFormIDsOverlap(*dependentEsm),
+            game.DoFormIDsOverlap(esm, dependentEsm));
+  EXPECT_EQ(esm->DoFormIDsOverlap(*dependentEsm),
+            game.DoFormIDsOverlap(dependentEsm, esm));
+  EXPECT_EQ(esm->DoFormIDsOverlap(*differentEsm),
+            game.DoFormIDsOverlap(differentEsm, esm));
+}
+
+TEST_P(GameTest,
+       doFormIDsOverlapShouldReadFormIDsIfOnlyPluginHeadersAreLoaded) {
+  Game fullGame(defaultGameSettings, "");
+  fullGame.Init();
+  fullGame.LoadAllInstalledPlugins(false);
+
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto fullEsm = fullGame.GetPlugin(blankEsm);
+  auto fullDependentEsm = fullGame.GetPlugin(blankMasterDependentEsm);
+  auto fullDifferentEsm = fullGame.GetPlugin(blankDifferentEsm);
+  auto esm = game.GetPlugin(blankEsm);
+  auto dependentEsm = game.GetPlugin(blankMasterDependentEsm);
+  auto differentEsm = game.GetPlugin(blankDifferentEsm);
+
+  EXPECT_EQ(fullEsm->DoFormIDsOverlap(*fullDependentEsm),
+            game.DoFormIDsOverlap(esm, dependentEsm));
+  EXPECT_EQ(fullEsm->DoFormIDsOverlap(*fullDifferentEsm),
+            game.DoFormIDsOverlap(esm, differentEsm));
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+}
+
+TEST_P(GameTest, getFormIdOverlapsShouldFindTheSamePairsAsDoFormIDsOverlap) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(false);
+
+  auto overlaps = game.GetFormIdOverlaps();
+
+  if (GetParam() == GameType::tes3) {
+    // Morrowind plugins have no FormIDs to scan.
+    EXPECT_TRUE(overlaps.empty());
+    return;
+  }
+
+  std::vector<std::pair<std::string, std::string>> expectedPairs;
+  auto plugins = game.GetPlugins();
+  for (size_t i = 0; i < plugins.size(); ++i) {
+    for (size_t j = i + 1; j < plugins.size(); ++j) {
+      if (plugins[i]->DoFormIDsOverlap(*plugins[j])) {
+        expectedPairs.emplace_back(plugins[i]->GetName(),
+                                   plugins[j]->GetName());
+      }
+    }
+  }
+
+  std::vector<std::pair<std::string, std::string>> pairs;
+  for (const auto& overlap : overlaps) {
+    pairs.emplace_back(overlap.plugin, overlap.otherPlugin);
+    EXPECT_LT(0, overlap.recordCount);
+  }
+
+  EXPECT_FALSE(pairs.empty());
+  EXPECT_EQ(expectedPairs, pairs);
+}
+
+TEST_P(GameTest,
+       loadFormIDsOfPossibleOverlapsShouldNotFullyLoadThePluginsInTheGame) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+  auto headersUsage = game.GetMemoryUsage();
+
+  game.LoadFormIDsOfPossibleOverlaps(blankEsm);
+
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+  EXPECT_FALSE(game.GetPlugin(blankEsm)->GetCRC().has_value());
+  EXPECT_EQ(headersUsage.pluginCount, game.GetMemoryUsage().pluginCount);
+  EXPECT_LT(headersUsage.estimatedBytes, game.GetMemoryUsage().estimatedBytes);
+}
+
+TEST_P(GameTest, derivedMetadataRevisionShouldChangeWhenGameStateChanges) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+
+  auto revision = game.GetDerivedMetadataRevision();
+  game.LoadAllInstalledPlugins(true);
+  EXPECT_NE(revision, game.GetDerivedMetadataRevision());
+
+  revision = game.GetDerivedMetadataRevision();
+  EXPECT_EQ(revision, game.GetDerivedMetadataRevision());
+
+  game.AddUserMetadata(PluginMetadata(blankEsm));
+  EXPECT_NE(revision, game.GetDerivedMetadataRevision());
+
+  revision = game.GetDerivedMetadataRevision();
+  game.LoadMetadata();
+  EXPECT_NE(revision, game.GetDerivedMetadataRevision());
+}
+
+TEST_P(GameTest,
+       getPluginsWithUserMetadataShouldReflectChangesToUserMetadata) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_TRUE(game.GetPluginsWithUserMetadata().empty());
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+  game.AddUserMetadata(PluginMetadata("missing.esp"));
+
+  EXPECT_EQ(std::vector<std::string>({blankEsm}),
+            game.GetPluginsWithUserMetadata());
+
+  metadata = PluginMetadata(blankEsp);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+  game.ClearUserMetadata(blankEsm);
+
+  EXPECT_EQ(std::vector<std::string>({blankEsp}),
+            game.GetPluginsWithUserMetadata());
+
+  game.ClearAllUserMetadata();
+
+  EXPECT_TRUE(game.GetPluginsWithUserMetadata().empty());
+}
+
+TEST_P(GameTest, evaluatedUserMetadataShouldReflectChangesToUserMetadata) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_FALSE(game.GetUserMetadata(blankEsm, true).has_value());
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+
+  auto evaluatedMetadata = game.GetUserMetadata(blankEsm, true);
+  ASSERT_TRUE(evaluatedMetadata.has_value());
+  EXPECT_EQ("group", evaluatedMetadata.value().GetGroup().value());
+
+  game.ClearUserMetadata(blankEsm);
+
+  EXPECT_FALSE(game.GetUserMetadata(blankEsm, true).has_value());
+}
+
+TEST_P(GameTest, resolvedUserMetadataShouldReflectChangesToUserMetadata) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+  game.ResolveAllMetadata();
+
+  EXPECT_FALSE(game.GetUserMetadata(blankEsm).has_value());
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+
+  auto userMetadata = game.GetUserMetadata(blankEsm);
+  ASSERT_TRUE(userMetadata.has_value());
+  EXPECT_EQ("group", userMetadata.value().GetGroup().value());
+
+  metadata = PluginMetadata("Blank\\.es(m|p)");
+  metadata.SetGroup("other group");
+  game.AddUserMetadata(metadata);
+
+  userMetadata = game.GetUserMetadata(blankEsp);
+  ASSERT_TRUE(userMetadata.has_value());
+  EXPECT_EQ("other group", userMetadata.value().GetGroup().value());
+
+  game.ClearAllUserMetadata();
+
+  EXPECT_FALSE(game.GetUserMetadata(blankEsm).has_value());
+  EXPECT_FALSE(game.GetUserMetadata(blankEsp).has_value());
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsAndMetadataShouldLoadPluginsAndMetadataLists) {
+  Game game = CreateInitialisedGame(lootDataPath);
+
+  std::ofstream out(game.UserlistPath());
+  out << "plugins:\n  - name: " << blankEsm << "\n    tag: [ Relev ]\n";
+  out.close();
+
+  game.LoadAllInstalledPluginsAndMetadata(true, false);
+
+  EXPECT_EQ(12, game.PluginCount());
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+
+  auto userMetadata = game.GetUserMetadata(blankEsm);
+  ASSERT_TRUE(userMetadata.has_value());
+  EXPECT_EQ(1, userMetadata.value().GetTags().size());
+}
+
+TEST_P(GameTest,
+       evaluatedMetadataShouldReflectChangesToTheDataDirectoryWhenReloaded) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetTags({Tag("Relev", true, "file(\"new.txt\")")});
+  game.AddUserMetadata(metadata);
+
+  EXPECT_TRUE(game.GetUserMetadata(blankEsm, true).value().GetTags().empty());
+
+  std::ofstream out(dataPath / "new.txt");
+  out.close();
+
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_EQ(1, game.GetUserMetadata(blankEsm, true).value().GetTags().size());
+}
+
+TEST_P(GameTest,
+       evaluatedMetadataShouldOnlyChangeForPluginsWithConditionsOnChanges) {
+  std::filesystem::create_directory(dataPath / "textures");
+
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetTags({Tag("Relev", true, "file(\"textures/new.dds\")")});
+  game.AddUserMetadata(metadata);
+  metadata = PluginMetadata(blankEsp);
+  metadata.SetTags({Tag("Delev", true, "not file(\"new.txt\")")});
+  game.AddUserMetadata(metadata);
+
+  EXPECT_TRUE(game.GetUserMetadata(blankEsm, true).value().GetTags().empty());
+  EXPECT_EQ(1, game.GetUserMetadata(blankEsp, true).value().GetTags().size());
+
+  std::ofstream out(dataPath / "textures" / "new.dds");
+  out.close();
+
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_EQ(1, game.GetUserMetadata(blankEsm, true).value().GetTags().size());
+  EXPECT_EQ(1, game.GetUserMetadata(blankEsp, true).value().GetTags().size());
+}
+
+TEST_P(GameTest, sortPluginsShouldReloadTheLoadOrderStateIfItsFilesChanged) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  ASSERT_FALSE(game.IsPluginActive(blankDifferentEsm));
+
+  auto loadOrder = getInitialLoadOrder();
+  for (auto& plugin : loadOrder) {
+    if (plugin.first == blankDifferentEsm) {
+      plugin.second = true;
+    }
+  }
+  setLoadOrder(loadOrder);
+
+  game.SortPlugins();
+
+  EXPECT_TRUE(game.IsPluginActive(blankDifferentEsm));
+}
+
+TEST_P(GameTest, sortPluginsShouldReturnTheSameResultIfNothingHasChanged) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  auto sortedPlugins = game.SortPlugins();
+  auto messages = game.GetMessages();
+  ASSERT_FALSE(sortedPlugins.empty());
+
+  EXPECT_EQ(sortedPlugins, game.SortPlugins());
+  EXPECT_EQ(messages.size(), game.GetMessages().size());
+}
+
+TEST_P(GameTest, sortPluginsShouldNotReuseTheLastResultIfMetadataHasChanged) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  auto sortedPlugins = game.SortPlugins();
+  auto first =
+      std::find(sortedPlugins.cbegin(), sortedPlugins.cend(), blankEsp);
+  auto second = std::find(
+      sortedPlugins.cbegin(), sortedPlugins.cend(), blankDifferentEsp);
+  ASSERT_NE(sortedPlugins.cend(), first);
+  ASSERT_NE(sortedPlugins.cend(), second);
+  if (second < first) {
+    std::swap(first, second);
+  }
+
+  PluginMetadata metadata(*first);
+  metadata.SetLoadAfterFiles({File(*second)});
+  game.AddUserMetadata(metadata);
+
+  auto newSortedPlugins = game.SortPlugins();
+  auto newFirst =
+      std::find(newSortedPlugins.cbegin(), newSortedPlugins.cend(), *first);
+  auto newSecond =
+      std::find(newSortedPlugins.cbegin(), newSortedPlugins.cend(), *second);
+
+  EXPECT_LT(newSecond, newFirst);
+}
+
+TEST_P(GameTest, sortPluginsShouldRecordAProfileOfTheSort) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  ASSERT_FALSE(game.GetLastSortProfile().has_value());
+
+  PluginMetadata metadata(blankDifferentEsp);
+  metadata.SetLoadAfterFiles({File(blankEsp), File(missingEsp)});
+  game.AddUserMetadata(metadata);
+
+  auto sortedPlugins = game.SortPlugins();
+  ASSERT_FALSE(sortedPlugins.empty());
+
+  auto profile = game.GetLastSortProfile();
+  ASSERT_TRUE(profile.has_value());
+  EXPECT_FALSE(profile.value().reusedLastResult);
+  EXPECT_EQ(sortedPlugins.size(), profile.value().pluginCount);
+
+  std::vector<std::string> stageNames;
+  for (const auto& stage : profile.value().stages) {
+    stageNames.push_back(stage.name);
+  }
+  EXPECT_EQ(std::vector<std::string>({"loadLoadOrderState",
+                                      "checkSortInputs",
+                                      "loadAndSortPlugins",
+                                      "checkForRemovedPlugins",
+                                      "countEdges"}),
+            stageNames);
+
+  // The rule for the missing plugin doesn't produce an edge.
+  EXPECT_EQ(1, profile.value().edgeCounts.at("User Load After"));
+  EXPECT_LT(0, profile.value().edgeCounts.at("Master"));
+}
+
+TEST_P(GameTest, sortPluginsShouldKeepTheCountsOfAReusedResultInItsProfile) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  game.SortPlugins();
+  auto profile = game.GetLastSortProfile().value();
+  game.SortPlugins();
+  auto reusedProfile = game.GetLastSortProfile().value();
+
+  EXPECT_TRUE(reusedProfile.reusedLastResult);
+  EXPECT_EQ(profile.pluginCount, reusedProfile.pluginCount);
+  EXPECT_EQ(profile.edgeCounts, reusedProfile.edgeCounts);
+  EXPECT_EQ(profile.overlapCandidatePairs,
+            reusedProfile.overlapCandidatePairs);
+  EXPECT_EQ(2, reusedProfile.stages.size());
+}
+
+TEST_P(GameTest, sortPluginsShouldReuseAResultPersistedByAnEarlierSession) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadMetadata();
+  game.LoadAllInstalledPlugins(true);
+
+  auto sortedPlugins = game.SortPlugins();
+  ASSERT_FALSE(sortedPlugins.empty());
+  ASSERT_TRUE(std::filesystem::exists(game.SortResultCachePath()));
+
+  Game otherGame = CreateInitialisedGame(lootDataPath);
+  otherGame.LoadMetadata();
+  otherGame.LoadAllInstalledPlugins(true);
+
+  EXPECT_EQ(sortedPlugins, otherGame.SortPlugins());
+  EXPECT_TRUE(otherGame.GetLastSortProfile().value().reusedLastResult);
+}
+
+TEST_P(GameTest,
+       sortPluginsShouldNotReuseAPersistedResultIfAPluginHasChangedSince) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadMetadata();
+  game.LoadAllInstalledPlugins(true);
+  game.SortPlugins();
+
+  const auto pluginPath = dataPath / blankEsp;
+  std::filesystem::last_write_time(
+      pluginPath,
+      std::filesystem::last_write_time(pluginPath) + std::chrono::hours(1));
+
+  Game otherGame = CreateInitialisedGame(lootDataPath);
+  otherGame.LoadMetadata();
+  otherGame.LoadAllInstalledPlugins(true);
+  otherGame.SortPlugins();
+
+  EXPECT_FALSE(otherGame.GetLastSortProfile().value().reusedLastResult);
+}
+
+TEST_P(GameTest, precomputeSortResultShouldNotChangeMessagesOrTheSortCount) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  auto messages = game.GetMessages();
+
+  EXPECT_TRUE(game.PrecomputeSortResult());
+
+  // The default cached message is hidden once the load order has been sorted,
+  // so the messages would change if the sort count was incremented.
+  EXPECT_EQ(messages, game.GetMessages());
+}
+
+TEST_P(GameTest, sortPluginsShouldReturnThePrecomputedSortResult) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  Game otherGame = CreateInitialisedGame(lootDataPath);
+  otherGame.LoadAllInstalledPlugins(true);
+
+  ASSERT_TRUE(game.PrecomputeSortResult());
+
+  EXPECT_EQ(otherGame.SortPlugins(), game.SortPlugins());
+}
+
+TEST_P(GameTest,
+       replaceUserMetadataShouldKeepTheLastSortResultIfItIsStillValid) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  auto sortedPlugins = game.SortPlugins();
+  ASSERT_FALSE(sortedPlugins.empty());
+
+  // The last plugin already loads after the first.
+  PluginMetadata metadata(sortedPlugins.back());
+  metadata.SetLoadAfterFiles({File(sortedPlugins.front())});
+  game.ReplaceUserMetadata(metadata);
+
+  EXPECT_EQ(sortedPlugins, game.SortPlugins());
+  ASSERT_TRUE(game.GetUserMetadata(sortedPlugins.back()).has_value());
+}
+
+TEST_P(GameTest,
+       replaceUserMetadataShouldRemoveTheUserMetadataIfItOnlyHasAName) {
+  Game game = CreateInitialisedGame(lootDataPath);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+
+  game.ReplaceUserMetadata(PluginMetadata(blankEsm));
+
+  EXPECT_FALSE(game.GetUserMetadata(blankEsm).has_value());
+}
+
+TEST_P(GameTest,
+       replaceUserMetadataShouldNotKeepTheLastSortResultIfItIsNoLongerValid) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  auto sortedPlugins = game.SortPlugins();
+  auto first =
+      std::find(sortedPlugins.cbegin(), sortedPlugins.cend(), blankEsp);
+  auto second = std::find(
+      sortedPlugins.cbegin(), sortedPlugins.cend(), blankDifferentEsp);
+  ASSERT_NE(sortedPlugins.cend(), first);
+  ASSERT_NE(sortedPlugins.cend(), second);
+  if (second < first) {
+    std::swap(first, second);
+  }
+
+  PluginMetadata metadata(*first);
+  metadata.SetLoadAfterFiles({File(*second)});
+  game.ReplaceUserMetadata(metadata);
+
+  auto newSortedPlugins = game.SortPlugins();
+  auto newFirst =
+      std::find(newSortedPlugins.cbegin(), newSortedPlugins.cend(), *first);
+  auto newSecond =
+      std::find(newSortedPlugins.cbegin(), newSortedPlugins.cend(), *second);
+
+  EXPECT_LT(newSecond, newFirst);
+}
+
+TEST_P(GameTest, setLoadOrderWithoutLoadedPluginsShouldIgnoreCurrentState) {
+  using std::filesystem::u8path;
+  Game game(defaultGameSettings, lootDataPath);
+  game.Init();
+
+  auto lootGamePath = lootDataPath / u8path(game.FolderName());
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto initialLoadOrder = getLoadOrder();
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
+
+  EXPECT_TRUE(loadOrder.empty());
+}
+
+TEST_P(GameTest, setLoadOrderShouldCreateABackupOfTheCurrentLoadOrder) {
+  using std::filesystem::u8path;
+  Game game(defaultGameSettings, lootDataPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto lootGamePath = lootDataPath / u8path(game.FolderName());
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto initialLoadOrder = getLoadOrder();
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
+
+  EXPECT_EQ(initialLoadOrder, loadOrder);
+}
+
+TEST_P(GameTest,
+       recordExternalChangesShouldReturnChangedPluginsWithoutGhostExtensions) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  auto changes = game.RecordExternalChanges({
+      dataPath / blankEsp,
+      dataPath / (blankMasterDependentEsm + ".ghost"),
+  });
+
+  EXPECT_EQ(std::set<std::string>({blankEsp, blankMasterDependentEsm}),
+            changes.plugins);
+  EXPECT_FALSE(changes.dataDirectory);
+  EXPECT_FALSE(changes.loadOrder);
+  EXPECT_FALSE(changes.metadataLists);
+}
+
+TEST_P(GameTest,
+       recordExternalChangesShouldReportChangesToOtherDataFilesSeparately) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  auto changes = game.RecordExternalChanges({dataPath / "textures"});
+
+  EXPECT_TRUE(changes.plugins.empty());
+  EXPECT_TRUE(changes.dataDirectory);
+  EXPECT_FALSE(changes.IsEmpty());
+}
+
+TEST_P(GameTest,
+       recordExternalChangesShouldReloadTheLoadOrderIfItsFilesChanged) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  ASSERT_NE(loadOrderToSet_, game.GetLoadOrder());
+
+  // Use a separate game handle to change the load order.
+  Game otherGame = CreateInitialisedGame(lootDataPath);
+  otherGame.LoadAllInstalledPlugins(true);
+  otherGame.SetLoadOrder(loadOrderToSet_);
+
+  auto changes = game.RecordExternalChanges({
+      localPath / "plugins.txt",
+      localPath / "loadorder.txt",
+      dataPath.parent_path() / "Morrowind.ini",
+  });
+
+  EXPECT_TRUE(changes.loadOrder);
+  EXPECT_EQ(loadOrderToSet_, game.GetLoadOrder());
+}
+
+TEST_P(GameTest,
+       recordExternalChangesShouldNotReportAnUnchangedLoadOrderAsChanged) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.SetLoadOrder(loadOrderToSet_);
+
+  auto changes = game.RecordExternalChanges({
+      localPath / "plugins.txt",
+      localPath / "loadorder.txt",
+      dataPath.parent_path() / "Morrowind.ini",
+  });
+
+  EXPECT_TRUE(changes.IsEmpty());
+}
+
+TEST_P(GameTest, recordExternalChangesShouldIgnoreLoadOrderWritesMadeByLoot) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.SetLoadOrder(loadOrderToSet_);
+
+  // Games with timestamp-based load orders change their plugins' files.
+  std::vector<std::filesystem::path> paths({
+      localPath / "plugins.txt",
+      localPath / "loadorder.txt",
+      dataPath.parent_path() / "Morrowind.ini",
+  });
+  if (GetParam() == GameType::tes3 || GetParam() == GameType::tes4 ||
+      GetParam() == GameType::fo3 || GetParam() == GameType::fonv) {
+    for (const auto& entry : std::filesystem::directory_iterator(dataPath)) {
+      paths.push_back(entry.path());
+    }
+  }
+
+  auto changes = game.RecordExternalChanges(paths);
+
+  EXPECT_TRUE(changes.plugins.empty());
+  EXPECT_FALSE(changes.loadOrder);
+}
+
+TEST_P(GameTest,
+       recordExternalChangesShouldNotIgnoreChangesMadeAfterLootWroteAFile) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.SetLoadOrder(loadOrderToSet_);
+
+  std::filesystem::last_write_time(
+      dataPath / blankEsp,
+      std::filesystem::last_write_time(dataPath / blankEsp) +
+          std::chrono::hours(1));
+
+  auto changes = game.RecordExternalChanges({dataPath / blankEsp});
+
+  EXPECT_EQ(std::set<std::string>({blankEsp}), changes.plugins);
+}
+
+TEST_P(GameTest, recordExternalChangesShouldIgnoreUserlistWritesMadeByLoot) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.LoadMetadata();
+
+  game.AddUserMetadata(PluginMetadata(blankEsp));
+  game.SaveUserMetadata();
+
+  auto changes = game.RecordExternalChanges({game.UserlistPath()});
+
+  EXPECT_FALSE(changes.metadataLists);
+  EXPECT_FALSE(game.AreMetadataListsStale());
+}
+
+TEST_P(GameTest, saveUserMetadataShouldWriteTheUserlist) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+  game.SaveUserMetadata();
+
+  auto tempPath = game.UserlistPath();
+  tempPath += ".tmp";
+
+  EXPECT_TRUE(std::filesystem::exists(game.UserlistPath()));
+  EXPECT_FALSE(std::filesystem::exists(tempPath));
+}
+
+TEST_P(GameTest,
+       saveUserMetadataShouldNotWriteTheUserlistUntilATransactionIsCommitted) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  game.BeginUserMetadataTransaction();
+  game.AddUserMetadata(PluginMetadata(blankEsp));
+  game.SaveUserMetadata();
+
+  EXPECT_FALSE(std::filesystem::exists(game.UserlistPath()));
+
+  game.CommitUserMetadataTransaction();
+
+  EXPECT_TRUE(std::filesystem::exists(game.UserlistPath()));
+}
+
+TEST_P(GameTest, rollingBackAUserMetadataTransactionShouldDiscardItsEdits) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+  game.SaveUserMetadata();
+
+  game.BeginUserMetadataTransaction();
+  game.ClearUserMetadata(blankEsm);
+  metadata = PluginMetadata(blankEsp);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+  game.SaveUserMetadata();
+  game.RollbackUserMetadataTransaction();
+
+  EXPECT_TRUE(game.GetUserMetadata(blankEsm).has_value());
+  EXPECT_FALSE(game.GetUserMetadata(blankEsp).has_value());
+}
+
+TEST_P(GameTest,
+       deferredUserMetadataSavesShouldNotWriteTheUserlistUntilFlushed) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.EnableDeferredUserMetadataSaves(std::chrono::minutes(1));
+
+  game.AddUserMetadata(PluginMetadata(blankEsp));
+  game.SaveUserMetadata();
+  game.AddUserMetadata(PluginMetadata(blankEsm));
+  game.SaveUserMetadata();
+
+  EXPECT_FALSE(std::filesystem::exists(game.UserlistPath()));
+
+  game.FlushUserMetadata();
+
+  EXPECT_TRUE(std::filesystem::exists(game.UserlistPath()));
+}
+
+TEST_P(GameTest,
+       deferredUserMetadataSavesShouldBeWrittenWhenTheGameIsUnloaded) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.EnableDeferredUserMetadataSaves(std::chrono::minutes(1));
+
+  game.AddUserMetadata(PluginMetadata(blankEsp));
+  game.SaveUserMetadata();
+  game.Unload();
+
+  EXPECT_TRUE(std::filesystem::exists(game.UserlistPath()));
+}
+
+TEST_P(GameTest,
+       committingAUserMetadataTransactionShouldWriteTheUserlistImmediately) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.EnableDeferredUserMetadataSaves(std::chrono::minutes(1));
+
+  game.BeginUserMetadataTransaction();
+  game.AddUserMetadata(PluginMetadata(blankEsp));
+  game.SaveUserMetadata();
+  game.CommitUserMetadataTransaction();
+
+  EXPECT_TRUE(std::filesystem::exists(game.UserlistPath()));
+}
+
+TEST_P(GameTest,
+       committingAUserMetadataTransactionShouldRollItBackIfTheWriteFails) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  // The userlist is written to a temporary file first, so block it.
+  auto tempPath = game.UserlistPath();
+  tempPath += ".tmp";
+  std::filesystem::create_directories(tempPath / "blocker");
+
+  PluginMetadata metadata(blankEsp);
+  metadata.SetGroup("group");
+
+  game.BeginUserMetadataTransaction();
+  game.AddUserMetadata(metadata);
+  game.SaveUserMetadata();
+  EXPECT_ANY_THROW(game.CommitUserMetadataTransaction());
+
+  EXPECT_FALSE(game.GetUserMetadata(blankEsp).has_value());
+
+  // The transaction should have ended.
+  game.BeginUserMetadataTransaction();
+  game.RollbackUserMetadataTransaction();
+}
+
+TEST_P(GameTest, deferredUserMetadataSaveFailuresShouldAddAnErrorMessage) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.EnableDeferredUserMetadataSaves(std::chrono::minutes(1));
+
+  auto tempPath = game.UserlistPath();
+  tempPath += ".tmp";
+  std::filesystem::create_directories(tempPath / "blocker");
+
+  game.AddUserMetadata(PluginMetadata(blankEsp));
+  game.SaveUserMetadata();
+  EXPECT_NO_THROW(game.FlushUserMetadata());
+
+  const auto messages = game.GetMessages();
+  EXPECT_TRUE(std::any_of(
+      messages.begin(), messages.end(), [](const Message& message) {
+        return message.GetType() == MessageType::error;
+      }));
+}
+
+TEST_P(GameTest,
+       recordExternalChangesShouldMarkExternallyChangedMetadataListsAsStale) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.LoadMetadata();
+
+  std::ofstream(game.UserlistPath()) << "plugins: []" << std::endl;
+
+  auto changes = game.RecordExternalChanges({game.UserlistPath()});
+
+  EXPECT_TRUE(changes.metadataLists);
+  EXPECT_TRUE(game.AreMetadataListsStale());
+
+  game.LoadMetadata();
+
+  EXPECT_FALSE(game.AreMetadataListsStale());
+}
+
+TEST_P(GameTest, loadMetadataShouldNotParseUnchangedMetadataListsAgain) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.LoadMetadata();
+
+  auto revision = game.GetDerivedMetadataRevision();
+  game.LoadMetadata();
+
+  EXPECT_EQ(revision, game.GetDerivedMetadataRevision());
+}
+
+TEST_P(GameTest, loadMetadataShouldParseAnExternallyChangedUserlistAgain) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.LoadMetadata();
+
+  std::ofstream(game.UserlistPath())
+      << "plugins:\n  - name: " << blankEsm << "\n    tag: [ Relev ]"
+      << std::endl;
+  game.LoadMetadata();
+
+  EXPECT_TRUE(game.GetUserMetadata(blankEsm).has_value());
+}
+
+TEST_P(GameTest, loadMetadataShouldDiscardUnsavedUserMetadataEdits) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+  game.LoadMetadata();
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetGroup("group");
+  game.AddUserMetadata(metadata);
+  game.LoadMetadata();
+
+  EXPECT_FALSE(game.GetUserMetadata(blankEsm).has_value());
+}
+
+TEST_P(GameTest, setLoadOrderShouldNotLeaveATemporaryBackupFileBehind) {
+  using std::filesystem::u8path;
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  auto lootGamePath = lootDataPath / u8path(game.FolderName());
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / "loadorder.bak.tmp"));
+}
+
+TEST_P(GameTest, setLoadOrderShouldNotBackUpTheLoadOrderIfItIsAlreadySet) {
+  using std::filesystem::u8path;
+  Game game = CreateInitialisedGame(lootDataPath);
+  game.LoadAllInstalledPlugins(true);
+
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+  ASSERT_EQ(loadOrderToSet_, game.GetLoadOrder());
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  auto lootGamePath = lootDataPath / u8path(game.FolderName());
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  EXPECT_EQ(loadOrderToSet_, getLoadOrder());
+}
+
+TEST_P(GameTest, setLoadOrderShouldRollOverExistingBackups) {
+  using std::filesystem::u8path;
+  Game game(defaultGameSettings, lootDataPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto lootGamePath = lootDataPath / u8path(game.FolderName());
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto initialLoadOrder = getLoadOrder();
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  auto firstSetLoadOrder = loadOrderToSet_;
+
+  ASSERT_NE(blankPluginDependentEsp, loadOrderToSet_[9]);
+  ASSERT_NE(blankDifferentMasterDependentEsp, loadOrderToSet_[10]);
+  loadOrderToSet_[9] = blankPluginDependentEsp;
+  loadOrderToSet_[10] = blankDifferentMasterDependentEsp;
+
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
+  EXPECT_EQ(firstSetLoadOrder, loadOrder);
+
+  loadOrder = readFileLines(lootGamePath / loadOrderBackupFile1);
+  EXPECT_EQ(initialLoadOrder, loadOrder);
+}
+
+TEST_P(GameTest, setLoadOrderShouldKeepUpToThreeBackups) {
+  using std::filesystem::u8path;
+  Game game(defaultGameSettings, lootDataPath);
+  game.Init();
+
+  auto lootGamePath = lootDataPath / u8path(game.FolderName());
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  ASSERT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto initialLoadOrder = getLoadOrder();
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  auto firstSetLoadOrder = loadOrderToSet_;
+
+  ASSERT_NE(blankPluginDependentEsp, loadOrderToSet_[9]);
+  ASSERT_NE(blankDifferentMasterDependentEsp, loadOrderToSet_[10]);
+  loadOrderToSet_[9] = blankPluginDependentEsp;
+  loadOrderToSet_[10] = blankDifferentMasterDependentEsp;
+
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  auto secondSetLoadOrder = loadOrderToSet_;
+
+  ASSERT_NE(blankMasterDependentEsp, loadOrderToSet_[7]);
+  ASSERT_NE(blankEsp, loadOrderToSet_[8]);
+  loadOrderToSet_[7] = blankMasterDependentEsp;
+  loadOrderToSet_[8] = blankEsp;
+
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  auto thirdSetLoadOrder = loadOrderToSet_;
+
+  ASSERT_NE(blankDifferentMasterDependentEsm, loadOrderToSet_[3]);
+  ASSERT_NE(blankDifferentEsm, loadOrderToSet_[4]);
+  loadOrderToSet_[3] = blankDifferentMasterDependentEsm;
+  loadOrderToSet_[4] = blankDifferentEsm;
+
+  ASSERT_NO_THROW(game.SetLoadOrder(loadOrderToSet_));
+
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile0));
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile1));
+  EXPECT_TRUE(std::filesystem::exists(lootGamePath / loadOrderBackupFile2));
+  EXPECT_FALSE(std::filesystem::exists(lootGamePath / loadOrderBackupFile3));
+
+  auto loadOrder = readFileLines(lootGamePath / loadOrderBackupFile0);
+  EXPECT_EQ(thirdSetLoadOrder, loadOrder);
+
+  loadOrder = readFileLines(lootGamePath / loadOrderBackupFile1);
+  EXPECT_EQ(secondSetLoadOrder, loadOrder);
+
+  loadOrder = readFileLines(lootGamePath / loadOrderBackupFile2);
+  EXPECT_EQ(firstSetLoadOrder, loadOrder);
+}
+
+TEST_P(GameTest, aMessageShouldBeCachedByDefault) {
   Game game = CreateInitialisedGame(lootDataPath);
 
   ASSERT_EQ(1, game.GetMessages().size());
@@ -829,6 +2188,43 @@ TEST_P(GameTest, clearingMessagesShouldRemoveAllAppendedMessages) {
 
   EXPECT_EQ(previousSize - messages.size(), game.GetMessages().size());
 }
+TEST_P(GameTest, getSimpleMessagesShouldReturnTheMessagesInTheGivenLanguage) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  const std::vector<MessageContent> content = std::vector<MessageContent>({
+      MessageContent("english", MessageContent::defaultLanguage),
+      MessageContent("french", "fr"),
+  });
+  game.AppendMessage(Message(MessageType::say, content));
+
+  auto messages = game.GetSimpleMessages("fr");
+
+  ASSERT_EQ(2, messages.size());
+  EXPECT_EQ("french", messages[1].text);
+  EXPECT_EQ("english", game.GetSimpleMessages("en")[1].text);
+}
+
+TEST_P(GameTest, getSimpleMessagesShouldReflectAppendedAndClearedMessages) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  ASSERT_EQ(1, game.GetSimpleMessages("en").size());
+
+  game.AppendMessage(Message(MessageType::say, "1"));
+  ASSERT_EQ(2, game.GetSimpleMessages("en").size());
+  EXPECT_EQ("1", game.GetSimpleMessages("en")[1].text);
+
+  game.ClearMessages();
+  EXPECT_EQ(1, game.GetSimpleMessages("en").size());
+}
+
+TEST_P(GameTest, getSimpleMessagesShouldReflectChangesToTheLoadOrderSortCount) {
+  Game game = CreateInitialisedGame(lootDataPath);
+  ASSERT_EQ(1, game.GetSimpleMessages("en").size());
+
+  game.IncrementLoadOrderSortCount();
+  EXPECT_TRUE(game.GetSimpleMessages("en").empty());
+
+  game.DecrementLoadOrderSortCount();
+  EXPECT_EQ(1, game.GetSimpleMessages("en").size());
+}
 }
 }
 }
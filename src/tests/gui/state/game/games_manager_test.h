@@ -31,8 +31,38 @@ along with LOOT.  If not, see
 
 namespace loot {
 namespace test {
+struct GameDetectionGate {
+  // Returns false if the gate didn't open in time.
+  bool Pass() {
+    std::unique_lock<std::mutex> lock(mutex);
+    ++arrivals;
+    opened.notify_all();
+    const auto passed = opened.wait_for(lock, std::chrono::seconds(5), [&]() {
+      return isOpen || arrivals >= requiredArrivals;
+    });
+    ++departures;
+    opened.notify_all();
+    return passed;
+  }
+
+  void Open() {
+    std::lock_guard<std::mutex> guard(mutex);
+    isOpen = true;
+    opened.notify_all();
+  }
+
+  std::mutex mutex;
+  std::condition_variable opened;
+  size_t arrivals = 0;
+  size_t departures = 0;
+  size_t requiredArrivals = 0;
+  bool isOpen = false;
+};
+
 class TestGamesManager : public GamesManager {
 public:
+  ~TestGamesManager() { StopPreloadingGames(); }
+
   int GetInitialiseCount(const std::string& folderName) {
     auto it = initialiseCounts_.find(folderName);
     if (it == initialiseCounts_.end()) {
@@ -42,15 +72,58 @@ public:
     }
   }
 
-private:
-  std::optional<std::filesystem::path> FindGamePath(
-      const GameSettings& gameSettings) const {
-    if (gameSettings.Type() == GameType::tes5 ||
-        gameSettings.Type() == GameType::fonv) {
-      return gameSettings.GamePath() / gameSettings.FolderName();
+  int GetPreloadCount(const std::string& folderName) {
+    std::lock_guard<std::mutex> guard(preloadCountsMutex_);
+
+    auto it = preloadCounts_.find(folderName);
+    if (it == preloadCounts_.end()) {
+      return 0;
+    } else {
+      return it->second;
     }
+  }
 
-    return std::nullopt;
+  int GetUnloadCount(const std::string& folderName) {
+    auto it = unloadCounts_.find(folderName);
+    if (it == unloadCounts_.end()) {
+      return 0;
+    } else {
+      return it->second;
+    }
+  }
+
+  void SetLoadedPluginCount(size_t count) { loadedPluginCount_ = count; }
+
+  // Searches for games of the given type won't finish until the returned
+  // gate is opened or the given number of them are running at once, and
+  // don't find the game if neither happens within a few seconds.
+  std::shared_ptr<GameDetectionGate> SetGatedGameType(
+      GameType gameType,
+      size_t requiredConcurrentSearches = std::numeric_limits<size_t>::max()) {
+    gatedGameType_ = gameType;
+    gate_ = std::make_shared<GameDetectionGate>();
+    gate_->requiredArrivals = requiredConcurrentSearches;
+    return gate_;
+  }
+
+private:
+  GamePathFinder GetGamePathFinder() const {
+    return [gatedGameType = gatedGameType_,
+            gate = gate_](const GameSettings& gameSettings)
+               -> std::optional<std::filesystem::path> {
+      if (gatedGameType.has_value() && gameSettings.Type() == gatedGameType &&
+          !gate->Pass()) {
+        return std::nullopt;
+      }
+
+      if (gameSettings.Type() == GameType::tes5 ||
+          gameSettings.Type() == GameType::fonv ||
+          gameSettings.Type() == GameType::fo4) {
+        return gameSettings.GamePath() / gameSettings.FolderName();
+      }
+
+      return std::nullopt;
+    };
   }
 
   void InitialiseGameData(gui::Game& game) {
@@ -62,7 +135,41 @@ private:
     }
   }
 
+  void PreloadGameData(gui::Game& game) {
+    std::lock_guard<std::mutex> guard(preloadCountsMutex_);
+
+    auto it = preloadCounts_.find(game.FolderName());
+    if (it == preloadCounts_.end()) {
+      preloadCounts_.emplace(game.FolderName(), 1);
+    } else {
+      it->second++;
+    }
+  }
+
+  void UnloadGameData(gui::Game& game) {
+    auto it = unloadCounts_.find(game.FolderName());
+    if (it == unloadCounts_.end()) {
+      unloadCounts_.emplace(game.FolderName(), 1);
+    } else {
+      it->second++;
+    }
+  }
+
+  gui::Game::MemoryUsage GetMemoryUsage(const gui::Game& game) const {
+    gui::Game::MemoryUsage usage;
+    usage.pluginCount = loadedPluginCount_;
+    usage.estimatedBytes = loadedPluginCount_ * 1024;
+    return usage;
+  }
+
   mutable std::map<std::string, unsigned int> initialiseCounts_;
+  std::map<std::string, unsigned int> unloadCounts_;
+
+  std::mutex preloadCountsMutex_;
+  std::map<std::string, unsigned int> preloadCounts_;
+  size_t loadedPluginCount_ = 0;
+  std::optional<GameType> gatedGameType_;
+  std::shared_ptr<GameDetectionGate> gate_;
 };
 
 TEST(GamesManager,
@@ -248,6 +355,88 @@ TEST(
   EXPECT_EQ(newGameSettings.RepoBranch(), settings[0].RepoBranch());
 }
 
+TEST(GamesManager,
+     loadInstalledGamesShouldNotMoveTheCurrentGameIfItIsUpdated) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  auto currentFolderName = GameSettings(GameType::fonv).FolderName();
+  manager.SetCurrentGame(currentFolderName);
+  auto& currentGame = manager.GetCurrentGame();
+
+  // Removing the game before the current game would move it if the games were
+  // stored by value.
+  manager.LoadInstalledGames({GameSettings(GameType::fonv).SetName("new")},
+                             std::filesystem::path());
+
+  EXPECT_EQ(&currentGame, &manager.GetCurrentGame());
+  EXPECT_EQ("new", currentGame.Name());
+}
+
+TEST(GamesManager,
+     loadInstalledGamesShouldTreatGamesThatTakeTooLongToFindAsNotInstalled) {
+  TestGamesManager manager;
+  manager.SetGameDetectionTimeout(std::chrono::milliseconds(100));
+  auto gate = manager.SetGatedGameType(GameType::fo4);
+
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fo4),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  gate->Open();
+
+  EXPECT_EQ(std::vector<std::string>({
+                GameSettings(GameType::tes5).FolderName(),
+                GameSettings(GameType::fonv).FolderName(),
+            }),
+            manager.GetInstalledGameFolderNames());
+}
+
+TEST(GamesManager, loadInstalledGamesShouldFindGamesConcurrently) {
+  TestGamesManager manager;
+  manager.SetGameDetectionTimeout(std::chrono::seconds(30));
+  manager.SetGatedGameType(GameType::tes5, 3);
+
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::tes5, "other"),
+          GameSettings(GameType::tes5, "another"),
+      },
+      std::filesystem::path());
+
+  EXPECT_EQ(3, manager.GetInstalledGameFolderNames().size());
+}
+
+TEST(GamesManager,
+     destroyingAManagerShouldNotWaitForGameDetectionThatTimedOut) {
+  std::shared_ptr<GameDetectionGate> gate;
+  {
+    TestGamesManager manager;
+    manager.SetGameDetectionTimeout(std::chrono::milliseconds(100));
+    gate = manager.SetGatedGameType(GameType::fo4);
+
+    manager.LoadInstalledGames({GameSettings(GameType::fo4)},
+                               std::filesystem::path());
+  }
+
+  std::unique_lock<std::mutex> lock(gate->mutex);
+  EXPECT_EQ(0u, gate->departures);
+
+  // Let the search finish so that it doesn't outlive the test.
+  gate->isOpen = true;
+  gate->opened.notify_all();
+  gate->opened.wait(lock, [&]() { return gate->departures == 1; });
+}
+
 TEST(GamesManager, getCurrentGameShouldThrowIfNoGamesAreInstalled) {
   TestGamesManager manager;
   EXPECT_THROW(manager.GetCurrentGame(), std::runtime_error);
@@ -299,6 +488,346 @@ TEST(GamesManager, setCurrentGameShouldInitialiseGameData) {
       1, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
 }
 
+TEST(GamesManager,
+     preloadGamesShouldPreloadInstalledGamesOtherThanTheCurrentGame) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes4),
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  manager.PreloadGames();
+  manager.WaitForPreloadedGames();
+
+  EXPECT_EQ(0,
+            manager.GetPreloadCount(GameSettings(GameType::tes5).FolderName()));
+  EXPECT_EQ(1,
+            manager.GetPreloadCount(GameSettings(GameType::fonv).FolderName()));
+}
+
+TEST(GamesManager, setCurrentGameShouldNotInitialiseAPreloadedGame) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  manager.PreloadGames();
+  manager.WaitForPreloadedGames();
+
+  auto preloadedFolderName = GameSettings(GameType::fonv).FolderName();
+  manager.SetCurrentGame(preloadedFolderName);
+
+  EXPECT_EQ(preloadedFolderName, manager.GetCurrentGame().FolderName());
+  EXPECT_EQ(0, manager.GetInitialiseCount(preloadedFolderName));
+}
+
+TEST(GamesManager,
+     setCurrentGameShouldKeepThePreviousGameLoadedIfGamesArePreloaded) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  auto firstFolderName = GameSettings(GameType::tes5).FolderName();
+  manager.SetCurrentGame(firstFolderName);
+
+  manager.PreloadGames();
+  manager.WaitForPreloadedGames();
+
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(firstFolderName);
+
+  EXPECT_EQ(1, manager.GetInitialiseCount(firstFolderName));
+}
+
+TEST(GamesManager, preloadGamesShouldStopOnceThePluginLimitIsReached) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetLoadedPluginCount(1000);
+
+  manager.PreloadGames();
+  manager.WaitForPreloadedGames();
+
+  EXPECT_EQ(1,
+            manager.GetPreloadCount(GameSettings(GameType::fonv).FolderName()));
+  EXPECT_EQ(0,
+            manager.GetPreloadCount(GameSettings(GameType::fo4).FolderName()));
+}
+
+TEST(GamesManager, preloadGamesShouldPreloadThroughTheGameTaskRunner) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  std::vector<std::string> taskGameFolders;
+  manager.SetGameTaskRunner(
+      [&](const std::string& gameFolder, std::function<void()> task) {
+        taskGameFolders.push_back(gameFolder);
+        task();
+      });
+
+  manager.PreloadGames();
+  manager.WaitForPreloadedGames();
+
+  const auto folderName = GameSettings(GameType::fonv).FolderName();
+  EXPECT_EQ(std::vector<std::string>({folderName}), taskGameFolders);
+  EXPECT_EQ(1, manager.GetPreloadCount(folderName));
+}
+
+TEST(GamesManager,
+     preloadGamesShouldMoveOnIfTheGameTaskRunnerDiscardsATask) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  manager.SetGameTaskRunner(
+      [&](const std::string& gameFolder, std::function<void()> task) {
+        if (gameFolder != GameSettings(GameType::fonv).FolderName()) {
+          task();
+        }
+      });
+
+  manager.PreloadGames();
+  manager.WaitForPreloadedGames();
+
+  EXPECT_EQ(0,
+            manager.GetPreloadCount(GameSettings(GameType::fonv).FolderName()));
+  EXPECT_EQ(1,
+            manager.GetPreloadCount(GameSettings(GameType::fo4).FolderName()));
+}
+
+TEST(GamesManager,
+     unloadPreloadedGamesShouldUnloadPreloadedAndKeptGamesButNotTheCurrent) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+  const auto firstFolderName = GameSettings(GameType::tes5).FolderName();
+  const auto currentFolderName = GameSettings(GameType::fonv).FolderName();
+  const auto preloadedFolderName = GameSettings(GameType::fo4).FolderName();
+  manager.SetCurrentGame(firstFolderName);
+
+  manager.PreloadGames();
+  manager.WaitForPreloadedGames();
+  manager.SetCurrentGame(currentFolderName);
+
+  manager.StopPreloadingGames();
+  manager.UnloadPreloadedGames();
+
+  EXPECT_EQ(1, manager.GetUnloadCount(firstFolderName));
+  EXPECT_EQ(0, manager.GetUnloadCount(currentFolderName));
+  EXPECT_EQ(1, manager.GetUnloadCount(preloadedFolderName));
+
+  manager.SetCurrentGame(firstFolderName);
+
+  EXPECT_EQ(2, manager.GetInitialiseCount(firstFolderName));
+}
+
+TEST(GamesManager,
+     setCurrentGameShouldInitialiseThePreviousGameAgainByDefault) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  auto firstFolderName = GameSettings(GameType::tes5).FolderName();
+  manager.SetCurrentGame(firstFolderName);
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(firstFolderName);
+
+  EXPECT_EQ(2, manager.GetInitialiseCount(firstFolderName));
+}
+
+TEST(GamesManager,
+     setCurrentGameShouldUnloadTheLeastRecentlyUsedGameIfOverTheLimit) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+  manager.SetMaxLoadedGames(2);
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+
+  EXPECT_EQ(0,
+            manager.GetUnloadCount(GameSettings(GameType::tes5).FolderName()));
+
+  manager.SetCurrentGame(GameSettings(GameType::fo4).FolderName());
+
+  EXPECT_EQ(1,
+            manager.GetUnloadCount(GameSettings(GameType::tes5).FolderName()));
+  EXPECT_EQ(0,
+            manager.GetUnloadCount(GameSettings(GameType::fonv).FolderName()));
+  EXPECT_EQ(0,
+            manager.GetUnloadCount(GameSettings(GameType::fo4).FolderName()));
+}
+
+TEST(GamesManager, setCurrentGameShouldInitialiseAnUnloadedGameAgain) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+  manager.SetMaxLoadedGames(2);
+
+  auto firstFolderName = GameSettings(GameType::tes5).FolderName();
+  manager.SetCurrentGame(firstFolderName);
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fo4).FolderName());
+  manager.SetCurrentGame(firstFolderName);
+
+  EXPECT_EQ(firstFolderName, manager.GetCurrentGame().FolderName());
+  EXPECT_EQ(2, manager.GetInitialiseCount(firstFolderName));
+  EXPECT_EQ(1,
+            manager.GetUnloadCount(GameSettings(GameType::fonv).FolderName()));
+}
+
+TEST(GamesManager, setMaxLoadedGamesShouldUnloadGamesOverTheNewLimit) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fo4).FolderName());
+
+  manager.SetMaxLoadedGames(2);
+
+  EXPECT_EQ(1,
+            manager.GetUnloadCount(GameSettings(GameType::tes5).FolderName()));
+  EXPECT_EQ(0,
+            manager.GetUnloadCount(GameSettings(GameType::fonv).FolderName()));
+}
+
+TEST(GamesManager,
+     setCurrentGameShouldUnloadGamesThroughTheGameTaskRunnerIfOneIsSet) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+  manager.SetMaxLoadedGames(2);
+
+  std::vector<std::pair<std::string, std::function<void()>>> tasks;
+  manager.SetGameTaskRunner(
+      [&](const std::string& gameFolder, std::function<void()> task) {
+        tasks.emplace_back(gameFolder, task);
+      });
+
+  const auto firstFolderName = GameSettings(GameType::tes5).FolderName();
+  manager.SetCurrentGame(firstFolderName);
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fo4).FolderName());
+
+  ASSERT_EQ(1, tasks.size());
+  EXPECT_EQ(firstFolderName, tasks[0].first);
+  EXPECT_EQ(0, manager.GetUnloadCount(firstFolderName));
+
+  tasks[0].second();
+
+  EXPECT_EQ(1, manager.GetUnloadCount(firstFolderName));
+}
+
+TEST(GamesManager,
+     aGameTaskShouldNotUnloadAGameThatWasLoadedAgainBeforeItRan) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+  manager.SetMaxLoadedGames(2);
+
+  std::vector<std::function<void()>> tasks;
+  manager.SetGameTaskRunner(
+      [&](const std::string&, std::function<void()> task) {
+        tasks.push_back(task);
+      });
+
+  const auto firstFolderName = GameSettings(GameType::tes5).FolderName();
+  manager.SetCurrentGame(firstFolderName);
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fo4).FolderName());
+  manager.SetCurrentGame(firstFolderName);
+
+  ASSERT_EQ(2, tasks.size());
+  for (const auto& task : tasks) {
+    task();
+  }
+
+  EXPECT_EQ(0, manager.GetUnloadCount(firstFolderName));
+  EXPECT_EQ(1,
+            manager.GetUnloadCount(GameSettings(GameType::fonv).FolderName()));
+}
+
+TEST(GamesManager, setMaxLoadedGamesShouldNotAllowALimitBelowTwo) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  manager.SetMaxLoadedGames(1);
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+
+  EXPECT_EQ(0,
+            manager.GetUnloadCount(GameSettings(GameType::tes5).FolderName()));
+}
+
 TEST(GamesManager,
      getFirstInstalledGameFolderNameShouldReturnNulloptIfNoGamesAreInstalled) {
   TestGamesManager manager;
@@ -27,6 +27,10 @@
 
 #include "gui/state/game/helpers.h"
 
+#include <chrono>
+#include <filesystem>
+#include <regex>
+
 #include <gtest/gtest.h>
 
 namespace loot {
@@ -88,6 +92,34 @@ TEST(EscapeMarkdownSpecialChars, shouldNotEscapeNonSpecialCharacters) {
   EXPECT_EQ(text, EscapeMarkdownSpecialChars(text));
 }
 
+std::string RegexEscapeMarkdownSpecialChars(const std::string& text) {
+  auto specialCharsRegex = std::regex("([\\\\`*_{}\\[\\]()#+.!-])");
+  return std::regex_replace(text, specialCharsRegex, "\\$1");
+}
+
+std::string GetMarkdownEscapingSampleText() {
+  std::string text;
+  for (int i = 0; i < 50; ++i) {
+    text += "Requires [SKSE](https://skse.silverlock.org/) v2.0.17+ or "
+            "*later*, see `Data\\SKSE\\Plugins` & _readme_ #1! ";
+  }
+  return text;
+}
+
+TEST(EscapeMarkdownSpecialChars,
+     shouldGiveTheSameOutputAsARegexReplacementForAllCharacters) {
+  for (int i = 0; i < 256; ++i) {
+    const auto text = std::string("a") + static_cast<char>(i) + "b";
+    EXPECT_EQ(RegexEscapeMarkdownSpecialChars(text),
+              EscapeMarkdownSpecialChars(text))
+        << "for character code " << i;
+  }
+
+  const auto text = GetMarkdownEscapingSampleText();
+  EXPECT_EQ(RegexEscapeMarkdownSpecialChars(text),
+            EscapeMarkdownSpecialChars(text));
+}
+
 TEST(PlainTextMessage, shouldEscapeMarkdownSpecialCharacters) {
   auto message = PlainTextMessage(MessageType::say, "normal text\\`*_{}[]()#+-.!");
 
@@ -189,6 +221,81 @@ TEST(ToMessage,
       message.GetContent(MessageContent::defaultLanguage).GetText());
 }
 
+TEST(GetRedatedTimestamps, shouldReturnNothingIfTimestampsAlreadyIncrease) {
+  auto time = std::filesystem::file_time_type::clock::now();
+  std::vector<FileTimestamp> timestamps{
+      {"a.esm", time},
+      {"b.esp", time},
+      {"c.esp", time + std::chrono::seconds(1)},
+  };
+
+  EXPECT_TRUE(GetRedatedTimestamps(timestamps).empty());
+}
+
+TEST(GetRedatedTimestamps,
+     shouldDateEachOutOfOrderFileAMinuteAfterTheFileBeforeIt) {
+  auto time = std::filesystem::file_time_type::clock::now();
+  std::vector<FileTimestamp> timestamps{
+      {"a.esm", time},
+      {"b.esp", time - std::chrono::seconds(60)},
+      {"c.esp", time + std::chrono::seconds(300)},
+      {"d.esp", time},
+      {"e.esp", time - std::chrono::seconds(120)},
+  };
+
+  auto redated = GetRedatedTimestamps(timestamps);
+
+  ASSERT_EQ(3, redated.size());
+  EXPECT_EQ("b.esp", redated[0].path);
+  EXPECT_EQ(time + std::chrono::seconds(60), redated[0].time);
+  EXPECT_EQ("d.esp", redated[1].path);
+  EXPECT_EQ(time + std::chrono::seconds(360), redated[1].time);
+  EXPECT_EQ("e.esp", redated[2].path);
+  EXPECT_EQ(time + std::chrono::seconds(420), redated[2].time);
+}
+
+TEST(DiffPluginLists, shouldFindAddedAndRemovedPlugins) {
+  auto diff = DiffPluginLists({"a.esm", "b.esp", "c.esp"},
+                              {"a.esm", "d.esp", "c.esp", "e.esp"});
+
+  EXPECT_EQ(std::vector<std::string>({"d.esp", "e.esp"}), diff.added);
+  EXPECT_EQ(std::vector<std::string>({"b.esp"}), diff.removed);
+  EXPECT_TRUE(diff.moved.empty());
+}
+
+TEST(DiffPluginLists, shouldIgnoreCaseAndGhostExtensions) {
+  auto diff = DiffPluginLists({"A.esm", "b.esp.ghost", "C.esp.GHOST"},
+                              {"a.ESM", "B.esp", "c.esp"});
+
+  EXPECT_TRUE(diff.added.empty());
+  EXPECT_TRUE(diff.removed.empty());
+  EXPECT_TRUE(diff.moved.empty());
+}
+
+TEST(DiffPluginLists, shouldFindTheFewestPluginsThatNeedToBeMoved) {
+  auto diff = DiffPluginLists({"a.esm", "b.esp", "c.esp", "d.esp", "e.esp"},
+                              {"a.esm", "e.esp", "b.esp", "c.esp", "d.esp"});
+
+  EXPECT_EQ(std::vector<std::string>({"e.esp"}), diff.moved);
+
+  diff = DiffPluginLists({"a.esm", "b.esp", "c.esp", "d.esp"},
+                         {"d.esp", "c.esp", "b.esp", "a.esm"});
+
+  EXPECT_EQ(3, diff.moved.size());
+}
+
+TEST(CheckForRemovedPlugins, shouldWarnAboutEachRemovedPlugin) {
+  auto messages = CheckForRemovedPlugins({"a.esm", "b.esp.ghost", "c.esp"},
+                                         {"a.esm"});
+
+  ASSERT_EQ(2, messages.size());
+  EXPECT_EQ(MessageType::warn, messages[0].GetType());
+  EXPECT_NE(std::string::npos,
+            messages[0].GetContent()[0].GetText().find("b.esp.ghost"));
+  EXPECT_NE(std::string::npos,
+            messages[1].GetContent()[0].GetText().find("c.esp"));
+}
+
 TEST(SplitRegistryPath, shouldAssumeHKLMIfNoRootKeyIsGiven) {
   auto[rootKey, subKey, value] = SplitRegistryPath("sub\\key\\value");
 
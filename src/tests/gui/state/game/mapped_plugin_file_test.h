@@ -0,0 +1,207 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_MAPPED_PLUGIN_FILE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_MAPPED_PLUGIN_FILE_TEST
+
+#include "gui/state/game/mapped_plugin_file.h"
+
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+class MappedPluginFileTest : public loot::test::CommonGameTestFixture {
+protected:
+  MappedPluginFileTest() : pluginPath_(lootDataPath / "Records.esl") {}
+
+  // Write a plugin with a header record and a group that holds a record for
+  // each of the given FormIDs, using 24 byte record headers.
+  void writePlugin(const std::vector<uint32_t>& formIds) {
+    std::ofstream out(pluginPath_, std::ios::binary);
+    writeHeader(out, "TES4", 0, 0);
+    writeHeader(
+        out, "GRUP", static_cast<uint32_t>(24 * (formIds.size() + 1)), 0);
+    for (const auto formId : formIds) {
+      writeHeader(out, "ARMO", 0, formId);
+    }
+  }
+
+  static void writeHeader(std::ofstream& out,
+                          const char* type,
+                          uint32_t size,
+                          uint32_t formId) {
+    out.write(type, 4);
+    writeUint32(out, size);
+    writeUint32(out, 0);
+    writeUint32(out, formId);
+    writeUint32(out, 0);
+    writeUint32(out, 0);
+  }
+
+  static void writeUint32(std::ofstream& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  const std::filesystem::path pluginPath_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        MappedPluginFileTest,
+                        ::testing::Values(GameType::tes5se));
+
+TEST_P(MappedPluginFileTest, constructorShouldThrowIfTheFileDoesNotExist) {
+  EXPECT_THROW(MappedPluginFile(dataPath / missingEsp), std::system_error);
+}
+
+TEST_P(MappedPluginFileTest, sizeShouldBeTheSizeOfTheFile) {
+  MappedPluginFile file(dataPath / blankEsm);
+
+  EXPECT_EQ(std::filesystem::file_size(dataPath / blankEsm), file.Size());
+  EXPECT_NE(nullptr, file.Data());
+}
+
+TEST_P(MappedPluginFileTest, constructorShouldAcceptAnEmptyFile) {
+  std::ofstream(pluginPath_).close();
+
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_EQ(0, file.Size());
+  EXPECT_NO_THROW(file.WillNeed());
+}
+
+TEST_P(MappedPluginFileTest, fileIdShouldDifferBetweenFilesAndBeStable) {
+  writePlugin({0x01000800});
+  MappedPluginFile file(pluginPath_);
+  MappedPluginFile sameFile(pluginPath_);
+  MappedPluginFile otherFile(dataPath / blankEsm);
+
+  EXPECT_EQ(file.FileId(), sameFile.FileId());
+  EXPECT_NE(file.FileId(), otherFile.FileId());
+}
+
+TEST_P(MappedPluginFileTest, willNeedShouldAcceptLengthsPastTheEndOfTheFile) {
+  writePlugin({0x01000800});
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_NO_THROW(file.WillNeed(0));
+  EXPECT_NO_THROW(file.WillNeed(file.Size() * 2));
+}
+
+TEST_P(MappedPluginFileTest,
+       getHeaderRecordLengthShouldIncludeTheHeaderRecordsHeaderAndData) {
+  writePlugin({0x01000800});
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_EQ(24, file.GetHeaderRecordLength(GameType::tes5se));
+  EXPECT_NO_THROW(file.Read(file.GetHeaderRecordLength(GameType::tes5se)));
+}
+
+TEST_P(MappedPluginFileTest,
+       getHeaderRecordLengthShouldBeTheFileSizeIfTheFileIsTooSmall) {
+  std::ofstream(pluginPath_) << "TES4";
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_EQ(4, file.GetHeaderRecordLength(GameType::tes5se));
+}
+
+TEST_P(MappedPluginFileTest, readShouldStopAtTheEndOfTheFile) {
+  writePlugin({0x01000800});
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_NO_THROW(file.Read(file.Size() * 2));
+}
+
+TEST_P(MappedPluginFileTest,
+       isValidAsLightMasterShouldBeTrueIfNewRecordsHaveObjectIndicesInRange) {
+  writePlugin({0x01000800, 0x01000FFF});
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_EQ(true, file.IsValidAsLightMaster(GameType::tes5se, 1));
+}
+
+TEST_P(MappedPluginFileTest,
+       isValidAsLightMasterShouldBeFalseIfANewRecordHasAnObjectIndexOutOfRange) {
+  writePlugin({0x01000800, 0x01001000});
+  {
+    // Windows can't write to a file while it's mapped.
+    MappedPluginFile file(pluginPath_);
+
+    EXPECT_EQ(false, file.IsValidAsLightMaster(GameType::tes5se, 1));
+  }
+
+  writePlugin({0x010007FF});
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_EQ(false, file.IsValidAsLightMaster(GameType::tes5se, 1));
+}
+
+TEST_P(MappedPluginFileTest, isValidAsLightMasterShouldIgnoreOverrideRecords) {
+  writePlugin({0x00012345, 0x01000800});
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_EQ(true, file.IsValidAsLightMaster(GameType::tes5se, 1));
+  EXPECT_EQ(false, file.IsValidAsLightMaster(GameType::tes5se, 0));
+}
+
+TEST_P(MappedPluginFileTest,
+       isValidAsLightMasterShouldReturnNulloptIfRecordsAreTruncated) {
+  writePlugin({0x01000800});
+  std::filesystem::resize_file(pluginPath_, 24 * 3 - 1);
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_FALSE(file.IsValidAsLightMaster(GameType::tes5se, 1).has_value());
+}
+
+TEST_P(MappedPluginFileTest,
+       isValidAsLightMasterShouldReturnNulloptIfTheFileIsNotAPlugin) {
+  std::ofstream(pluginPath_) << "This isn't a plugin file.";
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_FALSE(file.IsValidAsLightMaster(GameType::tes5se, 0).has_value());
+}
+
+TEST_P(MappedPluginFileTest,
+       isValidAsLightMasterShouldReturnNulloptForMorrowind) {
+  writePlugin({0x01000800});
+  MappedPluginFile file(pluginPath_);
+
+  EXPECT_FALSE(file.IsValidAsLightMaster(GameType::tes3, 1).has_value());
+}
+}
+}
+}
+
+#endif
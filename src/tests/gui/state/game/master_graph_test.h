@@ -0,0 +1,130 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_MASTER_GRAPH_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_MASTER_GRAPH_TEST
+
+#include "gui/state/game/master_graph.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+typedef MasterGraph::Problem MasterProblem;
+typedef MasterGraph::ProblemType MasterProblemType;
+
+TEST(MasterGraph, getDependentsShouldReturnThePluginsThatHaveAPluginAsAMaster) {
+  MasterGraph graph;
+  graph.AddPlugin(0, {}, true, false);
+  graph.AddPlugin(1, {0}, false, false);
+  graph.AddPlugin(2, {0, 3}, false, false);
+
+  EXPECT_EQ(std::vector<PluginId>({1, 2}), graph.GetDependents(0));
+  EXPECT_EQ(std::vector<PluginId>({2}), graph.GetDependents(3));
+  EXPECT_TRUE(graph.GetDependents(1).empty());
+  EXPECT_TRUE(graph.GetDependents(10).empty());
+}
+
+TEST(MasterGraph, hasPluginShouldBeFalseForMastersThatHaveNotBeenAdded) {
+  MasterGraph graph;
+  graph.AddPlugin(1, {0}, false, false);
+
+  EXPECT_TRUE(graph.HasPlugin(1));
+  EXPECT_FALSE(graph.HasPlugin(0));
+  EXPECT_FALSE(graph.HasPlugin(2));
+}
+
+TEST(MasterGraph, validateAllShouldFindMissingAndInactiveMastersInMasterOrder) {
+  MasterGraph graph;
+  graph.AddPlugin(0, {}, true, false);
+  graph.AddPlugin(1, {}, true, false);
+  graph.AddPlugin(2, {3, 0, 1}, false, false);
+
+  graph.ValidateAll([](PluginId id) { return id != 3; },
+                    [](PluginId id) { return id != 1; });
+
+  EXPECT_EQ(std::vector<MasterProblem>({
+                MasterProblem{MasterProblemType::missingMaster, 3},
+                MasterProblem{MasterProblemType::inactiveMaster, 1},
+            }),
+            graph.GetProblems(2));
+  EXPECT_TRUE(graph.GetProblems(0).empty());
+  EXPECT_TRUE(graph.GetProblems(3).empty());
+}
+
+TEST(MasterGraph, validateAllShouldFindNonMasterMastersOfLightMasters) {
+  MasterGraph graph;
+  graph.AddPlugin(0, {}, true, false);
+  graph.AddPlugin(1, {}, false, false);
+  graph.AddPlugin(2, {0, 1, 3}, true, true);
+  graph.AddPlugin(4, {1}, false, false);
+
+  graph.ValidateAll([](PluginId) { return true; },
+                    [](PluginId) { return true; });
+
+  // Masters that haven't been added aren't known to be non-masters.
+  EXPECT_EQ(std::vector<MasterProblem>({
+                MasterProblem{MasterProblemType::nonMasterMaster, 1},
+            }),
+            graph.GetProblems(2));
+  EXPECT_TRUE(graph.GetProblems(4).empty());
+}
+
+TEST(MasterGraph,
+     validateDependentsShouldOnlyValidateTheChangedPluginsDependents) {
+  MasterGraph graph;
+  graph.AddPlugin(0, {}, true, false);
+  graph.AddPlugin(1, {}, true, false);
+  graph.AddPlugin(2, {0}, false, false);
+  graph.AddPlugin(3, {1}, false, false);
+
+  graph.ValidateAll([](PluginId) { return true; },
+                    [](PluginId) { return true; });
+
+  const auto isActive = [](PluginId) { return false; };
+  auto validated = graph.ValidateDependents(
+      {0}, [](PluginId) { return true; }, isActive);
+
+  EXPECT_EQ(std::unordered_set<PluginId>({2}), validated);
+  EXPECT_EQ(std::vector<MasterProblem>({
+                MasterProblem{MasterProblemType::inactiveMaster, 0},
+            }),
+            graph.GetProblems(2));
+  EXPECT_TRUE(graph.GetProblems(3).empty());
+}
+
+TEST(MasterGraph, addPluginShouldIgnoreAPluginThatHasAlreadyBeenAdded) {
+  MasterGraph graph;
+  graph.AddPlugin(1, {0}, false, false);
+  graph.AddPlugin(1, {0}, false, false);
+
+  EXPECT_EQ(std::vector<PluginId>({1}), graph.GetDependents(0));
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,110 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_MESSAGE_TEMPLATES_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_MESSAGE_TEMPLATES_TEST
+
+#include "gui/state/game/message_templates.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+TEST(MessageTemplates, formatShouldReturnATemplateThatArgumentsCanBeFedTo) {
+  MessageTemplates templates("en");
+
+  EXPECT_EQ(
+      "This plugin requires \"Blank.esm\" to be installed, but it is missing.",
+      (templates.Format(MessageTemplate::missingMaster) % "Blank.esm").str());
+  EXPECT_EQ("cleaner found dirty edits.",
+            (templates.Format(MessageTemplate::dirtyEditsWithNoCounts) %
+             "cleaner")
+                .str());
+}
+
+TEST(MessageTemplates, formatShouldReturnAnUnusedCopyOfTheTemplate) {
+  MessageTemplates templates("en");
+
+  auto first = templates.Format(MessageTemplate::nonExistentGroup) % "a";
+  auto second = templates.Format(MessageTemplate::nonExistentGroup) % "b";
+
+  EXPECT_EQ("This plugin belongs to the group \"a\", which does not exist.",
+            first.str());
+  EXPECT_EQ("This plugin belongs to the group \"b\", which does not exist.",
+            second.str());
+}
+
+TEST(MessageTemplates, translateShouldReturnTheTranslatedTemplateText) {
+  MessageTemplates templates("en");
+
+  EXPECT_EQ(
+      "This plugin contains records that have FormIDs outside the valid range "
+      "for an ESL plugin. Using this plugin will cause irreversible damage to "
+      "your game saves.",
+      templates.Translate(MessageTemplate::invalidLightMaster));
+}
+
+TEST(MessageTemplates, formatShouldSelectThePluralFormForTheGivenCount) {
+  MessageTemplates templates("en");
+
+  EXPECT_EQ(
+      "1 ITM record",
+      (templates.Format(PluralMessageTemplate::itmRecords, 1) % 1).str());
+  EXPECT_EQ(
+      "2 ITM records",
+      (templates.Format(PluralMessageTemplate::itmRecords, 2) % 2).str());
+  EXPECT_EQ("1000 deleted navmeshes",
+            (templates.Format(PluralMessageTemplate::deletedNavmeshes, 1000) %
+             1000)
+                .str());
+}
+
+TEST(LoadMessageTemplates, shouldNotReloadTemplatesForTheSameLanguage) {
+  LoadMessageTemplates("en");
+  auto templates = GetMessageTemplates();
+
+  LoadMessageTemplates("en");
+
+  EXPECT_EQ(templates, GetMessageTemplates());
+  EXPECT_EQ("en", GetMessageTemplates()->GetLanguage());
+}
+
+TEST(LoadMessageTemplates, shouldReloadTemplatesIfTheLanguageChanges) {
+  LoadMessageTemplates("en");
+  auto templates = GetMessageTemplates();
+
+  LoadMessageTemplates("de");
+
+  EXPECT_NE(templates, GetMessageTemplates());
+  EXPECT_EQ("de", GetMessageTemplates()->GetLanguage());
+
+  LoadMessageTemplates("en");
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_PLUGIN_NAME_TABLE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_PLUGIN_NAME_TABLE_TEST
+
+#include "gui/state/game/plugin_name_table.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+TEST(PluginNameTable, internShouldGiveDistinctNamesDenseIds) {
+  PluginNameTable table;
+
+  EXPECT_EQ(0, table.Intern("Blank.esm"));
+  EXPECT_EQ(1, table.Intern("Blank.esp"));
+  EXPECT_EQ(2, table.Size());
+}
+
+TEST(PluginNameTable, internShouldGiveNamesThatDifferOnlyInCaseTheSameId) {
+  PluginNameTable table;
+
+  auto id = table.Intern("Blank.esm");
+
+  EXPECT_EQ(id, table.Intern("Blank.esm"));
+  EXPECT_EQ(id, table.Intern("blank.ESM"));
+  EXPECT_EQ(1, table.Size());
+}
+
+TEST(PluginNameTable, findShouldReturnNulloptIfTheNameHasNotBeenInterned) {
+  PluginNameTable table;
+  table.Intern("Blank.esm");
+
+  EXPECT_FALSE(table.Find("Blank.esp").has_value());
+}
+
+TEST(PluginNameTable, findShouldIgnoreCase) {
+  PluginNameTable table;
+  auto id = table.Intern("Blank.esm");
+
+  EXPECT_EQ(id, table.Find("BLANK.esm"));
+  EXPECT_EQ(id, table.Find("Blank.esm"));
+  EXPECT_EQ(1, table.Size());
+}
+
+TEST(PluginNameTable, getNameShouldReturnTheNameAsItWasFirstInterned) {
+  PluginNameTable table;
+  auto id = table.Intern("Blank.esm");
+  table.Intern("blank.esm");
+
+  EXPECT_EQ("Blank.esm", table.GetName(id));
+}
+
+TEST(PluginNameTable, getNameShouldThrowIfTheIdIsNotInTheTable) {
+  PluginNameTable table;
+
+  EXPECT_THROW(table.GetName(0), std::out_of_range);
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_PLUGIN_VALIDITY_CACHE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_PLUGIN_VALIDITY_CACHE_TEST
+
+#include "gui/state/game/plugin_validity_cache.h"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+class PluginValidityCacheTest : public loot::test::CommonGameTestFixture {
+protected:
+  PluginValidityCacheTest() :
+      cachePath_(lootDataPath / "plugin_validity.bin"),
+      modificationTime_(std::filesystem::file_time_type::clock::now()) {}
+
+  const std::filesystem::path cachePath_;
+  const std::filesystem::file_time_type modificationTime_;
+  PluginValidityCache cache_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        PluginValidityCacheTest,
+                        ::testing::Values(GameType::tes5));
+
+TEST_P(PluginValidityCacheTest, isValidPluginShouldReturnNulloptByDefault) {
+  EXPECT_FALSE(cache_.IsValidPlugin(blankEsp, 10, modificationTime_));
+}
+
+TEST_P(PluginValidityCacheTest,
+       isValidPluginShouldReturnTheCachedValueIfSizeAndTimeMatch) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+  cache_.SetIsValidPlugin(blankEsm, 10, modificationTime_, false);
+
+  EXPECT_EQ(true, cache_.IsValidPlugin(blankEsp, 10, modificationTime_));
+  EXPECT_EQ(false, cache_.IsValidPlugin(blankEsm, 10, modificationTime_));
+}
+
+TEST_P(PluginValidityCacheTest, isValidPluginShouldBeCaseInsensitive) {
+  cache_.SetIsValidPlugin("Blank.esp", 10, modificationTime_, true);
+
+  EXPECT_EQ(true, cache_.IsValidPlugin("blank.ESP", 10, modificationTime_));
+}
+
+TEST_P(PluginValidityCacheTest,
+       isValidPluginShouldReturnNulloptIfSizeOrTimeDoNotMatch) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+
+  EXPECT_FALSE(cache_.IsValidPlugin(blankEsp, 11, modificationTime_));
+  EXPECT_FALSE(cache_.IsValidPlugin(
+      blankEsp, 10, modificationTime_ + std::chrono::seconds(1)));
+}
+
+TEST_P(PluginValidityCacheTest, getCRCShouldReturnNulloptIfNoCRCHasBeenSet) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+
+  EXPECT_FALSE(cache_.GetCRC(blankEsp, 10, modificationTime_));
+}
+
+TEST_P(PluginValidityCacheTest,
+       setCRCShouldOnlyCacheTheCRCIfTheFileHasAMatchingEntry) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+
+  cache_.SetCRC(blankEsp, 11, modificationTime_, 0x12345678);
+  cache_.SetCRC(blankEsm, 10, modificationTime_, 0x12345678);
+  EXPECT_FALSE(cache_.GetCRC(blankEsp, 10, modificationTime_));
+  EXPECT_FALSE(cache_.GetCRC(blankEsm, 10, modificationTime_));
+
+  cache_.SetCRC(blankEsp, 10, modificationTime_, 0x12345678);
+  EXPECT_EQ(0x12345678u, cache_.GetCRC(blankEsp, 10, modificationTime_));
+  EXPECT_FALSE(cache_.GetCRC(
+      blankEsp, 10, modificationTime_ + std::chrono::seconds(1)));
+}
+
+TEST_P(PluginValidityCacheTest, setIsValidPluginShouldClearTheCachedCRC) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+  cache_.SetCRC(blankEsp, 10, modificationTime_, 0x12345678);
+
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+
+  EXPECT_FALSE(cache_.GetCRC(blankEsp, 10, modificationTime_));
+}
+
+TEST_P(PluginValidityCacheTest, loadShouldLeaveTheCacheEmptyIfNoFileExists) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+
+  cache_.Load(cachePath_);
+
+  EXPECT_EQ(PluginValidityCache(), cache_);
+}
+
+TEST_P(PluginValidityCacheTest, loadShouldReadWhatSaveWrote) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+  cache_.SetIsValidPlugin(nonAsciiEsp, 20, modificationTime_, false);
+  cache_.SetCRC(blankEsp, 10, modificationTime_, 0x12345678);
+
+  cache_.Save(cachePath_);
+
+  PluginValidityCache loadedCache;
+  loadedCache.Load(cachePath_);
+
+  EXPECT_EQ(cache_, loadedCache);
+  EXPECT_EQ(true, loadedCache.IsValidPlugin(blankEsp, 10, modificationTime_));
+  EXPECT_EQ(false,
+            loadedCache.IsValidPlugin(nonAsciiEsp, 20, modificationTime_));
+  EXPECT_EQ(0x12345678u, loadedCache.GetCRC(blankEsp, 10, modificationTime_));
+  EXPECT_FALSE(loadedCache.GetCRC(nonAsciiEsp, 20, modificationTime_));
+}
+
+TEST_P(PluginValidityCacheTest, loadShouldLeaveTheCacheEmptyIfTheFileIsCorrupt) {
+  cache_.SetIsValidPlugin(blankEsp, 10, modificationTime_, true);
+  cache_.Save(cachePath_);
+
+  // Truncate the file partway through its only entry.
+  auto fileSize = std::filesystem::file_size(cachePath_);
+  std::filesystem::resize_file(cachePath_, fileSize - 4);
+
+  PluginValidityCache loadedCache;
+  loadedCache.Load(cachePath_);
+
+  EXPECT_EQ(PluginValidityCache(), loadedCache);
+}
+
+TEST_P(PluginValidityCacheTest,
+       loadShouldLeaveTheCacheEmptyIfTheFileIsNotAValidityCache) {
+  std::ofstream out(cachePath_);
+  out << "not a cache";
+  out.close();
+
+  cache_.Load(cachePath_);
+
+  EXPECT_EQ(PluginValidityCache(), cache_);
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_SORT_RESULT_CACHE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_SORT_RESULT_CACHE_TEST
+
+#include "gui/state/game/sort_result_cache.h"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+class SortResultCacheTest : public loot::test::CommonGameTestFixture {
+protected:
+  SortResultCacheTest() :
+      cachePath_(lootDataPath / "sort_result.bin"),
+      sortedPlugins_({blankEsm, blankDifferentEsm, blankEsp}) {
+    PluginFingerprint fingerprint;
+    fingerprint.fileSize = 10;
+    fingerprint.modificationTime =
+        std::filesystem::file_time_type::clock::now();
+    fingerprint.isActive = true;
+
+    inputs_.metadataKey = "key";
+    inputs_.loadOrder = {blankEsm, blankEsp, blankDifferentEsm};
+    inputs_.plugins = {{"blank.esm", fingerprint}, {"blank.esp", fingerprint}};
+    inputs_.dataDirectoryEntries = {{"blank.esm", fingerprint}};
+  }
+
+  const std::filesystem::path cachePath_;
+  const std::vector<std::string> sortedPlugins_;
+  SortResultCache::Inputs inputs_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        SortResultCacheTest,
+                        ::testing::Values(GameType::tes5));
+
+TEST_P(SortResultCacheTest, getSortedPluginsShouldReturnNulloptByDefault) {
+  EXPECT_FALSE(SortResultCache().GetSortedPlugins(inputs_).has_value());
+}
+
+TEST_P(SortResultCacheTest,
+       getSortedPluginsShouldReturnTheSortedPluginsIfTheInputsMatch) {
+  SortResultCache cache(inputs_, sortedPlugins_);
+
+  auto inputs = inputs_;
+  inputs.plugins.at("blank.esm").crc = 0xDEADBEEF;
+
+  EXPECT_EQ(sortedPlugins_, cache.GetSortedPlugins(inputs));
+}
+
+TEST_P(SortResultCacheTest,
+       getSortedPluginsShouldReturnNulloptIfAnyOfTheInputsDiffer) {
+  SortResultCache cache(inputs_, sortedPlugins_);
+
+  auto inputs = inputs_;
+  inputs.metadataKey = "other key";
+  EXPECT_FALSE(cache.GetSortedPlugins(inputs).has_value());
+
+  inputs = inputs_;
+  std::swap(inputs.loadOrder[0], inputs.loadOrder[1]);
+  EXPECT_FALSE(cache.GetSortedPlugins(inputs).has_value());
+
+  inputs = inputs_;
+  inputs.plugins.at("blank.esp").isActive = false;
+  EXPECT_FALSE(cache.GetSortedPlugins(inputs).has_value());
+
+  inputs = inputs_;
+  inputs.plugins.erase("blank.esp");
+  EXPECT_FALSE(cache.GetSortedPlugins(inputs).has_value());
+
+  inputs = inputs_;
+  inputs.dataDirectoryEntries.at("blank.esm").fileSize = 11;
+  EXPECT_FALSE(cache.GetSortedPlugins(inputs).has_value());
+}
+
+TEST_P(SortResultCacheTest, saveAndLoadShouldRoundTripTheCache) {
+  SortResultCache(inputs_, sortedPlugins_).Save(cachePath_);
+
+  SortResultCache cache;
+  cache.Load(cachePath_);
+
+  EXPECT_EQ(sortedPlugins_, cache.GetSortedPlugins(inputs_));
+}
+
+TEST_P(SortResultCacheTest, loadShouldLeaveTheCacheEmptyIfTheFileIsInvalid) {
+  std::ofstream(cachePath_) << "invalid";
+
+  SortResultCache cache(inputs_, sortedPlugins_);
+  cache.Load(cachePath_);
+
+  EXPECT_FALSE(cache.GetSortedPlugins(inputs_).has_value());
+}
+
+TEST_P(SortResultCacheTest, loadShouldLeaveTheCacheEmptyIfTheFileIsTruncated) {
+  SortResultCache(inputs_, sortedPlugins_).Save(cachePath_);
+  std::filesystem::resize_file(cachePath_,
+                               std::filesystem::file_size(cachePath_) - 1);
+
+  SortResultCache cache;
+  cache.Load(cachePath_);
+
+  EXPECT_FALSE(cache.GetSortedPlugins(inputs_).has_value());
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,138 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_STRING_POOL_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_STRING_POOL_TEST
+
+#include "gui/state/game/string_pool.h"
+
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+TEST(StringPool, internShouldReturnTheSameStringForEqualValues) {
+  StringPool pool;
+
+  auto first = pool.Intern("Do not clean.");
+  auto second = pool.Intern(std::string("Do not clean."));
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ("Do not clean.", *first);
+  EXPECT_EQ(1, pool.Size());
+}
+
+TEST(StringPool, internShouldReturnDifferentStringsForDifferentValues) {
+  StringPool pool;
+
+  auto first = pool.Intern("Relev");
+  auto second = pool.Intern("relev");
+
+  EXPECT_NE(first, second);
+  EXPECT_EQ(2, pool.Size());
+}
+
+TEST(StringPool, stringsShouldBeRemovedWhenTheyAreNoLongerHeld) {
+  StringPool pool;
+
+  auto first = pool.Intern("Relev");
+  pool.Intern("Delev");
+
+  EXPECT_EQ(1, pool.Size());
+
+  first.reset();
+
+  EXPECT_EQ(0, pool.Size());
+  EXPECT_EQ("Relev", *pool.Intern("Relev"));
+}
+
+TEST(StringPool, stringsShouldOutliveThePool) {
+  PooledString string;
+  {
+    StringPool pool;
+    string = pool.Intern("Relev");
+  }
+
+  EXPECT_EQ("Relev", *string);
+}
+
+TEST(StringPool, internShouldBeSafeToCallFromMultipleThreads) {
+  StringPool pool;
+
+  std::vector<std::future<PooledString>> futures;
+  for (int i = 0; i < 8; ++i) {
+    futures.push_back(std::async(std::launch::async, [&pool]() {
+      PooledString string;
+      for (int j = 0; j < 1000; ++j) {
+        string = pool.Intern("Relev");
+        pool.Intern("Delev");
+      }
+      return string;
+    }));
+  }
+
+  std::vector<PooledString> strings;
+  for (auto& future : futures) {
+    strings.push_back(future.get());
+  }
+
+  for (const auto& string : strings) {
+    EXPECT_EQ(strings[0], string);
+  }
+  EXPECT_EQ(1, pool.Size());
+}
+
+TEST(StringPool, equalStringsInternedOnDifferentThreadsShouldBeTheSame) {
+  StringPool pool;
+
+  std::vector<std::future<std::vector<PooledString>>> futures;
+  for (int i = 0; i < 8; ++i) {
+    futures.push_back(std::async(std::launch::async, [&pool]() {
+      std::vector<PooledString> strings;
+      for (int j = 0; j < 100; ++j) {
+        strings.push_back(pool.Intern(std::to_string(j)));
+      }
+      return strings;
+    }));
+  }
+
+  std::vector<std::vector<PooledString>> strings;
+  for (auto& future : futures) {
+    strings.push_back(future.get());
+  }
+
+  for (const auto& threadStrings : strings) {
+    EXPECT_EQ(strings[0], threadStrings);
+  }
+  EXPECT_EQ(100, pool.Size());
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_STATE_LOCALE_CACHE_TEST
+#define LOOT_TESTS_GUI_STATE_LOCALE_CACHE_TEST
+
+#include "gui/state/locale_cache.h"
+
+#include <boost/locale.hpp>
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(LocaleCache, getShouldGenerateAUtf8LocaleForTheGivenLanguage) {
+  LocaleCache cache("l10n");
+
+  auto locale = cache.Get("de");
+
+  const auto& info = std::use_facet<boost::locale::info>(locale);
+  EXPECT_EQ("de", info.language());
+  EXPECT_TRUE(info.utf8());
+}
+
+TEST(LocaleCache, getShouldReuseTheLocaleGeneratedForALanguage) {
+  LocaleCache cache("l10n");
+
+  auto locale = cache.Get("en");
+
+  EXPECT_EQ(locale, cache.Get("en"));
+  EXPECT_NE(locale, cache.Get("de"));
+}
+
+TEST(LocaleCache, getShouldReturnAPrefetchedLocale) {
+  LocaleCache cache("l10n");
+
+  cache.Prefetch("fr");
+  auto locale = cache.Get("fr");
+
+  EXPECT_EQ("fr", std::use_facet<boost::locale::info>(locale).language());
+  EXPECT_EQ(locale, cache.Get("fr"));
+}
+}
+}
+
+#endif
@@ -0,0 +1,199 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_STATE_LOG_BRIDGE_TEST
+#define LOOT_TESTS_GUI_STATE_LOG_BRIDGE_TEST
+
+#include "gui/state/log_bridge.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class LogBridgeTest : public ::testing::Test {
+protected:
+  LogBridgeTest() : start_(std::chrono::steady_clock::now()) {}
+
+  LogBridge createBridge(LogBridge::Limits limits) {
+    return LogBridge(
+        [this](spdlog::level::level_enum level, const std::string& message) {
+          lines_.emplace_back(level, message);
+        },
+        limits);
+  }
+
+  const std::chrono::steady_clock::time_point start_;
+  std::vector<std::pair<spdlog::level::level_enum, std::string>> lines_;
+};
+
+TEST_F(LogBridgeTest, getCategoryShouldReplaceQuotedTextAndNumbers) {
+  EXPECT_EQ("Adding edge from \"\" to \"\" at #.#",
+            LogBridge::GetCategory(
+                "Adding edge from \"A 1.esp\" to \"B.esp\" at 12.5"));
+}
+
+TEST_F(LogBridgeTest, logShouldOnlyLogASampleOfLinesOnceACategoryHitsItsLimit) {
+  LogBridge::Limits limits;
+  limits.linesPerCategory = 2;
+  limits.sampleInterval = 3;
+  auto bridge = createBridge(limits);
+
+  for (int i = 0; i < 8; ++i) {
+    bridge.Log(spdlog::level::debug, "Plugin " + std::to_string(i), start_);
+  }
+
+  ASSERT_EQ(4, lines_.size());
+  EXPECT_EQ("Plugin 0", lines_[0].second);
+  EXPECT_EQ("Plugin 1", lines_[1].second);
+  EXPECT_EQ("Plugin 4", lines_[2].second);
+  EXPECT_EQ("Plugin 7", lines_[3].second);
+}
+
+TEST_F(LogBridgeTest, logShouldAlwaysLogWarningsAndErrors) {
+  LogBridge::Limits limits;
+  limits.linesPerCategory = 0;
+  limits.sampleInterval = 0;
+  limits.linesPerSecond = 0;
+  auto bridge = createBridge(limits);
+
+  bridge.Log(spdlog::level::warn, "warning", start_);
+  bridge.Log(spdlog::level::err, "error", start_);
+  bridge.Log(spdlog::level::info, "info", start_);
+
+  ASSERT_EQ(2, lines_.size());
+  EXPECT_EQ("warning", lines_[0].second);
+  EXPECT_EQ("error", lines_[1].second);
+}
+
+TEST_F(LogBridgeTest, logShouldCountExactRepeatsOfThePreviousMessage) {
+  auto bridge = createBridge(LogBridge::Limits());
+
+  bridge.Log(spdlog::level::debug, "a", start_);
+  bridge.Log(spdlog::level::debug, "a", start_);
+  bridge.Log(spdlog::level::debug, "a", start_);
+  bridge.Log(spdlog::level::debug, "b", start_);
+
+  ASSERT_EQ(3, lines_.size());
+  EXPECT_EQ("a", lines_[0].second);
+  EXPECT_EQ("The previous message was repeated 2 times.", lines_[1].second);
+  EXPECT_EQ(spdlog::level::debug, lines_[1].first);
+  EXPECT_EQ("b", lines_[2].second);
+}
+
+TEST_F(LogBridgeTest, logShouldLimitTheNumberOfLinesLoggedPerSecond) {
+  LogBridge::Limits limits;
+  limits.linesPerSecond = 2;
+  auto bridge = createBridge(limits);
+
+  bridge.Log(spdlog::level::debug, "a", start_);
+  bridge.Log(spdlog::level::debug, "b", start_);
+  bridge.Log(spdlog::level::debug, "c", start_);
+  bridge.Log(spdlog::level::debug, "d", start_ + std::chrono::seconds(1));
+
+  ASSERT_EQ(3, lines_.size());
+  EXPECT_EQ("b", lines_[1].second);
+  EXPECT_EQ("d", lines_[2].second);
+}
+
+TEST_F(LogBridgeTest, summariseShouldLogTheNumberOfSuppressedLinesAndReset) {
+  LogBridge::Limits limits;
+  limits.linesPerCategory = 1;
+  limits.sampleInterval = 0;
+  auto bridge = createBridge(limits);
+
+  bridge.Log(spdlog::level::debug, "Plugin 1", start_);
+  bridge.Log(spdlog::level::debug, "Plugin 2", start_);
+  bridge.Log(spdlog::level::debug, "Plugin 3", start_);
+  bridge.Summarise("sorting plugins");
+  bridge.Log(spdlog::level::debug, "Plugin 4", start_);
+  bridge.Summarise("sorting plugins");
+
+  ASSERT_EQ(3, lines_.size());
+  EXPECT_EQ("Suppressed 2 similar lines while sorting plugins.",
+            lines_[1].second);
+  EXPECT_EQ("Plugin 4", lines_[2].second);
+}
+
+TEST_F(LogBridgeTest, operationsShouldSummariseOnlyTheirOwnSuppressedLines) {
+  LogBridge::Limits limits;
+  limits.linesPerCategory = 1;
+  limits.sampleInterval = 0;
+  auto bridge = createBridge(limits);
+
+  bridge.Log(spdlog::level::debug, "Plugin 1", start_);
+  bridge.Log(spdlog::level::debug, "Plugin 2", start_);
+  {
+    LogBridge::Operation operation(bridge, "sorting plugins");
+    bridge.Log(spdlog::level::debug, "Plugin 3", start_);
+    bridge.Log(spdlog::level::debug, "Plugin 4", start_);
+    bridge.Log(spdlog::level::debug, "Plugin 5", start_);
+
+    std::thread([&]() {
+      LogBridge::Operation otherOperation(bridge, "loading plugins");
+      bridge.Log(spdlog::level::debug, "Plugin 6", start_);
+    }).join();
+
+    bridge.Log(spdlog::level::debug, "Plugin 7", start_);
+  }
+  bridge.Summarise("doing other work");
+
+  ASSERT_EQ(5, lines_.size());
+  EXPECT_EQ("Plugin 1", lines_[0].second);
+  EXPECT_EQ("Plugin 3", lines_[1].second);
+  EXPECT_EQ("Plugin 6", lines_[2].second);
+  EXPECT_EQ("Suppressed 3 similar lines while sorting plugins.",
+            lines_[3].second);
+  EXPECT_EQ("Suppressed 1 similar lines while doing other work.",
+            lines_[4].second);
+}
+
+TEST_F(LogBridgeTest, logShouldWriteOutTheBacktraceBeforeAnError) {
+  LogBridge::Limits limits;
+  limits.linesPerCategory = 1;
+  limits.sampleInterval = 0;
+  limits.backtraceSize = 2;
+  auto bridge = createBridge(limits);
+
+  for (int i = 0; i < 4; ++i) {
+    bridge.Log(spdlog::level::debug, "Plugin " + std::to_string(i), start_);
+  }
+  bridge.Log(spdlog::level::err, "error", start_);
+  bridge.Log(spdlog::level::err, "error 2", start_);
+
+  ASSERT_EQ(6, lines_.size());
+  EXPECT_EQ("Plugin 0", lines_[0].second);
+  EXPECT_EQ(spdlog::level::err, lines_[1].first);
+  EXPECT_EQ("Plugin 2", lines_[2].second);
+  EXPECT_EQ(spdlog::level::debug, lines_[2].first);
+  EXPECT_EQ("Plugin 3", lines_[3].second);
+  EXPECT_EQ("error", lines_[4].second);
+  EXPECT_EQ("error 2", lines_[5].second);
+}
+}
+}
+
+#endif
@@ -66,6 +66,13 @@ TEST(LootPaths, getLogPathShouldUseLootDataPath) {
             paths.getLogPath());
 }
 
+TEST(LootPaths, getStartupHistoryPathShouldUseLootDataPath) {
+  LootPaths paths("", "");
+
+  EXPECT_EQ(paths.getLootDataPath() / "startup_history.jsonl",
+            paths.getStartupHistoryPath());
+}
+
 TEST(LootPaths, constructorShouldSetAppPathToExecutableDirectoryIfGivenPathIsEmpty) {
   LootPaths paths("", "");
 
@@ -25,13 +25,16 @@ along with LOOT.  If not, see
 #ifndef LOOT_TESTS_GUI_STATE_LOOT_SETTINGS_TEST
 #define LOOT_TESTS_GUI_STATE_LOOT_SETTINGS_TEST
 
+#include <atomic>
 #include <fstream>
+#include <thread>
 
 #include "gui/state/loot_settings.h"
 
 #include <gtest/gtest.h>
 
 #include "gui/version.h"
+#include "tests/gui/test_helpers.h"
 
 namespace loot {
 bool operator==(const LootSettings::Language& lhs,
@@ -80,6 +83,11 @@ TEST_P(LootSettingsTest, defaultConstructorShouldSetDefaultValues) {
   EXPECT_FALSE(settings_.isDebugLoggingEnabled());
   EXPECT_TRUE(settings_.updateMasterlist());
   EXPECT_TRUE(settings_.isLootUpdateCheckEnabled());
+  EXPECT_FALSE(settings_.shouldPreloadGames());
+  EXPECT_FALSE(settings_.isLowFootprintModeEnabled());
+  EXPECT_EQ(3, settings_.getMaxLoadedGames());
+  EXPECT_EQ(0, settings_.getPluginReadingThreads());
+  EXPECT_EQ(1024, settings_.getCacheBudgetMiB());
   EXPECT_EQ("auto", settings_.getGame());
   EXPECT_EQ("auto", settings_.getLastGame());
   EXPECT_TRUE(settings_.getLastVersion().empty());
@@ -180,6 +188,11 @@ TEST_P(LootSettingsTest, loadingShouldReadFromATomlFile) {
   out << "enableDebugLogging = true" << endl
       << "updateMasterlist = true" << endl
       << "enableLootUpdateCheck = false" << endl
+      << "preloadGames = true" << endl
+      << "lowFootprintMode = true" << endl
+      << "maxLoadedGames = 5" << endl
+      << "pluginReadingThreads = 2" << endl
+      << "cacheBudgetMiB = 512" << endl
       << "game = \"Oblivion\"" << endl
       << "lastGame = \"Skyrim\"" << endl
       << "language = \"fr\"" << endl
@@ -212,6 +225,11 @@ TEST_P(LootSettingsTest, loadingShouldReadFromATomlFile) {
   EXPECT_TRUE(settings_.isDebugLoggingEnabled());
   EXPECT_TRUE(settings_.updateMasterlist());
   EXPECT_FALSE(settings_.isLootUpdateCheckEnabled());
+  EXPECT_TRUE(settings_.shouldPreloadGames());
+  EXPECT_TRUE(settings_.isLowFootprintModeEnabled());
+  EXPECT_EQ(5, settings_.getMaxLoadedGames());
+  EXPECT_EQ(2, settings_.getPluginReadingThreads());
+  EXPECT_EQ(512, settings_.getCacheBudgetMiB());
   EXPECT_EQ("Oblivion", settings_.getGame());
   EXPECT_EQ("Skyrim", settings_.getLastGame());
   EXPECT_EQ("0.7.1", settings_.getLastVersion());
@@ -443,6 +461,11 @@ TEST_P(LootSettingsTest, saveShouldWriteSettingsToPassedTomlFile) {
   settings_.enableDebugLogging(true);
   settings_.updateMasterlist(true);
   settings_.enableLootUpdateCheck(false);
+  settings_.setPreloadGames(true);
+  settings_.enableLowFootprintMode(true);
+  settings_.setMaxLoadedGames(5);
+  settings_.setPluginReadingThreads(2);
+  settings_.setCacheBudgetMiB(512);
   settings_.setDefaultGame(game);
   settings_.storeLastGame(lastGame);
   settings_.setLanguage(language);
@@ -462,6 +485,11 @@ TEST_P(LootSettingsTest, saveShouldWriteSettingsToPassedTomlFile) {
   EXPECT_TRUE(settings.isDebugLoggingEnabled());
   EXPECT_TRUE(settings.updateMasterlist());
   EXPECT_FALSE(settings.isLootUpdateCheckEnabled());
+  EXPECT_TRUE(settings.shouldPreloadGames());
+  EXPECT_TRUE(settings.isLowFootprintModeEnabled());
+  EXPECT_EQ(5, settings.getMaxLoadedGames());
+  EXPECT_EQ(2, settings.getPluginReadingThreads());
+  EXPECT_EQ(512, settings.getCacheBudgetMiB());
   EXPECT_EQ(game, settings.getGame());
   EXPECT_EQ(lastGame, settings.getLastGame());
   EXPECT_EQ(language, settings.getLanguage());
@@ -498,6 +526,119 @@ TEST_P(LootSettingsTest, saveShouldWriteNonAsciiPathsAsUtf8) {
   EXPECT_NE(std::string::npos, contents.find(u8"non\u00C1sciiGameLocalPath"));
 }
 
+TEST_P(LootSettingsTest, saveShouldNotLeaveATemporaryFileBehind) {
+  settings_.save(settingsFile_);
+
+  EXPECT_TRUE(std::filesystem::exists(settingsFile_));
+  EXPECT_FALSE(std::filesystem::exists(settingsFile_.string() + ".tmp"));
+}
+
+TEST_P(LootSettingsTest, storeFilterStateShouldAutosaveSettingsIfEnabled) {
+  settings_.enableAutosave(settingsFile_, std::chrono::milliseconds(10));
+  settings_.storeFilterState("hideCRCs", true);
+
+  // The settings file is written to a temporary path and then renamed, so it
+  // is complete once it exists.
+  ASSERT_TRUE(
+      waitUntil([&]() { return std::filesystem::exists(settingsFile_); }));
+
+  LootSettings settings;
+  settings.load(settingsFile_, lootDataPath);
+  EXPECT_TRUE(settings.getFilters().at("hideCRCs"));
+}
+
+TEST_P(LootSettingsTest, storeFilterStateShouldNotSaveSettingsIfUnchanged) {
+  settings_.storeFilterState("hideCRCs", true);
+  settings_.enableAutosave(settingsFile_, std::chrono::milliseconds(10));
+  settings_.storeFilterState("hideCRCs", true);
+
+  // Flushing writes any scheduled save, and waits for any save in progress.
+  settings_.flushSave();
+
+  EXPECT_FALSE(std::filesystem::exists(settingsFile_));
+}
+
+TEST_P(LootSettingsTest, storeWindowPositionShouldNotSaveSettingsIfUnchanged) {
+  LootSettings::WindowPosition position;
+  position.top = 1;
+  settings_.storeWindowPosition(position);
+  settings_.enableAutosave(settingsFile_, std::chrono::milliseconds(10));
+  settings_.storeWindowPosition(position);
+
+  settings_.flushSave();
+
+  EXPECT_FALSE(std::filesystem::exists(settingsFile_));
+}
+
+TEST_P(LootSettingsTest, storeGameSettingsShouldNotSaveSettingsIfUnchanged) {
+  settings_.enableAutosave(settingsFile_, std::chrono::milliseconds(10));
+  settings_.storeGameSettings(settings_.getGameSettings());
+
+  settings_.flushSave();
+
+  EXPECT_FALSE(std::filesystem::exists(settingsFile_));
+}
+
+TEST_P(LootSettingsTest, storeGameSettingsShouldSaveSettingsIfAPathChanged) {
+  auto gameSettings = settings_.getGameSettings();
+  gameSettings.front().SetGamePath(dataPath.parent_path());
+  settings_.enableAutosave(settingsFile_, std::chrono::seconds(60));
+  settings_.storeGameSettings(gameSettings);
+
+  settings_.flushSave();
+
+  EXPECT_TRUE(std::filesystem::exists(settingsFile_));
+}
+
+TEST_P(LootSettingsTest, flushSaveShouldWriteAPendingAutosave) {
+  settings_.enableAutosave(settingsFile_, std::chrono::seconds(60));
+  settings_.storeLastGame("Fallout3");
+
+  settings_.flushSave();
+
+  LootSettings settings;
+  settings.load(settingsFile_, lootDataPath);
+  EXPECT_EQ("Fallout3", settings.getLastGame());
+}
+
+TEST_P(LootSettingsTest, scheduleSaveShouldReturnFalseIfAutosaveIsNotEnabled) {
+  EXPECT_FALSE(settings_.scheduleSave());
+
+  settings_.enableAutosave(settingsFile_, std::chrono::seconds(60));
+
+  EXPECT_TRUE(settings_.scheduleSave());
+}
+
+TEST_P(LootSettingsTest, getSnapshotShouldNotBeAffectedByLaterChanges) {
+  settings_.setLanguage("fr");
+  auto snapshot = settings_.getSnapshot();
+
+  settings_.setLanguage("de");
+  settings_.storeFilterState("hideCRCs", true);
+
+  EXPECT_EQ("fr", snapshot->language);
+  EXPECT_TRUE(snapshot->filters.empty());
+  EXPECT_EQ("de", settings_.getSnapshot()->language);
+  EXPECT_TRUE(settings_.getSnapshot()->filters.at("hideCRCs"));
+}
+
+TEST_P(LootSettingsTest, gettersShouldBeSafeToCallWhileSettingsAreChanged) {
+  std::atomic<bool> stop(false);
+  std::thread writer([&]() {
+    for (int i = 0; !stop; ++i) {
+      settings_.setLanguage(i % 2 == 0 ? "fr" : "de");
+    }
+  });
+
+  for (int i = 0; i < 10000; ++i) {
+    auto language = settings_.getLanguage();
+    EXPECT_TRUE(language == "en" || language == "fr" || language == "de");
+  }
+
+  stop = true;
+  writer.join();
+}
+
 TEST_P(LootSettingsTest, storeGameSettingsShouldReplaceExistingGameSettings) {
   const std::vector<GameSettings> gameSettings({GameSettings(GameType::tes5)});
   settings_.storeGameSettings(gameSettings);
@@ -0,0 +1,134 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2019 WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_MEMORY_ACCOUNTING_TEST
+#define LOOT_TESTS_GUI_STATE_MEMORY_ACCOUNTING_TEST
+
+#include "gui/state/memory_accounting.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class ScopedAllocationCounterTest : public ::testing::Test {
+protected:
+  void SetUp() override { SetAllocationAccountingEnabled(true); }
+
+  void TearDown() override { SetAllocationAccountingEnabled(false); }
+
+  // Call operator new directly, as allocations made by new expressions can be
+  // optimised away.
+  static void allocateAndFree(size_t bytes) {
+    ::operator delete(::operator new(bytes));
+  }
+};
+
+TEST_F(ScopedAllocationCounterTest,
+       getCountsShouldReturnZeroesIfAccountingIsDisabled) {
+  SetAllocationAccountingEnabled(false);
+  ScopedAllocationCounter counter;
+
+  allocateAndFree(1000);
+
+  EXPECT_EQ(0, counter.GetCounts().count);
+  EXPECT_EQ(0, counter.GetCounts().bytes);
+  EXPECT_EQ(0, counter.GetCounts().peakBytes);
+}
+
+TEST_F(ScopedAllocationCounterTest,
+       getCountsShouldCountTheAllocationsMadeSinceConstruction) {
+  allocateAndFree(1000);
+  ScopedAllocationCounter counter;
+
+  allocateAndFree(1000);
+  allocateAndFree(500);
+
+  const auto counts = counter.GetCounts();
+  EXPECT_EQ(2, counts.count);
+  EXPECT_LE(1500, counts.bytes);
+  EXPECT_LE(1000, counts.peakBytes);
+  EXPECT_GT(counts.bytes, counts.peakBytes);
+}
+
+TEST_F(ScopedAllocationCounterTest,
+       getCountsShouldNotCountAllocationsMadeOnOtherThreads) {
+  ScopedAllocationCounter counter;
+
+  std::thread([]() { allocateAndFree(1000); }).join();
+
+  EXPECT_GT(1000, counter.GetCounts().bytes);
+}
+
+TEST_F(ScopedAllocationCounterTest,
+       anInnerCounterShouldNotLowerTheOuterCountersPeak) {
+  ScopedAllocationCounter outer;
+  allocateAndFree(2000);
+
+  {
+    ScopedAllocationCounter inner;
+    allocateAndFree(100);
+
+    EXPECT_GT(2000, inner.GetCounts().peakBytes);
+  }
+
+  EXPECT_LE(2000, outer.GetCounts().peakBytes);
+}
+
+TEST(SampleProcessMemory, shouldReturnNonZeroSizes) {
+  const auto sample = SampleProcessMemory();
+
+  ASSERT_TRUE(sample.has_value());
+  EXPECT_LT(0, sample.value().residentBytes);
+  EXPECT_LT(0, sample.value().committedBytes);
+}
+
+TEST(ProcessMemoryHistory, recordShouldDropTheOldestSampleOnceFull) {
+  ProcessMemoryHistory history;
+
+  for (size_t i = 0; i <= ProcessMemoryHistory::CAPACITY; ++i) {
+    ProcessMemorySample sample;
+    sample.residentBytes = i;
+    history.Record(sample);
+  }
+
+  const auto samples = history.GetSamples();
+  ASSERT_EQ(ProcessMemoryHistory::CAPACITY, samples.size());
+  EXPECT_EQ(1, samples.front().residentBytes);
+  EXPECT_EQ(ProcessMemoryHistory::CAPACITY, samples.back().residentBytes);
+}
+
+TEST(ProcessMemorySampler, shouldRecordASampleWhenConstructed) {
+  ProcessMemoryHistory history;
+
+  { ProcessMemorySampler sampler(std::chrono::hours(1), history); }
+
+  EXPECT_EQ(1, history.GetSamples().size());
+}
+}
+}
+
+#endif
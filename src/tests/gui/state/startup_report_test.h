@@ -0,0 +1,129 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_STATE_STARTUP_REPORT_TEST
+#define LOOT_TESTS_GUI_STATE_STARTUP_REPORT_TEST
+
+#include "gui/state/startup_report.h"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#undef min
+#include <json.hpp>
+
+namespace loot {
+namespace test {
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+class StartupReportTest : public ::testing::Test {
+protected:
+  StartupReportTest() :
+      historyPath_(std::filesystem::temp_directory_path() /
+                   "LOOT-startup-history-test.jsonl") {}
+
+  void SetUp() override { std::filesystem::remove(historyPath_); }
+
+  void TearDown() override { std::filesystem::remove(historyPath_); }
+
+  std::vector<nlohmann::json> readHistory() const {
+    std::vector<nlohmann::json> entries;
+    std::ifstream in(historyPath_);
+    std::string line;
+    while (std::getline(in, line)) {
+      entries.push_back(nlohmann::json::parse(line));
+    }
+    return entries;
+  }
+
+  const std::filesystem::path historyPath_;
+};
+
+TEST_F(StartupReportTest,
+       recordMilestoneShouldRecordTheTimeSinceTheProcessStarted) {
+  const auto start = steady_clock::now();
+  StartupReport report(start);
+
+  EXPECT_TRUE(report.RecordMilestone("a", start + milliseconds(2)));
+  EXPECT_TRUE(report.RecordMilestone("b", start + milliseconds(5)));
+
+  const auto milestones = report.GetMilestones();
+  ASSERT_EQ(2, milestones.size());
+  EXPECT_EQ("a", milestones[0].name);
+  EXPECT_EQ(2000, milestones[0].microseconds);
+  EXPECT_EQ("b", milestones[1].name);
+  EXPECT_EQ(5000, milestones[1].microseconds);
+}
+
+TEST_F(StartupReportTest, recordMilestoneShouldOnlyRecordTheFirstTime) {
+  const auto start = steady_clock::now();
+  StartupReport report(start);
+
+  EXPECT_TRUE(report.RecordMilestone("a", start + milliseconds(2)));
+  EXPECT_FALSE(report.RecordMilestone("a", start + milliseconds(5)));
+
+  ASSERT_EQ(1, report.GetMilestones().size());
+  EXPECT_EQ(2000, report.GetMilestones()[0].microseconds);
+}
+
+TEST_F(StartupReportTest,
+       writeShouldAppendTheMilestonesToTheHistoryFileOnlyOnce) {
+  const auto start = steady_clock::now();
+  StartupReport report(start);
+  report.RecordMilestone("a", start + milliseconds(2));
+
+  EXPECT_TRUE(report.Write(historyPath_));
+  EXPECT_FALSE(report.Write(historyPath_));
+  EXPECT_FALSE(report.RecordMilestone("b"));
+
+  const auto history = readHistory();
+  ASSERT_EQ(1, history.size());
+  ASSERT_EQ(1, history[0].at("milestones").size());
+  EXPECT_EQ("a", history[0]["milestones"][0].at("name"));
+  EXPECT_EQ(2000, history[0]["milestones"][0].at("microseconds"));
+  EXPECT_EQ(1, history[0].count("version"));
+  EXPECT_EQ(1, history[0].count("time"));
+}
+
+TEST_F(StartupReportTest, writeShouldOnlyKeepTheMostRecentEntries) {
+  for (int i = 0; i < 3; ++i) {
+    const auto start = steady_clock::now();
+    StartupReport report(start);
+    report.RecordMilestone("a", start + milliseconds(i));
+
+    report.Write(historyPath_, 2);
+  }
+
+  const auto history = readHistory();
+  ASSERT_EQ(2, history.size());
+  EXPECT_EQ(1000, history[0]["milestones"][0].at("microseconds"));
+  EXPECT_EQ(2000, history[1]["milestones"][0].at("microseconds"));
+}
+}
+}
+
+#endif
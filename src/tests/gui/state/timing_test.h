@@ -0,0 +1,191 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2019 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_GUI_STATE_TIMING_TEST
+#define LOOT_TESTS_GUI_STATE_TIMING_TEST
+
+#include "gui/state/timing.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+TEST(TimingRecorder, getEventsShouldReturnNoEventsIfNoneHaveBeenRecorded) {
+  TimingRecorder recorder;
+
+  EXPECT_TRUE(recorder.GetEvents().empty());
+}
+
+TEST(TimingRecorder, getEventsShouldReturnRecordedEventsOldestFirst) {
+  TimingRecorder recorder;
+  const auto start = steady_clock::now();
+
+  recorder.Record("a", start, start + milliseconds(2));
+  recorder.Record("b", start + milliseconds(2), start + milliseconds(5));
+
+  const auto events = recorder.GetEvents();
+
+  ASSERT_EQ(2, events.size());
+  EXPECT_STREQ("a", events[0].name);
+  EXPECT_EQ(2000, events[0].durationMicroseconds);
+  EXPECT_STREQ("b", events[1].name);
+  EXPECT_EQ(3000, events[1].durationMicroseconds);
+  EXPECT_EQ(2000, events[1].startMicroseconds - events[0].startMicroseconds);
+}
+
+TEST(TimingRecorder, recordShouldOverwriteTheOldestEventsOnceFull) {
+  TimingRecorder recorder;
+  const auto start = steady_clock::now();
+
+  recorder.Record("first", start, start);
+  for (size_t i = 0; i < TimingRecorder::CAPACITY; ++i) {
+    recorder.Record("other", start, start);
+  }
+
+  const auto events = recorder.GetEvents();
+
+  ASSERT_EQ(TimingRecorder::CAPACITY, events.size());
+  for (const auto& event : events) {
+    EXPECT_STREQ("other", event.name);
+  }
+}
+
+TEST(TimingRecorder, clearShouldRemoveAllRecordedEvents) {
+  TimingRecorder recorder;
+  const auto start = steady_clock::now();
+  recorder.Record("a", start, start);
+
+  recorder.Clear();
+  EXPECT_TRUE(recorder.GetEvents().empty());
+
+  recorder.Record("b", start, start);
+  ASSERT_EQ(1, recorder.GetEvents().size());
+  EXPECT_STREQ("b", recorder.GetEvents()[0].name);
+}
+
+TEST(TimingRecorder, recordShouldBeSafeToCallFromMultipleThreads) {
+  TimingRecorder recorder;
+  const size_t eventsPerThread = 500;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t j = 0; j < eventsPerThread; ++j) {
+        ScopedTimer timer("event", recorder);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(4 * eventsPerThread, recorder.GetEvents().size());
+}
+
+TEST(ScopedTimer, shouldRecordTheTimeBetweenConstructionAndDestruction) {
+  TimingRecorder recorder;
+
+  {
+    ScopedTimer timer("sleep", recorder);
+    std::this_thread::sleep_for(milliseconds(10));
+  }
+
+  const auto events = recorder.GetEvents();
+  ASSERT_EQ(1, events.size());
+  EXPECT_STREQ("sleep", events[0].name);
+  EXPECT_LE(10000, events[0].durationMicroseconds);
+}
+
+TEST(ScopedTimer, shouldRecordAllocationsIfAccountingIsEnabledOnConstruction) {
+  TimingRecorder recorder;
+
+  {
+    ScopedTimer timer("disabled", recorder);
+    ::operator delete(::operator new(1000));
+  }
+  SetAllocationAccountingEnabled(true);
+  {
+    ScopedTimer timer("enabled", recorder);
+    ::operator delete(::operator new(1000));
+  }
+  SetAllocationAccountingEnabled(false);
+
+  const auto events = recorder.GetEvents();
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(0, events[0].allocations.count);
+  EXPECT_EQ(1, events[1].allocations.count);
+  EXPECT_LE(1000, events[1].allocations.bytes);
+  EXPECT_LE(1000, events[1].allocations.peakBytes);
+}
+
+TEST(InternOperationName, shouldReturnTheSamePointerForEqualNames) {
+  const auto name = InternOperationName(std::string("getGameData"));
+
+  EXPECT_STREQ("getGameData", name);
+  EXPECT_EQ(name, InternOperationName(std::string("getGameData")));
+}
+
+TEST(SummariseTimings, shouldGiveTheCountTotalAndMaximumDurationPerName) {
+  const std::vector<TimingEvent> events({
+      TimingEvent{"b", 0, 5, 1},
+      TimingEvent{"a", 0, 10, 1},
+      TimingEvent{"b", 10, 20, 2},
+  });
+
+  const auto timings = SummariseTimings(events);
+
+  ASSERT_EQ(2, timings.size());
+  EXPECT_EQ("a", timings[0].name);
+  EXPECT_EQ(1, timings[0].count);
+  EXPECT_EQ(10, timings[0].totalMicroseconds);
+  EXPECT_EQ(10, timings[0].maxMicroseconds);
+  EXPECT_EQ("b", timings[1].name);
+  EXPECT_EQ(2, timings[1].count);
+  EXPECT_EQ(25, timings[1].totalMicroseconds);
+  EXPECT_EQ(20, timings[1].maxMicroseconds);
+}
+
+TEST(SummariseTimings, shouldGiveTheTotalAllocationsAndMaximumPeakPerName) {
+  const std::vector<TimingEvent> events({
+      TimingEvent{"a", 0, 5, 1, AllocationCounts{2, 300, 200}},
+      TimingEvent{"a", 10, 5, 1, AllocationCounts{1, 100, 100}},
+  });
+
+  const auto timings = SummariseTimings(events);
+
+  ASSERT_EQ(1, timings.size());
+  EXPECT_EQ(3, timings[0].allocationCount);
+  EXPECT_EQ(400, timings[0].allocatedBytes);
+  EXPECT_EQ(200, timings[0].maxPeakBytes);
+}
+}
+}
+
+#endif
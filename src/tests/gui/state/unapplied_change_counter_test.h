@@ -27,6 +27,9 @@ along with LOOT.  If not, see
 
 #include "gui/state/unapplied_change_counter.h"
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 namespace loot {
@@ -80,6 +83,26 @@ TEST(UnappliedChangeCounter,
 
   EXPECT_FALSE(counter.HasUnappliedChanges());
 }
+
+TEST(UnappliedChangeCounter,
+    concurrentlyIncrementingAndDecrementingTheChangeCounterEquallyShouldLeaveNoUnappliedChanges) {
+  UnappliedChangeCounter counter;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&counter]() {
+      for (int j = 0; j < 10000; ++j) {
+        counter.IncrementUnappliedChangeCounter();
+        counter.DecrementUnappliedChangeCounter();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(counter.HasUnappliedChanges());
+}
 }
 }
 
@@ -24,8 +24,10 @@ along with LOOT.  If not, see
 #ifndef LOOT_TESTS_GUI_TEST_HELPERS
 #define LOOT_TESTS_GUI_TEST_HELPERS
 
+#include <chrono>
 #include <filesystem>
 #include <string>
+#include <thread>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -45,6 +47,22 @@ void touch(const std::filesystem::path& path) {
   std::ofstream out(path);
   out.close();
 }
+
+// Poll the given condition until it's true or the timeout has passed. Returns
+// whether the condition became true.
+template<typename Predicate>
+bool waitUntil(Predicate condition,
+               std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  return true;
+}
 }
 }
 
@@ -0,0 +1,299 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014 WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_SYNTHETIC_PLUGINS
+#define LOOT_TESTS_SYNTHETIC_PLUGINS
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "loot/enum/game_type.h"
+
+// Plugins and metadata lists that are generated instead of copied from the
+// testing-plugins repository, so that tests and benchmarks can use load
+// orders of any size.
+namespace loot {
+namespace test {
+// Describes the plugins that createSyntheticPlugins() creates. Intervals count
+// from the first synthetic plugin, so an interval of 2 applies to the 2nd,
+// 4th, 6th, etc. plugins, and an interval of 0 applies to none of them.
+struct SyntheticPluginOptions {
+  size_t pluginCount = 100;
+  // Each plugin has the game's master file and up to this many of the
+  // synthetic plugins before it as masters.
+  size_t masterCount = 2;
+  // Light master flags are only set for games that support them.
+  size_t lightMasterInterval = 4;
+  size_t ghostedInterval = 10;
+  size_t activeInterval = 2;
+  // Games can't load more than 255 plugins, so plugins after this many active
+  // ones are inactive.
+  size_t maxActiveCount = 200;
+  // Each plugin overrides this many records from the game's master file, so
+  // every pair of synthetic plugins has overlapping FormIDs.
+  size_t overlappingRecordCount = 2;
+  // Each plugin adds this many records, with object indices that are valid
+  // for a light master.
+  size_t newRecordCount = 4;
+};
+
+// Get the filename of the synthetic plugin at the given position, counting
+// from 1.
+std::string getSyntheticPluginName(size_t position) {
+  std::ostringstream name;
+  name << "Synthetic Plugin " << std::setw(5) << std::setfill('0') << position
+       << ".esp";
+  return name.str();
+}
+
+void appendUint16(std::string& data, uint16_t value) {
+  data.push_back(static_cast<char>(value & 0xFF));
+  data.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void appendUint32(std::string& data, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+void appendRecordHeader(std::string& data,
+                        const char* type,
+                        uint32_t size,
+                        uint32_t flags,
+                        uint32_t formId,
+                        uint32_t headerSize) {
+  data.append(type, 4);
+  appendUint32(data, size);
+  appendUint32(data, flags);
+  appendUint32(data, formId);
+  data.append(headerSize - 16, '\0');
+}
+
+// Write a plugin with the given masters and a group that holds a record for
+// each of the given FormIDs. Records hold no data.
+void writeSyntheticPlugin(GameType gameType,
+                          const std::filesystem::path& path,
+                          const std::vector<std::string>& masters,
+                          bool isLightMaster,
+                          const std::vector<uint32_t>& formIds) {
+  // Oblivion's record and group headers have no version fields.
+  const uint32_t headerSize = gameType == GameType::tes4 ? 20 : 24;
+  const uint32_t lightMasterFlag = 0x200;
+
+  std::string headerData = "HEDR";
+  appendUint16(headerData, 12);
+  const float version = 1.0f;
+  uint32_t versionBits;
+  std::memcpy(&versionBits, &version, sizeof(versionBits));
+  appendUint32(headerData, versionBits);
+  appendUint32(headerData, static_cast<uint32_t>(formIds.size()));
+  appendUint32(headerData, 0x800);
+  for (const auto& master : masters) {
+    headerData += "MAST";
+    appendUint16(headerData, static_cast<uint16_t>(master.size() + 1));
+    headerData += master;
+    headerData.push_back('\0');
+    headerData += "DATA";
+    appendUint16(headerData, 8);
+    headerData.append(8, '\0');
+  }
+
+  std::string data;
+  appendRecordHeader(data,
+                     "TES4",
+                     static_cast<uint32_t>(headerData.size()),
+                     isLightMaster ? lightMasterFlag : 0,
+                     0,
+                     headerSize);
+  data += headerData;
+
+  // A group's size includes its header, and its label is its record type.
+  appendRecordHeader(data,
+                     "GRUP",
+                     static_cast<uint32_t>(headerSize * (formIds.size() + 1)),
+                     0x4F4D5241,  // "ARMO"
+                     0,
+                     headerSize);
+  for (const auto formId : formIds) {
+    appendRecordHeader(data, "ARMO", 0, 0, formId, headerSize);
+  }
+
+  std::ofstream out(path, std::ios::binary);
+  out.write(data.data(), data.size());
+}
+
+// Create plugins in the given data path as described by the given options.
+// Returns the plugins' filenames and whether they're active, in load order.
+// Morrowind's plugin format isn't supported.
+std::vector<std::pair<std::string, bool>> createSyntheticPlugins(
+    GameType gameType,
+    const std::filesystem::path& dataPath,
+    const std::string& masterFile,
+    const SyntheticPluginOptions& options) {
+  if (gameType == GameType::tes3) {
+    throw std::logic_error("Synthetic plugins can't be created for Morrowind");
+  }
+
+  const auto isApplied = [](size_t interval, size_t position) {
+    return interval != 0 && position % interval == 0;
+  };
+  const bool supportsLightMasters =
+      gameType == GameType::fo4 || gameType == GameType::tes5se;
+
+  std::vector<std::pair<std::string, bool>> plugins;
+  size_t activeCount = 0;
+  for (size_t i = 0; i < options.pluginCount; ++i) {
+    const auto position = i + 1;
+    const auto name = getSyntheticPluginName(position);
+
+    std::vector<std::string> masters({masterFile});
+    const auto firstMaster = plugins.size() > options.masterCount
+                                 ? plugins.end() - options.masterCount
+                                 : plugins.begin();
+    for (auto it = firstMaster; it != plugins.end(); ++it) {
+      masters.push_back(it->first);
+    }
+
+    std::vector<uint32_t> formIds;
+    for (size_t j = 0; j < options.overlappingRecordCount; ++j) {
+      formIds.push_back(static_cast<uint32_t>(0xF00 + j));
+    }
+    const auto masterIndex = static_cast<uint32_t>(masters.size()) << 24;
+    for (size_t j = 0; j < options.newRecordCount; ++j) {
+      formIds.push_back(masterIndex | static_cast<uint32_t>(0x800 + j));
+    }
+
+    const bool isLightMaster = supportsLightMasters &&
+                               isApplied(options.lightMasterInterval, position);
+    const auto path = dataPath / name;
+    writeSyntheticPlugin(gameType, path, masters, isLightMaster, formIds);
+
+    if (isApplied(options.ghostedInterval, position)) {
+      std::filesystem::rename(path, path.string() + ".ghost");
+    }
+
+    const bool isActive = activeCount < options.maxActiveCount &&
+                          isApplied(options.activeInterval, position);
+    if (isActive) {
+      ++activeCount;
+    }
+
+    plugins.emplace_back(name, isActive);
+  }
+
+  return plugins;
+}
+
+// Write a masterlist and userlist for the given synthetic plugins. The
+// masterlist spreads the plugins across a chain of groups in load order, loads
+// each after the one before it, and gives them conditional messages, Bash
+// Tags and dirty info for every 5th plugin. It has entries for the given
+// number of plugins per installed plugin, with the rest being for synthetic
+// plugins that aren't installed. The userlist adds load after metadata and
+// incompatibilities to every other plugin.
+void writeSyntheticMetadataLists(const std::filesystem::path& masterlistPath,
+                                 const std::filesystem::path& userlistPath,
+                                 const std::string& masterFile,
+                                 const std::vector<std::string>& plugins,
+                                 size_t groupCount,
+                                 size_t masterlistEntriesPerPlugin = 1) {
+  const auto getGroupName = [](size_t group) {
+    return "Synthetic Group " + std::to_string(group);
+  };
+
+  std::ofstream masterlist(masterlistPath);
+  masterlist << "bash_tags: [ Delev, Relev, Names, Stats ]\n"
+             << "globals:\n"
+             << "  - type: say\n"
+             << "    content: 'A general message with **Markdown**.'\n"
+             << "groups:\n  - name: default\n";
+  for (size_t group = 1; group <= groupCount; ++group) {
+    masterlist << "  - name: '" << getGroupName(group) << "'\n"
+               << "    after: [ '"
+               << (group == 1 ? "default" : getGroupName(group - 1))
+               << "' ]\n";
+  }
+
+  const auto getEntryName = [&](size_t entry) {
+    return entry < plugins.size() ? plugins[entry]
+                                  : getSyntheticPluginName(entry + 1);
+  };
+
+  masterlist << "plugins:\n";
+  const auto entryCount = plugins.size() * masterlistEntriesPerPlugin;
+  for (size_t i = 0; i < entryCount; ++i) {
+    const auto plugin = getEntryName(i);
+    const auto previousPlugin = i == 0 ? masterFile : getEntryName(i - 1);
+
+    masterlist << "  - name: '" << plugin << "'\n";
+    if (i > 0) {
+      masterlist << "    after: [ '" << previousPlugin << "' ]\n";
+    }
+    if (groupCount > 0) {
+      masterlist << "    group: '"
+                 << getGroupName(i * groupCount / entryCount + 1) << "'\n";
+    }
+    masterlist << "    msg:\n"
+               << "      - type: warn\n"
+               << "        content: 'Requires [a patch](https://example.com/"
+               << i << ") when used with " << previousPlugin << ".'\n"
+               << "        condition: 'active(\"" << previousPlugin
+               << "\")'\n"
+               << "    tag:\n"
+               << "      - Delev\n"
+               << "      - name: Relev\n"
+               << "        condition: 'file(\"" << masterFile << "\")'\n";
+    if (i % 5 == 0) {
+      masterlist << "    dirty:\n"
+                 << "      - crc: 0x" << std::hex << (0x10000000 + i)
+                 << std::dec << "\n"
+                 << "        util: 'Synthetic Cleaner v1.0'\n"
+                 << "        itm: 4\n"
+                 << "        udr: 2\n";
+    }
+  }
+
+  // Synthetic plugin positions count from 1, so there's never a plugin at 0.
+  const auto missingPlugin = getSyntheticPluginName(0);
+  std::ofstream userlist(userlistPath);
+  userlist << "plugins:\n";
+  for (size_t i = 1; i < plugins.size(); i += 2) {
+    userlist << "  - name: '" << plugins[i] << "'\n"
+             << "    after: [ '" << plugins[i - 1] << "' ]\n"
+             << "    inc: [ '" << missingPlugin << "' ]\n";
+  }
+}
+}
+}
+
+#endif